@@ -0,0 +1,61 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#ifndef INCLUDE_BENCH_H
+#define INCLUDE_BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+
+/* Helpers shared by the benchmark programs. Every program prints one line
+   per measured case, "<case> : <value> <unit> ...", so that runs can be
+   compared with diff. */
+
+/* nanoseconds on the monotonic clock */
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000ULL) + (uint64_t) ts.tv_nsec;
+}
+
+/* iteration count from the command line, or the default */
+static inline int bench_iterations(int argc, char *argv[], int dflt)
+{
+    int n;
+
+    if (argc < 2)
+    {
+        return dflt;
+    }
+
+    n = atoi(argv[1]);
+    return (n > 0) ? n : dflt;
+}
+
+/* deterministic pseudo random numbers, so that runs are comparable */
+static inline uint32_t bench_rand(uint32_t *state)
+{
+    *state = (*state * 1103515245U) + 12345U;
+    return (*state >> 8);
+}
+
+#endif /* INCLUDE_BENCH_H */
@@ -0,0 +1,151 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+/*
+ * Bufmon update benchmark (sbplugin_bst_cache.c).
+ *
+ * Resolves the rows of a bufmon description file the ways the monitor
+ * does : by parsing the row name, on first sight of a row (parse, then
+ * add to the UUID index) and through the UUID index. Then applies table
+ * updates of every row to the cache, resolved and staged as the monitor
+ * does, one batch per update. Prints the time per row and the row
+ * throughput of each case.
+ *
+ *   usage : bench_bufmon [iterations] [bufmon description file]
+ */
+
+#include <string.h>
+#include "broadview.h"
+#include "bench.h"
+#include "bench_ovsdb.h"
+
+#define BENCH_BUFMON_ITERATIONS    200
+
+static void bench_bufmon_print(const char *label, uint64_t time, long rows)
+{
+    printf("%-11s : %8.1f ns/row %8.2f Mrows/s\n", label, (double) time / rows,
+           ((double) rows * 1000.0) / (double) time);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *path = (argc > 2) ? argv[2] : BENCH_OVSDB_ROWS_FILE;
+    int iterations = bench_iterations(argc, argv, BENCH_BUFMON_ITERATIONS);
+    BENCH_OVSDB_ROW_t *rows = NULL;
+    BVIEW_OVSDB_ROW_UPDATE_t *updates;
+    BVIEW_OVSDB_ROW_REF_t ref;
+    unsigned int *indexes;
+    uint64_t start, time, firstTime = 0;
+    int count, resolved = 0, oldTrackMask, r, i, bid, port, queue;
+    uint32_t seed = 1;
+
+    count = bench_ovsdb_rows_load(path, &rows);
+    if (0 == count)
+    {
+        printf("no bufmon rows read from %s\n", path);
+        return 1;
+    }
+    updates = calloc(count, sizeof(BVIEW_OVSDB_ROW_UPDATE_t));
+    indexes = calloc(count, sizeof(unsigned int));
+    if ((NULL == updates) || (NULL == indexes) ||
+        (BVIEW_STATUS_SUCCESS != bst_ovsdb_cache_init()))
+    {
+        printf("out of memory\n");
+        return 1;
+    }
+
+    /* the rows that name a BST counter, as the parse resolves them */
+    for (r = 0; r < count; r++)
+    {
+        queue = -1;
+        if ((BVIEW_STATUS_SUCCESS == bst_ovsdb_row_info_get(0, rows[r].name, &bid, &port, &queue)) &&
+            (BVIEW_STATUS_SUCCESS == bst_ovsdb_cache_row_get(0, bid, port, queue, &indexes[resolved])))
+        {
+            rows[resolved++] = rows[r];
+        }
+    }
+    printf("rows        : %d of %d resolved\n", resolved, count);
+
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        for (r = 0; r < resolved; r++)
+        {
+            queue = -1;
+            bst_ovsdb_row_info_get(0, rows[r].name, &bid, &port, &queue);
+            bst_ovsdb_cache_row_get(0, bid, port, queue, &indexes[r]);
+        }
+    }
+    bench_bufmon_print("name parse", bench_now_ns() - start, (long) iterations * resolved);
+
+    /* the initial monitor reply, the index is emptied between the runs */
+    for (i = 0; i < iterations; i++)
+    {
+        start = bench_now_ns();
+        for (r = 0; r < resolved; r++)
+        {
+            bst_ovsdb_row_ref_get(rows[r].uuid, 0, rows[r].name, &ref);
+        }
+        firstTime += bench_now_ns() - start;
+        if (i != (iterations - 1))
+        {
+            for (r = 0; r < resolved; r++)
+            {
+                bst_ovsdb_row_ref_delete(rows[r].uuid);
+            }
+        }
+    }
+    bench_bufmon_print("first sight", firstTime, (long) iterations * resolved);
+
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        for (r = 0; r < resolved; r++)
+        {
+            if ((BVIEW_STATUS_SUCCESS != bst_ovsdb_row_ref_get(rows[r].uuid, 0, NULL, &ref)) ||
+                (ref.index != indexes[r]))
+            {
+                printf("row %s resolved to another counter\n", rows[r].name);
+                return 1;
+            }
+        }
+    }
+    bench_bufmon_print("indexed", bench_now_ns() - start, (long) iterations * resolved);
+
+    /* table updates of every row, new stats for every update */
+    time = 0;
+    for (i = 0; i < iterations; i++)
+    {
+        start = bench_now_ns();
+        for (r = 0; r < resolved; r++)
+        {
+            bst_ovsdb_row_ref_get(rows[r].uuid, 0, NULL, &updates[r].ref);
+            updates[r].row.stat = bench_rand(&seed) % 100000;
+            updates[r].row.threshold = 100000;
+            updates[r].row.enabled = true;
+        }
+        bst_ovsdb_row_updates_apply(updates, resolved, 0, &oldTrackMask);
+        time += bench_now_ns() - start;
+    }
+    bench_bufmon_print("update", time, (long) iterations * resolved);
+
+    free(updates);
+    free(indexes);
+    free(rows);
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+/*
+ * OVSDB cache benchmark (sbplugin_bst_cache.c, sbplugin_bst.c).
+ *
+ * Fills the cache of a 72 port asic from the rows of a bufmon description
+ * file, then prints the footprint of the cache and the time of a full
+ * snapshot, read in one pass through the snapshot map and read realm by
+ * realm with the per-realm getters. Both snapshots are checked to be the
+ * same.
+ *
+ *   usage : bench_cache [iterations] [bufmon description file]
+ */
+
+#include <string.h>
+#include "broadview.h"
+#include "bst.h"
+#include "bench.h"
+#include "bench_ovsdb.h"
+#include "sbplugin_bst.h"
+
+#define BENCH_CACHE_ITERATIONS    2000
+#define BENCH_CACHE_PORTS         72
+
+/* a snapshot read realm by realm */
+static BVIEW_STATUS bench_cache_realms_get(BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                           BVIEW_TIME_t *time)
+{
+    if ((BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_device_data_get(0, &snapshot->device, time)) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_ippg_data_get(0, &snapshot->iPortPg, time)) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_ipsp_data_get(0, &snapshot->iPortSp, time)) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_isp_data_get(0, &snapshot->iSp, time)) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_epsp_data_get(0, &snapshot->ePortSp, time)) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_esp_data_get(0, &snapshot->eSp, time)) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_eucq_data_get(0, &snapshot->eUcQ, time)) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_eucqg_data_get(0, &snapshot->eUcQg, time)) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_emcq_data_get(0, &snapshot->eMcQ, time)) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_cpuq_data_get(0, &snapshot->cpqQ, time)) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_rqeq_data_get(0, &snapshot->rqeQ, time)))
+    {
+        return BVIEW_STATUS_FAILURE;
+    }
+    return BVIEW_STATUS_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    static BVIEW_BST_ASIC_SNAPSHOT_DATA_t snapshot, realms;
+    const char *path = (argc > 2) ? argv[2] : BENCH_OVSDB_ROWS_FILE;
+    int iterations = bench_iterations(argc, argv, BENCH_CACHE_ITERATIONS);
+    BENCH_OVSDB_ROW_t *rows = NULL;
+    BVIEW_OVSDB_ROW_UPDATE_t *updates;
+    BVIEW_TIME_t time;
+    uint64_t start, snapshotTime, realmsTime;
+    int count, staged = 0, oldTrackMask, r, i;
+    uint32_t seed = 1;
+
+    count = bench_ovsdb_rows_load(path, &rows);
+    if (0 == count)
+    {
+        printf("no bufmon rows read from %s\n", path);
+        return 1;
+    }
+    updates = calloc(count, sizeof(BVIEW_OVSDB_ROW_UPDATE_t));
+    if ((NULL == updates) || (BVIEW_STATUS_SUCCESS != bst_ovsdb_cache_init()))
+    {
+        printf("out of memory\n");
+        return 1;
+    }
+    bench_ovsdb_asic_init(BENCH_CACHE_PORTS);
+
+    /* the initial monitor reply, every row with a stat */
+    for (r = 0; r < count; r++)
+    {
+        if (BVIEW_STATUS_SUCCESS == bst_ovsdb_row_ref_get(rows[r].uuid, 0, rows[r].name,
+                                                          &updates[staged].ref))
+        {
+            updates[staged].row.stat = (bench_rand(&seed) % 100000) + 1;
+            updates[staged].row.threshold = 100000;
+            updates[staged].row.enabled = true;
+            staged++;
+        }
+    }
+    bst_ovsdb_row_updates_apply(updates, staged, 0, &oldTrackMask);
+    bst_ovsdb_cache_stale_set(false);
+
+    printf("stats       : %8zu bytes per asic\n", sizeof(BVIEW_OVSDB_BST_COUNTER_DB_t));
+    printf("cache       : %8zu bytes per asic (%zu as row entries)\n",
+           sizeof(BVIEW_OVSDB_BST_STAT_DB_t),
+           BVIEW_OVSDB_BST_COUNTERS * sizeof(BVIEW_OVSDB_BID_INFO_t));
+
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        if (BVIEW_STATUS_SUCCESS != sbplugin_ovsdb_bst_snapshot_get(0, &snapshot, &time))
+        {
+            printf("snapshot read failed\n");
+            return 1;
+        }
+    }
+    snapshotTime = bench_now_ns() - start;
+
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        if (BVIEW_STATUS_SUCCESS != bench_cache_realms_get(&realms, &time))
+        {
+            printf("realm read failed\n");
+            return 1;
+        }
+    }
+    realmsTime = bench_now_ns() - start;
+
+    if (0 != memcmp(&snapshot, &realms, sizeof(snapshot)))
+    {
+        printf("the snapshot and the realms differ\n");
+        return 1;
+    }
+
+    printf("snapshot    : %8.2f us/snapshot (%d rows)\n",
+           (double) snapshotTime / iterations / 1000.0, staged);
+    printf("per realm   : %8.2f us/snapshot\n", (double) realmsTime / iterations / 1000.0);
+
+    free(updates);
+    free(rows);
+    return 0;
+}
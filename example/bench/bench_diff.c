@@ -0,0 +1,123 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+/*
+ * Change detection benchmark (bst_json_diff.c).
+ *
+ * Times bstjson_diff_changed_get() with every kernel the CPU supports on
+ * the two realms that dominate a report : the 4096 unicast queues (one
+ * counter and the port per entry) and the 130 x 8 ingress priority groups
+ * (two counters per entry), with 0, 1, 10 and 100 percent of the entries
+ * changed since the previous report.
+ *
+ *   usage : bench_diff [iterations]
+ */
+
+#include <string.h>
+#include "broadview.h"
+#include "bst.h"
+#include "bst_json_diff.h"
+#include "bench.h"
+
+#define BENCH_DIFF_ITERATIONS      20000
+
+typedef struct _bench_diff_realm_
+{
+    const char  *name;
+    int         numEntries;
+    int         stride;
+    int         compareWords;
+} BENCH_DIFF_REALM_t;
+
+static const BENCH_DIFF_REALM_t benchDiffRealms[] = {
+    { "egress-uc-queue", BVIEW_ASIC_MAX_UC_QUEUES,
+      BSTJSON_DIFF_STRIDE(((BVIEW_BST_EGRESS_UC_QUEUE_DATA_t *) 0)->data[0]), 1 },
+    { "ingress-port-priority-group", BVIEW_ASIC_MAX_PORTS * BVIEW_ASIC_MAX_PRIORITY_GROUPS,
+      BSTJSON_DIFF_STRIDE(((BVIEW_BST_INGRESS_PORT_PG_DATA_t *) 0)->data[0][0]), 2 }
+};
+
+static const int benchDiffPercent[] = { 0, 1, 10, 100 };
+
+static const struct
+{
+    BSTJSON_DIFF_ISA_t  isa;
+    const char          *name;
+} benchDiffKernels[] = {
+    { BSTJSON_DIFF_ISA_SCALAR, "scalar" },
+    { BSTJSON_DIFF_ISA_SSE2, "sse2" },
+    { BSTJSON_DIFF_ISA_AVX2, "avx2" }
+};
+
+int main(int argc, char *argv[])
+{
+    static uint64_t previous[BVIEW_ASIC_MAX_UC_QUEUES * 2];
+    static uint64_t current[BVIEW_ASIC_MAX_UC_QUEUES * 2];
+    static uint64_t bitmap[BSTJSON_DIFF_MAX_BITMAP_WORDS];
+    const BENCH_DIFF_REALM_t *realm;
+    int iterations = bench_iterations(argc, argv, BENCH_DIFF_ITERATIONS);
+    uint32_t seed;
+    uint64_t start, elapsed;
+    volatile int numSet = 0;
+    int r, p, k, i, entry;
+
+    for (r = 0; r < (int) (sizeof(benchDiffRealms) / sizeof(benchDiffRealms[0])); r++)
+    {
+        realm = &benchDiffRealms[r];
+
+        for (p = 0; p < (int) (sizeof(benchDiffPercent) / sizeof(benchDiffPercent[0])); p++)
+        {
+            /* same counters, then bump a spread of entries */
+            seed = 1;
+            for (i = 0; i < realm->numEntries * realm->stride; i++)
+            {
+                previous[i] = current[i] = bench_rand(&seed) % 100000;
+            }
+            for (entry = 0; entry < realm->numEntries; entry++)
+            {
+                if ((int) (bench_rand(&seed) % 100) < benchDiffPercent[p])
+                {
+                    current[entry * realm->stride]++;
+                }
+            }
+
+            for (k = 0; k < (int) (sizeof(benchDiffKernels) / sizeof(benchDiffKernels[0])); k++)
+            {
+                if (BVIEW_STATUS_SUCCESS != bstjson_diff_isa_set(benchDiffKernels[k].isa))
+                {
+                    printf("%-28s %3d%% %-6s : not supported\n", realm->name,
+                           benchDiffPercent[p], benchDiffKernels[k].name);
+                    continue;
+                }
+
+                start = bench_now_ns();
+                for (i = 0; i < iterations; i++)
+                {
+                    numSet = bstjson_diff_changed_get(previous, current, realm->numEntries,
+                                                      realm->stride, realm->compareWords, bitmap);
+                }
+                elapsed = bench_now_ns() - start;
+
+                printf("%-28s %3d%% %-6s : %8.1f ns/realm (%d changed)\n", realm->name,
+                       benchDiffPercent[p], benchDiffKernels[k].name,
+                       (double) elapsed / iterations, numSet);
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+/*
+ * Report format benchmark (bst_json_encoder.c, bst_bin_encoder.c).
+ *
+ * Encodes the same full report, every realm of a 130 port asic, in JSON
+ * and in the binary format, for 1 to 100 percent of the counters non
+ * zero, and prints the encode time, the report size and the throughput
+ * of each format.
+ *
+ *   usage : bench_format [iterations]
+ */
+
+#include <string.h>
+#include "broadview.h"
+#include "bst.h"
+#include "bench.h"
+#include "bench_report.h"
+#include "bst_json_memory.h"
+#include "bst_json_diff.h"
+#include "bst_bin_encoder.h"
+
+#define BENCH_FORMAT_ITERATIONS    50
+
+static const int benchFormatOccupancy[] = { 1, 10, 50, 100 };
+
+int main(int argc, char *argv[])
+{
+    static BVIEW_BST_ASIC_SNAPSHOT_DATA_t current;
+    static BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t maxBuffers;
+    BVIEW_ASIC_CAPABILITIES_t asic;
+    BSTJSON_REPORT_OPTIONS_t options;
+    BVIEW_TIME_t reportTime = 1700000000;
+    int iterations = bench_iterations(argc, argv, BENCH_FORMAT_ITERATIONS);
+    uint64_t start, jsonTime, binTime;
+    uint8_t *buffer;
+    BVIEW_STATUS status = BVIEW_STATUS_SUCCESS;
+    uint32_t seed = 1;
+    int o, i, jsonLength = 0, binLength = 0;
+
+    bstjson_memory_init();
+    bstjson_diff_init();
+    bench_report_asic_init(&asic);
+    bench_report_options_init(&options, &maxBuffers);
+
+    for (o = 0; o < (int) (sizeof(benchFormatOccupancy) / sizeof(benchFormatOccupancy[0])); o++)
+    {
+        bench_report_snapshot_fill(&current, benchFormatOccupancy[o], &seed);
+
+        /* a fully populated report can outgrow the json report buffer
+           (BSTJSON_MEMSIZE_REPORT), the binary report is still timed */
+        jsonLength = 0;
+        start = bench_now_ns();
+        for (i = 0; i < iterations; i++)
+        {
+            status = bstjson_encode_get_bst_report(0, 1, NULL, &current, &options,
+                                                   &asic, &reportTime, &buffer);
+            if (BVIEW_STATUS_SUCCESS != status)
+            {
+                break;
+            }
+            jsonLength = strlen((char *) buffer);
+            bstjson_memory_free(buffer);
+        }
+        jsonTime = bench_now_ns() - start;
+
+        start = bench_now_ns();
+        for (i = 0; i < iterations; i++)
+        {
+            if (BVIEW_STATUS_SUCCESS != bstbin_encode_get_bst_report(0, 1, NULL, &current, &options,
+                                                                      &asic, &reportTime, &buffer, &binLength))
+            {
+                printf("binary encoding failed\n");
+                return 1;
+            }
+            bstjson_memory_free(buffer);
+        }
+        binTime = bench_now_ns() - start;
+
+        if (BVIEW_STATUS_SUCCESS != status)
+        {
+            printf("%3d%% json   : encoding failed, status %d\n", benchFormatOccupancy[o], status);
+        }
+        else
+        {
+            printf("%3d%% json   : %8.1f us/report %8d bytes %7.1f MB/s\n", benchFormatOccupancy[o],
+                   (double) jsonTime / iterations / 1000.0, jsonLength,
+                   ((double) jsonLength * iterations * 1000.0) / (double) jsonTime);
+        }
+        printf("%3d%% binary : %8.1f us/report %8d bytes %7.1f MB/s", benchFormatOccupancy[o],
+               (double) binTime / iterations / 1000.0, binLength,
+               ((double) binLength * iterations * 1000.0) / (double) binTime);
+        if (0 != jsonLength)
+        {
+            printf(" (%.1f%% of json)", (100.0 * binLength) / jsonLength);
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,108 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+/*
+ * Report layout benchmark (bstjson_layout_dense_choose()).
+ *
+ * Encodes an incremental report of every realm, from 1 to 100 percent
+ * of the entries non zero, in the sparse layout and in the adaptive
+ * one, which writes a realm densely when that is shorter. Prints the
+ * encode time and the size of each.
+ *
+ *   usage : bench_layout [iterations]
+ */
+
+#include <string.h>
+#include "broadview.h"
+#include "bst.h"
+#include "bench.h"
+#include "bench_report.h"
+#include "bst_json_memory.h"
+#include "bst_json_diff.h"
+
+#define BENCH_LAYOUT_ITERATIONS    50
+
+static const int benchLayoutOccupancy[] = { 1, 5, 10, 25, 50, 75, 100 };
+
+static const struct
+{
+    const char *name;
+    int layout;
+} benchLayouts[] = {
+    { "sparse  ", BST_REPORT_LAYOUT_SPARSE },
+    { "adaptive", BST_REPORT_LAYOUT_ADAPTIVE }
+};
+
+int main(int argc, char *argv[])
+{
+    static BVIEW_BST_ASIC_SNAPSHOT_DATA_t current;
+    static BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t maxBuffers;
+    BVIEW_ASIC_CAPABILITIES_t asic;
+    BSTJSON_REPORT_OPTIONS_t options;
+    BVIEW_TIME_t reportTime = 1700000000;
+    BVIEW_STATUS status = BVIEW_STATUS_SUCCESS;
+    int iterations = bench_iterations(argc, argv, BENCH_LAYOUT_ITERATIONS);
+    uint64_t start, elapsed;
+    uint8_t *buffer;
+    uint32_t seed = 1;
+    int o, l, i, length = 0;
+
+    bstjson_memory_init();
+    bstjson_diff_init();
+    bench_report_asic_init(&asic);
+    bench_report_options_init(&options, &maxBuffers);
+
+    /* only the non zero entries are reported */
+    options.sendIncrementalReport = true;
+
+    for (o = 0; o < (int) (sizeof(benchLayoutOccupancy) / sizeof(benchLayoutOccupancy[0])); o++)
+    {
+        bench_report_snapshot_fill(&current, benchLayoutOccupancy[o], &seed);
+
+        for (l = 0; l < (int) (sizeof(benchLayouts) / sizeof(benchLayouts[0])); l++)
+        {
+            options.reportLayout = benchLayouts[l].layout;
+
+            start = bench_now_ns();
+            for (i = 0; i < iterations; i++)
+            {
+                status = bstjson_encode_get_bst_report(0, 1, NULL, &current, &options,
+                                                       &asic, &reportTime, &buffer);
+                if (BVIEW_STATUS_SUCCESS != status)
+                {
+                    break;
+                }
+                length = strlen((char *) buffer);
+                bstjson_memory_free(buffer);
+            }
+            elapsed = bench_now_ns() - start;
+
+            if (BVIEW_STATUS_SUCCESS != status)
+            {
+                printf("%3d%% %s : encoding failed, status %d\n", benchLayoutOccupancy[o],
+                       benchLayouts[l].name, status);
+                continue;
+            }
+
+            printf("%3d%% %s : %8.1f us/report %8d bytes\n", benchLayoutOccupancy[o],
+                   benchLayouts[l].name, (double) elapsed / iterations / 1000.0, length);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+/*
+ * Request queue benchmark (bst_msg.c).
+ *
+ * Posts requests through a private SysV queue and reads them back, as
+ * bst_send_request() and the bst thread do : once packed as the queued
+ * header, with the parameters in the request pool, and once as the
+ * whole BVIEW_BST_REQUEST_MSG_t. Prints the time of a round trip for a
+ * request with parameters (get-bst-report) and one without (a periodic
+ * report).
+ *
+ *   usage : bench_msg [iterations]
+ */
+
+#include <stdarg.h>
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/msg.h>
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_report.h"
+#include "bst_json_encoder.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "openapps_log_api.h"
+#include "bench.h"
+
+#define BENCH_MSG_ITERATIONS    200000
+
+/* the request posted whole, as before the queued header */
+typedef struct _bench_msg_raw_ {
+    long lane;
+    BVIEW_BST_REQUEST_MSG_t msg;
+} BENCH_MSG_RAW_t;
+
+void log_post(BVIEW_SEVERITY severity, char *format, ...)
+{
+    (void) severity;
+    (void) format;
+}
+
+/* round trips of a packed request, in nanoseconds per request */
+static double bench_msg_packed(int qid, const BVIEW_BST_REQUEST_MSG_t *request, int iterations)
+{
+    BVIEW_BST_QUEUE_MSG_t queueMsg;
+    BVIEW_BST_REQUEST_MSG_t received;
+    uint64_t start = bench_now_ns();
+    int i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        queueMsg.lane = BVIEW_BST_LANE_DATA;
+        if (BVIEW_STATUS_SUCCESS != bst_request_pack(request, &queueMsg))
+        {
+            return -1.0;
+        }
+        if ((0 != msgsnd(qid, &queueMsg, sizeof(BVIEW_BST_QUEUE_MSG_t) - sizeof(long), 0)) ||
+            (-1 == msgrcv(qid, &queueMsg, sizeof(BVIEW_BST_QUEUE_MSG_t) - sizeof(long), 0, 0)))
+        {
+            bst_request_release(&queueMsg);
+            return -1.0;
+        }
+        bst_request_unpack(&queueMsg, &received);
+    }
+
+    return (double) (bench_now_ns() - start) / iterations;
+}
+
+/* round trips of the whole request, in nanoseconds per request */
+static double bench_msg_raw(int qid, const BVIEW_BST_REQUEST_MSG_t *request, int iterations)
+{
+    static BENCH_MSG_RAW_t rawMsg;
+    static BVIEW_BST_REQUEST_MSG_t received;
+    uint64_t start = bench_now_ns();
+    int i;
+
+    for (i = 0; i < iterations; i++)
+    {
+        rawMsg.lane = BVIEW_BST_LANE_DATA;
+        memcpy(&rawMsg.msg, request, sizeof(BVIEW_BST_REQUEST_MSG_t));
+        if ((0 != msgsnd(qid, &rawMsg, sizeof(BENCH_MSG_RAW_t) - sizeof(long), 0)) ||
+            (-1 == msgrcv(qid, &rawMsg, sizeof(BENCH_MSG_RAW_t) - sizeof(long), 0, 0)))
+        {
+            return -1.0;
+        }
+        memcpy(&received, &rawMsg.msg, sizeof(BVIEW_BST_REQUEST_MSG_t));
+    }
+
+    return (double) (bench_now_ns() - start) / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+    static BVIEW_BST_REQUEST_MSG_t request;
+    int iterations = bench_iterations(argc, argv, BENCH_MSG_ITERATIONS);
+    int qid, r;
+    static const struct
+    {
+        const char *name;
+        BVIEW_BST_REPORT_TYPE_t reportType;
+    } benchRequests[] = {
+        { "get-bst-report", BVIEW_BST_STATS },
+        { "periodic      ", BVIEW_BST_STATS_PERIODIC }
+    };
+
+    if (BVIEW_STATUS_SUCCESS != bst_msg_init())
+    {
+        printf("request pool not created\n");
+        return 1;
+    }
+
+    qid = msgget(IPC_PRIVATE, IPC_CREAT | 0600);
+    if (-1 == qid)
+    {
+        printf("queue not created\n");
+        return 1;
+    }
+
+    printf("queued %u bytes, pooled %u bytes, unpacked %u bytes\n",
+           (unsigned int) (sizeof(BVIEW_BST_QUEUE_MSG_t) - sizeof(long)),
+           (unsigned int) sizeof(BVIEW_BST_REQUEST_PAYLOAD_t),
+           (unsigned int) (sizeof(BENCH_MSG_RAW_t) - sizeof(long)));
+
+    for (r = 0; r < (int) (sizeof(benchRequests) / sizeof(benchRequests[0])); r++)
+    {
+        memset(&request, 0, sizeof(request));
+        request.msg_type = BVIEW_BST_CMD_API_GET_REPORT;
+        request.report_type = benchRequests[r].reportType;
+
+        printf("%s packed : %8.1f ns/request\n", benchRequests[r].name,
+               bench_msg_packed(qid, &request, iterations));
+        printf("%s whole  : %8.1f ns/request\n", benchRequests[r].name,
+               bench_msg_raw(qid, &request, iterations));
+    }
+
+    msgctl(qid, IPC_RMID, NULL);
+    return 0;
+}
@@ -0,0 +1,156 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "bench_ovsdb.h"
+#include "sbplugin_system_map.h"
+#include "ovsdb_bst_ctl.h"
+#include "ovsdb_client.h"
+#include "ovsdb_txn.h"
+
+/* The cache and the BID table of the OVSDB plugin are linked as they are,
+   what they reach of the rest of the plugin is stubbed : nothing is
+   committed to a database. */
+int sbOvsdbDebugFlag = false;
+
+BVIEW_ASIC_t asicDb[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+
+void log_post(BVIEW_SEVERITY severity, char *format, ...)
+{
+    (void) severity;
+    (void) format;
+}
+
+BVIEW_STATUS sbplugin_ovsdb_valid_unit_check(unsigned int unit)
+{
+    return (unit < BVIEW_MAX_ASICS_ON_A_PLATFORM) ? BVIEW_STATUS_SUCCESS : BVIEW_STATUS_INVALID_PARAMETER;
+}
+
+BVIEW_STATUS sbplugin_ovsdb_system_time_get(time_t *now)
+{
+    *now = time(NULL);
+    return BVIEW_STATUS_SUCCESS;
+}
+
+void ovsdb_client_stats_dump(void)
+{
+}
+
+void ovsdb_txn_stats_dump(void)
+{
+}
+
+BVIEW_STATUS ovsdb_txn_init(void)
+{
+    return BVIEW_STATUS_SUCCESS;
+}
+
+void bst_ovsdb_monitor()
+{
+}
+
+BVIEW_STATUS bst_ovsdb_threshold_commit(int asic, int port, int index,
+                                        int bid, uint64_t threshold)
+{
+    return BVIEW_STATUS_SUCCESS;
+}
+
+BVIEW_STATUS bst_ovsdb_bst_config_commit(int asic, BVIEW_OVSDB_CONFIG_DATA_t *config)
+{
+    return BVIEW_STATUS_SUCCESS;
+}
+
+BVIEW_STATUS bst_ovsdb_bst_tracking_commit(int asic, BVIEW_OVSDB_CONFIG_DATA_t *config)
+{
+    return BVIEW_STATUS_SUCCESS;
+}
+
+BVIEW_STATUS bst_ovsdb_clear_thresholds_commit(int asic)
+{
+    return BVIEW_STATUS_SUCCESS;
+}
+
+BVIEW_STATUS bst_ovsdb_clear_stats_commit(int asic)
+{
+    return BVIEW_STATUS_SUCCESS;
+}
+
+int bench_ovsdb_rows_load(const char *path, BENCH_OVSDB_ROW_t **rows)
+{
+    static const char key[] = "  name: ";
+    char line[BENCH_OVSDB_NAME_SIZE + sizeof(key) - 1];
+    BENCH_OVSDB_ROW_t *list = NULL, *grown;
+    int count = 0, size = 0;
+    FILE *fp;
+
+    fp = fopen(path, "r");
+    if (NULL == fp)
+    {
+        return 0;
+    }
+
+    while (NULL != fgets(line, sizeof(line), fp))
+    {
+        /* the name of a counter, "  name: <realm>/<name>/<index1>/<index2>" */
+        if (0 != strncmp(line, key, sizeof(key) - 1))
+        {
+            continue;
+        }
+        if (count == size)
+        {
+            size = (0 == size) ? 1024 : (size * 2);
+            grown = realloc(list, size * sizeof(BENCH_OVSDB_ROW_t));
+            if (NULL == grown)
+            {
+                break;
+            }
+            list = grown;
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+        snprintf(list[count].name, sizeof(list[count].name), "%s", line + sizeof(key) - 1);
+        snprintf(list[count].uuid, sizeof(list[count].uuid),
+                 "%08x-%04x-4%03x-8%03x-%012x", (unsigned int) count * 2654435761U,
+                 count & 0xffff, count & 0xfff, (count * 7) & 0xfff, (unsigned int) count);
+        count++;
+    }
+    fclose(fp);
+
+    *rows = list;
+    return count;
+}
+
+void bench_ovsdb_asic_init(int numPorts)
+{
+    BVIEW_ASIC_t *asic = &asicDb[0];
+
+    memset(asic, 0, sizeof(BVIEW_ASIC_t));
+    asic->scalingParams.numPorts = numPorts;
+    asic->scalingParams.numUnicastQueues = BVIEW_TD2_NUM_UC_QUEUE;
+    asic->scalingParams.numUnicastQueueGroups = BVIEW_TD2_NUM_UC_QUEUE_GRP;
+    asic->scalingParams.numMulticastQueues = BVIEW_TD2_NUM_MC_QUEUE;
+    asic->scalingParams.numServicePools = BVIEW_TD2_NUM_SP;
+    asic->scalingParams.numCommonPools = BVIEW_TD2_NUM_COMMON_SP;
+    asic->scalingParams.numCpuQueues = BVIEW_TD2_CPU_COSQ;
+    asic->scalingParams.numRqeQueues = BVIEW_TD2_NUM_RQE;
+    asic->scalingParams.numRqeQueuePools = BVIEW_TD2_NUM_RQE_POOL;
+    asic->scalingParams.numPriorityGroups = BVIEW_TD2_NUM_PG;
+    asic->scalingParams.cellToByteConv = BVIEW_TD2_CELL_TO_BYTE;
+}
@@ -0,0 +1,52 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#ifndef INCLUDE_BENCH_OVSDB_H
+#define INCLUDE_BENCH_OVSDB_H
+
+#include "broadview.h"
+#include "sbplugin.h"
+#include "sbplugin_ovsdb.h"
+#include "sbplugin_bst_map.h"
+#include "sbplugin_bst_ovsdb.h"
+#include "sbplugin_bst_cache.h"
+
+/* Bufmon rows for the OVSDB cache benchmarks. The rows are the counters
+   of a bufmon description file, tests/bufmondsim.yaml by default (the 72
+   port simulator), each given a made up UUID, as the monitor names it. */
+
+/* the bufmon description file, relative to example/bench */
+#define BENCH_OVSDB_ROWS_FILE    "../../tests/bufmondsim.yaml"
+
+#define BENCH_OVSDB_NAME_SIZE    128
+
+/* a bufmon row, its UUID and its name */
+typedef struct _bench_ovsdb_row_
+{
+    char uuid[BVIEW_OVSDB_ROW_UUID_SIZE + 1];
+    char name[BENCH_OVSDB_NAME_SIZE];
+} BENCH_OVSDB_ROW_t;
+
+/* reads the rows of asic 0 from a bufmon description file, returns the
+   number of rows, 0 if the file can not be read */
+int bench_ovsdb_rows_load(const char *path, BENCH_OVSDB_ROW_t **rows);
+
+/* sizes asic 0 as the plugin sizes a trident2, with 'numPorts' ports */
+void bench_ovsdb_asic_init(int numPorts);
+
+#endif /* INCLUDE_BENCH_OVSDB_H */
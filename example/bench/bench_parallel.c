@@ -0,0 +1,113 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+/*
+ * Parallel realm encoding benchmark (bst_json_parallel.c).
+ *
+ * Encodes a report of every realm, half of the counters non zero, with
+ * 1 to BSTJSON_PARALLEL_MAX_THREADS encoding threads. The pool cannot be
+ * resized once started, so every thread count is measured in a child
+ * process of its own.
+ *
+ *   usage : bench_parallel [iterations]
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "broadview.h"
+#include "bst.h"
+#include "bench.h"
+#include "bench_report.h"
+#include "bst_json_memory.h"
+#include "bst_json_diff.h"
+#include "bst_json_parallel.h"
+
+#define BENCH_PARALLEL_ITERATIONS    100
+#define BENCH_PARALLEL_OCCUPANCY     50
+
+/* encodes the report 'iterations' times with 'numThreads' threads */
+static int bench_parallel_run(int numThreads, int iterations)
+{
+    static BVIEW_BST_ASIC_SNAPSHOT_DATA_t current;
+    static BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t maxBuffers;
+    BVIEW_ASIC_CAPABILITIES_t asic;
+    BSTJSON_REPORT_OPTIONS_t options;
+    BVIEW_TIME_t reportTime = 1700000000;
+    uint64_t start, elapsed;
+    uint8_t *buffer;
+    uint32_t seed = 1;
+    int i;
+
+    bstjson_memory_init();
+    bstjson_diff_init();
+    if (BVIEW_STATUS_SUCCESS != bstjson_parallel_init(numThreads))
+    {
+        printf("%d threads : pool not started\n", numThreads);
+        return 1;
+    }
+
+    bench_report_asic_init(&asic);
+    bench_report_options_init(&options, &maxBuffers);
+    bench_report_snapshot_fill(&current, BENCH_PARALLEL_OCCUPANCY, &seed);
+
+    start = bench_now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        if (BVIEW_STATUS_SUCCESS != bstjson_encode_get_bst_report(0, 1, NULL, &current, &options,
+                                                                   &asic, &reportTime, &buffer))
+        {
+            printf("%d threads : encoding failed\n", numThreads);
+            return 1;
+        }
+        bstjson_memory_free(buffer);
+    }
+    elapsed = bench_now_ns() - start;
+
+    printf("%d threads : %8.1f us/report (%d running)\n", numThreads,
+           (double) elapsed / iterations / 1000.0, bstjson_parallel_threads_get());
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int iterations = bench_iterations(argc, argv, BENCH_PARALLEL_ITERATIONS);
+    int numThreads, status, rv = 0;
+    pid_t pid;
+
+    for (numThreads = 1; numThreads <= BSTJSON_PARALLEL_MAX_THREADS; numThreads++)
+    {
+        fflush(stdout);
+        pid = fork();
+        if (pid < 0)
+        {
+            printf("fork failed\n");
+            return 1;
+        }
+        if (0 == pid)
+        {
+            exit(bench_parallel_run(numThreads, iterations));
+        }
+        if ((waitpid(pid, &status, 0) != pid) || !WIFEXITED(status) || (0 != WEXITSTATUS(status)))
+        {
+            rv = 1;
+        }
+    }
+
+    return rv;
+}
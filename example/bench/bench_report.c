@@ -0,0 +1,104 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "bench_report.h"
+
+/* The encoders print ports and asics through the system notation of the
+   south bound plugin, plain numbers are enough here. */
+BVIEW_STATUS sbapi_system_port_translate_to_notation(int asic, int port, char *dst)
+{
+    (void) asic;
+    sprintf(dst, "%d", port);
+    return BVIEW_STATUS_SUCCESS;
+}
+
+BVIEW_STATUS sbapi_system_port_translate_from_notation(char *src, int *port)
+{
+    *port = atoi(src);
+    return BVIEW_STATUS_SUCCESS;
+}
+
+BVIEW_STATUS sbapi_system_asic_translate_to_notation(int asic, char *dst)
+{
+    sprintf(dst, "%d", asic);
+    return BVIEW_STATUS_SUCCESS;
+}
+
+void bench_report_asic_init(BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    memset(asic, 0, sizeof(BVIEW_ASIC_CAPABILITIES_t));
+    asic->numPorts = BVIEW_ASIC_MAX_PORTS;
+    asic->numUnicastQueues = BVIEW_ASIC_MAX_UC_QUEUES;
+    asic->numUnicastQueueGroups = BVIEW_ASIC_MAX_UC_QUEUE_GROUPS;
+    asic->numMulticastQueues = BVIEW_ASIC_MAX_MC_QUEUES;
+    asic->numServicePools = BVIEW_ASIC_MAX_SERVICE_POOLS;
+    asic->numCommonPools = BVIEW_ASIC_MAX_COMMON_POOLS;
+    asic->numCpuQueues = BVIEW_ASIC_MAX_CPU_QUEUES;
+    asic->numRqeQueues = BVIEW_ASIC_MAX_RQE_QUEUES;
+    asic->numRqeQueuePools = BVIEW_ASIC_MAX_RQE_QUEUE_POOLS;
+    asic->numPriorityGroups = BVIEW_ASIC_MAX_PRIORITY_GROUPS;
+    asic->cellToByteConv = 208;
+}
+
+void bench_report_snapshot_fill(BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                int occupancy, uint32_t *seed)
+{
+    uint64_t *words = (uint64_t *) snapshot;
+    size_t i;
+
+    for (i = 0; i < sizeof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t) / sizeof(uint64_t); i++)
+    {
+        words[i] = ((int) (bench_rand(seed) % 100) < occupancy) ? (bench_rand(seed) % 100000) : 0;
+    }
+
+    /* the port of every unicast queue */
+    for (i = 0; i < BVIEW_ASIC_MAX_UC_QUEUES; i++)
+    {
+        snapshot->eUcQ.data[i].port = (i / 32) + 1;
+    }
+}
+
+void bench_report_options_init(BSTJSON_REPORT_OPTIONS_t *options,
+                               BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers)
+{
+    uint64_t *words = (uint64_t *) maxBuffers;
+    size_t i;
+
+    for (i = 0; i < sizeof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t) / sizeof(uint64_t); i++)
+    {
+        words[i] = 200000;
+    }
+
+    memset(options, 0, sizeof(BSTJSON_REPORT_OPTIONS_t));
+    options->includeIngressPortPriorityGroup = true;
+    options->includeIngressPortServicePool = true;
+    options->includeIngressServicePool = true;
+    options->includeEgressPortServicePool = true;
+    options->includeEgressServicePool = true;
+    options->includeEgressUcQueue = true;
+    options->includeEgressUcQueueGroup = true;
+    options->includeEgressMcQueue = true;
+    options->includeEgressCpuQueue = true;
+    options->includeEgressRqeQueue = true;
+    options->includeDevice = true;
+    options->bst_max_buffers_ptr = maxBuffers;
+}
@@ -0,0 +1,45 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#ifndef INCLUDE_BENCH_REPORT_H
+#define INCLUDE_BENCH_REPORT_H
+
+#include <stdint.h>
+#include "broadview.h"
+#include "bst.h"
+#include "system.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "bst_json_encoder.h"
+
+/* Synthetic reports for the encoder benchmarks. The asic is sized like the
+   largest one of asic.h (130 ports, 4096 unicast queues), every realm is
+   included and the counters are in bytes. */
+
+/* the asic capabilities of the reports */
+void bench_report_asic_init(BVIEW_ASIC_CAPABILITIES_t *asic);
+
+/* fills a snapshot, 'occupancy' percent of the counters being non zero */
+void bench_report_snapshot_fill(BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                int occupancy, uint32_t *seed);
+
+/* the options of a periodic report of every realm */
+void bench_report_options_init(BSTJSON_REPORT_OPTIONS_t *options,
+                               BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers);
+
+#endif /* INCLUDE_BENCH_REPORT_H */
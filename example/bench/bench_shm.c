@@ -0,0 +1,109 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+/*
+ * Shared memory snapshot benchmark (sbplugin_shm_bst.c,
+ * sbplugin_shm_region.c).
+ *
+ * Attaches the region of a running SHM producer, example/shm_producer,
+ * as the SHM plugin does, and takes full snapshots through the snapshot
+ * get of the plugin. Prints the mean, median, 99th percentile and
+ * longest snapshot get, and the copies lost to the producer updating the
+ * region meanwhile show in the tail. Without a producer there is nothing
+ * to measure, the benchmark says so and stops.
+ *
+ *   usage : bench_shm [iterations]
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include "broadview.h"
+#include "sbplugin_shm.h"
+#include "bench.h"
+
+#define BENCH_SHM_ITERATIONS    20000
+
+/* The region and the BST feature of the SHM plugin are linked as they
+   are, the log and the unit check of the plugin are stubbed. */
+int sbShmDebugFlag = false;
+
+void log_post(BVIEW_SEVERITY severity, char *format, ...)
+{
+    (void) severity;
+    (void) format;
+}
+
+BVIEW_STATUS sbplugin_shm_valid_unit_check(int unit)
+{
+    return ((unit >= 0) && (unit < sbplugin_shm_region_num_asics_get())) ?
+           BVIEW_STATUS_SUCCESS : BVIEW_STATUS_FAILURE;
+}
+
+static int bench_shm_compare(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *) a, y = *(const uint64_t *) b;
+
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[])
+{
+    static BVIEW_BST_ASIC_SNAPSHOT_DATA_t snapshot;
+    BVIEW_SB_BST_FEATURE_t feature;
+    BVIEW_TIME_t time;
+    int iterations = bench_iterations(argc, argv, BENCH_SHM_ITERATIONS);
+    uint64_t *samples, start, total = 0;
+    int i;
+
+    if (0 != access(BVIEW_SHM_SOCKET_PATH, F_OK))
+    {
+        printf("no producer on %s, start example/shm_producer first\n", BVIEW_SHM_SOCKET_PATH);
+        return 0;
+    }
+
+    samples = calloc(iterations, sizeof(uint64_t));
+    memset(&feature, 0, sizeof(feature));
+    if ((NULL == samples) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_shm_region_init()) ||
+        (BVIEW_STATUS_SUCCESS != sbplugin_shm_bst_init(&feature)))
+    {
+        printf("the producer region can not be attached\n");
+        return 1;
+    }
+
+    for (i = 0; i < iterations; i++)
+    {
+        start = bench_now_ns();
+        if (BVIEW_STATUS_SUCCESS != feature.bst_snapshot_get_cb(0, &snapshot, &time))
+        {
+            printf("snapshot get failed\n");
+            return 1;
+        }
+        samples[i] = bench_now_ns() - start;
+        total += samples[i];
+    }
+    qsort(samples, iterations, sizeof(uint64_t), bench_shm_compare);
+
+    printf("snapshot    : %8.2f us mean %8.2f us median %8.2f us p99 %8.2f us max (%zu bytes)\n",
+           (double) total / iterations / 1000.0, (double) samples[iterations / 2] / 1000.0,
+           (double) samples[(iterations * 99) / 100] / 1000.0,
+           (double) samples[iterations - 1] / 1000.0, sizeof(snapshot));
+
+    free(samples);
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+/*
+ * JSON writer benchmark (json_writer.h).
+ *
+ * Encodes the 4096 unicast queues of a report, " [  queue , "port" ,
+ * counter ] ," per queue, once with the snprintf template the encoders
+ * used before and once with the bounded writer they use now, checks that
+ * both produce the same bytes, and prints the time per realm for small and
+ * large counters.
+ *
+ *   usage : bench_writer [iterations]
+ */
+
+#include <string.h>
+#include <inttypes.h>
+#include "broadview.h"
+#include "asic.h"
+#include "json_writer.h"
+#include "bench.h"
+
+#define BENCH_WRITER_ITERATIONS    2000
+#define BENCH_WRITER_QUEUES        BVIEW_ASIC_MAX_UC_QUEUES
+#define BENCH_WRITER_BUFFER_SIZE   (BENCH_WRITER_QUEUES * 64)
+
+static uint64_t benchWriterCounters[BENCH_WRITER_QUEUES];
+static char benchWriterPorts[BENCH_WRITER_QUEUES][8];
+
+/* the encoder before the writer : one snprintf per row */
+static int bench_writer_snprintf(char *buffer, int bufLen)
+{
+    const char *dataTemplate = " [  %d , \"%s\" , %" PRIu64 " ] ,";
+    int length = 0;
+    int queue, n;
+
+    for (queue = 0; queue < BENCH_WRITER_QUEUES; queue++)
+    {
+        n = snprintf(&buffer[length], bufLen - length, dataTemplate, queue,
+                     benchWriterPorts[queue], benchWriterCounters[queue]);
+        if ((n < 0) || (n >= bufLen - length))
+        {
+            return -1;
+        }
+        length += n;
+    }
+
+    return length;
+}
+
+/* the encoder with the writer */
+static int bench_writer_append(char *buffer, int bufLen)
+{
+    JSON_WRITER_t writer;
+    int queue;
+
+    json_writer_init(&writer, buffer, bufLen);
+
+    for (queue = 0; queue < BENCH_WRITER_QUEUES; queue++)
+    {
+        JSON_WRITER_APPEND_LITERAL(&writer, " [  ");
+        json_writer_append_int(&writer, queue);
+        JSON_WRITER_APPEND_LITERAL(&writer, " , \"");
+        json_writer_append_str(&writer, benchWriterPorts[queue]);
+        JSON_WRITER_APPEND_LITERAL(&writer, "\" , ");
+        json_writer_append_u64(&writer, benchWriterCounters[queue]);
+        JSON_WRITER_APPEND_LITERAL(&writer, " ] ,");
+    }
+
+    if (json_writer_overflow(&writer))
+    {
+        return -1;
+    }
+
+    return json_writer_length(&writer);
+}
+
+int main(int argc, char *argv[])
+{
+    static char expected[BENCH_WRITER_BUFFER_SIZE];
+    static char buffer[BENCH_WRITER_BUFFER_SIZE];
+    static const uint64_t ranges[] = { 1000ULL, 100000000ULL, UINT64_MAX };
+    static const char *rangeNames[] = { "small", "medium", "large" };
+    int iterations = bench_iterations(argc, argv, BENCH_WRITER_ITERATIONS);
+    int (*encoders[])(char *, int) = { bench_writer_snprintf, bench_writer_append };
+    const char *encoderNames[] = { "snprintf", "writer" };
+    uint64_t start, elapsed;
+    uint32_t seed = 1;
+    int r, e, i, length = 0, expectedLength;
+
+    for (i = 0; i < BENCH_WRITER_QUEUES; i++)
+    {
+        snprintf(benchWriterPorts[i], sizeof(benchWriterPorts[i]), "%d", (i / 32) + 1);
+    }
+
+    for (r = 0; r < (int) (sizeof(ranges) / sizeof(ranges[0])); r++)
+    {
+        for (i = 0; i < BENCH_WRITER_QUEUES; i++)
+        {
+            benchWriterCounters[i] = ((((uint64_t) bench_rand(&seed)) << 40) ^
+                                      (((uint64_t) bench_rand(&seed)) << 16) ^
+                                      bench_rand(&seed)) % ranges[r];
+        }
+
+        expectedLength = bench_writer_snprintf(expected, sizeof(expected));
+
+        for (e = 0; e < 2; e++)
+        {
+            start = bench_now_ns();
+            for (i = 0; i < iterations; i++)
+            {
+                length = encoders[e](buffer, sizeof(buffer));
+            }
+            elapsed = bench_now_ns() - start;
+
+            if ((length != expectedLength) || (0 != memcmp(buffer, expected, length)))
+            {
+                printf("%-6s %-8s : output differs\n", rangeNames[r], encoderNames[e]);
+                return 1;
+            }
+
+            printf("%-6s %-8s : %9.1f ns/realm %7.1f MB/s (%d bytes)\n",
+                   rangeNames[r], encoderNames[e], (double) elapsed / iterations,
+                   ((double) length * iterations * 1000.0) / (double) elapsed, length);
+        }
+    }
+
+    return 0;
+}
@@ -63,6 +63,7 @@ extern "C"
 
 #define BSTAPP_COMMUNICATION_LOG_FILE   "/tmp/bstapp_communication.log"   
 
+#define BSTAPP_HTTP_CRLF          "\r\n"
 #define BSTAPP_HTTP_TWIN_CRLF     "\r\n\r\n"
 
 typedef struct _bstapp_config_
@@ -110,6 +111,11 @@ int bstapp_debug_menu(void *config);
 
 int bstapp_http_server_run(BSTAPP_CONFIG_t *config);
 
+/* binary reports */
+bool bstapp_binary_report_check(const char *body, int length);
+
+int bstapp_binary_report_decode(const char *body, int length, char *json, int jsonLength);
+
 
 
 #ifdef	__cplusplus
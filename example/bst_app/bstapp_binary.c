@@ -0,0 +1,371 @@
+/*****************************************************************************
+*
+* (C) Copyright Broadcom Corporation 2015
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+*
+* You may obtain a copy of the License at
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+***************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include <inttypes.h>
+
+#include "bstapp.h"
+#include "bstapp_debug.h"
+
+/* Reference decoder for the binary BST reports ("report-format" : 1).
+ * The message layout is described in the agent's bst_bin_encoder.h.
+ * A message is turned back into the JSON text the agent would have sent,
+ * so that it can be handled like any other report.
+ */
+
+#define BSTAPP_BINARY_MAGIC           "BSTB"
+#define BSTAPP_BINARY_MAGIC_LENGTH    4
+#define BSTAPP_BINARY_VERSION         1
+
+#define BSTAPP_BINARY_KIND_THRESHOLDS 1
+#define BSTAPP_BINARY_KIND_TRIGGER    2
+
+#define BSTAPP_BINARY_FLAG_SEQUENCED  (0x01 << 2)
+#define BSTAPP_BINARY_FLAG_KEYFRAME   (0x01 << 3)
+#define BSTAPP_BINARY_FLAG_STALE      (0x01 << 4)
+
+#define BSTAPP_BINARY_REALM_DEVICE    1
+
+/* how a realm is laid out in the message */
+typedef struct _bstapp_binary_realm_
+{
+    const char *name;
+    /* index name, after "port" for the realms indexed by port */
+    const char *index;
+    bool byPort;
+    /* rows carry the queue's port */
+    bool rowPort;
+    int numCounters;
+} BSTAPP_BINARY_REALM_t;
+
+/* indexed by the realm id */
+static const BSTAPP_BINARY_REALM_t bstappBinaryRealms[] = {
+    { NULL, NULL, false, false, 0 },
+    { "device", NULL, false, false, 1 },
+    { "ingress-service-pool", "service-pool", false, false, 1 },
+    { "ingress-port-service-pool", "service-pool", true, false, 1 },
+    { "ingress-port-priority-group", "priority-group", true, false, 2 },
+    { "egress-port-service-pool", "service-pool", true, false, 3 },
+    { "egress-service-pool", "service-pool", false, false, 3 },
+    { "egress-uc-queue", "queue", false, true, 1 },
+    { "egress-uc-queue-group", "queue-group", false, false, 1 },
+    { "egress-mc-queue", "queue", false, true, 2 },
+    { "egress-cpu-queue", "queue", false, false, 2 },
+    { "egress-rqe-queue", "queue", false, false, 2 }
+};
+
+#define BSTAPP_BINARY_NUM_REALMS  ((int) (sizeof(bstappBinaryRealms) / sizeof(bstappBinaryRealms[0])))
+
+/* input being read and output being written */
+typedef struct _bstapp_binary_ctx_
+{
+    const unsigned char *in;
+    int inLength;
+    int inPos;
+    char *out;
+    int outLength;
+    int outPos;
+    bool error;
+} BSTAPP_BINARY_CTX_t;
+
+static void bstapp_binary_print(BSTAPP_BINARY_CTX_t *ctx, const char *format, ...)
+{
+    va_list args;
+    int len;
+
+    if (ctx->error)
+    {
+        return;
+    }
+
+    va_start(args, format);
+    len = vsnprintf(ctx->out + ctx->outPos, ctx->outLength - ctx->outPos, format, args);
+    va_end(args);
+
+    if ((len < 0) || (len >= (ctx->outLength - ctx->outPos)))
+    {
+        ctx->error = true;
+        return;
+    }
+    ctx->outPos += len;
+}
+
+static uint8_t bstapp_binary_byte(BSTAPP_BINARY_CTX_t *ctx)
+{
+    if (ctx->inPos >= ctx->inLength)
+    {
+        ctx->error = true;
+        return 0;
+    }
+    return ctx->in[ctx->inPos++];
+}
+
+static uint64_t bstapp_binary_varint(BSTAPP_BINARY_CTX_t *ctx)
+{
+    uint64_t value = 0;
+    uint8_t byte;
+    int shift = 0;
+
+    do
+    {
+        byte = bstapp_binary_byte(ctx);
+        if (shift < 64)
+        {
+            value |= ((uint64_t) (byte & 0x7F)) << shift;
+        }
+        shift += 7;
+    } while ((byte & 0x80) && (false == ctx->error));
+
+    return value;
+}
+
+static int64_t bstapp_binary_signed(BSTAPP_BINARY_CTX_t *ctx)
+{
+    uint64_t value = bstapp_binary_varint(ctx);
+
+    return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+}
+
+/* copies a length prefixed string into 'str' */
+static void bstapp_binary_string(BSTAPP_BINARY_CTX_t *ctx, char *str, int strLength)
+{
+    uint64_t len = bstapp_binary_varint(ctx);
+
+    if ((ctx->error) || (len >= (uint64_t) strLength) ||
+        (len > (uint64_t) (ctx->inLength - ctx->inPos)))
+    {
+        ctx->error = true;
+        str[0] = 0;
+        return;
+    }
+
+    memcpy(str, ctx->in + ctx->inPos, (size_t) len);
+    str[len] = 0;
+    ctx->inPos += (int) len;
+}
+
+/* rows of a realm, or of a port of a realm, up to the terminating 0 */
+static void bstapp_binary_rows(BSTAPP_BINARY_CTX_t *ctx, const BSTAPP_BINARY_REALM_t *realm)
+{
+    char port[BSTAPP_MAX_STRING_LENGTH];
+    uint64_t step;
+    int64_t index = -1;
+    int i;
+    bool first = true;
+
+    while (false == ctx->error)
+    {
+        step = bstapp_binary_varint(ctx);
+        if (0 == step)
+        {
+            break;
+        }
+        index += (int64_t) step;
+
+        bstapp_binary_print(ctx, "%s [ %" PRId64, first ? "" : ",", index);
+        first = false;
+
+        if (realm->rowPort)
+        {
+            bstapp_binary_string(ctx, port, sizeof(port));
+            bstapp_binary_print(ctx, ", \"%s\"", port);
+        }
+
+        for (i = 0; i < realm->numCounters; i++)
+        {
+            bstapp_binary_print(ctx, ", %" PRIu64, bstapp_binary_varint(ctx));
+        }
+        bstapp_binary_print(ctx, " ]");
+    }
+}
+
+/* one realm, its id already read */
+static void bstapp_binary_realm(BSTAPP_BINARY_CTX_t *ctx, const BSTAPP_BINARY_REALM_t *realm)
+{
+    char port[BSTAPP_MAX_STRING_LENGTH];
+    bool first = true;
+
+    if (NULL == realm->index)
+    {
+        bstapp_binary_print(ctx, "{ \"realm\": \"%s\", \"data\": %" PRIu64 " }",
+                            realm->name, bstapp_binary_varint(ctx));
+        return;
+    }
+
+    bstapp_binary_print(ctx, "{ \"realm\": \"%s\", \"data\": [", realm->name);
+
+    if (false == realm->byPort)
+    {
+        bstapp_binary_rows(ctx, realm);
+    }
+    else
+    {
+        /* the port number is not needed, the port string follows it */
+        while ((false == ctx->error) && (0 != bstapp_binary_varint(ctx)))
+        {
+            bstapp_binary_string(ctx, port, sizeof(port));
+            bstapp_binary_print(ctx, "%s { \"port\": \"%s\", \"data\": [", first ? "" : ",", port);
+            bstapp_binary_rows(ctx, realm);
+            bstapp_binary_print(ctx, " ] }");
+            first = false;
+        }
+    }
+
+    bstapp_binary_print(ctx, " ] }");
+}
+
+/******************************************************************
+ * @brief  Tells if a report body is in the binary format.
+ *
+ *********************************************************************/
+bool bstapp_binary_report_check(const char *body, int length)
+{
+    return ((length >= BSTAPP_BINARY_MAGIC_LENGTH) &&
+            (0 == memcmp(body, BSTAPP_BINARY_MAGIC, BSTAPP_BINARY_MAGIC_LENGTH)));
+}
+
+/******************************************************************
+ * @brief  Turns a binary report into the equivalent JSON text.
+ *
+ * @param[in]   body       the binary message
+ * @param[in]   length     number of bytes in the message
+ * @param[out]  json       buffer for the JSON text
+ * @param[in]   jsonLength size of the buffer
+ *
+ * @retval   length of the JSON text, -1 if the message is malformed or
+ *           the text does not fit.
+ *********************************************************************/
+int bstapp_binary_report_decode(const char *body, int length, char *json, int jsonLength)
+{
+    BSTAPP_BINARY_CTX_t ctx;
+    char asicId[BSTAPP_MAX_STRING_LENGTH];
+    char counter[BSTAPP_MAX_STRING_LENGTH];
+    char port[BSTAPP_MAX_STRING_LENGTH];
+    char timeString[BSTAPP_MAX_STRING_LENGTH] = { 0 };
+    const BSTAPP_BINARY_REALM_t *trigger = NULL;
+    uint8_t kind, flags, id;
+    uint64_t version;
+    uint64_t sequence = 0;
+    time_t reportTime;
+    int64_t queue = 0;
+    bool first = true;
+
+    _BSTAPP_ASSERT((body != NULL) && (json != NULL) && (jsonLength > 0));
+    _BSTAPP_ASSERT(bstapp_binary_report_check(body, length));
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.in = (const unsigned char *) body;
+    ctx.inLength = length;
+    ctx.inPos = BSTAPP_BINARY_MAGIC_LENGTH;
+    ctx.out = json;
+    ctx.outLength = jsonLength;
+
+    if (BSTAPP_BINARY_VERSION != bstapp_binary_byte(&ctx))
+    {
+        _BSTAPP_LOG(_BSTAPP_DEBUG_ERROR, "BSTAPP : Unsupported binary report version \n");
+        return -1;
+    }
+
+    kind = bstapp_binary_byte(&ctx);
+    /* the units flags are not needed, the counters are printed as they come */
+    flags = bstapp_binary_byte(&ctx);
+    bstapp_binary_string(&ctx, asicId, sizeof(asicId));
+    version = bstapp_binary_varint(&ctx);
+    reportTime = (time_t) bstapp_binary_varint(&ctx);
+    if (flags & BSTAPP_BINARY_FLAG_SEQUENCED)
+    {
+        sequence = bstapp_binary_varint(&ctx);
+    }
+    strftime(timeString, sizeof(timeString), "%Y-%m-%d - %H:%M:%S ", localtime(&reportTime));
+
+    bstapp_binary_print(&ctx, "{ \"jsonrpc\": \"2.0\", \"method\": \"%s\", \"asic-id\": \"%s\", "
+                        "\"version\": \"%" PRIu64 "\", \"time-stamp\": \"%s\", ",
+                        (BSTAPP_BINARY_KIND_TRIGGER == kind) ? "trigger-report" :
+                        (BSTAPP_BINARY_KIND_THRESHOLDS == kind) ? "get-bst-thresholds" : "get-bst-report",
+                        asicId, version, timeString);
+
+    if (flags & BSTAPP_BINARY_FLAG_SEQUENCED)
+    {
+        bstapp_binary_print(&ctx, "\"sequence-number\": %" PRIu64 ", \"keyframe\": %d, ",
+                            sequence, (flags & BSTAPP_BINARY_FLAG_KEYFRAME) ? 1 : 0);
+    }
+    if (flags & BSTAPP_BINARY_FLAG_STALE)
+    {
+        bstapp_binary_print(&ctx, "\"stale\": 1, ");
+    }
+
+    if (BSTAPP_BINARY_KIND_TRIGGER == kind)
+    {
+        id = bstapp_binary_byte(&ctx);
+        bstapp_binary_string(&ctx, counter, sizeof(counter));
+        bstapp_binary_string(&ctx, port, sizeof(port));
+        queue = bstapp_binary_signed(&ctx);
+
+        if ((0 == id) || (id >= BSTAPP_BINARY_NUM_REALMS))
+        {
+            ctx.error = true;
+        }
+        else
+        {
+            trigger = &bstappBinaryRealms[id];
+            bstapp_binary_print(&ctx, "\"realm\": \"%s\", \"counter\": \"%s\", ", trigger->name, counter);
+            if (0 != port[0])
+            {
+                bstapp_binary_print(&ctx, "\"port\": \"%s\", ", port);
+            }
+            if (NULL != trigger->index)
+            {
+                bstapp_binary_print(&ctx, "\"%s\": %" PRId64 ", ", trigger->index, queue);
+            }
+        }
+    }
+
+    bstapp_binary_print(&ctx, "\"report\": [");
+
+    while (false == ctx.error)
+    {
+        id = bstapp_binary_byte(&ctx);
+        if (0 == id)
+        {
+            break;
+        }
+        if (id >= BSTAPP_BINARY_NUM_REALMS)
+        {
+            ctx.error = true;
+            break;
+        }
+
+        bstapp_binary_print(&ctx, first ? " " : ", ");
+        bstapp_binary_realm(&ctx, &bstappBinaryRealms[id]);
+        first = false;
+    }
+
+    bstapp_binary_print(&ctx, " ] }");
+
+    if (ctx.error)
+    {
+        _BSTAPP_LOG(_BSTAPP_DEBUG_ERROR, "BSTAPP : Malformed binary report at byte %d \n", ctx.inPos);
+        return -1;
+    }
+
+    return ctx.outPos;
+}
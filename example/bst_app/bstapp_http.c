@@ -17,6 +17,7 @@
 ***************************************************************************/
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <unistd.h>
@@ -32,6 +33,56 @@
 
 extern BSTAPP_REST_MSG_t bstRestMessages[];
 
+/******************************************************************
+ * @brief  Decodes, in place, the body of a message sent with
+ *         chunked transfer encoding.
+ *
+ * @param[in,out] body    chunked body, '\0' terminated
+ * @param[in]     length  number of bytes in the body
+ *
+ * @retval   number of bytes of the decoded body
+ *
+ * @note     a truncated body is decoded up to its last whole chunk.
+ *********************************************************************/
+static int bstapp_http_dechunk(char *body, int length)
+{
+    char *in = body;
+    char *out = body;
+    char *end = body + length;
+    char *next;
+    long size;
+
+    while (in < end)
+    {
+        size = strtol(in, &next, 16);
+        if (next == in)
+        {
+            break;
+        }
+
+        /* skip any chunk extension, up to the end of the line */
+        in = strstr(next, BSTAPP_HTTP_CRLF);
+        if (NULL == in)
+        {
+            break;
+        }
+        in += strlen(BSTAPP_HTTP_CRLF);
+
+        /* the last chunk has no data */
+        if ((size <= 0) || (size > (long) (end - in)))
+        {
+            break;
+        }
+
+        memmove(out, in, size);
+        out += size;
+        in += size + strlen(BSTAPP_HTTP_CRLF);
+    }
+
+    *out = '\0';
+    return (int) (out - body);
+}
+
 /******************************************************************
  * @brief  This function processes incoming http request .
  *
@@ -45,6 +96,11 @@ int bstapp_read_from_agent (int fd )
     int length = 0;
     int temp = 0;
     char report[BSTAPP_MAX_REPORT_LENGTH];
+    static char json[BSTAPP_MAX_REPORT_LENGTH];
+    char *body;
+    char saved;
+    bool chunked;
+    int jsonLength = 0;
 
     _BSTAPP_LOG(_BSTAPP_DEBUG_TRACE, "Extracting data from incoming report  \n");
 
@@ -53,7 +109,7 @@ int bstapp_read_from_agent (int fd )
     /* Read data from incoming request into the buffer */
     do
     {
-        temp = read(fd, (buf + length), (BSTAPP_MAX_REPORT_LENGTH - length));
+        temp = read(fd, (buf + length), (BSTAPP_MAX_REPORT_LENGTH - 1 - length));
         if (temp > 0)
         {
             length += temp;
@@ -65,6 +121,7 @@ int bstapp_read_from_agent (int fd )
     } while (temp > 0);
 
     close(fd);
+    buf[(length > 0) ? length : 0] = '\0';
 
     /* if there is any error reading */
     if ((temp < 0) && (length <= 0))
@@ -75,6 +132,40 @@ int bstapp_read_from_agent (int fd )
         return -1;
     }
 
+    /* a binary report is logged as the JSON it stands for */
+    for (body = buf; body + strlen(BSTAPP_HTTP_TWIN_CRLF) <= buf + length; body++)
+    {
+        if (0 != memcmp(body, BSTAPP_HTTP_TWIN_CRLF, strlen(BSTAPP_HTTP_TWIN_CRLF)))
+        {
+            continue;
+        }
+
+        body += strlen(BSTAPP_HTTP_TWIN_CRLF);
+
+        /* streamed reports come in chunks, log them as one body */
+        saved = *body;
+        *body = '\0';
+        chunked = (NULL != strstr(buf, "Transfer-Encoding: chunked"));
+        *body = saved;
+        if (chunked)
+        {
+            length = (int) (body - buf) +
+                     bstapp_http_dechunk(body, length - (int) (body - buf));
+        }
+
+        if (bstapp_binary_report_check(body, length - (int) (body - buf)))
+        {
+            jsonLength = bstapp_binary_report_decode(body, length - (int) (body - buf),
+                                                     &json[0], BSTAPP_MAX_REPORT_LENGTH);
+            if (jsonLength > 0)
+            {
+                bstapp_message_log(&json[0], jsonLength, true);
+                return 0;
+            }
+        }
+        break;
+    }
+
     bstapp_message_log(buf, length, true);
 
     return 0;
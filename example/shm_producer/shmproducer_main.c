@@ -0,0 +1,568 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+/*
+ * Reference producer of the SHM south bound plugin.
+ *
+ * A producer runs next to the switch driver and publishes the BST data of
+ * the driver in the region of sbplugin_shm_region.h. This one publishes
+ * synthetic counters, a bounded random walk, so the agent can be run and
+ * measured without a switch : a real producer reads the driver where
+ * shmproducer_collect () makes the values up.
+ *
+ * It creates the region, hands its eventfds to the agent connecting to the
+ * socket, publishes the counters every interval under the sequence lock,
+ * queues a trigger when a counter crosses its threshold, and applies the
+ * requests of the agent.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "sbplugin_shm_region.h"
+
+/* publish period, milliseconds */
+#define SHMPRODUCER_INTERVAL_DEFAULT   1000
+#define SHMPRODUCER_PORTS_DEFAULT      72
+/* max buffers published for every counter, and bound of the walk */
+#define SHMPRODUCER_MAX_BUF            100000
+/* step of the walk */
+#define SHMPRODUCER_STEP               512
+
+/* TD2 scaling */
+#define SHMPRODUCER_NUM_UC_QUEUE       2960
+#define SHMPRODUCER_NUM_UC_QUEUE_GRP   128
+#define SHMPRODUCER_NUM_MC_QUEUE       1040
+#define SHMPRODUCER_NUM_SP             4
+#define SHMPRODUCER_NUM_COMMON_SP      1
+#define SHMPRODUCER_NUM_RQE            11
+#define SHMPRODUCER_NUM_RQE_POOL       4
+#define SHMPRODUCER_NUM_PG             8
+#define SHMPRODUCER_CPU_COSQ           8
+#define SHMPRODUCER_CELL_TO_BYTE       208
+
+#define SHMPRODUCER_REALM_WORDS_MAX    4
+
+/* A realm of the snapshot : a section of dim1 x dim2 entries of words
+   uint64 values each, the first thresholdWords being the threshold
+   structure of the realm, in order. */
+typedef struct _shmproducer_realm_
+{
+  BVIEW_BST_REALM_ID_t    realm;
+  size_t                  offset;
+  int                     dim1;
+  int                     dim2;
+  int                     words;
+  int                     thresholdWords;
+  /* the first index is a port, numbered from 1 outside */
+  bool                    portIndexed;
+  /* counter of each word, BVIEW_BST_COUNTER_UNKNOWN if the word is none */
+  BVIEW_BST_COUNTER_ID_t  counters[SHMPRODUCER_REALM_WORDS_MAX];
+} SHMPRODUCER_REALM_t;
+
+#define SHMPRODUCER_SECTION(_field)   offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, _field)
+
+static const SHMPRODUCER_REALM_t shmproducerRealms[] = {
+  { BVIEW_BST_DEVICE, SHMPRODUCER_SECTION (device), 1, 1, 1, 1, false,
+    { BVIEW_BST_COUNTER_DATA } },
+  { BVIEW_BST_INGRESS_PORT_PG, SHMPRODUCER_SECTION (iPortPg),
+    BVIEW_ASIC_MAX_PORTS, BVIEW_ASIC_MAX_PRIORITY_GROUPS, 2, 2, true,
+    { BVIEW_BST_COUNTER_UM_SHARE, BVIEW_BST_COUNTER_UM_HEADROOM } },
+  { BVIEW_BST_INGRESS_PORT_SP, SHMPRODUCER_SECTION (iPortSp),
+    BVIEW_ASIC_MAX_PORTS, BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS, 1, 1, true,
+    { BVIEW_BST_COUNTER_UM_SHARE } },
+  { BVIEW_BST_INGRESS_SP, SHMPRODUCER_SECTION (iSp),
+    BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS, 1, 1, 1, false,
+    { BVIEW_BST_COUNTER_UM_SHARE } },
+  { BVIEW_BST_EGRESS_PORT_SP, SHMPRODUCER_SECTION (ePortSp),
+    BVIEW_ASIC_MAX_PORTS, BVIEW_ASIC_MAX_SERVICE_POOLS, 4, 4, true,
+    { BVIEW_BST_COUNTER_UC_SHARE, BVIEW_BST_COUNTER_UM_SHARE,
+      BVIEW_BST_COUNTER_MC_SHARE, BVIEW_BST_COUNTER_UNKNOWN } },
+  { BVIEW_BST_EGRESS_SP, SHMPRODUCER_SECTION (eSp),
+    BVIEW_ASIC_MAX_SERVICE_POOLS, 1, 3, 2, false,
+    { BVIEW_BST_COUNTER_UM_SHARE, BVIEW_BST_COUNTER_MC_SHARE,
+      BVIEW_BST_COUNTER_UNKNOWN } },
+  { BVIEW_BST_EGRESS_UC_QUEUE, SHMPRODUCER_SECTION (eUcQ),
+    BVIEW_ASIC_MAX_UC_QUEUES, 1, 2, 1, false,
+    { BVIEW_BST_COUNTER_UC_BUFFER, BVIEW_BST_COUNTER_UNKNOWN } },
+  { BVIEW_BST_EGRESS_UC_QUEUEGROUPS, SHMPRODUCER_SECTION (eUcQg),
+    BVIEW_ASIC_MAX_UC_QUEUE_GROUPS, 1, 1, 1, false,
+    { BVIEW_BST_COUNTER_UC_BUFFER } },
+  { BVIEW_BST_EGRESS_MC_QUEUE, SHMPRODUCER_SECTION (eMcQ),
+    BVIEW_ASIC_MAX_MC_QUEUES, 1, 3, 2, false,
+    { BVIEW_BST_COUNTER_MC_BUFFER, BVIEW_BST_COUNTER_UNKNOWN,
+      BVIEW_BST_COUNTER_UNKNOWN } },
+  { BVIEW_BST_EGRESS_CPU_QUEUE, SHMPRODUCER_SECTION (cpqQ),
+    BVIEW_ASIC_MAX_CPU_QUEUES, 1, 2, 2, false,
+    { BVIEW_BST_COUNTER_CPU_BUFFER, BVIEW_BST_COUNTER_UNKNOWN } },
+  { BVIEW_BST_EGRESS_RQE_QUEUE, SHMPRODUCER_SECTION (rqeQ),
+    BVIEW_ASIC_MAX_RQE_QUEUES, 1, 2, 2, false,
+    { BVIEW_BST_COUNTER_RQE_BUFFER, BVIEW_BST_COUNTER_RQE_QUEUE } }
+};
+
+#define SHMPRODUCER_REALM_COUNT  (sizeof (shmproducerRealms) / sizeof (shmproducerRealms[0]))
+
+typedef struct _shmproducer_
+{
+  BVIEW_SHM_REGION_t  *region;
+  int                 listenFd;
+  int                 clientFd;
+  int                 eventFd[BVIEW_SHM_EVENTFD_COUNT];
+  int                 interval;
+  BVIEW_BST_CONFIG_t  config;
+  uint64_t            seed;
+} SHMPRODUCER_t;
+
+static SHMPRODUCER_t           producer;
+static volatile sig_atomic_t   shmproducerStop;
+
+static void shmproducer_signal (int sig)
+{
+  (void) sig;
+  shmproducerStop = 1;
+}
+
+static uint64_t shmproducer_random (void)
+{
+  producer.seed ^= producer.seed << 13;
+  producer.seed ^= producer.seed >> 7;
+  producer.seed ^= producer.seed << 17;
+  return producer.seed;
+}
+
+/* first word of entry (index1, index2) of a realm of a snapshot */
+static uint64_t *shmproducer_entry (BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                    const SHMPRODUCER_REALM_t *p_realm,
+                                    int index1, int index2)
+{
+  return (uint64_t *) ((char *) snapshot + p_realm->offset) +
+         ((size_t) index1 * p_realm->dim2 + index2) * p_realm->words;
+}
+
+/* Create the region and describe the ASIC. The magic is written last. */
+static int shmproducer_region_create (int numPorts)
+{
+  BVIEW_SHM_REGION_t  *region;
+  BVIEW_SHM_ASIC_t    *p_asic;
+  uint64_t            *word;
+  size_t              index;
+  int                 fd;
+
+  shm_unlink (BVIEW_SHM_REGION_NAME);
+  fd = shm_open (BVIEW_SHM_REGION_NAME, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0)
+  {
+    perror ("shm_open");
+    return -1;
+  }
+  if (ftruncate (fd, sizeof (BVIEW_SHM_REGION_t)) < 0)
+  {
+    perror ("ftruncate");
+    close (fd);
+    return -1;
+  }
+  region = mmap (NULL, sizeof (BVIEW_SHM_REGION_t), PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd, 0);
+  close (fd);
+  if (MAP_FAILED == region)
+  {
+    perror ("mmap");
+    return -1;
+  }
+
+  region->version = BVIEW_SHM_REGION_VERSION;
+  region->size = sizeof (BVIEW_SHM_REGION_t);
+  region->numAsics = 1;
+
+  p_asic = &region->asics[0];
+  p_asic->asicType = BVIEW_ASIC_TYPE_TD2;
+  p_asic->scalingParams.numPorts = numPorts;
+  p_asic->scalingParams.numUnicastQueues = SHMPRODUCER_NUM_UC_QUEUE;
+  p_asic->scalingParams.numUnicastQueueGroups = SHMPRODUCER_NUM_UC_QUEUE_GRP;
+  p_asic->scalingParams.numMulticastQueues = SHMPRODUCER_NUM_MC_QUEUE;
+  p_asic->scalingParams.numServicePools = SHMPRODUCER_NUM_SP;
+  p_asic->scalingParams.numCommonPools = SHMPRODUCER_NUM_COMMON_SP;
+  p_asic->scalingParams.numCpuQueues = SHMPRODUCER_CPU_COSQ;
+  p_asic->scalingParams.numRqeQueues = SHMPRODUCER_NUM_RQE;
+  p_asic->scalingParams.numRqeQueuePools = SHMPRODUCER_NUM_RQE_POOL;
+  p_asic->scalingParams.numPriorityGroups = SHMPRODUCER_NUM_PG;
+  p_asic->scalingParams.cellToByteConv = SHMPRODUCER_CELL_TO_BYTE;
+  p_asic->scalingParams.support1588 = false;
+
+  /* every max buffer is a uint64 */
+  word = (uint64_t *) &p_asic->maxBuf;
+  for (index = 0; index < sizeof (p_asic->maxBuf) / sizeof (uint64_t); index++)
+  {
+    word[index] = SHMPRODUCER_MAX_BUF;
+  }
+
+  __atomic_store_n (&region->magic, BVIEW_SHM_REGION_MAGIC, __ATOMIC_RELEASE);
+  producer.region = region;
+  return 0;
+}
+
+/* Listen for the agent */
+static int shmproducer_listen (void)
+{
+  struct sockaddr_un addr;
+
+  producer.listenFd = socket (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (producer.listenFd < 0)
+  {
+    perror ("socket");
+    return -1;
+  }
+  memset (&addr, 0, sizeof (addr));
+  addr.sun_family = AF_UNIX;
+  strncpy (addr.sun_path, BVIEW_SHM_SOCKET_PATH, sizeof (addr.sun_path) - 1);
+  unlink (BVIEW_SHM_SOCKET_PATH);
+  if ((bind (producer.listenFd, (struct sockaddr *) &addr, sizeof (addr)) < 0) ||
+      (listen (producer.listenFd, 1) < 0))
+  {
+    perror (BVIEW_SHM_SOCKET_PATH);
+    return -1;
+  }
+  return 0;
+}
+
+/* Take a connecting agent and hand it the eventfds. One agent at a time,
+   a new one replaces the previous. */
+static void shmproducer_accept (void)
+{
+  char            byte = 0;
+  char            control[CMSG_SPACE (sizeof (int) * BVIEW_SHM_EVENTFD_COUNT)];
+  struct iovec    iov = { .iov_base = &byte, .iov_len = sizeof (byte) };
+  struct msghdr   msg;
+  struct cmsghdr  *cmsg;
+  int             fd;
+
+  fd = accept (producer.listenFd, NULL, NULL);
+  if (fd < 0)
+  {
+    return;
+  }
+
+  memset (&msg, 0, sizeof (msg));
+  memset (control, 0, sizeof (control));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof (control);
+  cmsg = CMSG_FIRSTHDR (&msg);
+  cmsg->cmsg_level = SOL_SOCKET;
+  cmsg->cmsg_type = SCM_RIGHTS;
+  cmsg->cmsg_len = CMSG_LEN (sizeof (int) * BVIEW_SHM_EVENTFD_COUNT);
+  memcpy (CMSG_DATA (cmsg), producer.eventFd, sizeof (int) * BVIEW_SHM_EVENTFD_COUNT);
+
+  if (sendmsg (fd, &msg, MSG_NOSIGNAL) < 0)
+  {
+    perror ("sendmsg");
+    close (fd);
+    return;
+  }
+  if (producer.clientFd >= 0)
+  {
+    close (producer.clientFd);
+  }
+  producer.clientFd = fd;
+  printf ("agent attached\n");
+}
+
+/* Apply a threshold request to the thresholds of the region */
+static void shmproducer_threshold_apply (BVIEW_SHM_ASIC_t *p_asic,
+                                         const BVIEW_SHM_REQUEST_t *request)
+{
+  const SHMPRODUCER_REALM_t *p_realm = NULL;
+  uint64_t                  *entry;
+  size_t                    index;
+  int                       index1, index2;
+
+  for (index = 0; index < SHMPRODUCER_REALM_COUNT; index++)
+  {
+    if (shmproducerRealms[index].realm == (BVIEW_BST_REALM_ID_t) request->realm)
+    {
+      p_realm = &shmproducerRealms[index];
+      break;
+    }
+  }
+  if (NULL == p_realm)
+  {
+    return;
+  }
+
+  index1 = (request->index1 < 0) ? 0 : request->index1;
+  index2 = (request->index2 < 0) ? 0 : request->index2;
+  if (p_realm->portIndexed)
+  {
+    index1--;
+  }
+  if ((index1 < 0) || (index1 >= p_realm->dim1) ||
+      (index2 < 0) || (index2 >= p_realm->dim2))
+  {
+    return;
+  }
+
+  entry = shmproducer_entry (&p_asic->thresholds, p_realm, index1, index2);
+  memcpy (entry, request->u.threshold, p_realm->thresholdWords * sizeof (uint64_t));
+}
+
+/* Apply the requests of the agent */
+static void shmproducer_requests_apply (void)
+{
+  BVIEW_SHM_REQUEST_t  request;
+  BVIEW_SHM_ASIC_t     *p_asic;
+  uint64_t             count;
+
+  /* read before the ring, a request queued after it signals again */
+  if (read (producer.eventFd[BVIEW_SHM_EVENTFD_REQUEST], &count, sizeof (count)) < 0)
+  {
+    return;
+  }
+
+  while (bview_shm_request_pop (&producer.region->requests, &request))
+  {
+    if ((request.asic < 0) || (request.asic >= producer.region->numAsics))
+    {
+      continue;
+    }
+    p_asic = &producer.region->asics[request.asic];
+
+    bview_shm_write_begin (p_asic);
+    switch (request.op)
+    {
+      case BVIEW_SHM_REQUEST_CONFIG:
+        producer.config = request.u.config;
+        break;
+      case BVIEW_SHM_REQUEST_THRESHOLD:
+        shmproducer_threshold_apply (p_asic, &request);
+        break;
+      case BVIEW_SHM_REQUEST_CLEAR_STATS:
+        memset (&p_asic->stats, 0, sizeof (p_asic->stats));
+        break;
+      case BVIEW_SHM_REQUEST_CLEAR_THRESHOLDS:
+        memset (&p_asic->thresholds, 0, sizeof (p_asic->thresholds));
+        break;
+      default:
+        break;
+    }
+    bview_shm_write_end (p_asic);
+  }
+}
+
+/* Collect the counters of the ASIC, queueing a trigger for each counter
+   crossing its threshold. Returns the number of triggers queued. */
+static int shmproducer_collect (BVIEW_SHM_ASIC_t *p_asic)
+{
+  const SHMPRODUCER_REALM_t *p_realm;
+  BVIEW_SHM_TRIGGER_t       trigger;
+  uint64_t                  *stat, *threshold, value;
+  size_t                    index;
+  int                       index1, index2, word, triggers = 0;
+
+  bview_shm_write_begin (p_asic);
+  for (index = 0; index < SHMPRODUCER_REALM_COUNT; index++)
+  {
+    p_realm = &shmproducerRealms[index];
+    for (index1 = 0; index1 < p_realm->dim1; index1++)
+    {
+      for (index2 = 0; index2 < p_realm->dim2; index2++)
+      {
+        stat = shmproducer_entry (&p_asic->stats, p_realm, index1, index2);
+        threshold = shmproducer_entry (&p_asic->thresholds, p_realm, index1, index2);
+        for (word = 0; word < p_realm->words; word++)
+        {
+          if (BVIEW_BST_COUNTER_UNKNOWN == p_realm->counters[word])
+          {
+            continue;
+          }
+          value = stat[word] + (shmproducer_random () % (2 * SHMPRODUCER_STEP));
+          value = (value > SHMPRODUCER_STEP) ? value - SHMPRODUCER_STEP : 0;
+          if (value > SHMPRODUCER_MAX_BUF)
+          {
+            value = SHMPRODUCER_MAX_BUF;
+          }
+          /* peak mode keeps the high water mark */
+          if ((BVIEW_BST_MODE_PEAK == producer.config.mode) && (value < stat[word]))
+          {
+            value = stat[word];
+          }
+
+          if ((word < p_realm->thresholdWords) && (0 != threshold[word]) &&
+              (stat[word] < threshold[word]) && (value >= threshold[word]))
+          {
+            trigger.asic = (int32_t) (p_asic - producer.region->asics);
+            trigger.info.realm = p_realm->realm;
+            trigger.info.counter = p_realm->counters[word];
+            trigger.info.port = p_realm->portIndexed ? index1 + 1 : -1;
+            trigger.info.queue = p_realm->portIndexed ? index2 :
+                                 ((1 == p_realm->dim1) ? -1 : index1);
+            if (bview_shm_trigger_push (&producer.region->triggers, &trigger))
+            {
+              triggers++;
+            }
+          }
+          stat[word] = value;
+        }
+      }
+    }
+  }
+  p_asic->time = (int64_t) time (NULL);
+  bview_shm_write_end (p_asic);
+  return triggers;
+}
+
+static void shmproducer_usage (const char *name)
+{
+  fprintf (stderr, "usage: %s [-i interval-msec] [-p ports]\n", name);
+}
+
+int main (int argc, char **argv)
+{
+  struct pollfd    pfd[3];
+  struct timespec  now, next;
+  uint64_t         one = 1;
+  int              numPorts = SHMPRODUCER_PORTS_DEFAULT;
+  int              opt, timeout, asic, triggers;
+
+  producer.interval = SHMPRODUCER_INTERVAL_DEFAULT;
+  producer.clientFd = -1;
+  producer.config.mode = BVIEW_BST_MODE_CURRENT;
+  producer.config.enableStatsMonitoring = true;
+  producer.seed = 88172645463325252ULL ^ (uint64_t) getpid ();
+
+  while ((opt = getopt (argc, argv, "i:p:")) != -1)
+  {
+    switch (opt)
+    {
+      case 'i':
+        producer.interval = atoi (optarg);
+        break;
+      case 'p':
+        numPorts = atoi (optarg);
+        break;
+      default:
+        shmproducer_usage (argv[0]);
+        return 1;
+    }
+  }
+  if ((producer.interval <= 0) || (numPorts <= 0) || (numPorts > BVIEW_ASIC_MAX_PORTS))
+  {
+    shmproducer_usage (argv[0]);
+    return 1;
+  }
+
+  signal (SIGINT, shmproducer_signal);
+  signal (SIGTERM, shmproducer_signal);
+
+  producer.eventFd[BVIEW_SHM_EVENTFD_TRIGGER] = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+  producer.eventFd[BVIEW_SHM_EVENTFD_REQUEST] = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if ((producer.eventFd[BVIEW_SHM_EVENTFD_TRIGGER] < 0) ||
+      (producer.eventFd[BVIEW_SHM_EVENTFD_REQUEST] < 0))
+  {
+    perror ("eventfd");
+    return 1;
+  }
+
+  /* the region exists before the agent can connect */
+  if ((shmproducer_region_create (numPorts) < 0) || (shmproducer_listen () < 0))
+  {
+    shm_unlink (BVIEW_SHM_REGION_NAME);
+    return 1;
+  }
+  printf ("publishing %s every %d msec\n", BVIEW_SHM_REGION_NAME, producer.interval);
+
+  clock_gettime (CLOCK_MONOTONIC, &next);
+  while (!shmproducerStop)
+  {
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    timeout = (int) ((next.tv_sec - now.tv_sec) * 1000 +
+                     (next.tv_nsec - now.tv_nsec) / 1000000);
+    if (timeout <= 0)
+    {
+      triggers = 0;
+      if (producer.config.enableStatsMonitoring)
+      {
+        for (asic = 0; asic < producer.region->numAsics; asic++)
+        {
+          triggers += shmproducer_collect (&producer.region->asics[asic]);
+        }
+      }
+      if ((triggers > 0) &&
+          (write (producer.eventFd[BVIEW_SHM_EVENTFD_TRIGGER], &one, sizeof (one)) < 0))
+      {
+        perror ("eventfd");
+      }
+      next.tv_sec += producer.interval / 1000;
+      next.tv_nsec += (long) (producer.interval % 1000) * 1000000;
+      if (next.tv_nsec >= 1000000000)
+      {
+        next.tv_sec++;
+        next.tv_nsec -= 1000000000;
+      }
+      continue;
+    }
+
+    pfd[0].fd = producer.listenFd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = producer.eventFd[BVIEW_SHM_EVENTFD_REQUEST];
+    pfd[1].events = POLLIN;
+    pfd[2].fd = producer.clientFd;
+    pfd[2].events = POLLIN;
+    if (poll (pfd, 3, timeout) <= 0)
+    {
+      continue;
+    }
+    if (pfd[0].revents & POLLIN)
+    {
+      shmproducer_accept ();
+    }
+    if (pfd[1].revents & POLLIN)
+    {
+      shmproducer_requests_apply ();
+    }
+    if (pfd[2].revents & (POLLIN | POLLHUP | POLLERR))
+    {
+      /* the agent sends nothing, this is its hang up */
+      close (producer.clientFd);
+      producer.clientFd = -1;
+      printf ("agent detached\n");
+    }
+  }
+
+  /* the agent sees the hang up and waits for the next producer */
+  if (producer.clientFd >= 0)
+  {
+    close (producer.clientFd);
+  }
+  close (producer.listenFd);
+  unlink (BVIEW_SHM_SOCKET_PATH);
+  shm_unlink (BVIEW_SHM_REGION_NAME);
+  return 0;
+}
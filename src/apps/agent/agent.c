@@ -51,6 +51,7 @@
 #include <poll-loop.h>
 
 #include "broadview.h"
+#include "bst.h"
 #include "rest.h"
 #include "system.h"
 #include "version.h"
@@ -88,6 +89,13 @@ void broadview_debug_dump(struct ds *ds, int argc, const char *argv[])
 #if BROADVIEW_ENABLE_FEATURE_SUPPORTED
   bool enabled = false;
 #endif
+  if ((argc > 1) && (0 == strcmp(argv[1], "bst")))
+  {
+    bst_debug_dump();
+    ds_put_format(ds, "BST statistics dumped to the console\n");
+    return;
+  }
+
   sys = ovsrec_system_first(idl);
   if (sys) 
   {
@@ -411,7 +419,7 @@ static void broadview_init(const char *db_path, struct unixctl_server *appctl)
   }
 
   /* Register ovs-appctl commands for this daemon. */
-  unixctl_command_register("broadview/dump", "", 0, 2, broadview_unixctl_dump, NULL);
+  unixctl_command_register("broadview/dump", "[bst]", 0, 2, broadview_unixctl_dump, NULL);
 
 } /* broadview_init */
 
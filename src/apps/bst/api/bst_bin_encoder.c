@@ -0,0 +1,616 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stddef.h>
+#include <time.h>
+
+#include "broadview.h"
+
+#include "cJSON.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+
+#include "bst_json_memory.h"
+#include "bst_json_encoder.h"
+#include "bst_json_diff.h"
+#include "bst_json_filter.h"
+#include "bst_json_header.h"
+#include "bst_bin_encoder.h"
+
+/* most converted / raw counters in a row of any realm */
+#define _BSTBIN_MAX_CONVERTED       3
+#define _BSTBIN_MAX_RAW             1
+
+/* position of counter '_field' within an entry of a snapshot realm, in uint64_t words */
+#define _BSTBIN_WORD(_type, _entry, _field) \
+    ((int) ((offsetof(_type, _entry._field) - offsetof(_type, _entry)) / sizeof(uint64_t)))
+
+#define _BSTBIN_SNAP_WORD(_entry, _field)    _BSTBIN_WORD(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, _entry, _field)
+#define _BSTBIN_MAXBUF_WORD(_entry, _field)  _BSTBIN_WORD(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, _entry, _field)
+
+/* size of an entry of a snapshot realm, in uint64_t words */
+#define _BSTBIN_SNAP_STRIDE(_entry) \
+    ((int) (sizeof(((BVIEW_BST_ASIC_SNAPSHOT_DATA_t *) 0)->_entry) / sizeof(uint64_t)))
+#define _BSTBIN_MAXBUF_STRIDE(_entry) \
+    ((int) (sizeof(((BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *) 0)->_entry) / sizeof(uint64_t)))
+
+/* a counter converted to the report units, with its max buffer */
+typedef struct _bstbin_counter_
+{
+    int word;
+    int maxBufWord;
+} BSTBIN_COUNTER_t;
+
+/* layout of a realm, in the snapshot and in the report */
+typedef struct _bstbin_realm_desc_
+{
+    BSTBIN_REALM_ID_t id;
+    /* realm in the registry */
+    BVIEW_BST_REALM_ID_t realm;
+    /* bool in BSTJSON_REPORT_OPTIONS_t asking for the realm */
+    size_t include;
+    /* first entry in the snapshot and in the max buffer snapshot */
+    size_t data;
+    size_t maxBuf;
+    int stride;
+    int maxBufStride;
+    /* leading words of an entry that are compared for changes */
+    int compareWords;
+    /* entries per port, 0 if the realm is not indexed by port */
+    int perPort;
+    /* int in BVIEW_ASIC_CAPABILITIES_t : number of entries (per port) in use */
+    size_t limit;
+    int numConverted;
+    BSTBIN_COUNTER_t converted[_BSTBIN_MAX_CONVERTED];
+    int numRaw;
+    int raw[_BSTBIN_MAX_RAW];
+    /* word holding the queue's port, -1 if none */
+    int portWord;
+} BSTBIN_REALM_DESC_t;
+
+/* realms other than the device, in the order the JSON report lists them */
+static const BSTBIN_REALM_DESC_t bstbin_realms[] = {
+    {
+        BSTBIN_REALM_INGRESS_PORT_PRIORITY_GROUP, BVIEW_BST_INGRESS_PORT_PG,
+        offsetof(BSTJSON_REPORT_OPTIONS_t, includeIngressPortPriorityGroup),
+        offsetof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, iPortPg.data),
+        offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, iPortPg.data),
+        _BSTBIN_SNAP_STRIDE(iPortPg.data[0][0]), _BSTBIN_MAXBUF_STRIDE(iPortPg.data[0][0]),
+        2, BVIEW_ASIC_MAX_PRIORITY_GROUPS, offsetof(BVIEW_ASIC_CAPABILITIES_t, numPriorityGroups),
+        2, { { _BSTBIN_SNAP_WORD(iPortPg.data[0][0], umShareBufferCount),
+               _BSTBIN_MAXBUF_WORD(iPortPg.data[0][0], umShareMaxBuf) },
+             { _BSTBIN_SNAP_WORD(iPortPg.data[0][0], umHeadroomBufferCount),
+               _BSTBIN_MAXBUF_WORD(iPortPg.data[0][0], umHeadroomMaxBuf) } },
+        0, { 0 }, -1
+    },
+    {
+        BSTBIN_REALM_INGRESS_PORT_SERVICE_POOL, BVIEW_BST_INGRESS_PORT_SP,
+        offsetof(BSTJSON_REPORT_OPTIONS_t, includeIngressPortServicePool),
+        offsetof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, iPortSp.data),
+        offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, iPortSp.data),
+        _BSTBIN_SNAP_STRIDE(iPortSp.data[0][0]), _BSTBIN_MAXBUF_STRIDE(iPortSp.data[0][0]),
+        1, BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS, offsetof(BVIEW_ASIC_CAPABILITIES_t, numServicePools),
+        1, { { _BSTBIN_SNAP_WORD(iPortSp.data[0][0], umShareBufferCount),
+               _BSTBIN_MAXBUF_WORD(iPortSp.data[0][0], umShareMaxBuf) } },
+        0, { 0 }, -1
+    },
+    {
+        BSTBIN_REALM_INGRESS_SERVICE_POOL, BVIEW_BST_INGRESS_SP,
+        offsetof(BSTJSON_REPORT_OPTIONS_t, includeIngressServicePool),
+        offsetof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, iSp.data),
+        offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, iSp.data),
+        _BSTBIN_SNAP_STRIDE(iSp.data[0]), _BSTBIN_MAXBUF_STRIDE(iSp.data[0]),
+        1, 0, offsetof(BVIEW_ASIC_CAPABILITIES_t, numServicePools),
+        1, { { _BSTBIN_SNAP_WORD(iSp.data[0], umShareBufferCount),
+               _BSTBIN_MAXBUF_WORD(iSp.data[0], umShareMaxBuf) } },
+        0, { 0 }, -1
+    },
+    {
+        BSTBIN_REALM_EGRESS_CPU_QUEUE, BVIEW_BST_EGRESS_CPU_QUEUE,
+        offsetof(BSTJSON_REPORT_OPTIONS_t, includeEgressCpuQueue),
+        offsetof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, cpqQ.data),
+        offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, cpqQ.data),
+        _BSTBIN_SNAP_STRIDE(cpqQ.data[0]), _BSTBIN_MAXBUF_STRIDE(cpqQ.data[0]),
+        2, 0, offsetof(BVIEW_ASIC_CAPABILITIES_t, numCpuQueues),
+        1, { { _BSTBIN_SNAP_WORD(cpqQ.data[0], cpuBufferCount),
+               _BSTBIN_MAXBUF_WORD(cpqQ.data[0], cpuMaxBuf) } },
+        1, { _BSTBIN_SNAP_WORD(cpqQ.data[0], cpuQueueEntries) }, -1
+    },
+    {
+        BSTBIN_REALM_EGRESS_MC_QUEUE, BVIEW_BST_EGRESS_MC_QUEUE,
+        offsetof(BSTJSON_REPORT_OPTIONS_t, includeEgressMcQueue),
+        offsetof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, eMcQ.data),
+        offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, eMcQ.data),
+        _BSTBIN_SNAP_STRIDE(eMcQ.data[0]), _BSTBIN_MAXBUF_STRIDE(eMcQ.data[0]),
+        2, 0, offsetof(BVIEW_ASIC_CAPABILITIES_t, numMulticastQueues),
+        1, { { _BSTBIN_SNAP_WORD(eMcQ.data[0], mcBufferCount),
+               _BSTBIN_MAXBUF_WORD(eMcQ.data[0], mcMaxBuf) } },
+        1, { _BSTBIN_SNAP_WORD(eMcQ.data[0], mcQueueEntries) },
+        _BSTBIN_SNAP_WORD(eMcQ.data[0], port)
+    },
+    {
+        BSTBIN_REALM_EGRESS_PORT_SERVICE_POOL, BVIEW_BST_EGRESS_PORT_SP,
+        offsetof(BSTJSON_REPORT_OPTIONS_t, includeEgressPortServicePool),
+        offsetof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, ePortSp.data),
+        offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, ePortSp.data),
+        _BSTBIN_SNAP_STRIDE(ePortSp.data[0][0]), _BSTBIN_MAXBUF_STRIDE(ePortSp.data[0][0]),
+        4, BVIEW_ASIC_MAX_SERVICE_POOLS, offsetof(BVIEW_ASIC_CAPABILITIES_t, numServicePools),
+        3, { { _BSTBIN_SNAP_WORD(ePortSp.data[0][0], ucShareBufferCount),
+               _BSTBIN_MAXBUF_WORD(ePortSp.data[0][0], ucShareMaxBuf) },
+             { _BSTBIN_SNAP_WORD(ePortSp.data[0][0], umShareBufferCount),
+               _BSTBIN_MAXBUF_WORD(ePortSp.data[0][0], umShareMaxBuf) },
+             { _BSTBIN_SNAP_WORD(ePortSp.data[0][0], mcShareBufferCount),
+               _BSTBIN_MAXBUF_WORD(ePortSp.data[0][0], mcShareMaxBuf) } },
+        0, { 0 }, -1
+    },
+    {
+        BSTBIN_REALM_EGRESS_RQE_QUEUE, BVIEW_BST_EGRESS_RQE_QUEUE,
+        offsetof(BSTJSON_REPORT_OPTIONS_t, includeEgressRqeQueue),
+        offsetof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, rqeQ.data),
+        offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, rqeQ.data),
+        _BSTBIN_SNAP_STRIDE(rqeQ.data[0]), _BSTBIN_MAXBUF_STRIDE(rqeQ.data[0]),
+        2, 0, offsetof(BVIEW_ASIC_CAPABILITIES_t, numRqeQueues),
+        1, { { _BSTBIN_SNAP_WORD(rqeQ.data[0], rqeBufferCount),
+               _BSTBIN_MAXBUF_WORD(rqeQ.data[0], rqeMaxBuf) } },
+        1, { _BSTBIN_SNAP_WORD(rqeQ.data[0], rqeQueueEntries) }, -1
+    },
+    {
+        BSTBIN_REALM_EGRESS_SERVICE_POOL, BVIEW_BST_EGRESS_SP,
+        offsetof(BSTJSON_REPORT_OPTIONS_t, includeEgressServicePool),
+        offsetof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, eSp.data),
+        offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, eSp.data),
+        _BSTBIN_SNAP_STRIDE(eSp.data[0]), _BSTBIN_MAXBUF_STRIDE(eSp.data[0]),
+        3, 0, offsetof(BVIEW_ASIC_CAPABILITIES_t, numServicePools),
+        2, { { _BSTBIN_SNAP_WORD(eSp.data[0], umShareBufferCount),
+               _BSTBIN_MAXBUF_WORD(eSp.data[0], umShareMaxBuf) },
+             { _BSTBIN_SNAP_WORD(eSp.data[0], mcShareBufferCount),
+               _BSTBIN_MAXBUF_WORD(eSp.data[0], mcShareMaxBuf) } },
+        1, { _BSTBIN_SNAP_WORD(eSp.data[0], mcShareQueueEntries) }, -1
+    },
+    {
+        BSTBIN_REALM_EGRESS_UC_QUEUE, BVIEW_BST_EGRESS_UC_QUEUE,
+        offsetof(BSTJSON_REPORT_OPTIONS_t, includeEgressUcQueue),
+        offsetof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, eUcQ.data),
+        offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, eUcQ.data),
+        _BSTBIN_SNAP_STRIDE(eUcQ.data[0]), _BSTBIN_MAXBUF_STRIDE(eUcQ.data[0]),
+        1, 0, offsetof(BVIEW_ASIC_CAPABILITIES_t, numUnicastQueues),
+        1, { { _BSTBIN_SNAP_WORD(eUcQ.data[0], ucBufferCount),
+               _BSTBIN_MAXBUF_WORD(eUcQ.data[0], ucMaxBuf) } },
+        0, { 0 },
+        _BSTBIN_SNAP_WORD(eUcQ.data[0], port)
+    },
+    {
+        BSTBIN_REALM_EGRESS_UC_QUEUE_GROUP, BVIEW_BST_EGRESS_UC_QUEUEGROUPS,
+        offsetof(BSTJSON_REPORT_OPTIONS_t, includeEgressUcQueueGroup),
+        offsetof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t, eUcQg.data),
+        offsetof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t, eUcQg.data),
+        _BSTBIN_SNAP_STRIDE(eUcQg.data[0]), _BSTBIN_MAXBUF_STRIDE(eUcQg.data[0]),
+        1, 0, offsetof(BVIEW_ASIC_CAPABILITIES_t, numUnicastQueueGroups),
+        1, { { _BSTBIN_SNAP_WORD(eUcQg.data[0], ucBufferCount),
+               _BSTBIN_MAXBUF_WORD(eUcQg.data[0], ucMaxBuf) } },
+        0, { 0 }, -1
+    }
+};
+
+#define _BSTBIN_NUM_REALMS  ((int) (sizeof(bstbin_realms) / sizeof(bstbin_realms[0])))
+
+/******************************************************************
+ * @brief  Appends an unsigned LEB128 varint.
+ *
+ *********************************************************************/
+static void _binencode_varint(JSON_WRITER_t *writer, uint64_t value)
+{
+    char bytes[BSTBIN_VARINT_MAX_BYTES];
+    int len = 0;
+
+    while (value >= 0x80)
+    {
+        bytes[len++] = (char) ((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    bytes[len++] = (char) value;
+
+    json_writer_append(writer, bytes, len);
+}
+
+/******************************************************************
+ * @brief  Appends a signed number, zigzag encoded.
+ *
+ *********************************************************************/
+static void _binencode_signed(JSON_WRITER_t *writer, int64_t value)
+{
+    _binencode_varint(writer, ((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+}
+
+/******************************************************************
+ * @brief  Appends a string, prefixed with its length.
+ *
+ *********************************************************************/
+static void _binencode_string(JSON_WRITER_t *writer, const char *str)
+{
+    int len = (int) strlen(str);
+
+    _binencode_varint(writer, (uint64_t) len);
+    json_writer_append(writer, str, len);
+}
+
+static void _binencode_byte(JSON_WRITER_t *writer, uint8_t value)
+{
+    json_writer_append(writer, (const char *) &value, 1);
+}
+
+/******************************************************************
+ * @brief  Encodes the device realm, if asked for and changed.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _binencode_report_device(JSON_WRITER_t *writer,
+                                             const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                             const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                             const BSTJSON_REPORT_OPTIONS_t *options,
+                                             const BSTJSON_CONVERT_t *conv)
+{
+    uint64_t data;
+
+    /* same rules as the JSON report */
+    if ((options->includeDevice == false) ||
+        ((previous != NULL) && (current->device.bufferCount == previous->device.bufferCount)))
+    {
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    _JSONENCODE_CONVERT_REALM(conv, current->device, options->bst_max_buffers_ptr->device.data,
+                              bufferCount, maxBuf, 1, &data);
+
+    _binencode_byte(writer, BSTBIN_REALM_DEVICE);
+    _binencode_varint(writer, data);
+    _JSONENCODE_WRITER_CHECK(writer);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Tells what the index of a realm entry stands for, as
+ *         the report filter sees it.
+ *
+ *********************************************************************/
+static BSTJSON_FILTER_INDEX_t _binencode_filter_index(BSTBIN_REALM_ID_t id)
+{
+    switch (id)
+    {
+        case BSTBIN_REALM_INGRESS_SERVICE_POOL:
+        case BSTBIN_REALM_INGRESS_PORT_SERVICE_POOL:
+        case BSTBIN_REALM_EGRESS_PORT_SERVICE_POOL:
+        case BSTBIN_REALM_EGRESS_SERVICE_POOL:
+            return BSTJSON_FILTER_INDEX_SERVICE_POOL;
+
+        case BSTBIN_REALM_EGRESS_UC_QUEUE:
+        case BSTBIN_REALM_EGRESS_MC_QUEUE:
+        case BSTBIN_REALM_EGRESS_CPU_QUEUE:
+        case BSTBIN_REALM_EGRESS_RQE_QUEUE:
+            return BSTJSON_FILTER_INDEX_QUEUE;
+
+        default:
+            return BSTJSON_FILTER_INDEX_NONE;
+    }
+}
+
+/******************************************************************
+ * @brief  Encodes the changed entries of one realm.
+ *
+ * @note   The entries are picked exactly as the JSON encoder does :
+ *         same diff bitmap, same trigger restriction, same report
+ *         filter, same skipped indices.
+ *********************************************************************/
+static BVIEW_STATUS _binencode_report_realm(JSON_WRITER_t *writer, int asicId,
+                                            const BSTBIN_REALM_DESC_t *desc,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                            const BSTJSON_REPORT_OPTIONS_t *options,
+                                            const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                            const BSTJSON_CONVERT_t *conv)
+{
+    uint64_t includeEntries[BSTJSON_DIFF_MAX_BITMAP_WORDS];
+    const uint64_t *cur = (const uint64_t *) ((const uint8_t *) current + desc->data);
+    const uint64_t *prev = NULL;
+    const uint64_t *maxBuf = (const uint64_t *) ((const uint8_t *) options->bst_max_buffers_ptr + desc->maxBuf);
+    const uint64_t *row;
+    int limit = *(const int *) ((const uint8_t *) asic + desc->limit);
+    int numEntries = (desc->perPort != 0) ? (asic->numPorts * desc->perPort) : limit;
+    int entry = 0, triggerEntry = -1;
+    int port = 0, index = 0, lastPort = 0, lastIndex = -1;
+    int i;
+    uint64_t value;
+    char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
+
+    if (previous != NULL)
+    {
+        prev = (const uint64_t *) ((const uint8_t *) previous + desc->data);
+    }
+
+    bstjson_diff_report_bitmap_get(prev, cur, numEntries, desc->stride, desc->compareWords,
+                                   options->sendIncrementalReport, includeEntries);
+
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
+    {
+        triggerEntry = options->triggerInfo.queue;
+        if (desc->perPort != 0)
+        {
+            triggerEntry = ((options->triggerInfo.queue >= 0) && (options->triggerInfo.queue < limit)) ?
+                           (((options->triggerInfo.port - 1) * desc->perPort) + options->triggerInfo.queue) : -1;
+        }
+        bstjson_diff_bitmap_restrict(includeEntries, numEntries, triggerEntry);
+    }
+
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                cur, numEntries, desc->stride, desc->compareWords,
+                                desc->perPort, desc->portWord, _binencode_filter_index(desc->id),
+                                includeEntries);
+
+    _binencode_byte(writer, (uint8_t) desc->id);
+
+    for (entry = bstjson_diff_bitmap_next(includeEntries, numEntries, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includeEntries, numEntries, entry + 1))
+    {
+        index = entry;
+
+        if (desc->perPort != 0)
+        {
+            port = (entry / desc->perPort) + 1;
+            index = entry % desc->perPort;
+
+            if (index >= limit)
+                continue;
+
+            if (port != lastPort)
+            {
+                if (lastPort != 0)
+                {
+                    /* end of the rows of the previous port */
+                    _binencode_varint(writer, 0);
+                }
+
+                memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
+                JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
+
+                _binencode_varint(writer, (uint64_t) (port - lastPort));
+                _binencode_string(writer, &portStr[0]);
+                lastPort = port;
+                lastIndex = -1;
+            }
+        }
+
+        row = &cur[entry * desc->stride];
+
+        _binencode_varint(writer, (uint64_t) (index - lastIndex));
+        lastIndex = index;
+
+        if (desc->portWord >= 0)
+        {
+            memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
+            JSON_PORT_MAP_TO_NOTATION(row[desc->portWord], asicId, &portStr[0]);
+            _binencode_string(writer, &portStr[0]);
+        }
+
+        for (i = 0; i < desc->numConverted; i++)
+        {
+            bstjson_convert_batch(conv, &row[desc->converted[i].word], desc->stride,
+                                  &maxBuf[(entry * desc->maxBufStride) + desc->converted[i].maxBufWord],
+                                  desc->maxBufStride, 1, &value);
+            _binencode_varint(writer, value);
+        }
+
+        for (i = 0; i < desc->numRaw; i++)
+        {
+            _binencode_varint(writer, row[desc->raw[i]]);
+        }
+        _JSONENCODE_WRITER_CHECK(writer);
+    }
+
+    if (lastPort != 0)
+    {
+        _binencode_varint(writer, 0);
+    }
+
+    /* end of the realm */
+    _binencode_varint(writer, 0);
+    _JSONENCODE_WRITER_CHECK(writer);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Writes the message header, and the trigger block of a
+ *         trigger report.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _binencode_report_header(JSON_WRITER_t *writer, int asicId,
+                                             const BSTJSON_REPORT_OPTIONS_t *options,
+                                             const BSTJSON_CONVERT_t *conv,
+                                             const BVIEW_TIME_t *time)
+{
+    const char *asicIdStr;
+    char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
+    uint8_t kind = BSTBIN_KIND_REPORT;
+    uint8_t flags = 0;
+    const BSTBIN_REALM_DESC_t *desc = NULL;
+    BVIEW_STATUS status;
+    int i;
+
+    if (options->reportTrigger == true)
+    {
+        kind = BSTBIN_KIND_TRIGGER;
+    }
+    else if (options->reportThreshold == true)
+    {
+        kind = BSTBIN_KIND_THRESHOLDS;
+    }
+
+    if (conv->mode == BSTJSON_CONVERT_CELLS)
+    {
+        flags |= BSTBIN_FLAG_UNITS_IN_CELLS;
+    }
+    else if (conv->mode == BSTJSON_CONVERT_PERCENT)
+    {
+        flags |= BSTBIN_FLAG_IN_PERCENTAGE;
+    }
+
+    if (0 != options->sequenceNumber)
+    {
+        flags |= BSTBIN_FLAG_SEQUENCED;
+        if (true == options->keyframe)
+        {
+            flags |= BSTBIN_FLAG_KEYFRAME;
+        }
+    }
+    if (true == options->stale)
+    {
+        flags |= BSTBIN_FLAG_STALE;
+    }
+
+    /* external notation of the unit */
+    status = bstjson_header_asic_id_get(asicId, &asicIdStr);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+    JSON_WRITER_APPEND_LITERAL(writer, BSTBIN_MAGIC);
+    _binencode_byte(writer, BSTBIN_FORMAT_VERSION);
+    _binencode_byte(writer, kind);
+    _binencode_byte(writer, flags);
+    _binencode_string(writer, asicIdStr);
+    _binencode_varint(writer, BVIEW_JSON_VERSION);
+    _binencode_varint(writer, (uint64_t) *(const time_t *) time);
+    if (flags & BSTBIN_FLAG_SEQUENCED)
+    {
+        _binencode_varint(writer, options->sequenceNumber);
+    }
+
+    if (kind == BSTBIN_KIND_TRIGGER)
+    {
+        if (BVIEW_BST_DEVICE != options->triggerInfo.realm)
+        {
+            for (i = 0; i < _BSTBIN_NUM_REALMS; i++)
+            {
+                if (options->triggerInfo.realm == bstbin_realms[i].realm)
+                {
+                    desc = &bstbin_realms[i];
+                    break;
+                }
+            }
+            _JSONENCODE_ASSERT(desc != NULL);
+        }
+
+        if ((desc != NULL) && (desc->perPort != 0))
+        {
+            JSON_PORT_MAP_TO_NOTATION(options->triggerInfo.port, asicId, &portStr[0]);
+        }
+
+        _binencode_byte(writer, (desc != NULL) ? (uint8_t) desc->id : (uint8_t) BSTBIN_REALM_DEVICE);
+        _binencode_string(writer, bst_registry_counter_name_get(options->triggerInfo.counter));
+        _binencode_string(writer, &portStr[0]);
+        _binencode_signed(writer, options->triggerInfo.queue);
+    }
+    _JSONENCODE_WRITER_CHECK(writer);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Creates a binary buffer using the supplied data for the
+ *         "get-bst-report" REST API.
+ *
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   method      Method ID (from original request)
+ * @param[out]  pBuffer     Filled-in buffer
+ * @param[out]  pLength     Number of bytes in the buffer
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  Data is encoded successfully
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  The report does not fit in a buffer
+ *
+ * @note     The returned buffer should be freed using the
+ *           bstjson_memory_free(). Failing to do so leads to memory leaks
+ *********************************************************************/
+
+BVIEW_STATUS bstbin_encode_get_bst_report ( int asicId,
+                                           int method,
+                                           const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                           const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                           const BSTJSON_REPORT_OPTIONS_t *options,
+                                           const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                           const BVIEW_TIME_t *time,
+                                           uint8_t **pBuffer,
+                                           int *pLength
+                                           )
+{
+    char *buf;
+    BVIEW_STATUS status;
+    JSON_WRITER_t writer;
+    BSTJSON_CONVERT_t conv;
+    int i;
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-BIN-Encoder : Request for Get-Bst-Report \n");
+
+    /* Validate Input Parameters */
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (current != NULL);
+    _JSONENCODE_ASSERT (time != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (pBuffer != NULL);
+    _JSONENCODE_ASSERT (pLength != NULL);
+
+    /* allocate memory for the message */
+    status = bstjson_memory_allocate(BSTJSON_MEMSIZE_REPORT, (uint8_t **) & buf);
+    _JSONENCODE_ASSERT (status == BVIEW_STATUS_SUCCESS);
+
+    json_writer_init(&writer, buf, BSTJSON_MEMSIZE_REPORT);
+    bstjson_convert_setup(options, asic, &conv);
+
+    status = _binencode_report_header(&writer, asicId, options, &conv, time);
+    _JSONENCODE_ASSERT_ERROR_AND_FREE((status == BVIEW_STATUS_SUCCESS), status, buf);
+
+    status = _binencode_report_device(&writer, previous, current, options, &conv);
+    _JSONENCODE_ASSERT_ERROR_AND_FREE((status == BVIEW_STATUS_SUCCESS), status, buf);
+
+    for (i = 0; i < _BSTBIN_NUM_REALMS; i++)
+    {
+        if (false == *(const bool *) ((const uint8_t *) options + bstbin_realms[i].include))
+        {
+            continue;
+        }
+
+        status = _binencode_report_realm(&writer, asicId, &bstbin_realms[i],
+                                         previous, current, options, asic, &conv);
+        _JSONENCODE_ASSERT_ERROR_AND_FREE((status == BVIEW_STATUS_SUCCESS), status, buf);
+    }
+
+    _binencode_byte(&writer, BSTBIN_REALM_END);
+    _JSONENCODE_ASSERT_ERROR_AND_FREE((false == json_writer_overflow(&writer)),
+                                      BVIEW_STATUS_OUTOFMEMORY, buf);
+
+    *pBuffer = (uint8_t *) buf;
+    *pLength = json_writer_length(&writer);
+
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-BIN-Encoder : Request for Get-Bst-Report Complete [%d] bytes \n", *pLength);
+
+    return BVIEW_STATUS_SUCCESS;
+}
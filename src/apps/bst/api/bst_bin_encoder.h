@@ -0,0 +1,134 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BSTBINENCODER_H
+#define INCLUDE_BSTBINENCODER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "broadview.h"
+
+#include "bst.h"
+#include "bst_json_encoder.h"
+
+/* Compact binary form of the "get-bst-report", "get-bst-thresholds" and
+ * "trigger-report" messages. It carries the same entries as the JSON
+ * report built from the same snapshot and options.
+ *
+ * Numbers are unsigned LEB128 varints (7 bits per byte, low bits first,
+ * high bit set on every byte but the last). Signed numbers are zigzag
+ * encoded first. A string is a varint length followed by its bytes.
+ *
+ *   message  : magic "BSTB", u8 format version,
+ *              u8 kind, u8 flags, string asic-id,
+ *              varint json version, varint time stamp (seconds since epoch),
+ *              [varint sequence number], [trigger], realm ..., u8 0
+ *   kind     : 0 report, 1 thresholds, 2 trigger report
+ *   flags    : bit 0 counters in cells, bit 1 counters in percentage,
+ *              bit 2 the sequence number follows the time stamp,
+ *              bit 3 the report is a keyframe of its incremental stream,
+ *              bit 4 the data is stale, collected while the south bound
+ *              was resyncing
+ *   trigger  : u8 realm id, string counter, string port (empty if the
+ *              realm is not indexed by port), zigzag queue/index
+ *   realm    : u8 realm id, then
+ *              device            - varint value
+ *              one index         - row ..., varint 0
+ *              (port, index)     - group ..., varint 0
+ *   group    : varint 1 + (port - previous port - 1), string port, row ..., varint 0
+ *   row      : varint 1 + (index - previous index - 1), [string port], varint counter ...
+ *
+ * Ports and indices only grow within a realm, so the gaps are small and
+ * most fit in one byte. The "previous" port starts at 0 (ports count from
+ * 1) and the previous index at -1, per realm and per group. Only the
+ * unicast and multicast queue rows carry the port string. The counters
+ * come in the order of the JSON row, after its index.
+ */
+
+#define BSTBIN_MAGIC                    "BSTB"
+#define BSTBIN_MAGIC_LENGTH             4
+#define BSTBIN_FORMAT_VERSION           1
+
+/* longest varint, for a uint64_t */
+#define BSTBIN_VARINT_MAX_BYTES         10
+
+/* message kinds */
+typedef enum _bstbin_kind_
+{
+    BSTBIN_KIND_REPORT = 0,
+    BSTBIN_KIND_THRESHOLDS,
+    BSTBIN_KIND_TRIGGER
+} BSTBIN_KIND_t;
+
+/* header flags */
+#define BSTBIN_FLAG_UNITS_IN_CELLS      (0x1)
+#define BSTBIN_FLAG_IN_PERCENTAGE       (0x01 << 1)
+#define BSTBIN_FLAG_SEQUENCED           (0x01 << 2)
+#define BSTBIN_FLAG_KEYFRAME            (0x01 << 3)
+#define BSTBIN_FLAG_STALE               (0x01 << 4)
+
+/* realm ids, 0 ends the list of realms */
+typedef enum _bstbin_realm_id_
+{
+    BSTBIN_REALM_END = 0,
+    BSTBIN_REALM_DEVICE,
+    BSTBIN_REALM_INGRESS_SERVICE_POOL,
+    BSTBIN_REALM_INGRESS_PORT_SERVICE_POOL,
+    BSTBIN_REALM_INGRESS_PORT_PRIORITY_GROUP,
+    BSTBIN_REALM_EGRESS_PORT_SERVICE_POOL,
+    BSTBIN_REALM_EGRESS_SERVICE_POOL,
+    BSTBIN_REALM_EGRESS_UC_QUEUE,
+    BSTBIN_REALM_EGRESS_UC_QUEUE_GROUP,
+    BSTBIN_REALM_EGRESS_MC_QUEUE,
+    BSTBIN_REALM_EGRESS_CPU_QUEUE,
+    BSTBIN_REALM_EGRESS_RQE_QUEUE,
+    BSTBIN_REALM_MAX
+} BSTBIN_REALM_ID_t;
+
+/* Prototypes */
+
+/******************************************************************
+ * @brief  Encodes a "get-bst-report" message in the binary form.
+ *
+ * @param[out]  pBuffer     Filled-in buffer, to be freed with
+ *                          bstjson_memory_free()
+ * @param[out]  pLength     Number of bytes in the buffer
+ *
+ * @note     The other parameters are the ones of
+ *           bstjson_encode_get_bst_report()
+ *********************************************************************/
+BVIEW_STATUS bstbin_encode_get_bst_report(int asicId,
+                                          int method,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                          const BSTJSON_REPORT_OPTIONS_t *options,
+                                          const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                          const BVIEW_TIME_t *reportTime,
+                                          uint8_t **pBuffer,
+                                          int *pLength
+                                          );
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif /* INCLUDE_BSTBINENCODER_H */
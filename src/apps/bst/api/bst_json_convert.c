@@ -0,0 +1,264 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "broadview.h"
+
+#include "cJSON.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+
+#include "bst_json_encoder.h"
+
+/* A percentage is round(value * 100 / maxBuf), which is computed in integers
+ * as (value * 200 + maxBuf) / (2 * maxBuf). */
+#define _BSTCONV_PERCENT_MULTIPLIER     200
+
+/******************************************************************
+ * @brief  Builds the factor for an exact division by 'divisor'.
+ *
+ *         reciprocal = floor((2^64 - 1) / divisor), so that the
+ *         high half of (n * reciprocal) is either n / divisor or
+ *         one less, and a single correction step gives the quotient.
+ *
+ *********************************************************************/
+static void _bstconv_factor_build(uint64_t divisor, uint64_t addend,
+                                  BSTJSON_CONVERT_FACTOR_t *factor)
+{
+    factor->addend = addend;
+    factor->divisor = divisor;
+    factor->reciprocal = UINT64_MAX / divisor;
+}
+
+/******************************************************************
+ * @brief  Builds the percentage factor for a max buffer value.
+ *
+ *         A zero max buffer reports 0 %. The divisor is then made
+ *         larger than any numerator, so the quotient is always 0.
+ *
+ *********************************************************************/
+static void _bstconv_percent_factor_build(uint64_t maxBuf, BSTJSON_CONVERT_FACTOR_t *factor)
+{
+    if (0 == maxBuf)
+    {
+        _bstconv_factor_build(UINT64_MAX, 0, factor);
+        return;
+    }
+
+    _bstconv_factor_build(2 * maxBuf, maxBuf, factor);
+}
+
+/******************************************************************
+ * @brief  (value * multiplier + addend) / divisor
+ *
+ *********************************************************************/
+static inline uint64_t _bstconv_apply(uint64_t value, uint64_t multiplier,
+                                      const BSTJSON_CONVERT_FACTOR_t *factor)
+{
+    uint64_t n = (value * multiplier) + factor->addend;
+#ifdef __SIZEOF_INT128__
+    uint64_t q = (uint64_t) (((unsigned __int128) n * factor->reciprocal) >> 64);
+
+    q += ((n - (q * factor->divisor)) >= factor->divisor);
+    return q;
+#else
+    return n / factor->divisor;
+#endif
+}
+
+/******************************************************************
+ * @brief  Percentage of a counter, for its max buffer factor.
+ *
+ *         value * 200 only fits in 64 bits for values up to maxBuf
+ *         and a little more. A value above maxBuf is split in whole
+ *         multiples of maxBuf, each worth 100 %, and a remainder,
+ *         so the product never overflows and the result is the same.
+ *
+ *********************************************************************/
+static inline uint64_t _bstconv_percent_apply(uint64_t value, uint64_t maxBuf,
+                                              const BSTJSON_CONVERT_FACTOR_t *factor)
+{
+    uint64_t whole;
+
+    if (value <= maxBuf)
+    {
+        return _bstconv_apply(value, _BSTCONV_PERCENT_MULTIPLIER, factor);
+    }
+
+    if (0 == maxBuf)
+    {
+        return 0;
+    }
+
+    whole = value / maxBuf;
+    if (whole > (UINT64_MAX / 100) - 1)
+    {
+        return UINT64_MAX;
+    }
+
+    return (whole * 100) +
+           _bstconv_apply(value - (whole * maxBuf), _BSTCONV_PERCENT_MULTIPLIER, factor);
+}
+
+/******************************************************************
+ * @brief  Rebuilds the percentage factors if the max buffer
+ *         settings differ from the ones the table was built from.
+ *
+ * @param[in,out]  table       conversion table of the unit
+ * @param[in]      maxBuffers  max buffer settings just read from the asic
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER
+ *
+ *********************************************************************/
+BVIEW_STATUS bstjson_convert_table_update(BSTJSON_CONVERT_TABLE_t *table,
+                                          const BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers)
+{
+    const uint64_t *maxBuf;
+    unsigned int i;
+
+    if ((NULL == table) || (NULL == maxBuffers))
+    {
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((true == table->valid) &&
+        (0 == memcmp(&table->maxBuffers, maxBuffers, sizeof(table->maxBuffers))))
+    {
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    memcpy(&table->maxBuffers, maxBuffers, sizeof(table->maxBuffers));
+
+    maxBuf = (const uint64_t *) &table->maxBuffers;
+    for (i = 0; i < BSTJSON_CONVERT_MAXBUF_WORDS; i++)
+    {
+        _bstconv_percent_factor_build(maxBuf[i], &table->percent[i]);
+    }
+
+    table->valid = true;
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Works out the conversion to be applied on the counters
+ *         of a report, from the report options.
+ *
+ * @param[in]   options   report options
+ * @param[in]   asic      asic capabilities
+ * @param[out]  conv      conversion to be passed to bstjson_convert_batch()
+ *
+ *********************************************************************/
+void bstjson_convert_setup(const BSTJSON_REPORT_OPTIONS_t *options,
+                           const BVIEW_ASIC_CAPABILITIES_t *asic,
+                           BSTJSON_CONVERT_t *conv)
+{
+    memset(conv, 0, sizeof(BSTJSON_CONVERT_t));
+
+    /* thresholds are never reported as percentage */
+    if ((false == options->reportThreshold) && (true == options->statsInPercentage))
+    {
+        conv->mode = BSTJSON_CONVERT_PERCENT;
+        conv->maxBuffers = (const uint64_t *) options->bst_max_buffers_ptr;
+
+        if ((NULL != options->bst_convert_table_ptr) &&
+            (true == options->bst_convert_table_ptr->valid))
+        {
+            conv->percent = &options->bst_convert_table_ptr->percent[0];
+        }
+        return;
+    }
+
+    if (true == options->statUnitsInCells)
+    {
+        /* counters come in bytes from asic */
+        conv->mode = BSTJSON_CONVERT_CELLS;
+        _bstconv_factor_build((asic->cellToByteConv > 0) ? asic->cellToByteConv : 1, 0, &conv->cells);
+    }
+}
+
+/******************************************************************
+ * @brief  Converts a run of counters of a realm to output units.
+ *
+ * @param[in]   conv          conversion set up for the report
+ * @param[in]   values        first counter
+ * @param[in]   valueStride   distance between counters, in uint64_t words
+ * @param[in]   maxBuf        max buffer of the first counter, in the
+ *                            report's max buffer snapshot
+ * @param[in]   maxBufStride  distance between max buffers, in uint64_t words
+ * @param[in]   count         number of counters
+ * @param[out]  out           converted counters
+ *
+ * @note   Each mode runs its own loop, with no per-counter decisions.
+ *
+ *********************************************************************/
+void bstjson_convert_batch(const BSTJSON_CONVERT_t *conv,
+                           const uint64_t *values, int valueStride,
+                           const uint64_t *maxBuf, int maxBufStride,
+                           int count, uint64_t *out)
+{
+    const BSTJSON_CONVERT_FACTOR_t *factor;
+    BSTJSON_CONVERT_FACTOR_t temp;
+    int i;
+
+    switch (conv->mode)
+    {
+        case BSTJSON_CONVERT_CELLS:
+            for (i = 0; i < count; i++)
+            {
+                out[i] = _bstconv_apply(values[i * valueStride], 1, &conv->cells);
+            }
+            break;
+
+        case BSTJSON_CONVERT_PERCENT:
+            if (NULL != conv->percent)
+            {
+                /* the factors are laid out like the max buffer snapshot */
+                factor = &conv->percent[maxBuf - conv->maxBuffers];
+                for (i = 0; i < count; i++)
+                {
+                    out[i] = _bstconv_percent_apply(values[i * valueStride], maxBuf[i * maxBufStride],
+                                                    &factor[i * maxBufStride]);
+                }
+                break;
+            }
+
+            /* no table, build the factors on the way */
+            for (i = 0; i < count; i++)
+            {
+                _bstconv_percent_factor_build(maxBuf[i * maxBufStride], &temp);
+                out[i] = _bstconv_percent_apply(values[i * valueStride], maxBuf[i * maxBufStride], &temp);
+            }
+            break;
+
+        default:
+            for (i = 0; i < count; i++)
+            {
+                out[i] = values[i * valueStride];
+            }
+            break;
+    }
+}
@@ -0,0 +1,447 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define _BSTDIFF_X86
+#endif
+
+#include "broadview.h"
+#include "bst_json_diff.h"
+
+#define _BSTDIFF_DEBUG
+#define _BSTDIFF_DEBUG_LEVEL        _BSTDIFF_DEBUG_ERROR
+
+#define _BSTDIFF_DEBUG_TRACE        (0x1)
+#define _BSTDIFF_DEBUG_INFO         (0x01 << 1)
+#define _BSTDIFF_DEBUG_ERROR        (0x01 << 2)
+#define _BSTDIFF_DEBUG_ALL          (0xFF)
+
+#ifdef _BSTDIFF_DEBUG
+#define _BSTDIFF_LOG(level, format,args...)   do { \
+            if ((level) & _BSTDIFF_DEBUG_LEVEL) { \
+                printf(format, ##args); \
+            } \
+        }while(0)
+#else
+#define _BSTDIFF_LOG(level, format,args...)
+#endif
+
+/* The kernels compare at most one block of words at a time, so that the
+ * per-word result fits in a single uint64_t mask */
+#define _BSTDIFF_BLOCK_WORDS        64
+
+/* A block kernel returns a mask with bit 'i' set if prev[i] != cur[i] */
+typedef uint64_t (*_BSTDIFF_BLOCK_FN_t)(const uint64_t *prev, const uint64_t *cur, int count);
+
+/* compared against, when looking for non-zero entries */
+static const uint64_t _bstdiff_zero_block[_BSTDIFF_BLOCK_WORDS] = { 0 };
+
+/******************************************************************
+ * @brief  Portable block kernel.
+ *
+ *********************************************************************/
+static uint64_t _bstdiff_block_scalar(const uint64_t *prev, const uint64_t *cur, int count)
+{
+    uint64_t mask = 0;
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        mask |= ((uint64_t) (prev[i] != cur[i])) << i;
+    }
+
+    return mask;
+}
+
+#ifdef _BSTDIFF_X86
+/******************************************************************
+ * @brief  SSE2 block kernel, two words per step.
+ *
+ *         SSE2 has no 64-bit compare, so the 32-bit halves are
+ *         compared and the results of both halves are combined.
+ *
+ *********************************************************************/
+__attribute__((target("sse2")))
+static uint64_t _bstdiff_block_sse2(const uint64_t *prev, const uint64_t *cur, int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i x, eq;
+    uint64_t mask = 0;
+    int i = 0;
+
+    for (i = 0; i + 2 <= count; i += 2)
+    {
+        x = _mm_xor_si128(_mm_loadu_si128((const __m128i *) &prev[i]),
+                          _mm_loadu_si128((const __m128i *) &cur[i]));
+        eq = _mm_cmpeq_epi32(x, zero);
+        eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+        mask |= ((uint64_t) (~_mm_movemask_pd(_mm_castsi128_pd(eq)) & 0x3)) << i;
+    }
+
+    if (i < count)
+    {
+        mask |= _bstdiff_block_scalar(&prev[i], &cur[i], count - i) << i;
+    }
+
+    return mask;
+}
+
+/******************************************************************
+ * @brief  AVX2 block kernel, four words per step.
+ *
+ *********************************************************************/
+__attribute__((target("avx2")))
+static uint64_t _bstdiff_block_avx2(const uint64_t *prev, const uint64_t *cur, int count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    __m256i x, eq;
+    uint64_t mask = 0;
+    int i = 0;
+
+    for (i = 0; i + 4 <= count; i += 4)
+    {
+        x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *) &prev[i]),
+                             _mm256_loadu_si256((const __m256i *) &cur[i]));
+        eq = _mm256_cmpeq_epi64(x, zero);
+        mask |= ((uint64_t) (~_mm256_movemask_pd(_mm256_castsi256_pd(eq)) & 0xF)) << i;
+    }
+
+    if (i < count)
+    {
+        mask |= _bstdiff_block_scalar(&prev[i], &cur[i], count - i) << i;
+    }
+
+    return mask;
+}
+#endif
+
+/* kernel in use, scalar until bstjson_diff_init() has run */
+static _BSTDIFF_BLOCK_FN_t _bstdiff_block_fn = _bstdiff_block_scalar;
+static BSTJSON_DIFF_ISA_t _bstdiff_isa = BSTJSON_DIFF_ISA_SCALAR;
+
+/******************************************************************
+ * @brief  Selects the best kernel for the CPU we are running on.
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ *
+ *********************************************************************/
+BVIEW_STATUS bstjson_diff_init(void)
+{
+    _bstdiff_block_fn = _bstdiff_block_scalar;
+    _bstdiff_isa = BSTJSON_DIFF_ISA_SCALAR;
+
+#ifdef _BSTDIFF_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        _bstdiff_block_fn = _bstdiff_block_avx2;
+        _bstdiff_isa = BSTJSON_DIFF_ISA_AVX2;
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        _bstdiff_block_fn = _bstdiff_block_sse2;
+        _bstdiff_isa = BSTJSON_DIFF_ISA_SSE2;
+    }
+#endif
+
+    _BSTDIFF_LOG(_BSTDIFF_DEBUG_INFO, "BST-DIFF : using kernel %d \n", _bstdiff_isa);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Returns the kernel currently in use.
+ *
+ *********************************************************************/
+BSTJSON_DIFF_ISA_t bstjson_diff_isa_get(void)
+{
+    return _bstdiff_isa;
+}
+
+/******************************************************************
+ * @brief  Forces a kernel, for measurements.
+ *
+ * @param[in]   isa      kernel to use
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ * @retval   BVIEW_STATUS_UNSUPPORTED   the CPU or the build lacks it
+ *
+ *********************************************************************/
+BVIEW_STATUS bstjson_diff_isa_set(BSTJSON_DIFF_ISA_t isa)
+{
+    if (BSTJSON_DIFF_ISA_SCALAR == isa)
+    {
+        _bstdiff_block_fn = _bstdiff_block_scalar;
+        _bstdiff_isa = isa;
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+#ifdef _BSTDIFF_X86
+    __builtin_cpu_init();
+
+    if ((BSTJSON_DIFF_ISA_SSE2 == isa) && (__builtin_cpu_supports("sse2")))
+    {
+        _bstdiff_block_fn = _bstdiff_block_sse2;
+        _bstdiff_isa = isa;
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    if ((BSTJSON_DIFF_ISA_AVX2 == isa) && (__builtin_cpu_supports("avx2")))
+    {
+        _bstdiff_block_fn = _bstdiff_block_avx2;
+        _bstdiff_isa = isa;
+        return BVIEW_STATUS_SUCCESS;
+    }
+#endif
+
+    return BVIEW_STATUS_UNSUPPORTED;
+}
+
+/******************************************************************
+ * @brief  Runs the block kernel over a realm and folds the per-word
+ *         mask into a per-entry bitmap.
+ *
+ *         'prev' NULL compares against zero.
+ *
+ *********************************************************************/
+static int _bstdiff_run(const uint64_t *prev, const uint64_t *cur,
+                        int numEntries, int stride, int compareWords,
+                        uint64_t *bitmap)
+{
+    int numWords = numEntries * stride;
+    int base, count, word, entry, end;
+    int numSet = 0;
+    uint64_t mask, bit;
+
+    memset(bitmap, 0, BSTJSON_DIFF_BITMAP_WORDS(numEntries) * sizeof(uint64_t));
+
+    for (base = 0; base < numWords; base += _BSTDIFF_BLOCK_WORDS)
+    {
+        count = numWords - base;
+        if (count > _BSTDIFF_BLOCK_WORDS)
+        {
+            count = _BSTDIFF_BLOCK_WORDS;
+        }
+
+        mask = _bstdiff_block_fn((prev != NULL) ? &prev[base] : _bstdiff_zero_block,
+                                 &cur[base], count);
+        if (mask == 0)
+        {
+            continue;
+        }
+
+        /* one word per entry, the mask is the bitmap word itself */
+        if (stride == 1)
+        {
+            bitmap[base / 64] = mask;
+            numSet += __builtin_popcountll(mask);
+            continue;
+        }
+
+        while (mask != 0)
+        {
+            word = base + __builtin_ctzll(mask);
+            entry = word / stride;
+
+            if ((word - (entry * stride)) >= compareWords)
+            {
+                /* not a counter, ignore */
+                mask &= (mask - 1);
+                continue;
+            }
+
+            bit = ((uint64_t) 1) << (entry % 64);
+            if ((bitmap[entry / 64] & bit) == 0)
+            {
+                bitmap[entry / 64] |= bit;
+                numSet++;
+            }
+
+            /* the rest of this entry does not matter any more */
+            end = ((entry + 1) * stride) - base;
+            mask = (end >= _BSTDIFF_BLOCK_WORDS) ? 0 : (mask & ~((((uint64_t) 1) << end) - 1));
+        }
+    }
+
+    return numSet;
+}
+
+/******************************************************************
+ * @brief  Builds the bitmap of entries changed between two realms.
+ *
+ * @param[in]   previous      previous realm data
+ * @param[in]   current       current realm data
+ * @param[in]   numEntries    number of entries to compare
+ * @param[in]   stride        entry size, in uint64_t words
+ * @param[in]   compareWords  leading words of an entry to compare
+ * @param[out]  bitmap        one bit per entry
+ *
+ * @retval   number of changed entries
+ *
+ *********************************************************************/
+int bstjson_diff_changed_get(const void *previous, const void *current,
+                             int numEntries, int stride, int compareWords,
+                             uint64_t *bitmap)
+{
+    return _bstdiff_run((const uint64_t *) previous, (const uint64_t *) current,
+                        numEntries, stride, compareWords, bitmap);
+}
+
+/******************************************************************
+ * @brief  Builds the bitmap of non-zero entries of a realm.
+ *
+ * @param[in]   current       realm data
+ * @param[in]   numEntries    number of entries to check
+ * @param[in]   stride        entry size, in uint64_t words
+ * @param[in]   compareWords  leading words of an entry to check
+ * @param[out]  bitmap        one bit per entry
+ *
+ * @retval   number of non-zero entries
+ *
+ *********************************************************************/
+int bstjson_diff_nonzero_get(const void *current,
+                             int numEntries, int stride, int compareWords,
+                             uint64_t *bitmap)
+{
+    return _bstdiff_run(NULL, (const uint64_t *) current,
+                        numEntries, stride, compareWords, bitmap);
+}
+
+/******************************************************************
+ * @brief  Builds the bitmap of entries to be carried in a report.
+ *
+ *********************************************************************/
+int bstjson_diff_report_bitmap_get(const void *previous, const void *current,
+                                   int numEntries, int stride, int compareWords,
+                                   bool sendIncrementalReport,
+                                   uint64_t *bitmap)
+{
+    if (previous != NULL)
+    {
+        return bstjson_diff_changed_get(previous, current, numEntries, stride, compareWords, bitmap);
+    }
+
+    if (true == sendIncrementalReport)
+    {
+        return bstjson_diff_nonzero_get(current, numEntries, stride, compareWords, bitmap);
+    }
+
+    /* full snapshot, every entry goes */
+    bstjson_diff_bitmap_fill(bitmap, numEntries);
+
+    return numEntries;
+}
+
+/******************************************************************
+ * @brief  Sets the bits of all the entries.
+ *
+ *********************************************************************/
+void bstjson_diff_bitmap_fill(uint64_t *bitmap, int numEntries)
+{
+    int words = BSTJSON_DIFF_BITMAP_WORDS(numEntries);
+
+    if (words <= 0)
+    {
+        return;
+    }
+
+    memset(bitmap, 0xFF, words * sizeof(uint64_t));
+    if ((numEntries % 64) != 0)
+    {
+        bitmap[words - 1] = (((uint64_t) 1) << (numEntries % 64)) - 1;
+    }
+}
+
+/******************************************************************
+ * @brief  Counts the set bits.
+ *
+ *********************************************************************/
+int bstjson_diff_bitmap_count(const uint64_t *bitmap, int numEntries)
+{
+    int words = BSTJSON_DIFF_BITMAP_WORDS(numEntries);
+    int w, count = 0;
+
+    for (w = 0; w < words; w++)
+    {
+        count += __builtin_popcountll(bitmap[w]);
+    }
+
+    return count;
+}
+
+/******************************************************************
+ * @brief  Clears every bit of the bitmap except 'index'.
+ *
+ *********************************************************************/
+void bstjson_diff_bitmap_restrict(uint64_t *bitmap, int numEntries, int index)
+{
+    uint64_t keep = 0;
+
+    if ((index >= 0) && (index < numEntries))
+    {
+        keep = bitmap[index / 64] & (((uint64_t) 1) << (index % 64));
+    }
+
+    memset(bitmap, 0, BSTJSON_DIFF_BITMAP_WORDS(numEntries) * sizeof(uint64_t));
+
+    if (keep != 0)
+    {
+        bitmap[index / 64] = keep;
+    }
+}
+
+/******************************************************************
+ * @brief  Returns the first set bit at or after 'from'.
+ *
+ * @retval   index of the bit, -1 if there are no more set bits
+ *
+ *********************************************************************/
+int bstjson_diff_bitmap_next(const uint64_t *bitmap, int numEntries, int from)
+{
+    int words = BSTJSON_DIFF_BITMAP_WORDS(numEntries);
+    int w;
+    uint64_t bits;
+
+    if ((from < 0) || (from >= numEntries))
+    {
+        return -1;
+    }
+
+    w = from / 64;
+    bits = bitmap[w] & (~((uint64_t) 0) << (from % 64));
+
+    while (bits == 0)
+    {
+        if (++w >= words)
+        {
+            return -1;
+        }
+        bits = bitmap[w];
+    }
+
+    from = (w * 64) + __builtin_ctzll(bits);
+
+    return (from < numEntries) ? from : -1;
+}
@@ -0,0 +1,108 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BST_JSON_DIFF_H
+#define	INCLUDE_BST_JSON_DIFF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "broadview.h"
+#include "bst.h"
+
+#ifdef	__cplusplus
+extern "C"
+{
+#endif
+
+/* Change detection for the report encoders.
+ *
+ * A realm is viewed as an array of 'numEntries' entries, each 'stride'
+ * uint64_t words wide, of which the first 'compareWords' words are counters
+ * (trailing words such as the queue's 'port' are not compared).
+ * The result is a bitmap with one bit per entry.
+ */
+
+/* Number of bitmap words needed for a realm of _n entries */
+#define BSTJSON_DIFF_BITMAP_WORDS(_n)      (((_n) + 63) / 64)
+
+/* Largest realm, in entries (the unicast queues) */
+#define BSTJSON_DIFF_MAX_ENTRIES           BVIEW_ASIC_MAX_UC_QUEUES
+
+/* Words in a bitmap large enough for any realm */
+#define BSTJSON_DIFF_MAX_BITMAP_WORDS      BSTJSON_DIFF_BITMAP_WORDS(BSTJSON_DIFF_MAX_ENTRIES)
+
+/* Number of uint64_t words in one entry of a realm data array */
+#define BSTJSON_DIFF_STRIDE(_entry)        ((int)(sizeof(_entry) / sizeof(uint64_t)))
+
+/* Instruction set selected for the diff kernel */
+typedef enum _bstjson_diff_isa_
+{
+    BSTJSON_DIFF_ISA_SCALAR = 0,
+    BSTJSON_DIFF_ISA_SSE2,
+    BSTJSON_DIFF_ISA_AVX2
+} BSTJSON_DIFF_ISA_t;
+
+/* Selects the best kernel for the CPU. Safe to call more than once */
+BVIEW_STATUS bstjson_diff_init(void);
+
+/* Returns the kernel currently in use */
+BSTJSON_DIFF_ISA_t bstjson_diff_isa_get(void);
+
+/* Forces a kernel, for measurements. Fails if the CPU lacks it */
+BVIEW_STATUS bstjson_diff_isa_set(BSTJSON_DIFF_ISA_t isa);
+
+/* Sets the bit of every entry whose compared words differ between
+ * 'previous' and 'current'. Returns the number of bits set. */
+int bstjson_diff_changed_get(const void *previous, const void *current,
+                             int numEntries, int stride, int compareWords,
+                             uint64_t *bitmap);
+
+/* Sets the bit of every entry that has a non-zero compared word.
+ * Returns the number of bits set. */
+int bstjson_diff_nonzero_get(const void *current,
+                             int numEntries, int stride, int compareWords,
+                             uint64_t *bitmap);
+
+/* Builds the bitmap of entries a report has to carry :
+ *   previous != NULL         - the changed entries
+ *   incremental snapshot     - the non-zero entries
+ *   full snapshot            - all entries
+ * Returns the number of bits set. */
+int bstjson_diff_report_bitmap_get(const void *previous, const void *current,
+                                   int numEntries, int stride, int compareWords,
+                                   bool sendIncrementalReport,
+                                   uint64_t *bitmap);
+
+/* Sets the bits of all 'numEntries' entries */
+void bstjson_diff_bitmap_fill(uint64_t *bitmap, int numEntries);
+
+/* Returns the number of bits set */
+int bstjson_diff_bitmap_count(const uint64_t *bitmap, int numEntries);
+
+/* Clears every bit except 'index'. An out of range index clears all */
+void bstjson_diff_bitmap_restrict(uint64_t *bitmap, int numEntries, int index);
+
+/* Returns the first set bit at or after 'from', or -1 if there is none */
+int bstjson_diff_bitmap_next(const uint64_t *bitmap, int numEntries, int from);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* INCLUDE_BST_JSON_DIFF_H */
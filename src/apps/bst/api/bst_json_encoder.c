@@ -34,6 +34,9 @@
 
 #include "bst_json_memory.h"
 #include "bst_json_encoder.h"
+#include "bst_json_diff.h"
+#include "bst_json_parallel.h"
+#include "bst_json_header.h"
 #include "bst_app.h"
 
 /******************************************************************
@@ -74,13 +77,21 @@ BVIEW_STATUS bstjson_encode_get_bst_feature( int asicId,
 \"send-snapshot-on-trigger\": %d,\
 \"trigger-rate-limit-interval\": %d,\
 \"async-full-reports\": %d,\
-\"stats-in-percentage\": %d\
+\"stats-in-percentage\": %d,\
+\"report-format\": %d,\
+\"report-filter\": %s,\
+\"report-layout\": %d,\
+\"keyframe-interval\": %d,\
+\"report-resync\": %d,\
+\"coalesce-window\": %d\
 },\
 \"id\": %d\
 }";
 
     char *jsonBuf;
     char asicIdStr[JSON_MAX_NODE_LENGTH] = { 0 };
+    char filterStr[BSTJSON_FILTER_ENCODE_LENGTH] = { 0 };
+    JSON_WRITER_t writer;
     BVIEW_STATUS status;
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-Feature \n");
@@ -88,6 +99,11 @@ BVIEW_STATUS bstjson_encode_get_bst_feature( int asicId,
     /* Validate Input Parameters */
     _JSONENCODE_ASSERT (pData != NULL);
 
+    /* the filter, in the form the configure request takes */
+    json_writer_init(&writer, &filterStr[0], sizeof(filterStr));
+    status = bstjson_filter_encode(asicId, &pData->reportFilter, &writer);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
     /* allocate memory for JSON */
     status = bstjson_memory_allocate(BSTJSON_MEMSIZE_RESPONSE, (uint8_t **) & jsonBuf);
     _JSONENCODE_ASSERT (status == BVIEW_STATUS_SUCCESS);
@@ -105,7 +121,9 @@ BVIEW_STATUS bstjson_encode_get_bst_feature( int asicId,
              pData->statUnitsInCells, 
              pData->bstMaxTriggers, pData->sendSnapshotOnTrigger,
              pData->triggerTransmitInterval, (pData->sendIncrementalReport == 0)?1:0, 
-             pData->statsInPercentage, method);
+             pData->statsInPercentage, pData->reportFormat, &filterStr[0],
+             pData->reportLayout, pData->keyframeInterval, pData->reportResync,
+             pData->coalesceWindow, method);
 
     /* setup the return value */
     *pJsonBuffer = (uint8_t *) jsonBuf;
@@ -209,28 +227,87 @@ BVIEW_STATUS bstjson_encode_get_bst_tracking( int asicId,
     return BVIEW_STATUS_SUCCESS;
 }
 
+/******************************************************************
+ * @brief  Chooses between the sparse and the dense layout of a realm.
+ *
+ * @param[in]     options     Report options
+ * @param[in]     previous    Snapshot the report is a difference to
+ * @param[in,out] bitmap      Entries to report, all set if dense
+ * @param[in]     numEntries  Entries in the realm
+ * @param[in]     numFields   Fields of a row, without the index
+ *
+ * @retval   true if the realm is to be written dense
+ *
+ * @note     A sparse row is " [  index , f1 , ... ] ,", a dense one
+ *           the same without "index , ". Dense rows are written for
+ *           every entry, so it only pays when most entries are reported.
+ *           Filtered and trigger-only reports stay sparse, as the dense
+ *           layout would bring back the entries they leave out.
+ *********************************************************************/
+bool bstjson_layout_dense_choose(const BSTJSON_REPORT_OPTIONS_t *options,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                 uint64_t *bitmap, int numEntries, int numFields)
+{
+    int numSet, indexChars, setRow, unsetRow, value;
+    int64_t sparse, dense;
+
+    if ((BST_REPORT_LAYOUT_ADAPTIVE != options->reportLayout) ||
+        (true == options->filter.active) ||
+        (_JSONENCODE_TRIGGER_ONLY(options)) ||
+        (numEntries <= 0))
+    {
+        return false;
+    }
+
+    numSet = bstjson_diff_bitmap_count(bitmap, numEntries);
+
+    /* digits of the largest index */
+    indexChars = 1;
+    for (value = numEntries - 1; value >= 10; value /= 10)
+    {
+        indexChars++;
+    }
+
+    /* " [  " and " ] ,", the fields and the " , " between them */
+    setRow = 8 + (numFields * BSTJSON_LAYOUT_VALUE_CHARS) + ((numFields - 1) * 3);
+
+    /* entries left out of an incremental snapshot are all zero */
+    unsetRow = setRow;
+    if ((NULL == previous) && (true == options->sendIncrementalReport))
+    {
+        unsetRow = 8 + numFields + ((numFields - 1) * 3);
+    }
+
+    sparse = (int64_t) numSet * (setRow + indexChars + 3);
+    dense = ((int64_t) numSet * setRow) + ((int64_t) (numEntries - numSet) * unsetRow);
+
+    if (dense >= sparse)
+    {
+        return false;
+    }
+
+    bstjson_diff_bitmap_fill(bitmap, numEntries);
+    return true;
+}
+
 /******************************************************************
  * @brief  Creates a JSON buffer using the supplied data for the 
  *         "get-bst-report" REST API - device part.
  *
  *********************************************************************/
 
-static BVIEW_STATUS _jsonencode_report_device ( char *jsonBuf,
+static BVIEW_STATUS _jsonencode_report_device ( JSON_WRITER_t *writer,
                                                const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                const BSTJSON_REPORT_OPTIONS_t *options,
-                                               const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                               int bufLen,
-                                               int *length)
+                                               const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
 
-  char *getBstDeviceReportTemplate = "{ \"realm\" : \"device\", \"data\" : % " PRIu64 "}";
   /* Since this is an internal function, with all parameters validated already, 
    * we jump to the logic straight-away 
    */
   uint64_t data;
-  *length = 0;
-  uint64_t maxBufVal = 0;
+  BSTJSON_CONVERT_t conv;
 
   _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding device data \n");
 
@@ -249,92 +326,169 @@ static BVIEW_STATUS _jsonencode_report_device ( char *jsonBuf,
     return BVIEW_STATUS_SUCCESS;
   }
   /* data to be sent to collector */
-  data = current->device.bufferCount;
-  maxBufVal = options->bst_max_buffers_ptr->device.data.maxBuf;
+  bstjson_convert_setup(options, asic, &conv);
+  _JSONENCODE_CONVERT_REALM(&conv, current->device, options->bst_max_buffers_ptr->device.data,
+                            bufferCount, maxBuf, 1, &data);
 
-  bst_json_convert_data(options, asic, &data, maxBufVal);
+  /* encode the JSON : { "realm" : "device", "data" : <count>} , */
+  JSON_WRITER_APPEND_LITERAL(writer, "{ \"realm\" : \"");
+  json_writer_append_str(writer, bst_registry_realm_name_get(BVIEW_BST_DEVICE));
+  JSON_WRITER_APPEND_LITERAL(writer, "\", \"data\" : ");
+  json_writer_append_u64(writer, data);
+  JSON_WRITER_APPEND_LITERAL(writer, "} ,");
+  _JSONENCODE_WRITER_CHECK(writer);
 
-  /* encode the JSON */
-  *length = snprintf(jsonBuf, bufLen, getBstDeviceReportTemplate, data);
-  _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding device data [%d] complete \n", *length);
+  _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding device data complete \n");
 
   return BVIEW_STATUS_SUCCESS;
 }
 
-static BVIEW_STATUS bstjson_realm_to_indices_get(char *realm, char *index1, char *index2)
+static BVIEW_STATUS bstjson_encode_trigger_realm_index_info(JSON_WRITER_t *writer, int asicId,
+                                                            const char *index, int port, int queue)
 {
-  static BSTJSON_REALM_INDEX_t bst_realm_indices_map [] = {
-    {"device" ,NULL, NULL},
-    {"ingress-service-pool", "service-pool", NULL},
-    {"ingress-port-service-pool", "port", "service-pool" },
-    {"ingress-port-priority-group", "port", "priority-group"},
-    {"egress-port-service-pool", "port", "service-pool"},
-    {"egress-service-pool", "service-pool", NULL},
-    {"egress-uc-queue", "queue", NULL},
-    {"egress-uc-queue-group", "queue-group", NULL},
-    {"egress-mc-queue", "queue", NULL},
-    {"egress-cpu-queue", "queue", NULL},
-    {"egress-rqe-queue", "queue", NULL}
-  };
-
-  unsigned int i;
-
-  if ((NULL == realm)||
-      (NULL == index1) ||
-      (NULL == index2))
+  char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
+
+  if (index != NULL)
   {
-    return BVIEW_STATUS_INVALID_PARAMETER;
+    if (0 == strcmp("port", index))
+    {
+      /* convert the port to an external representation */
+      memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
+      JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
+
+      /* "port" : "<port>", */
+      JSON_WRITER_APPEND_LITERAL(writer, "\"port\" : \"");
+      json_writer_append_str(writer, &portStr[0]);
+      JSON_WRITER_APPEND_LITERAL(writer, "\",");
+    }
+    else
+    {
+      /* "<index>" : <queue>, */
+      JSON_WRITER_APPEND_LITERAL(writer, "\"");
+      json_writer_append_str(writer, index);
+      JSON_WRITER_APPEND_LITERAL(writer, "\" : ");
+      json_writer_append_int(writer, queue);
+      JSON_WRITER_APPEND_LITERAL(writer, ",");
+    }
+    return BVIEW_STATUS_SUCCESS;
   }
+    return BVIEW_STATUS_FAILURE;
 
-  for (i = 0; i < 11; i++)
-  {
-    if (0 == strcmp(realm, bst_realm_indices_map[i].realm))
+}
+
+/******************************************************************
+ * @brief  Encodes the ingress and egress realms of a report, one
+ *         after the other.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _jsonencode_report_realms ( JSON_WRITER_t *writer,
+                                               int asicId,
+                                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                               const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                               const BSTJSON_REPORT_OPTIONS_t *options,
+                                               const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    BVIEW_STATUS status;
+
+    /* if any of the ingress encodings are required, add them to report */
+    if (options->includeIngressPortPriorityGroup ||
+        options->includeIngressPortServicePool ||
+        options->includeIngressServicePool)
     {
-      if (NULL != bst_realm_indices_map[i].index1)
+        status = _jsonencode_report_ingress(writer, asicId, previous, current, options, asic);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+    }
+
+    /* if any of the egress encodings are required, add them to report */
+    if (options->includeEgressCpuQueue ||
+        options->includeEgressMcQueue ||
+        options->includeEgressPortServicePool ||
+        options->includeEgressRqeQueue ||
+        options->includeEgressServicePool ||
+        options->includeEgressUcQueue ||
+        options->includeEgressUcQueueGroup )
+    {
+        status = _jsonencode_report_egress(writer, asicId, previous, current, options, asic);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Writes a whole "get-bst-report" message into a writer,
+ *         either a report buffer or a streaming chunk.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _jsonencode_report_write ( JSON_WRITER_t *writer,
+                                              int asicId,
+                                              int method,
+                                              const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                              const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                              const BSTJSON_REPORT_OPTIONS_t *options,
+                                              const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                              const BVIEW_TIME_t *time)
+{
+    BVIEW_STATUS status;
+    const BVIEW_BST_REGISTRY_REALM_t *realmIndex;
+
+    /* fill the header */
+    status = bstjson_header_write(writer, asicId, options, time);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+    if (options->reportTrigger == true)
+    {
+      realmIndex = bst_registry_realm_get(options->triggerInfo.realm);
+      if (NULL == realmIndex)
       {
-        strncpy(index1, bst_realm_indices_map[i].index1, strlen(bst_realm_indices_map[i].index1));
+        return BVIEW_STATUS_INVALID_PARAMETER;
       }
 
-      if (NULL != bst_realm_indices_map[i].index2)
+      if (NULL != realmIndex->index1)
       {
-        strncpy(index2, bst_realm_indices_map[i].index2, strlen(bst_realm_indices_map[i].index2));
+        status = bstjson_encode_trigger_realm_index_info(writer, asicId, realmIndex->index1, 
+            options->triggerInfo.port, options->triggerInfo.queue);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
       }
 
-      return BVIEW_STATUS_SUCCESS;
-    }
-  }
-
-  return BVIEW_STATUS_FAILURE;
 
-}
+      if (NULL != realmIndex->index2)
+      {
+        status = bstjson_encode_trigger_realm_index_info(writer, asicId, realmIndex->index2, 
+            options->triggerInfo.port, options->triggerInfo.queue);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+      }
 
-BVIEW_STATUS bstjson_encode_trigger_realm_index_info(char *buffer, int asicId,
-                                                     int bufLen,int *length,
-                                                     char *index, int port, int queue)
-{
-  char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
+      JSON_WRITER_APPEND_LITERAL(writer, "\"report\" : [");
+    }
+    _JSONENCODE_WRITER_CHECK(writer);
 
-  char * portTemplate = "\"port\" : \"%s\",";
-  char * indexTemplate = "\"%s\" : %d,";
+    /* get the device report */
+    status = _jsonencode_report_device(writer, previous, current, options, asic);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
 
-  if (index != NULL)
-  {
-    if (0 == strcmp("port", index))
+    /* encode the realms in parallel when we can, serially otherwise */
+    status = bstjson_parallel_encode_realms(writer, asicId, previous, current, options, asic);
+    if (status == BVIEW_STATUS_RESOURCE_NOT_AVAILABLE)
     {
-      /* convert the port to an external representation */
-      memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
-      JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
-       *length = snprintf(buffer, bufLen, portTemplate, &portStr[0]);
+        status = _jsonencode_report_realms(writer, asicId, previous, current, options, asic);
     }
-    else
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+
+    /* finalizing the report */
+    json_writer_backup(writer, 1);
+
+    if (json_writer_peek(writer) == 0)
     {
-       *length = snprintf(buffer, bufLen, indexTemplate, index, queue);
+        json_writer_backup(writer, 1);
     }
-    return BVIEW_STATUS_SUCCESS;
-  }
-    return BVIEW_STATUS_FAILURE;
 
+    JSON_WRITER_APPEND_LITERAL(writer, " ] } ");
+    _JSONENCODE_WRITER_CHECK(writer);
+
+    return BVIEW_STATUS_SUCCESS;
 }
+
 /******************************************************************
  * @brief  Creates a JSON buffer using the supplied data for the 
  *         "get-bst-report" REST API.
@@ -364,39 +518,9 @@ BVIEW_STATUS bstjson_encode_get_bst_report ( int asicId,
                                             uint8_t **pJsonBuffer
                                             )
 {
-    char *jsonBuf, *start;
+    char *jsonBuf;
     BVIEW_STATUS status;
-    int bufferLength = BSTJSON_MEMSIZE_REPORT;
-    int tempLength = 0;
-
-    time_t report_time;
-    struct tm *timeinfo;
-    char timeString[64];
-    char asicIdStr[JSON_MAX_NODE_LENGTH] = { 0 };
-    char index1[256];
-    char index2[256];
-
-
-
-    char *getBstReportStart = " { \
-\"jsonrpc\": \"2.0\",\
-\"method\": \"%s\",\
-\"asic-id\": \"%s\",\
-\"version\": \"%d\",\
-\"time-stamp\": \"%s\",\
-\"report\": [ \
-";
-
-    char *getBstTriggerReportStart = " { \
-\"jsonrpc\": \"2.0\",\
-\"method\": \"%s\",\
-\"asic-id\": \"%s\",\
-\"version\": \"%d\",\
-\"time-stamp\": \"%s\",\
-\"realm\": \"%s\",\
-\"counter\": \"%s\",\
-";
-
+    JSON_WRITER_t writer;
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-Report \n");
 
@@ -406,146 +530,91 @@ BVIEW_STATUS bstjson_encode_get_bst_report ( int asicId,
     _JSONENCODE_ASSERT (time != NULL);
     _JSONENCODE_ASSERT (asic != NULL);
 
-    /* obtain the time */
-    memset(&timeString, 0, sizeof (timeString));
-    report_time = *(time_t *) time;
-    timeinfo = localtime(&report_time);
-    strftime(timeString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
-
     /* allocate memory for JSON */
     status = bstjson_memory_allocate(BSTJSON_MEMSIZE_REPORT, (uint8_t **) & jsonBuf);
     _JSONENCODE_ASSERT (status == BVIEW_STATUS_SUCCESS);
 
-    start = jsonBuf;
-
     /* clear the buffer */
     memset(jsonBuf, 0, BSTJSON_MEMSIZE_REPORT);
 
-    /* convert asicId to external  notation */
-    JSON_ASIC_ID_MAP_TO_NOTATION(asicId, &asicIdStr[0]);
-
-    /* fill the header */
-    /* encode the JSON */
-
-    if (options->reportTrigger == false)
-    {
-      tempLength = snprintf(jsonBuf, bufferLength, getBstReportStart,
-          (options->reportThreshold == true) ? "get-bst-thresholds" :"get-bst-report",
-          &asicIdStr[0], BVIEW_JSON_VERSION, timeString);
-      bufferLength -= tempLength;
-      jsonBuf += tempLength;
-    }
-    else
-    {
-      memset(index1, 0, sizeof(index1));
-      memset(index2, 0, sizeof(index2));
-      if (BVIEW_STATUS_SUCCESS != bstjson_realm_to_indices_get((char *)options->triggerInfo.realm, &index1[0], &index2[0]))
-      {
-        return BVIEW_STATUS_INVALID_PARAMETER;
-      }
-      tempLength = snprintf(jsonBuf, bufferLength, getBstTriggerReportStart,
-          "trigger-report",
-          &asicIdStr[0], BVIEW_JSON_VERSION, timeString, options->triggerInfo.realm, options->triggerInfo.counter);
-
-      jsonBuf += tempLength;
-      bufferLength -= tempLength;
-      if (0 != index1[0])
-      {
-        status = bstjson_encode_trigger_realm_index_info(jsonBuf, asicId, bufferLength, &tempLength, &index1[0], 
-            options->triggerInfo.port, options->triggerInfo.queue);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-        bufferLength -= tempLength;
-        jsonBuf += tempLength;
-      }
+    json_writer_init(&writer, jsonBuf, BSTJSON_MEMSIZE_REPORT);
+    status = _jsonencode_report_write(&writer, asicId, method, previous, current, options, asic, time);
+    _JSONENCODE_ASSERT_ERROR_AND_FREE((status == BVIEW_STATUS_SUCCESS), status, jsonBuf);
 
+    *pJsonBuffer = (uint8_t *) jsonBuf;
 
-      if (0 != index2[0])
-      {
-        status = bstjson_encode_trigger_realm_index_info(jsonBuf, asicId, bufferLength, &tempLength, &index2[0], 
-            options->triggerInfo.port, options->triggerInfo.queue);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-        bufferLength -= tempLength;
-        jsonBuf += tempLength;
-      }
-
-      tempLength = snprintf(jsonBuf, bufferLength, "\"report\" : [" ); 
-      bufferLength -= tempLength;
-      jsonBuf += tempLength; 
-    }
-
-    /* get the device report */
-    status = _jsonencode_report_device(jsonBuf, previous, current, options, asic, bufferLength, &tempLength);
-    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-    if (tempLength)
-    {
-        bufferLength -= tempLength;
-        jsonBuf += tempLength;
-
-        tempLength = snprintf(jsonBuf, bufferLength, " ,");
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-Report Complete [%d] bytes \n", json_writer_length(&writer));
 
-        bufferLength -= tempLength;
-        jsonBuf += tempLength;
-    }
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_DUMPJSON, "BST-JSON-Encoder : %s \n", jsonBuf);
 
-    /* if any of the ingress encodings are required, add them to report */
-    if (options->includeIngressPortPriorityGroup ||
-        options->includeIngressPortServicePool ||
-        options->includeIngressServicePool)
-    {
-        status = _jsonencode_report_ingress(jsonBuf, asicId, previous, current, options, asic, bufferLength, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
 
-        /* adjust the buffer */
-        bufferLength -= (tempLength);
-        jsonBuf += (tempLength);
+    return BVIEW_STATUS_SUCCESS;
+}
 
-    }
+/******************************************************************
+ * @brief  Encodes a "get-bst-report" message in fixed size chunks,
+ *         handing each chunk to a sink as soon as it is full.
+ *
+ * @param[in]   asicId      ASIC for which this data is being encoded.
+ * @param[in]   method      Method ID (from original request) that needs 
+ *                          to be encoded in JSON.
+ * @param[in]   sink        receives the chunks, in order
+ * @param[in]   sinkCtx     passed back to the sink
+ *                           
+ * @retval   BVIEW_STATUS_SUCCESS  The whole report was handed to the sink
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  A single piece did not fit in a chunk
+ * @retval   other  first error returned by the sink
+ *
+ * @note     The text is the same as bstjson_encode_get_bst_report()'s,
+ *           but only BSTJSON_STREAM_CHUNK_SIZE bytes are needed for it.
+ *           On failure the sink may already have received part of it.
+ *********************************************************************/
 
-    /* if any of the egress encodings are required, add them to report */
-    if (options->includeEgressCpuQueue ||
-        options->includeEgressMcQueue ||
-        options->includeEgressPortServicePool ||
-        options->includeEgressRqeQueue ||
-        options->includeEgressServicePool ||
-        options->includeEgressUcQueue ||
-        options->includeEgressUcQueueGroup )
-    {
-        status = _jsonencode_report_egress(jsonBuf, asicId, previous, current, options, asic, bufferLength, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+BVIEW_STATUS bstjson_encode_get_bst_report_stream ( int asicId,
+                                                   int method,
+                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                   const BSTJSON_REPORT_OPTIONS_t *options,
+                                                   const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                                   const BVIEW_TIME_t *time,
+                                                   JSON_WRITER_SINK_t sink,
+                                                   void *sinkCtx
+                                                   )
+{
+    char chunk[BSTJSON_STREAM_CHUNK_SIZE];
+    BVIEW_STATUS status;
+    JSON_WRITER_t writer;
 
-        /* adjust the buffer */
-        bufferLength -= (tempLength);
-        jsonBuf += (tempLength);
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for streamed Get-Bst-Report \n");
 
-    }
+    /* Validate Input Parameters */
+    _JSONENCODE_ASSERT (options != NULL);
+    _JSONENCODE_ASSERT (current != NULL);
+    _JSONENCODE_ASSERT (time != NULL);
+    _JSONENCODE_ASSERT (asic != NULL);
+    _JSONENCODE_ASSERT (sink != NULL);
 
-    /* finalizing the report */
+    memset(chunk, 0, sizeof(chunk));
 
-    bufferLength -= 1;
-    jsonBuf -= 1;
+    json_writer_stream_init(&writer, chunk, sizeof(chunk), sink, sinkCtx);
+    status = _jsonencode_report_write(&writer, asicId, method, previous, current, options, asic, time);
 
-    if (jsonBuf[0] == 0)
+    /* a failing sink shows up as an overflow, report its own error instead */
+    if ((status == BVIEW_STATUS_OUTOFMEMORY) && (writer.sinkStatus != BVIEW_STATUS_SUCCESS))
     {
-        bufferLength -= 1;
-        jsonBuf--;
+        status = writer.sinkStatus;
     }
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
 
-    tempLength = snprintf(jsonBuf, bufferLength, " ] } ");
-
-    *pJsonBuffer = (uint8_t *) start;
-
-    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Request for Get-Bst-Report Complete [%d] bytes \n", (int)strlen(start));
-
-    _JSONENCODE_LOG(_JSONENCODE_DEBUG_DUMPJSON, "BST-JSON-Encoder : %s \n", start);
+    status = json_writer_flush(&writer);
+    _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
 
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : Streamed Get-Bst-Report Complete [%d] bytes \n", json_writer_length(&writer));
 
     return BVIEW_STATUS_SUCCESS;
 }
 
-uint64_t round_int( double r ) {
-      return (r > 0.0) ? (r + 0.5) : (r - 0.5); 
-}
 /******************************************************************* 
    Utility function to convert the data based on config 
 ********************************************************************/
@@ -553,8 +622,7 @@ BVIEW_STATUS bst_json_convert_data(const BSTJSON_REPORT_OPTIONS_t *options,
                                           const BVIEW_ASIC_CAPABILITIES_t *asic,
                                           uint64_t *value, uint64_t maxBufVal)
 {
-  double percentage =0;
-  uint64_t data = 0;
+  BSTJSON_CONVERT_t conv;
 
   if ((NULL == options) ||
       (NULL == asic) ||
@@ -563,46 +631,10 @@ BVIEW_STATUS bst_json_convert_data(const BSTJSON_REPORT_OPTIONS_t *options,
     return BVIEW_STATUS_INVALID_PARAMETER;
   }
 
-  data = *value;
-
-
-  /* Report is threshold. */
-  if (true == options->reportThreshold)
-  {
-    if (true == options->statUnitsInCells)
-    {
-      /* threshold comes in bytes from asic */
-      data = data / (asic->cellToByteConv);
-    }
-  }
-  else
-  {
-    /* report is stats */
-    if (true == options->statsInPercentage)
-    {
-      if (0 == maxBufVal)
-      {
-        data = 0;
-      }
-      else
-      {
-        /* we just need the percentage of the configured value */
-        percentage = ((double)(data * 100))/((double)(maxBufVal));
-        data = round_int(percentage);
-      }
-    }
-    else
-    {
-      /* conversion to bytes or cells based on config */
-      if (true == options->statUnitsInCells)
-      {
-        /* threshold comes in bytes from asic */
-        data = data / (asic->cellToByteConv);
-      }
-    }
-  }
-
-  *value = data;
+  /* single value, same arithmetic as the realm encoders */
+  bstjson_convert_setup(options, asic, &conv);
+  conv.percent = NULL;
+  bstjson_convert_batch(&conv, value, 1, &maxBufVal, 1, 1, value);
 
   return BVIEW_STATUS_SUCCESS;
 }
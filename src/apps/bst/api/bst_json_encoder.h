@@ -26,8 +26,43 @@ extern "C"
 
 #include "broadview.h"
 #include "json.h"
+#include "json_writer.h"
 
 #include "bst.h"
+#include "bst_json_filter.h"
+
+/* Chunk a streamed report is encoded into */
+#define BSTJSON_STREAM_CHUNK_SIZE       4096
+
+/* Number of counters in the max buffer snapshot */
+#define BSTJSON_CONVERT_MAXBUF_WORDS    (sizeof(BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t) / sizeof(uint64_t))
+
+/* Fixed-point factor for a unit/percentage conversion.
+ * The division by 'divisor' is done with the precomputed 'reciprocal'. */
+typedef struct _bstjson_convert_factor_
+{
+    uint64_t addend;
+    uint64_t divisor;
+    uint64_t reciprocal;
+} BSTJSON_CONVERT_FACTOR_t;
+
+/* Percentage factors, one per max buffer counter.
+ * Rebuilt only when the max buffer settings change */
+typedef struct _bstjson_convert_table_
+{
+    bool valid;
+    /* max buffer values the factors were built from */
+    BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t maxBuffers;
+    BSTJSON_CONVERT_FACTOR_t percent[BSTJSON_CONVERT_MAXBUF_WORDS];
+} BSTJSON_CONVERT_TABLE_t;
+
+/* conversion modes */
+typedef enum _bstjson_convert_mode_
+{
+    BSTJSON_CONVERT_NONE = 0,
+    BSTJSON_CONVERT_CELLS,
+    BSTJSON_CONVERT_PERCENT
+} BSTJSON_CONVERT_MODE_t;
 
 /* reporting options */
 typedef struct _bst_reporting_options_
@@ -51,15 +86,92 @@ typedef struct _bst_reporting_options_
     bool sendIncrementalReport;
     bool statsInPercentage;
     BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *bst_max_buffers_ptr;
+    const BSTJSON_CONVERT_TABLE_t *bst_convert_table_ptr;
+    /* BST_REPORT_FORMAT_t the report is sent in */
+    int reportFormat;
+    /* BST_REPORT_LAYOUT_t of the realm data */
+    int reportLayout;
+    /* entries of the included realms to report */
+    BSTJSON_REPORT_FILTER_t filter;
+    /* position of the report in its incremental stream, 0 if the
+       report is not part of one */
+    uint64_t sequenceNumber;
+    /* the report is a difference to no earlier report */
+    bool keyframe;
+    /* the data was collected while the south bound was resyncing */
+    bool stale;
 } BSTJSON_REPORT_OPTIONS_t;
 
-/* structure to map the realms and indices */
+/* conversion to be applied on the counters of one report */
+typedef struct _bstjson_convert_
+{
+    BSTJSON_CONVERT_MODE_t mode;
+    /* factor for CELLS mode */
+    BSTJSON_CONVERT_FACTOR_t cells;
+    /* per counter factors for PERCENT mode, NULL if there is no valid table */
+    const BSTJSON_CONVERT_FACTOR_t *percent;
+    /* max buffers, for PERCENT mode without a table */
+    const uint64_t *maxBuffers;
+} BSTJSON_CONVERT_t;
+
 
-typedef struct _bst_realm_index_ {
-  char *realm;
-  char *index1;
-  char *index2;
-}BSTJSON_REALM_INDEX_t;
+/* Encodes one realm of a report, leaving a trailing ',' after it */
+typedef BVIEW_STATUS (*BSTJSON_REALM_ENCODER_t) (JSON_WRITER_t *writer,
+                                                 int asicId,
+                                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                 const BSTJSON_REPORT_OPTIONS_t *options,
+                                                 const BVIEW_ASIC_CAPABILITIES_t *asic);
+
+/* Layout of the realm data in a JSON report.
+ *
+ * A realm is normally written sparse : one "[ index, ... ]" row per
+ * reported entry. With the adaptive layout, a realm not indexed by port
+ * is written dense when that is estimated to be shorter :
+ *   { "realm": "egress-uc-queue", "layout": "dense", "data": [ row, ... ] }
+ * with the row of every entry, in index order and without the index.
+ * The estimate uses BSTJSON_LAYOUT_VALUE_CHARS per field of a reported
+ * entry, and one character per field of an entry only known to be zero. */
+#define BSTJSON_LAYOUT_VALUE_CHARS      6
+
+/* opens realm '_realm' (BVIEW_BST_REALM_ID_t), in the given layout.
+ * The name comes from the registry (bst_registry.h) */
+#define _JSONENCODE_REALM_OPEN(w, _realm, _dense) \
+    do { \
+        JSON_WRITER_APPEND_LITERAL((w), " { \"realm\": \""); \
+        json_writer_append_str((w), bst_registry_realm_name_get(_realm)); \
+        if (_dense) { \
+            JSON_WRITER_APPEND_LITERAL((w), "\", \"layout\": \"dense\", \"data\": [ "); \
+        } else { \
+            JSON_WRITER_APPEND_LITERAL((w), "\", \"data\": [ "); \
+        } \
+    } while(0)
+
+/* Number of ingress and egress realms in a report */
+#define BSTJSON_INGRESS_REALMS          3
+#define BSTJSON_EGRESS_REALMS           7
+
+/* Most text a realm takes : a row per entry of its snapshot data, each
+ * with its index and brackets, and up to 20 digits and separators per
+ * counter, plus the realm framing and a header per port */
+#define BSTJSON_REALM_ROW_CHARS         24
+#define BSTJSON_REALM_FIELD_CHARS       24
+#define BSTJSON_REALM_MARGIN            (64 * BVIEW_ASIC_MAX_PORTS)
+#define BSTJSON_REALM_LENGTH(_member, _entry) \
+    ((int) ((sizeof(((BVIEW_BST_ASIC_SNAPSHOT_DATA_t *) 0)->_member) / \
+             sizeof(((BVIEW_BST_ASIC_SNAPSHOT_DATA_t *) 0)->_entry)) * \
+            (BSTJSON_REALM_ROW_CHARS + \
+             ((sizeof(((BVIEW_BST_ASIC_SNAPSHOT_DATA_t *) 0)->_entry) / sizeof(uint64_t)) * \
+              BSTJSON_REALM_FIELD_CHARS))) + BSTJSON_REALM_MARGIN)
+
+/* lists a realm, see _jsonencode_report_ingress_realms_get() */
+#define _JSONENCODE_REALM_ADD(_encoders, _lengths, _count, _encoder, _member, _entry) \
+    do { \
+        if (NULL != (_lengths)) { \
+            (_lengths)[(_count)] = BSTJSON_REALM_LENGTH(_member, _entry); \
+        } \
+        (_encoders)[(_count)++] = (_encoder); \
+    } while(0)
 
 #define _JSONENCODE_DEBUG
 #define _JSONENCODE_DEBUG_LEVEL         _JSONENCODE_DEBUG_ERROR
@@ -92,6 +204,32 @@ typedef struct _bst_realm_index_ {
 
 #define _JSONENCODE_ASSERT(condition) _JSONENCODE_ASSERT_ERROR((condition), (BVIEW_STATUS_INVALID_PARAMETER))
 
+/* same as _JSONENCODE_ASSERT_ERROR, releasing the JSON buffer being encoded */
+#define _JSONENCODE_ASSERT_ERROR_AND_FREE(condition, errcode, buf) do { \
+    if (!(condition)) { \
+        _JSONENCODE_LOG(_JSONENCODE_DEBUG_ERROR, \
+                    "BST JSON Encoder (%s:%d) Encoding failed  \n", \
+                    __func__, __LINE__); \
+        bstjson_memory_free((uint8_t *) (buf)); \
+        return (errcode); \
+    } \
+} while(0)
+
+/* true if a trigger report must carry only the entry that triggered */
+#define _JSONENCODE_TRIGGER_ONLY(options) \
+    ((true == (options)->reportTrigger) && (false == (options)->sendSnapShotOnTrigger))
+
+/* bytes per unit of the report's counters, for the report filter */
+#define _JSONENCODE_BYTES_PER_UNIT(options, asic) \
+    ((((options)->statUnitsInCells) && ((asic)->cellToByteConv > 0)) ? (uint64_t) (asic)->cellToByteConv : 1)
+
+/* converts counter '_cnt' of every entry of a realm data array, using max buffer '_max' */
+#define _JSONENCODE_CONVERT_REALM(_conv, _cur, _maxb, _cnt, _max, _count, _out) \
+    bstjson_convert_batch((_conv), \
+                          &(_cur)._cnt, (int) (sizeof(_cur) / sizeof(uint64_t)), \
+                          &(_maxb)._max, (int) (sizeof(_maxb) / sizeof(uint64_t)), \
+                          (_count), (_out))
+
 #define _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actLen, dst, len, lenptr, format, args...) \
     do { \
         int xtemp = *(lenptr); \
@@ -106,6 +244,22 @@ typedef struct _bst_realm_index_ {
         (len) -= (actLen); \
     } while(0)
 
+/* returns out of memory if the report no longer fits in the writer's buffer */
+#define _JSONENCODE_WRITER_CHECK(w) \
+    do { \
+        if (json_writer_overflow(w)) { \
+            _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (%s:%d) Out of Json memory while encoding \n", __func__, __LINE__); \
+            return BVIEW_STATUS_OUTOFMEMORY; \
+        } \
+    } while(0)
+
+/* replaces the trailing ',' of the last entry with "] } ," */
+#define _JSONENCODE_WRITER_CLOSE(w) \
+    do { \
+        json_writer_backup((w), 1); \
+        JSON_WRITER_APPEND_LITERAL((w), "] } ,"); \
+    } while(0)
+
 /* Prototypes */
 
 BVIEW_STATUS bstjson_encode_get_bst_feature(int asicId,
@@ -131,24 +285,49 @@ BVIEW_STATUS bstjson_encode_get_bst_report(int asicId,
                                            uint8_t **pJsonBuffer
                                            );
 
-BVIEW_STATUS _jsonencode_report_ingress(char *buffer,
+BVIEW_STATUS bstjson_encode_get_bst_report_stream(int asicId,
+                                                  int method,
+                                                  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                                  const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                                  const BSTJSON_REPORT_OPTIONS_t *options,
+                                                  const BVIEW_ASIC_CAPABILITIES_t *asic,
+                                                  const BVIEW_TIME_t *reportTime,
+                                                  JSON_WRITER_SINK_t sink,
+                                                  void *sinkCtx
+                                                  );
+
+BVIEW_STATUS _jsonencode_report_ingress(JSON_WRITER_t *writer,
                                         int asicId,
                                         const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                         const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                         const BSTJSON_REPORT_OPTIONS_t *options,
-                                        const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                        int bufLen,
-                                        int *length
+                                        const BVIEW_ASIC_CAPABILITIES_t *asic
                                         );
 
-BVIEW_STATUS _jsonencode_report_egress(char *buffer,
+/* Tells if a realm is to be written dense. If so, every bit of 'bitmap'
+ * is set, as every entry is written. 'numFields' is the row width
+ * without the index. */
+bool bstjson_layout_dense_choose(const BSTJSON_REPORT_OPTIONS_t *options,
+                                 const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                 uint64_t *bitmap, int numEntries, int numFields);
+
+/* Fill 'encoders' with the encoders of the realms asked for, in report order,
+ * and 'lengths', unless NULL, with the room each realm takes on its own.
+ * Return the number of realms. */
+int _jsonencode_report_ingress_realms_get(const BSTJSON_REPORT_OPTIONS_t *options,
+                                          BSTJSON_REALM_ENCODER_t *encoders,
+                                          int *lengths);
+
+int _jsonencode_report_egress_realms_get(const BSTJSON_REPORT_OPTIONS_t *options,
+                                         BSTJSON_REALM_ENCODER_t *encoders,
+                                         int *lengths);
+
+BVIEW_STATUS _jsonencode_report_egress(JSON_WRITER_t *writer,
                                        int asicId,
                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                        const BSTJSON_REPORT_OPTIONS_t *options,
-                                       const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                       int bufLen,
-                                       int *length
+                                       const BVIEW_ASIC_CAPABILITIES_t *asic
                                        );
 
 /******************************************************************* 
@@ -158,6 +337,21 @@ BVIEW_STATUS bst_json_convert_data(const BSTJSON_REPORT_OPTIONS_t *options,
                                           const BVIEW_ASIC_CAPABILITIES_t *asic,
                                           uint64_t *value, uint64_t defVal);
 
+/******************************************************************* 
+   Batched conversion of realm counters, see bst_json_convert.c
+********************************************************************/
+BVIEW_STATUS bstjson_convert_table_update(BSTJSON_CONVERT_TABLE_t *table,
+                                          const BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuffers);
+
+void bstjson_convert_setup(const BSTJSON_REPORT_OPTIONS_t *options,
+                           const BVIEW_ASIC_CAPABILITIES_t *asic,
+                           BSTJSON_CONVERT_t *conv);
+
+void bstjson_convert_batch(const BSTJSON_CONVERT_t *conv,
+                           const uint64_t *values, int valueStride,
+                           const uint64_t *maxBuf, int maxBufStride,
+                           int count, uint64_t *out);
+
 #ifdef __cplusplus
 }
 #endif
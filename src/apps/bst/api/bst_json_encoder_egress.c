@@ -29,80 +29,85 @@
 
 #include "bst_json_memory.h"
 #include "bst_json_encoder.h"
+#include "bst_json_diff.h"
+#include "bst_json_filter.h"
 
 /******************************************************************
  * @brief  Creates a JSON buffer using the supplied data for the 
  *         "get-bst-report" REST API - egress CPU Queue.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_cpuq ( char *buffer, int asicId,
+static BVIEW_STATUS _jsonencode_report_egress_cpuq ( JSON_WRITER_t *writer, int asicId,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                     const BSTJSON_REPORT_OPTIONS_t *options,
-                                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                    int bufLen,
-                                                    int *length)
+                                                    const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
-    int queue = 0;
+    int queue = 0, entry = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
-    int sendIncrReport = options->sendIncrementalReport;
-
-    char *realmTemplate = " { \"realm\": \"egress-cpu-queue\", \"%s\": [ ";
-    char *cpuqTemplate = " [  %d , %" PRIu64 ", %" PRIu64 " ] ,";
+    uint64_t includeQueues[BSTJSON_DIFF_BITMAP_WORDS(BVIEW_ASIC_MAX_CPU_QUEUES)];
+    BSTJSON_CONVERT_t conv;
+    bool dense = false;
+    uint64_t cpuBuffer[BVIEW_ASIC_MAX_CPU_QUEUES];
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - CPU Queue data \n");
 
-    /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    /* find the queues that need to be reported */
+    bstjson_diff_report_bitmap_get((previous != NULL) ? &previous->cpqQ.data[0] : NULL,
+                                   &current->cpqQ.data[0],
+                                   asic->numCpuQueues, BSTJSON_DIFF_STRIDE(current->cpqQ.data[0]), 2,
+                                   options->sendIncrementalReport, includeQueues);
 
-    /* For each queue, check if there is a difference, and create the report. */
-    for (queue = 1; queue <= asic->numCpuQueues; queue++)
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
     {
-      /* check if the trigger report request should contain snap shot */
-        if ((queue-1 != options->triggerInfo.queue) && 
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
-        {
-          continue;
-        }
-        /* lets see if this queue needs to be included in the report at all */
-        /* if this queue needs not be reported, then we move to next queue */
-      if (true == sendIncrReport)
-      {
-        if ((NULL == previous) &&
-            (current->cpqQ.data[queue - 1].cpuBufferCount == 0) &&
-            (current->cpqQ.data[queue - 1].cpuQueueEntries == 0))
-            continue;
-      }
+        bstjson_diff_bitmap_restrict(includeQueues, asic->numCpuQueues, options->triggerInfo.queue);
+    }
 
-        if ((previous != NULL) &&
-            (previous->cpqQ.data[queue - 1].cpuBufferCount == current->cpqQ.data[queue - 1].cpuBufferCount) &&
-            (previous->cpqQ.data[queue - 1].cpuQueueEntries == current->cpqQ.data[queue - 1].cpuQueueEntries))
-            continue;
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                &current->cpqQ.data[0],
+                                asic->numCpuQueues, BSTJSON_DIFF_STRIDE(current->cpqQ.data[0]), 2,
+                                0, -1, BSTJSON_FILTER_INDEX_QUEUE, includeQueues);
 
-             val = current->cpqQ.data[queue - 1].cpuBufferCount;
-             maxBufVal = options->bst_max_buffers_ptr->cpqQ.data[queue - 1].cpuMaxBuf;
-             bst_json_convert_data(options, asic, &val, maxBufVal);
-        /* Now that this queue needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      cpuqTemplate, queue-1,
-                                                      val,
-                                                      current->cpqQ.data[queue - 1].cpuQueueEntries
-                                                      );
+    /* write every entry in index order, without its index, when that is shorter */
+    dense = bstjson_layout_dense_choose(options, previous, includeQueues, asic->numCpuQueues, 2);
 
-    }
+    /* copying the header */
+    _JSONENCODE_REALM_OPEN(writer, BVIEW_BST_EGRESS_CPU_QUEUE, dense);
+
+    /* convert the counters to the reported units */
+    bstjson_convert_setup(options, asic, &conv);
+    _JSONENCODE_CONVERT_REALM(&conv, current->cpqQ.data[0], options->bst_max_buffers_ptr->cpqQ.data[0],
+                              cpuBufferCount, cpuMaxBuf, asic->numCpuQueues, cpuBuffer);
+
+    /* For each queue with a difference, create the report. */
+    for (entry = bstjson_diff_bitmap_next(includeQueues, asic->numCpuQueues, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includeQueues, asic->numCpuQueues, entry + 1))
+    {
+        queue = entry + 1;
 
-    /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+        val = cpuBuffer[entry];
 
-    /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+        /* Now that this queue needs to be included in the report, add the data to report :
+         * " [  queue , cpu-buffer, cpu-queue-entries ] ," */
+        JSON_WRITER_APPEND_LITERAL(writer, " [  ");
+        if (false == dense)
+        {
+            json_writer_append_int(writer, queue-1);
+            JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        }
+        json_writer_append_u64(writer, val);
+        JSON_WRITER_APPEND_LITERAL(writer, ", ");
+        json_writer_append_u64(writer, current->cpqQ.data[queue - 1].cpuQueueEntries);
+        JSON_WRITER_APPEND_LITERAL(writer, " ] ,");
+        _JSONENCODE_WRITER_CHECK(writer);
+    }
+
+    /* replace the last ',' with the "] } ," for the next 'realm' */
+    _JSONENCODE_WRITER_CLOSE(writer);
+    _JSONENCODE_WRITER_CHECK(writer);
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - CPU Queue data Complete \n");
 
@@ -114,74 +119,77 @@ static BVIEW_STATUS _jsonencode_report_egress_cpuq ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress RQE Queue.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_rqeq ( char *buffer, int asicId,
+static BVIEW_STATUS _jsonencode_report_egress_rqeq ( JSON_WRITER_t *writer, int asicId,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                     const BSTJSON_REPORT_OPTIONS_t *options,
-                                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                    int bufLen,
-                                                    int *length)
+                                                    const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
-    int queue = 0;
+    int queue = 0, entry = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
-    int sendIncrReport = options->sendIncrementalReport;
-
-    char *realmTemplate = " { \"realm\": \"egress-rqe-queue\", \"%s\": [ ";
-    char *cpuqTemplate = " [  %d , %" PRIu64 ", %" PRIu64 " ] ,";
+    uint64_t includeQueues[BSTJSON_DIFF_BITMAP_WORDS(BVIEW_ASIC_MAX_RQE_QUEUES)];
+    BSTJSON_CONVERT_t conv;
+    bool dense = false;
+    uint64_t rqeBuffer[BVIEW_ASIC_MAX_RQE_QUEUES];
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - RQE Queue data \n");
 
-    /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    /* find the queues that need to be reported */
+    bstjson_diff_report_bitmap_get((previous != NULL) ? &previous->rqeQ.data[0] : NULL,
+                                   &current->rqeQ.data[0],
+                                   asic->numRqeQueues, BSTJSON_DIFF_STRIDE(current->rqeQ.data[0]), 2,
+                                   options->sendIncrementalReport, includeQueues);
 
-    /* For each queue, check if there is a difference, and create the report. */
-    for (queue = 1; queue <= asic->numRqeQueues; queue++)
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
     {
-      /* check if the trigger report request should contain snap shot */
-        if ((queue-1 != options->triggerInfo.queue) && 
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
-        {
-          continue;
-        }
-      if (true == sendIncrReport)
-       {
-        /* lets see if this queue needs to be included in the report at all */
-        /* if this queue needs not be reported, then we move to next queue */
-        if ((NULL == previous) &&
-            (current->rqeQ.data[queue - 1].rqeBufferCount == 0) &&
-            (current->rqeQ.data[queue - 1].rqeQueueEntries == 0))
-            continue;
-      }
+        bstjson_diff_bitmap_restrict(includeQueues, asic->numRqeQueues, options->triggerInfo.queue);
+    }
 
-        if ((previous != NULL) &&
-            (previous->rqeQ.data[queue - 1].rqeBufferCount == current->rqeQ.data[queue - 1].rqeBufferCount) &&
-            (previous->rqeQ.data[queue - 1].rqeQueueEntries == current->rqeQ.data[queue - 1].rqeQueueEntries))
-            continue;
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                &current->rqeQ.data[0],
+                                asic->numRqeQueues, BSTJSON_DIFF_STRIDE(current->rqeQ.data[0]), 2,
+                                0, -1, BSTJSON_FILTER_INDEX_QUEUE, includeQueues);
 
-             val = current->rqeQ.data[queue - 1].rqeBufferCount;
-             maxBufVal = options->bst_max_buffers_ptr->rqeQ.data[queue - 1].rqeMaxBuf;
-             bst_json_convert_data(options, asic, &val, maxBufVal);
-        /* Now that this queue needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      cpuqTemplate, queue-1,
-                                                      val,
-                                                      current->rqeQ.data[queue - 1].rqeQueueEntries
-                                                      );
+    /* write every entry in index order, without its index, when that is shorter */
+    dense = bstjson_layout_dense_choose(options, previous, includeQueues, asic->numRqeQueues, 2);
 
-    }
+    /* copying the header */
+    _JSONENCODE_REALM_OPEN(writer, BVIEW_BST_EGRESS_RQE_QUEUE, dense);
+
+    /* convert the counters to the reported units */
+    bstjson_convert_setup(options, asic, &conv);
+    _JSONENCODE_CONVERT_REALM(&conv, current->rqeQ.data[0], options->bst_max_buffers_ptr->rqeQ.data[0],
+                              rqeBufferCount, rqeMaxBuf, asic->numRqeQueues, rqeBuffer);
+
+    /* For each queue with a difference, create the report. */
+    for (entry = bstjson_diff_bitmap_next(includeQueues, asic->numRqeQueues, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includeQueues, asic->numRqeQueues, entry + 1))
+    {
+        queue = entry + 1;
+
+        val = rqeBuffer[entry];
 
-    /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+        /* Now that this queue needs to be included in the report, add the data to report :
+         * " [  queue , rqe-buffer, rqe-queue-entries ] ," */
+        JSON_WRITER_APPEND_LITERAL(writer, " [  ");
+        if (false == dense)
+        {
+            json_writer_append_int(writer, queue-1);
+            JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        }
+        json_writer_append_u64(writer, val);
+        JSON_WRITER_APPEND_LITERAL(writer, ", ");
+        json_writer_append_u64(writer, current->rqeQ.data[queue - 1].rqeQueueEntries);
+        JSON_WRITER_APPEND_LITERAL(writer, " ] ,");
+        _JSONENCODE_WRITER_CHECK(writer);
+    }
 
-    /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    /* replace the last ',' with the "] } ," for the next 'realm' */
+    _JSONENCODE_WRITER_CLOSE(writer);
+    _JSONENCODE_WRITER_CHECK(writer);
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - RQE Queue data Complete \n");
 
@@ -193,81 +201,87 @@ static BVIEW_STATUS _jsonencode_report_egress_rqeq ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress Multicast Queue.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_mcq ( char *buffer, int asicId,
+static BVIEW_STATUS _jsonencode_report_egress_mcq ( JSON_WRITER_t *writer, int asicId,
                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                    const BSTJSON_REPORT_OPTIONS_t *options,
-                                                   const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                   int bufLen,
-                                                   int *length)
+                                                   const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
-    int queue = 0;
+    int queue = 0, entry = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
-    int sendIncrReport = options->sendIncrementalReport;
+    uint64_t includeQueues[BSTJSON_DIFF_BITMAP_WORDS(BVIEW_ASIC_MAX_MC_QUEUES)];
+    BSTJSON_CONVERT_t conv;
+    bool dense = false;
+    uint64_t mcBuffer[BVIEW_ASIC_MAX_MC_QUEUES];
 
-    char *realmTemplate = " { \"realm\": \"egress-mc-queue\", \"%s\": [ ";
-    char *dataTemplate = " [  %d , \"%s\" ,  %" PRIu64 ", %" PRIu64 " ] ,";
     char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
 
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - MC Queue data \n");
 
-    /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    /* find the queues that need to be reported */
+    bstjson_diff_report_bitmap_get((previous != NULL) ? &previous->eMcQ.data[0] : NULL,
+                                   &current->eMcQ.data[0],
+                                   asic->numMulticastQueues, BSTJSON_DIFF_STRIDE(current->eMcQ.data[0]), 2,
+                                   options->sendIncrementalReport, includeQueues);
 
-    /* For each service pool, check if there is a difference, and create the report. */
-    for (queue = 1; queue <= asic->numMulticastQueues; queue++)
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
     {
-      /* check if the trigger report request should contain snap shot */
-        if ((queue-1 != options->triggerInfo.queue) && 
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
-        {
-          continue;
-        }
+        bstjson_diff_bitmap_restrict(includeQueues, asic->numMulticastQueues, options->triggerInfo.queue);
+    }
 
-      if (true == sendIncrReport)
-      {
-        /* lets see if this queue needs to be included in the report at all */
-        /* if this queue needs not be reported, then we move to next queue */
-        if ((NULL == previous) &&
-            (current->eMcQ.data[queue - 1].mcBufferCount == 0) &&
-            (current->eMcQ.data[queue - 1].mcQueueEntries == 0) )
-            continue;
-      }
-        if ((previous != NULL) &&
-            (previous->eMcQ.data[queue - 1].mcBufferCount == current->eMcQ.data[queue - 1].mcBufferCount ) &&
-            (previous->eMcQ.data[queue - 1].mcQueueEntries == current->eMcQ.data[queue - 1].mcQueueEntries))
-            continue;
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                &current->eMcQ.data[0],
+                                asic->numMulticastQueues, BSTJSON_DIFF_STRIDE(current->eMcQ.data[0]), 2,
+                                0, BSTJSON_FILTER_WORD(current->eMcQ.data[0], port),
+                                BSTJSON_FILTER_INDEX_QUEUE, includeQueues);
+
+    /* write every entry in index order, without its index, when that is shorter */
+    dense = bstjson_layout_dense_choose(options, previous, includeQueues, asic->numMulticastQueues, 3);
+
+    /* copying the header */
+    _JSONENCODE_REALM_OPEN(writer, BVIEW_BST_EGRESS_MC_QUEUE, dense);
+
+    /* convert the counters to the reported units */
+    bstjson_convert_setup(options, asic, &conv);
+    _JSONENCODE_CONVERT_REALM(&conv, current->eMcQ.data[0], options->bst_max_buffers_ptr->eMcQ.data[0],
+                              mcBufferCount, mcMaxBuf, asic->numMulticastQueues, mcBuffer);
+
+    /* For each queue with a difference, create the report. */
+    for (entry = bstjson_diff_bitmap_next(includeQueues, asic->numMulticastQueues, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includeQueues, asic->numMulticastQueues, entry + 1))
+    {
+        queue = entry + 1;
 
         /* convert the port to an external representation */
         memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
         JSON_PORT_MAP_TO_NOTATION(current->eMcQ.data[queue - 1].port, asicId, &portStr[0]);
 
-        val = current->eMcQ.data[queue - 1].mcBufferCount;
-        maxBufVal = options->bst_max_buffers_ptr->eMcQ.data[queue - 1].mcMaxBuf;
-        bst_json_convert_data(options, asic, &val, maxBufVal);
-        /* Now that this pool needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      dataTemplate, queue-1,
-                                                      &portStr[0],
-                                                      val,
-                                                      current->eMcQ.data[queue - 1].mcQueueEntries
-                                                      );
+        val = mcBuffer[entry];
 
+        /* Now that this queue needs to be included in the report, add the data to report :
+         * " [  queue , "port" ,  mc-buffer, mc-queue-entries ] ," */
+        JSON_WRITER_APPEND_LITERAL(writer, " [  ");
+        if (false == dense)
+        {
+            json_writer_append_int(writer, queue-1);
+            JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        }
+        JSON_WRITER_APPEND_LITERAL(writer, "\"");
+        json_writer_append_str(writer, &portStr[0]);
+        JSON_WRITER_APPEND_LITERAL(writer, "\" ,  ");
+        json_writer_append_u64(writer, val);
+        JSON_WRITER_APPEND_LITERAL(writer, ", ");
+        json_writer_append_u64(writer, current->eMcQ.data[queue - 1].mcQueueEntries);
+        JSON_WRITER_APPEND_LITERAL(writer, " ] ,");
+        _JSONENCODE_WRITER_CHECK(writer);
     }
 
-    /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
-
-    /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    /* replace the last ',' with the "] } ," for the next 'realm' */
+    _JSONENCODE_WRITER_CLOSE(writer);
+    _JSONENCODE_WRITER_CHECK(writer);
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - MC Queue data Complete \n");
 
@@ -279,78 +293,85 @@ static BVIEW_STATUS _jsonencode_report_egress_mcq ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress UC Queue.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_ucq ( char *buffer, int asicId,
+static BVIEW_STATUS _jsonencode_report_egress_ucq ( JSON_WRITER_t *writer, int asicId,
                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                    const BSTJSON_REPORT_OPTIONS_t *options,
-                                                   const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                   int bufLen,
-                                                   int *length)
+                                                   const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
-    int queue = 0;
+    int queue = 0, entry = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
-    int sendIncrReport = options->sendIncrementalReport;
+    uint64_t includeQueues[BSTJSON_DIFF_BITMAP_WORDS(BVIEW_ASIC_MAX_UC_QUEUES)];
+    BSTJSON_CONVERT_t conv;
+    bool dense = false;
+    uint64_t ucBuffer[BVIEW_ASIC_MAX_UC_QUEUES];
 
-    char *realmTemplate = " { \"realm\": \"egress-uc-queue\", \"%s\": [ ";
-    char *dataTemplate = " [  %d , \"%s\" , %" PRIu64 " ] ,";
     char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
 
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - UC Queue data \n");
 
-    /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    /* find the queues that need to be reported */
+    bstjson_diff_report_bitmap_get((previous != NULL) ? &previous->eUcQ.data[0] : NULL,
+                                   &current->eUcQ.data[0],
+                                   asic->numUnicastQueues, BSTJSON_DIFF_STRIDE(current->eUcQ.data[0]), 1,
+                                   options->sendIncrementalReport, includeQueues);
 
-    /* For each unicast queues, check if there is a difference, and create the report. */
-    for (queue = 1; queue <= asic->numUnicastQueues; queue++)
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
     {
-      /* check if the trigger report request should contain snap shot */
-        if ((queue-1 != options->triggerInfo.queue) && 
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
-        {
-          continue;
-        }
+        bstjson_diff_bitmap_restrict(includeQueues, asic->numUnicastQueues, options->triggerInfo.queue);
+    }
 
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                &current->eUcQ.data[0],
+                                asic->numUnicastQueues, BSTJSON_DIFF_STRIDE(current->eUcQ.data[0]), 1,
+                                0, BSTJSON_FILTER_WORD(current->eUcQ.data[0], port),
+                                BSTJSON_FILTER_INDEX_QUEUE, includeQueues);
 
-      if (true == sendIncrReport)
-      {
-        /* lets see if this queue needs to be included in the report at all */
-        /* if this queue needs not be reported, then we move to next queue */
-        if ((NULL == previous) &&
-            (current->eUcQ.data[queue - 1].ucBufferCount == 0))
-            continue;
-      }
-        if ((previous != NULL) &&
-            (previous->eUcQ.data[queue - 1].ucBufferCount == current->eUcQ.data[queue - 1].ucBufferCount))
-            continue;
+    /* write every entry in index order, without its index, when that is shorter */
+    dense = bstjson_layout_dense_choose(options, previous, includeQueues, asic->numUnicastQueues, 2);
+
+    /* copying the header */
+    _JSONENCODE_REALM_OPEN(writer, BVIEW_BST_EGRESS_UC_QUEUE, dense);
+
+    /* convert the counters to the reported units */
+    bstjson_convert_setup(options, asic, &conv);
+    _JSONENCODE_CONVERT_REALM(&conv, current->eUcQ.data[0], options->bst_max_buffers_ptr->eUcQ.data[0],
+                              ucBufferCount, ucMaxBuf, asic->numUnicastQueues, ucBuffer);
+
+    /* For each unicast queue with a difference, create the report. */
+    for (entry = bstjson_diff_bitmap_next(includeQueues, asic->numUnicastQueues, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includeQueues, asic->numUnicastQueues, entry + 1))
+    {
+        queue = entry + 1;
 
         /* convert the port to an external representation */
         memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
         JSON_PORT_MAP_TO_NOTATION(current->eUcQ.data[queue - 1].port, asicId, &portStr[0]);
 
-         val = current->eUcQ.data[queue - 1].ucBufferCount;
-         maxBufVal = options->bst_max_buffers_ptr->eUcQ.data[queue - 1].ucMaxBuf;
-         bst_json_convert_data(options, asic, &val, maxBufVal);
-        /* Now that this ucq needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      dataTemplate, queue-1,
-                                                      &portStr[0],
-                                                      val 
-                                                      );
-    }
+        val = ucBuffer[entry];
 
-    /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+        /* Now that this ucq needs to be included in the report, add the data to report :
+         * " [  queue , "port" , uc-buffer ] ," */
+        JSON_WRITER_APPEND_LITERAL(writer, " [  ");
+        if (false == dense)
+        {
+            json_writer_append_int(writer, queue-1);
+            JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        }
+        JSON_WRITER_APPEND_LITERAL(writer, "\"");
+        json_writer_append_str(writer, &portStr[0]);
+        JSON_WRITER_APPEND_LITERAL(writer, "\" , ");
+        json_writer_append_u64(writer, val);
+        JSON_WRITER_APPEND_LITERAL(writer, " ] ,");
+        _JSONENCODE_WRITER_CHECK(writer);
+    }
 
-    /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    /* replace the last ',' with the "] } ," for the next 'realm' */
+    _JSONENCODE_WRITER_CLOSE(writer);
+    _JSONENCODE_WRITER_CHECK(writer);
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - UC Queue data Complete \n");
 
@@ -362,71 +383,75 @@ static BVIEW_STATUS _jsonencode_report_egress_ucq ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress UC Queue Group.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_ucqg ( char *buffer, int asicId,
+static BVIEW_STATUS _jsonencode_report_egress_ucqg ( JSON_WRITER_t *writer, int asicId,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                     const BSTJSON_REPORT_OPTIONS_t *options,
-                                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                    int bufLen,
-                                                    int *length)
+                                                    const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
-    int qg = 0;
+    int qg = 0, entry = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
-    int sendIncrReport = options->sendIncrementalReport;
-
-    char *realmTemplate = " { \"realm\": \"egress-uc-queue-group\", \"%s\": [ ";
-    char *dataTemplate = " [  %d , %" PRIu64 " ] ,";
+    uint64_t includeGroups[BSTJSON_DIFF_BITMAP_WORDS(BVIEW_ASIC_MAX_UC_QUEUE_GROUPS)];
+    BSTJSON_CONVERT_t conv;
+    bool dense = false;
+    uint64_t ucBuffer[BVIEW_ASIC_MAX_UC_QUEUE_GROUPS];
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - UC Queue Group data \n");
 
-    /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    /* find the queue groups that need to be reported */
+    bstjson_diff_report_bitmap_get((previous != NULL) ? &previous->eUcQg.data[0] : NULL,
+                                   &current->eUcQg.data[0],
+                                   asic->numUnicastQueueGroups, BSTJSON_DIFF_STRIDE(current->eUcQg.data[0]), 1,
+                                   options->sendIncrementalReport, includeGroups);
 
-    /* For each unicast queue groups, check if there is a difference, and create the report. */
-    for (qg = 1; qg <= asic->numUnicastQueueGroups; qg++)
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
     {
-      /* check if the trigger report request should contain snap shot */
-        if ((qg-1 != options->triggerInfo.queue) && 
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
-        {
-          continue;
-        }
+        bstjson_diff_bitmap_restrict(includeGroups, asic->numUnicastQueueGroups, options->triggerInfo.queue);
+    }
 
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                &current->eUcQg.data[0],
+                                asic->numUnicastQueueGroups, BSTJSON_DIFF_STRIDE(current->eUcQg.data[0]), 1,
+                                0, -1, BSTJSON_FILTER_INDEX_NONE, includeGroups);
 
-      if (true == sendIncrReport)
-      {
-        /* lets see if this queue needs to be included in the report at all */
-        /* if this queue needs not be reported, then we move to next queue */
-        if ((NULL == previous) &&
-            (current->eUcQg.data[qg - 1].ucBufferCount == 0))
-            continue;
-     }
-        if ((previous != NULL) &&
-            (previous->eUcQg.data[qg - 1].ucBufferCount == current->eUcQg.data[qg - 1].ucBufferCount))
-            continue;
+    /* write every entry in index order, without its index, when that is shorter */
+    dense = bstjson_layout_dense_choose(options, previous, includeGroups, asic->numUnicastQueueGroups, 1);
 
-              val = current->eUcQg.data[qg - 1].ucBufferCount;
-              maxBufVal = options->bst_max_buffers_ptr->eUcQg.data[qg - 1].ucMaxBuf;
-              bst_json_convert_data(options, asic, &val, maxBufVal);
-        /* Now that this ucqg needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      dataTemplate, qg-1,
-                                                      val 
-                                                      );
-    }
+    /* copying the header */
+    _JSONENCODE_REALM_OPEN(writer, BVIEW_BST_EGRESS_UC_QUEUEGROUPS, dense);
+
+    /* convert the counters to the reported units */
+    bstjson_convert_setup(options, asic, &conv);
+    _JSONENCODE_CONVERT_REALM(&conv, current->eUcQg.data[0], options->bst_max_buffers_ptr->eUcQg.data[0],
+                              ucBufferCount, ucMaxBuf, asic->numUnicastQueueGroups, ucBuffer);
+
+    /* For each unicast queue group with a difference, create the report. */
+    for (entry = bstjson_diff_bitmap_next(includeGroups, asic->numUnicastQueueGroups, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includeGroups, asic->numUnicastQueueGroups, entry + 1))
+    {
+        qg = entry + 1;
+
+        val = ucBuffer[entry];
 
-    /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+        /* Now that this ucqg needs to be included in the report, add the data to report :
+         * " [  queue-group , uc-buffer ] ," */
+        JSON_WRITER_APPEND_LITERAL(writer, " [  ");
+        if (false == dense)
+        {
+            json_writer_append_int(writer, qg-1);
+            JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        }
+        json_writer_append_u64(writer, val);
+        JSON_WRITER_APPEND_LITERAL(writer, " ] ,");
+        _JSONENCODE_WRITER_CHECK(writer);
+    }
 
-    /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    /* replace the last ',' with the "] } ," for the next 'realm' */
+    _JSONENCODE_WRITER_CLOSE(writer);
+    _JSONENCODE_WRITER_CHECK(writer);
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - UC Queue Group data Complete \n");
 
@@ -438,80 +463,83 @@ static BVIEW_STATUS _jsonencode_report_egress_ucqg ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress Service Pools .
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_sp ( char *buffer, int asicId,
+static BVIEW_STATUS _jsonencode_report_egress_sp ( JSON_WRITER_t *writer, int asicId,
                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                   const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                   const BSTJSON_REPORT_OPTIONS_t *options,
-                                                  const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                  int bufLen,
-                                                  int *length)
+                                                  const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
-    int pool = 0;
+    int pool = 0, entry = 0;
     uint64_t val1 = 0, val2 = 0;
-    uint64_t maxBufVal = 0;
-    int sendIncrReport = options->sendIncrementalReport;
-
-    char *realmTemplate = " { \"realm\": \"egress-service-pool\", \"%s\": [ ";
-    char *dataTemplate = " [  %d , %" PRIu64 " , %" PRIu64 ", %" PRIu64 " ] ,";
+    uint64_t includePools[BSTJSON_DIFF_BITMAP_WORDS(BVIEW_ASIC_MAX_SERVICE_POOLS)];
+    BSTJSON_CONVERT_t conv;
+    bool dense = false;
+    uint64_t umShare[BVIEW_ASIC_MAX_SERVICE_POOLS];
+    uint64_t mcShare[BVIEW_ASIC_MAX_SERVICE_POOLS];
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - Service Pool data \n");
 
-    /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, realmTemplate, "data");
+    /* find the service pools that need to be reported */
+    bstjson_diff_report_bitmap_get((previous != NULL) ? &previous->eSp.data[0] : NULL,
+                                   &current->eSp.data[0],
+                                   asic->numServicePools, BSTJSON_DIFF_STRIDE(current->eSp.data[0]), 3,
+                                   options->sendIncrementalReport, includePools);
 
-    /* For each service pool, check if there is a difference, and create the report. */
-    for (pool = 1; pool <= asic->numServicePools; pool++)
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
     {
-      if ((pool-1 != options->triggerInfo.queue) && 
-	  (false == options->sendSnapShotOnTrigger) && 
-	  (true == options->reportTrigger))
-      {
-	continue;
-      }
-
-
-      if (true == sendIncrReport)
-      {
-        /* lets see if this sp needs to be included in the report at all */
-        /* if this sp needs not be reported, then we move to next sp */
-        if ((NULL == previous) &&
-            (current->eSp.data[pool - 1].umShareBufferCount == 0) &&
-            (current->eSp.data[pool - 1].mcShareBufferCount == 0)  &&
-            (current->eSp.data[pool - 1].mcShareQueueEntries == 0) )
-            continue;
-      }
-
-        if ((previous != NULL) &&
-            (previous->eSp.data[pool - 1].umShareBufferCount == current->eSp.data[pool - 1].umShareBufferCount ) &&
-            (previous->eSp.data[pool - 1].mcShareBufferCount == current->eSp.data[pool - 1].mcShareBufferCount ) &&
-            (previous->eSp.data[pool - 1].mcShareQueueEntries == current->eSp.data[pool - 1].mcShareQueueEntries ))
-            continue;
+        bstjson_diff_bitmap_restrict(includePools, asic->numServicePools, options->triggerInfo.queue);
+    }
 
-             val1 = current->eSp.data[pool - 1].umShareBufferCount;
-             maxBufVal = options->bst_max_buffers_ptr->eSp.data[pool - 1].umShareMaxBuf;
-             bst_json_convert_data(options, asic, &val1, maxBufVal);
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                &current->eSp.data[0],
+                                asic->numServicePools, BSTJSON_DIFF_STRIDE(current->eSp.data[0]), 3,
+                                0, -1, BSTJSON_FILTER_INDEX_SERVICE_POOL, includePools);
+
+    /* write every entry in index order, without its index, when that is shorter */
+    dense = bstjson_layout_dense_choose(options, previous, includePools, asic->numServicePools, 3);
+
+    /* copying the header */
+    _JSONENCODE_REALM_OPEN(writer, BVIEW_BST_EGRESS_SP, dense);
+
+    /* convert the counters to the reported units */
+    bstjson_convert_setup(options, asic, &conv);
+    _JSONENCODE_CONVERT_REALM(&conv, current->eSp.data[0], options->bst_max_buffers_ptr->eSp.data[0],
+                              umShareBufferCount, umShareMaxBuf, asic->numServicePools, umShare);
+    _JSONENCODE_CONVERT_REALM(&conv, current->eSp.data[0], options->bst_max_buffers_ptr->eSp.data[0],
+                              mcShareBufferCount, mcShareMaxBuf, asic->numServicePools, mcShare);
+
+    /* For each service pool with a difference, create the report. */
+    for (entry = bstjson_diff_bitmap_next(includePools, asic->numServicePools, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includePools, asic->numServicePools, entry + 1))
+    {
+        pool = entry + 1;
 
-             val2 = current->eSp.data[pool - 1].mcShareBufferCount;
-             maxBufVal = options->bst_max_buffers_ptr->eSp.data[pool - 1].mcShareMaxBuf;
-             bst_json_convert_data(options, asic, &val2, maxBufVal);
+        val1 = umShare[entry];
+        val2 = mcShare[entry];
 
-        /* Now that this pool needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      dataTemplate, pool-1, val1,val2,
-                                                      current->eSp.data[pool - 1].mcShareQueueEntries
-                                                      );
+        /* Now that this pool needs to be included in the report, add the data to report :
+         * " [  sp , um-share , mc-share, mc-share-queue-entries ] ," */
+        JSON_WRITER_APPEND_LITERAL(writer, " [  ");
+        if (false == dense)
+        {
+            json_writer_append_int(writer, pool-1);
+            JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        }
+        json_writer_append_u64(writer, val1);
+        JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        json_writer_append_u64(writer, val2);
+        JSON_WRITER_APPEND_LITERAL(writer, ", ");
+        json_writer_append_u64(writer, current->eSp.data[pool - 1].mcShareQueueEntries);
+        JSON_WRITER_APPEND_LITERAL(writer, " ] ,");
+        _JSONENCODE_WRITER_CHECK(writer);
     }
 
-    /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
-
-    /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    /* replace the last ',' with the "] } ," for the next 'realm' */
+    _JSONENCODE_WRITER_CLOSE(writer);
+    _JSONENCODE_WRITER_CHECK(writer);
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - Service Pool data Complete \n");
 
@@ -523,160 +551,120 @@ static BVIEW_STATUS _jsonencode_report_egress_sp ( char *buffer, int asicId,
  *         "get-bst-report" REST API - egress-port-service-pool.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_egress_epsp ( char *buffer, int asicId,
+static BVIEW_STATUS _jsonencode_report_egress_epsp ( JSON_WRITER_t *writer, int asicId,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                     const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                     const BSTJSON_REPORT_OPTIONS_t *options,
-                                                    const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                    int bufLen,
-                                                    int *length)
+                                                    const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
-    bool includePort = false;
     uint64_t val1 = 0, val2 = 0, val3 = 0;
-    uint64_t maxBufVal = 0;
-    int sendIncrReport = options->sendIncrementalReport;
 
-    int includeServicePool[BVIEW_ASIC_MAX_SERVICE_POOLS] = { 0 };
-    int port = 0, pool = 0;
+    uint64_t includeEntries[BSTJSON_DIFF_MAX_BITMAP_WORDS];
+    BSTJSON_CONVERT_t conv;
+    uint64_t ucShare[BVIEW_ASIC_MAX_PORTS * BVIEW_ASIC_MAX_SERVICE_POOLS];
+    uint64_t umShare[BVIEW_ASIC_MAX_PORTS * BVIEW_ASIC_MAX_SERVICE_POOLS];
+    uint64_t mcShare[BVIEW_ASIC_MAX_PORTS * BVIEW_ASIC_MAX_SERVICE_POOLS];
+    int numEntries = asic->numPorts * BVIEW_ASIC_MAX_SERVICE_POOLS;
+    int entry = 0, triggerEntry = -1;
+    int port = 0, pool = 0, lastPort = 0;
 
-    char *epspTemplate = " { \"realm\": \"egress-port-service-pool\", \"%s\": [ ";
-    char *epspPortTemplate = " { \"port\": \"%s\", \"data\": [ ";
-    char *epspServicePoolTemplate = " [  %d , %" PRIu64 " , %" PRIu64 " , %" PRIu64 " ] ,";
     char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
 
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - EPSP data \n");
 
-    /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, epspTemplate, "data");
+    /* copying the header */
+    _JSONENCODE_REALM_OPEN(writer, BVIEW_BST_EGRESS_PORT_SP, false);
 
-    /* For each port, and for each service pool in that port, 
-     *  1. attempt to see if this port needs to be reported.
-     *  2. create the report.
-     */
-    for (port = 1; port <= asic->numPorts; port++)
+    /* find the (port, service pool) pairs that need to be reported,
+     * entry 'n' is port (n / MAX_SERVICE_POOLS) + 1 */
+    bstjson_diff_report_bitmap_get((previous != NULL) ? &previous->ePortSp.data[0][0] : NULL,
+                                   &current->ePortSp.data[0][0],
+                                   numEntries, BSTJSON_DIFF_STRIDE(current->ePortSp.data[0][0]), 4,
+                                   options->sendIncrementalReport, includeEntries);
+
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
     {
-      /* check if the trigger report request should contain snap shot */
-        if ((port != options->triggerInfo.port) &&
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
-         {
-           continue;
-         }
-        includePort = false;
-        memset (&includeServicePool[0], 0, sizeof (includeServicePool));
-
-        /* lets see if this port needs to be included in the report at all */
-        for (pool = 1; pool <= asic->numServicePools; pool++)
+        if ((options->triggerInfo.queue >= 0) &&
+            (options->triggerInfo.queue < asic->numServicePools))
         {
-      /* check if the trigger report request should contain snap shot */
-        if ((pool-1 != options->triggerInfo.queue) && 
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
-         {
-           continue;
-         }
-            /* By default, we plan to include the pool */
-            includeServicePool[pool - 1] = 1;
-
-      if (true == sendIncrReport)
-      {
-            /* If there is no traffic reported for this priority group, ignore it */
-               if ((NULL == previous) &&
-                (current->ePortSp.data[port - 1][pool - 1].umShareBufferCount == 0) &&
-                (current->ePortSp.data[port - 1][pool - 1].ucShareBufferCount == 0) &&
-                (current->ePortSp.data[port - 1][pool - 1].mcShareBufferCount == 0) &&
-                (current->ePortSp.data[port - 1][pool - 1].mcShareQueueEntries == 0))
-            {
-                includeServicePool[pool - 1] = 0;
-                continue;
-            }
-      }
-            /* If this is snapshot report, include the port in the data  */
-            if (previous == NULL)
-            {
-                includePort = true;
-                continue;
-            }
-
-            /* if there is traffic reported since the last snapshot, we can't ignore this pool */
-            if ( (previous->ePortSp.data[port - 1][pool - 1].umShareBufferCount
-                  != current->ePortSp.data[port - 1][pool - 1].umShareBufferCount) ||
-                (previous->ePortSp.data[port - 1][pool - 1].ucShareBufferCount
-                 != current->ePortSp.data[port - 1][pool - 1].ucShareBufferCount) ||
-                (previous->ePortSp.data[port - 1][pool - 1].mcShareBufferCount
-                 != current->ePortSp.data[port - 1][pool - 1].mcShareBufferCount) ||
-                (previous->ePortSp.data[port - 1][pool - 1].mcShareQueueEntries
-                 != current->ePortSp.data[port - 1][pool - 1].mcShareQueueEntries) )
-            {
-                includePort = true;
-                continue;
-            }
-
-            /* since there is no reason to include the pool, we can ignore it*/
-            includeServicePool[pool - 1] = 0;
+            triggerEntry = ((options->triggerInfo.port - 1) * BVIEW_ASIC_MAX_SERVICE_POOLS) +
+                            options->triggerInfo.queue;
         }
+        bstjson_diff_bitmap_restrict(includeEntries, numEntries, triggerEntry);
+    }
 
-        /* if this port needs not be reported, then we move to next port */
-        if (includePort == false)
-        {
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                &current->ePortSp.data[0][0],
+                                numEntries, BSTJSON_DIFF_STRIDE(current->ePortSp.data[0][0]), 4,
+                                BVIEW_ASIC_MAX_SERVICE_POOLS, -1, BSTJSON_FILTER_INDEX_SERVICE_POOL, includeEntries);
+
+    /* convert the counters to the reported units */
+    bstjson_convert_setup(options, asic, &conv);
+    _JSONENCODE_CONVERT_REALM(&conv, current->ePortSp.data[0][0], options->bst_max_buffers_ptr->ePortSp.data[0][0],
+                              ucShareBufferCount, ucShareMaxBuf, numEntries, ucShare);
+    _JSONENCODE_CONVERT_REALM(&conv, current->ePortSp.data[0][0], options->bst_max_buffers_ptr->ePortSp.data[0][0],
+                              umShareBufferCount, umShareMaxBuf, numEntries, umShare);
+    _JSONENCODE_CONVERT_REALM(&conv, current->ePortSp.data[0][0], options->bst_max_buffers_ptr->ePortSp.data[0][0],
+                              mcShareBufferCount, mcShareMaxBuf, numEntries, mcShare);
+
+    /* walk the pairs to be reported, ports come in ascending order */
+    for (entry = bstjson_diff_bitmap_next(includeEntries, numEntries, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includeEntries, numEntries, entry + 1))
+    {
+        port = (entry / BVIEW_ASIC_MAX_SERVICE_POOLS) + 1;
+        pool = (entry % BVIEW_ASIC_MAX_SERVICE_POOLS) + 1;
+
+        if (pool > asic->numServicePools)
             continue;
-        }
 
-        /* convert the port to an external representation */
-        memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
-        JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
+        if (port != lastPort)
+        {
+            if (lastPort != 0)
+            {
+                /* replace the last ',' with the "] } ," for the next port */
+                _JSONENCODE_WRITER_CLOSE(writer);
+            }
 
-        /* Now that this port needs to be included in the report, copy the header */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, epspPortTemplate, &portStr[0]);
+            /* convert the port to an external representation */
+            memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
+            JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
 
-        /* for each priority-group, prepare the data */
-        for (pool = 1; pool <= asic->numServicePools; pool++)
-        {
-            /* we ignore if there is no data to be reported */
-            if (includeServicePool[pool - 1] == 0)
-                continue;
-
-            val1 = current->ePortSp.data[port - 1][pool - 1].ucShareBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->ePortSp.data[port - 1][pool - 1].ucShareMaxBuf;
-            bst_json_convert_data(options, asic, &val1, maxBufVal);
-
-            val2 = current->ePortSp.data[port - 1][pool - 1].umShareBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->ePortSp.data[port - 1][pool - 1].umShareMaxBuf;
-            bst_json_convert_data(options, asic, &val2, maxBufVal);
-
-            val3 = current->ePortSp.data[port - 1][pool - 1].mcShareBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->ePortSp.data[port - 1][pool - 1].mcShareMaxBuf;
-            bst_json_convert_data(options, asic, &val3, maxBufVal);
-
-            /* add the data to the report */
-            _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                          epspServicePoolTemplate, pool-1,
-                                                          val1, val2, val3,
-                                                          current->ePortSp.data[port - 1][pool - 1].mcShareQueueEntries
-                                                          );
+            /* Now that this port needs to be included in the report, copy the header */
+            JSON_WRITER_APPEND_LITERAL(writer, " { \"port\": \"");
+            json_writer_append_str(writer, &portStr[0]);
+            JSON_WRITER_APPEND_LITERAL(writer, "\", \"data\": [ ");
+            lastPort = port;
         }
 
-        /* adjust the buffer to remove the last ',' */
-        buffer = buffer - 1;
-        remLength += 1;
-        *length -= 1;
-
-        /* add the "] } ," for the next port */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      "] } ," );
+        val1 = ucShare[entry];
+        val2 = umShare[entry];
+        val3 = mcShare[entry];
+
+        /* add the data to the report : " [  sp , uc-share , um-share , mc-share ] ," */
+        JSON_WRITER_APPEND_LITERAL(writer, " [  ");
+        json_writer_append_int(writer, pool-1);
+        JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        json_writer_append_u64(writer, val1);
+        JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        json_writer_append_u64(writer, val2);
+        JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        json_writer_append_u64(writer, val3);
+        JSON_WRITER_APPEND_LITERAL(writer, " ] ,");
+        _JSONENCODE_WRITER_CHECK(writer);
     }
 
-    /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    if (lastPort != 0)
+    {
+        /* replace the last ',' with the "] } ," for the next port */
+        _JSONENCODE_WRITER_CLOSE(writer);
+    }
 
-    /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    /* replace the last ',' with the "] } ," for the next 'realm' */
+    _JSONENCODE_WRITER_CLOSE(writer);
+    _JSONENCODE_WRITER_CHECK(writer);
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS - EPSP data Complete \n");
 
@@ -685,136 +673,89 @@ static BVIEW_STATUS _jsonencode_report_egress_epsp ( char *buffer, int asicId,
 }
 
 /******************************************************************
- * @brief  Creates a JSON buffer using the supplied data for the 
- *         "get-bst-report" REST API - egress part.
+ * @brief  Lists the egress realms asked for, in report order.
  *
+ * @param[in]   options    Report options
+ * @param[out]  encoders   Encoders of the realms, BSTJSON_EGRESS_REALMS
+ *                         entries at most
+ * @param[out]  lengths    Room each realm takes when encoded on its own,
+ *                         may be NULL
+ *
+ * @retval   number of realms
  *********************************************************************/
-BVIEW_STATUS _jsonencode_report_egress ( char *buffer, int asicId,
-                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
-                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
-                                        const BSTJSON_REPORT_OPTIONS_t *options,
-                                        const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                        int bufLen,
-                                        int *length)
+int _jsonencode_report_egress_realms_get(const BSTJSON_REPORT_OPTIONS_t *options,
+                                         BSTJSON_REALM_ENCODER_t *encoders,
+                                         int *lengths)
 {
-    BVIEW_STATUS status;
-    int tempLength = 0;
-
-    *length = 0;
-
-    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS data \n");
-
-    /* If CPU realm is asked for, lets encode the corresponding data */
+    int count = 0;
 
     if (options->includeEgressCpuQueue)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_cpuq(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        _JSONENCODE_REALM_ADD(encoders, lengths, count, _jsonencode_report_egress_cpuq, cpqQ, cpqQ.data[0]);
     }
 
-    /* If Egress Multicast queue realm is asked for, lets encode the corresponding data */
     if (options->includeEgressMcQueue)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_mcq(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        _JSONENCODE_REALM_ADD(encoders, lengths, count, _jsonencode_report_egress_mcq, eMcQ, eMcQ.data[0]);
     }
 
-    /* If Egress Port - Service Pool realm is asked for, lets encode the corresponding data */
-
     if (options->includeEgressPortServicePool)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_epsp(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        _JSONENCODE_REALM_ADD(encoders, lengths, count, _jsonencode_report_egress_epsp, ePortSp, ePortSp.data[0][0]);
     }
 
-    /* If Egress RQE queue realm is asked for, lets encode the corresponding data */
     if (options->includeEgressRqeQueue)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_rqeq(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        _JSONENCODE_REALM_ADD(encoders, lengths, count, _jsonencode_report_egress_rqeq, rqeQ, rqeQ.data[0]);
     }
 
-    /* If Egress Service Pool realm is asked for, lets encode the corresponding data */
     if (options->includeEgressServicePool)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_sp(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        _JSONENCODE_REALM_ADD(encoders, lengths, count, _jsonencode_report_egress_sp, eSp, eSp.data[0]);
     }
 
-    /* If Egress Unicast queue realm is asked for, lets encode the corresponding data */
     if (options->includeEgressUcQueue)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_ucq(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+        _JSONENCODE_REALM_ADD(encoders, lengths, count, _jsonencode_report_egress_ucq, eUcQ, eUcQ.data[0]);
     }
 
-    /* If Egress Unicast queue group realm is asked for, lets encode the corresponding data */
     if (options->includeEgressUcQueueGroup)
     {
-        tempLength = 0;
-        status = _jsonencode_report_egress_ucqg(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+        _JSONENCODE_REALM_ADD(encoders, lengths, count, _jsonencode_report_egress_ucqg, eUcQg, eUcQg.data[0]);
+    }
 
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
+    return count;
+}
+
+/******************************************************************
+ * @brief  Creates a JSON buffer using the supplied data for the 
+ *         "get-bst-report" REST API - egress part.
+ *
+ *********************************************************************/
+BVIEW_STATUS _jsonencode_report_egress ( JSON_WRITER_t *writer, int asicId,
+                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                        const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                        const BSTJSON_REPORT_OPTIONS_t *options,
+                                        const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    BVIEW_STATUS status;
+    BSTJSON_REALM_ENCODER_t encoders[BSTJSON_EGRESS_REALMS];
+    int count, i;
 
+    _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS data \n");
+
+    count = _jsonencode_report_egress_realms_get(options, &encoders[0], NULL);
+
+    for (i = 0; i < count; i++)
+    {
+        status = encoders[i](writer, asicId, previous, current, options, asic);
+        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
     }
 
-    if (tempLength != 0)
+    /* drop the trailing ',' of the last realm */
+    if (count > 0)
     {
-        *(length) -= 1;
+        json_writer_backup(writer, 1);
     }
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding EGRESS data complete \n");
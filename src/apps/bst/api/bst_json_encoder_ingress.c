@@ -29,161 +29,122 @@
 
 #include "bst_json_memory.h"
 #include "bst_json_encoder.h"
+#include "bst_json_diff.h"
+#include "bst_json_filter.h"
 
 /******************************************************************
  * @brief  Creates a JSON buffer using the supplied data for the 
  *         "get-bst-report" REST API - ingress-port-port-group.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_ingress_ippg ( char *buffer, int asicId,
+static BVIEW_STATUS _jsonencode_report_ingress_ippg ( JSON_WRITER_t *writer, int asicId,
                                                      const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                      const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                      const BSTJSON_REPORT_OPTIONS_t *options,
-                                                     const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                     int bufLen,
-                                                     int *length)
+                                                     const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
-    bool includePort = false;
     uint64_t val1 = 0;
     uint64_t val2 = 0;
-    uint64_t maxBufVal = 0;
-    int sendIncrReport = options->sendIncrementalReport;
 
-
-    int includePriorityGroups[BVIEW_ASIC_MAX_PRIORITY_GROUPS] = { 0 };
-    int port = 0, priGroup = 0;
+    uint64_t includeEntries[BSTJSON_DIFF_MAX_BITMAP_WORDS];
+    BSTJSON_CONVERT_t conv;
+    uint64_t umShare[BVIEW_ASIC_MAX_PORTS * BVIEW_ASIC_MAX_PRIORITY_GROUPS];
+    uint64_t umHeadroom[BVIEW_ASIC_MAX_PORTS * BVIEW_ASIC_MAX_PRIORITY_GROUPS];
+    int numEntries = asic->numPorts * BVIEW_ASIC_MAX_PRIORITY_GROUPS;
+    int entry = 0, triggerEntry = -1;
+    int port = 0, priGroup = 0, lastPort = 0;
     char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
 
-    char *ippgTemplate = " { \"realm\": \"ingress-port-priority-group\", \"%s\": [ ";
-    char *ippgPortTemplate = " { \"port\": \"%s\", \"data\": [ ";
-    char *ippgPortGroupTemplate = " [  %d , %" PRIu64 " , %" PRIu64 " ] ,";
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - IPPG data \n");
 
-    /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, ippgTemplate, "data");
+    /* copying the header */
+    _JSONENCODE_REALM_OPEN(writer, BVIEW_BST_INGRESS_PORT_PG, false);
 
-    /* For each port, and for each priority group in that port, 
-     *  1. attempt to see if this port needs to be reported.
-     *  2. create the report.
-     */
-    for (port = 1; port <= asic->numPorts; port++)
+    /* find the (port, priority group) pairs that need to be reported,
+     * entry 'n' is port (n / MAX_PRIORITY_GROUPS) + 1 */
+    bstjson_diff_report_bitmap_get((previous != NULL) ? &previous->iPortPg.data[0][0] : NULL,
+                                   &current->iPortPg.data[0][0],
+                                   numEntries, BSTJSON_DIFF_STRIDE(current->iPortPg.data[0][0]), 2,
+                                   options->sendIncrementalReport, includeEntries);
+
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
     {
-      /* check if the trigger report request should contain snap shot */
-        if ((port != options->triggerInfo.port) &&
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
+        if ((options->triggerInfo.queue >= 0) &&
+            (options->triggerInfo.queue < asic->numPriorityGroups))
         {
-          continue;
+            triggerEntry = ((options->triggerInfo.port - 1) * BVIEW_ASIC_MAX_PRIORITY_GROUPS) +
+                            options->triggerInfo.queue;
         }
-        includePort = false;
-        memset (&includePriorityGroups[0], 0, sizeof (includePriorityGroups));
-
-        /* lets see if this port needs to be included in the report at all */
-        for (priGroup = 1; priGroup <= asic->numPriorityGroups; priGroup++)
-        {
-      /* check if the trigger report request should contain snap shot */
-           if ((priGroup-1 != options->triggerInfo.queue) && 
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
-           {
-             continue;
-           }
-            /* By default, we plan to include the pri-group */
-            includePriorityGroups[priGroup - 1] = 1;
-   
-            if (true == sendIncrReport)
-            {
-            /* If there is no traffic reported for this priority group, ignore it */
-            if ((previous == NULL) && 
-                (current->iPortPg.data[port - 1][priGroup - 1].umShareBufferCount == 0) &&
-                (current->iPortPg.data[port - 1][priGroup - 1].umHeadroomBufferCount == 0) )
-            {
-                includePriorityGroups[priGroup - 1] = 0;
-                continue;
-            }
-           }
-
-            /* If this is snapshot report, include the port in the data  */
-            if (previous == NULL)
-            {
-                includePort = true;
-                continue;
-            }
-
-            /* if there is traffic reported since the last snapshot, we can't ignore this priority group */
-            if (previous->iPortPg.data[port - 1][priGroup - 1].umShareBufferCount
-                != current->iPortPg.data[port - 1][priGroup - 1].umShareBufferCount)
-            {
-                includePort = true;
-                continue;
-            }
-
-            if (previous->iPortPg.data[port - 1][priGroup - 1].umHeadroomBufferCount
-                != current->iPortPg.data[port - 1][priGroup - 1].umHeadroomBufferCount)
-            {
-                includePort = true;
-                continue;
-            }
+        bstjson_diff_bitmap_restrict(includeEntries, numEntries, triggerEntry);
+    }
 
-            /* since there is no reason to include the group, we can ignore it*/
-            includePriorityGroups[priGroup - 1] = 0;
-        }
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                &current->iPortPg.data[0][0],
+                                numEntries, BSTJSON_DIFF_STRIDE(current->iPortPg.data[0][0]), 2,
+                                BVIEW_ASIC_MAX_PRIORITY_GROUPS, -1, BSTJSON_FILTER_INDEX_NONE, includeEntries);
+
+    /* convert the counters to the reported units */
+    bstjson_convert_setup(options, asic, &conv);
+    _JSONENCODE_CONVERT_REALM(&conv, current->iPortPg.data[0][0], options->bst_max_buffers_ptr->iPortPg.data[0][0],
+                              umShareBufferCount, umShareMaxBuf, numEntries, umShare);
+    _JSONENCODE_CONVERT_REALM(&conv, current->iPortPg.data[0][0], options->bst_max_buffers_ptr->iPortPg.data[0][0],
+                              umHeadroomBufferCount, umHeadroomMaxBuf, numEntries, umHeadroom);
+
+    /* walk the pairs to be reported, ports come in ascending order */
+    for (entry = bstjson_diff_bitmap_next(includeEntries, numEntries, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includeEntries, numEntries, entry + 1))
+    {
+        port = (entry / BVIEW_ASIC_MAX_PRIORITY_GROUPS) + 1;
+        priGroup = (entry % BVIEW_ASIC_MAX_PRIORITY_GROUPS) + 1;
 
-        /* if this port needs not be reported, then we move to next port */
-        if (includePort == false)
-        {
+        if (priGroup > asic->numPriorityGroups)
             continue;
-        }
-
-          /* convert the port to an external representation */
-          memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
-          JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
 
-          /* Now that this port needs to be included in the report, copy the header */
-          _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, ippgPortTemplate, &portStr[0]);
-
-        /* for each priority-group, prepare the data */
-        for (priGroup = 1; priGroup <= asic->numPriorityGroups; priGroup++)
+        if (port != lastPort)
         {
-            /* we ignore if there is no data to be reported */
-            if (includePriorityGroups[priGroup - 1] == 0)
-                continue;
-
-            val1 = current->iPortPg.data[port - 1][priGroup - 1].umShareBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->iPortPg.data[port - 1][priGroup - 1].umShareMaxBuf;
-            bst_json_convert_data(options, asic, &val1, maxBufVal);
-
-            val2 = current->iPortPg.data[port - 1][priGroup - 1].umHeadroomBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->iPortPg.data[port - 1][priGroup - 1].umHeadroomMaxBuf;
-            bst_json_convert_data(options, asic, &val2, maxBufVal);
+            if (lastPort != 0)
+            {
+                /* replace the last ',' with the "] } ," for the next port */
+                _JSONENCODE_WRITER_CLOSE(writer);
+            }
 
+            /* convert the port to an external representation */
+            memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
+            JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
 
-            /* add the data to the report */
-            _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                          ippgPortGroupTemplate, priGroup-1, val1, val2);
+            /* Now that this port needs to be included in the report, copy the header */
+            JSON_WRITER_APPEND_LITERAL(writer, " { \"port\": \"");
+            json_writer_append_str(writer, &portStr[0]);
+            JSON_WRITER_APPEND_LITERAL(writer, "\", \"data\": [ ");
+            lastPort = port;
         }
 
-          /* adjust the buffer to remove the last ',' */
-          buffer = buffer - 1;
-          remLength += 1;
-          *length -= 1;
-
-        /* add the "] } ," for the next port */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      "] } ," );
+        val1 = umShare[entry];
+        val2 = umHeadroom[entry];
+
+        /* add the data to the report : " [  pg , um-share , um-headroom ] ," */
+        JSON_WRITER_APPEND_LITERAL(writer, " [  ");
+        json_writer_append_int(writer, priGroup-1);
+        JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        json_writer_append_u64(writer, val1);
+        JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        json_writer_append_u64(writer, val2);
+        JSON_WRITER_APPEND_LITERAL(writer, " ] ,");
+        _JSONENCODE_WRITER_CHECK(writer);
     }
 
-    /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    if (lastPort != 0)
+    {
+        /* replace the last ',' with the "] } ," for the next port */
+        _JSONENCODE_WRITER_CLOSE(writer);
+    }
 
-    /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    /* replace the last ',' with the "] } ," for the next 'realm' */
+    _JSONENCODE_WRITER_CLOSE(writer);
+    _JSONENCODE_WRITER_CHECK(writer);
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - IPPG data Complete \n");
 
@@ -196,143 +157,107 @@ static BVIEW_STATUS _jsonencode_report_ingress_ippg ( char *buffer, int asicId,
  *         "get-bst-report" REST API - ingress-port-service-pool.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( char *buffer, int asicId,
+static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( JSON_WRITER_t *writer, int asicId,
                                                      const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                      const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                      const BSTJSON_REPORT_OPTIONS_t *options,
-                                                     const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                     int bufLen,
-                                                     int *length)
+                                                     const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
-    bool includePort = false;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
-    int sendIncrReport = options->sendIncrementalReport;
 
-    int includeServicePool[BVIEW_ASIC_MAX_SERVICE_POOLS] = { 0 };
-    int port = 0, pool = 0;
+    uint64_t includeEntries[BSTJSON_DIFF_MAX_BITMAP_WORDS];
+    BSTJSON_CONVERT_t conv;
+    uint64_t umShare[BVIEW_ASIC_MAX_PORTS * BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS];
+    int numEntries = asic->numPorts * BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS;
+    int entry = 0, triggerEntry = -1;
+    int port = 0, pool = 0, lastPort = 0;
     char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
 
-
-    char *ipspTemplate = " { \"realm\": \"ingress-port-service-pool\", \"%s\": [ ";
-    char *ipspPortTemplate = " { \"port\": \"%s\", \"data\": [ ";
-    //char *ippgPortGroupTemplate = " { \"pg\" : %d , \"um-share\": %" PRIu64 " , \"um-headroom\": %" PRIu64 " } ,";
-    //char *ippgPortGroupTemplate = " { \"pg\" : %d , \"data\": [ %" PRIu64 " , %" PRIu64 " ] } ,";
-    char *ipspServicePoolTemplate = " [  %d , %" PRIu64 " ] ,";
-
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - IPSP data \n");
 
-    /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, ipspTemplate, "data");
+    /* copying the header */
+    _JSONENCODE_REALM_OPEN(writer, BVIEW_BST_INGRESS_PORT_SP, false);
+
+    /* find the (port, service pool) pairs that need to be reported,
+     * entry 'n' is port (n / MAX_INGRESS_SERVICE_POOLS) + 1 */
+    bstjson_diff_report_bitmap_get((previous != NULL) ? &previous->iPortSp.data[0][0] : NULL,
+                                   &current->iPortSp.data[0][0],
+                                   numEntries, BSTJSON_DIFF_STRIDE(current->iPortSp.data[0][0]), 1,
+                                   options->sendIncrementalReport, includeEntries);
 
-    /* For each port, and for each priority group in that port, 
-     *  1. attempt to see if this port needs to be reported.
-     *  2. create the report.
-     */
-    for (port = 1; port <= asic->numPorts; port++)
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
     {
-      /* check if the trigger report request should contain snap shot */
-        if ((port != options->triggerInfo.port) &&
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
+        if ((options->triggerInfo.queue >= 0) &&
+            (options->triggerInfo.queue < asic->numServicePools))
         {
-          continue;
+            triggerEntry = ((options->triggerInfo.port - 1) * BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS) +
+                            options->triggerInfo.queue;
         }
-        includePort = false;
-        memset (&includeServicePool[0], 0, sizeof (includeServicePool));
-
-        /* lets see if this port needs to be included in the report at all */
-        for (pool = 1; pool <= asic->numServicePools; pool++)
-        {
-      /* check if the trigger report request should contain snap shot */
-           if ((pool-1 != options->triggerInfo.queue) && 
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
-           {
-             continue;
-           }
-            /* By default, we plan to include the pool */
-            includeServicePool[pool - 1] = 1;
-
-            if (true == sendIncrReport)
-            {
-              /* If there is no traffic reported for this priority group, ignore it */
-              if ((previous == NULL) &&
-                  (current->iPortSp.data[port - 1][pool - 1].umShareBufferCount == 0))
-              {
-                includeServicePool[pool - 1] = 0;
-                continue;
-              }
-            }
-
-            /* If this is snapshot report, include the port in the data  */
-            if (previous == NULL)
-            {
-                includePort = true;
-                continue;
-            }
-
-            /* if there is traffic reported since the last snapshot, we can't ignore this pool */
-            if (previous->iPortSp.data[port - 1][pool - 1].umShareBufferCount
-                != current->iPortSp.data[port - 1][pool - 1].umShareBufferCount)
-            {
-                includePort = true;
-                continue;
-            }
+        bstjson_diff_bitmap_restrict(includeEntries, numEntries, triggerEntry);
+    }
 
-            /* since there is no reason to include the pool, we can ignore it*/
-            includeServicePool[pool - 1] = 0;
-        }
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                &current->iPortSp.data[0][0],
+                                numEntries, BSTJSON_DIFF_STRIDE(current->iPortSp.data[0][0]), 1,
+                                BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS, -1, BSTJSON_FILTER_INDEX_SERVICE_POOL, includeEntries);
+
+    /* convert the counters to the reported units */
+    bstjson_convert_setup(options, asic, &conv);
+    _JSONENCODE_CONVERT_REALM(&conv, current->iPortSp.data[0][0], options->bst_max_buffers_ptr->iPortSp.data[0][0],
+                              umShareBufferCount, umShareMaxBuf, numEntries, umShare);
+
+    /* walk the pairs to be reported, ports come in ascending order */
+    for (entry = bstjson_diff_bitmap_next(includeEntries, numEntries, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includeEntries, numEntries, entry + 1))
+    {
+        port = (entry / BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS) + 1;
+        pool = (entry % BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS) + 1;
 
-        /* if this port needs not be reported, then we move to next port */
-        if (includePort == false)
-        {
+        if (pool > asic->numServicePools)
             continue;
-        }
 
-          /* convert the port to an external representation */
-          memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
-          JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
-
-          /* Now that this port needs to be included in the report, copy the header */
-          _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, ipspPortTemplate,  &portStr[0]);
-
-        /* for each priority-group, prepare the data */
-        for (pool = 1; pool <= asic->numServicePools; pool++)
+        if (port != lastPort)
         {
-            /* we ignore if there is no data to be reported */
-            if (includeServicePool[pool - 1] == 0)
-                continue;
+            if (lastPort != 0)
+            {
+                /* replace the last ',' with the "] } ," for the next port */
+                _JSONENCODE_WRITER_CLOSE(writer);
+            }
 
-            val = current->iPortSp.data[port - 1][pool - 1].umShareBufferCount;
-            maxBufVal = options->bst_max_buffers_ptr->iPortSp.data[port - 1][pool - 1].umShareMaxBuf;
-            bst_json_convert_data(options, asic, &val, maxBufVal);
+            /* convert the port to an external representation */
+            memset(&portStr[0], 0, JSON_MAX_NODE_LENGTH);
+            JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
 
-            /* add the data to the report */
-            _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                          ipspServicePoolTemplate, pool-1,val);
+            /* Now that this port needs to be included in the report, copy the header */
+            JSON_WRITER_APPEND_LITERAL(writer, " { \"port\": \"");
+            json_writer_append_str(writer, &portStr[0]);
+            JSON_WRITER_APPEND_LITERAL(writer, "\", \"data\": [ ");
+            lastPort = port;
         }
 
-        /* adjust the buffer to remove the last ',' */
-        buffer = buffer - 1;
-        remLength += 1;
-        *length -= 1;
+        val = umShare[entry];
 
-        /* add the "] } ," for the next port */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      "] } ," );
+        /* add the data to the report : " [  sp , um-share ] ," */
+        JSON_WRITER_APPEND_LITERAL(writer, " [  ");
+        json_writer_append_int(writer, pool-1);
+        JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        json_writer_append_u64(writer, val);
+        JSON_WRITER_APPEND_LITERAL(writer, " ] ,");
+        _JSONENCODE_WRITER_CHECK(writer);
     }
 
-    /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+    if (lastPort != 0)
+    {
+        /* replace the last ',' with the "] } ," for the next port */
+        _JSONENCODE_WRITER_CLOSE(writer);
+    }
 
-    /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    /* replace the last ',' with the "] } ," for the next 'realm' */
+    _JSONENCODE_WRITER_CLOSE(writer);
+    _JSONENCODE_WRITER_CHECK(writer);
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - IPSP data Complete \n");
 
@@ -345,70 +270,75 @@ static BVIEW_STATUS _jsonencode_report_ingress_ipsp ( char *buffer, int asicId,
  *         "get-bst-report" REST API - ingress-service-pool.
  *
  *********************************************************************/
-static BVIEW_STATUS _jsonencode_report_ingress_sp ( char *buffer, int asicId,
+static BVIEW_STATUS _jsonencode_report_ingress_sp ( JSON_WRITER_t *writer, int asicId,
                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                                    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                                    const BSTJSON_REPORT_OPTIONS_t *options,
-                                                   const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                                   int bufLen,
-                                                   int *length)
+                                                   const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
-    int remLength = bufLen;
-    int actualLength  = 0;
-    int pool = 0;
+    int pool = 0, entry = 0;
     uint64_t val = 0;
-    uint64_t maxBufVal = 0;
-    int sendIncrReport = options->sendIncrementalReport;
-
-    char *ispTemplate = " { \"realm\": \"ingress-service-pool\", \"%s\": [ ";
-    char *ispServicePoolTemplate = " [  %d , %" PRIu64 " ] ,";
+    uint64_t includePools[BSTJSON_DIFF_BITMAP_WORDS(BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS)];
+    BSTJSON_CONVERT_t conv;
+    bool dense = false;
+    uint64_t umShare[BVIEW_ASIC_MAX_INGRESS_SERVICE_POOLS];
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - ISP data \n");
 
-    /* copying the header . Pointer and Length adjustments are handled by the macro */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length, ispTemplate, "data");
+    /* find the service pools that need to be reported */
+    bstjson_diff_report_bitmap_get((previous != NULL) ? &previous->iSp.data[0] : NULL,
+                                   &current->iSp.data[0],
+                                   asic->numServicePools, BSTJSON_DIFF_STRIDE(current->iSp.data[0]), 1,
+                                   options->sendIncrementalReport, includePools);
 
-    /* For each service pool, check if there is a difference, and create the report. */
-    for (pool = 1; pool <= asic->numServicePools; pool++)
+    /* check if the trigger report request should contain snap shot */
+    if (_JSONENCODE_TRIGGER_ONLY(options))
     {
-      /* check if the trigger report request should contain snap shot */
-        if ((pool-1 != options->triggerInfo.queue) && 
-            (false == options->sendSnapShotOnTrigger) && 
-            (true == options->reportTrigger))
-        {
-          continue;
-        }
+        bstjson_diff_bitmap_restrict(includePools, asic->numServicePools, options->triggerInfo.queue);
+    }
 
-        if (true == sendIncrReport)
-        {
-        /* lets see if this pool needs to be included in the report at all */
-        /* if this pool needs not be reported, then we move to next pool */
-         if ((previous == NULL) &&
-            (current->iSp.data[pool-1].umShareBufferCount == 0))
-            continue;  
-        }
+    /* leave out the entries the report filter does not ask for */
+    bstjson_filter_bitmap_apply(&options->filter, _JSONENCODE_BYTES_PER_UNIT(options, asic),
+                                &current->iSp.data[0],
+                                asic->numServicePools, BSTJSON_DIFF_STRIDE(current->iSp.data[0]), 1,
+                                0, -1, BSTJSON_FILTER_INDEX_SERVICE_POOL, includePools);
 
-        if ((previous != NULL) &&
-            (previous->iSp.data[pool-1].umShareBufferCount == current->iSp.data[pool-1].umShareBufferCount))
-            continue;
+    /* write every entry in index order, without its index, when that is shorter */
+    dense = bstjson_layout_dense_choose(options, previous, includePools, asic->numServicePools, 1);
 
-             val = current->iSp.data[pool-1].umShareBufferCount;
-             maxBufVal = options->bst_max_buffers_ptr->iSp.data[pool-1].umShareMaxBuf;
-             bst_json_convert_data(options, asic, &val, maxBufVal);
-        /* Now that this pool needs to be included in the report, add the data to report */
-        _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                      ispServicePoolTemplate, pool-1, val);
+    /* copying the header */
+    _JSONENCODE_REALM_OPEN(writer, BVIEW_BST_INGRESS_SP, dense);
 
-    }
+    /* convert the counters to the reported units */
+    bstjson_convert_setup(options, asic, &conv);
+    _JSONENCODE_CONVERT_REALM(&conv, current->iSp.data[0], options->bst_max_buffers_ptr->iSp.data[0],
+                              umShareBufferCount, umShareMaxBuf, asic->numServicePools, umShare);
+
+    /* For each service pool with a difference, create the report. */
+    for (entry = bstjson_diff_bitmap_next(includePools, asic->numServicePools, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(includePools, asic->numServicePools, entry + 1))
+    {
+        pool = entry + 1;
+
+        val = umShare[entry];
 
-    /* adjust the buffer to remove the last ',' */
-    buffer = buffer - 1;
-    remLength += 1;
-    *length -= 1;
+        /* Now that this pool needs to be included in the report, add the data to report :
+         * " [  sp , um-share ] ," */
+        JSON_WRITER_APPEND_LITERAL(writer, " [  ");
+        if (false == dense)
+        {
+            json_writer_append_int(writer, pool-1);
+            JSON_WRITER_APPEND_LITERAL(writer, " , ");
+        }
+        json_writer_append_u64(writer, val);
+        JSON_WRITER_APPEND_LITERAL(writer, " ] ,");
+        _JSONENCODE_WRITER_CHECK(writer);
+    }
 
-    /* add the "] } ," for the next 'realm' */
-    _JSONENCODE_COPY_FORMATTED_STRING_AND_ADVANCE(actualLength, buffer, remLength, length,
-                                                  "] } ," );
+    /* replace the last ',' with the "] } ," for the next 'realm' */
+    _JSONENCODE_WRITER_CLOSE(writer);
+    _JSONENCODE_WRITER_CHECK(writer);
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS - ISP data Complete \n");
 
@@ -416,82 +346,72 @@ static BVIEW_STATUS _jsonencode_report_ingress_sp ( char *buffer, int asicId,
 
 }
 
+/******************************************************************
+ * @brief  Lists the ingress realms asked for, in report order.
+ *
+ * @param[in]   options    Report options
+ * @param[out]  encoders   Encoders of the realms, BSTJSON_INGRESS_REALMS
+ *                         entries at most
+ * @param[out]  lengths    Room each realm takes when encoded on its own,
+ *                         may be NULL
+ *
+ * @retval   number of realms
+ *********************************************************************/
+int _jsonencode_report_ingress_realms_get(const BSTJSON_REPORT_OPTIONS_t *options,
+                                          BSTJSON_REALM_ENCODER_t *encoders,
+                                          int *lengths)
+{
+    int count = 0;
+
+    if (options->includeIngressPortPriorityGroup)
+    {
+        _JSONENCODE_REALM_ADD(encoders, lengths, count, _jsonencode_report_ingress_ippg, iPortPg, iPortPg.data[0][0]);
+    }
+
+    if (options->includeIngressPortServicePool)
+    {
+        _JSONENCODE_REALM_ADD(encoders, lengths, count, _jsonencode_report_ingress_ipsp, iPortSp, iPortSp.data[0][0]);
+    }
+
+    if (options->includeIngressServicePool)
+    {
+        _JSONENCODE_REALM_ADD(encoders, lengths, count, _jsonencode_report_ingress_sp, iSp, iSp.data[0]);
+    }
+
+    return count;
+}
+
 /******************************************************************
  * @brief  Creates a JSON buffer using the supplied data for the 
  *         "get-bst-report" REST API - ingress part.
  *
  *********************************************************************/
-BVIEW_STATUS _jsonencode_report_ingress ( char *buffer, 
+BVIEW_STATUS _jsonencode_report_ingress ( JSON_WRITER_t *writer,
                                          int asicId,
                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
                                          const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
                                          const BSTJSON_REPORT_OPTIONS_t *options,
-                                         const BVIEW_ASIC_CAPABILITIES_t *asic,
-                                         int bufLen,
-                                         int *length)
+                                         const BVIEW_ASIC_CAPABILITIES_t *asic)
 {
     BVIEW_STATUS status;
-    int tempLength = 0;
-
-    *length = 0;
+    BSTJSON_REALM_ENCODER_t encoders[BSTJSON_INGRESS_REALMS];
+    BSTJSON_REALM_ENCODER_t egress[BSTJSON_EGRESS_REALMS];
+    int count, i;
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS data \n");
 
-    /* If Port-PriorityGroup realm is asked for, lets encode the corresponding data */
-    if (options->includeIngressPortPriorityGroup)
-    {
-        tempLength = 0;
-        status = _jsonencode_report_ingress_ippg(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
+    count = _jsonencode_report_ingress_realms_get(options, &encoders[0], NULL);
 
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
-    }
-
-    /* If Port-ServicePool realm is asked for, lets encode the corresponding data */
-    if (options->includeIngressPortServicePool)
+    for (i = 0; i < count; i++)
     {
-        tempLength = 0;
-        status = _jsonencode_report_ingress_ipsp(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
+        status = encoders[i](writer, asicId, previous, current, options, asic);
         _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
     }
 
-    /* If ServicePool realm is asked for, lets encode the corresponding data */
-    if (options->includeIngressServicePool)
+    /* the last realm leaves its trailing ',' for the egress part, drop it if there is none */
+    if ((count > 0) && (0 == _jsonencode_report_egress_realms_get(options, &egress[0], NULL)))
     {
-        tempLength = 0;
-        status = _jsonencode_report_ingress_sp(buffer, asicId, previous, current, options, asic, bufLen, &tempLength);
-        _JSONENCODE_ASSERT_ERROR((status == BVIEW_STATUS_SUCCESS), status);
-        if (tempLength != 0)
-        {
-            bufLen -= (tempLength);
-            buffer += (tempLength);
-            *(length) += (tempLength);
-        }
-    }
-
-    if (tempLength != 0)
-    {
-        if (! (options->includeEgressCpuQueue ||
-               options->includeEgressMcQueue ||
-               options->includeEgressPortServicePool ||
-               options->includeEgressRqeQueue ||
-               options->includeEgressServicePool ||
-               options->includeEgressUcQueue ||
-               options->includeEgressUcQueueGroup ))
-        {
-            *(length) -= 1;
-        }
+        json_writer_backup(writer, 1);
     }
 
     _JSONENCODE_LOG(_JSONENCODE_DEBUG_TRACE, "BST-JSON-Encoder : (Report) Encoding INGRESS data complete \n");
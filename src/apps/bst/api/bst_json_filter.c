@@ -0,0 +1,434 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "broadview.h"
+#include "json.h"
+#include "cJSON.h"
+#include "bst_json_diff.h"
+#include "bst_json_filter.h"
+
+/* true if bit 'n' of 'bitmap' is set */
+#define _BSTFILTER_BIT_TEST(bitmap, n)   (0 != ((bitmap)[(n) / 64] & (((uint64_t) 1) << ((n) % 64))))
+
+/* 2^64, the first min-value that no longer fits a counter */
+#define BSTFILTER_MIN_VALUE_LIMIT        18446744073709551616.0
+
+/******************************************************************
+ * @brief  Converts a port in external notation, checking its range.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _bstfilter_port_get(cJSON *json_port, int *port)
+{
+    if ((json_port->type != cJSON_String) || (json_port->valuestring == NULL))
+    {
+        _jsonlog("Error parsing JSON, port in report-filter not a string ");
+        return BVIEW_STATUS_INVALID_JSON;
+    }
+
+    if ((BVIEW_STATUS_SUCCESS != sbapi_system_port_translate_from_notation(json_port->valuestring, port)) ||
+        (*port < 1) || (*port > BVIEW_ASIC_MAX_PORTS))
+    {
+        _jsonlog("The JSON string can't be converted to Port# %s ", json_port->valuestring);
+        return BVIEW_STATUS_INVALID_JSON;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Parses the "ports" list : ports and [first, last] ranges.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _bstfilter_ports_parse(cJSON *json_ports, BSTJSON_REPORT_FILTER_t *filter)
+{
+    cJSON *json_item;
+    int i, port, first, last;
+    BVIEW_STATUS rv;
+
+    if (json_ports->type != cJSON_Array)
+    {
+        _jsonlog("Error parsing JSON, ports in report-filter not an array ");
+        return BVIEW_STATUS_INVALID_JSON;
+    }
+
+    for (i = 0; i < cJSON_GetArraySize(json_ports); i++)
+    {
+        json_item = cJSON_GetArrayItem(json_ports, i);
+
+        if (json_item->type == cJSON_Array)
+        {
+            if (2 != cJSON_GetArraySize(json_item))
+            {
+                _jsonlog("Error parsing JSON, port range in report-filter needs [first, last] ");
+                return BVIEW_STATUS_INVALID_JSON;
+            }
+            rv = _bstfilter_port_get(cJSON_GetArrayItem(json_item, 0), &first);
+            if (BVIEW_STATUS_SUCCESS != rv)
+            {
+                return rv;
+            }
+            rv = _bstfilter_port_get(cJSON_GetArrayItem(json_item, 1), &last);
+            if (BVIEW_STATUS_SUCCESS != rv)
+            {
+                return rv;
+            }
+        }
+        else
+        {
+            rv = _bstfilter_port_get(json_item, &first);
+            if (BVIEW_STATUS_SUCCESS != rv)
+            {
+                return rv;
+            }
+            last = first;
+        }
+
+        if (first > last)
+        {
+            _jsonlog("The JSON port range is empty (%d - %d) ", first, last);
+            return BVIEW_STATUS_INVALID_JSON;
+        }
+
+        for (port = first; port <= last; port++)
+        {
+            filter->ports[(port - 1) / 64] |= ((uint64_t) 1) << ((port - 1) % 64);
+        }
+    }
+
+    filter->filterPorts = true;
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Parses a "report-filter" object.
+ *
+ * @param[in]   json_filter   the "report-filter" member of the params
+ * @param[out]  filter        filled-in filter
+ *
+ * @retval   BVIEW_STATUS_SUCCESS            filter parsed
+ * @retval   BVIEW_STATUS_INVALID_JSON       malformed or out of range member
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  min-value not a positive integer
+ *
+ *********************************************************************/
+BVIEW_STATUS bstjson_filter_parse(cJSON *json_filter, BSTJSON_REPORT_FILTER_t *filter)
+{
+    cJSON *json_ports, *json_queueRange, *json_servicePools, *json_minValue;
+    cJSON *json_item;
+    int i, pool;
+    BVIEW_STATUS rv;
+
+    JSON_VALIDATE_POINTER(json_filter, "report-filter", BVIEW_STATUS_INVALID_PARAMETER);
+    JSON_VALIDATE_POINTER(filter, "filter", BVIEW_STATUS_INVALID_PARAMETER);
+
+    memset(filter, 0, sizeof(BSTJSON_REPORT_FILTER_t));
+
+    if (json_filter->type != cJSON_Object)
+    {
+        _jsonlog("Error parsing JSON, report-filter not an object ");
+        return BVIEW_STATUS_INVALID_JSON;
+    }
+
+    /* Parsing and Validating 'ports' from JSON buffer */
+    json_ports = cJSON_GetObjectItem(json_filter, "ports");
+    if (NULL != json_ports)
+    {
+        rv = _bstfilter_ports_parse(json_ports, filter);
+        if (BVIEW_STATUS_SUCCESS != rv)
+        {
+            return rv;
+        }
+    }
+
+    /* Parsing and Validating 'queue-range' from JSON buffer */
+    json_queueRange = cJSON_GetObjectItem(json_filter, "queue-range");
+    if (NULL != json_queueRange)
+    {
+        if ((json_queueRange->type != cJSON_Array) || (2 != cJSON_GetArraySize(json_queueRange)) ||
+            (cJSON_GetArrayItem(json_queueRange, 0)->type != cJSON_Number) ||
+            (cJSON_GetArrayItem(json_queueRange, 1)->type != cJSON_Number))
+        {
+            _jsonlog("Error parsing JSON, queue-range in report-filter needs [first, last] ");
+            return BVIEW_STATUS_INVALID_JSON;
+        }
+        filter->queueMin = cJSON_GetArrayItem(json_queueRange, 0)->valueint;
+        filter->queueMax = cJSON_GetArrayItem(json_queueRange, 1)->valueint;
+        if ((filter->queueMin < 0) || (filter->queueMin > filter->queueMax) ||
+            (filter->queueMax >= BVIEW_ASIC_MAX_UC_QUEUES))
+        {
+            _jsonlog("The JSON queue-range is invalid (%d - %d) ", filter->queueMin, filter->queueMax);
+            return BVIEW_STATUS_INVALID_JSON;
+        }
+        filter->filterQueues = true;
+    }
+
+    /* Parsing and Validating 'service-pools' from JSON buffer */
+    json_servicePools = cJSON_GetObjectItem(json_filter, "service-pools");
+    if (NULL != json_servicePools)
+    {
+        if (json_servicePools->type != cJSON_Array)
+        {
+            _jsonlog("Error parsing JSON, service-pools in report-filter not an array ");
+            return BVIEW_STATUS_INVALID_JSON;
+        }
+        for (i = 0; i < cJSON_GetArraySize(json_servicePools); i++)
+        {
+            json_item = cJSON_GetArrayItem(json_servicePools, i);
+            if (json_item->type != cJSON_Number)
+            {
+                _jsonlog("Error parsing JSON, service pool in report-filter not a integer ");
+                return BVIEW_STATUS_INVALID_JSON;
+            }
+            pool = json_item->valueint;
+            if ((pool < 0) || (pool >= BVIEW_ASIC_MAX_SERVICE_POOLS))
+            {
+                _jsonlog("The JSON number out of range %d (min %d, max %d) ", pool, 0, BVIEW_ASIC_MAX_SERVICE_POOLS - 1);
+                return BVIEW_STATUS_INVALID_JSON;
+            }
+            filter->servicePools |= (1U << pool);
+        }
+        filter->filterServicePools = true;
+    }
+
+    /* Parsing and Validating 'min-value' from JSON buffer */
+    json_minValue = cJSON_GetObjectItem(json_filter, "min-value");
+    if (NULL != json_minValue)
+    {
+        if (json_minValue->type != cJSON_Number)
+        {
+            _jsonlog("Error parsing JSON, min-value in report-filter not a number ");
+            return BVIEW_STATUS_INVALID_JSON;
+        }
+        /* a counter value : a whole number that fits 64 bits */
+        if ((json_minValue->valuedouble < 0) ||
+            (json_minValue->valuedouble >= BSTFILTER_MIN_VALUE_LIMIT) ||
+            ((double) (uint64_t) json_minValue->valuedouble != json_minValue->valuedouble))
+        {
+            _jsonlog("The JSON min-value in report-filter is not a positive integer (%f) ",
+                     json_minValue->valuedouble);
+            return BVIEW_STATUS_INVALID_PARAMETER;
+        }
+        filter->minValue = (uint64_t) json_minValue->valuedouble;
+    }
+
+    filter->active = (filter->filterPorts || filter->filterQueues ||
+                      filter->filterServicePools || (0 != filter->minValue));
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Encodes a filter in the form bstjson_filter_parse() accepts.
+ *
+ * @param[in]   asicId    ASIC the ports are translated for
+ * @param[in]   filter    filter to encode
+ * @param[out]  w         writer the "report-filter" object is appended to
+ *
+ * @retval   BVIEW_STATUS_SUCCESS       filter encoded
+ * @retval   BVIEW_STATUS_INVALID_JSON  a port can't be translated
+ * @retval   BVIEW_STATUS_OUTOFMEMORY   the writer overflowed
+ *
+ * @note   Consecutive ports are encoded as [first, last] ranges. A filter
+ *         without any criterion is encoded as an empty object.
+ *********************************************************************/
+BVIEW_STATUS bstjson_filter_encode(int asicId, const BSTJSON_REPORT_FILTER_t *filter,
+                                   JSON_WRITER_t *w)
+{
+    char portStr[JSON_MAX_NODE_LENGTH] = { 0 };
+    int port, last, pool;
+    bool first;
+
+    JSON_VALIDATE_POINTER(filter, "filter", BVIEW_STATUS_INVALID_PARAMETER);
+    JSON_VALIDATE_POINTER(w, "writer", BVIEW_STATUS_INVALID_PARAMETER);
+
+    JSON_WRITER_APPEND_LITERAL(w, "{ ");
+
+    if (true == filter->filterPorts)
+    {
+        JSON_WRITER_APPEND_LITERAL(w, "\"ports\": [ ");
+        first = true;
+        for (port = 1; port <= BVIEW_ASIC_MAX_PORTS; port++)
+        {
+            if (!_BSTFILTER_BIT_TEST(filter->ports, port - 1))
+            {
+                continue;
+            }
+            /* bit 'last' is the port after 'last' */
+            last = port;
+            while ((last < BVIEW_ASIC_MAX_PORTS) && _BSTFILTER_BIT_TEST(filter->ports, last))
+            {
+                last++;
+            }
+
+            if (false == first)
+            {
+                JSON_WRITER_APPEND_LITERAL(w, ", ");
+            }
+            first = false;
+
+            JSON_PORT_MAP_TO_NOTATION(port, asicId, &portStr[0]);
+            if (last == port)
+            {
+                json_writer_append_formatted(w, "\"%s\"", &portStr[0]);
+            }
+            else
+            {
+                json_writer_append_formatted(w, "[ \"%s\", ", &portStr[0]);
+                JSON_PORT_MAP_TO_NOTATION(last, asicId, &portStr[0]);
+                json_writer_append_formatted(w, "\"%s\" ]", &portStr[0]);
+            }
+            port = last;
+        }
+        JSON_WRITER_APPEND_LITERAL(w, " ], ");
+    }
+
+    if (true == filter->filterQueues)
+    {
+        json_writer_append_formatted(w, "\"queue-range\": [ %d, %d ], ",
+                                     filter->queueMin, filter->queueMax);
+    }
+
+    if (true == filter->filterServicePools)
+    {
+        JSON_WRITER_APPEND_LITERAL(w, "\"service-pools\": [ ");
+        first = true;
+        for (pool = 0; pool < BVIEW_ASIC_MAX_SERVICE_POOLS; pool++)
+        {
+            if (0 == (filter->servicePools & (1U << pool)))
+            {
+                continue;
+            }
+            if (false == first)
+            {
+                JSON_WRITER_APPEND_LITERAL(w, ", ");
+            }
+            first = false;
+            json_writer_append_int(w, pool);
+        }
+        JSON_WRITER_APPEND_LITERAL(w, " ], ");
+    }
+
+    if (0 != filter->minValue)
+    {
+        JSON_WRITER_APPEND_LITERAL(w, "\"min-value\": ");
+        json_writer_append_u64(w, filter->minValue);
+        JSON_WRITER_APPEND_LITERAL(w, ", ");
+    }
+
+    /* drop the ", " after the last member */
+    json_writer_backup(w, 2);
+    if (',' == json_writer_peek(w))
+    {
+        JSON_WRITER_APPEND_LITERAL(w, " }");
+    }
+    else
+    {
+        /* nothing was appended, step over the "{ " again */
+        json_writer_append(w, "{ }", 3);
+    }
+
+    return (json_writer_overflow(w)) ? BVIEW_STATUS_OUTOFMEMORY : BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Clears the bit of every entry the filter leaves out.
+ *
+ * @note   Only the set bits are visited, the bitmap already holds the
+ *         entries the report would carry without the filter.
+ *
+ * @note   The counters are collected in bytes, the min value is in the
+ *         units of the report : it is scaled to bytes once, rather than
+ *         converting every counter.
+ *********************************************************************/
+void bstjson_filter_bitmap_apply(const BSTJSON_REPORT_FILTER_t *filter,
+                                 uint64_t bytesPerUnit,
+                                 const void *current,
+                                 int numEntries, int stride, int compareWords,
+                                 int perPort, int portWord,
+                                 BSTJSON_FILTER_INDEX_t index,
+                                 uint64_t *bitmap)
+{
+    const uint64_t *words = (const uint64_t *) current;
+    const uint64_t *row;
+    uint64_t port, minBytes = 0;
+    int entry, idx, w;
+    bool keep;
+
+    if ((NULL == filter) || (false == filter->active))
+    {
+        return;
+    }
+
+    /* a report in cells rounds the bytes down to whole cells, so a
+       counter reaches n cells from n * bytesPerUnit bytes on */
+    if (0 != filter->minValue)
+    {
+        bytesPerUnit = (0 != bytesPerUnit) ? bytesPerUnit : 1;
+        minBytes = (filter->minValue > (UINT64_MAX / bytesPerUnit)) ?
+                   UINT64_MAX : (filter->minValue * bytesPerUnit);
+    }
+
+    for (entry = bstjson_diff_bitmap_next(bitmap, numEntries, 0);
+         entry >= 0;
+         entry = bstjson_diff_bitmap_next(bitmap, numEntries, entry + 1))
+    {
+        row = &words[(size_t) entry * stride];
+        idx = (perPort != 0) ? (entry % perPort) : entry;
+        keep = true;
+
+        /* realms that carry no port are not narrowed by the port set */
+        if (filter->filterPorts && ((perPort != 0) || (portWord >= 0)))
+        {
+            port = (perPort != 0) ? (uint64_t) ((entry / perPort) + 1) : row[portWord];
+            keep = (port >= 1) && (port <= BVIEW_ASIC_MAX_PORTS) &&
+                   _BSTFILTER_BIT_TEST(filter->ports, port - 1);
+        }
+
+        if (keep && filter->filterQueues && (BSTJSON_FILTER_INDEX_QUEUE == index))
+        {
+            keep = (idx >= filter->queueMin) && (idx <= filter->queueMax);
+        }
+
+        if (keep && filter->filterServicePools && (BSTJSON_FILTER_INDEX_SERVICE_POOL == index))
+        {
+            keep = (idx < 32) && (0 != (filter->servicePools & (1U << idx)));
+        }
+
+        if (keep && (0 != minBytes))
+        {
+            keep = false;
+            for (w = 0; w < compareWords; w++)
+            {
+                if (row[w] >= minBytes)
+                {
+                    keep = true;
+                    break;
+                }
+            }
+        }
+
+        if (false == keep)
+        {
+            bitmap[entry / 64] &= ~(((uint64_t) 1) << (entry % 64));
+        }
+    }
+}
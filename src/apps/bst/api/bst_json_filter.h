@@ -0,0 +1,124 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BST_JSON_FILTER_H
+#define	INCLUDE_BST_JSON_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "broadview.h"
+#include "asic.h"
+#include "cJSON.h"
+#include "bst_json_diff.h"
+#include "json_writer.h"
+
+#ifdef	__cplusplus
+extern "C"
+{
+#endif
+
+/* Server side filtering of the report entries.
+ *
+ * A filter narrows the entries of the realms a report includes :
+ *   ports          - realms indexed by port, and the unicast and
+ *                    multicast queues by the port using the queue
+ *   queue range    - unicast, multicast, CPU and RQE queues
+ *   service pools  - the service pool realms, ingress and egress
+ *   min value      - entries whose counters are all below the value
+ *                    are left out. The value is in the units of the
+ *                    report, cells or bytes (stat-units-in-cells); a
+ *                    report in percentage compares it in those units
+ *                    too, before the counters become percentages
+ * A criterion that is not set keeps every entry. The filter is applied
+ * on the bitmap of entries to report, so filtered out entries are never
+ * converted or formatted.
+ *
+ * JSON form, every member optional :
+ *   "report-filter" : { "ports" : [ "1", [ "5", "8" ] ],
+ *                       "queue-range" : [ 0, 7 ],
+ *                       "service-pools" : [ 0, 2 ],
+ *                       "min-value" : 100 }
+ * A port range is a [first, last] pair. An empty object clears the filter.
+ */
+
+/* Words in the port set of a filter, bit (port - 1) per port */
+#define BSTJSON_FILTER_PORT_WORDS          BSTJSON_DIFF_BITMAP_WORDS(BVIEW_ASIC_MAX_PORTS)
+
+/* Word of a realm entry '_entry' holding '_field' */
+#define BSTJSON_FILTER_WORD(_entry, _field) \
+    ((int) (((const uint64_t *) &(_entry)._field) - ((const uint64_t *) &(_entry))))
+
+/* Filter on the entries of a report */
+typedef struct _bstjson_report_filter_
+{
+    /* false if no criterion is set */
+    bool active;
+    /* ports kept, bit (port - 1) */
+    bool filterPorts;
+    uint64_t ports[BSTJSON_FILTER_PORT_WORDS];
+    /* queues kept, [queueMin, queueMax] */
+    bool filterQueues;
+    int queueMin;
+    int queueMax;
+    /* service pools kept, bit per pool */
+    bool filterServicePools;
+    uint32_t servicePools;
+    /* in the units of the report, 0 keeps every entry */
+    uint64_t minValue;
+} BSTJSON_REPORT_FILTER_t;
+
+/* Most text bstjson_filter_encode() takes : every other port set, each
+ * quoted with a separator, plus the queue range, pools and min value */
+#define BSTJSON_FILTER_ENCODE_LENGTH       ((8 * BVIEW_ASIC_MAX_PORTS) + 128)
+
+/* What the index of a realm entry stands for */
+typedef enum _bstjson_filter_index_
+{
+    BSTJSON_FILTER_INDEX_NONE = 0,
+    BSTJSON_FILTER_INDEX_QUEUE,
+    BSTJSON_FILTER_INDEX_SERVICE_POOL
+} BSTJSON_FILTER_INDEX_t;
+
+/* Parses a "report-filter" object into 'filter'. */
+BVIEW_STATUS bstjson_filter_parse(cJSON *json_filter, BSTJSON_REPORT_FILTER_t *filter);
+
+/* Appends 'filter' to 'w' as a "report-filter" object. */
+BVIEW_STATUS bstjson_filter_encode(int asicId, const BSTJSON_REPORT_FILTER_t *filter,
+                                   JSON_WRITER_t *w);
+
+/* Clears the bit of every entry the filter leaves out.
+ * 'bytesPerUnit' is the size of a unit of the report's counters, the
+ * cell size for a report in cells and 1 for a report in bytes.
+ * The realm is laid out as for bstjson_diff_report_bitmap_get() :
+ *   perPort    - entries per port, 0 if the realm is not indexed by port
+ *   portWord   - word of an entry holding the queue's port, -1 if none
+ *   index      - what the entry's index (within its port) stands for */
+void bstjson_filter_bitmap_apply(const BSTJSON_REPORT_FILTER_t *filter,
+                                 uint64_t bytesPerUnit,
+                                 const void *current,
+                                 int numEntries, int stride, int compareWords,
+                                 int perPort, int portWord,
+                                 BSTJSON_FILTER_INDEX_t index,
+                                 uint64_t *bitmap);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* INCLUDE_BST_JSON_FILTER_H */
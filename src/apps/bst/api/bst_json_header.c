@@ -0,0 +1,307 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "broadview.h"
+#include "json.h"
+#include "json_writer.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+#include "bst_registry.h"
+
+#include "bst_json_encoder.h"
+#include "bst_json_header.h"
+
+/* header kinds, by method */
+typedef enum _bsthdr_kind_
+{
+    _BSTHDR_KIND_REPORT = 0,
+    _BSTHDR_KIND_THRESHOLDS,
+    _BSTHDR_KIND_TRIGGER,
+    _BSTHDR_KIND_MAX
+} _BSTHDR_KIND_t;
+
+static const char *bstHeaderMethods[_BSTHDR_KIND_MAX] = {
+    "get-bst-report",
+    "get-bst-thresholds",
+    "trigger-report"
+};
+
+/* text of a header up to the time stamp */
+#define _BSTHDR_PREFIX_LENGTH       256
+
+#define _BSTHDR_TIME_FORMAT         "%Y-%m-%d - %H:%M:%S "
+#define _BSTHDR_TIME_LENGTH         64
+
+/* fixed part of the headers of a unit */
+typedef struct _bsthdr_unit_
+{
+    bool ready;
+    char asicIdStr[JSON_MAX_NODE_LENGTH];
+    char prefix[_BSTHDR_KIND_MAX][_BSTHDR_PREFIX_LENGTH];
+    int prefixLength[_BSTHDR_KIND_MAX];
+} _BSTHDR_UNIT_t;
+
+static _BSTHDR_UNIT_t bstHeaderUnits[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+static pthread_mutex_t bstHeaderUnitLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* for a unit out of the table, rebuilt every time */
+static __thread _BSTHDR_UNIT_t bstHeaderScratch;
+
+/* time stamp last formatted by this thread */
+static __thread struct _bsthdr_time_
+{
+    time_t second;
+    /* first second of the minute of 'second' */
+    time_t minute;
+    int length;
+    char text[_BSTHDR_TIME_LENGTH];
+} bstHeaderTime;
+
+/******************************************************************
+ * @brief  Builds the realm tables of the registry.
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ *
+ *********************************************************************/
+BVIEW_STATUS bstjson_header_init(void)
+{
+    return bst_registry_init();
+}
+
+/******************************************************************
+ * @brief  Builds the fixed part of the headers of a unit.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _bsthdr_unit_build(int asicId, _BSTHDR_UNIT_t *unit)
+{
+    int kind, length;
+
+    memset(unit->asicIdStr, 0, sizeof (unit->asicIdStr));
+
+    /* convert asicId to external  notation */
+    JSON_ASIC_ID_MAP_TO_NOTATION(asicId, &unit->asicIdStr[0]);
+
+    for (kind = 0; kind < _BSTHDR_KIND_MAX; kind++)
+    {
+        length = snprintf(unit->prefix[kind], _BSTHDR_PREFIX_LENGTH, " { \
+\"jsonrpc\": \"2.0\",\
+\"method\": \"%s\",\
+\"asic-id\": \"%s\",\
+\"version\": \"%d\",\
+\"time-stamp\": \"",
+                          bstHeaderMethods[kind], &unit->asicIdStr[0], BVIEW_JSON_VERSION);
+        if ((length < 0) || (length >= _BSTHDR_PREFIX_LENGTH))
+        {
+            return BVIEW_STATUS_OUTOFMEMORY;
+        }
+        unit->prefixLength[kind] = length;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Returns the fixed part of the headers of a unit, built on
+ *         first use.
+ *
+ *********************************************************************/
+static BVIEW_STATUS _bsthdr_unit_get(int asicId, const _BSTHDR_UNIT_t **pUnit)
+{
+    _BSTHDR_UNIT_t *unit;
+    BVIEW_STATUS status = BVIEW_STATUS_SUCCESS;
+
+    if ((asicId < 0) || (asicId >= BVIEW_MAX_ASICS_ON_A_PLATFORM))
+    {
+        status = _bsthdr_unit_build(asicId, &bstHeaderScratch);
+        *pUnit = &bstHeaderScratch;
+        return status;
+    }
+
+    unit = &bstHeaderUnits[asicId];
+
+    if (false == __atomic_load_n(&unit->ready, __ATOMIC_ACQUIRE))
+    {
+        pthread_mutex_lock(&bstHeaderUnitLock);
+        if (false == unit->ready)
+        {
+            status = _bsthdr_unit_build(asicId, unit);
+            if (BVIEW_STATUS_SUCCESS == status)
+            {
+                __atomic_store_n(&unit->ready, true, __ATOMIC_RELEASE);
+            }
+        }
+        pthread_mutex_unlock(&bstHeaderUnitLock);
+    }
+
+    *pUnit = unit;
+    return status;
+}
+
+/******************************************************************
+ * @brief  Returns the external notation of a unit.
+ *
+ * @param[in]   asicId     unit
+ * @param[out]  asicIdStr  notation, valid until the next call on this
+ *                         thread for a unit out of the platform range
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ * @retval   BVIEW_STATUS_INVALID_JSON  the unit has no notation
+ *
+ *********************************************************************/
+BVIEW_STATUS bstjson_header_asic_id_get(int asicId, const char **asicIdStr)
+{
+    const _BSTHDR_UNIT_t *unit;
+    BVIEW_STATUS status;
+
+    status = _bsthdr_unit_get(asicId, &unit);
+    if (BVIEW_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+
+    *asicIdStr = &unit->asicIdStr[0];
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Formats a time stamp, reusing the one of the last call.
+ *
+ * @retval   length of the text
+ *
+ * @note     Within a minute only the seconds change, given that time
+ *           zones are offset by whole minutes.
+ *********************************************************************/
+static int _bsthdr_time_format(time_t reportTime, const char **text)
+{
+    struct _bsthdr_time_ *cache = &bstHeaderTime;
+    struct tm timeinfo;
+    time_t second;
+
+    *text = &cache->text[0];
+
+    if ((cache->length > 0) && (reportTime == cache->second))
+    {
+        return cache->length;
+    }
+
+    if ((cache->length > 0) &&
+        (reportTime >= cache->minute) && (reportTime < (cache->minute + 60)))
+    {
+        /* "... %M:%S " : the seconds sit before the trailing blank */
+        second = reportTime - cache->minute;
+        cache->text[cache->length - 3] = (char) ('0' + (second / 10));
+        cache->text[cache->length - 2] = (char) ('0' + (second % 10));
+        cache->second = reportTime;
+        return cache->length;
+    }
+
+    memset(&cache->text[0], 0, sizeof (cache->text));
+    localtime_r(&reportTime, &timeinfo);
+    cache->length = (int) strftime(&cache->text[0], _BSTHDR_TIME_LENGTH, _BSTHDR_TIME_FORMAT, &timeinfo);
+    cache->second = reportTime;
+    /* a leap second is not reused */
+    cache->minute = (timeinfo.tm_sec < 60) ? (reportTime - timeinfo.tm_sec) : (reportTime + 1);
+
+    return cache->length;
+}
+
+/******************************************************************
+ * @brief  Writes the header of a report.
+ *
+ * @param[in]   writer     writer, at the start of the report
+ * @param[in]   asicId     unit
+ * @param[in]   options    report options
+ * @param[in]   reportTime time stamp of the report
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ * @retval   BVIEW_STATUS_INVALID_JSON  the unit has no notation
+ *
+ * @note     A report header ends with its "report" array opened, a
+ *           trigger report one after its "counter". A report of an
+ *           incremental stream carries its sequence number, and tells
+ *           if it is a keyframe. A report of data collected while the
+ *           south bound was resyncing is marked stale.
+ *********************************************************************/
+BVIEW_STATUS bstjson_header_write(JSON_WRITER_t *writer, int asicId,
+                                  const BSTJSON_REPORT_OPTIONS_t *options,
+                                  const BVIEW_TIME_t *reportTime)
+{
+    const _BSTHDR_UNIT_t *unit;
+    const char *timeString;
+    int timeLength;
+    int kind = _BSTHDR_KIND_REPORT;
+    BVIEW_STATUS status;
+
+    if (options->reportTrigger == true)
+    {
+        kind = _BSTHDR_KIND_TRIGGER;
+    }
+    else if (options->reportThreshold == true)
+    {
+        kind = _BSTHDR_KIND_THRESHOLDS;
+    }
+
+    status = _bsthdr_unit_get(asicId, &unit);
+    if (BVIEW_STATUS_SUCCESS != status)
+    {
+        return status;
+    }
+
+    timeLength = _bsthdr_time_format(*(const time_t *) reportTime, &timeString);
+
+    json_writer_append(writer, unit->prefix[kind], unit->prefixLength[kind]);
+    json_writer_append(writer, timeString, timeLength);
+    JSON_WRITER_APPEND_LITERAL(writer, "\"");
+
+    if (0 != options->sequenceNumber)
+    {
+        JSON_WRITER_APPEND_LITERAL(writer, ",\"sequence-number\": ");
+        json_writer_append_u64(writer, options->sequenceNumber);
+        JSON_WRITER_APPEND_LITERAL(writer, ",\"keyframe\": ");
+        json_writer_append_int(writer, (true == options->keyframe) ? 1 : 0);
+    }
+
+    if (true == options->stale)
+    {
+        JSON_WRITER_APPEND_LITERAL(writer, ",\"stale\": 1");
+    }
+
+    if (kind != _BSTHDR_KIND_TRIGGER)
+    {
+        JSON_WRITER_APPEND_LITERAL(writer, ",\"report\": [ ");
+    }
+    else
+    {
+        JSON_WRITER_APPEND_LITERAL(writer, ",\"realm\": \"");
+        json_writer_append_str(writer, bst_registry_realm_name_get(options->triggerInfo.realm));
+        JSON_WRITER_APPEND_LITERAL(writer, "\",\"counter\": \"");
+        json_writer_append_str(writer, bst_registry_counter_name_get(options->triggerInfo.counter));
+        JSON_WRITER_APPEND_LITERAL(writer, "\",");
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
@@ -0,0 +1,59 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BST_JSON_HEADER_H
+#define	INCLUDE_BST_JSON_HEADER_H
+
+#include "broadview.h"
+#include "json_writer.h"
+#include "bst.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "bst_json_encoder.h"
+
+#ifdef	__cplusplus
+extern "C"
+{
+#endif
+
+/* Fixed parts of the report header.
+ *
+ * The text of a header up to its time stamp only depends on the unit and
+ * on the method, so it is built once per unit and copied afterwards. The
+ * time stamp is formatted once a minute per thread, only its seconds are
+ * rewritten in between. The realm and the counter a trigger report names
+ * come from the registry (bst_registry.h).
+ */
+
+/* Builds the realm tables of the registry. Safe to call more than once */
+BVIEW_STATUS bstjson_header_init(void);
+
+/* Returns the external notation of a unit */
+BVIEW_STATUS bstjson_header_asic_id_get(int asicId, const char **asicIdStr);
+
+/* Writes the header of a report up to its "report" array, or of a trigger
+ * report up to its "counter" */
+BVIEW_STATUS bstjson_header_write(JSON_WRITER_t *writer, int asicId,
+                                  const BSTJSON_REPORT_OPTIONS_t *options,
+                                  const BVIEW_TIME_t *reportTime);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* INCLUDE_BST_JSON_HEADER_H */
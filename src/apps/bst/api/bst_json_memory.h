@@ -28,11 +28,13 @@ extern "C"
 {
 #endif
 
-/* A small implementation of a memory pool, that offers buffers in two sizes */
+/* A memory pool on top of the JSON slab allocator (json_slab.h),
+   that offers buffers in predefined sizes */
 
 typedef enum _bstjson_memory_size_
 {
-    BSTJSON_MEMSIZE_RESPONSE = 1024,
+    /* get-bst-feature carries the report filter, see BSTJSON_FILTER_ENCODE_LENGTH */
+    BSTJSON_MEMSIZE_RESPONSE = 2048,
     BSTJSON_MEMSIZE_REPORT = (sizeof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t)+ (32*2048)),
 } BSTJSON_MEMORY_SIZE;
 
@@ -0,0 +1,447 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "broadview.h"
+#include "json_writer.h"
+
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+
+#include "bst.h"
+
+#include "bst_json_memory.h"
+#include "bst_json_encoder.h"
+#include "bst_json_parallel.h"
+
+#define _BSTPAR_DEBUG
+#define _BSTPAR_DEBUG_LEVEL         _BSTPAR_DEBUG_ERROR
+
+#define _BSTPAR_DEBUG_TRACE         (0x1)
+#define _BSTPAR_DEBUG_INFO          (0x01 << 1)
+#define _BSTPAR_DEBUG_ERROR         (0x01 << 2)
+#define _BSTPAR_DEBUG_ALL           (0xFF)
+
+#ifdef _BSTPAR_DEBUG
+#define _BSTPAR_LOG(level, format,args...)   do { \
+            if ((level) & _BSTPAR_DEBUG_LEVEL) { \
+                printf(format, ##args); \
+            } \
+        }while(0)
+#else
+#define _BSTPAR_LOG(level, format,args...)
+#endif
+
+/* one job per realm */
+#define _BSTPAR_MAX_JOBS            (BSTJSON_INGRESS_REALMS + BSTJSON_EGRESS_REALMS)
+
+/* one realm to encode */
+typedef struct _bstpar_job_
+{
+    BSTJSON_REALM_ENCODER_t encoder;
+    JSON_WRITER_t writer;
+    BVIEW_STATUS status;
+} _BSTPAR_JOB_t;
+
+typedef struct _bstpar_pool_
+{
+    bool running;
+    int numThreads;
+    pthread_t threads[BSTJSON_PARALLEL_MAX_THREADS];
+
+    /* held by the report being encoded */
+    pthread_mutex_t busy;
+
+    /* protects the fields below */
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;
+    pthread_cond_t workDone;
+
+    /* the report being encoded */
+    int asicId;
+    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous;
+    const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current;
+    const BSTJSON_REPORT_OPTIONS_t *options;
+    const BVIEW_ASIC_CAPABILITIES_t *asic;
+
+    _BSTPAR_JOB_t jobs[_BSTPAR_MAX_JOBS];
+    int numJobs;
+    /* next job to be picked up */
+    int nextJob;
+    /* jobs not yet complete */
+    int pending;
+
+    /* one chunk per realm, see _bstpar_realms_get() */
+    char *chunks;
+} _BSTPAR_POOL_t;
+
+static _BSTPAR_POOL_t bstParallelPool = {
+    .running = false,
+    .numThreads = 1,
+    .busy = PTHREAD_MUTEX_INITIALIZER,
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .workReady = PTHREAD_COND_INITIALIZER,
+    .workDone = PTHREAD_COND_INITIALIZER
+};
+
+/******************************************************************
+ * @brief  Picks up and encodes jobs until there is none left.
+ *
+ * @note     called with the pool lock held, returns with it held
+ *********************************************************************/
+static void _bstpar_jobs_run(_BSTPAR_POOL_t *pool)
+{
+    _BSTPAR_JOB_t *job;
+
+    while (pool->nextJob < pool->numJobs)
+    {
+        job = &pool->jobs[pool->nextJob++];
+        pthread_mutex_unlock(&pool->lock);
+
+        job->status = job->encoder(&job->writer, pool->asicId, pool->previous,
+                                   pool->current, pool->options, pool->asic);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->pending--;
+        if (0 == pool->pending)
+        {
+            pthread_cond_signal(&pool->workDone);
+        }
+    }
+}
+
+/******************************************************************
+ * @brief  Pool thread, waits for reports and encodes their realms.
+ *
+ *********************************************************************/
+static void *_bstpar_thread(void *arg)
+{
+    _BSTPAR_POOL_t *pool = (_BSTPAR_POOL_t *) arg;
+
+    pthread_mutex_lock(&pool->lock);
+    while (true)
+    {
+        while (pool->nextJob >= pool->numJobs)
+        {
+            pthread_cond_wait(&pool->workReady, &pool->lock);
+        }
+        _bstpar_jobs_run(pool);
+    }
+
+    /* not reached */
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/******************************************************************
+ * @brief  Lists the realms asked for, with the length of their chunks.
+ *
+ * @param[out]  numIngress  number of ingress realms, listed first
+ *
+ * @retval   number of realms
+ *
+ * @note     A chunk is sized to the most text its realm can take, but
+ *           never more than a whole report.
+ *********************************************************************/
+static int _bstpar_realms_get(const BSTJSON_REPORT_OPTIONS_t *options,
+                              BSTJSON_REALM_ENCODER_t *encoders,
+                              int *lengths, int *numIngress)
+{
+    int numJobs, i;
+
+    *numIngress = _jsonencode_report_ingress_realms_get(options, &encoders[0], &lengths[0]);
+    numJobs = *numIngress;
+    numJobs += _jsonencode_report_egress_realms_get(options, &encoders[numJobs], &lengths[numJobs]);
+
+    for (i = 0; i < numJobs; i++)
+    {
+        if (lengths[i] > BSTJSON_MEMSIZE_REPORT)
+        {
+            lengths[i] = BSTJSON_MEMSIZE_REPORT;
+        }
+    }
+
+    return numJobs;
+}
+
+/******************************************************************
+ * @brief  Returns the room taken by the chunks of all the realms.
+ *
+ *********************************************************************/
+static size_t _bstpar_chunks_length(void)
+{
+    BSTJSON_REPORT_OPTIONS_t options;
+    BSTJSON_REALM_ENCODER_t encoders[_BSTPAR_MAX_JOBS];
+    int lengths[_BSTPAR_MAX_JOBS];
+    size_t total = 0;
+    int numJobs, numIngress, i;
+
+    memset(&options, 0, sizeof(options));
+    options.includeIngressPortPriorityGroup = true;
+    options.includeIngressPortServicePool = true;
+    options.includeIngressServicePool = true;
+    options.includeEgressPortServicePool = true;
+    options.includeEgressServicePool = true;
+    options.includeEgressUcQueue = true;
+    options.includeEgressUcQueueGroup = true;
+    options.includeEgressMcQueue = true;
+    options.includeEgressCpuQueue = true;
+    options.includeEgressRqeQueue = true;
+
+    numJobs = _bstpar_realms_get(&options, encoders, lengths, &numIngress);
+
+    for (i = 0; i < numJobs; i++)
+    {
+        total += (size_t) lengths[i];
+    }
+
+    return total;
+}
+
+/******************************************************************
+ * @brief  Starts the pool of threads encoding the realms of a report.
+ *
+ * @param[in]   numThreads  threads encoding a report, the calling one
+ *                          included, or BSTJSON_PARALLEL_THREADS_AUTO
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ * @retval   BVIEW_STATUS_RESOURCE_NOT_AVAILABLE  if the chunks or any
+ *                                                thread can't be had
+ *
+ * @note     On failure reports are still encoded, serially. If only
+ *           some threads could be started, the pool runs with them.
+ *********************************************************************/
+BVIEW_STATUS bstjson_parallel_init(int numThreads)
+{
+    _BSTPAR_POOL_t *pool = &bstParallelPool;
+    long cpus;
+    int i;
+
+    if (pool->running)
+    {
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    if (BSTJSON_PARALLEL_THREADS_AUTO == numThreads)
+    {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        numThreads = (cpus > 0) ? (int) cpus : 1;
+    }
+
+    if (numThreads > BSTJSON_PARALLEL_MAX_THREADS)
+    {
+        numThreads = BSTJSON_PARALLEL_MAX_THREADS;
+    }
+
+    if (numThreads <= 1)
+    {
+        _BSTPAR_LOG(_BSTPAR_DEBUG_INFO, "BST-PARALLEL : single thread, realms are encoded serially \n");
+        return BVIEW_STATUS_SUCCESS;
+    }
+
+    pool->chunks = malloc(_bstpar_chunks_length());
+    if (NULL == pool->chunks)
+    {
+        _BSTPAR_LOG(_BSTPAR_DEBUG_ERROR, "BST-PARALLEL : no memory for the realm chunks \n");
+        return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    pool->numJobs = 0;
+    pool->nextJob = 0;
+    pool->pending = 0;
+
+    /* the thread asking for a report is one of the encoders */
+    for (i = 0; i < (numThreads - 1); i++)
+    {
+        if (0 != pthread_create(&pool->threads[i], NULL, _bstpar_thread, pool))
+        {
+            _BSTPAR_LOG(_BSTPAR_DEBUG_ERROR, "BST-PARALLEL : failed to create thread %d \n", i);
+            break;
+        }
+        pthread_detach(pool->threads[i]);
+    }
+
+    if (0 == i)
+    {
+        free(pool->chunks);
+        pool->chunks = NULL;
+        return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    /* the threads already started, and the calling one */
+    numThreads = i + 1;
+
+    pool->numThreads = numThreads;
+    pool->running = true;
+
+    _BSTPAR_LOG(_BSTPAR_DEBUG_INFO, "BST-PARALLEL : %d threads encoding reports \n", numThreads);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Returns the number of threads encoding a report.
+ *
+ *********************************************************************/
+int bstjson_parallel_threads_get(void)
+{
+    return bstParallelPool.numThreads;
+}
+
+/******************************************************************
+ * @brief  Encodes the ingress and egress realms of a report in parallel
+ *         and appends them to the report in order.
+ *
+ * @param[in]   writer     Report being written, after its device realm
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ * @retval   BVIEW_STATUS_RESOURCE_NOT_AVAILABLE  if the realms are to be
+ *                                                encoded serially
+ * @retval   status of the first realm failing, in report order
+ *
+ * @note     The other parameters are the ones of the realm encoders.
+ *********************************************************************/
+BVIEW_STATUS bstjson_parallel_encode_realms(JSON_WRITER_t *writer,
+                                            int asicId,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                            const BSTJSON_REPORT_OPTIONS_t *options,
+                                            const BVIEW_ASIC_CAPABILITIES_t *asic)
+{
+    _BSTPAR_POOL_t *pool = &bstParallelPool;
+    BSTJSON_REALM_ENCODER_t encoders[_BSTPAR_MAX_JOBS];
+    int lengths[_BSTPAR_MAX_JOBS];
+    _BSTPAR_JOB_t *job;
+    char *chunk;
+    int numIngress, numEgress, numJobs, i;
+    BVIEW_STATUS status = BVIEW_STATUS_SUCCESS;
+
+    /* a streamed report has to be written in order, as it goes out */
+    if ((false == pool->running) || (NULL != writer->sink))
+    {
+        return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    numJobs = _bstpar_realms_get(options, encoders, lengths, &numIngress);
+    numEgress = numJobs - numIngress;
+
+    if (numJobs < 2)
+    {
+        return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    /* the periodic and the trigger reports may be built at the same time,
+       the one coming second does not wait */
+    if (0 != pthread_mutex_trylock(&pool->busy))
+    {
+        return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+
+    _BSTPAR_LOG(_BSTPAR_DEBUG_TRACE, "BST-PARALLEL : encoding %d realms \n", numJobs);
+
+    pthread_mutex_lock(&pool->lock);
+
+    pool->asicId = asicId;
+    pool->previous = previous;
+    pool->current = current;
+    pool->options = options;
+    pool->asic = asic;
+
+    /* the realms asked for are a subset of all of them, their chunks fit */
+    chunk = pool->chunks;
+    for (i = 0; i < numJobs; i++)
+    {
+        job = &pool->jobs[i];
+        job->encoder = encoders[i];
+        job->status = BVIEW_STATUS_SUCCESS;
+        json_writer_init(&job->writer, chunk, lengths[i]);
+        chunk += lengths[i];
+    }
+
+    pool->numJobs = numJobs;
+    pool->nextJob = 0;
+    pool->pending = numJobs;
+    pthread_cond_broadcast(&pool->workReady);
+
+    /* lend a hand, then wait for the jobs still running */
+    _bstpar_jobs_run(pool);
+    while (pool->pending > 0)
+    {
+        pthread_cond_wait(&pool->workDone, &pool->lock);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+
+    /* only a realm larger than a whole report overflows its chunk,
+       let the serial encoders report it */
+    for (i = 0; i < numJobs; i++)
+    {
+        if (BVIEW_STATUS_OUTOFMEMORY == pool->jobs[i].status)
+        {
+            pthread_mutex_unlock(&pool->busy);
+            _BSTPAR_LOG(_BSTPAR_DEBUG_TRACE, "BST-PARALLEL : realm %d overflowed its chunk \n", i);
+            return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+        }
+    }
+
+    /* stitch the chunks, in the order the serial encoders write them */
+    for (i = 0; i < numJobs; i++)
+    {
+        job = &pool->jobs[i];
+        if (BVIEW_STATUS_SUCCESS != job->status)
+        {
+            status = job->status;
+            break;
+        }
+
+        json_writer_append(writer, job->writer.start, json_writer_length(&job->writer));
+        if (json_writer_overflow(writer))
+        {
+            status = BVIEW_STATUS_OUTOFMEMORY;
+            break;
+        }
+
+        /* the last ingress realm keeps its ',' only if egress realms follow */
+        if ((i == (numIngress - 1)) && (0 == numEgress))
+        {
+            json_writer_backup(writer, 1);
+        }
+    }
+
+    pthread_mutex_unlock(&pool->busy);
+
+    if (BVIEW_STATUS_SUCCESS != status)
+    {
+        _BSTPAR_LOG(_BSTPAR_DEBUG_TRACE, "BST-PARALLEL : realm %d failed with %d \n", i, status);
+        return status;
+    }
+
+    /* drop the trailing ',' of the last egress realm */
+    if (numEgress > 0)
+    {
+        json_writer_backup(writer, 1);
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
@@ -0,0 +1,74 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BST_JSON_PARALLEL_H
+#define	INCLUDE_BST_JSON_PARALLEL_H
+
+#include "broadview.h"
+#include "json_writer.h"
+#include "bst.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "bst_json_encoder.h"
+
+#ifdef	__cplusplus
+extern "C"
+{
+#endif
+
+/* Parallel encoding of the realms of a report.
+ *
+ * Every realm asked for is encoded into a chunk of its own by a small pool
+ * of threads, the calling thread being one of them. The chunks are then
+ * appended to the report in the order of the realms, so the text is the
+ * same as the one of the serial encoders.
+ */
+
+/* Most threads encoding a report, the calling one included */
+#define BSTJSON_PARALLEL_MAX_THREADS       4
+
+/* Pick the number of threads from the processors online */
+#define BSTJSON_PARALLEL_THREADS_AUTO      0
+
+/* Starts the pool with 'numThreads' threads (BSTJSON_PARALLEL_THREADS_AUTO
+ * to size it on the processors). With a single thread there is no pool and
+ * reports are encoded serially. If fewer threads can be started, the pool
+ * runs with those. Later calls keep the running pool. */
+BVIEW_STATUS bstjson_parallel_init(int numThreads);
+
+/* Returns the number of threads encoding a report, 1 if there is no pool */
+int bstjson_parallel_threads_get(void);
+
+/* Encodes the ingress and egress realms asked for in 'options' into 'writer',
+ * exactly as _jsonencode_report_ingress() and _jsonencode_report_egress()
+ * would. Returns BVIEW_STATUS_RESOURCE_NOT_AVAILABLE, with nothing written,
+ * when the realms are better encoded serially : no pool, pool in use by
+ * another report, streamed report, fewer than two realms or a realm
+ * larger than its chunk. */
+BVIEW_STATUS bstjson_parallel_encode_realms(JSON_WRITER_t *writer,
+                                            int asicId,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *previous,
+                                            const BVIEW_BST_ASIC_SNAPSHOT_DATA_t *current,
+                                            const BSTJSON_REPORT_OPTIONS_t *options,
+                                            const BVIEW_ASIC_CAPABILITIES_t *asic);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* INCLUDE_BST_JSON_PARALLEL_H */
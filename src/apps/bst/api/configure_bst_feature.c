@@ -49,7 +49,9 @@ BVIEW_STATUS bstjson_configure_bst_feature (void *cookie, char *jsonBuffer, int
     cJSON *json_id, *json_bstEnable, *json_sendAsyncReports;
     cJSON *json_collectionInterval, *json_statUnitsInCells,  *root, *params;
     cJSON *json_maxTriggerReports, *json_sendSnapshotTrigger,  *json_triggerTransmitInterval, *json_sendIncrementalReport;
-    cJSON *json_statsInPercentage;
+    cJSON *json_statsInPercentage, *json_reportFormat, *json_reportFilter;
+    cJSON *json_reportLayout, *json_keyframeInterval, *json_reportResync;
+    cJSON *json_coalesceWindow;
 
     /* Local non-command-parameter JSON variable declarations */
     char jsonrpc[JSON_MAX_NODE_LENGTH] = {0};
@@ -227,6 +229,87 @@ BVIEW_STATUS bstjson_configure_bst_feature (void *cookie, char *jsonBuffer, int
       command.configMask = (command.configMask | (1 << BST_CONFIG_PARAMS_STATS_IN_PERCENT));
     }
 
+    /* Parsing and Validating 'report-format' from JSON buffer */
+    json_reportFormat = cJSON_GetObjectItem(params, "report-format");
+    if (NULL != json_reportFormat)
+    {
+      JSON_VALIDATE_JSON_POINTER(json_reportFormat, "report-format", BVIEW_STATUS_INVALID_JSON);
+      JSON_VALIDATE_JSON_AS_NUMBER(json_reportFormat, "report-format");
+      /* Copy the value */
+      command.reportFormat = json_reportFormat->valueint;
+      /* Ensure  that the number 'report-format' is within range of [0,1] (json, binary) */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.reportFormat, BST_REPORT_FORMAT_JSON, BST_REPORT_FORMAT_BINARY);
+      command.configMask = (command.configMask | (1 << BST_CONFIG_PARAMS_REPORT_FORMAT));
+    }
+
+    /* Parsing and Validating 'report-layout' from JSON buffer */
+    json_reportLayout = cJSON_GetObjectItem(params, "report-layout");
+    if (NULL != json_reportLayout)
+    {
+      JSON_VALIDATE_JSON_POINTER(json_reportLayout, "report-layout", BVIEW_STATUS_INVALID_JSON);
+      JSON_VALIDATE_JSON_AS_NUMBER(json_reportLayout, "report-layout");
+      /* Copy the value */
+      command.reportLayout = json_reportLayout->valueint;
+      /* Ensure  that the number 'report-layout' is within range of [0,1] (sparse, adaptive) */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.reportLayout, BST_REPORT_LAYOUT_SPARSE, BST_REPORT_LAYOUT_ADAPTIVE);
+      command.configMask = (command.configMask | (1 << BST_CONFIG_PARAMS_REPORT_LAYOUT));
+    }
+
+    /* Parsing and Validating 'report-filter' from JSON buffer, an empty object clears the filter */
+    json_reportFilter = cJSON_GetObjectItem(params, "report-filter");
+    if (NULL != json_reportFilter)
+    {
+      status = bstjson_filter_parse(json_reportFilter, &command.reportFilter);
+      if (BVIEW_STATUS_SUCCESS != status)
+      {
+        cJSON_Delete(root);
+        return status;
+      }
+      command.configMask = (command.configMask | (1 << BST_CONFIG_PARAMS_REPORT_FILTER));
+    }
+
+    /* Parsing and Validating 'keyframe-interval' from JSON buffer */
+    json_keyframeInterval = cJSON_GetObjectItem(params, "keyframe-interval");
+    if (NULL != json_keyframeInterval)
+    {
+      JSON_VALIDATE_JSON_POINTER(json_keyframeInterval, "keyframe-interval", BVIEW_STATUS_INVALID_JSON);
+      JSON_VALIDATE_JSON_AS_NUMBER(json_keyframeInterval, "keyframe-interval");
+      /* Copy the value */
+      command.keyframeInterval = json_keyframeInterval->valueint;
+      /* Ensure  that the number 'keyframe-interval' is within range, 0 for keyframes on resync only */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.keyframeInterval, 0, 10000);
+      command.configMask = (command.configMask | (1 << BST_CONFIG_PARAMS_KEYFRAME_INTVL));
+    }
+
+    /* Parsing and Validating 'report-resync' from JSON buffer */
+    json_reportResync = cJSON_GetObjectItem(params, "report-resync");
+    if (NULL != json_reportResync)
+    {
+      JSON_VALIDATE_JSON_POINTER(json_reportResync, "report-resync", BVIEW_STATUS_INVALID_JSON);
+      JSON_VALIDATE_JSON_AS_NUMBER(json_reportResync, "report-resync");
+      /* Copy the value */
+      command.reportResync = json_reportResync->valueint;
+      /* Ensure  that the number 'report-resync' is within range of [0,1] */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.reportResync, 0, 1);
+      if (1 == command.reportResync)
+      {
+        command.configMask = (command.configMask | (1 << BST_CONFIG_PARAMS_REPORT_RESYNC));
+      }
+    }
+
+    /* Parsing and Validating 'coalesce-window' from JSON buffer */
+    json_coalesceWindow = cJSON_GetObjectItem(params, "coalesce-window");
+    if (NULL != json_coalesceWindow)
+    {
+      JSON_VALIDATE_JSON_POINTER(json_coalesceWindow, "coalesce-window", BVIEW_STATUS_INVALID_JSON);
+      JSON_VALIDATE_JSON_AS_NUMBER(json_coalesceWindow, "coalesce-window");
+      /* Copy the value */
+      command.coalesceWindow = json_coalesceWindow->valueint;
+      /* Ensure  that the number 'coalesce-window' is within range of [0,1000] milli seconds */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.coalesceWindow, 0, 1000);
+      command.configMask = (command.configMask | (1 << BST_CONFIG_PARAMS_COALESCE_WINDOW));
+    }
+
     /* Send the 'command' along with 'asicId' and 'cookie' to the Application thread. */
     status = bstjson_configure_bst_feature_impl (cookie, asicId, id, &command);
 
@@ -34,6 +34,7 @@ extern "C"
 #include "json.h"
 
 #include "cJSON.h"
+#include "bst_json_filter.h"
 
 typedef enum _bst_config_param_mask_pos_
 {
@@ -45,9 +46,29 @@ typedef enum _bst_config_param_mask_pos_
   BST_CONFIG_PARAMS_SND_SNAP_TGR,
   BST_CONFIG_PARAMS_TGR_RL_INTVL,
   BST_CONFIG_PARAMS_ASYNC_FULL_REP,
-  BST_CONFIG_PARAMS_STATS_IN_PERCENT
+  BST_CONFIG_PARAMS_STATS_IN_PERCENT,
+  BST_CONFIG_PARAMS_REPORT_FORMAT,
+  BST_CONFIG_PARAMS_REPORT_FILTER,
+  BST_CONFIG_PARAMS_REPORT_LAYOUT,
+  BST_CONFIG_PARAMS_KEYFRAME_INTVL,
+  BST_CONFIG_PARAMS_REPORT_RESYNC,
+  BST_CONFIG_PARAMS_COALESCE_WINDOW
 }BST_CONFIG_PARAM_MASK_t;
 
+/* Encodings a report can be sent in */
+typedef enum _bst_report_format_
+{
+  BST_REPORT_FORMAT_JSON = 0,
+  BST_REPORT_FORMAT_BINARY
+}BST_REPORT_FORMAT_t;
+
+/* Layouts of the realm data in a JSON report */
+typedef enum _bst_report_layout_
+{
+  BST_REPORT_LAYOUT_SPARSE = 0,
+  BST_REPORT_LAYOUT_ADAPTIVE
+}BST_REPORT_LAYOUT_t;
+
 /* Structure to pass API parameters to the BST APP */
 typedef struct _bstjson_configure_bst_feature_
 {
@@ -60,6 +81,16 @@ typedef struct _bstjson_configure_bst_feature_
     int sendSnapshotOnTrigger;
     int triggerTransmitInterval;
     int sendIncrementalReport;
+    int reportFormat;
+    /* entries of the periodic reports */
+    BSTJSON_REPORT_FILTER_t reportFilter;
+    int reportLayout;
+    /* periodic reports between two keyframes */
+    int keyframeInterval;
+    /* next periodic report is a keyframe, not stored; on a get, 1 while it still is */
+    int reportResync;
+    /* milli seconds a get-bst-report collection is shared for */
+    int coalesceWindow;
     int configMask;
 } BSTJSON_CONFIGURE_BST_FEATURE_t;
 
@@ -50,6 +50,7 @@ BVIEW_STATUS bstjson_get_bst_report (void *cookie, char *jsonBuffer, int bufLeng
     cJSON *json_includeIngressServicePool, *json_includeEgressPortServicePool, *json_includeEgressServicePool;
     cJSON *json_includeEgressUcQueue, *json_includeEgressUcQueueGroup, *json_includeEgressMcQueue;
     cJSON *json_includeEgressCpuQueue, *json_includeEgressRqeQueue, *json_includeDevice;
+    cJSON *json_reportFormat, *json_reportFilter, *json_reportLayout;
     cJSON  *root, *params;
 
     /* Local non-command-parameter JSON variable declarations */
@@ -234,6 +235,45 @@ BVIEW_STATUS bstjson_get_bst_report (void *cookie, char *jsonBuffer, int bufLeng
     JSON_CHECK_VALUE_AND_CLEANUP (command.includeDevice, 0, 1);
 
 
+    /* Parsing and Validating 'report-format' from JSON buffer, the configured one is used if absent */
+    command.reportFormat = BSTJSON_REPORT_FORMAT_CONFIGURED;
+    json_reportFormat = cJSON_GetObjectItem(params, "report-format");
+    if (NULL != json_reportFormat)
+    {
+      JSON_VALIDATE_JSON_AS_NUMBER(json_reportFormat, "report-format");
+      /* Copy the value */
+      command.reportFormat = json_reportFormat->valueint;
+      /* Ensure  that the number 'report-format' is within range of [0,1] */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.reportFormat, 0, 1);
+    }
+
+
+    /* Parsing and Validating 'report-layout' from JSON buffer, the configured one is used if absent */
+    command.reportLayout = BSTJSON_REPORT_LAYOUT_CONFIGURED;
+    json_reportLayout = cJSON_GetObjectItem(params, "report-layout");
+    if (NULL != json_reportLayout)
+    {
+      JSON_VALIDATE_JSON_AS_NUMBER(json_reportLayout, "report-layout");
+      /* Copy the value */
+      command.reportLayout = json_reportLayout->valueint;
+      /* Ensure  that the number 'report-layout' is within range of [0,1] */
+      JSON_CHECK_VALUE_AND_CLEANUP (command.reportLayout, 0, 1);
+    }
+
+
+    /* Parsing and Validating 'report-filter' from JSON buffer, the report is not filtered if absent */
+    json_reportFilter = cJSON_GetObjectItem(params, "report-filter");
+    if (NULL != json_reportFilter)
+    {
+      status = bstjson_filter_parse(json_reportFilter, &command.filter);
+      if (BVIEW_STATUS_SUCCESS != status)
+      {
+        cJSON_Delete(root);
+        return status;
+      }
+    }
+
+
     /* Send the 'command' along with 'asicId' and 'cookie' to the Application thread. */
     status = bstjson_get_bst_report_impl (cookie, asicId, id,&command);
 
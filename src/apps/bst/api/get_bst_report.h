@@ -34,6 +34,13 @@ extern "C"
 #include "json.h"
 
 #include "cJSON.h"
+#include "bst_json_filter.h"
+
+/* 'reportFormat' of a request that does not ask for one */
+#define BSTJSON_REPORT_FORMAT_CONFIGURED    (-1)
+
+/* 'reportLayout' of a request that does not ask for one */
+#define BSTJSON_REPORT_LAYOUT_CONFIGURED    (-1)
 
 /* Structure to pass API parameters to the BST APP */
 typedef struct _bstjson_get_bst_report_
@@ -49,6 +56,10 @@ typedef struct _bstjson_get_bst_report_
     int includeEgressCpuQueue;
     int includeEgressRqeQueue;
     int includeDevice;
+    int reportFormat;
+    int reportLayout;
+    /* entries to report, not filtered if absent */
+    BSTJSON_REPORT_FILTER_t filter;
 } BSTJSON_GET_BST_REPORT_t;
 
 
@@ -81,6 +81,7 @@ BVIEW_STATUS bst_config_feature_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
   BVIEW_BST_CONFIG_t bstMode;
   BVIEW_BST_CONFIG_PARAMS_t *ptr;
   bool timerUpdateReqd = false;
+  bool resyncReqd = false;
   int tmpMask = 0;
   int interval = BVIEW_BST_DEFAULT_PLUGIN_INTERVAL;
 
@@ -172,6 +173,7 @@ BVIEW_STATUS bst_config_feature_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
   {
     /* Store the data is desired in bytes or cells */
     ptr->statUnitsInCells = msg_data->request.config.statUnitsInCells;
+    resyncReqd = true;
   }
 
 
@@ -180,6 +182,44 @@ BVIEW_STATUS bst_config_feature_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
   {
     /* Store the data is desired in percentage */
     ptr->statsInPercentage = msg_data->request.config.statsInPercentage;
+    resyncReqd = true;
+  }
+
+  if (tmpMask & (1 << BST_CONFIG_PARAMS_REPORT_FORMAT))
+  {
+    /* encoding of the reports sent to the collector */
+    ptr->reportFormat = msg_data->request.config.reportFormat;
+  }
+
+  if (tmpMask & (1 << BST_CONFIG_PARAMS_REPORT_LAYOUT))
+  {
+    /* layout of the realm data in the JSON reports */
+    ptr->reportLayout = msg_data->request.config.reportLayout;
+  }
+
+  if (tmpMask & (1 << BST_CONFIG_PARAMS_REPORT_FILTER))
+  {
+    /* entries of the periodic reports, an empty filter reports all */
+    ptr->reportFilter = msg_data->request.config.reportFilter;
+    resyncReqd = true;
+  }
+
+  if (tmpMask & (1 << BST_CONFIG_PARAMS_KEYFRAME_INTVL))
+  {
+    /* periodic reports between two keyframes */
+    ptr->keyframeInterval = msg_data->request.config.keyframeInterval;
+  }
+
+  if (tmpMask & (1 << BST_CONFIG_PARAMS_COALESCE_WINDOW))
+  {
+    /* freshness window of the get-bst-report collections */
+    ptr->coalesceWindow = msg_data->request.config.coalesceWindow;
+  }
+
+  if (tmpMask & (1 << BST_CONFIG_PARAMS_REPORT_RESYNC))
+  {
+    /* the collector asks for a keyframe */
+    resyncReqd = true;
   }
 
   if ((0 == ptr->collectionInterval) || 
@@ -195,6 +235,13 @@ BVIEW_STATUS bst_config_feature_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
 
   BST_RWLOCK_UNLOCK(msg_data->unit);
 
+  /* the periodic reports no longer carry what the collector holds,
+     start the incremental stream over with a keyframe */
+  if (true == resyncReqd)
+  {
+    bst_consumer_resync (msg_data->unit);
+  }
+
   if (!(tmpMask & (1 << BST_CONFIG_PARAMS_ENABLE)))
   {
     /* bst not enabled in config.
@@ -244,12 +291,14 @@ BVIEW_STATUS bst_config_feature_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
 * @retval  : BVIEW_STATUS_SUCCESS : when the bst feature params is 
 *                                   retrieved successfully.
 *
-* @note
+* @note : report-resync is not stored, it is reported as 1 while the
+*         next periodic report is a keyframe.
 *
 *********************************************************************/
 BVIEW_STATUS bst_config_feature_get (BVIEW_BST_REQUEST_MSG_t * msg_data)
 {
   BVIEW_BST_CONFIG_PARAMS_t *ptr;
+  BVIEW_BST_UNIT_CXT_t *unit_ptr;
 
 
   if (NULL == msg_data)
@@ -262,6 +311,13 @@ BVIEW_STATUS bst_config_feature_get (BVIEW_BST_REQUEST_MSG_t * msg_data)
   {
     return BVIEW_STATUS_INVALID_PARAMETER;
   }
+
+  unit_ptr = BST_UNIT_PTR_GET (msg_data->unit);
+  BST_LOCK_TAKE (msg_data->unit);
+  ptr->reportResync =
+    (false == unit_ptr->consumers[BVIEW_BST_CONSUMER_PERIODIC].valid) ? 1 : 0;
+  BST_LOCK_GIVE (msg_data->unit);
+
   return  BVIEW_STATUS_SUCCESS;
 }
 
@@ -481,6 +537,85 @@ BVIEW_STATUS system_switch_properties_get (BVIEW_BST_REQUEST_MSG_t * msg_data)
   return BVIEW_STATUS_SUCCESS;
 }
 
+/*********************************************************************
+* @brief : tells if the last collection is recent enough to be shared.
+*
+* @param[in] cache    : report cache of the unit
+* @param[in] windowMs : freshness window in milli seconds, 0 for none
+*
+* @retval  : true if the active record holds a collection of the window
+*
+*********************************************************************/
+static bool bst_report_cache_fresh (const BVIEW_BST_REPORT_CACHE_t *cache,
+                                    int windowMs)
+{
+  struct timespec now;
+  long long elapsedMs;
+
+  if ((0 >= windowMs) || (false == cache->collected))
+  {
+    return false;
+  }
+
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  elapsedMs = ((long long) (now.tv_sec - cache->collectTime.tv_sec) * 1000) +
+              ((now.tv_nsec - cache->collectTime.tv_nsec) / 1000000);
+
+  return (elapsedMs < windowMs);
+}
+
+/*********************************************************************
+* @brief : copies an encoded report into a buffer of the report pool.
+*
+* @param[in]  buffer  : encoded report
+* @param[in]  length  : number of bytes in the report
+* @param[out] pCopy   : copy, to be freed with bstjson_memory_free()
+*
+* @retval  : BVIEW_STATUS_SUCCESS : report copied
+* @retval  : BVIEW_STATUS_OUTOFMEMORY : no buffer available
+*
+*********************************************************************/
+static BVIEW_STATUS bst_report_buffer_copy (const uint8_t *buffer, int length,
+                                            uint8_t **pCopy)
+{
+  BVIEW_STATUS rv;
+
+  rv = bstjson_memory_allocate (BSTJSON_MEMSIZE_REPORT, pCopy);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    return rv;
+  }
+
+  memcpy (*pCopy, buffer, length);
+  /* JSON reports are strings */
+  if (length < BSTJSON_MEMSIZE_REPORT)
+  {
+    (*pCopy)[length] = 0;
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : frees the report encoded from the last collection.
+*
+* @param[in] cache : report cache of the unit
+*
+* @note : to be called with the unit lock held.
+*
+*********************************************************************/
+static void bst_report_cache_release (BVIEW_BST_REPORT_CACHE_t *cache)
+{
+  /* whatever gets encoded from now on belongs to a new collection */
+  cache->generation++;
+
+  if (NULL != cache->buffer)
+  {
+    bstjson_memory_free (cache->buffer);
+    cache->buffer = NULL;
+    cache->length = 0;
+  }
+}
+
 /*********************************************************************
 * @brief : application function to get the bst report and thresholds 
 *
@@ -501,6 +636,8 @@ BVIEW_STATUS bst_get_report (BVIEW_BST_REQUEST_MSG_t * msg_data)
   BVIEW_BST_TRACK_PARAMS_t *track_ptr;
   BVIEW_BST_CONFIG_PARAMS_t *config_ptr;
   BVIEW_TIME_t  curr_time;   
+  /* only the bst thread collects */
+  static BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t max_buffers;
  
   if (NULL == msg_data)
   {
@@ -532,15 +669,51 @@ BVIEW_STATUS bst_get_report (BVIEW_BST_REQUEST_MSG_t * msg_data)
   if ((BVIEW_BST_CMD_API_GET_REPORT == msg_data->msg_type) ||
       (BVIEW_BST_CMD_API_TRIGGER_REPORT == msg_data->msg_type))
   {
-    /* collect data.. since the data is huge.. give the current record 
-       memory pointer directly so that we can avoid, copy */
+    bool getReport = ((BVIEW_BST_STATS_PERIODIC != msg_data->report_type) &&
+                      (BVIEW_BST_STATS_TRIGGER != msg_data->report_type));
+
+    /* a report of an earlier collection may still be encoded
+       from the record collected into */
+    bst_pipeline_record_wait (msg_data->unit, ptr->stats_current_record_ptr);
+
     BST_LOCK_TAKE (msg_data->unit);
-    ss = ptr->stats_current_record_ptr;
-    /* before we collect data..ensure there is no garbage.. 
-     */
-    memset (ss, 0,
-        sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
-    rv = sbapi_bst_snapshot_get (msg_data->unit, &ss->snapshot_data, &ss->tv);
+    ptr->report_cache.reuse = false;
+    if ((true == getReport) &&
+        (true == bst_report_cache_fresh (&ptr->report_cache, config_ptr->coalesceWindow)))
+    {
+      /* collected a moment ago, the active record is still fresh.
+         the request shares it, and the records are not rotated */
+      ptr->report_cache.reuse = true;
+      ptr->report_cache.stats.collectHits++;
+    }
+    else
+    {
+      /* collect data.. since the data is huge.. give the current record 
+         memory pointer directly so that we can avoid, copy */
+      ss = ptr->stats_current_record_ptr;
+      /* before we collect data..ensure there is no garbage.. 
+       */
+      memset (ss, 0,
+          sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
+      rv = sbapi_bst_snapshot_get (msg_data->unit, &ss->snapshot_data, &ss->tv);
+      if (BVIEW_STATUS_NOTREADY == rv)
+      {
+        /* the south bound is resyncing, the snapshot holds the last
+           data it had. it is reported, marked stale */
+        ss->stale = true;
+        rv = BVIEW_STATUS_SUCCESS;
+      }
+
+      /* the collection becomes the active record, the report
+         encoded from the previous one is stale */
+      bst_report_cache_release (&ptr->report_cache);
+      ptr->report_cache.collected = (BVIEW_STATUS_SUCCESS == rv);
+      clock_gettime (CLOCK_MONOTONIC, &ptr->report_cache.collectTime);
+      if (true == getReport)
+      {
+        ptr->report_cache.stats.collectMisses++;
+      }
+    }
     BST_LOCK_GIVE (msg_data->unit);
 
     if (BVIEW_STATUS_SUCCESS != rv)
@@ -552,11 +725,22 @@ BVIEW_STATUS bst_get_report (BVIEW_BST_REQUEST_MSG_t * msg_data)
     }
 
 	/* check if stats are requested in percentage format.
-	    if yes, then retrieve the default/max buffers allocated from ASIC */
-    if (true == config_ptr->statsInPercentage)
+	    if yes, then retrieve the default/max buffers allocated from ASIC.
+	    a shared collection shares the max buffers read with it */
+    if ((true == config_ptr->statsInPercentage) &&
+        ((false == ptr->report_cache.reuse) || (false == ptr->bst_convert_table->valid)))
 	{
-       sbapi_system_max_buf_snapshot_get (msg_data->unit, &ptr->bst_max_buffers,
+       sbapi_system_max_buf_snapshot_get (msg_data->unit, &max_buffers,
                                           &curr_time);
+       /* refresh the percentage factors, if the settings have changed.
+          the reports in the pipeline read them, let them go first */
+       if ((false == ptr->bst_convert_table->valid) ||
+           (0 != memcmp (&max_buffers, &ptr->bst_max_buffers, sizeof (max_buffers))))
+       {
+         bst_pipeline_unit_drain (msg_data->unit);
+         memcpy (&ptr->bst_max_buffers, &max_buffers, sizeof (max_buffers));
+         bstjson_convert_table_update (ptr->bst_convert_table, &ptr->bst_max_buffers);
+       }
 	}
 
     if (BVIEW_BST_CMD_API_TRIGGER_REPORT == msg_data->msg_type)
@@ -573,7 +757,9 @@ BVIEW_STATUS bst_get_report (BVIEW_BST_REQUEST_MSG_t * msg_data)
        thresholds. assumption is that threshold get is called very sparingly,
        where as report is quite often.. so one record is enough.. 
        since we have single record, don't want a read while collecting the  information.
-       so protect the same */
+       so protect the same. the previous threshold report may still be
+       encoded from it */
+    bst_pipeline_record_wait (msg_data->unit, ptr->threshold_record_ptr);
     BST_LOCK_TAKE (msg_data->unit);
     /* make sure no garbage.. */
     memset (&ptr->threshold_record_ptr->snapshot_data, 0, sizeof(BVIEW_BST_ASIC_SNAPSHOT_DATA_t));
@@ -867,6 +1053,7 @@ BVIEW_STATUS bst_clear_threshold_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
   rv = sbapi_bst_clear_thresholds (msg_data->unit);
   if (BVIEW_STATUS_SUCCESS == rv)
   {
+    bst_pipeline_record_wait (msg_data->unit, ptr->threshold_record_ptr);
     BST_LOCK_TAKE (msg_data->unit);
     /* threshold clear is successful.. clear the record as well */
     memset (ptr->threshold_record_ptr, 0, 
@@ -908,6 +1095,8 @@ BVIEW_STATUS bst_clear_stats_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
     return BVIEW_STATUS_INVALID_PARAMETER;
 
   ptr = BST_UNIT_PTR_GET (msg_data->unit);
+  /* the reports in the pipeline read the records */
+  bst_pipeline_unit_drain (msg_data->unit);
   /* take the lock */
   BST_LOCK_TAKE (msg_data->unit);
   /* stats clear  */
@@ -920,6 +1109,11 @@ BVIEW_STATUS bst_clear_stats_set (BVIEW_BST_REQUEST_MSG_t * msg_data)
   /* release the lock */
   BST_LOCK_GIVE (msg_data->unit);
 
+  /* the baselines are no longer what the counters grow from */
+  bst_consumer_resync (msg_data->unit);
+  /* nor is the last collection what the counters are */
+  bst_report_cache_invalidate (msg_data->unit);
+
   /* clear in asic as well*/
 
   rv = sbapi_bst_clear_stats (msg_data->unit);
@@ -980,6 +1174,277 @@ BVIEW_STATUS bst_update_data (BVIEW_BST_REPORT_TYPE_t type, unsigned int unit)
   return BVIEW_STATUS_SUCCESS;
 }
 
+/*********************************************************************
+* @brief : picks the baseline of the next report of a consumer.
+*
+* @param[in]  unit        : unit number
+* @param[in]  id          : consumer
+* @param[in]  active      : snapshot the report carries
+* @param[in]  incremental : consumer takes incremental reports
+* @param[out] pBaseline   : snapshot the report is a difference to,
+*                           NULL for a keyframe
+* @param[out] pSequence   : sequence number of the report
+* @param[out] pKeyframe   : true if the report is a keyframe
+*
+* @retval  : BVIEW_STATUS_SUCCESS : baseline picked
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : Each consumer keeps a copy of the snapshot it was last sent,
+*         so the reports pulled in between (get-bst-report, triggers)
+*         do not move its baseline. A keyframe is sent on the first
+*         report, after a resync and every 'keyframeInterval' reports.
+*
+*********************************************************************/
+BVIEW_STATUS bst_consumer_report_prepare (unsigned int unit,
+                                          BVIEW_BST_CONSUMER_ID_t id,
+                                          const BVIEW_BST_REPORT_SNAPSHOT_t *active,
+                                          bool incremental,
+                                          BVIEW_BST_REPORT_SNAPSHOT_t **pBaseline,
+                                          uint64_t *pSequence,
+                                          bool *pKeyframe)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_BST_CONSUMER_t *consumer;
+  unsigned int interval;
+  bool keyframe;
+  int next;
+
+  if ((id >= BVIEW_BST_CONSUMER_MAX) || (NULL == active) ||
+      (NULL == pBaseline) || (NULL == pSequence) || (NULL == pKeyframe))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  ptr = BST_UNIT_PTR_GET (unit);
+  consumer = &ptr->consumers[id];
+  interval = ptr->bst_data->bst_config.config.keyframeInterval;
+
+  /* the previous report may still be encoded from the buffer
+     copied into below */
+  bst_pipeline_record_wait (unit, consumer->baseline[1 - consumer->current]);
+
+  BST_LOCK_TAKE (unit);
+
+  keyframe = ((false == incremental) || (false == consumer->valid) ||
+              ((0 != interval) && ((consumer->sinceKeyframe + 1) >= interval)));
+
+  /* the report is a difference to what the consumer was last sent */
+  *pBaseline = (true == keyframe) ? NULL : consumer->baseline[consumer->current];
+
+  /* what is sent now is the baseline of the next report. the other
+     buffer is free, the current one is still needed for this report */
+  next = 1 - consumer->current;
+  memcpy (consumer->baseline[next], active, sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
+  consumer->current = next;
+  consumer->valid = true;
+  consumer->sinceKeyframe = (true == keyframe) ? 0 : (consumer->sinceKeyframe + 1);
+  *pSequence = ++consumer->sequenceNumber;
+  *pKeyframe = keyframe;
+
+  BST_LOCK_GIVE (unit);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : makes the next report of every consumer a keyframe.
+*
+* @param[in] unit : unit number
+*
+* @retval  : BVIEW_STATUS_SUCCESS : next reports are keyframes
+*
+* @note : called when the baselines no longer match what the consumers
+*         hold, i.e. on clear stats, or on a change of what the reports
+*         carry. The sequence numbers keep growing.
+*
+*********************************************************************/
+BVIEW_STATUS bst_consumer_resync (unsigned int unit)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  int id;
+
+  ptr = BST_UNIT_PTR_GET (unit);
+
+  BST_LOCK_TAKE (unit);
+  for (id = 0; id < BVIEW_BST_CONSUMER_MAX; id++)
+  {
+    ptr->consumers[id].valid = false;
+  }
+  BST_LOCK_GIVE (unit);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : finds the encoded report of the last collection.
+*
+* @param[in]  unit     : unit number
+* @param[in]  options  : options of the report to send
+* @param[in]  generation : collection the report is to be encoded from
+* @param[out] pBuffer  : copy of the encoded report, to be freed with
+*                        bstjson_memory_free()
+* @param[out] pLength  : number of bytes in the report
+*
+* @retval  : true if a report encoded with the same options is cached
+*
+* @note : to be called with the unit lock held. The options are
+*         compared byte for byte, both copies come from zeroed
+*         response messages. The cached report may be freed by the
+*         next collection, so the caller gets a copy.
+*
+*********************************************************************/
+bool bst_report_cache_lookup (unsigned int unit,
+                              const BVIEW_BST_REPORT_OPTIONS_t *options,
+                              uint64_t generation,
+                              uint8_t **pBuffer, int *pLength)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_BST_REPORT_CACHE_t *cache;
+
+  ptr = BST_UNIT_PTR_GET (unit);
+  cache = &ptr->report_cache;
+
+  if ((NULL == cache->buffer) || (generation != cache->generation) ||
+      (0 != memcmp (&cache->options, options, sizeof (BVIEW_BST_REPORT_OPTIONS_t))) ||
+      (BVIEW_STATUS_SUCCESS != bst_report_buffer_copy (cache->buffer, cache->length, pBuffer)))
+  {
+    cache->stats.encodeMisses++;
+    return false;
+  }
+
+  cache->stats.encodeHits++;
+  *pLength = cache->length;
+  return true;
+}
+
+/*********************************************************************
+* @brief : keeps the encoded report of the last collection.
+*
+* @param[in] unit    : unit number
+* @param[in] options : options the report was encoded with
+* @param[in] generation : collection the report was encoded from
+* @param[in] buffer  : encoded report, the cache keeps a copy
+* @param[in] length  : number of bytes in the report
+*
+* @note : to be called with the unit lock held. Only the last report
+*         is kept, requests with other options encode their own. A
+*         report of an older collection is not kept.
+*
+*********************************************************************/
+void bst_report_cache_store (unsigned int unit,
+                             const BVIEW_BST_REPORT_OPTIONS_t *options,
+                             uint64_t generation,
+                             const uint8_t *buffer, int length)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+  BVIEW_BST_REPORT_CACHE_t *cache;
+  uint8_t *copy;
+
+  ptr = BST_UNIT_PTR_GET (unit);
+  cache = &ptr->report_cache;
+
+  /* collected again while the report was encoded */
+  if (generation != cache->generation)
+  {
+    return;
+  }
+
+  if (BVIEW_STATUS_SUCCESS != bst_report_buffer_copy (buffer, length, &copy))
+  {
+    return;
+  }
+
+  /* replaces the report of the same collection */
+  if (NULL != cache->buffer)
+  {
+    bstjson_memory_free (cache->buffer);
+  }
+  cache->buffer = copy;
+  cache->length = length;
+  memcpy (&cache->options, options, sizeof (BVIEW_BST_REPORT_OPTIONS_t));
+}
+
+/*********************************************************************
+* @brief : drops the last collection, the next request collects.
+*
+* @param[in] unit : unit number
+*
+* @retval  : BVIEW_STATUS_SUCCESS : cache dropped
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_cache_invalidate (unsigned int unit)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+
+  ptr = BST_UNIT_PTR_GET (unit);
+
+  BST_LOCK_TAKE (unit);
+  bst_report_cache_release (&ptr->report_cache);
+  ptr->report_cache.collected = false;
+  BST_LOCK_GIVE (unit);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : reads the hit and miss counters of the report cache.
+*
+* @param[in]  unit   : unit number
+* @param[out] pStats : counters
+*
+* @retval  : BVIEW_STATUS_SUCCESS : counters read
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_cache_stats_get (unsigned int unit,
+                                         BVIEW_BST_REPORT_CACHE_STATS_t *pStats)
+{
+  BVIEW_BST_UNIT_CXT_t *ptr;
+
+  if ((unit >= BVIEW_BST_MAX_UNITS) || (NULL == pStats))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  ptr = BST_UNIT_PTR_GET (unit);
+
+  BST_LOCK_TAKE (unit);
+  *pStats = ptr->report_cache.stats;
+  BST_LOCK_GIVE (unit);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : dumps the hit and miss counters of the report cache of
+*          each unit.
+*
+* @param[in] : none
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_report_cache_stats_dump (void)
+{
+  BVIEW_BST_REPORT_CACHE_STATS_t stats;
+  int unit, num_units = 0;
+
+  if (BVIEW_STATUS_SUCCESS != sbapi_system_num_units_get (&num_units))
+  {
+    return;
+  }
+
+  for (unit = 0; unit < num_units; unit++)
+  {
+    if (BVIEW_STATUS_SUCCESS !=
+        bst_report_cache_stats_get ((unsigned int) unit, &stats))
+    {
+      continue;
+    }
+    printf (" Unit %d : Collect Hits %" PRIu64 " -- Collect Misses %" PRIu64
+            " -- Encode Hits %" PRIu64 " -- Encode Misses %" PRIu64 " \n",
+            unit, stats.collectHits, stats.collectMisses,
+            stats.encodeHits, stats.encodeMisses);
+  }
+  printf ("\n");
+}
+
 /*********************************************************************
 * @brief :  function to register with module mgr
 *
@@ -62,6 +62,14 @@ extern "C" {
 #define BVIEW_BST_DEFAULT_INTERVAL  60
 #define BVIEW_BST_DEFAULT_STATS_UNITS  true
 #define BVIEW_BST_DEFAULT_STATS_PERCENTAGE false 
+#define BVIEW_BST_DEFAULT_REPORT_FORMAT   BST_REPORT_FORMAT_JSON
+#define BVIEW_BST_DEFAULT_REPORT_LAYOUT   BST_REPORT_LAYOUT_SPARSE
+  /* periodic reports between two keyframes, 0 sends a keyframe
+     only on the first report and on a resync */
+#define BVIEW_BST_DEFAULT_KEYFRAME_INTERVAL 0
+  /* milli seconds a get-bst-report collection is shared for, 0 collects
+     on every request */
+#define BVIEW_BST_DEFAULT_COALESCE_WINDOW 0
 #define BVIEW_BST_DEFAULT_TRACK_INGRESS   true
 #define BVIEW_BST_DEFAULT_TRACK_EGRESS    true
 #define BVIEW_BST_DEFAULT_TRACK_DEVICE    true
@@ -89,6 +97,12 @@ extern "C" {
 /* Maximum number of failed Receive messages */
 #define BVIEW_BST_MAX_QUEUE_SEND_FAILS      10
 
+/* control requests served in a row while data requests wait */
+#define BVIEW_BST_CONTROL_LANE_BURST        8
+
+/* reports between collection and the end of their send */
+#define BVIEW_BST_PIPELINE_DEPTH            4
+
 typedef BSTJSON_CONFIGURE_BST_TRACKING_t  BVIEW_BST_TRACK_PARAMS_t;
 typedef BSTJSON_CONFIGURE_BST_FEATURE_t   BVIEW_BST_CONFIG_PARAMS_t;
 typedef BSTJSON_REPORT_OPTIONS_t          BVIEW_BST_REPORT_OPTIONS_t;
@@ -119,20 +133,27 @@ typedef enum _bst_threshold_realm_ {
 }BVIEW_BST_THRESHOLD_TYPE_t;
 
 
+/* BST ids, the counters raising triggers, with the realm and the counter
+   of the registry they stand for */
+#define BST_TRIGGER_INDEX_REGISTRY(_X) \
+  _X(BST_ID_DEVICE,                BVIEW_BST_DEVICE,                BVIEW_BST_COUNTER_DATA)        \
+  _X(BST_ID_ING_POOL,              BVIEW_BST_INGRESS_SP,            BVIEW_BST_COUNTER_UM_SHARE)    \
+  _X(BST_ID_PORT_POOL,             BVIEW_BST_INGRESS_PORT_SP,       BVIEW_BST_COUNTER_UM_SHARE)    \
+  _X(BST_ID_PRI_GROUP_SHARED,      BVIEW_BST_INGRESS_PORT_PG,       BVIEW_BST_COUNTER_UM_SHARE)    \
+  _X(BST_ID_PRI_GROUP_HEADROOM,    BVIEW_BST_INGRESS_PORT_PG,       BVIEW_BST_COUNTER_UM_HEADROOM) \
+  _X(BST_ID_EGR_POOL,              BVIEW_BST_EGRESS_SP,             BVIEW_BST_COUNTER_UM_SHARE)    \
+  _X(BST_ID_EGR_MCAST_POOL,        BVIEW_BST_EGRESS_SP,             BVIEW_BST_COUNTER_MC_SHARE)    \
+  _X(BST_ID_UCAST,                 BVIEW_BST_EGRESS_UC_QUEUE,       BVIEW_BST_COUNTER_UC_BUFFER)   \
+  _X(BST_ID_MCAST,                 BVIEW_BST_EGRESS_MC_QUEUE,       BVIEW_BST_COUNTER_MC_BUFFER)   \
+  _X(BST_ID_EGR_UCAST_PORT_SHARED, BVIEW_BST_EGRESS_PORT_SP,        BVIEW_BST_COUNTER_UC_SHARE)    \
+  _X(BST_ID_EGR_PORT_SHARED,       BVIEW_BST_EGRESS_PORT_SP,        BVIEW_BST_COUNTER_UM_SHARE)    \
+  _X(BST_ID_RQE_QUEUE,             BVIEW_BST_EGRESS_RQE_QUEUE,      BVIEW_BST_COUNTER_RQE_BUFFER)  \
+  _X(BST_ID_UCAST_GROUP,           BVIEW_BST_EGRESS_UC_QUEUEGROUPS, BVIEW_BST_COUNTER_UC_BUFFER)
+
+#define BST_TRIGGER_INDEX_ENUM(_index, _realm, _counter)   _index,
+
 typedef enum _bst_trigger_index_ {
-  BST_ID_DEVICE = 0,
-  BST_ID_ING_POOL,
-  BST_ID_PORT_POOL,
-  BST_ID_PRI_GROUP_SHARED, 
-  BST_ID_PRI_GROUP_HEADROOM,
-  BST_ID_EGR_POOL,
-  BST_ID_EGR_MCAST_POOL, 
-  BST_ID_UCAST, 
-  BST_ID_MCAST,
-  BST_ID_EGR_UCAST_PORT_SHARED,
-  BST_ID_EGR_PORT_SHARED, 
-  BST_ID_RQE_QUEUE, 
-  BST_ID_UCAST_GROUP, 
+  BST_TRIGGER_INDEX_REGISTRY(BST_TRIGGER_INDEX_ENUM)
   BST_ID_MAX
 }BST_TRIGGER_INDEX_t;
 
@@ -140,21 +161,8 @@ typedef enum _bst_trigger_index_ {
 #define BVIEW_BST_MAX_THRESHOLD_TYPE_MIN BVIEW_BST_DEVICE_THRESHOLD
 #define BVIEW_BST_MAX_THRESHOLD_TYPE_MAX BVIEW_BST_INGRESS_SP_THRESHOLD
 
-/* structure to map realm to threshold type */
-typedef struct _bst_realm_to_threshold_ {
-  /* realm string */
-  char *realm;
-  /* threshold  type*/
-  BVIEW_BST_THRESHOLD_TYPE_t threshold;
-}BVIEW_BST_REALM_THRESHOLD_t;
-
-
-/* structure to map the trigger index to realm and counter */
-typedef struct _bst_trigger_realm_map_ {
-    BST_TRIGGER_INDEX_t index;
-    char *realm;
-    char *counter;
-}BST_REALM_COUNTER_INDEX_t;
+
+
 /* BST command enums */
 typedef enum _bst_cmd_ {
   /* Set group */
@@ -191,6 +199,9 @@ typedef enum _bst_cmd_ {
   typedef struct _bst_report_snapshot_data_ {
     BVIEW_TIME_t tv;
     BVIEW_BST_ASIC_SNAPSHOT_DATA_t snapshot_data;
+    /* collected while the south bound was resyncing, the data is
+       the last it had */
+    bool stale;
   }BVIEW_BST_REPORT_SNAPSHOT_t;
 
   typedef struct _bst_report_respose_ {
@@ -205,12 +216,11 @@ typedef enum _bst_cmd_ {
     int id; /* id passed from the request */
     int version; /* json version */
     BVIEW_BST_REPORT_TYPE_t report_type; 
-    char realm[JSON_MAX_NODE_LENGTH];
     unsigned int threshold_type;
     BVIEW_BST_THRESHOLD_CONFIG_t threshold;
      /* trigger info */
-     BVIEW_BST_TRIGGER_INFO_t triggerInfo;
-    union
+     BVIEW_BST_TRIGGER_INFO_t trigger;
+    union _bst_request_params_
     {
       /* feature params */
       BVIEW_BST_CONFIG_PARAMS_t config;
@@ -235,6 +245,64 @@ typedef enum _bst_cmd_ {
     }request;
   }BVIEW_BST_REQUEST_MSG_t;
 
+  /* parameters of a request, out of line in the request pool
+     while the request is queued */
+  typedef struct _bst_request_payload_ {
+    BVIEW_BST_THRESHOLD_CONFIG_t threshold;
+    union _bst_request_params_ request;
+  }BVIEW_BST_REQUEST_PAYLOAD_t;
+
+  /* fixed header of a queued request */
+  typedef struct _bst_msg_hdr_ {
+    void *cookie;
+    /* parameters, NULL for requests without */
+    BVIEW_BST_REQUEST_PAYLOAD_t *payload;
+    int32_t msg_type;
+    int32_t unit;
+    int32_t id;
+    uint8_t version;
+    uint8_t report_type;
+    uint8_t threshold_type;
+    BVIEW_BST_TRIGGER_INFO_t trigger;
+  }BVIEW_BST_MSG_HDR_t;
+
+  /* cost of queueing the requests */
+  typedef struct _bst_msg_stats_ {
+    /* bytes a request takes on the queue, and in the request pool */
+    unsigned int queuedSize;
+    unsigned int payloadSize;
+    uint64_t requests;
+    uint64_t payloads;
+    /* time spent packing and posting a request, nano seconds */
+    uint64_t totalEnqueueTime;
+    uint64_t maxEnqueueTime;
+    /* requests that found no buffer in the pool */
+    uint64_t poolFailures;
+  }BVIEW_BST_MSG_STATS_t;
+
+
+  /* Lanes of the request queue. The lane is the message type on the
+     queue, the lower one is served first */
+  typedef enum _bst_lane_ {
+    BVIEW_BST_LANE_CONTROL = 1,
+    BVIEW_BST_LANE_DATA,
+    BVIEW_BST_LANE_MAX = BVIEW_BST_LANE_DATA
+  }BVIEW_BST_LANE_t;
+
+  /* request as posted on the queue */
+  typedef struct _bst_queue_msg_ {
+    long lane; /* BVIEW_BST_LANE_t, message type on the queue */
+    struct timespec enqueueTime; /* monotonic clock */
+    BVIEW_BST_MSG_HDR_t hdr;
+  }BVIEW_BST_QUEUE_MSG_t;
+
+  /* time the requests of a lane wait in the queue */
+  typedef struct _bst_lane_stats_ {
+    uint64_t requests;
+    /* micro seconds */
+    uint64_t totalWait;
+    uint64_t maxWait;
+  }BVIEW_BST_LANE_STATS_t;
 
   typedef struct _bst_response_msg_ {
     long msg_type;
@@ -245,6 +313,13 @@ typedef enum _bst_cmd_ {
     BVIEW_ASIC_CAPABILITIES_t  *asic_capabilities;
     BVIEW_BST_REPORT_OPTIONS_t options;
     BVIEW_STATUS rv; /* return value for set request */
+    /* the encoded report may be shared with the requests of the
+       same freshness window */
+    bool coalesce;
+    /* collection the report is encoded from, see BVIEW_BST_REPORT_CACHE_t */
+    uint64_t cacheGeneration;
+    /* when the bst thread picked up the request, monotonic clock */
+    struct timespec startTime;
     union
     {
       BVIEW_BST_CONFIG_PARAMS_t *config;
@@ -253,6 +328,27 @@ typedef enum _bst_cmd_ {
     }response;
   }BVIEW_BST_RESPONSE_MSG_t;
 
+  /* stages a report goes through */
+  typedef enum _bst_pipeline_stage_ {
+    /* bst thread : collection, record rotation, reply options */
+    BVIEW_BST_STAGE_COLLECT = 0,
+    /* encoding thread */
+    BVIEW_BST_STAGE_ENCODE,
+    /* sending thread */
+    BVIEW_BST_STAGE_SEND,
+    BVIEW_BST_STAGE_MAX
+  }BVIEW_BST_PIPELINE_STAGE_t;
+
+  /* work done by a stage, times in micro seconds */
+  typedef struct _bst_pipeline_stats_ {
+    uint64_t reports;
+    uint64_t totalTime;
+    uint64_t maxTime;
+    /* reports waiting for the stage */
+    unsigned int depth;
+    unsigned int maxDepth;
+  }BVIEW_BST_PIPELINE_STATS_t;
+
   typedef struct _bst_timer_s_ {
     unsigned int unit;
     bool in_use;
@@ -267,6 +363,59 @@ typedef enum _bst_cmd_ {
   } BVIEW_BST_DATA_t;
 
 
+/* Receivers of incremental reports, each with its own baseline */
+typedef enum _bst_consumer_id_
+{
+  BVIEW_BST_CONSUMER_PERIODIC = 0,
+  BVIEW_BST_CONSUMER_MAX
+}BVIEW_BST_CONSUMER_ID_t;
+
+/* what a consumer of incremental reports was last sent */
+typedef struct _bst_consumer_s_
+{
+  /* snapshot the next report is a difference to, and the previous
+     one, still read while the current report is encoded */
+  BVIEW_BST_REPORT_SNAPSHOT_t *baseline[2];
+  int current;
+  /* false until the first report and after a resync */
+  bool valid;
+  /* sequence number of the last report */
+  uint64_t sequenceNumber;
+  /* reports sent since the last keyframe */
+  unsigned int sinceKeyframe;
+}BVIEW_BST_CONSUMER_t;
+
+/* how often get-bst-report requests were served from the last collection */
+typedef struct _bst_report_cache_stats_s_
+{
+  /* requests which shared the last collection, or collected */
+  uint64_t collectHits;
+  uint64_t collectMisses;
+  /* requests which shared the last encoded report, or encoded */
+  uint64_t encodeHits;
+  uint64_t encodeMisses;
+}BVIEW_BST_REPORT_CACHE_STATS_t;
+
+/* last collection of a unit, shared by the get-bst-report
+   requests of its freshness window */
+typedef struct _bst_report_cache_s_
+{
+  /* the active record holds the last collection */
+  bool collected;
+  /* bumped when the encoded report is dropped, a report encoded
+     from an earlier collection is not kept */
+  uint64_t generation;
+  /* when it was collected, on the monotonic clock */
+  struct timespec collectTime;
+  /* the request being handled shares the last collection */
+  bool reuse;
+  /* report last encoded from the collection, with its options */
+  uint8_t *buffer;
+  int length;
+  BVIEW_BST_REPORT_OPTIONS_t options;
+  BVIEW_BST_REPORT_CACHE_STATS_t stats;
+}BVIEW_BST_REPORT_CACHE_t;
+
 typedef struct _bst_context_unit_info__
 {
   /* stats records */
@@ -276,9 +425,18 @@ typedef struct _bst_context_unit_info__
   /* threshold records */
   BVIEW_BST_REPORT_SNAPSHOT_t *threshold_record_ptr;
 
+  /* baselines of the incremental report streams */
+  BVIEW_BST_CONSUMER_t consumers[BVIEW_BST_CONSUMER_MAX];
+
+  /* last collection, shared by the get-bst-report requests */
+  BVIEW_BST_REPORT_CACHE_t report_cache;
+
   /* place holder to store the bst max buffer settings */
   BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t bst_max_buffers;
 
+  /* percentage conversion factors, derived from the max buffer settings */
+  BSTJSON_CONVERT_TABLE_t *bst_convert_table;
+
   /* config data */
   BVIEW_BST_DATA_t *bst_data;
   /* lock for this unit */
@@ -307,6 +465,8 @@ typedef struct _bst_context_info__
   /* message queue id for bst */
   int recvMsgQid;
   int recvTriggerMsgQid;
+  /* queue wait of the requests, per lane, updated by the bst thread */
+  BVIEW_BST_LANE_STATS_t laneStats[BVIEW_BST_LANE_MAX + 1];
     /* pthread ID*/
   pthread_t bst_thread;
   pthread_t bst_trigger_thread;
@@ -771,6 +931,142 @@ BVIEW_STATUS bst_module_register ();
 *********************************************************************/
 BVIEW_STATUS bst_send_request(BVIEW_BST_REQUEST_MSG_t *msg_data);
 
+/*********************************************************************
+* @brief   :  reads the queue wait statistics of a lane
+*
+* @param[in]   lane   : lane of the request queue
+* @param[out]  pStats : statistics of the lane
+*
+* @retval  : BVIEW_STATUS_SUCCESS : statistics read
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_lane_stats_get (BVIEW_BST_LANE_t lane,
+                                 BVIEW_BST_LANE_STATS_t *pStats);
+
+/*********************************************************************
+* @brief   :  encodes the report of a response message
+*
+* @param[in]   reply_data : response message of a report request
+* @param[out]  pBuffer    : encoded report, to be freed with
+*                           bstjson_memory_free()
+* @param[out]  pLength    : number of bytes in the report
+*
+* @retval  : BVIEW_STATUS_SUCCESS : report encoded
+* @retval  : other : the encoder failed, *pBuffer may still be set
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_encode (BVIEW_BST_RESPONSE_MSG_t *reply_data,
+                                uint8_t **pBuffer, int *pLength);
+
+/*********************************************************************
+* @brief   :  sends an encoded response and frees it
+*
+* @param[in]  cookie     : request the response is for, NULL for
+*                          asynchronous reports
+* @param[in]  pBuffer    : encoded response
+* @param[in]  bufLength  : number of bytes in the response
+* @param[in]  binary     : the response is a binary report
+*
+* @retval  : BVIEW_STATUS_SUCCESS : response sent
+* @retval  : other : the send failed
+*
+*********************************************************************/
+BVIEW_STATUS bst_response_buffer_send (void *cookie, uint8_t *pBuffer,
+                                       int bufLength, bool binary);
+
+/*********************************************************************
+* @brief   :  tells if a report is streamed to its client
+*
+* @param[in]  reply_data : response message of a report request
+*
+* @retval  : true : the report is encoded as it is sent, see
+*                   bst_report_stream()
+*
+*********************************************************************/
+bool bst_report_streamed (const BVIEW_BST_RESPONSE_MSG_t *reply_data);
+
+/*********************************************************************
+* @brief   :  encodes a report and sends it as it is encoded
+*
+* @param[in]  reply_data : response message of a report request
+*
+* @retval  : BVIEW_STATUS_SUCCESS : report sent
+* @retval  : other : the encoder or the send failed
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_stream (BVIEW_BST_RESPONSE_MSG_t *reply_data);
+
+/*********************************************************************
+* @brief   :  starts the encoding and sending threads of the reports
+*
+* @retval  : BVIEW_STATUS_SUCCESS : pipeline started
+* @retval  : BVIEW_STATUS_FAILURE : thread creation failed, reports
+*                                   are then encoded and sent by the
+*                                   bst thread
+*
+*********************************************************************/
+BVIEW_STATUS bst_pipeline_init (void);
+
+/*********************************************************************
+* @brief   :  hands a report over to the encoding thread
+*
+* @param[in]  reply_data : response message of a report request
+*
+* @retval  : BVIEW_STATUS_SUCCESS : report queued
+*
+* @note  : called by the bst thread, blocks while the pipeline is full.
+*          The records of the report are held until it is encoded,
+*          or sent for a streamed report.
+*
+*********************************************************************/
+BVIEW_STATUS bst_pipeline_submit (BVIEW_BST_RESPONSE_MSG_t *reply_data);
+
+/*********************************************************************
+* @brief   :  waits until no queued report reads a record
+*
+* @param[in]  unit   : unit number
+* @param[in]  record : record about to be written
+*
+* @note  : called by the bst thread, without the unit lock, before
+*          a record is collected into or cleared.
+*
+*********************************************************************/
+void bst_pipeline_record_wait (unsigned int unit, const void *record);
+
+/*********************************************************************
+* @brief   :  waits until no report of a unit is in the pipeline
+*
+* @param[in]  unit : unit number
+*
+* @note  : called by the bst thread, without the unit lock.
+*
+*********************************************************************/
+void bst_pipeline_unit_drain (unsigned int unit);
+
+/*********************************************************************
+* @brief   :  reads the statistics of a pipeline stage
+*
+* @param[in]   stage  : stage
+* @param[out]  pStats : statistics of the stage
+*
+* @retval  : BVIEW_STATUS_SUCCESS : statistics read
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_pipeline_stats_get (BVIEW_BST_PIPELINE_STAGE_t stage,
+                                     BVIEW_BST_PIPELINE_STATS_t *pStats);
+
+/*********************************************************************
+* @brief   :  dumps the statistics of the pipeline stages
+*
+* @param[in]  : none
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_pipeline_stats_dump (void);
+
 /*********************************************************************
 *  @brief:  callback function to send periodic reports  
 *
@@ -848,6 +1144,114 @@ BVIEW_STATUS bst_clear_stats_set (BVIEW_BST_REQUEST_MSG_t * msg_data);
 *********************************************************************/
 BVIEW_STATUS bst_update_data(BVIEW_BST_REPORT_TYPE_t type,unsigned int unit);
 
+/*********************************************************************
+* @brief : picks the baseline of the next report of a consumer.
+*
+* @param[in]  unit        : unit number
+* @param[in]  id          : consumer
+* @param[in]  active      : snapshot the report carries
+* @param[in]  incremental : consumer takes incremental reports
+* @param[out] pBaseline   : snapshot the report is a difference to,
+*                           NULL for a keyframe
+* @param[out] pSequence   : sequence number of the report
+* @param[out] pKeyframe   : true if the report is a keyframe
+*
+* @retval  : BVIEW_STATUS_SUCCESS : baseline picked
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : 'active' becomes the consumer's next baseline. The returned
+*         baseline stays valid until the consumer's next report.
+*
+*********************************************************************/
+BVIEW_STATUS bst_consumer_report_prepare (unsigned int unit,
+                                          BVIEW_BST_CONSUMER_ID_t id,
+                                          const BVIEW_BST_REPORT_SNAPSHOT_t *active,
+                                          bool incremental,
+                                          BVIEW_BST_REPORT_SNAPSHOT_t **pBaseline,
+                                          uint64_t *pSequence,
+                                          bool *pKeyframe);
+
+/*********************************************************************
+* @brief : makes the next report of every consumer a keyframe.
+*
+* @param[in] unit : unit number
+*
+* @retval  : BVIEW_STATUS_SUCCESS : next reports are keyframes
+*
+*********************************************************************/
+BVIEW_STATUS bst_consumer_resync (unsigned int unit);
+
+/*********************************************************************
+* @brief : finds the encoded report of the last collection.
+*
+* @param[in]  unit     : unit number
+* @param[in]  options  : options of the report to send
+* @param[in]  generation : collection the report is to be encoded from
+* @param[out] pBuffer  : copy of the encoded report, to be freed with
+*                        bstjson_memory_free()
+* @param[out] pLength  : number of bytes in the report
+*
+* @retval  : true if a report encoded with the same options is cached
+*
+* @note : to be called with the unit lock held.
+*
+*********************************************************************/
+bool bst_report_cache_lookup (unsigned int unit,
+                              const BVIEW_BST_REPORT_OPTIONS_t *options,
+                              uint64_t generation,
+                              uint8_t **pBuffer, int *pLength);
+
+/*********************************************************************
+* @brief : keeps the encoded report of the last collection.
+*
+* @param[in] unit    : unit number
+* @param[in] options : options the report was encoded with
+* @param[in] generation : collection the report was encoded from
+* @param[in] buffer  : encoded report, the cache keeps a copy
+* @param[in] length  : number of bytes in the report
+*
+* @note : to be called with the unit lock held.
+*
+*********************************************************************/
+void bst_report_cache_store (unsigned int unit,
+                             const BVIEW_BST_REPORT_OPTIONS_t *options,
+                             uint64_t generation,
+                             const uint8_t *buffer, int length);
+
+/*********************************************************************
+* @brief : drops the last collection, the next request collects.
+*
+* @param[in] unit : unit number
+*
+* @retval  : BVIEW_STATUS_SUCCESS : cache dropped
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_cache_invalidate (unsigned int unit);
+
+/*********************************************************************
+* @brief : reads the hit and miss counters of the report cache.
+*
+* @param[in]  unit   : unit number
+* @param[out] pStats : counters
+*
+* @retval  : BVIEW_STATUS_SUCCESS : counters read
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_cache_stats_get (unsigned int unit,
+                                         BVIEW_BST_REPORT_CACHE_STATS_t *pStats);
+
+/*********************************************************************
+* @brief : dumps the hit and miss counters of the report cache of
+*          each unit.
+*
+* @param[in] : none
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_report_cache_stats_dump (void);
+
 /*************************************************************
 *@brief:  Callback function to send the trigger to bst application
 *         to send periodic collection
@@ -948,15 +1352,92 @@ BVIEW_STATUS bst_trigger_timer_cb (union sigval sigval);
 /*********************************************************************
 *  @brief:  function to set the given realm in the include trigger report.  
 *
-* @param[in]   *realm : pointer to realm 
-* @param[in]   *realm : pointer to json encode options 
+* @param[in]   realm : realm id
+* @param[in]   *options : pointer to json encode options 
 *
 * @retval  : none : 
 *
 * @note :
 *
 *********************************************************************/
-void bst_set_realm_to_collect(char *realm, BVIEW_BST_REPORT_OPTIONS_t *options);
+void bst_set_realm_to_collect(BVIEW_BST_REALM_ID_t realm, BVIEW_BST_REPORT_OPTIONS_t *options);
+
+/*********************************************************************
+* @brief : creates the pool of the request parameters
+*
+* @retval  : BVIEW_STATUS_SUCCESS : pool created
+* @retval  : other : the pool could not be created
+*
+*********************************************************************/
+BVIEW_STATUS bst_msg_init (void);
+
+/*********************************************************************
+* @brief : packs a request for a queue
+*
+* @param[in]   msg_data  : request
+* @param[out]  queue_msg : header to post, with the parameters in a
+*                          buffer of the request pool
+*
+* @retval  : BVIEW_STATUS_SUCCESS : request packed
+* @retval  : BVIEW_STATUS_OUTOFMEMORY : no buffer in the request pool
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : the lane of the message is left to the caller. If the
+*         message is not posted, bst_request_release() frees it.
+*
+*********************************************************************/
+BVIEW_STATUS bst_request_pack (const BVIEW_BST_REQUEST_MSG_t *msg_data,
+                               BVIEW_BST_QUEUE_MSG_t *queue_msg);
+
+/*********************************************************************
+* @brief : unpacks a request read from a queue
+*
+* @param[in]   queue_msg : header read
+* @param[out]  msg_data  : request
+*
+* @note : the parameters go back to the request pool.
+*
+*********************************************************************/
+void bst_request_unpack (BVIEW_BST_QUEUE_MSG_t *queue_msg,
+                         BVIEW_BST_REQUEST_MSG_t *msg_data);
+
+/*********************************************************************
+* @brief : frees a packed request that could not be posted
+*
+* @param[in]   queue_msg : header
+*
+*********************************************************************/
+void bst_request_release (BVIEW_BST_QUEUE_MSG_t *queue_msg);
+
+/*********************************************************************
+* @brief : accounts for a request posted to a queue
+*
+* @param[in]   queue_msg : request posted, its enqueue time is when
+*                          packing started
+*
+*********************************************************************/
+void bst_msg_enqueue_account (const BVIEW_BST_QUEUE_MSG_t *queue_msg);
+
+/*********************************************************************
+* @brief : reads the statistics of the request queues
+*
+* @param[out]  pStats : statistics
+*
+* @retval  : BVIEW_STATUS_SUCCESS : statistics read
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_msg_stats_get (BVIEW_BST_MSG_STATS_t *pStats);
+
+/*********************************************************************
+* @brief : dumps the statistics of the request queues
+*
+* @param[in]  : none
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_msg_stats_dump (void);
 
 /*********************************************************************
 * @brief : application function to process trigger messages 
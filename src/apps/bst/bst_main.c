@@ -25,6 +25,7 @@
 #include <mqueue.h>
 #include <errno.h>
 #include "bst_json_memory.h"
+#include "bst_json_diff.h"
 #include "clear_bst_statistics.h"
 #include "clear_bst_thresholds.h"
 #include "configure_bst_thresholds.h"
@@ -35,6 +36,9 @@
 #include "get_bst_thresholds.h"
 #include "get_bst_report.h"
 #include "bst_json_encoder.h"
+#include "bst_bin_encoder.h"
+#include "bst_json_parallel.h"
+#include "bst_json_header.h"
 #include "bst.h"
 #include "broadview.h"
 #include "bst_app.h"
@@ -198,6 +202,99 @@ BVIEW_STATUS bst_enable_on_trigger_timer_expiry (BVIEW_BST_REQUEST_MSG_t * msg_d
   return rv;
 }
 
+/*********************************************************************
+* @brief   :  lane of the request queue a request is posted on
+*
+* @param[in]  msg_type : request type
+*
+* @retval  : BVIEW_BST_LANE_CONTROL or BVIEW_BST_LANE_DATA
+*
+*********************************************************************/
+static BVIEW_BST_LANE_t bst_request_lane_get (long msg_type)
+{
+  switch (msg_type)
+  {
+    /* configuration, and the small requests that go with it */
+    case BVIEW_BST_CMD_API_SET_TRACK:
+    case BVIEW_BST_CMD_API_SET_FEATURE:
+    case BVIEW_BST_CMD_API_SET_THRESHOLD:
+    case BVIEW_BST_CMD_API_CLEAR_THRESHOLD:
+    case BVIEW_BST_CMD_API_CLEAR_STATS:
+    case BVIEW_BST_CMD_API_GET_FEATURE:
+    case BVIEW_BST_CMD_API_GET_TRACK:
+    case BVIEW_BST_CMD_API_CLEAR_TRIGGER_COUNT:
+    case BVIEW_BST_CMD_API_ENABLE_BST_ON_TRIGGER:
+    case BVIEW_BST_CMD_API_UPDATE_TRACK:
+    case BVIEW_BST_CMD_API_UPDATE_FEATURE:
+      return BVIEW_BST_LANE_CONTROL;
+
+    /* collections and reports */
+    default:
+      return BVIEW_BST_LANE_DATA;
+  }
+}
+
+/*********************************************************************
+* @brief   :  reads the next request to serve from the queue
+*
+* @param[out]     queue_msg   : the request
+* @param[in,out]  controlRun  : control requests served in a row
+*
+* @retval  : 0 on success, -1 if the queue could not be read
+*
+* @note  : control requests are served first, in their order. After
+*          BVIEW_BST_CONTROL_LANE_BURST of them in a row, a waiting data
+*          request is served, so periodic collection is not starved.
+*
+*********************************************************************/
+static int bst_request_receive (BVIEW_BST_QUEUE_MSG_t *queue_msg,
+                                unsigned int *controlRun)
+{
+  struct timespec now;
+  uint64_t wait;
+  BVIEW_BST_LANE_STATS_t *stats;
+  ssize_t len = -1;
+
+  if (*controlRun >= BVIEW_BST_CONTROL_LANE_BURST)
+  {
+    len = msgrcv (bst_info.recvMsgQid, queue_msg,
+                  sizeof (BVIEW_BST_QUEUE_MSG_t) - sizeof (long),
+                  BVIEW_BST_LANE_DATA, IPC_NOWAIT);
+  }
+
+  if (-1 == len)
+  {
+    /* lowest lane first, in order within a lane */
+    len = msgrcv (bst_info.recvMsgQid, queue_msg,
+                  sizeof (BVIEW_BST_QUEUE_MSG_t) - sizeof (long),
+                  -BVIEW_BST_LANE_MAX, 0);
+    if (-1 == len)
+    {
+      return -1;
+    }
+  }
+
+  *controlRun = (BVIEW_BST_LANE_CONTROL == queue_msg->lane) ? (*controlRun + 1) : 0;
+
+  if ((queue_msg->lane >= BVIEW_BST_LANE_CONTROL) &&
+      (queue_msg->lane <= BVIEW_BST_LANE_MAX))
+  {
+    clock_gettime (CLOCK_MONOTONIC, &now);
+    wait = (uint64_t) ((((long long) (now.tv_sec - queue_msg->enqueueTime.tv_sec)) * 1000000) +
+                       ((now.tv_nsec - queue_msg->enqueueTime.tv_nsec) / 1000));
+    /* read by bst_lane_stats_get on other threads */
+    stats = &bst_info.laneStats[queue_msg->lane];
+    __atomic_fetch_add (&stats->requests, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add (&stats->totalWait, wait, __ATOMIC_RELAXED);
+    if (wait > __atomic_load_n (&stats->maxWait, __ATOMIC_RELAXED))
+    {
+      __atomic_store_n (&stats->maxWait, wait, __ATOMIC_RELAXED);
+    }
+  }
+
+  return 0;
+}
+
 /*********************************************************************
 * @brief : bst main application function which does processing of messages
 *
@@ -217,10 +314,12 @@ BVIEW_STATUS bst_enable_on_trigger_timer_expiry (BVIEW_BST_REQUEST_MSG_t * msg_d
 *********************************************************************/
 BVIEW_STATUS bst_app_main (void)
 {
+  BVIEW_BST_QUEUE_MSG_t queue_msg;
   BVIEW_BST_REQUEST_MSG_t msg_data;
   BVIEW_BST_RESPONSE_MSG_t reply_data;
   BVIEW_STATUS rv = BVIEW_STATUS_FAILURE;
   unsigned int rcvd_err = 0;
+  unsigned int controlRun = 0;
   unsigned int id = 0, num_units = 0;
   BVIEW_BST_API_HANDLER_t handler;
 
@@ -290,8 +389,9 @@ BVIEW_STATUS bst_app_main (void)
 
   while (1)
   {
-    if (-1 != (msgrcv (bst_info.recvMsgQid, &msg_data, sizeof (msg_data), 0, 0))) 
+    if (-1 != bst_request_receive (&queue_msg, &controlRun))
     {
+      bst_request_unpack (&queue_msg, &msg_data);
       _BST_LOG(_BST_DEBUG_INFO, "msg_data info\n"
           "msg_data.msg_type = %ld\n"
           "msg_data.unit = %d\n"
@@ -327,6 +427,8 @@ BVIEW_STATUS bst_app_main (void)
       rcvd_err = 0;
       /* Memset the response message */
       memset (&reply_data, 0, sizeof (BVIEW_BST_RESPONSE_MSG_t));
+      /* the collect stage of a report starts here */
+      clock_gettime (CLOCK_MONOTONIC, &reply_data.startTime);
 
       /* get the api function for the method type */
       if (BVIEW_STATUS_SUCCESS != bst_type_api_get (msg_data.msg_type, &handler))
@@ -441,6 +543,12 @@ BVIEW_STATUS bst_app_config_init (unsigned int num_units)
     ptr->config.bstMaxTriggers = BVIEW_BST_DEFAULT_MAX_TRIGGERS;
     ptr->config.sendSnapshotOnTrigger = BVIEW_BST_DEFAULT_SNAPSHOT_TRIGGER;
     ptr->config.statsInPercentage = BVIEW_BST_DEFAULT_STATS_PERCENTAGE;
+    ptr->config.reportFormat = BVIEW_BST_DEFAULT_REPORT_FORMAT;
+    ptr->config.reportLayout = BVIEW_BST_DEFAULT_REPORT_LAYOUT;
+    ptr->config.keyframeInterval = BVIEW_BST_DEFAULT_KEYFRAME_INTERVAL;
+    ptr->config.coalesceWindow = BVIEW_BST_DEFAULT_COALESCE_WINDOW;
+    /* no report filter, periodic reports carry every entry */
+    memset(&ptr->config.reportFilter, 0, sizeof(ptr->config.reportFilter));
     ptr->config.triggerTransmitInterval = BVIEW_BST_DEFAULT_TRIGGER_INTERVAL;
     ptr->config.sendIncrementalReport = BVIEW_BST_DEFAULT_SEND_INCR_REPORT;
 
@@ -573,6 +681,215 @@ BVIEW_STATUS bst_app_config_init (unsigned int num_units)
 }
 
 
+/*********************************************************************
+* @brief   :  encodes the report of a response message
+*
+* @param[in]   reply_data : response message of a report request
+* @param[out]  pBuffer    : encoded report, to be freed with
+*                           bstjson_memory_free()
+* @param[out]  pLength    : number of bytes in the report
+*
+* @retval  : BVIEW_STATUS_SUCCESS : report encoded
+* @retval  : other : the encoder failed, *pBuffer may still be set
+*
+* @note  : runs on the encoding thread. The records of the report are
+*          held by the pipeline, the unit lock is only taken around
+*          the report cache.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_encode (BVIEW_BST_RESPONSE_MSG_t *reply_data,
+                                uint8_t **pBuffer, int *pLength)
+{
+  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+  bool cached = false;
+
+  if ((NULL == reply_data) || (NULL == pBuffer) || (NULL == pLength))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  *pBuffer = NULL;
+  *pLength = 0;
+
+  /* the same report may have been encoded for an earlier
+     request of the freshness window */
+  if (true == reply_data->coalesce)
+  {
+    BST_LOCK_TAKE (reply_data->unit);
+    cached = bst_report_cache_lookup (reply_data->unit, &reply_data->options,
+                                      reply_data->cacheGeneration,
+                                      pBuffer, pLength);
+    BST_LOCK_GIVE (reply_data->unit);
+    if (true == cached)
+    {
+      return BVIEW_STATUS_SUCCESS;
+    }
+  }
+
+  /* if this is a periodic report, the back up pointer is
+     a non null poiner, other wise , the backup 
+     pointer would be NULL pointer. so call 
+     the encoder function accordingly */
+  if (BST_REPORT_FORMAT_BINARY == reply_data->options.reportFormat)
+  {
+    rv = bstbin_encode_get_bst_report (reply_data->unit, reply_data->msg_type,
+                                       (NULL == reply_data->response.report.backup) ? NULL :
+                                       &reply_data->response.report.backup->snapshot_data,
+                                       &reply_data->response.report.active->snapshot_data,
+                                       &reply_data->options,
+                                       reply_data->asic_capabilities,
+                                       &reply_data->response.report.active->tv,
+                                       pBuffer, pLength);
+  }
+  else
+  {
+    rv = bstjson_encode_get_bst_report (reply_data->unit, reply_data->msg_type,
+                                        (NULL == reply_data->response.report.backup) ? NULL :
+                                        &reply_data->response.report.backup->snapshot_data,
+                                        &reply_data->response.report.active->snapshot_data,
+                                        &reply_data->options,
+                                        reply_data->asic_capabilities,
+                                        &reply_data->response.report.active->tv,
+                                        pBuffer);
+    if ((BVIEW_STATUS_SUCCESS == rv) && (NULL != *pBuffer))
+    {
+      *pLength = strlen((char *)*pBuffer);
+    }
+  }
+
+  if ((BVIEW_STATUS_SUCCESS != rv) || (NULL == *pBuffer))
+  {
+    return (BVIEW_STATUS_SUCCESS != rv) ? rv : BVIEW_STATUS_FAILURE;
+  }
+
+  /* keep it for the next requests of the window */
+  if (true == reply_data->coalesce)
+  {
+    BST_LOCK_TAKE (reply_data->unit);
+    bst_report_cache_store (reply_data->unit, &reply_data->options,
+                            reply_data->cacheGeneration,
+                            *pBuffer, *pLength);
+    BST_LOCK_GIVE (reply_data->unit);
+  }
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief   :  sends an encoded response and frees it
+*
+* @param[in]  cookie     : request the response is for, NULL for
+*                          asynchronous reports
+* @param[in]  pBuffer    : encoded response
+* @param[in]  bufLength  : number of bytes in the response
+* @param[in]  binary     : the response is a binary report
+*
+* @retval  : BVIEW_STATUS_SUCCESS : response sent
+* @retval  : other : the send failed
+*
+* @note  : the buffer is freed in both successful and unsuccessful
+*          cases.
+*
+*********************************************************************/
+BVIEW_STATUS bst_response_buffer_send (void *cookie, uint8_t *pBuffer,
+                                       int bufLength, bool binary)
+{
+  BVIEW_STATUS rv;
+
+  if (NULL == pBuffer)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  /* binary reports carry their length, the rest are strings */
+  if (0 == bufLength)
+  {
+    bufLength = strlen((char *)pBuffer);
+  }
+  rv = rest_response_send(cookie, (char *)pBuffer, bufLength);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    _BST_LOG(_BST_DEBUG_ERROR, "sending response failed due to error = %d\r\n",rv);
+    LOG_POST (BVIEW_LOG_ERROR,
+        " sending response failed due to error = %d\r\n",rv);
+  }
+  else
+  {
+    _BST_LOG(_BST_DEBUG_TRACE,"sent response to rest, pJsonBuffer = %.*s, len = %d\r\n",
+             (true == binary) ? 0 : bufLength,
+             pBuffer, bufLength); 
+  }
+  bstjson_memory_free(pBuffer);
+  return rv;
+}
+
+/*********************************************************************
+* @brief   :  tells if a report is streamed to its client
+*
+* @param[in]  reply_data : response message of a report request
+*
+* @retval  : true : the report is encoded as it is sent
+*
+* @note  : only the asynchronous JSON reports are streamed. A
+*          get-bst-report response is encoded whole, it may be shared
+*          with other requests and an encoding failure still gets an
+*          error response.
+*
+*********************************************************************/
+bool bst_report_streamed (const BVIEW_BST_RESPONSE_MSG_t *reply_data)
+{
+  return ((NULL == reply_data->cookie) &&
+          (false == reply_data->coalesce) &&
+          (BST_REPORT_FORMAT_JSON == reply_data->options.reportFormat));
+}
+
+/*********************************************************************
+* @brief   :  encodes a report and sends it as it is encoded
+*
+* @param[in]  reply_data : response message of a report request
+*
+* @retval  : BVIEW_STATUS_SUCCESS : report sent
+* @retval  : other : the encoder or the send failed
+*
+* @note  : the report goes out a BSTJSON_STREAM_CHUNK_SIZE chunk at
+*          a time, as a chunked POST, without a report buffer. The
+*          records of the report are read until the last chunk is sent.
+*
+*********************************************************************/
+BVIEW_STATUS bst_report_stream (BVIEW_BST_RESPONSE_MSG_t *reply_data)
+{
+  REST_STREAM_t stream;
+  BVIEW_STATUS rv;
+  BVIEW_STATUS closeRv;
+
+  if (NULL == reply_data)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  rv = rest_response_stream_open (reply_data->cookie, &stream);
+  if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    rv = bstjson_encode_get_bst_report_stream (reply_data->unit, reply_data->msg_type,
+                                               (NULL == reply_data->response.report.backup) ? NULL :
+                                               &reply_data->response.report.backup->snapshot_data,
+                                               &reply_data->response.report.active->snapshot_data,
+                                               &reply_data->options,
+                                               reply_data->asic_capabilities,
+                                               &reply_data->response.report.active->tv,
+                                               rest_response_stream_write, &stream);
+  }
+
+  /* ends the report, or drops it if it failed half way */
+  closeRv = rest_response_stream_close (&stream);
+  if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    rv = closeRv;
+  }
+
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    _BST_LOG(_BST_DEBUG_ERROR, "streaming report failed due to error = %d\r\n",rv);
+    LOG_POST (BVIEW_LOG_ERROR,
+        " streaming report failed due to error = %d\r\n",rv);
+  }
+  return rv;
+}
+
 /*********************************************************************
 * @brief : function to send reponse for encoding to cjson and sending 
 *          using rest API 
@@ -589,6 +906,8 @@ BVIEW_STATUS bst_app_config_init (unsigned int num_units)
 *           calls the encoding api to encode the data, and the memory
 *           for the data is allocated. In case of both successful and 
 *           unsuccessful send of the data, the memory must be freed.
+*           Reports are handed over to the encoding and sending
+*           threads, so the bst thread goes on with the next request.
 *           
 *********************************************************************/
 BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
@@ -623,6 +942,12 @@ BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
       return BVIEW_STATUS_SUCCESS;
     }
 
+    if ((BVIEW_BST_CMD_API_GET_REPORT == reply_data->msg_type) ||
+        (BVIEW_BST_CMD_API_TRIGGER_REPORT == reply_data->msg_type) ||
+        (BVIEW_BST_CMD_API_GET_THRESHOLD == reply_data->msg_type))
+    {
+      return bst_pipeline_submit (reply_data);
+    }
   } 
 
   /* Take lock*/
@@ -645,61 +970,15 @@ BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
           &pJsonBuffer);
       break;
 
-   
-     case BVIEW_BST_CMD_API_GET_REPORT:
-     case BVIEW_BST_CMD_API_TRIGGER_REPORT:
-     case BVIEW_BST_CMD_API_GET_THRESHOLD:
-      /*  call json encoder api for report  */
-
-      /* if this is a periodic report, the back up pointer is
-         a non null poiner, other wise , the backup 
-         pointer would be NULL pointer. so call 
-         the encoder function accordingly */
-
-      if (NULL == reply_data->response.report.backup)
-      {
-      rv = bstjson_encode_get_bst_report (reply_data->unit, reply_data->msg_type,
-                                          NULL, 
-                                          &reply_data->response.report.active->snapshot_data,
-                                          &reply_data->options,
-                                          reply_data->asic_capabilities,
-                                          &reply_data->response.report.active->tv,
-                                          &pJsonBuffer); 
-      }
-      else
-      {
-      rv = bstjson_encode_get_bst_report (reply_data->unit, reply_data->msg_type,
-                                          &reply_data->response.report.backup->snapshot_data, 
-                                          &reply_data->response.report.active->snapshot_data,
-                                          &reply_data->options,
-                                          reply_data->asic_capabilities,
-                                          &reply_data->response.report.active->tv,
-                                          &pJsonBuffer); 
-      }
-
-        break;
     default:
       break;
   }
+  /* release the lock for success and failed cases */
+  BST_LOCK_GIVE(reply_data->unit);
 
   if (NULL != pJsonBuffer && BVIEW_STATUS_SUCCESS == rv)
   {
-    rv = rest_response_send(reply_data->cookie, (char *)pJsonBuffer, strlen((char *)pJsonBuffer));
-    if (BVIEW_STATUS_SUCCESS != rv)
-    {
-      _BST_LOG(_BST_DEBUG_ERROR, "sending response failed due to error = %d\r\n",rv);
-      LOG_POST (BVIEW_LOG_ERROR,
-          " sending response failed due to error = %d\r\n",rv);
-    }
-    else
-    {
-      _BST_LOG(_BST_DEBUG_TRACE,"sent response to rest, pJsonBuffer = %s, len = %d\r\n", pJsonBuffer, (int)strlen((char *)pJsonBuffer)); 
-    }
-    /* free the json buffer */
-    if (NULL != pJsonBuffer)
-    {
-      bstjson_memory_free(pJsonBuffer);
-    }
+    rv = bst_response_buffer_send (reply_data->cookie, pJsonBuffer, 0, false);
   }
   else
   {
@@ -714,8 +993,6 @@ BVIEW_STATUS bst_send_response (BVIEW_BST_RESPONSE_MSG_t * reply_data)
       bstjson_memory_free(pJsonBuffer);
     }
   }
-  /* release the lock for success and failed cases */
-  BST_LOCK_GIVE(reply_data->unit);
   return rv;
 }
 
@@ -777,6 +1054,7 @@ BVIEW_STATUS bst_copy_reply_params (BVIEW_BST_REQUEST_MSG_t * msg_data,
 
   /* copy the address pointer of the default values */
   reply_data->options.bst_max_buffers_ptr = &ptr->bst_max_buffers;
+  reply_data->options.bst_convert_table_ptr = ptr->bst_convert_table;
         /* copy the collect params into options fields of the request */
   BST_COPY_COLLECT_TO_RESP (pCollect, pResp);
 
@@ -793,22 +1071,32 @@ BVIEW_STATUS bst_copy_reply_params (BVIEW_BST_REQUEST_MSG_t * msg_data,
           reply_data->options.reportTrigger = true;
           reply_data->options.reportThreshold = false;
           reply_data->cookie = NULL;
-          reply_data->options.triggerInfo = msg_data->triggerInfo;
+          /* the report names the realm and the counter by their ids */
+          reply_data->options.triggerInfo = msg_data->trigger;
           reply_data->options.sendSnapShotOnTrigger = ptr->bst_data->bst_config.config.sendSnapshotOnTrigger;
           if(false == reply_data->options.sendSnapShotOnTrigger)
           {
             BST_COPY_TO_RESP(pResp, false);
             /* Set the only the desired realm to true */
-            bst_set_realm_to_collect(msg_data->triggerInfo.realm, pResp);
+            bst_set_realm_to_collect(msg_data->trigger.realm, pResp);
           }
         }
 
         /* update the data, i.e make the active record as new backup
-           and current record as new active */
-        bst_update_data (BVIEW_BST_STATS, msg_data->unit);
+           and current record as new active. A request sharing the
+           last collection finds it in the active record already */
+        if (true == ptr->report_cache.reuse)
+        {
+          ptr->report_cache.reuse = false;
+        }
+        else
+        {
+          bst_update_data (BVIEW_BST_STATS, msg_data->unit);
+        }
 
         /* assign the active records */
         reply_data->response.report.active = ptr->stats_active_record_ptr;
+        reply_data->options.stale = ptr->stats_active_record_ptr->stale;
 
         /* copy the backup record ptr if and only if the report is periodic */
 
@@ -817,14 +1105,18 @@ BVIEW_STATUS bst_copy_reply_params (BVIEW_BST_REQUEST_MSG_t * msg_data,
             reply_data->options.sendIncrementalReport = 
                  ptr->bst_data->bst_config.config.sendIncrementalReport;
 
-          /* check if complete report is configured */
-          if (false == ptr->bst_data->bst_config.config.sendIncrementalReport)
+          /* the periodic stream is a difference to what it last sent,
+             whatever was pulled in between. A complete report, or a
+             keyframe, goes out with no baseline */
+          if (BVIEW_STATUS_SUCCESS != bst_consumer_report_prepare (msg_data->unit,
+                                          BVIEW_BST_CONSUMER_PERIODIC,
+                                          ptr->stats_active_record_ptr,
+                                          ptr->bst_data->bst_config.config.sendIncrementalReport,
+                                          &reply_data->response.report.backup,
+                                          &reply_data->options.sequenceNumber,
+                                          &reply_data->options.keyframe))
           {
-            reply_data->response.report.backup = NULL;
-          }
-          else
-          {
-            reply_data->response.report.backup = ptr->stats_backup_record_ptr;
+            return BVIEW_STATUS_FAILURE;
           }
           reply_data->cookie = NULL;
         }
@@ -842,6 +1134,49 @@ BVIEW_STATUS bst_copy_reply_params (BVIEW_BST_REQUEST_MSG_t * msg_data,
 
         reply_data->options.statsInPercentage = 
           ptr->bst_data->bst_config.config.statsInPercentage;
+
+        /* reports go out in the configured encoding, unless
+           a get-bst-report request asks for another one */
+        reply_data->options.reportFormat =
+          ptr->bst_data->bst_config.config.reportFormat;
+        if ((BVIEW_BST_STATS_PERIODIC != msg_data->report_type) &&
+            (BVIEW_BST_STATS_TRIGGER != msg_data->report_type) &&
+            (BSTJSON_REPORT_FORMAT_CONFIGURED != pCollect->reportFormat))
+        {
+          reply_data->options.reportFormat = pCollect->reportFormat;
+        }
+
+        /* same for the layout of the realm data */
+        reply_data->options.reportLayout =
+          ptr->bst_data->bst_config.config.reportLayout;
+        if ((BVIEW_BST_STATS_PERIODIC != msg_data->report_type) &&
+            (BVIEW_BST_STATS_TRIGGER != msg_data->report_type) &&
+            (BSTJSON_REPORT_LAYOUT_CONFIGURED != pCollect->reportLayout))
+        {
+          reply_data->options.reportLayout = pCollect->reportLayout;
+        }
+
+        /* periodic reports carry the configured filter, a get-bst-report
+           request its own one. trigger reports are not filtered */
+        if (BVIEW_BST_STATS_PERIODIC == msg_data->report_type)
+        {
+          reply_data->options.filter =
+            ptr->bst_data->bst_config.config.reportFilter;
+        }
+        else if (BVIEW_BST_STATS_TRIGGER != msg_data->report_type)
+        {
+          reply_data->options.filter = pCollect->filter;
+        }
+
+        /* get-bst-report requests of one freshness window, asking for
+           the same report, share its encoding */
+        if ((BVIEW_BST_STATS_PERIODIC != msg_data->report_type) &&
+            (BVIEW_BST_STATS_TRIGGER != msg_data->report_type) &&
+            (0 != ptr->bst_data->bst_config.config.coalesceWindow))
+        {
+          reply_data->coalesce = true;
+          reply_data->cacheGeneration = ptr->report_cache.generation;
+        }
       }
       break;
 
@@ -872,6 +1207,88 @@ BVIEW_STATUS bst_copy_reply_params (BVIEW_BST_REQUEST_MSG_t * msg_data,
   return bst_send_response(reply_data);
 }
 
+/*********************************************************************
+* @brief   :  reads the queue wait statistics of a lane
+*
+* @param[in]   lane   : lane of the request queue
+* @param[out]  pStats : statistics of the lane
+*
+* @retval  : BVIEW_STATUS_SUCCESS : statistics read
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note  : the counters are updated atomically by the bst thread. Each
+*          one is read whole, but a read racing an update may see the
+*          request count of one request and the wait time of another.
+*
+*********************************************************************/
+BVIEW_STATUS bst_lane_stats_get (BVIEW_BST_LANE_t lane,
+                                 BVIEW_BST_LANE_STATS_t *pStats)
+{
+  BVIEW_BST_LANE_STATS_t *stats;
+
+  if ((lane < BVIEW_BST_LANE_CONTROL) || (lane > BVIEW_BST_LANE_MAX) ||
+      (NULL == pStats))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  stats = &bst_info.laneStats[lane];
+  pStats->requests = __atomic_load_n (&stats->requests, __ATOMIC_RELAXED);
+  pStats->totalWait = __atomic_load_n (&stats->totalWait, __ATOMIC_RELAXED);
+  pStats->maxWait = __atomic_load_n (&stats->maxWait, __ATOMIC_RELAXED);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief   :  dumps the queue wait statistics of the lanes
+*
+* @param[in]  : none
+*
+* @retval  : none
+*
+*********************************************************************/
+static void bst_lane_stats_dump (void)
+{
+  BVIEW_BST_LANE_STATS_t stats;
+  BVIEW_BST_LANE_t lane;
+
+  for (lane = BVIEW_BST_LANE_CONTROL; lane <= BVIEW_BST_LANE_MAX; lane++)
+  {
+    if (BVIEW_STATUS_SUCCESS != bst_lane_stats_get (lane, &stats))
+    {
+      continue;
+    }
+    printf (" %-7s Lane : Requests %" PRIu64 " -- Average Wait %" PRIu64
+            " us -- Longest Wait %" PRIu64 " us \n",
+            (BVIEW_BST_LANE_CONTROL == lane) ? "Control" : "Data",
+            stats.requests,
+            (0 != stats.requests) ? (stats.totalWait / stats.requests) : 0,
+            stats.maxWait);
+  }
+  printf ("\n");
+}
+
+/*********************************************************************
+* @brief   :  dumps the internal statistics of the bst application
+*
+* @param[in]  : none
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_debug_dump (void)
+{
+  printf (" BST Request Queue Statistics \n\n");
+  bst_msg_stats_dump ();
+  bst_lane_stats_dump ();
+
+  printf (" BST Report Pipeline Statistics \n\n");
+  bst_pipeline_stats_dump ();
+
+  printf (" BST Report Cache Statistics \n\n");
+  bst_report_cache_stats_dump ();
+
+  bstjson_memory_dump ();
+}
+
 /*********************************************************************
 * @brief   :  function to post message to the bst application  
 *
@@ -889,11 +1306,24 @@ BVIEW_STATUS bst_send_request (BVIEW_BST_REQUEST_MSG_t * msg_data)
 {
   int rv = BVIEW_STATUS_SUCCESS;
   struct mq_attr obuf; /* output attr struct for getattr */
+  BVIEW_BST_QUEUE_MSG_t queue_msg;
 
   if (NULL == msg_data)
     return BVIEW_STATUS_INVALID_PARAMETER;
 
-  if (-1 == msgsnd (bst_info.recvMsgQid, msg_data, sizeof (BVIEW_BST_REQUEST_MSG_t), IPC_NOWAIT))
+  queue_msg.lane = bst_request_lane_get (msg_data->msg_type);
+  clock_gettime (CLOCK_MONOTONIC, &queue_msg.enqueueTime);
+  rv = bst_request_pack (msg_data, &queue_msg);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+              "Failed to pack message to bst application,  msg_type  %ld, err = %d\r\n",
+              msg_data->msg_type, rv);
+    return rv;
+  }
+
+  if (-1 == msgsnd (bst_info.recvMsgQid, &queue_msg,
+                    sizeof (BVIEW_BST_QUEUE_MSG_t) - sizeof (long), IPC_NOWAIT))
   {
     if ( ! mq_getattr(bst_info.recvMsgQid,&obuf) )
     {
@@ -904,8 +1334,13 @@ BVIEW_STATUS bst_send_request (BVIEW_BST_REQUEST_MSG_t * msg_data)
     LOG_POST (BVIEW_LOG_ERROR,
               "Failed to send message to bst application,  msg_type  %ld, err = %d\r\n",
               msg_data->msg_type, errno);
+    bst_request_release (&queue_msg);
     rv = BVIEW_STATUS_FAILURE;
   }
+  else
+  {
+    bst_msg_enqueue_account (&queue_msg);
+  }
 
   return rv;
 }
@@ -961,6 +1396,7 @@ BVIEW_STATUS bst_periodic_collection_cb (union sigval sigval)
 void bst_app_uninit ()
 {
   int id = 0, num_units;
+  int consumer, buf;
   pthread_mutex_t *bst_mutex;
   pthread_rwlock_t *bst_configRWLock;
 
@@ -1007,10 +1443,31 @@ void bst_app_uninit ()
       free (bst_info.unit[id].stats_current_record_ptr);
     }
 
+    if (NULL != bst_info.unit[id].report_cache.buffer)
+    {
+      bstjson_memory_free (bst_info.unit[id].report_cache.buffer);
+    }
+
+    for (consumer = 0; consumer < BVIEW_BST_CONSUMER_MAX; consumer++)
+    {
+      for (buf = 0; buf < 2; buf++)
+      {
+        if (NULL != bst_info.unit[id].consumers[consumer].baseline[buf])
+        {
+          free (bst_info.unit[id].consumers[consumer].baseline[buf]);
+        }
+      }
+    }
+
     if (NULL != bst_info.unit[id].threshold_record_ptr)
     {
       free (bst_info.unit[id].threshold_record_ptr);
     }
+
+    if (NULL != bst_info.unit[id].bst_convert_table)
+    {
+      free (bst_info.unit[id].bst_convert_table);
+    }
   }
   
   /* check if the message queue already exists.
@@ -1053,6 +1510,8 @@ BVIEW_STATUS bst_main ()
 {
   unsigned int id = 0, num_units = 0;
   int rv = BVIEW_STATUS_SUCCESS;
+  int consumer, buf;
+  bool baselinesAllocated;
   int recvMsgQid;
   pthread_rwlock_t *bst_configRWLock;
 
@@ -1106,11 +1565,34 @@ BVIEW_STATUS bst_main ()
       (BVIEW_BST_REPORT_SNAPSHOT_t *)
       malloc (sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
 
+    /* percentage conversion factors */
+    bst_info.unit[id].bst_convert_table =
+      (BSTJSON_CONVERT_TABLE_t *)
+      malloc (sizeof (BSTJSON_CONVERT_TABLE_t));
+
+    /* baselines of the incremental report streams */
+    baselinesAllocated = true;
+    for (consumer = 0; consumer < BVIEW_BST_CONSUMER_MAX; consumer++)
+    {
+      for (buf = 0; buf < 2; buf++)
+      {
+        bst_info.unit[id].consumers[consumer].baseline[buf] =
+          (BVIEW_BST_REPORT_SNAPSHOT_t *)
+          malloc (sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
+        if (NULL == bst_info.unit[id].consumers[consumer].baseline[buf])
+        {
+          baselinesAllocated = false;
+        }
+      }
+    }
+
     if ((NULL == bst_info.unit[id].bst_data) ||
+        (false == baselinesAllocated) ||
         (NULL == bst_info.unit[id].stats_active_record_ptr) ||
         (NULL == bst_info.unit[id].stats_backup_record_ptr) ||
         (NULL == bst_info.unit[id].stats_current_record_ptr) ||
-        (NULL == bst_info.unit[id].threshold_record_ptr))
+        (NULL == bst_info.unit[id].threshold_record_ptr) ||
+        (NULL == bst_info.unit[id].bst_convert_table))
     {
       /* Free the resources allocated so far */
       bst_app_uninit ();
@@ -1132,11 +1614,39 @@ BVIEW_STATUS bst_main ()
     memset (bst_info.unit[id].stats_current_record_ptr, 0,
             sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
 
+    /* no report sent yet, the first one of each stream is a keyframe */
+    for (consumer = 0; consumer < BVIEW_BST_CONSUMER_MAX; consumer++)
+    {
+      for (buf = 0; buf < 2; buf++)
+      {
+        memset (bst_info.unit[id].consumers[consumer].baseline[buf], 0,
+                sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
+      }
+      bst_info.unit[id].consumers[consumer].current = 0;
+      bst_info.unit[id].consumers[consumer].valid = false;
+      bst_info.unit[id].consumers[consumer].sequenceNumber = 0;
+      bst_info.unit[id].consumers[consumer].sinceKeyframe = 0;
+    }
+
+    /* nothing collected yet */
+    memset (&bst_info.unit[id].report_cache, 0, sizeof (BVIEW_BST_REPORT_CACHE_t));
+
     memset (bst_info.unit[id].threshold_record_ptr, 0,
             sizeof (BVIEW_BST_REPORT_SNAPSHOT_t));
+
+    memset (bst_info.unit[id].bst_convert_table, 0,
+            sizeof (BSTJSON_CONVERT_TABLE_t));
   }
 
     bstjson_memory_init();
+    bstjson_diff_init();
+    bstjson_parallel_init(BSTJSON_PARALLEL_THREADS_AUTO);
+    bstjson_header_init();
+  /* pool of the queued request parameters */
+  if (BVIEW_STATUS_SUCCESS != bst_msg_init ())
+  {
+    return BVIEW_STATUS_INIT_FAILED;
+  }
   LOG_POST (BVIEW_LOG_INFO,
               "bst application: bst memory allocated successfully\r\n");
 
@@ -1189,6 +1699,14 @@ BVIEW_STATUS bst_main ()
   }
   bst_info.recvMsgQid = recvMsgQid;
 
+  /* reports are encoded and sent by their own threads. without them
+     the bst thread does it, as before */
+  if (BVIEW_STATUS_SUCCESS != bst_pipeline_init ())
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+              "bst application: reports are encoded by the bst thread\r\n");
+  }
+
    /* create pthread for bst application */
   if (0 != pthread_create (&bst_info.bst_thread, NULL, (void *) &bst_app_main, NULL))
   {
@@ -1267,72 +1785,56 @@ BVIEW_STATUS bst_main ()
 *
 *********************************************************************/
 
-void bst_set_realm_to_collect(char *realm, BVIEW_BST_REPORT_OPTIONS_t *options)
+void bst_set_realm_to_collect(BVIEW_BST_REALM_ID_t realm, BVIEW_BST_REPORT_OPTIONS_t *options)
 {
-  if (0 == strcmp("device", realm))
+  switch (realm)
   {
-    options->includeDevice = true;
-    return;
-  }
-  
-  if (0 == strcmp("ingress-service-pool", realm))
-  {
-    options->includeIngressServicePool = true;
-    return;
-  }
+    case BVIEW_BST_DEVICE:
+      options->includeDevice = true;
+      break;
 
-  if (0 == strcmp("ingress-port-service-pool", realm))
-  {
-    options->includeIngressPortServicePool = true;
-    return;
-  }
-  
-  if (0 == strcmp("ingress-port-priority-group", realm))
-  {
-    options->includeIngressPortPriorityGroup = true;
-    return;
-  }
+    case BVIEW_BST_INGRESS_SP:
+      options->includeIngressServicePool = true;
+      break;
 
-  if (0 == strcmp("egress-port-service-pool", realm))
-  {
-    options->includeEgressPortServicePool = true;
-    return;
-  }
+    case BVIEW_BST_INGRESS_PORT_SP:
+      options->includeIngressPortServicePool = true;
+      break;
 
-  if (0 == strcmp("egress-service-pool", realm))
-  {
-    options->includeEgressServicePool = true;
-    return;
-  }
+    case BVIEW_BST_INGRESS_PORT_PG:
+      options->includeIngressPortPriorityGroup = true;
+      break;
 
-  if (0 == strcmp("egress-uc-queue", realm))
-  {
-    options->includeEgressUcQueue = true;
-    return;
-  }
+    case BVIEW_BST_EGRESS_PORT_SP:
+      options->includeEgressPortServicePool = true;
+      break;
 
-  if (0 == strcmp("egress-uc-queue-group", realm))
-  {
-    options->includeEgressUcQueueGroup = true;
-    return;
-  }
+    case BVIEW_BST_EGRESS_SP:
+      options->includeEgressServicePool = true;
+      break;
 
-  if (0 == strcmp("egress-mc-queue", realm))
-  {
-    options->includeEgressMcQueue = true;
-    return;
-  }
+    case BVIEW_BST_EGRESS_UC_QUEUE:
+      options->includeEgressUcQueue = true;
+      break;
 
-  if (0 == strcmp("egress-cpu-queue", realm))
-  {
-    options->includeEgressCpuQueue = true;
-    return;
-  }
+    case BVIEW_BST_EGRESS_UC_QUEUEGROUPS:
+      options->includeEgressUcQueueGroup = true;
+      break;
 
-  if (0 == strcmp("egress-rqe-queue", realm))
-  {
-    options->includeEgressRqeQueue = true;
-    return;
+    case BVIEW_BST_EGRESS_MC_QUEUE:
+      options->includeEgressMcQueue = true;
+      break;
+
+    case BVIEW_BST_EGRESS_CPU_QUEUE:
+      options->includeEgressCpuQueue = true;
+      break;
+
+    case BVIEW_BST_EGRESS_RQE_QUEUE:
+      options->includeEgressRqeQueue = true;
+      break;
+
+    default:
+      break;
   }
 
   return;
@@ -0,0 +1,289 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_report.h"
+#include "bst_json_encoder.h"
+#include "json_slab.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "openapps_log_api.h"
+
+/* Requests are queued as a fixed header. The realm and the counter of
+ * a trigger travel as registry ids (bst_registry.h). The parameters of the
+ * requests carrying some (configuration, get-bst-report) stay in a
+ * buffer of the request pool, the header points to it.
+ */
+
+/* buffers of the request pool */
+#define BVIEW_BST_MSG_POOL_INITIAL_SLICES   16
+#define BVIEW_BST_MSG_POOL_MAX_SLICES       64
+
+static int bstMsgPoolClass = -1;
+
+static pthread_mutex_t bstMsgStatsLock = PTHREAD_MUTEX_INITIALIZER;
+static BVIEW_BST_MSG_STATS_t bstMsgStats;
+
+/*********************************************************************
+* @brief : tells if a request carries parameters
+*
+*********************************************************************/
+static bool bst_request_payload_carried (const BVIEW_BST_REQUEST_MSG_t *msg_data)
+{
+  switch (msg_data->msg_type)
+  {
+    case BVIEW_BST_CMD_API_SET_TRACK:
+    case BVIEW_BST_CMD_API_SET_FEATURE:
+    case BVIEW_BST_CMD_API_SET_THRESHOLD:
+    case BVIEW_BST_CMD_API_UPDATE_TRACK:
+    case BVIEW_BST_CMD_API_UPDATE_FEATURE:
+      return true;
+
+    case BVIEW_BST_CMD_API_GET_REPORT:
+    case BVIEW_BST_CMD_API_GET_THRESHOLD:
+      /* periodic and trigger reports take what is tracked */
+      return ((BVIEW_BST_STATS_PERIODIC != msg_data->report_type) &&
+              (BVIEW_BST_STATS_TRIGGER != msg_data->report_type));
+
+    default:
+      return false;
+  }
+}
+
+/*********************************************************************
+* @brief : creates the pool of the request parameters
+*
+* @retval  : BVIEW_STATUS_SUCCESS : pool created
+* @retval  : other : the pool could not be created
+*
+*********************************************************************/
+BVIEW_STATUS bst_msg_init (void)
+{
+  BVIEW_STATUS rv;
+
+  /* the parameters are freed by the bst threads, allocated by
+     the others, a per thread cache does not help */
+  rv = json_slab_class_create ("bst-request", sizeof (BVIEW_BST_REQUEST_PAYLOAD_t),
+                               BVIEW_BST_MSG_POOL_INITIAL_SLICES,
+                               BVIEW_BST_MSG_POOL_MAX_SLICES, 0, &bstMsgPoolClass);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    LOG_POST (BVIEW_LOG_ERROR,
+        "Failed to create the bst request pool, err = %d\r\n", rv);
+    return rv;
+  }
+
+  pthread_mutex_lock (&bstMsgStatsLock);
+  bstMsgStats.queuedSize = sizeof (BVIEW_BST_QUEUE_MSG_t) - sizeof (long);
+  bstMsgStats.payloadSize = sizeof (BVIEW_BST_REQUEST_PAYLOAD_t);
+  pthread_mutex_unlock (&bstMsgStatsLock);
+
+  LOG_POST (BVIEW_LOG_INFO,
+      "bst requests are queued in %u bytes, %u more in the pool for their "
+      "parameters, %u bytes unpacked\r\n",
+      (unsigned int) (sizeof (BVIEW_BST_QUEUE_MSG_t) - sizeof (long)),
+      (unsigned int) sizeof (BVIEW_BST_REQUEST_PAYLOAD_t),
+      (unsigned int) sizeof (BVIEW_BST_REQUEST_MSG_t));
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : packs a request for a queue
+*
+* @param[in]   msg_data  : request
+* @param[out]  queue_msg : header to post, with the parameters in a
+*                          buffer of the request pool
+*
+* @retval  : BVIEW_STATUS_SUCCESS : request packed
+* @retval  : BVIEW_STATUS_OUTOFMEMORY : no buffer in the request pool
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note : the lane of the message is left to the caller. If the
+*         message is not posted, bst_request_release() frees it.
+*
+*********************************************************************/
+BVIEW_STATUS bst_request_pack (const BVIEW_BST_REQUEST_MSG_t *msg_data,
+                               BVIEW_BST_QUEUE_MSG_t *queue_msg)
+{
+  BVIEW_BST_MSG_HDR_t *hdr;
+  uint8_t *buffer = NULL;
+
+  if ((NULL == msg_data) || (NULL == queue_msg))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  hdr = &queue_msg->hdr;
+  hdr->cookie = msg_data->cookie;
+  hdr->payload = NULL;
+  hdr->msg_type = (int32_t) msg_data->msg_type;
+  hdr->unit = msg_data->unit;
+  hdr->id = msg_data->id;
+  hdr->version = (uint8_t) msg_data->version;
+  hdr->report_type = (uint8_t) msg_data->report_type;
+  hdr->threshold_type = (uint8_t) msg_data->threshold_type;
+  hdr->trigger = msg_data->trigger;
+
+  if (true == bst_request_payload_carried (msg_data))
+  {
+    if (BVIEW_STATUS_SUCCESS != json_slab_allocate (bstMsgPoolClass, &buffer))
+    {
+      pthread_mutex_lock (&bstMsgStatsLock);
+      bstMsgStats.poolFailures++;
+      pthread_mutex_unlock (&bstMsgStatsLock);
+      return BVIEW_STATUS_OUTOFMEMORY;
+    }
+    hdr->payload = (BVIEW_BST_REQUEST_PAYLOAD_t *) buffer;
+    hdr->payload->threshold = msg_data->threshold;
+    memcpy (&hdr->payload->request, &msg_data->request, sizeof (msg_data->request));
+  }
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : unpacks a request read from a queue
+*
+* @param[in]   queue_msg : header read
+* @param[out]  msg_data  : request
+*
+* @note : the parameters go back to the request pool.
+*
+*********************************************************************/
+void bst_request_unpack (BVIEW_BST_QUEUE_MSG_t *queue_msg,
+                         BVIEW_BST_REQUEST_MSG_t *msg_data)
+{
+  BVIEW_BST_MSG_HDR_t *hdr = &queue_msg->hdr;
+
+  memset (msg_data, 0, sizeof (BVIEW_BST_REQUEST_MSG_t));
+  msg_data->msg_type = hdr->msg_type;
+  msg_data->unit = hdr->unit;
+  msg_data->cookie = hdr->cookie;
+  msg_data->id = hdr->id;
+  msg_data->version = hdr->version;
+  msg_data->report_type = (BVIEW_BST_REPORT_TYPE_t) hdr->report_type;
+  msg_data->threshold_type = hdr->threshold_type;
+  msg_data->trigger = hdr->trigger;
+
+  if (NULL != hdr->payload)
+  {
+    msg_data->threshold = hdr->payload->threshold;
+    memcpy (&msg_data->request, &hdr->payload->request, sizeof (msg_data->request));
+    bst_request_release (queue_msg);
+  }
+}
+
+/*********************************************************************
+* @brief : frees a packed request that could not be posted
+*
+* @param[in]   queue_msg : header
+*
+*********************************************************************/
+void bst_request_release (BVIEW_BST_QUEUE_MSG_t *queue_msg)
+{
+  if (NULL != queue_msg->hdr.payload)
+  {
+    json_slab_free ((uint8_t *) queue_msg->hdr.payload);
+    queue_msg->hdr.payload = NULL;
+  }
+}
+
+/*********************************************************************
+* @brief : accounts for a request posted to a queue
+*
+* @param[in]   queue_msg : request posted, its enqueue time is when
+*                          packing started
+*
+*********************************************************************/
+void bst_msg_enqueue_account (const BVIEW_BST_QUEUE_MSG_t *queue_msg)
+{
+  const struct timespec *start = &queue_msg->enqueueTime;
+  struct timespec now;
+  uint64_t time;
+
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  time = (uint64_t) ((((long long) (now.tv_sec - start->tv_sec)) * 1000000000) +
+                     (now.tv_nsec - start->tv_nsec));
+
+  pthread_mutex_lock (&bstMsgStatsLock);
+  bstMsgStats.requests++;
+  if (NULL != queue_msg->hdr.payload)
+  {
+    bstMsgStats.payloads++;
+  }
+  bstMsgStats.totalEnqueueTime += time;
+  if (time > bstMsgStats.maxEnqueueTime)
+  {
+    bstMsgStats.maxEnqueueTime = time;
+  }
+  pthread_mutex_unlock (&bstMsgStatsLock);
+}
+
+/*********************************************************************
+* @brief : reads the statistics of the request queues
+*
+* @param[out]  pStats : statistics
+*
+* @retval  : BVIEW_STATUS_SUCCESS : statistics read
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+*********************************************************************/
+BVIEW_STATUS bst_msg_stats_get (BVIEW_BST_MSG_STATS_t *pStats)
+{
+  if (NULL == pStats)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  pthread_mutex_lock (&bstMsgStatsLock);
+  *pStats = bstMsgStats;
+  pthread_mutex_unlock (&bstMsgStatsLock);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief : dumps the statistics of the request queues
+*
+* @param[in]  : none
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_msg_stats_dump (void)
+{
+  BVIEW_BST_MSG_STATS_t stats;
+
+  if (BVIEW_STATUS_SUCCESS != bst_msg_stats_get (&stats))
+  {
+    return;
+  }
+
+  printf (" Queued Size %u bytes -- Payload Size %u bytes \n",
+          stats.queuedSize, stats.payloadSize);
+  printf (" Requests %" PRIu64 " -- Payloads %" PRIu64 " -- Pool Failures %" PRIu64 " \n",
+          stats.requests, stats.payloads, stats.poolFailures);
+  printf (" Average Enqueue Time %" PRIu64 " ns -- Longest Enqueue Time %" PRIu64 " ns \n\n",
+          (0 != stats.requests) ? (stats.totalEnqueueTime / stats.requests) : 0,
+          stats.maxEnqueueTime);
+}
@@ -49,28 +49,27 @@
   *********************************************************************/
 static unsigned int bst_realm_type_get (char *str)
 {
-  unsigned int i = 0;
-
-  const BVIEW_BST_REALM_THRESHOLD_t realm_threshold_map[] = {
-    {"device", BVIEW_BST_DEVICE_THRESHOLD},
-    {"ingress-port-priority-group", BVIEW_BST_INGRESS_PORT_PG_THRESHOLD},
-    {"ingress-port-service-pool", BVIEW_BST_INGRESS_PORT_SP_THRESHOLD},
-    {"ingress-service-pool", BVIEW_BST_INGRESS_SP_THRESHOLD},
-    {"egress-port-service-pool", BVIEW_BST_EGRESS_PORT_SP_THRESHOLD},
-    {"egress-service-pool", BVIEW_BST_EGRESS_SP_THRESHOLD},
-    {"egress-uc-queue", BVIEW_BST_EGRESS_UC_QUEUE_THRESHOLD},
-    {"egress-uc-queue-group", BVIEW_BST_EGRESS_UC_QUEUEGROUPS_THRESHOLD},
-    {"egress-mc-queue", BVIEW_BST_EGRESS_MC_QUEUE_THRESHOLD},
-    {"egress-cpu-queue", BVIEW_BST_EGRESS_CPU_QUEUE_THRESHOLD},
-    {"egress-rqe-queue", BVIEW_BST_EGRESS_RQE_QUEUE_THRESHOLD}
+  /* threshold type of a realm, by registry id */
+  static const BVIEW_BST_THRESHOLD_TYPE_t realm_threshold_map[BVIEW_BST_COUNT] = {
+    [BVIEW_BST_DEVICE] = BVIEW_BST_DEVICE_THRESHOLD,
+    [BVIEW_BST_INGRESS_PORT_PG] = BVIEW_BST_INGRESS_PORT_PG_THRESHOLD,
+    [BVIEW_BST_INGRESS_PORT_SP] = BVIEW_BST_INGRESS_PORT_SP_THRESHOLD,
+    [BVIEW_BST_INGRESS_SP] = BVIEW_BST_INGRESS_SP_THRESHOLD,
+    [BVIEW_BST_EGRESS_PORT_SP] = BVIEW_BST_EGRESS_PORT_SP_THRESHOLD,
+    [BVIEW_BST_EGRESS_SP] = BVIEW_BST_EGRESS_SP_THRESHOLD,
+    [BVIEW_BST_EGRESS_UC_QUEUE] = BVIEW_BST_EGRESS_UC_QUEUE_THRESHOLD,
+    [BVIEW_BST_EGRESS_UC_QUEUEGROUPS] = BVIEW_BST_EGRESS_UC_QUEUEGROUPS_THRESHOLD,
+    [BVIEW_BST_EGRESS_MC_QUEUE] = BVIEW_BST_EGRESS_MC_QUEUE_THRESHOLD,
+    [BVIEW_BST_EGRESS_CPU_QUEUE] = BVIEW_BST_EGRESS_CPU_QUEUE_THRESHOLD,
+    [BVIEW_BST_EGRESS_RQE_QUEUE] = BVIEW_BST_EGRESS_RQE_QUEUE_THRESHOLD
   };
-  for (i = BVIEW_BST_MAX_THRESHOLD_TYPE_MIN; i <= BVIEW_BST_MAX_THRESHOLD_TYPE_MAX; i++)
+  BVIEW_BST_REALM_ID_t realm;
+
+  realm = bst_registry_realm_id_get (str);
+  if (BVIEW_BST_REALM_UNKNOWN != realm)
   {
-    if (0 == strcmp (str, realm_threshold_map[i-1].realm))
-    {
-       _BST_LOG(_BST_DEBUG_TRACE, "requested realm %s found match for the realm type %d\n", str, realm_threshold_map[i-1].threshold);
-      return realm_threshold_map[i-1].threshold;
-    }
+    _BST_LOG(_BST_DEBUG_TRACE, "requested realm %s found match for the realm type %d\n", str, realm_threshold_map[realm]);
+    return realm_threshold_map[realm];
   }
 
   _BST_LOG(_BST_DEBUG_ERROR, "requested realm %s not found match for the realm type \n ", str);
@@ -242,8 +241,6 @@ BVIEW_STATUS bstjson_configure_bst_thresholds_impl (void *cookie, int asicId,
   msg_data.msg_type = BVIEW_BST_CMD_API_SET_THRESHOLD;
   msg_data.id = id;
 
-  memcpy (msg_data.realm, pCommand->realm, JSON_MAX_NODE_LENGTH);
-
   threshold_type = bst_realm_type_get (pCommand->realm);
 
   if (0 == threshold_type)
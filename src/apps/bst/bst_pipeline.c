@@ -0,0 +1,599 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ***************************************************************************/
+
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <errno.h>
+#include "configure_bst_thresholds.h"
+#include "configure_bst_feature.h"
+#include "configure_bst_tracking.h"
+#include "get_bst_report.h"
+#include "bst_json_memory.h"
+#include "bst_json_encoder.h"
+#include "bst.h"
+#include "broadview.h"
+#include "bst_app.h"
+#include "openapps_log_api.h"
+
+/* Reports go through three stages : the bst thread collects and
+ * prepares them, an encoding thread encodes them and a sending thread
+ * sends them. A streamed report skips the encoding thread, the sending
+ * thread encodes it chunk by chunk as it goes out. The stages share BVIEW_BST_PIPELINE_DEPTH job slots, so
+ * a unit can be collected while the report of another one, or an
+ * earlier report of the same one, is still encoded or sent.
+ *
+ * A queued report reads the records it was prepared from. The bst
+ * thread waits for them to be encoded before it collects into or
+ * clears one of them, see bst_pipeline_record_wait().
+ */
+
+typedef enum _bst_pipeline_job_state_ {
+  BVIEW_BST_JOB_FREE = 0,
+  BVIEW_BST_JOB_ENCODE,
+  BVIEW_BST_JOB_SEND
+}BVIEW_BST_PIPELINE_JOB_STATE_t;
+
+/* one report in the pipeline */
+typedef struct _bst_pipeline_job_ {
+  BVIEW_BST_PIPELINE_JOB_STATE_t state;
+  BVIEW_BST_RESPONSE_MSG_t reply;
+  /* records the encoder reads, until the report is encoded (sent,
+     for a streamed report) */
+  const void *records[2];
+  /* encoded report */
+  uint8_t *buffer;
+  int length;
+}BVIEW_BST_PIPELINE_JOB_t;
+
+/* bounded queue of job slots */
+typedef struct _bst_pipeline_queue_ {
+  int slots[BVIEW_BST_PIPELINE_DEPTH];
+  int head;
+  int count;
+}BVIEW_BST_PIPELINE_QUEUE_t;
+
+typedef struct _bst_pipeline_ {
+  bool running;
+  pthread_t encodeThread;
+  pthread_t sendThread;
+
+  /* protects the fields below */
+  pthread_mutex_t lock;
+  /* a job slot, or a record held by a job, got free */
+  pthread_cond_t jobDone;
+  pthread_cond_t encodeReady;
+  pthread_cond_t sendReady;
+
+  BVIEW_BST_PIPELINE_JOB_t jobs[BVIEW_BST_PIPELINE_DEPTH];
+  BVIEW_BST_PIPELINE_QUEUE_t encodeQueue;
+  BVIEW_BST_PIPELINE_QUEUE_t sendQueue;
+
+  BVIEW_BST_PIPELINE_STATS_t stats[BVIEW_BST_STAGE_MAX];
+}BVIEW_BST_PIPELINE_t;
+
+static BVIEW_BST_PIPELINE_t bst_pipeline = {
+  .running = false,
+  .lock = PTHREAD_MUTEX_INITIALIZER,
+  .jobDone = PTHREAD_COND_INITIALIZER,
+  .encodeReady = PTHREAD_COND_INITIALIZER,
+  .sendReady = PTHREAD_COND_INITIALIZER
+};
+
+/*********************************************************************
+* @brief : micro seconds elapsed since a time of the monotonic clock
+*
+*********************************************************************/
+static uint64_t bst_pipeline_elapsed (const struct timespec *since)
+{
+  struct timespec now;
+
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return (uint64_t) ((((long long) (now.tv_sec - since->tv_sec)) * 1000000) +
+                     ((now.tv_nsec - since->tv_nsec) / 1000));
+}
+
+/*********************************************************************
+* @brief : accounts for a report done by a stage
+*
+* @note : called with the pipeline lock held
+*
+*********************************************************************/
+static void bst_pipeline_stats_add (BVIEW_BST_PIPELINE_STAGE_t stage, uint64_t time)
+{
+  BVIEW_BST_PIPELINE_STATS_t *stats = &bst_pipeline.stats[stage];
+
+  stats->reports++;
+  stats->totalTime += time;
+  if (time > stats->maxTime)
+  {
+    stats->maxTime = time;
+  }
+}
+
+/*********************************************************************
+* @brief : queues a job slot for a stage
+*
+* @note : called with the pipeline lock held, the queue has room for
+*         every slot
+*
+*********************************************************************/
+static void bst_pipeline_push (BVIEW_BST_PIPELINE_QUEUE_t *queue,
+                               BVIEW_BST_PIPELINE_STAGE_t stage, int slot)
+{
+  BVIEW_BST_PIPELINE_STATS_t *stats = &bst_pipeline.stats[stage];
+
+  queue->slots[(queue->head + queue->count) % BVIEW_BST_PIPELINE_DEPTH] = slot;
+  queue->count++;
+
+  stats->depth = queue->count;
+  if (stats->depth > stats->maxDepth)
+  {
+    stats->maxDepth = stats->depth;
+  }
+}
+
+/*********************************************************************
+* @brief : waits for, and takes, the next job slot of a stage
+*
+* @note : called with the pipeline lock held, returns with it held
+*
+*********************************************************************/
+static int bst_pipeline_pop (BVIEW_BST_PIPELINE_QUEUE_t *queue,
+                             BVIEW_BST_PIPELINE_STAGE_t stage,
+                             pthread_cond_t *ready)
+{
+  int slot;
+
+  while (0 == queue->count)
+  {
+    pthread_cond_wait (ready, &bst_pipeline.lock);
+  }
+
+  slot = queue->slots[queue->head];
+  queue->head = (queue->head + 1) % BVIEW_BST_PIPELINE_DEPTH;
+  queue->count--;
+  bst_pipeline.stats[stage].depth = queue->count;
+
+  return slot;
+}
+
+/*********************************************************************
+* @brief : accounts for a report that was not encoded or not sent
+*
+* @param[in]  reply : response message of the report
+*
+* @note : a periodic report carries a sequence number. The collector
+*         did not get it, so the next one can not be a difference to
+*         it : the stream starts over with a keyframe.
+*         Called without the pipeline lock, bst_consumer_resync()
+*         takes the unit lock.
+*
+*********************************************************************/
+static void bst_pipeline_report_failed (const BVIEW_BST_RESPONSE_MSG_t *reply)
+{
+  if (0 != reply->options.sequenceNumber)
+  {
+    bst_consumer_resync (reply->unit);
+  }
+}
+
+/*********************************************************************
+* @brief : encoding thread, encodes the reports in the order they
+*          were collected
+*
+*********************************************************************/
+static void *bst_pipeline_encode_main (void *arg)
+{
+  BVIEW_BST_PIPELINE_JOB_t *job;
+  struct timespec start;
+  BVIEW_STATUS rv;
+  uint64_t time;
+  int slot;
+
+  (void) arg;
+
+  pthread_mutex_lock (&bst_pipeline.lock);
+  while (1)
+  {
+    slot = bst_pipeline_pop (&bst_pipeline.encodeQueue, BVIEW_BST_STAGE_ENCODE,
+                             &bst_pipeline.encodeReady);
+    job = &bst_pipeline.jobs[slot];
+
+    if (true == bst_report_streamed (&job->reply))
+    {
+      /* encoded by the sending thread as it goes out, the records
+         stay held until then */
+      job->state = BVIEW_BST_JOB_SEND;
+      bst_pipeline_push (&bst_pipeline.sendQueue, BVIEW_BST_STAGE_SEND, slot);
+      pthread_cond_signal (&bst_pipeline.sendReady);
+      continue;
+    }
+    pthread_mutex_unlock (&bst_pipeline.lock);
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    job->buffer = NULL;
+    job->length = 0;
+    rv = bst_report_encode (&job->reply, &job->buffer, &job->length);
+    time = bst_pipeline_elapsed (&start);
+
+    if (BVIEW_STATUS_SUCCESS != rv)
+    {
+      LOG_POST (BVIEW_LOG_ERROR,
+          "encoding of bst response failed due to error = %d\r\n", rv);
+      /* Can happen that memory is allocated,
+         but the encoding failed.. */
+      if (NULL != job->buffer)
+      {
+        bstjson_memory_free (job->buffer);
+        job->buffer = NULL;
+      }
+      bst_pipeline_report_failed (&job->reply);
+    }
+
+    pthread_mutex_lock (&bst_pipeline.lock);
+    bst_pipeline_stats_add (BVIEW_BST_STAGE_ENCODE, time);
+    /* the records may be written again */
+    job->records[0] = NULL;
+    job->records[1] = NULL;
+    if (NULL != job->buffer)
+    {
+      job->state = BVIEW_BST_JOB_SEND;
+      bst_pipeline_push (&bst_pipeline.sendQueue, BVIEW_BST_STAGE_SEND, slot);
+      pthread_cond_signal (&bst_pipeline.sendReady);
+    }
+    else
+    {
+      job->state = BVIEW_BST_JOB_FREE;
+    }
+    pthread_cond_broadcast (&bst_pipeline.jobDone);
+  }
+
+  /* not reached */
+  pthread_mutex_unlock (&bst_pipeline.lock);
+  return NULL;
+}
+
+/*********************************************************************
+* @brief : sending thread, sends the encoded reports in order
+*
+*********************************************************************/
+static void *bst_pipeline_send_main (void *arg)
+{
+  BVIEW_BST_PIPELINE_JOB_t *job;
+  struct timespec start;
+  BVIEW_STATUS rv;
+  uint64_t time;
+  int slot;
+
+  (void) arg;
+
+  pthread_mutex_lock (&bst_pipeline.lock);
+  while (1)
+  {
+    slot = bst_pipeline_pop (&bst_pipeline.sendQueue, BVIEW_BST_STAGE_SEND,
+                             &bst_pipeline.sendReady);
+    job = &bst_pipeline.jobs[slot];
+    pthread_mutex_unlock (&bst_pipeline.lock);
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    if (true == bst_report_streamed (&job->reply))
+    {
+      rv = bst_report_stream (&job->reply);
+    }
+    else
+    {
+      rv = bst_response_buffer_send (job->reply.cookie, job->buffer, job->length,
+                                     (BST_REPORT_FORMAT_BINARY == job->reply.options.reportFormat));
+    }
+    time = bst_pipeline_elapsed (&start);
+
+    if (BVIEW_STATUS_SUCCESS != rv)
+    {
+      bst_pipeline_report_failed (&job->reply);
+    }
+
+    pthread_mutex_lock (&bst_pipeline.lock);
+    bst_pipeline_stats_add (BVIEW_BST_STAGE_SEND, time);
+    job->records[0] = NULL;
+    job->records[1] = NULL;
+    job->buffer = NULL;
+    job->state = BVIEW_BST_JOB_FREE;
+    pthread_cond_broadcast (&bst_pipeline.jobDone);
+  }
+
+  /* not reached */
+  pthread_mutex_unlock (&bst_pipeline.lock);
+  return NULL;
+}
+
+/*********************************************************************
+* @brief   :  starts the encoding and sending threads of the reports
+*
+* @retval  : BVIEW_STATUS_SUCCESS : pipeline started
+* @retval  : BVIEW_STATUS_FAILURE : thread creation failed, reports
+*                                   are then encoded and sent by the
+*                                   bst thread
+*
+*********************************************************************/
+BVIEW_STATUS bst_pipeline_init (void)
+{
+  if (true == bst_pipeline.running)
+  {
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  if (0 != pthread_create (&bst_pipeline.encodeThread, NULL,
+                           bst_pipeline_encode_main, NULL))
+  {
+    LOG_POST (BVIEW_LOG_ERROR, "BST encoding thread creation failed %d\r\n", errno);
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  if (0 != pthread_create (&bst_pipeline.sendThread, NULL,
+                           bst_pipeline_send_main, NULL))
+  {
+    LOG_POST (BVIEW_LOG_ERROR, "BST sending thread creation failed %d\r\n", errno);
+    pthread_cancel (bst_pipeline.encodeThread);
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  bst_pipeline.running = true;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief   :  hands a report over to the encoding thread
+*
+* @param[in]  reply_data : response message of a report request
+*
+* @retval  : BVIEW_STATUS_SUCCESS : report queued
+* @retval  : other : the report could not be encoded or sent, when
+*                    there is no pipeline
+*
+* @note  : called by the bst thread, blocks while the pipeline is full.
+*          The records of the report are held until it is encoded,
+*          or sent for a streamed report.
+*
+*********************************************************************/
+BVIEW_STATUS bst_pipeline_submit (BVIEW_BST_RESPONSE_MSG_t *reply_data)
+{
+  BVIEW_BST_PIPELINE_JOB_t *job = NULL;
+  uint8_t *pBuffer = NULL;
+  int bufLength = 0;
+  uint64_t time;
+  BVIEW_STATUS rv;
+  int slot;
+
+  if (NULL == reply_data)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  time = bst_pipeline_elapsed (&reply_data->startTime);
+
+  if (false == bst_pipeline.running)
+  {
+    /* no threads, the bst thread does it all */
+    if (true == bst_report_streamed (reply_data))
+    {
+      rv = bst_report_stream (reply_data);
+    }
+    else
+    {
+      rv = bst_report_encode (reply_data, &pBuffer, &bufLength);
+      if (BVIEW_STATUS_SUCCESS == rv)
+      {
+        rv = bst_response_buffer_send (reply_data->cookie, pBuffer, bufLength,
+                                       (BST_REPORT_FORMAT_BINARY == reply_data->options.reportFormat));
+      }
+      else
+      {
+        LOG_POST (BVIEW_LOG_ERROR,
+            "encoding of bst response failed due to error = %d\r\n", rv);
+        if (NULL != pBuffer)
+        {
+          bstjson_memory_free (pBuffer);
+        }
+      }
+    }
+    if (BVIEW_STATUS_SUCCESS != rv)
+    {
+      bst_pipeline_report_failed (reply_data);
+    }
+    return rv;
+  }
+
+  pthread_mutex_lock (&bst_pipeline.lock);
+  bst_pipeline_stats_add (BVIEW_BST_STAGE_COLLECT, time);
+
+  /* wait for a free slot, the slowest stage sets the pace */
+  while (NULL == job)
+  {
+    for (slot = 0; slot < BVIEW_BST_PIPELINE_DEPTH; slot++)
+    {
+      if (BVIEW_BST_JOB_FREE == bst_pipeline.jobs[slot].state)
+      {
+        job = &bst_pipeline.jobs[slot];
+        break;
+      }
+    }
+    if (NULL == job)
+    {
+      pthread_cond_wait (&bst_pipeline.jobDone, &bst_pipeline.lock);
+    }
+  }
+
+  memcpy (&job->reply, reply_data, sizeof (BVIEW_BST_RESPONSE_MSG_t));
+  job->records[0] = reply_data->response.report.active;
+  job->records[1] = reply_data->response.report.backup;
+  job->state = BVIEW_BST_JOB_ENCODE;
+  bst_pipeline_push (&bst_pipeline.encodeQueue, BVIEW_BST_STAGE_ENCODE, slot);
+  pthread_cond_signal (&bst_pipeline.encodeReady);
+  pthread_mutex_unlock (&bst_pipeline.lock);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief   :  tells if a queued report reads a record
+*
+* @note  : called with the pipeline lock held
+*
+*********************************************************************/
+static bool bst_pipeline_record_held (unsigned int unit, const void *record)
+{
+  BVIEW_BST_PIPELINE_JOB_t *job;
+  int slot;
+
+  for (slot = 0; slot < BVIEW_BST_PIPELINE_DEPTH; slot++)
+  {
+    job = &bst_pipeline.jobs[slot];
+    if ((BVIEW_BST_JOB_FREE != job->state) &&
+        ((unsigned int) job->reply.unit == unit) &&
+        ((record == job->records[0]) || (record == job->records[1])))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*********************************************************************
+* @brief   :  waits until no queued report reads a record
+*
+* @param[in]  unit   : unit number
+* @param[in]  record : record about to be written
+*
+* @note  : called by the bst thread, without the unit lock, before
+*          a record is collected into or cleared. The encoding thread
+*          takes the unit lock, waiting with it held would dead lock.
+*
+*********************************************************************/
+void bst_pipeline_record_wait (unsigned int unit, const void *record)
+{
+  if ((false == bst_pipeline.running) || (NULL == record))
+  {
+    return;
+  }
+
+  pthread_mutex_lock (&bst_pipeline.lock);
+  while (true == bst_pipeline_record_held (unit, record))
+  {
+    pthread_cond_wait (&bst_pipeline.jobDone, &bst_pipeline.lock);
+  }
+  pthread_mutex_unlock (&bst_pipeline.lock);
+}
+
+/*********************************************************************
+* @brief   :  waits until no report of a unit is in the pipeline
+*
+* @param[in]  unit : unit number
+*
+* @note  : called by the bst thread, without the unit lock, before
+*          the unit data the encoders read (max buffers, conversion
+*          factors) is changed.
+*
+*********************************************************************/
+void bst_pipeline_unit_drain (unsigned int unit)
+{
+  bool busy = true;
+  int slot;
+
+  if (false == bst_pipeline.running)
+  {
+    return;
+  }
+
+  pthread_mutex_lock (&bst_pipeline.lock);
+  while (true == busy)
+  {
+    busy = false;
+    for (slot = 0; slot < BVIEW_BST_PIPELINE_DEPTH; slot++)
+    {
+      if ((BVIEW_BST_JOB_FREE != bst_pipeline.jobs[slot].state) &&
+          ((unsigned int) bst_pipeline.jobs[slot].reply.unit == unit))
+      {
+        busy = true;
+        break;
+      }
+    }
+    if (true == busy)
+    {
+      pthread_cond_wait (&bst_pipeline.jobDone, &bst_pipeline.lock);
+    }
+  }
+  pthread_mutex_unlock (&bst_pipeline.lock);
+}
+
+/*********************************************************************
+* @brief   :  reads the statistics of a pipeline stage
+*
+* @param[in]   stage  : stage
+* @param[out]  pStats : statistics of the stage
+*
+* @retval  : BVIEW_STATUS_SUCCESS : statistics read
+* @retval  : BVIEW_STATUS_INVALID_PARAMETER : invalid parameters to function.
+*
+* @note  : the collect stage time runs from the pick up of the request
+*          to its hand over, waiting for a free slot excluded.
+*
+*********************************************************************/
+BVIEW_STATUS bst_pipeline_stats_get (BVIEW_BST_PIPELINE_STAGE_t stage,
+                                     BVIEW_BST_PIPELINE_STATS_t *pStats)
+{
+  if ((stage >= BVIEW_BST_STAGE_MAX) || (NULL == pStats))
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
+  pthread_mutex_lock (&bst_pipeline.lock);
+  *pStats = bst_pipeline.stats[stage];
+  pthread_mutex_unlock (&bst_pipeline.lock);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief   :  dumps the statistics of the pipeline stages
+*
+* @param[in]  : none
+*
+* @retval  : none
+*
+*********************************************************************/
+void bst_pipeline_stats_dump (void)
+{
+  static const char *stageNames[BVIEW_BST_STAGE_MAX] = {
+    "Collect", "Encode", "Send"
+  };
+  BVIEW_BST_PIPELINE_STATS_t stats;
+  BVIEW_BST_PIPELINE_STAGE_t stage;
+
+  for (stage = BVIEW_BST_STAGE_COLLECT; stage < BVIEW_BST_STAGE_MAX; stage++)
+  {
+    if (BVIEW_STATUS_SUCCESS != bst_pipeline_stats_get (stage, &stats))
+    {
+      continue;
+    }
+    printf (" %-7s Stage : Reports %" PRIu64 " -- Average Time %" PRIu64
+            " us -- Longest Time %" PRIu64 " us -- Depth %u -- Max Depth %u \n",
+            stageNames[stage], stats.reports,
+            (0 != stats.reports) ? (stats.totalTime / stats.reports) : 0,
+            stats.maxTime, stats.depth, stats.maxDepth);
+  }
+  printf ("\n");
+}
@@ -44,44 +44,27 @@
 extern BVIEW_BST_CXT_t bst_info;
 /* BST rwlock for config data*/
 
-bool bst_trigger_index_get(char *realm, char *counter, unsigned int *val)
+/* BST id of a (realm, counter), plus one, 0 if the pair raises no trigger */
+#define BST_TRIGGER_INDEX_ENTRY(_index, _realm, _counter) \
+  [_realm][_counter] = (_index) + 1,
+
+static const uint8_t bst_trigger_index_map[BVIEW_BST_COUNT][BVIEW_BST_COUNTER_MAX] = {
+  BST_TRIGGER_INDEX_REGISTRY(BST_TRIGGER_INDEX_ENTRY)
+};
+
+bool bst_trigger_index_get(BVIEW_BST_REALM_ID_t realm, BVIEW_BST_COUNTER_ID_t counter,
+                           unsigned int *val)
 {
-  static BST_REALM_COUNTER_INDEX_t bst_realm_index_map [] = {
-    {BST_ID_DEVICE, "device" ,"data"},
-    {BST_ID_ING_POOL, "ingress-service-pool", "um-share-buffer-count"},
-    {BST_ID_PORT_POOL, "ingress-port-service-pool", "um-share-buffer-count" },
-    {BST_ID_PRI_GROUP_SHARED, "ingress-port-priority-group", "um-share-buffer-count"},
-    {BST_ID_PRI_GROUP_HEADROOM, "ingress-port-priority-group", "um-headroom-buffer-count"},
-    {BST_ID_EGR_POOL, "egress-service-pool", "um-share-buffer-count"},
-    {BST_ID_EGR_MCAST_POOL, "egress-service-pool", "mc-share-buffer-count"},
-    {BST_ID_UCAST, "egress-uc-queue", "uc-buffer-count"},
-    {BST_ID_MCAST, "egress-mc-queue", "mc-buffer-count"},
-    {BST_ID_EGR_UCAST_PORT_SHARED, "egress-port-service-pool", "uc-share-buffer-count"},
-    {BST_ID_EGR_PORT_SHARED, "egress-port-service-pool", "um-share-buffer-count"},
-    {BST_ID_RQE_QUEUE, "egress-rqe-queue", "rqe-buffer-count"},
-    {BST_ID_UCAST_GROUP, "egress-uc-queue-group", "uc-buffer-count"}
-  };
-
-  unsigned int i;
-
-  if ((NULL == realm) ||
-      (NULL == counter) || 
-      (NULL == val))
+  if ((NULL == val) ||
+      (realm < BVIEW_BST_REALM_ID_MIN) || (realm >= BVIEW_BST_REALM_ID_MAX) ||
+      (counter <= BVIEW_BST_COUNTER_UNKNOWN) || (counter >= BVIEW_BST_COUNTER_MAX) ||
+      (0 == bst_trigger_index_map[realm][counter]))
   {
     return false;
   }
 
-  for (i = 0; i <BST_ID_MAX; i++)
-  {
-    if ((0 == strcmp(realm, bst_realm_index_map[i].realm)) && 
-        (0 == strcmp (counter, bst_realm_index_map[i].counter)))
-    {
-      *val = bst_realm_index_map[i].index;
-      return true;
-    }
-  }
-
-  return false;
+  *val = bst_trigger_index_map[realm][counter] - 1;
+  return true;
 }
 
 /*********************************************************************
@@ -150,6 +133,7 @@ BVIEW_STATUS bst_enable_on_trigger(BVIEW_BST_REQUEST_MSG_t *msg_data, int bstEna
 
 BVIEW_STATUS bst_trigger_main(void)
 {
+  BVIEW_BST_QUEUE_MSG_t queue_msg;
   BVIEW_BST_REQUEST_MSG_t msg_data;
   BVIEW_STATUS rv = BVIEW_STATUS_FAILURE;
   unsigned int rcvd_err = 0;
@@ -158,8 +142,10 @@ BVIEW_STATUS bst_trigger_main(void)
 
   while (1)
   {
-    if (-1 != (msgrcv (bst_info.recvTriggerMsgQid, &msg_data, sizeof (msg_data), 0, 0))) 
+    if (-1 != (msgrcv (bst_info.recvTriggerMsgQid, &queue_msg,
+                       sizeof (BVIEW_BST_QUEUE_MSG_t) - sizeof (long), 0, 0))) 
     {
+      bst_request_unpack (&queue_msg, &msg_data);
       /* get num units */
        num_units = 0;
       if (BVIEW_STATUS_SUCCESS != sbapi_system_num_units_get ((int *) &num_units))
@@ -241,8 +227,8 @@ BVIEW_STATUS bst_process_trigger(BVIEW_BST_REQUEST_MSG_t *msg_data)
   unsigned int index = 0;
 
   /* check if the trigger report needs to be collected */
-  send_trigger = bst_trigger_index_get(msg_data->triggerInfo.realm, 
-                                       msg_data->triggerInfo.counter,
+  send_trigger = bst_trigger_index_get(msg_data->trigger.realm, 
+                                       msg_data->trigger.counter,
                                        &index);
   if (true == send_trigger)
   {
@@ -270,7 +256,7 @@ BVIEW_STATUS bst_process_trigger(BVIEW_BST_REQUEST_MSG_t *msg_data)
     bst_msg.unit = msg_data->unit;
     bst_msg.msg_type = BVIEW_BST_CMD_API_TRIGGER_REPORT;
     bst_msg.report_type = BVIEW_BST_STATS_TRIGGER;
-    memcpy(&bst_msg.triggerInfo, &msg_data->triggerInfo, sizeof(BVIEW_BST_TRIGGER_INFO_t));
+    bst_msg.trigger = msg_data->trigger;
 
     /* Send the message to the bst application */
     rv = bst_send_request (&bst_msg);
@@ -313,17 +299,33 @@ BVIEW_STATUS bst_process_trigger(BVIEW_BST_REQUEST_MSG_t *msg_data)
 BVIEW_STATUS bst_trigger_send_request (BVIEW_BST_REQUEST_MSG_t * msg_data)
 {
   int rv = BVIEW_STATUS_SUCCESS;
+  BVIEW_BST_QUEUE_MSG_t queue_msg;
 
   if (NULL == msg_data)
     return BVIEW_STATUS_INVALID_PARAMETER;
 
-  if (-1 == msgsnd (bst_info.recvTriggerMsgQid, msg_data, sizeof (BVIEW_BST_REQUEST_MSG_t), IPC_NOWAIT))
+  /* a single lane */
+  queue_msg.lane = BVIEW_BST_LANE_CONTROL;
+  clock_gettime (CLOCK_MONOTONIC, &queue_msg.enqueueTime);
+  rv = bst_request_pack (msg_data, &queue_msg);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    return rv;
+  }
+
+  if (-1 == msgsnd (bst_info.recvTriggerMsgQid, &queue_msg,
+                    sizeof (BVIEW_BST_QUEUE_MSG_t) - sizeof (long), IPC_NOWAIT))
   {
     LOG_POST (BVIEW_LOG_ERROR,
               "Failed to send message to bst application,  %ld, errno  %d\r\n",
               msg_data->msg_type, errno);
+    bst_request_release (&queue_msg);
     rv = BVIEW_STATUS_FAILURE;
   }
+  else
+  {
+    bst_msg_enqueue_account (&queue_msg);
+  }
 
   return rv;
 }
@@ -354,9 +356,13 @@ BVIEW_STATUS bst_trigger_cb (int unit, void *cookie,
   BVIEW_BST_REQUEST_MSG_t msg_data = {0};
   BVIEW_STATUS rv;
 
+  if (NULL == triggerInfo)
+    return BVIEW_STATUS_INVALID_PARAMETER;
+
   msg_data.unit = unit;
   msg_data.msg_type = BVIEW_BST_CMD_API_TRIGGER_COLLECT;
-  memcpy(&msg_data.triggerInfo, triggerInfo, sizeof(BVIEW_BST_TRIGGER_INFO_t));
+  /* the plugin names the realm and the counter by their registry ids */
+  msg_data.trigger = *triggerInfo;
 
   /* Send the message to the bst application */
   rv = bst_trigger_send_request (&msg_data);
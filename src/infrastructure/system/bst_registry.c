@@ -0,0 +1,231 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "broadview.h"
+#include "bst_registry.h"
+
+/* slots of a name hash table, a power of two well above the names */
+#define _REGISTRY_SLOTS             32
+
+#define _REGISTRY_REALM_ROW(_id, _name, _index1, _index2) \
+  [_id] = { _name, _index1, _index2 },
+#define _REGISTRY_COUNTER_ROW(_id, _name) \
+  [_id] = _name,
+
+/* realms by id, generated from the registry */
+static const BVIEW_BST_REGISTRY_REALM_t bstRegistryRealms[BVIEW_BST_COUNT] = {
+  [BVIEW_BST_REALM_UNKNOWN] = { "", NULL, NULL },
+  BVIEW_BST_REALM_REGISTRY(_REGISTRY_REALM_ROW)
+};
+
+/* counter names by id, generated from the registry */
+static const char *bstRegistryCounters[BVIEW_BST_COUNTER_MAX] = {
+  [BVIEW_BST_COUNTER_UNKNOWN] = "",
+  BVIEW_BST_COUNTER_REGISTRY(_REGISTRY_COUNTER_ROW)
+};
+
+/* ids by name hash, 0 for an empty slot */
+static int bstRegistryRealmSlots[_REGISTRY_SLOTS];
+static int bstRegistryCounterSlots[_REGISTRY_SLOTS];
+static pthread_once_t bstRegistryOnce = PTHREAD_ONCE_INIT;
+
+/******************************************************************
+ * @brief  FNV-1a hash of a name.
+ *
+ *********************************************************************/
+static unsigned int _registry_hash(const char *str)
+{
+  unsigned int hash = 2166136261u;
+
+  while (*str)
+  {
+    hash ^= (unsigned char) *str++;
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/******************************************************************
+ * @brief  Places an id in a name hash table.
+ *
+ *********************************************************************/
+static void _registry_slot_set(int *slots, const char *name, int id)
+{
+  unsigned int slot = _registry_hash(name) & (_REGISTRY_SLOTS - 1);
+
+  while (0 != slots[slot])
+  {
+    slot = (slot + 1) & (_REGISTRY_SLOTS - 1);
+  }
+  slots[slot] = id;
+}
+
+/******************************************************************
+ * @brief  Fills the name hash tables.
+ *
+ *********************************************************************/
+static void _registry_build(void)
+{
+  int id;
+
+  memset(bstRegistryRealmSlots, 0, sizeof (bstRegistryRealmSlots));
+  memset(bstRegistryCounterSlots, 0, sizeof (bstRegistryCounterSlots));
+
+  for (id = BVIEW_BST_REALM_ID_MIN; id < BVIEW_BST_REALM_ID_MAX; id++)
+  {
+    _registry_slot_set(bstRegistryRealmSlots, bstRegistryRealms[id].name, id);
+  }
+  for (id = BVIEW_BST_COUNTER_UNKNOWN + 1; id < BVIEW_BST_COUNTER_MAX; id++)
+  {
+    _registry_slot_set(bstRegistryCounterSlots, bstRegistryCounters[id], id);
+  }
+}
+
+/******************************************************************
+ * @brief  Builds the name hash tables.
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ *
+ *********************************************************************/
+BVIEW_STATUS bst_registry_init(void)
+{
+  pthread_once(&bstRegistryOnce, _registry_build);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Maps a realm name to its id.
+ *
+ * @param[in]   name      realm name
+ *
+ * @retval   the realm id, BVIEW_BST_REALM_UNKNOWN if there is none
+ *
+ *********************************************************************/
+BVIEW_BST_REALM_ID_t bst_registry_realm_id_get(const char *name)
+{
+  unsigned int slot;
+  int id;
+
+  if (NULL == name)
+  {
+    return BVIEW_BST_REALM_UNKNOWN;
+  }
+
+  pthread_once(&bstRegistryOnce, _registry_build);
+
+  slot = _registry_hash(name) & (_REGISTRY_SLOTS - 1);
+  while (0 != (id = bstRegistryRealmSlots[slot]))
+  {
+    if (0 == strcmp(name, bstRegistryRealms[id].name))
+    {
+      return (BVIEW_BST_REALM_ID_t) id;
+    }
+    slot = (slot + 1) & (_REGISTRY_SLOTS - 1);
+  }
+
+  return BVIEW_BST_REALM_UNKNOWN;
+}
+
+/******************************************************************
+ * @brief  Maps a counter name to its id.
+ *
+ * @param[in]   name      counter name
+ *
+ * @retval   the counter id, BVIEW_BST_COUNTER_UNKNOWN if there is none
+ *
+ *********************************************************************/
+BVIEW_BST_COUNTER_ID_t bst_registry_counter_id_get(const char *name)
+{
+  unsigned int slot;
+  int id;
+
+  if (NULL == name)
+  {
+    return BVIEW_BST_COUNTER_UNKNOWN;
+  }
+
+  pthread_once(&bstRegistryOnce, _registry_build);
+
+  slot = _registry_hash(name) & (_REGISTRY_SLOTS - 1);
+  while (0 != (id = bstRegistryCounterSlots[slot]))
+  {
+    if (0 == strcmp(name, bstRegistryCounters[id]))
+    {
+      return (BVIEW_BST_COUNTER_ID_t) id;
+    }
+    slot = (slot + 1) & (_REGISTRY_SLOTS - 1);
+  }
+
+  return BVIEW_BST_COUNTER_UNKNOWN;
+}
+
+/******************************************************************
+ * @brief  Returns a registered realm.
+ *
+ * @param[in]   realm     realm id
+ *
+ * @retval   the realm, NULL for an id out of the registry
+ *
+ *********************************************************************/
+const BVIEW_BST_REGISTRY_REALM_t *bst_registry_realm_get(int realm)
+{
+  if ((realm < BVIEW_BST_REALM_ID_MIN) || (realm >= BVIEW_BST_REALM_ID_MAX))
+  {
+    return NULL;
+  }
+  return &bstRegistryRealms[realm];
+}
+
+/******************************************************************
+ * @brief  Maps a realm id to its name.
+ *
+ * @param[in]   realm     realm id
+ *
+ * @retval   the realm name, "" for an id out of the registry
+ *
+ *********************************************************************/
+const char *bst_registry_realm_name_get(int realm)
+{
+  if ((realm < BVIEW_BST_REALM_ID_MIN) || (realm >= BVIEW_BST_REALM_ID_MAX))
+  {
+    return "";
+  }
+  return bstRegistryRealms[realm].name;
+}
+
+/******************************************************************
+ * @brief  Maps a counter id to its name.
+ *
+ * @param[in]   counter   counter id
+ *
+ * @retval   the counter name, "" for an id out of the registry
+ *
+ *********************************************************************/
+const char *bst_registry_counter_name_get(int counter)
+{
+  if ((counter <= BVIEW_BST_COUNTER_UNKNOWN) || (counter >= BVIEW_BST_COUNTER_MAX))
+  {
+    return "";
+  }
+  return bstRegistryCounters[counter];
+}
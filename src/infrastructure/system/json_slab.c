@@ -0,0 +1,532 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "broadview.h"
+#include "json_slab.h"
+
+#define _SLAB_DEBUG
+#define _SLAB_DEBUG_LEVEL           _SLAB_DEBUG_ERROR
+
+#define _SLAB_DEBUG_TRACE           (0x1)
+#define _SLAB_DEBUG_INFO            (0x01 << 1)
+#define _SLAB_DEBUG_ERROR           (0x01 << 2)
+#define _SLAB_DEBUG_ALL             (0xFF)
+
+#ifdef _SLAB_DEBUG
+#define _SLAB_LOG(level, format,args...)   do { \
+            if ((level) & _SLAB_DEBUG_LEVEL) { \
+                printf(format, ##args); \
+            } \
+        }while(0)
+#else
+#define _SLAB_LOG(level, format,args...)
+#endif
+
+/* Utility Macros for parameter validation */
+#define _SLAB_ASSERT_ERROR(condition, errcode) do { \
+    if (!(condition)) { \
+        _SLAB_LOG(_SLAB_DEBUG_ERROR, \
+                    "JSON Slab (%s:%d) Invalid Input Parameter  \n", \
+                    __func__, __LINE__); \
+        return (errcode); \
+    } \
+} while(0)
+
+#define _SLAB_ASSERT(condition) _SLAB_ASSERT_ERROR((condition), (BVIEW_STATUS_INVALID_PARAMETER))
+
+/* marks the header in front of every buffer */
+#define _SLAB_MAGIC                 0x4A534C42
+
+/* Free list head : a tag in the upper half, bumped on every change so that
+ * a stale head never compares equal (ABA), and 1 + index of the first free
+ * slice in the lower half, 0 when the list is empty */
+#define _SLAB_HEAD_INDEX(_h)        ((uint32_t) ((_h) & 0xFFFFFFFF))
+#define _SLAB_HEAD_MAKE(_h, _i)     (((((_h) >> 32) + 1) << 32) | (uint64_t) (uint32_t) (_i))
+
+/* placed in front of every buffer, keeps the buffer 16 byte aligned */
+typedef struct _slab_header_
+{
+    uint32_t magic;
+    uint32_t classId;
+    uint32_t index;
+    uint32_t reserved;
+} _SLAB_HEADER_t;
+
+typedef struct _slab_slice_
+{
+    uint8_t *buffer;
+    /* 1 + index of the next free slice, 0 at the end of the list */
+    uint32_t next;
+    bool inUse;
+    time_t timeTaken;
+} _SLAB_SLICE_t;
+
+typedef struct _slab_class_
+{
+    char name[JSON_SLAB_NAME_LENGTH];
+    int size;
+    int maxSlices;
+    int cacheDepth;
+
+    /* maxSlices descriptors, the first numSlices are in use */
+    _SLAB_SLICE_t *slices;
+    int numSlices;
+
+    uint64_t freeHead;
+
+    /* taken to add a slice */
+    pthread_mutex_t growLock;
+
+    /* telemetry */
+    int inUse;
+    int highWatermark;
+    uint64_t allocations;
+    uint64_t failures;
+    time_t maxHoldTime;
+    time_t totalHoldTime;
+} _SLAB_CLASS_t;
+
+static _SLAB_CLASS_t slabClasses[JSON_SLAB_MAX_CLASSES];
+static int slabNumClasses;
+
+/* serializes the creation of classes */
+static pthread_mutex_t slabLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* slices freed by this thread, per class */
+static __thread struct _slab_cache_
+{
+    int count;
+    uint32_t index[JSON_SLAB_MAX_CACHE_DEPTH];
+} slabCache[JSON_SLAB_MAX_CLASSES];
+
+/******************************************************************
+ * @brief  Raises '*max' to 'value' if it is lower.
+ *
+ *********************************************************************/
+static void _slab_int_max_update(int *max, int value)
+{
+    int old = __atomic_load_n(max, __ATOMIC_RELAXED);
+
+    while ((value > old) &&
+           (false == __atomic_compare_exchange_n(max, &old, value, true,
+                                                 __ATOMIC_RELAXED, __ATOMIC_RELAXED)))
+    {
+        ;
+    }
+}
+
+static void _slab_time_max_update(time_t *max, time_t value)
+{
+    time_t old = __atomic_load_n(max, __ATOMIC_RELAXED);
+
+    while ((value > old) &&
+           (false == __atomic_compare_exchange_n(max, &old, value, true,
+                                                 __ATOMIC_RELAXED, __ATOMIC_RELAXED)))
+    {
+        ;
+    }
+}
+
+/******************************************************************
+ * @brief  Puts a slice on the free list of its class.
+ *
+ *********************************************************************/
+static void _slab_push(_SLAB_CLASS_t *cls, uint32_t index)
+{
+    uint64_t head = __atomic_load_n(&cls->freeHead, __ATOMIC_ACQUIRE);
+
+    do
+    {
+        __atomic_store_n(&cls->slices[index].next, _SLAB_HEAD_INDEX(head), __ATOMIC_RELAXED);
+    } while (false == __atomic_compare_exchange_n(&cls->freeHead, &head,
+                                                  _SLAB_HEAD_MAKE(head, index + 1), true,
+                                                  __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+}
+
+/******************************************************************
+ * @brief  Takes a slice off the free list of a class.
+ *
+ * @retval   index of the slice, -1 if the list is empty
+ *
+ *********************************************************************/
+static int _slab_pop(_SLAB_CLASS_t *cls)
+{
+    uint64_t head = __atomic_load_n(&cls->freeHead, __ATOMIC_ACQUIRE);
+    uint32_t first, next;
+
+    do
+    {
+        first = _SLAB_HEAD_INDEX(head);
+        if (0 == first)
+        {
+            return -1;
+        }
+        /* the slice may be taken meanwhile, the tag then fails the exchange */
+        next = __atomic_load_n(&cls->slices[first - 1].next, __ATOMIC_RELAXED);
+    } while (false == __atomic_compare_exchange_n(&cls->freeHead, &head,
+                                                  _SLAB_HEAD_MAKE(head, next), true,
+                                                  __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+
+    return (int) (first - 1);
+}
+
+/******************************************************************
+ * @brief  Adds a slice to a class.
+ *
+ * @retval   index of the new slice, -1 if the class is full or there is
+ *           no memory
+ *
+ *********************************************************************/
+static int _slab_grow(_SLAB_CLASS_t *cls, int classId)
+{
+    _SLAB_HEADER_t *header;
+    int index = -1;
+
+    pthread_mutex_lock(&cls->growLock);
+
+    if (cls->numSlices < cls->maxSlices)
+    {
+        header = malloc(sizeof (_SLAB_HEADER_t) + (size_t) cls->size);
+        if (NULL != header)
+        {
+            index = cls->numSlices;
+            header->magic = _SLAB_MAGIC;
+            header->classId = (uint32_t) classId;
+            header->index = (uint32_t) index;
+            header->reserved = 0;
+
+            cls->slices[index].buffer = (uint8_t *) (header + 1);
+            cls->slices[index].next = 0;
+            cls->slices[index].inUse = false;
+            cls->slices[index].timeTaken = 0;
+
+            /* json_slab_free() checks the index against it */
+            __atomic_store_n(&cls->numSlices, index + 1, __ATOMIC_RELEASE);
+        }
+    }
+
+    pthread_mutex_unlock(&cls->growLock);
+
+    if (index >= 0)
+    {
+        _SLAB_LOG(_SLAB_DEBUG_INFO, "JSON Slab : class %s grew to %d slices \n", cls->name, index + 1);
+    }
+
+    return index;
+}
+
+/******************************************************************
+ * @brief  Creates a size class.
+ *
+ * @param[in]    name           Name of the class, for the telemetry
+ * @param[in]    size           Size of the buffers
+ * @param[in]    initialSlices  Slices created right away
+ * @param[in]    maxSlices      Most slices the class grows to
+ * @param[in]    cacheDepth     Slices kept by each thread freeing them
+ * @param[out]   classId        Class to allocate from
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  Class is created, or already was
+ * @retval   BVIEW_STATUS_TABLE_FULL  JSON_SLAB_MAX_CLASSES are created
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  The initial slices can't be had
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ *
+ * @note     A class that exists already is returned as is, so that a
+ *           module can be initialized more than once.
+ *********************************************************************/
+BVIEW_STATUS json_slab_class_create(const char *name, int size,
+                                    int initialSlices, int maxSlices,
+                                    int cacheDepth, int *classId)
+{
+    _SLAB_CLASS_t *cls;
+    int id, index, i;
+
+    _SLAB_ASSERT((name != NULL) && (classId != NULL));
+    _SLAB_ASSERT(strlen(name) < JSON_SLAB_NAME_LENGTH);
+    _SLAB_ASSERT((size > 0) && (maxSlices > 0));
+    _SLAB_ASSERT((initialSlices >= 0) && (initialSlices <= maxSlices));
+    _SLAB_ASSERT((cacheDepth >= 0) && (cacheDepth <= JSON_SLAB_MAX_CACHE_DEPTH));
+
+    pthread_mutex_lock(&slabLock);
+
+    for (id = 0; id < slabNumClasses; id++)
+    {
+        if (0 == strcmp(slabClasses[id].name, name))
+        {
+            pthread_mutex_unlock(&slabLock);
+            *classId = id;
+            return BVIEW_STATUS_SUCCESS;
+        }
+    }
+
+    if (slabNumClasses >= JSON_SLAB_MAX_CLASSES)
+    {
+        pthread_mutex_unlock(&slabLock);
+        _SLAB_LOG(_SLAB_DEBUG_ERROR, "JSON Slab : no room for class %s \n", name);
+        return BVIEW_STATUS_TABLE_FULL;
+    }
+
+    cls = &slabClasses[id];
+    memset(cls, 0, sizeof (_SLAB_CLASS_t));
+
+    cls->slices = calloc((size_t) maxSlices, sizeof (_SLAB_SLICE_t));
+    if (NULL == cls->slices)
+    {
+        pthread_mutex_unlock(&slabLock);
+        _SLAB_LOG(_SLAB_DEBUG_ERROR, "JSON Slab : no memory for class %s \n", name);
+        return BVIEW_STATUS_OUTOFMEMORY;
+    }
+
+    strcpy(cls->name, name);
+    cls->size = size;
+    cls->maxSlices = maxSlices;
+    cls->cacheDepth = cacheDepth;
+    pthread_mutex_init(&cls->growLock, NULL);
+
+    for (i = 0; i < initialSlices; i++)
+    {
+        index = _slab_grow(cls, id);
+        if (index < 0)
+        {
+            break;
+        }
+        _slab_push(cls, (uint32_t) index);
+    }
+
+    /* publish the class, the allocations check the id against it */
+    __atomic_store_n(&slabNumClasses, id + 1, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&slabLock);
+
+    *classId = id;
+
+    _SLAB_LOG(_SLAB_DEBUG_INFO, "JSON Slab : class %s [%d] of %d bytes, %d/%d slices \n",
+              name, id, size, i, maxSlices);
+
+    return (i == initialSlices) ? BVIEW_STATUS_SUCCESS : BVIEW_STATUS_OUTOFMEMORY;
+}
+
+/******************************************************************
+ * @brief  Allocates a buffer of a size class.
+ *
+ * @param[in]    classId     Class, see json_slab_class_create()
+ * @param[out]   buffer      Pointer to the allocated buffer.
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  Buffer is allocated successfully
+ * @retval   BVIEW_STATUS_OUTOFMEMORY  No free buffers are available
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ *
+ * @note     The allocated buffer must be freed with a call to
+ *           json_slab_free()
+ *********************************************************************/
+BVIEW_STATUS json_slab_allocate(int classId, uint8_t **buffer)
+{
+    _SLAB_CLASS_t *cls;
+    struct _slab_cache_ *cache;
+    _SLAB_SLICE_t *pSlice;
+    int index, inUse;
+
+    _SLAB_ASSERT(buffer != NULL);
+    _SLAB_ASSERT((classId >= 0) && (classId < __atomic_load_n(&slabNumClasses, __ATOMIC_ACQUIRE)));
+
+    cls = &slabClasses[classId];
+    cache = &slabCache[classId];
+
+    /* the slices this thread freed last, then the shared ones, then a new one */
+    if (cache->count > 0)
+    {
+        index = (int) cache->index[--cache->count];
+    }
+    else
+    {
+        index = _slab_pop(cls);
+        if (index < 0)
+        {
+            index = _slab_grow(cls, classId);
+        }
+    }
+
+    if (index < 0)
+    {
+        __atomic_fetch_add(&cls->failures, 1, __ATOMIC_RELAXED);
+        _SLAB_LOG(_SLAB_DEBUG_ERROR,
+                  "JSON Slab : Failed to allocate from class %s, %d slices in use \n",
+                  cls->name, __atomic_load_n(&cls->inUse, __ATOMIC_RELAXED));
+        return BVIEW_STATUS_OUTOFMEMORY;
+    }
+
+    pSlice = &cls->slices[index];
+    time(&pSlice->timeTaken);
+    __atomic_store_n(&pSlice->inUse, true, __ATOMIC_RELEASE);
+
+    __atomic_fetch_add(&cls->allocations, 1, __ATOMIC_RELAXED);
+    inUse = __atomic_add_fetch(&cls->inUse, 1, __ATOMIC_RELAXED);
+    _slab_int_max_update(&cls->highWatermark, inUse);
+
+    *buffer = pSlice->buffer;
+
+    _SLAB_LOG(_SLAB_DEBUG_TRACE,
+              "JSON Slab : Allocated memory[ %"PRI_PTR_TO_UINT_FMT" - index=%d] from %s at %d \n",
+              (ptr_to_uint_t)(*buffer), index, cls->name, (int) pSlice->timeTaken);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Returns the passed buffer to its size class
+ *
+ * @param[in]   buffer      Pointer to the buffer to be returned.
+ *
+ * @retval   BVIEW_STATUS_SUCCESS  Buffer is returned successfully
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ * @retval   BVIEW_STATUS_INVALID_MEMORY  The buffer was not allocated by
+ *           json_slab_allocate(), or is already free
+ *********************************************************************/
+BVIEW_STATUS json_slab_free(uint8_t *buffer)
+{
+    _SLAB_HEADER_t *header;
+    _SLAB_CLASS_t *cls;
+    struct _slab_cache_ *cache;
+    _SLAB_SLICE_t *pSlice;
+    time_t now, held;
+
+    _SLAB_ASSERT(buffer != NULL);
+
+    header = ((_SLAB_HEADER_t *) buffer) - 1;
+
+    _SLAB_ASSERT_ERROR((header->magic == _SLAB_MAGIC) &&
+                       (header->classId < (uint32_t) __atomic_load_n(&slabNumClasses, __ATOMIC_ACQUIRE)),
+                       BVIEW_STATUS_INVALID_MEMORY);
+
+    cls = &slabClasses[header->classId];
+
+    _SLAB_ASSERT_ERROR((header->index < (uint32_t) __atomic_load_n(&cls->numSlices, __ATOMIC_ACQUIRE)) &&
+                       (cls->slices[header->index].buffer == buffer),
+                       BVIEW_STATUS_INVALID_MEMORY);
+
+    pSlice = &cls->slices[header->index];
+
+    if (false == __atomic_exchange_n(&pSlice->inUse, false, __ATOMIC_ACQ_REL))
+    {
+        _SLAB_LOG(_SLAB_DEBUG_ERROR,
+                  "JSON Slab : %" PRI_PTR_TO_UINT_FMT " [index %d] of %s is already free \n",
+                  (ptr_to_uint_t) buffer, (int) header->index, cls->name);
+        return BVIEW_STATUS_INVALID_MEMORY;
+    }
+
+    time(&now);
+    held = (now > pSlice->timeTaken) ? (now - pSlice->timeTaken) : 0;
+    pSlice->timeTaken = 0;
+
+    __atomic_fetch_add(&cls->totalHoldTime, held, __ATOMIC_RELAXED);
+    _slab_time_max_update(&cls->maxHoldTime, held);
+    __atomic_fetch_sub(&cls->inUse, 1, __ATOMIC_RELAXED);
+
+    cache = &slabCache[header->classId];
+    if (cache->count < cls->cacheDepth)
+    {
+        cache->index[cache->count++] = header->index;
+    }
+    else
+    {
+        _slab_push(cls, header->index);
+    }
+
+    _SLAB_LOG(_SLAB_DEBUG_TRACE,
+              "JSON Slab : %" PRI_PTR_TO_UINT_FMT " [index %d] returned to %s \n",
+              (ptr_to_uint_t) buffer, (int) header->index, cls->name);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  Reads the telemetry of a size class.
+ *
+ * @param[in]    classId     Class, see json_slab_class_create()
+ * @param[out]   stats       Telemetry of the class
+ *
+ * @retval   BVIEW_STATUS_SUCCESS
+ * @retval   BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter
+ *********************************************************************/
+BVIEW_STATUS json_slab_stats_get(int classId, JSON_SLAB_STATS_t *stats)
+{
+    _SLAB_CLASS_t *cls;
+
+    _SLAB_ASSERT(stats != NULL);
+    _SLAB_ASSERT((classId >= 0) && (classId < __atomic_load_n(&slabNumClasses, __ATOMIC_ACQUIRE)));
+
+    cls = &slabClasses[classId];
+
+    memset(stats, 0, sizeof (JSON_SLAB_STATS_t));
+    strcpy(stats->name, cls->name);
+    stats->size = cls->size;
+    stats->slices = __atomic_load_n(&cls->numSlices, __ATOMIC_ACQUIRE);
+    stats->maxSlices = cls->maxSlices;
+    stats->inUse = __atomic_load_n(&cls->inUse, __ATOMIC_RELAXED);
+    stats->highWatermark = __atomic_load_n(&cls->highWatermark, __ATOMIC_RELAXED);
+    stats->allocations = __atomic_load_n(&cls->allocations, __ATOMIC_RELAXED);
+    stats->failures = __atomic_load_n(&cls->failures, __ATOMIC_RELAXED);
+    stats->maxHoldTime = __atomic_load_n(&cls->maxHoldTime, __ATOMIC_RELAXED);
+    stats->totalHoldTime = __atomic_load_n(&cls->totalHoldTime, __ATOMIC_RELAXED);
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/*****************************************************************//**
+* @brief  Dump a size class.
+*
+*
+* @retval   none
+*
+  *********************************************************************/
+void json_slab_dump(int classId)
+{
+    JSON_SLAB_STATS_t stats;
+    _SLAB_SLICE_t *pSlice;
+    time_t now;
+    int index;
+
+    if (BVIEW_STATUS_SUCCESS != json_slab_stats_get(classId, &stats))
+    {
+        return;
+    }
+
+    time(&now);
+
+    printf(" %s Slab : %d bytes -- Slices %3d of %3d -- In Use %3d -- High Watermark %3d \n",
+           stats.name, stats.size, stats.slices, stats.maxSlices, stats.inUse, stats.highWatermark);
+    printf(" Allocations %" PRIu64 " -- Failures %" PRIu64 " -- Longest Hold %d s -- Total Hold %d s \n\n",
+           stats.allocations, stats.failures, (int) stats.maxHoldTime, (int) stats.totalHoldTime);
+
+    for (index = 0; index < stats.slices; index++)
+    {
+        pSlice = &slabClasses[classId].slices[index];
+        printf (" [%2d] \t %"PRI_PTR_TO_UINT_FMT" \t %10s %10d\n",
+                index, (ptr_to_uint_t) (pSlice->buffer),
+                (pSlice->inUse == true) ? "In Use" : "Available",
+                (pSlice->inUse == true) ? (int) (now - pSlice->timeTaken) : 0);
+    }
+    printf("\n");
+}
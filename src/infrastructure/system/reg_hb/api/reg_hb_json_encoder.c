@@ -24,6 +24,7 @@
 #include <inttypes.h>
 #include "broadview.h"
 #include "cJSON.h"
+#include "json_writer.h"
 #include "configure_reg_hb_feature.h"
 #include "system.h"
 #include "system_utils.h"
@@ -143,11 +144,11 @@ BVIEW_STATUS reg_hb_json_encode_get_switch_properties (int method,
                                  \"agent-port\":\"%d\",\
                                  \"agent-sw-version\":\"%s\"}\
 }";
-  char *asicInfoTemplate = "[\"%s\", \"%s\", %d],";
   char *featureTemplate = "\"%s\"";
   char *jsonBuf;
   BVIEW_STATUS status;
   char asicInfoStr[JSON_MAX_NODE_LENGTH]={0};
+  JSON_WRITER_t writer;
   char featureStr[JSON_MAX_NODE_LENGTH]={0};
   int asic =0;
   int len = 0;
@@ -175,16 +176,30 @@ BVIEW_STATUS reg_hb_json_encode_get_switch_properties (int method,
     strftime(timeString, 64, "%Y-%m-%d - %H:%M:%S ", timeinfo);
 
 
+  json_writer_init(&writer, &asicInfoStr[0], sizeof(asicInfoStr));
   for (asic = 0; asic < pData->numAsics ; asic++)
   {
-    len  = snprintf (&asicInfoStr[totalLen],JSON_MAX_NODE_LENGTH,asicInfoTemplate,
-        pData->asicInfo[asic].asic_notation,
-        (pData->asicInfo[asic].asicType == BVIEW_ASIC_TYPE_TD2) ? "BCM56850" : "BCM56960",
-        pData->asicInfo[asic].numPorts);
-    totalLen += len;
+    /* ["asic-notation", "chip", num-ports], */
+    JSON_WRITER_APPEND_LITERAL(&writer, "[\"");
+    json_writer_append_str(&writer, pData->asicInfo[asic].asic_notation);
+    JSON_WRITER_APPEND_LITERAL(&writer, "\", \"");
+    json_writer_append_str(&writer,
+        (pData->asicInfo[asic].asicType == BVIEW_ASIC_TYPE_TD2) ? "BCM56850" : "BCM56960");
+    JSON_WRITER_APPEND_LITERAL(&writer, "\", ");
+    json_writer_append_int(&writer, pData->asicInfo[asic].numPorts);
+    JSON_WRITER_APPEND_LITERAL(&writer, "],");
   }
+
+  if (json_writer_overflow(&writer))
+  {
+    _SYSTEM_UTILS_JSONENCODE_LOG(_SYSTEM_UTILS_JSONENCODE_DEBUG_ERROR, "SYSTEM_UTILS-JSON-Encoder : asic info of %d asics does not fit \n", pData->numAsics);
+    system_utils_json_memory_free((uint8_t *) jsonBuf);
+    return BVIEW_STATUS_OUTOFMEMORY;
+  }
+
   /* Remove comma after last element */
-  asicInfoStr[totalLen-1] = '\0';
+  json_writer_backup(&writer, 1);
+  asicInfoStr[json_writer_length(&writer)] = '\0';
 
   len = 0;
   totalLen = 0;
@@ -71,7 +71,8 @@ extern "C"
 {
 #endif
 
-/* A small implementation of a memory pool, that offers buffers in two sizes */
+/* A memory pool on top of the JSON slab allocator (json_slab.h),
+   that offers buffers in predefined sizes */
 
 typedef enum _system_utils_json_memory_size_
 {
@@ -182,6 +182,18 @@ BVIEW_STATUS rest_send_500(int fd);
 /* sends asynchronous report to client */
 BVIEW_STATUS rest_send_async_report(REST_CONTEXT_t *rest, char *buffer, int length);
 
+/* sends the header of a HTTP 200 message, without a length */
+BVIEW_STATUS rest_send_200_header(int fd);
+
+/* sends a whole buffer */
+BVIEW_STATUS rest_send_all(int fd, const char *buffer, int length, int flags);
+
+/* starts an asynchronous report with chunked transfer encoding */
+BVIEW_STATUS rest_send_async_stream_open(REST_CONTEXT_t *rest, int *fd);
+
+/* sends a chunk of a chunked message, 0 bytes ends the message */
+BVIEW_STATUS rest_send_chunk(int fd, const char *buffer, int length);
+
 BVIEW_STATUS rest_http_server_run(REST_CONTEXT_t *rest);
 BVIEW_STATUS rest_session_validate(REST_CONTEXT_t *context, REST_SESSION_t *session);
 BVIEW_STATUS rest_send_200_with_data(int fd, char *buffer, int length);
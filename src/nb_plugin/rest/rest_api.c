@@ -147,6 +147,132 @@ BVIEW_STATUS rest_response_send(void *cookie, char *pBuf, int size)
     return status;
 }
 
+/******************************************************************
+ * @brief  Starts a response of unknown length to a client
+ * 
+ * @param[in]   cookie  session of the request, NULL for an
+ *                      asynchronous report
+ * @param[out]  stream  state of the response
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the header is sent
+ *
+ * @note   rest_response_stream_close() is to be called in all cases,
+ *         it releases the session. A session gets the usual 200
+ *         header, the body ends when the socket is closed. An
+ *         asynchronous report is a chunked POST.
+ *********************************************************************/
+BVIEW_STATUS rest_response_stream_open(void *cookie, REST_STREAM_t *stream)
+{
+    REST_SESSION_t *session = (REST_SESSION_t *) cookie;
+
+    if (NULL == stream)
+    {
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    stream->session = session;
+    stream->fd = -1;
+    stream->status = BVIEW_STATUS_SUCCESS;
+
+    if (session != NULL)
+    {
+        stream->status = rest_session_validate(&rest, session);
+        if (stream->status == BVIEW_STATUS_SUCCESS)
+        {
+            stream->fd = session->connectionFd;
+            stream->status = rest_send_200_header(stream->fd);
+        }
+        return stream->status;
+    }
+
+    /* asynchronous data sending */
+    stream->status = rest_send_async_stream_open(&rest, &stream->fd);
+    return stream->status;
+}
+
+/******************************************************************
+ * @brief  Sends a piece of a streamed response
+ * 
+ * @param[in]   stream  state of the response
+ * @param[in]   pBuf    data to be sent
+ * @param[in]   size    number of bytes to be sent
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the data is sent, or dropped
+ *           along with the response
+ *
+ * @note   once a piece fails, the rest of the response is dropped
+ *         and the failure is returned again.
+ *********************************************************************/
+BVIEW_STATUS rest_response_stream_write(void *stream, const char *pBuf, int size)
+{
+    REST_STREAM_t *pStream = (REST_STREAM_t *) stream;
+
+    if ((NULL == pStream) || (NULL == pBuf) || (0 > size))
+    {
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((pStream->status != BVIEW_STATUS_SUCCESS) || (-1 == pStream->fd) || (0 == size))
+    {
+        return pStream->status;
+    }
+
+    if (pStream->session != NULL)
+    {
+        pStream->status = rest_send_all(pStream->fd, pBuf, size, MSG_MORE);
+    }
+    else
+    {
+        pStream->status = rest_send_chunk(pStream->fd, pBuf, size);
+    }
+
+    return pStream->status;
+}
+
+/******************************************************************
+ * @brief  Ends a streamed response
+ * 
+ * @param[in]   stream  state of the response
+ *
+ * @retval   BVIEW_STATUS_SUCCESS if the whole response is sent
+ *
+ * @note   closes the socket and releases the session, whether the
+ *         response went out or not.
+ *********************************************************************/
+BVIEW_STATUS rest_response_stream_close(REST_STREAM_t *stream)
+{
+    REST_SESSION_t *session;
+
+    if (NULL == stream)
+    {
+        return BVIEW_STATUS_INVALID_PARAMETER;
+    }
+
+    session = (REST_SESSION_t *) stream->session;
+
+    if ((stream->status == BVIEW_STATUS_SUCCESS) && (-1 != stream->fd) && (NULL == session))
+    {
+        /* the last chunk */
+        stream->status = rest_send_chunk(stream->fd, NULL, 0);
+    }
+
+    if (session != NULL)
+    {
+        if (rest_session_validate(&rest, session) == BVIEW_STATUS_SUCCESS)
+        {
+            close(session->connectionFd);
+            session->inUse = false;
+        }
+    }
+    else if (-1 != stream->fd)
+    {
+        close(stream->fd);
+    }
+
+    stream->fd = -1;
+    return stream->status;
+}
+
 
 /******************************************************************
  * @brief  Sends successful response to a client 
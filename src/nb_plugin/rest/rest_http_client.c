@@ -20,6 +20,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <unistd.h>
+#include <errno.h>
 
 #include <sys/types.h>
 #include <sys/socket.h>
@@ -165,34 +166,81 @@ BVIEW_STATUS rest_send_500(int fd)
 }
 
 /******************************************************************
- * @brief  sends an asynchronous report to the client 
+ * @brief  sends the header of a HTTP 200 message, the body is
+ *         sent by the caller
  *
- * @param[in]   rest    context for reading configuration
+ * @param[in]   fd    socket for sending message
+ *
+ * @retval   BVIEW_STATUS_SUCCESS 
+ * 
+ * @note     the length of the body is not known, the client reads
+ *           it until the socket is closed.
+ *********************************************************************/
+BVIEW_STATUS rest_send_200_header(int fd)
+{
+    char *response = "HTTP/1.1 200 OK \r\n"
+            "Server: BroadViewAgent (Unix) (Linux) \r\n"
+            "Content-Type: text/json \r\n\r\n";
+
+    if (0 > send(fd, response, strlen(response), MSG_MORE))
+        return BVIEW_STATUS_FAILURE;
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  sends a whole buffer, however many calls it takes
+ *
+ * @param[in]   fd      socket for sending message
  * @param[in]   buffer  Buffer containing data to be sent
  * @param[in]   length  number of bytes to be sent 
- * 
+ * @param[in]   flags   flags of send()
+ *
  * @retval   BVIEW_STATUS_SUCCESS if send is successful
  * 
  * @note     
  *********************************************************************/
-BVIEW_STATUS rest_send_async_report(REST_CONTEXT_t *rest, char *buffer, int length)
+BVIEW_STATUS rest_send_all(int fd, const char *buffer, int length, int flags)
 {
-    char *header = "POST /agent_response HTTP/1.1\r\n"
-            "Host: BVIEW Client\r\n"
-            "User-Agent: BroadViewAgent\r\n"
-            "Accept: text/html,application/xhtml+xml,application/xml\r\n"
-            "Content-Length: %d\r\n"
-            "\r\n";
+    int bytes_sent;
 
-    char buf[REST_MAX_HTTP_BUFFER_LENGTH] = { 0 };
+    while (length > 0)
+    {
+        bytes_sent = send(fd, buffer, length, flags);
+        if (0 > bytes_sent)
+        {
+            if (EINTR == errno)
+                continue;
+            return BVIEW_STATUS_FAILURE;
+        }
+        buffer += bytes_sent;
+        length -= bytes_sent;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  connects to the client of the asynchronous reports
+ *
+ * @param[in]   rest    context for reading configuration
+ * @param[out]  fd      connected socket, -1 if the client is the
+ *                      default one and it is not reachable
+ * 
+ * @retval   BVIEW_STATUS_SUCCESS if the reports can be sent
+ * 
+ * @note     the default client need not be running, reports for
+ *           it are dropped without an error.
+ *********************************************************************/
+static BVIEW_STATUS rest_async_connect(REST_CONTEXT_t *rest, int *fd)
+{
     int clientFd;
     struct sockaddr_in clientAddr;
     int temp = 0;
-    BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
     char clientIp[BVIEW_MAX_IP_ADDR_LENGTH] = {0};
     int clientPort = 0;
 
-    snprintf(buf, REST_MAX_HTTP_BUFFER_LENGTH - 1, header, length);
+    *fd = -1;
 
     /* create socket to send data to */
     clientFd = socket(AF_INET, SOCK_STREAM, 0);
@@ -243,6 +291,42 @@ BVIEW_STATUS rest_send_async_report(REST_CONTEXT_t *rest, char *buffer, int leng
 
     _REST_ASSERT_NET_SOCKET_ERROR((temp != -1), "Error connecting to client for sending async reports",clientFd);
 
+    *fd = clientFd;
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  sends an asynchronous report to the client 
+ *
+ * @param[in]   rest    context for reading configuration
+ * @param[in]   buffer  Buffer containing data to be sent
+ * @param[in]   length  number of bytes to be sent 
+ * 
+ * @retval   BVIEW_STATUS_SUCCESS if send is successful
+ * 
+ * @note     
+ *********************************************************************/
+BVIEW_STATUS rest_send_async_report(REST_CONTEXT_t *rest, char *buffer, int length)
+{
+    char *header = "POST /agent_response HTTP/1.1\r\n"
+            "Host: BVIEW Client\r\n"
+            "User-Agent: BroadViewAgent\r\n"
+            "Accept: text/html,application/xhtml+xml,application/xml\r\n"
+            "Content-Length: %d\r\n"
+            "\r\n";
+
+    char buf[REST_MAX_HTTP_BUFFER_LENGTH] = { 0 };
+    int clientFd;
+    BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+
+    snprintf(buf, REST_MAX_HTTP_BUFFER_LENGTH - 1, header, length);
+
+    rv = rest_async_connect(rest, &clientFd);
+    if ((BVIEW_STATUS_SUCCESS != rv) || (-1 == clientFd))
+    {
+      return rv;
+    }
+
     /* send data */
     if (0 > send(clientFd, buf, strlen(buf),MSG_MORE))
       rv = BVIEW_STATUS_FAILURE;
@@ -257,6 +341,78 @@ BVIEW_STATUS rest_send_async_report(REST_CONTEXT_t *rest, char *buffer, int leng
 
 }
 
+/******************************************************************
+ * @brief  starts an asynchronous report of unknown length
+ *
+ * @param[in]   rest    context for reading configuration
+ * @param[out]  fd      socket the report goes on, -1 if it is to
+ *                      be dropped
+ * 
+ * @retval   BVIEW_STATUS_SUCCESS if the header is sent
+ * 
+ * @note     the report is sent with chunked transfer encoding,
+ *           see rest_send_chunk().
+ *********************************************************************/
+BVIEW_STATUS rest_send_async_stream_open(REST_CONTEXT_t *rest, int *fd)
+{
+    char *header = "POST /agent_response HTTP/1.1\r\n"
+            "Host: BVIEW Client\r\n"
+            "User-Agent: BroadViewAgent\r\n"
+            "Accept: text/html,application/xhtml+xml,application/xml\r\n"
+            "Transfer-Encoding: chunked\r\n"
+            "\r\n";
+    BVIEW_STATUS rv;
+
+    rv = rest_async_connect(rest, fd);
+    if ((BVIEW_STATUS_SUCCESS != rv) || (-1 == *fd))
+    {
+      return rv;
+    }
+
+    if (0 > send(*fd, header, strlen(header), MSG_MORE))
+    {
+      close(*fd);
+      *fd = -1;
+      return BVIEW_STATUS_FAILURE;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
+/******************************************************************
+ * @brief  sends one chunk of a chunked message
+ *
+ * @param[in]   fd      socket for sending message
+ * @param[in]   buffer  Buffer containing data to be sent
+ * @param[in]   length  number of bytes to be sent, 0 sends the
+ *                      last chunk, which ends the message
+ * 
+ * @retval   BVIEW_STATUS_SUCCESS if send is successful
+ * 
+ * @note     
+ *********************************************************************/
+BVIEW_STATUS rest_send_chunk(int fd, const char *buffer, int length)
+{
+    char size[REST_MAX_STRING_LENGTH] = { 0 };
+    int sizeLength;
+
+    if (0 == length)
+    {
+      return rest_send_all(fd, "0" REST_HTTP_TWIN_CRLF, 5, 0);
+    }
+
+    sizeLength = snprintf(size, sizeof(size), "%x" REST_HTTP_CRLF, length);
+
+    if ((BVIEW_STATUS_SUCCESS != rest_send_all(fd, size, sizeLength, MSG_MORE)) ||
+        (BVIEW_STATUS_SUCCESS != rest_send_all(fd, buffer, length, MSG_MORE)) ||
+        (BVIEW_STATUS_SUCCESS != rest_send_all(fd, REST_HTTP_CRLF, 2, MSG_MORE)))
+    {
+      return BVIEW_STATUS_FAILURE;
+    }
+
+    return BVIEW_STATUS_SUCCESS;
+}
+
 /******************************************************************
  * @brief  sends a HTTP 404 message to the client 
  *
@@ -35,6 +35,7 @@ extern "C"
 #include "broadview.h"
 #include "asic.h"
 #include "sbplugin.h"
+#include "bst_registry.h"
 
 /* Buffer Count for the device */
 typedef struct _bst_device_
@@ -231,12 +232,11 @@ typedef enum _bst_trigger_type_
 
 } BVIEW_BST_TRIGGER_TYPE;
 
-#define BVIEW_MAX_STRING_NAME_LEN 256
-/* Trigger info */
+/* Trigger info, the realm and the counter are registry ids */
 typedef struct  _bst_trigger_info_
 {
-  char realm[BVIEW_MAX_STRING_NAME_LEN];
-  char counter[BVIEW_MAX_STRING_NAME_LEN];
+  BVIEW_BST_REALM_ID_t realm;
+  BVIEW_BST_COUNTER_ID_t counter;
   int port;
   int queue;
 } BVIEW_BST_TRIGGER_INFO_t;
@@ -437,24 +437,8 @@ typedef BVIEW_STATUS(*BVIEW_BST_TRIGGER_CALLBACK_t) (int asic,
 
 
 
-/* threshold types */
-typedef enum _bst_realm_ {
-  BVIEW_BST_DEVICE = 1,
-  BVIEW_BST_EGRESS_PORT_SP,
-  BVIEW_BST_EGRESS_SP,
-  BVIEW_BST_EGRESS_UC_QUEUE,
-  BVIEW_BST_EGRESS_UC_QUEUEGROUPS,
-  BVIEW_BST_EGRESS_MC_QUEUE,
-  BVIEW_BST_EGRESS_CPU_QUEUE,
-  BVIEW_BST_EGRESS_RQE_QUEUE,
-  BVIEW_BST_INGRESS_PORT_PG,
-  BVIEW_BST_INGRESS_PORT_SP,
-  BVIEW_BST_INGRESS_SP,
-  BVIEW_BST_COUNT
-}BVIEW_BST_REALM_ID_t;
-
-#define BVIEW_BST_REALM_ID_MIN BVIEW_BST_DEVICE
-#define BVIEW_BST_REALM_ID_MAX BVIEW_BST_COUNT
+/* the realm and counter ids, BVIEW_BST_REALM_ID_t and
+   BVIEW_BST_COUNTER_ID_t, are generated in bst_registry.h */
 
 #define BVIEW_BST_CONFIG_FEATURE_UPDATE 1
 #define BVIEW_BST_CONFIG_TRACK_UPDATE 1
@@ -535,6 +519,18 @@ BVIEW_STATUS bst_plugin_cb(void *request);
 *
 *********************************************************************/
 BVIEW_STATUS bst_notify_config_change (int asicId, int id);
+
+/*********************************************************************
+* @brief : dumps the internal statistics of the bst application
+*
+* @param[in] : none
+*
+* @retval  : none
+*
+* @note    : the statistics are printed on the console.
+*
+*********************************************************************/
+void bst_debug_dump (void);
       
 #ifdef __cplusplus
 }
@@ -0,0 +1,120 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_BST_REGISTRY_H
+#define INCLUDE_BST_REGISTRY_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "broadview.h"
+
+/* Registry of the BST realms and counters.
+ *
+ * The realms and the counters are listed once, below, and everything else
+ * is generated from the lists : the ids, the names the encoders write, and
+ * the hash tables that map a name to its id where a name comes in (REST
+ * requests, OVSDB rows). Inside the agent the realms and the counters only
+ * travel as ids.
+ *
+ * A realm row is (id, name, first index, second index), the indices being
+ * the keys a trigger report carries for the realm, NULL if none.
+ * A counter row is (id, name).
+ *
+ * New rows go at the end, the ids are part of the binary reports and of
+ * the tracking masks.
+ */
+#define BVIEW_BST_REALM_REGISTRY(_X) \
+  _X(BVIEW_BST_DEVICE,                "device",                      NULL,   NULL)             \
+  _X(BVIEW_BST_EGRESS_PORT_SP,        "egress-port-service-pool",    "port", "service-pool")   \
+  _X(BVIEW_BST_EGRESS_SP,             "egress-service-pool",         "service-pool", NULL)     \
+  _X(BVIEW_BST_EGRESS_UC_QUEUE,       "egress-uc-queue",             "queue", NULL)            \
+  _X(BVIEW_BST_EGRESS_UC_QUEUEGROUPS, "egress-uc-queue-group",       "queue-group", NULL)      \
+  _X(BVIEW_BST_EGRESS_MC_QUEUE,       "egress-mc-queue",             "queue", NULL)            \
+  _X(BVIEW_BST_EGRESS_CPU_QUEUE,      "egress-cpu-queue",            "queue", NULL)            \
+  _X(BVIEW_BST_EGRESS_RQE_QUEUE,      "egress-rqe-queue",            "queue", NULL)            \
+  _X(BVIEW_BST_INGRESS_PORT_PG,       "ingress-port-priority-group", "port", "priority-group") \
+  _X(BVIEW_BST_INGRESS_PORT_SP,       "ingress-port-service-pool",   "port", "service-pool")   \
+  _X(BVIEW_BST_INGRESS_SP,            "ingress-service-pool",        "service-pool", NULL)
+
+#define BVIEW_BST_COUNTER_REGISTRY(_X) \
+  _X(BVIEW_BST_COUNTER_DATA,        "data")                     \
+  _X(BVIEW_BST_COUNTER_UM_SHARE,    "um-share-buffer-count")    \
+  _X(BVIEW_BST_COUNTER_UM_HEADROOM, "um-headroom-buffer-count") \
+  _X(BVIEW_BST_COUNTER_UC_SHARE,    "uc-share-buffer-count")    \
+  _X(BVIEW_BST_COUNTER_MC_SHARE,    "mc-share-buffer-count")    \
+  _X(BVIEW_BST_COUNTER_UC_BUFFER,   "uc-buffer-count")          \
+  _X(BVIEW_BST_COUNTER_MC_BUFFER,   "mc-buffer-count")          \
+  _X(BVIEW_BST_COUNTER_CPU_BUFFER,  "cpu-buffer-count")         \
+  _X(BVIEW_BST_COUNTER_RQE_BUFFER,  "rqe-buffer-count")         \
+  _X(BVIEW_BST_COUNTER_RQE_QUEUE,   "rqe-queue-count")
+
+#define BVIEW_BST_REGISTRY_REALM_ENUM(_id, _name, _index1, _index2)   _id,
+#define BVIEW_BST_REGISTRY_COUNTER_ENUM(_id, _name)                   _id,
+
+/* realms, 0 is no realm */
+typedef enum _bst_realm_ {
+  BVIEW_BST_REALM_UNKNOWN = 0,
+  BVIEW_BST_REALM_REGISTRY(BVIEW_BST_REGISTRY_REALM_ENUM)
+  BVIEW_BST_COUNT
+}BVIEW_BST_REALM_ID_t;
+
+#define BVIEW_BST_REALM_ID_MIN BVIEW_BST_DEVICE
+#define BVIEW_BST_REALM_ID_MAX BVIEW_BST_COUNT
+
+/* counters of the realms, 0 is no counter */
+typedef enum _bst_counter_ {
+  BVIEW_BST_COUNTER_UNKNOWN = 0,
+  BVIEW_BST_COUNTER_REGISTRY(BVIEW_BST_REGISTRY_COUNTER_ENUM)
+  BVIEW_BST_COUNTER_MAX
+}BVIEW_BST_COUNTER_ID_t;
+
+/* a realm as registered */
+typedef struct _bst_registry_realm_
+{
+  const char *name;
+  const char *index1;
+  const char *index2;
+} BVIEW_BST_REGISTRY_REALM_t;
+
+/* Builds the name hash tables. Safe to call more than once, the lookups
+ * call it themselves */
+BVIEW_STATUS bst_registry_init(void);
+
+/* Returns the id of a realm name, BVIEW_BST_REALM_UNKNOWN if there is none */
+BVIEW_BST_REALM_ID_t bst_registry_realm_id_get(const char *name);
+
+/* Returns the id of a counter name, BVIEW_BST_COUNTER_UNKNOWN if there is none */
+BVIEW_BST_COUNTER_ID_t bst_registry_counter_id_get(const char *name);
+
+/* Returns a registered realm, NULL for an id out of the registry */
+const BVIEW_BST_REGISTRY_REALM_t *bst_registry_realm_get(int realm);
+
+/* Returns the name of a realm, "" for an id out of the registry */
+const char *bst_registry_realm_name_get(int realm);
+
+/* Returns the name of a counter, "" for an id out of the registry */
+const char *bst_registry_counter_name_get(int counter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_BST_REGISTRY_H */
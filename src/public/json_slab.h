@@ -0,0 +1,98 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_JSON_SLAB_H
+#define INCLUDE_JSON_SLAB_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <time.h>
+
+#include "broadview.h"
+
+/* Slab allocator for the buffers of the JSON (and binary) encoders.
+ *
+ * Every module creates the size classes it needs : a class hands out
+ * buffers of one size, starts with 'initialSlices' of them and grows on
+ * demand, one slice at a time, up to 'maxSlices'. Free slices sit on a
+ * lock-free list per class. A thread also keeps up to 'cacheDepth' of the
+ * slices it freed, and takes them back first, so that a module encoding
+ * and freeing on the same thread does not touch the shared list at all.
+ *
+ * A slice in a thread's cache is only seen by that thread, so 'maxSlices'
+ * leaves room for the caches of the threads using the class.
+ *
+ * Buffers are freed with json_slab_free() whatever their class.
+ */
+
+/* Most size classes, all modules together */
+#define JSON_SLAB_MAX_CLASSES           16
+
+/* Deepest per-thread cache of a class */
+#define JSON_SLAB_MAX_CACHE_DEPTH       4
+
+/* Longest name of a class, including the '\0' */
+#define JSON_SLAB_NAME_LENGTH           32
+
+/* Telemetry of a class */
+typedef struct _json_slab_stats_
+{
+    char name[JSON_SLAB_NAME_LENGTH];
+    int size;
+    /* slices created so far, and the most there may be */
+    int slices;
+    int maxSlices;
+    /* slices handed out and not yet freed, and the most there ever were */
+    int inUse;
+    int highWatermark;
+    uint64_t allocations;
+    /* allocations that found no slice */
+    uint64_t failures;
+    /* longest and total time a slice was held, in seconds */
+    time_t maxHoldTime;
+    time_t totalHoldTime;
+} JSON_SLAB_STATS_t;
+
+/* Creates a size class, or returns the one already created with that name.
+ * 'maxSlices' equal to 'initialSlices' disables the growth. */
+BVIEW_STATUS json_slab_class_create(const char *name, int size,
+                                    int initialSlices, int maxSlices,
+                                    int cacheDepth, int *classId);
+
+/* Takes a buffer of the class. BVIEW_STATUS_OUTOFMEMORY once the class
+ * has 'maxSlices' slices in use */
+BVIEW_STATUS json_slab_allocate(int classId, uint8_t **buffer);
+
+/* Returns a buffer taken with json_slab_allocate() */
+BVIEW_STATUS json_slab_free(uint8_t *buffer);
+
+/* Reads the telemetry of a class */
+BVIEW_STATUS json_slab_stats_get(int classId, JSON_SLAB_STATS_t *stats);
+
+/* Prints the telemetry and the slices of a class */
+void json_slab_dump(int classId);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JSON_SLAB_H */
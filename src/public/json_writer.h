@@ -0,0 +1,281 @@
+/*****************************************************************************
+  *
+  * (C) Copyright Broadcom Corporation 2015
+  *
+  * Licensed under the Apache License, Version 2.0 (the "License");
+  * you may not use this file except in compliance with the License.
+  *
+  * You may obtain a copy of the License at
+  * http://www.apache.org/licenses/LICENSE-2.0
+  *
+  * Unless required by applicable law or agreed to in writing, software
+  * distributed under the License is distributed on an "AS IS" BASIS,
+  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  * See the License for the specific language governing permissions and
+  * limitations under the License.
+  *
+  ***************************************************************************/
+
+#ifndef INCLUDE_JSON_WRITER_H
+#define INCLUDE_JSON_WRITER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <string.h>
+
+#include "broadview.h"
+
+/* Appends text to a fixed JSON buffer without going through printf.
+ *
+ * The writer keeps the same buffer contents snprintf would : every append
+ * is followed by a '\0', and the last byte of the buffer is reserved for it.
+ * An append that does not fit writes nothing and marks the writer as
+ * overflowed; every later append is then ignored. The caller checks
+ * json_writer_overflow() once per entry rather than after each piece.
+ *
+ * A writer set up with json_writer_stream_init() works on a small chunk
+ * instead : when the chunk is full, its contents are handed to the sink and
+ * the chunk is reused. The last JSON_WRITER_HOLD_BYTES bytes are held back,
+ * so that json_writer_backup() can still step over a trailing ','.
+ */
+
+/* Longest decimal representation of a uint64_t */
+#define JSON_WRITER_U64_DIGITS      20
+
+/* Bytes kept in the chunk when it is handed to the sink */
+#define JSON_WRITER_HOLD_BYTES      4
+
+/* Receives the text of a streamed message, one chunk at a time */
+typedef BVIEW_STATUS (*JSON_WRITER_SINK_t) (void *sinkCtx, const char *data, int length);
+
+typedef struct _json_writer_
+{
+    char *start;
+    char *cursor;
+    /* last byte of the buffer, kept for the terminating '\0' */
+    char *limit;
+    bool overflow;
+    /* streaming only */
+    JSON_WRITER_SINK_t sink;
+    void *sinkCtx;
+    /* bytes already handed to the sink */
+    int emitted;
+    /* first failure reported by the sink */
+    BVIEW_STATUS sinkStatus;
+} JSON_WRITER_t;
+
+/* "00" "01" ... "99", two digits are emitted per division */
+static const char json_writer_digit_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static inline void json_writer_init(JSON_WRITER_t *w, char *buffer, int bufLen)
+{
+    w->start = buffer;
+    w->cursor = buffer;
+    w->limit = buffer + ((bufLen > 0) ? (bufLen - 1) : 0);
+    w->overflow = (bufLen <= 0);
+    w->sink = NULL;
+    w->sinkCtx = NULL;
+    w->emitted = 0;
+    w->sinkStatus = BVIEW_STATUS_SUCCESS;
+}
+
+static inline void json_writer_stream_init(JSON_WRITER_t *w, char *chunk, int chunkLen,
+                                           JSON_WRITER_SINK_t sink, void *sinkCtx)
+{
+    json_writer_init(w, chunk, chunkLen);
+    w->overflow = (chunkLen <= (2 * JSON_WRITER_HOLD_BYTES)) || (NULL == sink);
+    w->sink = sink;
+    w->sinkCtx = sinkCtx;
+}
+
+/* Hands all but the held back bytes to the sink. Returns false if
+ * nothing could be made room for */
+static inline bool _json_writer_drain(JSON_WRITER_t *w)
+{
+    int out = (int) (w->cursor - w->start) - JSON_WRITER_HOLD_BYTES;
+
+    if ((NULL == w->sink) || (out <= 0))
+    {
+        return false;
+    }
+
+    w->sinkStatus = w->sink(w->sinkCtx, w->start, out);
+    if (BVIEW_STATUS_SUCCESS != w->sinkStatus)
+    {
+        return false;
+    }
+
+    memmove(w->start, w->start + out, JSON_WRITER_HOLD_BYTES);
+    w->cursor -= out;
+    w->emitted += out;
+    *w->cursor = '\0';
+    return true;
+}
+
+static inline void json_writer_append(JSON_WRITER_t *w, const char *str, int len)
+{
+    if (w->overflow)
+    {
+        return;
+    }
+
+    if ((len > (w->limit - w->cursor)) &&
+        ((false == _json_writer_drain(w)) || (len > (w->limit - w->cursor))))
+    {
+        w->overflow = true;
+        return;
+    }
+
+    memcpy(w->cursor, str, len);
+    w->cursor += len;
+    *w->cursor = '\0';
+}
+
+/* Appends a string literal, its length is known at compile time */
+#define JSON_WRITER_APPEND_LITERAL(_w, _lit)  json_writer_append((_w), (_lit), (int) (sizeof(_lit) - 1))
+
+static inline void json_writer_append_str(JSON_WRITER_t *w, const char *str)
+{
+    json_writer_append(w, str, (int) strlen(str));
+}
+
+/* Same output as "%" PRIu64 */
+static inline void json_writer_append_u64(JSON_WRITER_t *w, uint64_t value)
+{
+    char digits[JSON_WRITER_U64_DIGITS];
+    char *p = &digits[JSON_WRITER_U64_DIGITS];
+    unsigned int pair;
+
+    while (value >= 100)
+    {
+        pair = (unsigned int) (value % 100) * 2;
+        value /= 100;
+        p -= 2;
+        p[0] = json_writer_digit_pairs[pair];
+        p[1] = json_writer_digit_pairs[pair + 1];
+    }
+
+    if (value >= 10)
+    {
+        pair = (unsigned int) value * 2;
+        p -= 2;
+        p[0] = json_writer_digit_pairs[pair];
+        p[1] = json_writer_digit_pairs[pair + 1];
+    }
+    else
+    {
+        *--p = (char) ('0' + value);
+    }
+
+    json_writer_append(w, p, (int) (&digits[JSON_WRITER_U64_DIGITS] - p));
+}
+
+/* Same output as "%d" */
+static inline void json_writer_append_int(JSON_WRITER_t *w, int value)
+{
+    if (value < 0)
+    {
+        JSON_WRITER_APPEND_LITERAL(w, "-");
+        json_writer_append_u64(w, (uint64_t) (-(int64_t) value));
+        return;
+    }
+
+    json_writer_append_u64(w, (uint64_t) value);
+}
+
+/* Same output as snprintf(format, ...), for the odd header */
+static inline void json_writer_append_formatted(JSON_WRITER_t *w, const char *format, ...)
+{
+    va_list args;
+    int room, len, attempt;
+
+    for (attempt = 0; (attempt < 2) && (false == w->overflow); attempt++)
+    {
+        room = (int) (w->limit - w->cursor) + 1;
+
+        va_start(args, format);
+        len = vsnprintf(w->cursor, room, format, args);
+        va_end(args);
+
+        if ((len >= 0) && (len < room))
+        {
+            w->cursor += len;
+            return;
+        }
+
+        /* restore the terminator the failed attempt overwrote */
+        *w->cursor = '\0';
+        if ((len < 0) || (false == _json_writer_drain(w)))
+        {
+            break;
+        }
+    }
+
+    w->overflow = true;
+}
+
+/* Steps back over the last 'count' bytes, e.g. a trailing ',' */
+static inline void json_writer_backup(JSON_WRITER_t *w, int count)
+{
+    w->cursor = ((w->cursor - w->start) > count) ? (w->cursor - count) : w->start;
+}
+
+/* Byte at the cursor, i.e. the one a backup stepped over ('\0' if none) */
+static inline char json_writer_peek(const JSON_WRITER_t *w)
+{
+    return *w->cursor;
+}
+
+/* Total bytes written, including the ones already handed to the sink */
+static inline int json_writer_length(const JSON_WRITER_t *w)
+{
+    return w->emitted + (int) (w->cursor - w->start);
+}
+
+/* Hands whatever is left in the chunk to the sink, at the end of a message */
+static inline BVIEW_STATUS json_writer_flush(JSON_WRITER_t *w)
+{
+    int out = (int) (w->cursor - w->start);
+
+    if ((NULL == w->sink) || (out <= 0))
+    {
+        return w->sinkStatus;
+    }
+
+    w->sinkStatus = w->sink(w->sinkCtx, w->start, out);
+    if (BVIEW_STATUS_SUCCESS == w->sinkStatus)
+    {
+        w->cursor = w->start;
+        w->emitted += out;
+    }
+
+    return w->sinkStatus;
+}
+
+static inline bool json_writer_overflow(const JSON_WRITER_t *w)
+{
+    return w->overflow;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_JSON_WRITER_H */
@@ -49,6 +49,31 @@ BVIEW_STATUS rest_response_send_error(void *cookie, BVIEW_STATUS rv, int id);
 
 BVIEW_STATUS rest_response_send_ok (void *cookie);
 
+/* A response streamed to the client, see rest_response_stream_open() */
+typedef struct _rest_stream_
+{
+    /* session of the request, NULL for an asynchronous report */
+    void *session;
+    /* socket, -1 if the response is dropped */
+    int fd;
+    /* first failure, the rest of the response is dropped */
+    BVIEW_STATUS status;
+} REST_STREAM_t;
+
+/* APIs to send a response whose length is not known up front, piece
+ * by piece. rest_response_stream_open() sends the HTTP header, each
+ * rest_response_stream_write() a piece of the body, and
+ * rest_response_stream_close() ends the response and releases the
+ * session. Asynchronous reports (NULL cookie) are sent with chunked
+ * transfer encoding. rest_response_stream_write() has the prototype of
+ * a JSON_WRITER_SINK_t.
+ */
+BVIEW_STATUS rest_response_stream_open(void *cookie, REST_STREAM_t *stream);
+
+BVIEW_STATUS rest_response_stream_write(void *stream, const char *pBuf, int size);
+
+BVIEW_STATUS rest_response_stream_close(REST_STREAM_t *stream);
+
 #ifdef	__cplusplus
 }
 #endif
@@ -24,12 +24,6 @@ extern "C"
 {
 #endif
 
-#define BST_OVSDB_REALM_SIZE          128
-typedef struct _realm_map_
-{
-  char realmName[BST_OVSDB_REALM_SIZE];
-  int realmId;
-} BVIEW_BST_REALM_MAP_t;
 
 /*********************************************************************
 * @brief           Set default connection parameters                                 
@@ -36,31 +36,94 @@ typedef struct _bst_ovsdb_bid_info_
   uint64_t  stat;      /* buffer usage of a particular BID */
   uint64_t  threshold; /* Threshold configured */
   bool      enabled;   /* Row is enabled  */
+  bool      triggered; /* Row status is "triggered" */
 } BVIEW_OVSDB_BID_INFO_t;
 
-typedef struct _bst_ovsdb_stat_db_
+/* Counters of an ASIC, an array per BID. The arrays follow the order of
+ * the realms of BVIEW_BST_ASIC_SNAPSHOT_DATA_t, the stats and the
+ * thresholds are each laid out this way */
+typedef struct _bst_ovsdb_counter_db_
 {
   /*Device Data*/
-  BVIEW_OVSDB_BID_INFO_t         device;
+  uint64_t                       device;
   /* Ingress Data*/
-  BVIEW_OVSDB_BID_INFO_t         iPGShared[SB_OVSDB_PG_SHARED_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         iPGHeadroom[SB_OVSDB_PG_HEADROOM_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         iPortSP[SB_OVSDB_I_P_SP_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         iSP[SB_OVSDB_I_SP_STAT_SIZE];
+  uint64_t                       iPGShared[SB_OVSDB_PG_SHARED_SIZE];
+  uint64_t                       iPGHeadroom[SB_OVSDB_PG_HEADROOM_SIZE];
+  uint64_t                       iPortSP[SB_OVSDB_I_P_SP_STAT_SIZE];
+  uint64_t                       iSP[SB_OVSDB_I_SP_STAT_SIZE];
   /* Egress Data*/
-  BVIEW_OVSDB_BID_INFO_t         ePortSPucShare[SB_OVSDB_E_P_SP_UC_SHARE_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         ePortSPumShare[SB_OVSDB_E_P_SP_UM_SHARE_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         ePortSPmcShare[SB_OVSDB_E_P_SP_UM_SHARE_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         eSPumShare[SB_OVSDB_E_SP_UM_SHARE_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         eSPmcShare[SB_OVSDB_E_SP_MC_SHARE_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         ucQ[SB_OVSDB_E_UC_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         eUCqGroup[SB_OVSBD_E_UC_Q_GROUP_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         mcQ[SB_OVSDB_E_MC_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         eCPU[SB_OVSDB_E_CPU_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         rqe[SB_OVSDB_E_RQE_STAT_SIZE];
-  BVIEW_OVSDB_BID_INFO_t         rqeQueueEntries[SB_OVSDB_E_RQE_QUEUE_STAT_SIZE];
+  uint64_t                       ePortSPucShare[SB_OVSDB_E_P_SP_UC_SHARE_STAT_SIZE];
+  uint64_t                       ePortSPumShare[SB_OVSDB_E_P_SP_UM_SHARE_STAT_SIZE];
+  uint64_t                       ePortSPmcShare[SB_OVSDB_E_P_SP_UM_SHARE_STAT_SIZE];
+  uint64_t                       eSPumShare[SB_OVSDB_E_SP_UM_SHARE_STAT_SIZE];
+  uint64_t                       eSPmcShare[SB_OVSDB_E_SP_MC_SHARE_STAT_SIZE];
+  uint64_t                       ucQ[SB_OVSDB_E_UC_STAT_SIZE];
+  uint64_t                       eUCqGroup[SB_OVSBD_E_UC_Q_GROUP_STAT_SIZE];
+  uint64_t                       mcQ[SB_OVSDB_E_MC_STAT_SIZE];
+  uint64_t                       eCPU[SB_OVSDB_E_CPU_STAT_SIZE];
+  uint64_t                       rqe[SB_OVSDB_E_RQE_STAT_SIZE];
+  uint64_t                       rqeQueueEntries[SB_OVSDB_E_RQE_QUEUE_STAT_SIZE];
+} BVIEW_OVSDB_BST_COUNTER_DB_t;
+
+/* Number of counters of an ASIC */
+#define BVIEW_OVSDB_BST_COUNTERS \
+              (sizeof (BVIEW_OVSDB_BST_COUNTER_DB_t) / sizeof (uint64_t))
+
+/* OVSDB BST stats, thresholds and enabled rows of an ASIC, stored apart so
+ * that reading one of them reads nothing else */
+typedef struct _bst_ovsdb_stat_db_
+{
+  /* buffer usage of the counters */
+  BVIEW_OVSDB_BST_COUNTER_DB_t  stat;
+  /* thresholds configured */
+  BVIEW_OVSDB_BST_COUNTER_DB_t  threshold;
+  /* rows enabled, a bit per counter */
+  uint64_t                      enabled[(BVIEW_OVSDB_BST_COUNTERS + 63) / 64];
+  /* rows in "triggered" status, a bit per counter */
+  uint64_t                      triggered[(BVIEW_OVSDB_BST_COUNTERS + 63) / 64];
 } BVIEW_OVSDB_BST_STAT_DB_t;
 
+/* Length of a row UUID, RFC 7047 */
+#define BVIEW_OVSDB_ROW_UUID_SIZE       36
+
+/* A bufmon row resolved to its cache entry */
+typedef struct _bst_ovsdb_row_ref_
+{
+  int  asic;
+  int  bid;
+  int  port;
+  int  queue;
+  /* counter of the row in the cache arrays of the asic */
+  unsigned int index;
+} BVIEW_OVSDB_ROW_REF_t;
+
+/* A bufmon row update, staged until its table update is applied */
+typedef struct _bst_ovsdb_row_update_
+{
+  BVIEW_OVSDB_ROW_REF_t   ref;
+  /* new columns of the row */
+  BVIEW_OVSDB_BID_INFO_t  row;
+  /* the row went into "triggered" status, to be reported */
+  bool                    triggered;
+  /* the row left the database */
+  bool                    deleted;
+  /* UUID of a deleted row */
+  char                    uuid[BVIEW_OVSDB_ROW_UUID_SIZE + 1];
+} BVIEW_OVSDB_ROW_UPDATE_t;
+
+/* A run of snapshot fields, read from consecutive stats */
+typedef struct _bst_ovsdb_snapshot_map_
+{
+  /* offset of the first field in the snapshot, in 64 bit words */
+  unsigned int  dst;
+  /* distance between the fields, in 64 bit words */
+  unsigned int  stride;
+  /* first stat, a counter of the cache arrays */
+  unsigned int  src;
+  /* number of fields */
+  unsigned int  count;
+} BVIEW_OVSDB_SNAPSHOT_MAP_t;
+
 /* BST Config cache of OVSDB */
 typedef struct _bst_ovsdb_config_data_
 {
@@ -84,6 +147,13 @@ typedef struct _bst_ovsdb_data_
   BVIEW_OVSDB_CONFIG_DATA_t     config_data;  
   /* OVSDB plugin Cache */
   BVIEW_OVSDB_BST_STAT_DB_t     cache[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+  /* Per ASIC sequence of the stats and thresholds, odd while the
+     monitor writes them. Snapshot reads retry on a change instead
+     of taking the lock */
+  unsigned int                  seq[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+  /* The monitor is not in sync with the database, the cache holds
+     the last values it read */
+  bool                          stale;
 
 } BVIEW_OVSDB_BST_DATA_t;
 
@@ -154,7 +224,7 @@ BVIEW_OVSDB_BST_DATA_t  *bst_ovsdb_cache_get ();
 *
 * @param[in]   asic      -  asic number
 * @param[in]   ovsdb_key -  ovsdb bufmon table's name/key entry
-* @param[out]  p_row     -  Pointer to the row
+* @param[out]  p_index   -  counter of the row in the cache arrays
 
 *
 * @retval BVIEW_STATUS_FAILURE      Failed to get row from ovsdb key
@@ -166,47 +236,155 @@ BVIEW_OVSDB_BST_DATA_t  *bst_ovsdb_cache_get ();
 *********************************************************************/
 BVIEW_STATUS bst_ovsdb_cache_row_get (int asic, int bid, int index1,
                                       int index2,
-                                      BVIEW_OVSDB_BID_INFO_t **p_row);
+                                      unsigned int *p_index);
 
 /*********************************************************************
-* @brief    Update the stat/threshold of row with key 'ovsdb_key'.
+* @brief    Get row from ovsdb-key  <realm>/<name>/<index1>/<index2>
 *
 *
 * @param[in]   asic      -  asic number
 * @param[in]   ovsdb_key -  ovsdb bufmon table's name/key entry
 * @param[out]  p_row     -  Pointer to the row
+
 *
-* @retval BVIEW_STATUS_FAILURE      Failed to get the row for ovsdb_key.
-* @retval BVIEW_STATUS_SUCCESS      updated cache successfully.
+* @retval BVIEW_STATUS_FAILURE      Failed to get row from ovsdb key
+* @retval BVIEW_STATUS_SUCCESS
 *
 *
 *
 * @notes    none
 *********************************************************************/
-BVIEW_STATUS    bst_ovsdb_row_update (int asic,  int bid,
-                                      int port,  int queue,
-                                      bool default_threshold,
-                                      BVIEW_OVSDB_BID_INFO_t *p_row);
+BVIEW_STATUS bst_ovsdb_row_info_get (int asic, const char *ovsdb_key,
+                                     int *pbid, int *port,
+                                     int *queue);
 
 /*********************************************************************
-* @brief    Get row from ovsdb-key  <realm>/<name>/<index1>/<index2>
+* @brief    Resolve a bufmon row to its cache entry.
 *
+* @param[in]   uuid      -  row UUID, as the monitor names the row
+* @param[in]   asic      -  asic number of the row
+* @param[in]   ovsdb_key -  name of the row, NULL if not at hand
+* @param[out]  p_ref     -  the resolved row
 *
-* @param[in]   asic      -  asic number
-* @param[in]   ovsdb_key -  ovsdb bufmon table's name/key entry
-* @param[out]  p_row     -  Pointer to the row
+* @retval BVIEW_STATUS_FAILURE      row unknown and its name missing or
+*                                   not a BST counter
+* @retval BVIEW_STATUS_SUCCESS      row resolved
+*
+* @notes    A row seen once is found again by its UUID without
+*           parsing its name. Monitor thread only.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_row_ref_get (const char *uuid, int asic,
+                                    const char *ovsdb_key,
+                                    BVIEW_OVSDB_ROW_REF_t *p_ref);
 
+/*********************************************************************
+* @brief    Read back the cached columns of a bufmon row.
 *
-* @retval BVIEW_STATUS_FAILURE      Failed to get row from ovsdb key
-* @retval BVIEW_STATUS_SUCCESS
+* @param[in]   p_ref     -  row resolved by bst_ovsdb_row_ref_get
+* @param[out]  p_row     -  cached columns of the row
 *
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_SUCCESS            columns read.
 *
+* @notes    Monitor thread only, it is the one writer of the cache.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_row_cached_get (const BVIEW_OVSDB_ROW_REF_t *p_ref,
+                                       BVIEW_OVSDB_BID_INFO_t *p_row);
+
+/*********************************************************************
+* @brief    Start a sweep of the row index.
 *
-* @notes    none
+* @notes    Every row is unseen until bst_ovsdb_row_ref_get finds it
+*           again. Monitor thread only.
 *********************************************************************/
-BVIEW_STATUS bst_ovsdb_row_info_get (int asic, char *ovsdb_key,
-                                     int *pbid, int *port,
-                                     int *queue);
+void bst_ovsdb_row_refs_unmark (void);
+
+/*********************************************************************
+* @brief    Get the next row not seen since the sweep started.
+*
+* @param[in,out]  p_cursor  -  position in the index, 0 to start
+* @param[out]     uuid      -  row UUID, BVIEW_OVSDB_ROW_UUID_SIZE + 1 bytes
+* @param[out]     p_ref     -  the row
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_FAILURE            no more unseen rows
+* @retval BVIEW_STATUS_SUCCESS            unseen row found
+*
+* @notes    The index is not to change during the walk. Monitor thread
+*           only.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_row_ref_unseen_get (unsigned int *p_cursor, char *uuid,
+                                           BVIEW_OVSDB_ROW_REF_t *p_ref);
+
+/*********************************************************************
+* @brief    Forget a bufmon row deleted from the database.
+*
+* @param[in]   uuid      -  row UUID
+*
+* @notes    Monitor thread only.
+*********************************************************************/
+void bst_ovsdb_row_ref_delete (const char *uuid);
+
+/*********************************************************************
+* @brief    Mark the cache as out of sync with the database, or back
+*           in sync.
+*
+* @param[in]   stale     -  cache out of sync
+*
+* @notes    The cache keeps its values while the monitor resyncs.
+*********************************************************************/
+void bst_ovsdb_cache_stale_set (bool stale);
+
+/*********************************************************************
+* @brief    Tell if the cache is out of sync with the database.
+*
+* @retval   true while the monitor resyncs
+*********************************************************************/
+bool bst_ovsdb_cache_stale_get (void);
+
+/*********************************************************************
+* @brief    Note a snapshot served from the cache in sync.
+*
+* @notes    The first one after a resync times the lost session up to
+*           a valid report, see bst_ovsdb_cache_dump.
+*********************************************************************/
+void bst_ovsdb_cache_report_served (void);
+
+/*********************************************************************
+* @brief    Apply a batch of bufmon row updates to the cache.
+*
+* @param[in]   p_updates      -  staged rows of one table update
+* @param[in]   count          -  number of staged rows
+* @param[in]   trackMask      -  realms found enabled in the batch
+* @param[out]  p_oldTrackMask -  tracking mask before the batch
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_SUCCESS            updated cache successfully.
+*
+* @notes    The batch is applied under one write lock.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_row_updates_apply (BVIEW_OVSDB_ROW_UPDATE_t *p_updates,
+                                          int count, int trackMask,
+                                          int *p_oldTrackMask);
+
+/*********************************************************************
+* @brief    Read the stats of an ASIC into a snapshot, as the map says.
+*
+* @param[in]   asic      -  asic number
+* @param[in]   p_map     -  runs of snapshot fields and their stats
+* @param[in]   count     -  number of runs in the map
+* @param[out]  p_dst     -  snapshot, as 64 bit words
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_SUCCESS            snapshot read.
+*
+* @notes    Lock free, the read is retried if the monitor updated the
+*           ASIC meanwhile. A reader that keeps losing falls back to
+*           the read lock.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_snapshot_read (int asic,
+                                   const BVIEW_OVSDB_SNAPSHOT_MAP_t *p_map,
+                                   int count, uint64_t *p_dst);
 
 /*********************************************************************
 * @brief   Dumps BST ovsdb cache. 
@@ -18,18 +18,23 @@
 
 /* OVSDB includes*/
 #include <unistd.h>
+#include <errno.h>
 #include <pthread.h>
 #include <semaphore.h>
 #include <openvswitch/compiler.h>
 #include <json.h>
 #include <jsonrpc.h>
+#include <latch.h>
 #include <ovsdb-data.h>
 #include <poll-loop.h>
 #include <stream.h>
+#include <timeval.h>
 
 /* BroadView Includes*/
 #include "broadview.h"
 #include "ovsdb_common_ctl.h"
+#include "ovsdb_client.h"
+#include "ovsdb_txn.h"
 #include "sbplugin_bst_ovsdb.h"
 #include "sbplugin_bst_cache.h"
 #include "ovsdb_bst_ctl.h"
@@ -39,110 +44,95 @@ extern BVIEW_BST_OVSDB_BID_PARAMS_t  bid_tab_params[SB_OVSDB_BST_STAT_ID_MAX_COU
 
 
 
-#define   BST_OVSDB_THRESHOLD_JSON    "[\"OpenSwitch\",{\"op\":\"update\",\"table\":\"bufmon\",\"row\":{\"trigger_threshold\":%lld},\"where\":[[\"name\",\"==\", \"%s\"]]}]"
+/* Operations of the transactions the plugin commits, see ovsdb_txn.h */
+#define   BST_OVSDB_THRESHOLD_OP    "{\"op\":\"update\",\"table\":\"bufmon\",\"row\":{\"trigger_threshold\":%lld},\"where\":[[\"name\",\"==\", \"%s\"]]}"
 
 
-#define   BST_OVSDB_CONFIG_JSON_FORMAT       "[\"OpenSwitch\",{\"op\":\"update\",\"table\":\"System\",\"row\":{\"bufmon_config\":[\"map\",[[\"enabled\",\"%s\"], [\"counters_mode\",\"%s\"], [\"periodic_collection_enabled\",\"%s\"], [\"snapshot_on_threshold_trigger\", \"%s\"], [\"collection_period\", \"%s\"], [\"threshold_trigger_rate_limit\", \"%s\"],[\"threshold_trigger_collection_enabled\", \"%s\"]]]} , \"where\":[[\"_uuid\",\"==\",[\"uuid\", \"%s\"]]]}]"
+#define   BST_OVSDB_CONFIG_OP_FORMAT       "{\"op\":\"update\",\"table\":\"System\",\"row\":{\"bufmon_config\":[\"map\",[[\"enabled\",\"%s\"], [\"counters_mode\",\"%s\"], [\"periodic_collection_enabled\",\"%s\"], [\"snapshot_on_threshold_trigger\", \"%s\"], [\"collection_period\", \"%s\"], [\"threshold_trigger_rate_limit\", \"%s\"],[\"threshold_trigger_collection_enabled\", \"%s\"]]]} , \"where\":[[\"_uuid\",\"==\",[\"uuid\", \"%.36s\"]]]}"
 
-#define  BST_JSON_MONITOR_BUFMON   "[\"OpenSwitch\",null,{\"bufmon\":[{\"columns\":[\"counter_value\",\"counter_vendor_specific_info\",\"enabled\",\"hw_unit_id\",\"name\",\"status\",\"trigger_threshold\",\"_version\"]}], \"System\":[{\"columns\":[\"bufmon_config\"]},{\"columns\":[\"bufmon_info\"]}]}]"
+/* System columns, monitored with the v1 protocol */
+#define  BST_JSON_MONITOR_SYSTEM   "[\"OpenSwitch\",null,{\"System\":[{\"columns\":[\"bufmon_config\"]},{\"columns\":[\"bufmon_info\"]}]}]"
 
+/* bufmon rows matching a condition, see BST_JSON_MONITOR_WHERE_ENABLED.
+ * update2 sends the key columns with the initial and inserted rows only */
+#define  BST_JSON_MONITOR_COND_BUFMON   "[\"OpenSwitch\",\"bufmon\",{\"bufmon\":[{\"columns\":[\"counter_value\",\"enabled\",\"hw_unit_id\",\"name\",\"status\",\"trigger_threshold\"],\"where\":%s}]}]"
+#define  BST_JSON_MONITOR_COND_SINCE_BUFMON   "[\"OpenSwitch\",\"bufmon\",{\"bufmon\":[{\"columns\":[\"counter_value\",\"enabled\",\"hw_unit_id\",\"name\",\"status\",\"trigger_threshold\"],\"where\":%s}]},\"%s\"]"
+#define  BST_JSON_MONITOR_COND_CHANGE   "[\"bufmon\",\"bufmon\",{\"bufmon\":[{\"where\":%s}]}]"
 
-#define   BST_OVSDB_CLEAR_THRESHOLDS_JSON  "[\"OpenSwitch\",{\"op\":\"update\",\"table\":\"bufmon\",\"row\":{\"trigger_threshold\":[\"set\",[]]},\"where\":[[\"hw_unit_id\",\"==\",%d]]}]"
-#define   BST_OVSDB_CLEAR_STATS_JSON  "[\"OpenSwitch\",{\"op\":\"update\",\"table\":\"bufmon\",\"row\":{\"counter_value\":0},\"where\":[[\"hw_unit_id\",\"==\",%d]]}]"
+/* bufmon rows for a server without monitor_cond, the key columns come
+ * with the initial and inserted rows only */
+#define  BST_JSON_MONITOR_BUFMON   "[\"OpenSwitch\",\"bufmon\",{\"bufmon\":[{\"columns\":[\"hw_unit_id\",\"name\"],\"select\":{\"initial\":true,\"insert\":true,\"delete\":false,\"modify\":false}},{\"columns\":[\"counter_value\",\"enabled\",\"status\",\"trigger_threshold\"]}]}]"
 
-#define    BST_JSON_TRACKING_FORMAT_ENABLE "[\"OpenSwitch\",{\"op\":\"update\",\"table\":\"bufmon\",\"row\":{\"enabled\":true},\"where\":[[\"counter_vendor_specific_info\",\"includes\", [\"map\",[[\"realm\",\"%s\"]]]]]}]"
+/* Condition of the bufmon monitor, the clauses of a monitor condition
+ * are or'ed : the enabled rows, and the rows of each tracked realm */
+#define  BST_JSON_MONITOR_WHERE_ENABLED  "[[\"enabled\",\"==\",true]"
+#define  BST_JSON_MONITOR_WHERE_REALM    ",[\"counter_vendor_specific_info\",\"includes\",[\"map\",[[\"realm\",\"%s\"]]]]"
+#define  BST_OVSDB_MONITOR_WHERE_SIZE    2048
+#define  BST_OVSDB_MONITOR_REQUEST_SIZE  (BST_OVSDB_MONITOR_WHERE_SIZE + 512)
 
 
-#define    BST_JSON_TRACKING_FORMAT_DISABLE "[\"OpenSwitch\",{\"op\":\"update\",\"table\":\"bufmon\",\"row\":{\"enabled\":[\"set\",[]]},\"where\":[[\"counter_vendor_specific_info\",\"includes\", [\"map\",[[\"realm\",\"%s\"]]]]]}]"
+#define   BST_OVSDB_CLEAR_THRESHOLDS_OP  "{\"op\":\"update\",\"table\":\"bufmon\",\"row\":{\"trigger_threshold\":[\"set\",[]]},\"where\":[[\"hw_unit_id\",\"==\",%d]]}"
+#define   BST_OVSDB_CLEAR_STATS_OP  "{\"op\":\"update\",\"table\":\"bufmon\",\"row\":{\"counter_value\":0},\"where\":[[\"hw_unit_id\",\"==\",%d]]}"
+
+#define    BST_JSON_TRACKING_OP_ENABLE "{\"op\":\"update\",\"table\":\"bufmon\",\"row\":{\"enabled\":true},\"where\":[[\"counter_vendor_specific_info\",\"includes\", [\"map\",[[\"realm\",\"%s\"]]]]]}"
+
+
+#define    BST_JSON_TRACKING_OP_DISABLE "{\"op\":\"update\",\"table\":\"bufmon\",\"row\":{\"enabled\":[\"set\",[]]},\"where\":[[\"counter_vendor_specific_info\",\"includes\", [\"map\",[[\"realm\",\"%s\"]]]]]}"
 static char system_table_uuid[OVSDB_UUID_SIZE];
 #define  BST_NUM_MONITOR_TABLES              2
 const char *bst_table_name[BST_NUM_MONITOR_TABLES] = {"bufmon", "System"};
 extern sem_t monitor_init_done_sem;
 
+/* first size of the row staging list, doubled when full */
+#define  BST_OVSDB_ROW_STAGING_INITIAL_SIZE  1024
 
-BVIEW_BST_REALM_MAP_t realm_id_map[BVIEW_BST_COUNT] = {
-    {.realmName = "device",
-     .realmId = BVIEW_BST_DEVICE},
-    {.realmName = "ingress-port-priority-group",
-     .realmId =BVIEW_BST_INGRESS_PORT_PG},
-    {.realmName = "ingress-port-service-pool",
-     .realmId =BVIEW_BST_INGRESS_PORT_SP},
-    {.realmName ="ingress-service-pool",
-     .realmId =BVIEW_BST_INGRESS_SP},
-    {.realmName ="egress-port-service-pool",
-     .realmId =BVIEW_BST_EGRESS_PORT_SP},
-    {.realmName ="egress-service-pool",
-     .realmId =BVIEW_BST_EGRESS_SP},
-    {.realmName ="egress-uc-queue",
-     .realmId =BVIEW_BST_EGRESS_UC_QUEUE},
-    {.realmName ="egress-uc-queue-group",
-     .realmId =BVIEW_BST_EGRESS_UC_QUEUEGROUPS},
-    {.realmName ="egress-mc-queue",
-     .realmId =BVIEW_BST_EGRESS_MC_QUEUE},
-    {.realmName ="egress-cpu-queue",
-     .realmId =BVIEW_BST_EGRESS_CPU_QUEUE},
-    {.realmName ="egress-rqe-queue",
-     .realmId =BVIEW_BST_EGRESS_RQE_QUEUE
-    }
-  };
-
-
-/*********************************************************************
-* @brief      Get Realm name form id
-*
-* @param[in]  realmId               -  realm ID
-* @param[in]  realmName             - realm Name
-*
-* @retval
-*********************************************************************/
-static BVIEW_STATUS bst_ovsdb_realm_name_get (int realmId,
-                                              char *realmName)
+/* bufmon rows of the table update being applied. Used by the monitor
+ * thread only */
+static struct
 {
-  unsigned int i = 0;
+  BVIEW_OVSDB_ROW_UPDATE_t *rows;
+  int                       size;
+  int                       count;
+} bst_ovsdb_row_staging;
 
-  if (realmId >= BVIEW_BST_REALM_ID_MAX)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
-  for (i = BVIEW_BST_REALM_ID_MIN; i < BVIEW_BST_REALM_ID_MAX; i++)
-  {
-    if (realmId == realm_id_map[i-1].realmId)
-    {
-      sprintf (realmName, "%s", realm_id_map[i-1].realmName);
-    }
-  }
+/* last transaction id of a monitor_cond_since with none seen yet */
+#define  BST_OVSDB_MONITOR_TXN_NONE      "00000000-0000-0000-0000-000000000000"
 
-  return BVIEW_STATUS_SUCCESS;
-}
-
-/*********************************************************************
-* @brief      Get Realm Id form name 
-*
-* @param[in]  realmId               -  realm name 
-* @param[in]  realmName             - realm id 
-*
-* @retval
-*********************************************************************/
-static BVIEW_STATUS bst_ovsdb_realm_id_get (char *realmName,
-                                            int *realmId)
+/* ways of monitoring the bufmon table, tried in this order */
+typedef enum _bst_ovsdb_monitor_method_
 {
-  unsigned int i = 0;
-
-  if (realmName == NULL)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
-  for (i = BVIEW_BST_REALM_ID_MIN; i < BVIEW_BST_REALM_ID_MAX; i++)
-  {
-    if (0 == strcmp(realmName, realm_id_map[i-1].realmName))
-    {
-      *realmId = realm_id_map[i-1].realmId;
-      return BVIEW_STATUS_SUCCESS;
-    }
-  }
-
-  return BVIEW_STATUS_FAILURE;
-}
+  BST_OVSDB_MONITOR_COND_SINCE = 0,
+  BST_OVSDB_MONITOR_COND,
+  BST_OVSDB_MONITOR_PLAIN
+} BST_OVSDB_MONITOR_METHOD_t;
+
+/* State of the monitor session. wantMask is set by the tracking commits,
+ * the rest is used by the monitor thread only */
+static struct
+{
+  /* set when the tracking mask changes */
+  struct latch  wake;
+  bool          wakeReady;
+  /* how bufmon is monitored */
+  BST_OVSDB_MONITOR_METHOD_t method;
+  /* last transaction seen, for monitor_cond_since */
+  char          lastTxnId[OVSDB_UUID_SIZE + 1];
+  /* requests of the session waiting for their reply */
+  struct json  *systemId;
+  struct json  *bufmonId;
+  struct json  *changeId;
+  /* next session open, and the wait after a failure */
+  long long int reconnectAt;
+  long long int backoff;
+  /* initial bufmon rows and bufmon_config applied */
+  bool          bufmonSynced;
+  bool          configSynced;
+  /* plugin init released */
+  bool          initDone;
+  /* realms of the condition sent, and of the tracking mask */
+  int           whereMask;
+  int           wantMask;
+} bst_ovsdb_monitor_state;
 
 
 /*********************************************************************
@@ -297,28 +287,241 @@ bst_system_bufmon_config_update (struct json *json_object)
 
   return BVIEW_STATUS_SUCCESS;
 }
+/*********************************************************************
+* @brief    Make room for one more staged bufmon row.
+*
+* @retval BVIEW_STATUS_RESOURCE_NOT_AVAILABLE   Failed to grow the list
+* @retval BVIEW_STATUS_SUCCESS             Room for one more row
+*
+* @notes    Monitor thread only.
+*********************************************************************/
+static BVIEW_STATUS
+bst_ovsdb_row_staging_reserve (void)
+{
+  BVIEW_OVSDB_ROW_UPDATE_t *p_rows;
+  int size;
+
+  if (bst_ovsdb_row_staging.count < bst_ovsdb_row_staging.size)
+  {
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  size = (0 == bst_ovsdb_row_staging.size) ?
+          BST_OVSDB_ROW_STAGING_INITIAL_SIZE : 2 * bst_ovsdb_row_staging.size;
+  p_rows = realloc (bst_ovsdb_row_staging.rows, size * sizeof (*p_rows));
+  if (NULL == p_rows)
+  {
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+  bst_ovsdb_row_staging.rows = p_rows;
+  bst_ovsdb_row_staging.size = size;
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Apply the staged bufmon rows to the cache.
+*
+* @param[in]     trackMask  - realms found enabled in the staged rows
+*
+* @notes    The rows go into the cache under one write lock, then the
+*           triggers they carry are reported and the deleted rows
+*           dropped from the row index. Monitor thread only.
+*********************************************************************/
+static void
+bst_ovsdb_row_staging_flush (int trackMask)
+{
+  BVIEW_OVSDB_ROW_UPDATE_t *p_update;
+  int oldTrackMask = 0;
+  int i;
+
+  bst_ovsdb_row_updates_apply (bst_ovsdb_row_staging.rows,
+                               bst_ovsdb_row_staging.count,
+                               trackMask, &oldTrackMask);
+
+  for (i = 0; i < bst_ovsdb_row_staging.count; i++)
+  {
+    p_update = &bst_ovsdb_row_staging.rows[i];
+    if (p_update->triggered)
+    {
+      /*
+       The indexing for the params like
+       queue, queue-group etc starts from
+       1 in the driver.
+      */
+      bst_ovsdb_trigger_callback (p_update->ref.asic,
+        p_update->ref.bid, p_update->ref.port, p_update->ref.queue-1);
+    }
+  }
+  for (i = 0; i < bst_ovsdb_row_staging.count; i++)
+  {
+    if (bst_ovsdb_row_staging.rows[i].deleted)
+    {
+      bst_ovsdb_row_ref_delete (bst_ovsdb_row_staging.rows[i].uuid);
+    }
+  }
+  bst_ovsdb_row_staging.count = 0;
+
+  /* check if there is any diff in old and new track mask, the batch
+   * only adds realms, and updates of other columns add none */
+  if ((oldTrackMask | trackMask) != oldTrackMask)
+  {
+    bst_notify_config_change (0, BVIEW_BST_CONFIG_TRACK_UPDATE);
+  }
+}
+
+/*********************************************************************
+* @brief    Get the values of a bufmon column.
+*
+* @param[in]    column    - Pointer to the column JSON value.
+* @param[out]   p_values  - values, room for two.
+*
+* @retval   number of values, -1 if the column cannot be read
+*
+* @notes    A column is an atom or a ["set",[...]] of at most one atom,
+*           two for an update2 difference. Integers and booleans are
+*           taken as such, a status string as "triggered" or not.
+*********************************************************************/
+static int
+bst_ovsdb_column_values_get (const struct json *column, uint64_t *p_values)
+{
+  const struct json *set;
+  const struct json *atom;
+  size_t n;
+
+  if (column->type == JSON_ARRAY)
+  {
+    if ((json_array (column)->n != 2) ||
+        (json_array (column)->elems[0]->type != JSON_STRING) ||
+        (strcmp (json_array (column)->elems[0]->u.string, "set") != 0) ||
+        (json_array (column)->elems[1]->type != JSON_ARRAY))
+    {
+      return -1;
+    }
+    set = json_array (column)->elems[1];
+  }
+  else
+  {
+    set = NULL;
+  }
+
+  for (n = 0; n < (set ? json_array (set)->n : 1); n++)
+  {
+    atom = set ? json_array (set)->elems[n] : column;
+    if (n >= 2)
+    {
+      return -1;
+    }
+    switch (atom->type)
+    {
+      case JSON_INTEGER:
+        p_values[n] = atom->u.integer;
+        break;
+      case JSON_TRUE:
+        p_values[n] = 1;
+        break;
+      case JSON_FALSE:
+        p_values[n] = 0;
+        break;
+      case JSON_STRING:
+        p_values[n] = (strcmp ("triggered", atom->u.string) == 0) ? 1 : 0;
+        break;
+      default:
+        return -1;
+    }
+  }
+  return (int) n;
+}
+
+/*********************************************************************
+* @brief    Resolve the new value of a bufmon column.
+*
+* @param[in]    column    - Pointer to the column JSON value, or NULL.
+* @param[in]    diff      - column is an update2 difference.
+* @param[in]    old       - value before the update.
+* @param[in]    unset     - value of the column when empty.
+*
+* @retval   new value of the column
+*
+* @notes    update2 sends the difference for the optional columns :
+*           the one value added or removed, or the two values swapped.
+*           For a plain column it is the new value, which differs from
+*           the old one, so the same rules apply.
+*********************************************************************/
+static uint64_t
+bst_ovsdb_column_resolve (const struct json *column, bool diff,
+                          uint64_t old, uint64_t unset)
+{
+  uint64_t values[2];
+  int n;
+
+  if (NULL == column)
+  {
+    return old;
+  }
+  n = bst_ovsdb_column_values_get (column, values);
+  if (n < 0)
+  {
+    return old;
+  }
+  if (!diff)
+  {
+    return (n > 0) ? values[0] : unset;
+  }
+  if (n == 1)
+  {
+    return (values[0] == old) ? unset : values[0];
+  }
+  if (n == 2)
+  {
+    return (values[0] == old) ? values[1] : values[0];
+  }
+  return old;
+}
+
+/*********************************************************************
+* @brief    Get a column of a row.
+*
+* @param[in]    row       - Pointer to the row JSON object, or NULL.
+* @param[in]    name      - column name.
+*
+* @retval   the column, NULL if the row does not carry it
+*********************************************************************/
+static struct json *
+bst_ovsdb_row_column_get (struct json *row, const char *name)
+{
+  if ((NULL == row) || (row->type != JSON_OBJECT))
+  {
+    return NULL;
+  }
+  return shash_find_data (json_object (row), name);
+}
+
 /*********************************************************************
 * @brief    Update SB PLUGIN cache.
 *
 * @param[in]   table_name   - Pointer to the table_name string.
 * @param[in]   table_update - Pointer to "Update" JSON Object.
-* @param[in]   Initial      - Initial rows
+* @param[in]   update2      - rows are in update2 format
 *
 * @retval
 *
-* @notes    if Initial
+* @notes    The bufmon rows of the update are parsed into a staging
+*           list first and applied to the cache in one go, readers
+*           never see half of a notification.
 *
+*           A bufmon update carries only some of the columns, for
+*           update2 the difference of some. The columns are resolved
+*           against the cached ones, the staged rows carry them all.
 *
 *********************************************************************/
 static BVIEW_STATUS
 bst_ovsdb_cache_update_table(const char *table_name, struct json *table_update,
-                               bool initial)
+                               bool update2)
 {
   struct shash_node *node;
-  BVIEW_OVSDB_BST_DATA_t     *p_cache = NULL;
   int                         trackMask = 0;
-  int                         oldTrackMask = 0;
-  static bool sys_cache_init_done = false;
+  bool                        bufmon = false;
 
   /* NULL Pointer validation*/
   SB_OVSDB_NULLPTR_CHECK (table_update, BVIEW_STATUS_INVALID_PARAMETER);
@@ -330,151 +533,161 @@ bst_ovsdb_cache_update_table(const char *table_name, struct json *table_update,
     return BVIEW_STATUS_FAILURE;
   }
 
-  p_cache = bst_ovsdb_cache_get ();
-  if (!p_cache)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
-
-  /* Acquire write lock*/
-  SB_OVSDB_RWLOCK_WR_LOCK(p_cache->lock);
-  /* store the previous config
-     for later inspection */
-  oldTrackMask = p_cache->config_data.trackingMask;
-  /* Release lock */
-  SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
+  bufmon = (strcmp (table_name, "bufmon") == 0);
 
-  /* Loop through all Nodes and update the cahce*/
+  /* Loop through all Nodes and stage the bufmon rows */
   SHASH_FOR_EACH (node, json_object(table_update))
   {
-    BVIEW_OVSDB_BID_INFO_t   row = {0,0,0};
+    BVIEW_OVSDB_ROW_UPDATE_t *p_update;
+    BVIEW_OVSDB_BID_INFO_t    cached;
+    BVIEW_OVSDB_BID_INFO_t    base;
+    uint64_t                  defaultThreshold = 0;
     struct json *row_update = node->data;
-    struct json *old, *new, *hw_unit_id, *name, *counter_value, *trigger_threshold, *enabled, *status;
-    bool   default_threshold = false;
-    int    port=0, queue=-1, bid =-1, realm_id;
+    struct json *old, *new, *row, *hw_unit_id, *name;
+    bool   diff = false;
+    bool   deleted = false;
+    int    realm_id;
 
     if (row_update->type != JSON_OBJECT) {
       continue;
     }
-    old = shash_find_data(json_object(row_update), "old");
-    new = shash_find_data(json_object(row_update), "new");
-    if (strcmp (table_name, "bufmon") == 0)
+    if (bufmon)
     {
-      OVSDB_GET_COLUMN (hw_unit_id, old, new , "hw_unit_id")
-      OVSDB_GET_COLUMN (name, old, new , "name")
-      OVSDB_GET_COLUMN (counter_value, old, new , "counter_value")
-      OVSDB_GET_COLUMN (trigger_threshold, old, new , "trigger_threshold")
-      OVSDB_GET_COLUMN (enabled, old, new , "enabled")
-      OVSDB_GET_COLUMN (status, old, new , "status")
-
-      /* Name + hw_unit_id is key, if both are NULL don't update the cache.*/
-      if (name && hw_unit_id)
+      if (update2)
       {
-        /* Parse the Name and get bid, port, queue*/
-        if (BVIEW_STATUS_SUCCESS !=
-              bst_ovsdb_row_info_get (hw_unit_id->u.integer,
-              name->u.string, &bid,
-              &port, &queue))
+        /* one of initial, insert, modify or delete */
+        row = shash_find_data(json_object(row_update), "modify");
+        diff = (NULL != row);
+        if (NULL == row)
         {
-          continue;
+          row = shash_find_data(json_object(row_update), "initial");
         }
-        if (counter_value && counter_value->type == JSON_INTEGER)
+        if (NULL == row)
         {
-          row.stat = counter_value->u.integer;
+          row = shash_find_data(json_object(row_update), "insert");
         }
+        deleted = (NULL != shash_find_data(json_object(row_update), "delete"));
+      }
+      else
+      {
+        old = shash_find_data(json_object(row_update), "old");
+        new = shash_find_data(json_object(row_update), "new");
+        row = new ? new : old;
+        deleted = (NULL == new);
+      }
+      if ((NULL == row) && !deleted)
+      {
+        continue;
+      }
+      hw_unit_id = bst_ovsdb_row_column_get (row, "hw_unit_id");
+      name = bst_ovsdb_row_column_get (row, "name");
 
-        if (trigger_threshold && trigger_threshold->type == JSON_INTEGER)
+      if (BVIEW_STATUS_SUCCESS != bst_ovsdb_row_staging_reserve ())
+      {
+        /* out of memory, apply what is staged and go on from there */
+        SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+            "OVSDB BST monitor: Failed to grow the row staging list");
+        bst_ovsdb_row_staging_flush (trackMask);
+        if (0 == bst_ovsdb_row_staging.size)
         {
-          row.threshold = trigger_threshold->u.integer;
+          continue;
         }
-        else if (trigger_threshold && trigger_threshold->type == JSON_ARRAY)
+      }
+      p_update = &bst_ovsdb_row_staging.rows[bst_ovsdb_row_staging.count];
+      memset (p_update, 0, sizeof (*p_update));
+
+      /* Get bid, port, queue of the row, by its uuid once known.
+       * Name + hw_unit_id is key, a row first seen without them is
+       * skipped */
+      if (BVIEW_STATUS_SUCCESS !=
+            bst_ovsdb_row_ref_get (node->name,
+                (hw_unit_id && hw_unit_id->type == JSON_INTEGER) ?
+                hw_unit_id->u.integer : -1,
+                (name && name->type == JSON_STRING) ? name->u.string : NULL,
+                &p_update->ref))
+      {
+        continue;
+      }
+      bst_ovsdb_row_cached_get (&p_update->ref, &cached);
+
+      if (deleted)
+      {
+        /* Row deleted, or out of the monitor condition */
+        p_update->row = cached;
+        p_update->row.enabled = false;
+        p_update->row.triggered = false;
+        p_update->deleted = true;
+        strncpy (p_update->uuid, node->name, sizeof (p_update->uuid) - 1);
+      }
+      else
+      {
+        bst_ovsdb_default_threshold_get (p_update->ref.bid, &defaultThreshold);
+        /* update2 leaves the columns at their default out of a new row */
+        if (update2 && !diff)
         {
-          default_threshold = true;
+          memset (&base, 0, sizeof (base));
+          base.threshold = defaultThreshold;
         }
-        if (enabled)
+        else
         {
-          row.enabled = (enabled->type == JSON_TRUE) ? true :false;
-          if (row.enabled)
-          {
-            /* Get RealID*/
-            if (BVIEW_STATUS_SUCCESS ==
-              bst_ovsdb_realm_id_get (bid_tab_params[bid].realm_name,
-               &realm_id))
-            {
-              /* Check if already set ignore*/
-              if (!(trackMask & (1 << realm_id)))
-              {
-                /* Acquire write lock*/
-                SB_OVSDB_RWLOCK_WR_LOCK(p_cache->lock);
-                /* set bit*/
-                p_cache->config_data.trackingMask = (p_cache->config_data.trackingMask | (1 << realm_id));
-                /* Release lock */
-               SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
-               trackMask = (trackMask | (1 << realm_id));
-             }
-           }
+          base = cached;
         }
-      }
-      /* Update BST cache*/
-      bst_ovsdb_row_update (hw_unit_id->u.integer,
-          bid, port, queue,
-          default_threshold,
-          &row);
-      if (status && status->type == JSON_STRING)
-      {
-        if (strcmp("triggered", status->u.string) == 0)
+        p_update->row.stat = bst_ovsdb_column_resolve (
+                 bst_ovsdb_row_column_get (row, "counter_value"),
+                 diff, base.stat, 0);
+        p_update->row.threshold = bst_ovsdb_column_resolve (
+                 bst_ovsdb_row_column_get (row, "trigger_threshold"),
+                 diff, base.threshold, defaultThreshold);
+        p_update->row.enabled = bst_ovsdb_column_resolve (
+                 bst_ovsdb_row_column_get (row, "enabled"),
+                 diff, base.enabled, false) ? true : false;
+        p_update->row.triggered = bst_ovsdb_column_resolve (
+                 bst_ovsdb_row_column_get (row, "status"),
+                 diff, base.triggered, false) ? true : false;
+        /* report the rows going into "triggered" */
+        p_update->triggered = (p_update->row.triggered && !cached.triggered);
+        if (p_update->row.enabled)
         {
-          /*
-           The indexing for the params like
-           queue, queue-group etc starts from
-           1 in the driver.
-          */
-          bst_ovsdb_trigger_callback (hw_unit_id->u.integer,
-            bid, port, queue-1);
+          /* realm of the BID, a registry id */
+          realm_id = bid_tab_params[p_update->ref.bid].realm;
+          trackMask = (trackMask | (1 << realm_id));
         }
       }
-     }
-   } /* if (strcmp (table_name, ..... */
-   else if (strcmp (table_name,"System") ==0)
-   {
-     struct json *config;
-
-     /* Validate UUID length*/
-     if (strlen (node->name) !=  OVSDB_UUID_SIZE)
-     {
-       SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-        "OVSDB BST monitor: Invalid UUID length (%d)",
-        strlen (node->name));
-       continue;
-     }
-     /* COPY UUID*/
-     strncpy (system_table_uuid, node->name, sizeof(system_table_uuid));
-     OVSDB_GET_COLUMN (config, old, new, "bufmon_config");
-     if (config)
-     {
-       bst_system_bufmon_config_update (config);
-       sys_cache_init_done = true;
-     }
-   }
- } /* SHASH_FOR_EACH (node, json_object(table_update)) */
-
-  /* check if there is any diff in old and new track mask */
-  if (oldTrackMask != trackMask)
-  {
-    bst_notify_config_change (0, BVIEW_BST_CONFIG_TRACK_UPDATE);
-  } 
-
-  if (strlen (system_table_uuid) > 0)
-  {
-    if (sys_cache_init_done)
+      bst_ovsdb_row_staging.count++;
+    } /* if (bufmon) */
+    else if (strcmp (table_name,"System") ==0)
     {
-      if (sem_post(&monitor_init_done_sem) != 0)
+      struct json *config;
+
+      old = shash_find_data(json_object(row_update), "old");
+      new = shash_find_data(json_object(row_update), "new");
+      if (!old && !new)
+      {
+        continue;
+      }
+      /* Validate UUID length*/
+      if (strlen (node->name) !=  OVSDB_UUID_SIZE)
       {
         SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-           "OVSDB BST monitor: Failed to release semaphore");
-        return BVIEW_STATUS_FAILURE;
+         "OVSDB BST monitor: Invalid UUID length (%d)",
+         strlen (node->name));
+        continue;
+      }
+      /* COPY UUID*/
+      strncpy (system_table_uuid, node->name, sizeof(system_table_uuid));
+      OVSDB_GET_COLUMN (config, old, new, "bufmon_config");
+      if (config)
+      {
+        bst_system_bufmon_config_update (config);
+        bst_ovsdb_monitor_state.configSynced = true;
       }
     }
+  } /* SHASH_FOR_EACH (node, json_object(table_update)) */
+
+  if (bufmon)
+  {
+    /* Apply the whole update at once */
+    bst_ovsdb_row_staging_flush (trackMask);
   }
 
   return BVIEW_STATUS_SUCCESS;
@@ -485,9 +698,7 @@ bst_ovsdb_cache_update_table(const char *table_name, struct json *table_update,
 * @brief     update the sbplugin cache.
 *
 *@param[in]  table_updates    -  Pointer to "Update" JSON object.
-*@param[in]  mts              -  Pointer to local monitored table.
-*@param[in]  n_mts            -  number of tables monitored.
-*@param[in]  initial          -  Is it initial Notification from server.
+*@param[in]  update2          -  rows are in update2 format.
 *
 * @retval
 * @notes   
@@ -496,7 +707,7 @@ bst_ovsdb_cache_update_table(const char *table_name, struct json *table_update,
 *********************************************************************/
 static BVIEW_STATUS
 bst_ovsdb_cache_update(struct json *table_updates,
-                       bool initial)
+                       bool update2)
 {
   size_t i;
   struct json *table_update;    
@@ -520,102 +731,577 @@ bst_ovsdb_cache_update(struct json *table_updates,
                                    bst_table_name[i]);
     if (table_update) 
     {
-       bst_ovsdb_cache_update_table(bst_table_name[i], table_update, initial);
+       bst_ovsdb_cache_update_table(bst_table_name[i], table_update, update2);
     }
   }
   return BVIEW_STATUS_SUCCESS;
 }
+
 /*********************************************************************
-* @brief   BST OVSDB monitor thread
+* @brief    Build the condition of the bufmon monitor.
+*
+* @param[in]    mask      - realms tracked.
+* @param[out]   where     - condition, a JSON array.
+* @param[in]    size      - size of the buffer.
 *
+* @retval BVIEW_STATUS_FAILURE   condition does not fit the buffer
+* @retval BVIEW_STATUS_SUCCESS   condition built
+*********************************************************************/
+static BVIEW_STATUS
+bst_ovsdb_monitor_where_build (int mask, char *where, size_t size)
+{
+  size_t len;
+  int realmId;
+
+  len = snprintf (where, size, "%s", BST_JSON_MONITOR_WHERE_ENABLED);
+  for (realmId = BVIEW_BST_REALM_ID_MIN;
+       (realmId < BVIEW_BST_REALM_ID_MAX) && (len < size); realmId++)
+  {
+    if (mask & (1 << realmId))
+    {
+      len += snprintf (where + len, size - len, BST_JSON_MONITOR_WHERE_REALM,
+                       bst_registry_realm_name_get (realmId));
+    }
+  }
+  if (len < size)
+  {
+    len += snprintf (where + len, size - len, "]");
+  }
+  return (len < size) ? BVIEW_STATUS_SUCCESS : BVIEW_STATUS_FAILURE;
+}
+
+/*********************************************************************
+* @brief    Send the monitor request of the bufmon table.
 *
+* @param[in]    rpc       - JSON RPC session.
+* @param[out]   p_id      - id of the request.
 *
-* @notes   Receive JSON notification from OVSDB-SERVER and Update the 
-*          SB PLUGIN cache.
+* @retval BVIEW_STATUS_FAILURE   request not sent
+* @retval BVIEW_STATUS_SUCCESS   request sent
 *
+* @notes    monitor_cond_since with the tracked realms and the last
+*           transaction seen, monitor_cond once the server turned
+*           monitor_cond_since down, the plain monitor once it turned
+*           monitor_cond down.
 *
+*           The changes since the last transaction are only good for
+*           the condition they were seen with, it is sent again and
+*           the tracking mask follows once in sync.
 *********************************************************************/
-void
-bst_ovsdb_monitor()
+static BVIEW_STATUS
+bst_ovsdb_monitor_bufmon_send (struct jsonrpc *rpc, struct json **p_id)
 {
+  char where[BST_OVSDB_MONITOR_WHERE_SIZE];
+  char params[BST_OVSDB_MONITOR_REQUEST_SIZE];
   struct jsonrpc_msg *request;
-  struct json *monitor,*request_id;
-  struct jsonrpc *rpc;
-  struct jsonrpc_msg *msg;
-  int error;
-  char connectMode[OVSDB_CONFIG_MAX_LINE_LENGTH];
-  struct json *params;
-  const char *sock_path;
+  bool since;
+  int mask;
 
+  since = (BST_OVSDB_MONITOR_COND_SINCE == bst_ovsdb_monitor_state.method);
+  if (BST_OVSDB_MONITOR_PLAIN != bst_ovsdb_monitor_state.method)
+  {
+    if (since &&
+        strcmp (bst_ovsdb_monitor_state.lastTxnId, BST_OVSDB_MONITOR_TXN_NONE))
+    {
+      mask = bst_ovsdb_monitor_state.whereMask;
+    }
+    else
+    {
+      mask = __atomic_load_n (&bst_ovsdb_monitor_state.wantMask,
+                              __ATOMIC_RELAXED);
+    }
+    if (BVIEW_STATUS_SUCCESS !=
+           bst_ovsdb_monitor_where_build (mask, where, sizeof (where)))
+    {
+      return BVIEW_STATUS_FAILURE;
+    }
+    if (since)
+    {
+      snprintf (params, sizeof (params), BST_JSON_MONITOR_COND_SINCE_BUFMON,
+                where, bst_ovsdb_monitor_state.lastTxnId);
+    }
+    else
+    {
+      snprintf (params, sizeof (params), BST_JSON_MONITOR_COND_BUFMON, where);
+    }
+    bst_ovsdb_monitor_state.whereMask = mask;
+    request = jsonrpc_create_request (since ? "monitor_cond_since" : "monitor_cond",
+                                      json_from_string (params), NULL);
+  }
+  else
+  {
+    request = jsonrpc_create_request ("monitor",
+                              json_from_string (BST_JSON_MONITOR_BUFMON), NULL);
+  }
+  *p_id = json_clone (request->id);
+  if (jsonrpc_send (rpc, request))
+  {
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+               "OVSDB BST monitor:Failed to send 'monitor bufmon table' to ovsdb-server");
+    return BVIEW_STATUS_FAILURE;
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
 
+/*********************************************************************
+* @brief    Bring the bufmon monitor condition up to the tracking mask.
+*
+* @param[in]    rpc       - JSON RPC session.
+*
+* @notes    Rows of a realm no longer tracked leave the monitor as
+*           deletes once disabled, rows of a newly tracked realm come
+*           in as inserts.
+*********************************************************************/
+static void
+bst_ovsdb_monitor_where_change (struct jsonrpc *rpc)
+{
+  char where[BST_OVSDB_MONITOR_WHERE_SIZE];
+  char params[BST_OVSDB_MONITOR_REQUEST_SIZE];
+  struct jsonrpc_msg *request;
+  int mask;
 
-  /* Open RPC Session*/
-  memset (&connectMode[0], 0, OVSDB_CONFIG_MAX_LINE_LENGTH);
-  sock_path = sbplugin_ovsdb_sock_path_get();
-  strncpy(connectMode, sock_path, OVSDB_CONFIG_MAX_LINE_LENGTH-1);
-  rpc = open_jsonrpc (connectMode); 
-  if (!rpc) 
+  mask = __atomic_load_n (&bst_ovsdb_monitor_state.wantMask, __ATOMIC_RELAXED);
+  if (mask == bst_ovsdb_monitor_state.whereMask)
+  {
+    return;
+  }
+  if (BVIEW_STATUS_SUCCESS !=
+         bst_ovsdb_monitor_where_build (mask, where, sizeof (where)))
+  {
+    return;
+  }
+  snprintf (params, sizeof (params), BST_JSON_MONITOR_COND_CHANGE, where);
+  request = jsonrpc_create_request ("monitor_cond_change",
+                                    json_from_string (params), NULL);
+  json_destroy (bst_ovsdb_monitor_state.changeId);
+  bst_ovsdb_monitor_state.changeId = json_clone (request->id);
+  if (jsonrpc_send (rpc, request))
   {
     SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-               "OVSDB BST monitor:Failed to open JSON RPC session %s", 
-                connectMode);
+               "OVSDB BST monitor:Failed to send the bufmon condition");
     return;
   }
-  /* Send monitor request to the ovsdb server*/
-  monitor = json_from_string(BST_JSON_MONITOR_BUFMON);
-  request = jsonrpc_create_request("monitor", monitor, NULL);
-  request_id = json_clone (request->id);
-  error = jsonrpc_send(rpc, request);
-  if (error)
+  bst_ovsdb_monitor_state.whereMask = mask;
+}
+
+/*********************************************************************
+* @brief    Release the plugin init once the cache is filled.
+*
+* @notes    The System row, its bufmon_config and the initial bufmon
+*           rows are all needed. Released once.
+*********************************************************************/
+static void
+bst_ovsdb_monitor_init_done (void)
+{
+  if (bst_ovsdb_monitor_state.initDone ||
+      !bst_ovsdb_monitor_state.bufmonSynced ||
+      !bst_ovsdb_monitor_state.configSynced ||
+      (strlen (system_table_uuid) == 0))
+  {
+    return;
+  }
+  if (sem_post(&monitor_init_done_sem) != 0)
   {
     SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-               "OVSDB BST monitor:Failed to send 'monitor bufmon table' to ovsdb-server %s",
-                connectMode);
+       "OVSDB BST monitor: Failed to release semaphore");
     return;
   }
+  bst_ovsdb_monitor_state.initDone = true;
+}
 
-  for (;;)
+/*********************************************************************
+* @brief    Have the bufmon monitor follow a new tracking mask.
+*
+* @param[in]    trackingMask  - realms tracked.
+*
+* @notes    Called by the committing thread, the monitor thread
+*           changes the condition.
+*********************************************************************/
+static void
+bst_ovsdb_monitor_track (int trackingMask)
+{
+  __atomic_store_n (&bst_ovsdb_monitor_state.wantMask, trackingMask,
+                    __ATOMIC_RELAXED);
+  if (__atomic_load_n (&bst_ovsdb_monitor_state.wakeReady, __ATOMIC_ACQUIRE))
+  {
+    latch_set (&bst_ovsdb_monitor_state.wake);
+  }
+}
+
+/*********************************************************************
+* @brief    Drop from the cache the bufmon rows the resync did not
+*           bring back.
+*
+* @notes    The rows were deleted, or left the monitor condition,
+*           while the session was down. They go out as deletes.
+*           Monitor thread only.
+*********************************************************************/
+static void
+bst_ovsdb_monitor_unseen_delete (void)
+{
+  BVIEW_OVSDB_ROW_UPDATE_t *p_update;
+  BVIEW_OVSDB_ROW_REF_t     ref;
+  char                      uuid[BVIEW_OVSDB_ROW_UUID_SIZE + 1];
+  unsigned int              cursor = 0;
+
+  while (BVIEW_STATUS_SUCCESS ==
+            bst_ovsdb_row_ref_unseen_get (&cursor, uuid, &ref))
   {
-    while (1) 
+    /* no flush in the walk, it changes the row index */
+    if (BVIEW_STATUS_SUCCESS != bst_ovsdb_row_staging_reserve ())
+    {
+      SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+          "OVSDB BST monitor: Failed to grow the row staging list");
+      break;
+    }
+    p_update = &bst_ovsdb_row_staging.rows[bst_ovsdb_row_staging.count];
+    memset (p_update, 0, sizeof (*p_update));
+    p_update->ref = ref;
+    bst_ovsdb_row_cached_get (&ref, &p_update->row);
+    p_update->row.enabled = false;
+    p_update->row.triggered = false;
+    p_update->deleted = true;
+    strncpy (p_update->uuid, uuid, sizeof (p_update->uuid) - 1);
+    bst_ovsdb_row_staging.count++;
+  }
+  bst_ovsdb_row_staging_flush (0);
+}
+
+/*********************************************************************
+* @brief    Apply the reply of the bufmon monitor request.
+*
+* @param[in]    result    - result of the reply.
+*
+* @notes    The reply of monitor_cond_since is [found, last
+*           transaction, updates], the updates being the changes since
+*           the last transaction if found. Otherwise the reply holds
+*           all the rows, and the cached rows it does not hold are
+*           gone. The cache is in sync from there.
+*********************************************************************/
+static void
+bst_ovsdb_monitor_bufmon_synced (struct json *result)
+{
+  struct json *updates = result;
+  struct json *txn;
+  bool         full = true;
+
+  if (BST_OVSDB_MONITOR_COND_SINCE == bst_ovsdb_monitor_state.method)
+  {
+    if ((result->type != JSON_ARRAY) || (result->u.array.n != 3))
+    {
+      SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+             "OVSDB BST monitor: Invalid monitor_cond_since reply");
+      return;
+    }
+    full = (result->u.array.elems[0]->type != JSON_TRUE);
+    txn = result->u.array.elems[1];
+    if (txn->type == JSON_STRING)
+    {
+      strncpy (bst_ovsdb_monitor_state.lastTxnId, txn->u.string,
+               sizeof (bst_ovsdb_monitor_state.lastTxnId) - 1);
+    }
+    updates = result->u.array.elems[2];
+  }
+
+  if (full)
+  {
+    bst_ovsdb_row_refs_unmark ();
+  }
+  bst_ovsdb_cache_update (updates,
+              (BST_OVSDB_MONITOR_PLAIN != bst_ovsdb_monitor_state.method));
+  if (full)
+  {
+    bst_ovsdb_monitor_unseen_delete ();
+  }
+
+  bst_ovsdb_cache_stale_set (false);
+  bst_ovsdb_monitor_state.bufmonSynced = true;
+  bst_ovsdb_monitor_state.backoff = OVSDB_CLIENT_RECONNECT_MIN_MSEC;
+}
+
+/*********************************************************************
+* @brief    Wait before the next session open.
+*
+* @notes    The wait doubles up to OVSDB_CLIENT_RECONNECT_MAX_MSEC,
+*           and is back to its minimum once a session is in sync.
+*********************************************************************/
+static void
+bst_ovsdb_monitor_backoff (void)
+{
+  long long int backoff = bst_ovsdb_monitor_state.backoff;
+
+  bst_ovsdb_monitor_state.reconnectAt = time_msec () + backoff;
+  bst_ovsdb_monitor_state.backoff =
+      ((backoff * 2) < OVSDB_CLIENT_RECONNECT_MAX_MSEC) ?
+       (backoff * 2) : OVSDB_CLIENT_RECONNECT_MAX_MSEC;
+}
+
+/*********************************************************************
+* @brief    Drop the session.
+*
+* @param[in,out] rpc      -  JSON RPC session.
+*
+* @notes    The cache keeps its values, marked stale, until the next
+*           session is in sync.
+*********************************************************************/
+static void
+bst_ovsdb_monitor_disconnect (struct jsonrpc **rpc)
+{
+  jsonrpc_close (*rpc);
+  *rpc = NULL;
+
+  json_destroy (bst_ovsdb_monitor_state.systemId);
+  json_destroy (bst_ovsdb_monitor_state.bufmonId);
+  bst_ovsdb_monitor_state.systemId = NULL;
+  bst_ovsdb_monitor_state.bufmonId = NULL;
+  if (NULL != bst_ovsdb_monitor_state.changeId)
+  {
+    /* the condition the server has is not known, start over */
+    json_destroy (bst_ovsdb_monitor_state.changeId);
+    bst_ovsdb_monitor_state.changeId = NULL;
+    strncpy (bst_ovsdb_monitor_state.lastTxnId, BST_OVSDB_MONITOR_TXN_NONE,
+             sizeof (bst_ovsdb_monitor_state.lastTxnId) - 1);
+  }
+  bst_ovsdb_monitor_state.bufmonSynced = false;
+  bst_ovsdb_cache_stale_set (true);
+
+  SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+        "OVSDB BST monitor: session lost, resync in %lld msec",
+        bst_ovsdb_monitor_state.backoff);
+  bst_ovsdb_monitor_backoff ();
+}
+
+/*********************************************************************
+* @brief    Open a session and send the monitor requests.
+*
+* @retval   the session, NULL if it could not be opened
+*********************************************************************/
+static struct jsonrpc *
+bst_ovsdb_monitor_connect (void)
+{
+  char connectMode[OVSDB_CONFIG_MAX_LINE_LENGTH];
+  struct jsonrpc_msg *request;
+  struct jsonrpc *rpc;
+
+  memset (&connectMode[0], 0, OVSDB_CONFIG_MAX_LINE_LENGTH);
+  strncpy (connectMode, sbplugin_ovsdb_sock_path_get (),
+           OVSDB_CONFIG_MAX_LINE_LENGTH - 1);
+  rpc = open_jsonrpc (connectMode);
+  if (!rpc)
+  {
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+               "OVSDB BST monitor:Failed to open JSON RPC session %s, retry in %lld msec",
+                connectMode, bst_ovsdb_monitor_state.backoff);
+    bst_ovsdb_monitor_backoff ();
+    return NULL;
+  }
+
+  /* Send monitor requests to the ovsdb server*/
+  request = jsonrpc_create_request ("monitor",
+                        json_from_string (BST_JSON_MONITOR_SYSTEM), NULL);
+  bst_ovsdb_monitor_state.systemId = json_clone (request->id);
+  if (jsonrpc_send (rpc, request))
+  {
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+               "OVSDB BST monitor:Failed to send 'monitor System table' to ovsdb-server %s",
+                connectMode);
+    bst_ovsdb_monitor_disconnect (&rpc);
+    return NULL;
+  }
+  if (BVIEW_STATUS_SUCCESS !=
+         bst_ovsdb_monitor_bufmon_send (rpc, &bst_ovsdb_monitor_state.bufmonId))
+  {
+    bst_ovsdb_monitor_disconnect (&rpc);
+    return NULL;
+  }
+  return rpc;
+}
+
+/*********************************************************************
+* @brief    Read what the ovsdb-server has sent.
+*
+* @param[in,out] rpc      -  JSON RPC session, NULL once dropped.
+*
+*********************************************************************/
+static void
+bst_ovsdb_monitor_receive (struct jsonrpc **rpc)
+{
+  struct jsonrpc_msg *msg;
+  struct json *params;
+  bool lost;
+  int error;
+
+  while (*rpc)
+  {
+    error = jsonrpc_recv (*rpc, &msg);
+    if (EAGAIN == error)
+    {
+      break;
+    }
+    if (error)
+    {
+      bst_ovsdb_monitor_disconnect (rpc);
+      break;
+    }
+    lost = false;
+
+    if (msg->type == JSONRPC_REQUEST && !strcmp (msg->method, "echo"))
+    {
+      /* keep-alive of the ovsdb-server */
+      jsonrpc_send (*rpc, jsonrpc_create_reply (json_clone (msg->params),
+                                                msg->id));
+    }
+       /* Initial entries notified by ovsdb-server server through
+        * Message type "Reply"
+        */
+    else if (msg->type == JSONRPC_REPLY &&
+             json_equal (msg->id, bst_ovsdb_monitor_state.systemId))
+    {
+      bst_ovsdb_cache_update (msg->result, false);
+    }
+    else if (msg->type == JSONRPC_REPLY &&
+             json_equal (msg->id, bst_ovsdb_monitor_state.bufmonId))
     {
-      error = jsonrpc_recv(rpc, &msg);
-      if (error)
+      bst_ovsdb_monitor_bufmon_synced (msg->result);
+    }
+    else if (msg->type == JSONRPC_REPLY &&
+             json_equal (msg->id, bst_ovsdb_monitor_state.changeId))
+    {
+      json_destroy (bst_ovsdb_monitor_state.changeId);
+      bst_ovsdb_monitor_state.changeId = NULL;
+    }
+    else if (msg->type == JSONRPC_ERROR &&
+             json_equal (msg->id, bst_ovsdb_monitor_state.bufmonId) &&
+             (BST_OVSDB_MONITOR_PLAIN != bst_ovsdb_monitor_state.method))
+    {
+      /* Method not in the server, fall back to the next one */
+      SB_OVSDB_LOG (BVIEW_LOG_INFO,
+             "OVSDB BST monitor: %s not supported",
+             (BST_OVSDB_MONITOR_COND_SINCE == bst_ovsdb_monitor_state.method) ?
+             "monitor_cond_since" : "monitor_cond, monitoring all bufmon rows");
+      json_destroy (bst_ovsdb_monitor_state.bufmonId);
+      bst_ovsdb_monitor_state.bufmonId = NULL;
+      bst_ovsdb_monitor_state.method++;
+      if (BVIEW_STATUS_SUCCESS !=
+            bst_ovsdb_monitor_bufmon_send (*rpc, &bst_ovsdb_monitor_state.bufmonId))
       {
-        break;
+        lost = true;
       }
-         /* Initial entries notified by ovsdb-server server through 
-          * Message type "Reply"
-          */
-      if (msg->type == JSONRPC_REPLY &&
-         (json_equal(msg->id, request_id)))
+    }
+       /* Row/Column Modify (s) are notfied by ovsdb-server through
+        * Message type "Update", "Update2" for monitor_cond and
+        * "Update3" for monitor_cond_since
+        */
+    else if (msg->type == JSONRPC_NOTIFY &&
+             (!strcmp (msg->method, "update") ||
+              !strcmp (msg->method, "update2")))
+    {
+      params = msg->params;
+      if (params->type == JSON_ARRAY
+       && params->u.array.n == 2)
       {
-        bst_ovsdb_cache_update (msg->result, true);
+            /* extract data and update plugin cache*/
+        bst_ovsdb_cache_update (params->u.array.elems[1],
+                                !strcmp (msg->method, "update2"));
       }
-         /* Row/Column Modify (s) are notfied by ovsdb-server through 
-          * Message type "Update
-          */
-      else if (msg->type == JSONRPC_NOTIFY &&
-               !strcmp(msg->method, "update")) 
+    }
+    else if (msg->type == JSONRPC_NOTIFY && !strcmp (msg->method, "update3"))
+    {
+      params = msg->params;
+      if (params->type == JSON_ARRAY
+       && params->u.array.n == 3
+       && params->u.array.elems[1]->type == JSON_STRING)
       {
-        params = msg->params;
-        if (params->type == JSON_ARRAY
-         && params->u.array.n == 2
-         && params->u.array.elems[0]->type == JSON_NULL) 
-        {
-              /* extract data and update plugin cache*/
-          bst_ovsdb_cache_update (params->u.array.elems[1], false);                 
-        }
+        strncpy (bst_ovsdb_monitor_state.lastTxnId,
+                 params->u.array.elems[1]->u.string,
+                 sizeof (bst_ovsdb_monitor_state.lastTxnId) - 1);
+        bst_ovsdb_cache_update (params->u.array.elems[2], true);
       }
-      jsonrpc_msg_destroy(msg);
     }
-    jsonrpc_run(rpc);
-    jsonrpc_wait(rpc);
-    jsonrpc_recv_wait(rpc);
-    poll_block();
+    else if (msg->type == JSONRPC_ERROR)
+    {
+      SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+             "OVSDB BST monitor: request failed");
+    }
+    jsonrpc_msg_destroy (msg);
+    bst_ovsdb_monitor_init_done ();
+
+    if (lost)
+    {
+      bst_ovsdb_monitor_disconnect (rpc);
+    }
+  }
+}
+
+/*********************************************************************
+* @brief   BST OVSDB monitor thread
+*
+*
+*
+* @notes   Receive JSON notification from OVSDB-SERVER and Update the
+*          SB PLUGIN cache.
+*
+*          The System columns are monitored with the v1 protocol. The
+*          bufmon table is monitored with monitor_cond_since or
+*          monitor_cond, for the rows of the tracked realms and the
+*          dynamic columns, or with the v1 protocol and the same
+*          columns if the server has neither.
+*
+*          A lost session is opened again with a backoff. Meanwhile
+*          the cache keeps the last values read and the snapshots are
+*          reported stale. monitor_cond_since resumes from the last
+*          transaction seen, the other methods resync from all rows.
+*
+*********************************************************************/
+void
+bst_ovsdb_monitor()
+{
+  struct jsonrpc *rpc = NULL;
+
+  strncpy (bst_ovsdb_monitor_state.lastTxnId, BST_OVSDB_MONITOR_TXN_NONE,
+           sizeof (bst_ovsdb_monitor_state.lastTxnId) - 1);
+  bst_ovsdb_monitor_state.backoff = OVSDB_CLIENT_RECONNECT_MIN_MSEC;
+  bst_ovsdb_monitor_state.reconnectAt = 0;
+  latch_init (&bst_ovsdb_monitor_state.wake);
+  __atomic_store_n (&bst_ovsdb_monitor_state.wakeReady, true, __ATOMIC_RELEASE);
+
+  for (;;)
+  {
+    latch_poll (&bst_ovsdb_monitor_state.wake);
+
+    if ((NULL == rpc) && (time_msec () >= bst_ovsdb_monitor_state.reconnectAt))
+    {
+      rpc = bst_ovsdb_monitor_connect ();
+    }
+
+    bst_ovsdb_monitor_receive (&rpc);
+
+    if (rpc)
+    {
+      /* Follow the tracking mask */
+      if ((BST_OVSDB_MONITOR_PLAIN != bst_ovsdb_monitor_state.method) &&
+          bst_ovsdb_monitor_state.bufmonSynced)
+      {
+        bst_ovsdb_monitor_where_change (rpc);
+      }
+      jsonrpc_run (rpc);
+      if (0 != jsonrpc_get_status (rpc))
+      {
+        bst_ovsdb_monitor_disconnect (&rpc);
+        continue;
+      }
+      jsonrpc_wait (rpc);
+      jsonrpc_recv_wait (rpc);
+    }
+    else
+    {
+      poll_timer_wait_until (bst_ovsdb_monitor_state.reconnectAt);
+    }
+    latch_wait (&bst_ovsdb_monitor_state.wake);
+    poll_block ();
   }
 }
 
-int count  = 0;
 /*********************************************************************
 * @brief       Commit column "trigger_threshold" in table "bufmon" to 
 *              OVSDB database.
@@ -626,27 +1312,17 @@ int count  = 0;
 * @param[in]   bid              -  Stat ID
 * @param[in]   threshold      -  Threshold.
 *
-* @notes       
-*          
+* @notes       The update joins the pending OVSDB transaction, which
+*              goes out with the next ones, see ovsdb_txn.h.
 *
 *
 *********************************************************************/
 BVIEW_STATUS bst_ovsdb_threshold_commit (int asic , int port, int index,
                                          int bid, uint64_t threshold)
 {
-  char   s_transact[1024] = {0};
   char   s_key[1024]       = {0};
-  struct json *transaction;
-  struct jsonrpc_msg *request;
-  char connectMode[OVSDB_CONFIG_MAX_LINE_LENGTH]; 
-  static struct jsonrpc *rpc = NULL;
   BVIEW_STATUS   rv = BVIEW_STATUS_SUCCESS;
-  int error = 0;
-  const char *sock_path;
-  if (0 == count)
-  {
-    rpc = NULL;
-  }
+
   /* Get Row name */
   rv = bst_bid_port_index_to_ovsdb_key (asic, bid, port, index, 
                                         s_key, sizeof(s_key));
@@ -657,31 +1333,14 @@ BVIEW_STATUS bst_ovsdb_threshold_commit (int asic , int port, int index,
                          asic, bid, port, index, "threshold");
     return BVIEW_STATUS_FAILURE;
   }
-  /* Create JSON Request*/
-  sprintf (s_transact, BST_OVSDB_THRESHOLD_JSON ,(unsigned long long int) threshold, s_key);
-
-  transaction = json_from_string(s_transact);
-  request = jsonrpc_create_request("transact", transaction, NULL);
-  if (count == 0)
-  { 
-    memset (&connectMode[0], 0, OVSDB_CONFIG_MAX_LINE_LENGTH);
-    sock_path = sbplugin_ovsdb_sock_path_get();
-    strncpy(connectMode, sock_path, OVSDB_CONFIG_MAX_LINE_LENGTH-1);
-    rpc = open_jsonrpc (connectMode);
-    if (rpc == NULL)
-    { 
-      SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-                 "Trigger_threshold commit:Failed to open JSNON RPC session");
-      return BVIEW_STATUS_FAILURE;
-    }
-    count++;
-  }
-  error = jsonrpc_send (rpc, request);
-  if (error)
+  /* Add the update to the pending transaction */
+  rv = ovsdb_txn_op_add (BST_OVSDB_THRESHOLD_OP,
+                         (unsigned long long int) threshold, s_key);
+  if (rv != BVIEW_STATUS_SUCCESS)
   {
-   SB_OVSDB_LOG (BVIEW_LOG_ERROR,"\r\n Failed set threshold\r\n");
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR,"\r\n Failed set threshold\r\n");
   }
-  return BVIEW_STATUS_SUCCESS;
+  return rv;
 }
 
 /*********************************************************************
@@ -692,56 +1351,40 @@ BVIEW_STATUS bst_ovsdb_threshold_commit (int asic , int port, int index,
 *
 * @retval      
 * 
-* @notes    
-*          
+* @notes    Sent with the pending OVSDB transaction, and waits for
+*           the reply.
 *
 *
 *********************************************************************/
 BVIEW_STATUS bst_ovsdb_bst_config_commit (int asic , 
                                           BVIEW_OVSDB_CONFIG_DATA_t *config)
 {
-  char   s_transact[1024] = {0};
   char   buf[16]          = {0};
   char   buf1[16]          = {0};
-  struct json *transaction;
-  struct jsonrpc_msg *request, *reply;
-  struct jsonrpc *rpc;
-  char connectMode[OVSDB_CONFIG_MAX_LINE_LENGTH];
-  const char *sock_path;
+  BVIEW_STATUS   rv = BVIEW_STATUS_SUCCESS;
  
   /* NULL Pointer validation */
   SB_OVSDB_NULLPTR_CHECK (config, BVIEW_STATUS_INVALID_PARAMETER);
 
   sprintf (buf, "%d",config->collection_interval);
   sprintf (buf1, "%d",config->bstMaxTriggers);
-  /* Create JSON request*/
-  BVIEW_OVSDB_FORM_CONFIG_JSON (s_transact, BST_OVSDB_CONFIG_JSON_FORMAT,
-                              (config->bst_enable ? "true":"false"),
-                              ((config->bst_tracking_mode == BVIEW_BST_MODE_PEAK) ? "peak":"current"),
-                              (config->periodic_collection ? "true":"false"),
-                              (config->sendSnapshotOnTrigger ? "true":"false"),
-                              buf,
-                              buf1 ,
-                              (config->triggerCollectionEnabled ? "true":"false"),
-                              system_table_uuid);
-
-  transaction = json_from_string(s_transact);
-  request = jsonrpc_create_request("transact", transaction, NULL);
-  memset (&connectMode[0], 0, OVSDB_CONFIG_MAX_LINE_LENGTH);
-  sock_path = sbplugin_ovsdb_sock_path_get();
-  strncpy(connectMode, sock_path, OVSDB_CONFIG_MAX_LINE_LENGTH-1);
-
-  rpc = open_jsonrpc (connectMode);
-  if (rpc == NULL)
-  { 
+  /* Add the update to the pending transaction */
+  rv = ovsdb_txn_op_add (BST_OVSDB_CONFIG_OP_FORMAT,
+                         (config->bst_enable ? "true":"false"),
+                         ((config->bst_tracking_mode == BVIEW_BST_MODE_PEAK) ? "peak":"current"),
+                         (config->periodic_collection ? "true":"false"),
+                         (config->sendSnapshotOnTrigger ? "true":"false"),
+                         buf,
+                         buf1 ,
+                         (config->triggerCollectionEnabled ? "true":"false"),
+                         system_table_uuid);
+  if (rv != BVIEW_STATUS_SUCCESS)
+  {
     SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-                 "System config commit:Failed to open JSNON RPC session");
-    return BVIEW_STATUS_FAILURE;
+                 "System config commit:Failed to queue the update");
+    return rv;
   }
-  check_txn(jsonrpc_transact_block(rpc, request, &reply),&reply);
-  jsonrpc_msg_destroy(reply);
-  jsonrpc_close(rpc);
-  return BVIEW_STATUS_SUCCESS;
+  return ovsdb_txn_commit (true);
 }
 
 
@@ -753,73 +1396,46 @@ BVIEW_STATUS bst_ovsdb_bst_config_commit (int asic ,
 *
 * @retval
 *
-* @notes
-*
+* @notes    The updates of all the realms go in one transaction,
+*           which is sent without waiting for the reply.
 *
 *
 *********************************************************************/
 BVIEW_STATUS bst_ovsdb_bst_tracking_commit (int asic ,
                                           BVIEW_OVSDB_CONFIG_DATA_t *config)
 {
-  char   s_transact[1024] = {0};
-  struct json *transaction;
-  struct jsonrpc_msg *request;
-  struct jsonrpc *rpc;
-  char connectMode[OVSDB_CONFIG_MAX_LINE_LENGTH];
   int realmId;
-  char  realmName[BST_OVSDB_REALM_SIZE];
-  const char *sock_path;
+  const char *realmName;
+  BVIEW_STATUS   rv = BVIEW_STATUS_SUCCESS;
 
   /* NULL Pointer validation */
   SB_OVSDB_NULLPTR_CHECK (config, BVIEW_STATUS_INVALID_PARAMETER);
 
-  memset (&connectMode[0], 0, OVSDB_CONFIG_MAX_LINE_LENGTH);
-  sock_path = sbplugin_ovsdb_sock_path_get();
-  strncpy(connectMode, sock_path, OVSDB_CONFIG_MAX_LINE_LENGTH-1);
-
-  rpc = open_jsonrpc (connectMode);
-  if (rpc == NULL)
-  {
-    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-                 "System config commit:Failed to open JSNON RPC session");
-    return BVIEW_STATUS_FAILURE;
-  }
   for (realmId = BVIEW_BST_REALM_ID_MIN;
        realmId < BVIEW_BST_REALM_ID_MAX;realmId++)
   {
+    realmName = bst_registry_realm_name_get (realmId);
     if(config->trackingMask & (1 <<realmId))
     {
-      bst_ovsdb_realm_name_get (realmId, realmName);
-      sprintf (s_transact, BST_JSON_TRACKING_FORMAT_ENABLE, realmName);
-      transaction = json_from_string(s_transact);
-      request = jsonrpc_create_request("transact", transaction, NULL);
-      jsonrpc_send (rpc, request);
+      rv = ovsdb_txn_op_add (BST_JSON_TRACKING_OP_ENABLE, realmName);
     }
     else
     {
-      bst_ovsdb_realm_name_get (realmId, realmName);
-      sprintf (s_transact, BST_JSON_TRACKING_FORMAT_DISABLE, realmName);
-      transaction = json_from_string(s_transact);
-      request = jsonrpc_create_request("transact", transaction, NULL);
-      jsonrpc_send (rpc, request);
+      rv = ovsdb_txn_op_add (BST_JSON_TRACKING_OP_DISABLE, realmName);
+    }
+    if (rv != BVIEW_STATUS_SUCCESS)
+    {
+      SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+                   "Tracking commit:Failed to queue the update of realm %s",
+                   realmName);
+      return rv;
     }
-  }
-  if (config->trackingMask & (1 << (BVIEW_BST_REALM_ID_MAX-1)))
-  {
-    bst_ovsdb_realm_name_get ((BVIEW_BST_REALM_ID_MAX-1), realmName);
-    sprintf (s_transact, BST_JSON_TRACKING_FORMAT_ENABLE, realmName);
-  }
-  else
-  {
-    bst_ovsdb_realm_name_get ((BVIEW_BST_REALM_ID_MAX-1), realmName);
-    sprintf (s_transact, BST_JSON_TRACKING_FORMAT_DISABLE, realmName);
   }
 
-  transaction = json_from_string(s_transact);
-  request = jsonrpc_create_request("transact", transaction, NULL);
-  jsonrpc_send_block (rpc, request);
+  /* rows of the tracked realms only are monitored */
+  bst_ovsdb_monitor_track (config->trackingMask);
 
-  return BVIEW_STATUS_SUCCESS;
+  return ovsdb_txn_commit (false);
 }
 
 
@@ -829,40 +1445,24 @@ BVIEW_STATUS bst_ovsdb_bst_tracking_commit (int asic ,
 *
 * @param[in]   asic             -  ASIC ID
 *
-* @notes
-*
+* @notes       Sent with the pending OVSDB transaction, and waits for
+*              the reply.
 *
 *
 *********************************************************************/
 BVIEW_STATUS bst_ovsdb_clear_thresholds_commit (int asic)
 {
-  char   s_transact[1024] = {0};
-  struct json *transaction;
-  struct jsonrpc_msg *request, *reply;
-  struct jsonrpc *rpc;
-  char connectMode[OVSDB_CONFIG_MAX_LINE_LENGTH];
-  const char *sock_path;
-
-   /* Create JSON Request*/
-  sprintf (s_transact, BST_OVSDB_CLEAR_THRESHOLDS_JSON ,asic);
-
-  transaction = json_from_string(s_transact);
-  request = jsonrpc_create_request("transact", transaction, NULL);
-  memset (&connectMode[0], 0, OVSDB_CONFIG_MAX_LINE_LENGTH);
-  sock_path = sbplugin_ovsdb_sock_path_get();
-  strncpy(connectMode, sock_path, OVSDB_CONFIG_MAX_LINE_LENGTH-1);
+  BVIEW_STATUS   rv = BVIEW_STATUS_SUCCESS;
 
-  rpc = open_jsonrpc (connectMode);
-  if (rpc == NULL)
+  /* Add the update to the pending transaction */
+  rv = ovsdb_txn_op_add (BST_OVSDB_CLEAR_THRESHOLDS_OP, asic);
+  if (rv != BVIEW_STATUS_SUCCESS)
   {
     SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-                 "clear thresholds commit:Failed to open JSNON RPC session");
-    return BVIEW_STATUS_FAILURE;
+                 "clear thresholds commit:Failed to queue the update");
+    return rv;
   }
-  check_txn(jsonrpc_transact_block(rpc, request, &reply),&reply);
-  jsonrpc_msg_destroy(reply);
-  jsonrpc_close(rpc);
-  return BVIEW_STATUS_SUCCESS;
+  return ovsdb_txn_commit (true);
 }
 
 
@@ -872,39 +1472,23 @@ BVIEW_STATUS bst_ovsdb_clear_thresholds_commit (int asic)
 *
 * @param[in]   asic             -  ASIC ID
 *
-* @notes       Set all Stats to Zero
-*
+* @notes       Set all Stats to Zero. Sent with the pending OVSDB
+*              transaction, and waits for the reply.
 *
 *
 *********************************************************************/
 BVIEW_STATUS bst_ovsdb_clear_stats_commit (int asic)
 {
-  char   s_transact[1024] = {0};
-  struct json *transaction;
-  struct jsonrpc_msg *request, *reply;
-  struct jsonrpc *rpc;
-  char connectMode[OVSDB_CONFIG_MAX_LINE_LENGTH];
-  const char *sock_path;
-
-   /* Create JSON Request*/
-  sprintf (s_transact, BST_OVSDB_CLEAR_STATS_JSON ,asic);
-
-  transaction = json_from_string(s_transact);
-  request = jsonrpc_create_request("transact", transaction, NULL);
-  memset (&connectMode[0], 0, OVSDB_CONFIG_MAX_LINE_LENGTH);
-  sock_path = sbplugin_ovsdb_sock_path_get();
-  strncpy(connectMode, sock_path, OVSDB_CONFIG_MAX_LINE_LENGTH-1);
+  BVIEW_STATUS   rv = BVIEW_STATUS_SUCCESS;
 
-  rpc = open_jsonrpc (connectMode);
-  if (rpc == NULL)
+  /* Add the update to the pending transaction */
+  rv = ovsdb_txn_op_add (BST_OVSDB_CLEAR_STATS_OP, asic);
+  if (rv != BVIEW_STATUS_SUCCESS)
   {
     SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-                 "Clear stats commit:Failed to open JSNON RPC session");
-    return BVIEW_STATUS_FAILURE;
+                 "Clear stats commit:Failed to queue the update");
+    return rv;
   }
-  check_txn(jsonrpc_transact_block(rpc, request, &reply),&reply);
-  jsonrpc_msg_destroy(reply);
-  jsonrpc_close(rpc);
-  return BVIEW_STATUS_SUCCESS;
+  return ovsdb_txn_commit (true);
 }
 
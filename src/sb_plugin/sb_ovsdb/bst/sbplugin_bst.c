@@ -24,6 +24,7 @@
 #include <errno.h>
 #include <signal.h>
 #include <pthread.h>
+#include <stddef.h>
 #include "common/platform_spec.h"
 #include "bst.h"
 #include "sbfeature_bst.h"
@@ -32,6 +33,10 @@
 #include "sbplugin_bst_map.h"
 #include "sbplugin_bst_ovsdb.h"
 #include "ovsdb_bst_ctl.h"
+#include "ovsdb_txn.h"
+
+/* BST BID table parameters */
+extern BVIEW_BST_OVSDB_BID_PARAMS_t  bid_tab_params[SB_OVSDB_BST_STAT_ID_MAX_COUNT];
 
 /* Ovsdb Monitor init time out value */
 #define SB_OVSDB_MONITOR_INIT_TIME_OUT    40   /* Seconds */
@@ -97,6 +102,23 @@
                 } \
               }
 
+/* Add a snapshot field, read from the stat of a BID, to a snapshot map */
+#define BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD(_map, _count, _run, _field, _bid, _index) \
+              sbplugin_ovsdb_bst_snapshot_map_add ((_map), (_count), (_run), \
+                  offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, _field) / sizeof (uint64_t), \
+                  BVIEW_OVSDB_BID_BASE_INDEX (_bid) + (_index))
+
+/* Snapshot map of an ASIC */
+typedef struct _bst_ovsdb_snapshot_map_info_
+{
+  bool                         ready;
+  int                          count;
+  BVIEW_OVSDB_SNAPSHOT_MAP_t  *map;
+} BVIEW_OVSDB_BST_SNAPSHOT_MAP_INFO_t;
+
+static BVIEW_OVSDB_BST_SNAPSHOT_MAP_INFO_t bstSnapshotMap[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+static pthread_mutex_t bstSnapshotMapLock = PTHREAD_MUTEX_INITIALIZER;
+
 sem_t monitor_init_done_sem;
 
 pthread_t ovsdb_client_thread;
@@ -208,6 +230,13 @@ BVIEW_STATUS sbplugin_ovsdb_bst_infra_init()
     return rv;
   }
 
+  /* Start the committer of the OVSDB transactions */
+  if ((rv = ovsdb_txn_init()) != BVIEW_STATUS_SUCCESS)
+  {
+    SB_OVSDB_DEBUG_PRINT ("Failed to start OVSDB transaction committer");
+    return rv;
+  }
+
 
 
   return rv;
@@ -334,105 +363,330 @@ BVIEW_STATUS sbplugin_ovsdb_bst_config_get (int asic,
  return  BVIEW_STATUS_SUCCESS;
 }
 /*********************************************************************
-* @brief  Obtain Complete ASIC Statistics Report
+* @brief  Add a snapshot field to a snapshot map
+*
+* @param[out]     map                - the map, NULL to count its runs
+* @param[in,out]  count              - number of runs ended so far
+* @param[in,out]  run                - run being built
+* @param[in]      dst                - the field, in 64 bit words
+* @param[in]      src                - its stat, a counter of the cache
+*
+* @notes    The field extends the run if it follows it both in the
+*           snapshot and in the cache, or it ends the run and starts
+*           a new one.
+*
+*
+*********************************************************************/
+static void sbplugin_ovsdb_bst_snapshot_map_add (BVIEW_OVSDB_SNAPSHOT_MAP_t *map,
+                                 int *count,
+                                 BVIEW_OVSDB_SNAPSHOT_MAP_t *run,
+                                 unsigned int dst, unsigned int src)
+{
+  if ((0 != run->count) && (src == run->src + run->count))
+  {
+    if ((1 == run->count) && (dst > run->dst))
+    {
+      run->stride = dst - run->dst;
+      run->count++;
+      return;
+    }
+    if (dst == run->dst + run->count * run->stride)
+    {
+      run->count++;
+      return;
+    }
+  }
+
+  if (0 != run->count)
+  {
+    if (NULL != map)
+    {
+      map[*count] = *run;
+    }
+    (*count)++;
+  }
+  run->dst = dst;
+  run->stride = 1;
+  run->src = src;
+  run->count = 1;
+}
+
+/*********************************************************************
+* @brief  Build the snapshot map of an ASIC
 *
 * @param[in]      asic               - unit
-* @param[out]     snapshot           - snapshot data structure
-* @param[out]     time               - time
+* @param[out]     map                - runs of snapshot fields and their
+*                                      stats, NULL to count them
+* @param[out]     count              - number of runs
 *
-* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
-* @retval BVIEW_STATUS_FAILURE           if snapshot get is failed.
-* @retval BVIEW_STATUS_SUCCESS           if snapshot get is success.
+* @retval BVIEW_STATUS_FAILURE           if an index does not resolve.
+* @retval BVIEW_STATUS_SUCCESS           if the map is built.
 *
-* @notes    none
+* @notes    Same fields as the per realm getters below. A field at a
+*           time, so that the fields of a realm make long runs.
 *
 *
 *********************************************************************/
-BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_get (int asic,
-                                 BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
-                                 BVIEW_TIME_t *time)
+static BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_map_build (int asic,
+                                 BVIEW_OVSDB_SNAPSHOT_MAP_t *map,
+                                 int *count)
 {
-  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+  BVIEW_OVSDB_SNAPSHOT_MAP_t  run;
+  unsigned int                port = 0;
+  unsigned int                index = 0;
+  int                         db_index = 0;
 
-  /* Check validity of input data*/
-  BVIEW_BST_INPUT_VALIDATE (asic, snapshot, time);
+  memset (&run, 0, sizeof (run));
+  *count = 0;
+
+  /* Device Statistics */
+  BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run, device.bufferCount,
+                                    SB_OVSDB_BST_STAT_ID_DEVICE, 0);
 
-  /* Obtain Device Statistics */
-  rv = sbplugin_ovsdb_bst_device_data_get (asic, &snapshot->device, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  /* Ingress Port + Priority Groups Statistics */
+  BVIEW_BST_PORT_ITER (asic, port)
   {
-    return BVIEW_STATUS_FAILURE;
+    BVIEW_BST_PG_ITER (asic, index)
+    {
+      BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_PRI_GROUP_SHARED,
+                                    port, index, &db_index);
+      BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+            iPortPg.data[port - 1][index].umShareBufferCount,
+            SB_OVSDB_BST_STAT_ID_PRI_GROUP_SHARED, db_index);
+    }
+  }
+  BVIEW_BST_PORT_ITER (asic, port)
+  {
+    BVIEW_BST_PG_ITER (asic, index)
+    {
+      BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_PRI_GROUP_HEADROOM,
+                                    port, index, &db_index);
+      BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+            iPortPg.data[port - 1][index].umHeadroomBufferCount,
+            SB_OVSDB_BST_STAT_ID_PRI_GROUP_HEADROOM, db_index);
+    }
   }
 
-  /* Obtain Ingress Port + Priority Groups Statistics */
-  rv = sbplugin_ovsdb_bst_ippg_data_get (asic, &snapshot->iPortPg, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  /* Ingress Port + Service Pools Statistics */
+  BVIEW_BST_PORT_ITER (asic, port)
   {
-    return BVIEW_STATUS_FAILURE;
+    BVIEW_BST_SP_ITER (asic, index)
+    {
+      BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_PORT_POOL,
+                                    port, index, &db_index);
+      BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+            iPortSp.data[port - 1][index].umShareBufferCount,
+            SB_OVSDB_BST_STAT_ID_PORT_POOL, db_index);
+    }
   }
-  /* Obtain Ingress Port + Service Pools Statistics */
-  rv = sbplugin_ovsdb_bst_ipsp_data_get (asic, &snapshot->iPortSp, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+
+  /* Ingress Service Pools Statistics */
+  BVIEW_BST_SP_ITER (asic, index)
   {
-    return BVIEW_STATUS_FAILURE;
+    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_ING_POOL,
+                                  0, index, &db_index);
+    BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+          iSp.data[index].umShareBufferCount,
+          SB_OVSDB_BST_STAT_ID_ING_POOL, db_index);
   }
 
-  /* Obtain Ingress Service Pools Statistics */
-  rv = sbplugin_ovsdb_bst_isp_data_get (asic, &snapshot->iSp,time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  /* Egress Port + Service Pools Statistics */
+  BVIEW_BST_PORT_ITER (asic, port)
   {
-    return BVIEW_STATUS_FAILURE;
+    BVIEW_BST_SP_ITER (asic, index)
+    {
+      BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_EGR_UCAST_PORT_SHARED,
+                                    port, index, &db_index);
+      BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+            ePortSp.data[port - 1][index].ucShareBufferCount,
+            SB_OVSDB_BST_STAT_ID_EGR_UCAST_PORT_SHARED, db_index);
+    }
+  }
+  BVIEW_BST_PORT_ITER (asic, port)
+  {
+    BVIEW_BST_SP_ITER (asic, index)
+    {
+      BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_EGR_PORT_SHARED,
+                                    port, index, &db_index);
+      BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+            ePortSp.data[port - 1][index].umShareBufferCount,
+            SB_OVSDB_BST_STAT_ID_EGR_PORT_SHARED, db_index);
+    }
   }
 
-  /* Obtain Egress Port + Service Pools Statistics */
-  rv = sbplugin_ovsdb_bst_epsp_data_get (asic, &snapshot->ePortSp, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  /* Egress Service Pools Statistics */
+  BVIEW_BST_SP_ITER (asic, index)
   {
-    return BVIEW_STATUS_FAILURE;
+    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_EGR_POOL,
+                                  0, index, &db_index);
+    BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+          eSp.data[index].umShareBufferCount,
+          SB_OVSDB_BST_STAT_ID_EGR_POOL, db_index);
+  }
+  BVIEW_BST_SP_ITER (asic, index)
+  {
+    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_EGR_MCAST_POOL,
+                                  0, index, &db_index);
+    BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+          eSp.data[index].mcShareBufferCount,
+          SB_OVSDB_BST_STAT_ID_EGR_MCAST_POOL, db_index);
   }
 
-  /* Obtain Egress Service Pools Statistics */
-  rv = sbplugin_ovsdb_bst_esp_data_get (asic, &snapshot->eSp, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  /* Egress Unicast Queues Statistics */
+  BVIEW_BST_UC_QUEUE_ITER (asic, index)
   {
-    return BVIEW_STATUS_FAILURE;
+    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_UCAST,
+                                  0, index, &db_index);
+    BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+          eUcQ.data[index].ucBufferCount,
+          SB_OVSDB_BST_STAT_ID_UCAST, db_index);
   }
 
-  /* Obtain Egress Egress Unicast Queues Statistics */
-  rv = sbplugin_ovsdb_bst_eucq_data_get (asic, &snapshot->eUcQ, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  /* Egress Unicast Queue Groups Statistics */
+  BVIEW_BST_UC_QUEUE_GRP_ITER (asic, index)
   {
-    return BVIEW_STATUS_FAILURE;
+    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_UCAST_GROUP,
+                                  0, index, &db_index);
+    BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+          eUcQg.data[index].ucBufferCount,
+          SB_OVSDB_BST_STAT_ID_UCAST_GROUP, db_index);
   }
 
-  /* Obtain Egress Egress Unicast Queue Groups Statistics */
-  rv = sbplugin_ovsdb_bst_eucqg_data_get (asic, &snapshot->eUcQg ,time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  /* Egress Multicast Queues Statistics */
+  BVIEW_BST_MC_QUEUE_ITER (asic, index)
   {
-    return BVIEW_STATUS_FAILURE;
+    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_MCAST,
+                                  0, index, &db_index);
+    BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+          eMcQ.data[index].mcBufferCount,
+          SB_OVSDB_BST_STAT_ID_MCAST, db_index);
   }
 
-  /* Obtain Egress Egress Multicast Queues Statistics */
-  rv = sbplugin_ovsdb_bst_emcq_data_get (asic, &snapshot->eMcQ, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  /* Egress CPU Queues Statistics */
+  BVIEW_BST_CPU_QUEUE_ITER (asic, index)
   {
-    return BVIEW_STATUS_FAILURE;
+    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_CPU_QUEUE,
+                                  0, index, &db_index);
+    BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+          cpqQ.data[index].cpuBufferCount,
+          SB_OVSDB_BST_STAT_ID_CPU_QUEUE, db_index);
   }
 
-  /* Obtain Egress Egress CPU Queues Statistics */
-  rv = sbplugin_ovsdb_bst_cpuq_data_get (asic, &snapshot->cpqQ,time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  /* Egress RQE Queues Statistics */
+  BVIEW_BST_RQE_QUEUE_ITER (asic, index)
   {
-    return BVIEW_STATUS_FAILURE;
+    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_RQE_QUEUE,
+                                  0, index, &db_index);
+    BVIEW_OVSDB_BST_SNAPSHOT_MAP_ADD (map, count, &run,
+          rqeQ.data[index].rqeBufferCount,
+          SB_OVSDB_BST_STAT_ID_RQE_QUEUE, db_index);
+  }
+
+  /* End the last run */
+  sbplugin_ovsdb_bst_snapshot_map_add (map, count, &run, 0, 0);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Get the snapshot map of an ASIC, built on first use
+*
+* @param[in]      asic               - unit
+*
+* @retval   the map, NULL if it could not be built
+*
+* @notes    The map depends on the scaling parameters of the ASIC only,
+*           it is built once and never freed.
+*
+*
+*********************************************************************/
+static BVIEW_OVSDB_BST_SNAPSHOT_MAP_INFO_t *sbplugin_ovsdb_bst_snapshot_map_get (int asic)
+{
+  BVIEW_OVSDB_BST_SNAPSHOT_MAP_INFO_t *p_info = &bstSnapshotMap[asic];
+  BVIEW_OVSDB_SNAPSHOT_MAP_t          *map = NULL;
+  int                                  count = 0;
+
+  if (__atomic_load_n (&p_info->ready, __ATOMIC_ACQUIRE))
+  {
+    return p_info;
+  }
+
+  pthread_mutex_lock (&bstSnapshotMapLock);
+  if ((false == p_info->ready) &&
+      (BVIEW_STATUS_SUCCESS ==
+           sbplugin_ovsdb_bst_snapshot_map_build (asic, NULL, &count)))
+  {
+    map = malloc (count * sizeof (*map));
+    if ((NULL != map) &&
+        (BVIEW_STATUS_SUCCESS ==
+             sbplugin_ovsdb_bst_snapshot_map_build (asic, map, &count)))
+    {
+      p_info->map = map;
+      p_info->count = count;
+      __atomic_store_n (&p_info->ready, true, __ATOMIC_RELEASE);
+    }
+    else
+    {
+      free (map);
+    }
   }
+  pthread_mutex_unlock (&bstSnapshotMapLock);
+
+  return (p_info->ready) ? p_info : NULL;
+}
+
+/*********************************************************************
+* @brief  Obtain Complete ASIC Statistics Report
+*
+* @param[in]      asic               - unit
+* @param[out]     snapshot           - snapshot data structure
+* @param[out]     time               - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if snapshot get is failed.
+* @retval BVIEW_STATUS_NOTREADY          if the snapshot holds the last
+*                                        values read, the monitor is
+*                                        resyncing with the database.
+* @retval BVIEW_STATUS_SUCCESS           if snapshot get is success.
+*
+* @notes    All the realms are read in one pass, through the map of
+*           the ASIC and without the cache lock.
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_ovsdb_bst_snapshot_get (int asic,
+                                 BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                 BVIEW_TIME_t *time)
+{
+  BVIEW_OVSDB_BST_SNAPSHOT_MAP_INFO_t *p_info = NULL;
+  BVIEW_STATUS rv;
+  bool stale;
 
-  /* Obtain Egress Egress RQE Queues Statistics */
-  rv = sbplugin_ovsdb_bst_rqeq_data_get (asic, &snapshot->rqeQ, time);
-  if (rv != BVIEW_STATUS_SUCCESS)
+  /* Check validity of input data*/
+  BVIEW_BST_INPUT_VALIDATE (asic, snapshot, time);
+
+  p_info = sbplugin_ovsdb_bst_snapshot_map_get (asic);
+  if (NULL == p_info)
   {
     return BVIEW_STATUS_FAILURE;
   }
-  return BVIEW_STATUS_SUCCESS;
+
+  /* Update current local time*/
+  sbplugin_ovsdb_system_time_get (time);
+
+  /* taken before the read, a resync ending under it is still stale */
+  stale = bst_ovsdb_cache_stale_get ();
+  rv = bst_ovsdb_cache_snapshot_read (asic, p_info->map, p_info->count,
+                                      (uint64_t *) snapshot);
+  if ((BVIEW_STATUS_SUCCESS == rv) && (stale))
+  {
+    rv = BVIEW_STATUS_NOTREADY;
+  }
+  else if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    bst_ovsdb_cache_report_served ();
+  }
+  return rv;
 }
 
 /*********************************************************************
@@ -468,7 +722,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_device_data_get (int asic,
   sbplugin_ovsdb_system_time_get (time);
 
   /*Get total use-count is expressed in terms of buffers used in the device*/
-  data->bufferCount = p_cache->cache[asic].device.stat;
+  data->bufferCount = p_cache->cache[asic].stat.device;
 
   /* Release lock */
   SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
@@ -522,7 +776,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_ippg_data_get (int asic,
       BVIEW_OVSDB_BST_GET_DB_INDEX(asic, SB_OVSDB_BST_STAT_ID_PRI_GROUP_SHARED,
                                    port, pg, &db_index);
       data->data[port - 1][pg].umShareBufferCount =
-                     p_cache->cache[asic].iPGShared[db_index].stat;
+                     p_cache->cache[asic].stat.iPGShared[db_index];
 
       /* BST_Stat for each of the (Ingress Port, PG) UC plus MC
        * Headroom use-counts in units of buffers.
@@ -530,7 +784,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_ippg_data_get (int asic,
       BVIEW_OVSDB_BST_GET_DB_INDEX(asic, SB_OVSDB_BST_STAT_ID_PRI_GROUP_HEADROOM,
                                    port, pg, &db_index);
       data->data[port - 1][pg].umHeadroomBufferCount =
-                     p_cache->cache[asic].iPGHeadroom[db_index].stat;
+                     p_cache->cache[asic].stat.iPGHeadroom[db_index];
     } /* for (pg = 0; pg < BVI ....*/
   } /* for (port = 0; port < BVIEW......*/
   /* Release lock */
@@ -584,7 +838,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_ipsp_data_get (int asic,
      BVIEW_OVSDB_BST_GET_DB_INDEX(asic,SB_OVSDB_BST_STAT_ID_PORT_POOL,
                                   port, sp, &db_index);
      data->data[port - 1][sp].umShareBufferCount =
-                           p_cache->cache[asic].iPortSP[db_index].stat;
+                           p_cache->cache[asic].stat.iPortSP[db_index];
    }
  }
 
@@ -634,7 +888,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_isp_data_get (int asic,
    BVIEW_OVSDB_BST_GET_DB_INDEX (asic,SB_OVSDB_BST_STAT_ID_ING_POOL,
                                  0, sp, &db_index);
    data->data[sp].umShareBufferCount =
-         p_cache->cache[asic].iSP[db_index].stat;
+         p_cache->cache[asic].stat.iSP[db_index];
  }
   /* Release lock */
  SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
@@ -683,13 +937,13 @@ BVIEW_STATUS sbplugin_ovsdb_bst_epsp_data_get (int asic,
      BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_EGR_UCAST_PORT_SHARED,
                                    port, sp, &db_index);
      data->data[port - 1][sp].ucShareBufferCount =
-             p_cache->cache[asic].ePortSPucShare[db_index].stat;
+             p_cache->cache[asic].stat.ePortSPucShare[db_index];
 
      /* Obtain Egress Port + Service Pools Statistics - Ucast+Mcast cast stats*/
      BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_EGR_PORT_SHARED,
                                    port, sp, &db_index)
      data->data[port - 1][sp].umShareBufferCount =
-             p_cache->cache[asic].ePortSPumShare[db_index].stat;
+             p_cache->cache[asic].stat.ePortSPumShare[db_index];
    }
  }
   /* Release lock */
@@ -739,12 +993,12 @@ BVIEW_STATUS sbplugin_ovsdb_bst_esp_data_get  (int asic,
    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_EGR_POOL,
                                  0, sp, &db_index);
    data->data[sp].umShareBufferCount =
-                    p_cache->cache[asic].eSPumShare[db_index].stat;
+                    p_cache->cache[asic].stat.eSPumShare[db_index];
    /*BST_Threshold for each of the 4 Egress SP MC Share use-counts in units of buffers.*/
    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_EGR_MCAST_POOL,
                                  0, sp, &db_index);
    data->data[sp].mcShareBufferCount =
-                    p_cache->cache[asic].eSPmcShare[db_index].stat;
+                    p_cache->cache[asic].stat.eSPmcShare[db_index];
  }
   /* Release lock */
  SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
@@ -791,7 +1045,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_eucq_data_get (int asic,
    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_UCAST,
                                  0, cosq, &db_index);
    data->data[cosq].ucBufferCount =
-                 p_cache->cache[asic].ucQ[db_index].stat;
+                 p_cache->cache[asic].stat.ucQ[db_index];
  }
   /* Release lock */
  SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
@@ -839,7 +1093,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_eucqg_data_get (int asic,
    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_UCAST_GROUP,
                                  0, cosq, &db_index);
    data->data[cosq].ucBufferCount =
-            p_cache->cache[asic].eUCqGroup[db_index].stat;
+            p_cache->cache[asic].stat.eUCqGroup[db_index];
  }
   /* Release lock */
  SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
@@ -886,7 +1140,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_emcq_data_get (int asic,
    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_MCAST,
                                  0, cosq, &db_index);
    data->data[cosq].mcBufferCount =
-          p_cache->cache[asic].mcQ[db_index].stat;
+          p_cache->cache[asic].stat.mcQ[db_index];
  }
   /* Release lock */
  SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
@@ -933,7 +1187,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_cpuq_data_get (int asic,
    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_CPU_QUEUE,
                                  0, cosq, &db_index);
    data->data[cosq].cpuBufferCount =
-              p_cache->cache[asic].eCPU[db_index].stat;
+              p_cache->cache[asic].stat.eCPU[db_index];
  }
   /* Release lock */
  SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
@@ -980,7 +1234,7 @@ BVIEW_STATUS sbplugin_ovsdb_bst_rqeq_data_get (int asic,
    BVIEW_OVSDB_BST_GET_DB_INDEX (asic, SB_OVSDB_BST_STAT_ID_RQE_QUEUE,
                                  0 ,cosq, &db_index);
    data->data[cosq].rqeBufferCount =
-           p_cache->cache[asic].rqe[db_index].stat;
+           p_cache->cache[asic].stat.rqe[db_index];
  }
   /* Release lock */
  SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
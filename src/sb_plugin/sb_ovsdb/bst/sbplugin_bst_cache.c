@@ -21,11 +21,14 @@
 #include <stdlib.h>
 #include <inttypes.h>
 #include <pthread.h>
+#include <time.h>
 #include "sbplugin.h"
 #include "sbplugin_ovsdb.h"
 #include "sbplugin_bst_map.h"
 #include "sbplugin_bst_ovsdb.h"
 #include "sbplugin_bst_cache.h"
+#include "ovsdb_client.h"
+#include "ovsdb_txn.h"
 
 #define OVSDB_BST_MAX_TRIGGERS_NOT_INIT 0
 #define OVSDB_BST_MAX_TRIGGERS_DEFAULT  60
@@ -36,6 +39,53 @@ static BVIEW_OVSDB_BST_DATA_t  bst_ovsdb_cache;
 /* BST BID table parameters */ 
 extern BVIEW_BST_OVSDB_BID_PARAMS_t  bid_tab_params[SB_OVSDB_BST_STAT_ID_MAX_COUNT];
 
+/* lock free tries of a snapshot read before it takes the read lock */
+#define BST_OVSDB_SNAPSHOT_READ_RETRIES    8
+
+/* first size of the row index, a power of two, doubled at half load */
+#define BST_OVSDB_ROW_INDEX_INITIAL_SIZE   4096
+
+/* entry of the row index */
+typedef struct _bst_ovsdb_row_slot_
+{
+  bool                   used;
+  /* sweep the row was last seen in */
+  unsigned int           seen;
+  char                   uuid[BVIEW_OVSDB_ROW_UUID_SIZE];
+  BVIEW_OVSDB_ROW_REF_t  ref;
+} BVIEW_OVSDB_ROW_SLOT_t;
+
+/* bufmon rows by UUID, open addressing with linear probing. Filled from
+ * the initial monitor reply, read by the updates that follow. Used by the
+ * monitor thread only */
+static struct
+{
+  BVIEW_OVSDB_ROW_SLOT_t *slots;
+  unsigned int            size;
+  unsigned int            count;
+  /* sweep of the rows, see bst_ovsdb_row_refs_unmark */
+  unsigned int            sweep;
+} bst_ovsdb_row_index;
+
+/* Resyncs of the monitor after a lost session, timed from the loss. Set
+ * by the monitor thread, but for the first report, set by the reader
+ * that serves it */
+static struct
+{
+  uint64_t  lost;
+  uint64_t  resyncs;
+  /* when the last session was lost, msec */
+  uint64_t  lostAt;
+  /* lost to back in sync, msec */
+  uint64_t  resyncLast;
+  uint64_t  resyncMax;
+  /* lost to the first snapshot served in sync, msec */
+  uint64_t  firstReportLast;
+  uint64_t  firstReportMax;
+  /* in sync again, the first snapshot is still to be served */
+  bool      firstReportPending;
+} bst_ovsdb_resync_stats;
+
 
 /*********************************************************************
 * @brief   Initialise BST OVSDB cache
@@ -61,6 +111,8 @@ BVIEW_STATUS bst_ovsdb_cache_init()
             
     return BVIEW_STATUS_FAILURE;
   }
+  /* nothing read from the database yet */
+  bst_ovsdb_cache.stale = true;
   return BVIEW_STATUS_SUCCESS;
 }
 
@@ -153,7 +205,7 @@ BVIEW_STATUS bst_ovsdb_cache_bst_config_get(int asic,
 *
 * @param[in]   asic      -  asic number   
 * @param[in]   ovsdb_key -  ovsdb bufmon table's name/key entry     
-* @param[out]  p_row     -  Pointer to the row    
+* @param[out]  p_index   -  counter of the row in the cache arrays
 
 *
 * @retval BVIEW_STATUS_FAILURE      Failed to get row from ovsdb key  
@@ -165,13 +217,12 @@ BVIEW_STATUS bst_ovsdb_cache_bst_config_get(int asic,
 *********************************************************************/
 BVIEW_STATUS bst_ovsdb_cache_row_get (int asic, int bid, int index1,
                                       int index2,
-                                      BVIEW_OVSDB_BID_INFO_t **p_row)
+                                      unsigned int *p_index)
 {
   int index =0;
-  BVIEW_OVSDB_BID_INFO_t   *p_base = NULL;
 
   /* Check for NULL pointer */
-  SB_OVSDB_NULLPTR_CHECK(p_row, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK(p_index, BVIEW_STATUS_INVALID_PARAMETER);
 
   /* If it is double indexed then port is @first index */
   if (bid_tab_params[bid].is_double_indexed == true)
@@ -192,14 +243,13 @@ BVIEW_STATUS bst_ovsdb_cache_row_get (int asic, int bid, int index1,
   }
 
   /* Validate the index */
-  if (index >= bid_tab_params[bid].size)
+  if ((index < 0) || (index >= bid_tab_params[bid].size))
   {
     return BVIEW_STATUS_FAILURE;
   }
 
-  p_base = BVIEW_OVSDB_BID_BASE_ADDR (bid, &bst_ovsdb_cache.cache[asic]);
-  /* Get pointer to the entry */
-  *p_row =  p_base + index;
+  /* Counter of the entry */
+  *p_index = BVIEW_OVSDB_BID_BASE_INDEX (bid) + index;
 
   return BVIEW_STATUS_SUCCESS;
 }
@@ -220,11 +270,12 @@ BVIEW_STATUS bst_ovsdb_cache_row_get (int asic, int bid, int index1,
 *
 * @notes    none
 *********************************************************************/
-BVIEW_STATUS bst_ovsdb_row_info_get (int asic, char *ovsdb_key,
+BVIEW_STATUS bst_ovsdb_row_info_get (int asic, const char *ovsdb_key,
                                      int *pbid, int *port, 
                                      int *queue)
 {
   char src_string[1024] = {0};
+  char *save = NULL;
   char delim[2] = "/";
   char *realm   = NULL;
   char *name    = NULL;
@@ -234,49 +285,47 @@ BVIEW_STATUS bst_ovsdb_row_info_get (int asic, char *ovsdb_key,
   int num_of_entries = sizeof(bid_tab_params)/sizeof(BVIEW_BST_OVSDB_BID_PARAMS_t);
   int  bid = 0;
   int index =0;
+  BVIEW_BST_REALM_ID_t realmId;
+  BVIEW_BST_COUNTER_ID_t counterId;
 
   SB_OVSDB_NULLPTR_CHECK(ovsdb_key, BVIEW_STATUS_INVALID_PARAMETER);
   SB_OVSDB_NULLPTR_CHECK(pbid, BVIEW_STATUS_INVALID_PARAMETER);
   SB_OVSDB_NULLPTR_CHECK(port, BVIEW_STATUS_INVALID_PARAMETER);
   SB_OVSDB_NULLPTR_CHECK(queue, BVIEW_STATUS_INVALID_PARAMETER);
 
-  strcpy(src_string, ovsdb_key);
+  strncpy(src_string, ovsdb_key, sizeof(src_string) - 1);
 
   /* ovsdb_key string is of the format <realm>/<name>/<index1>/<index2> */
   /* Get realm */
-  realm = strtok(src_string, delim);
+  realm = strtok_r(src_string, delim, &save);
   /* Get name */
-  name = strtok(NULL, delim);
+  name = strtok_r(NULL, delim, &save);
   /* Get  index1*/
-  index1 = strtok(NULL, delim);
+  index1 = strtok_r(NULL, delim, &save);
   /* Get  index2*/
-  index2 = strtok(NULL, delim);
+  index2 = strtok_r(NULL, delim, &save);
   if (realm == NULL || name == NULL ||
       index1 == NULL || index2 == NULL)
   {
     return BVIEW_STATUS_FAILURE;
   }
 
-  final_token = strtok(NULL, delim);
+  final_token = strtok_r(NULL, delim, &save);
   if (final_token != NULL)
   {
     return BVIEW_STATUS_FAILURE;
   }
 
-  final_token = strtok(NULL, delim);
-  if (final_token != NULL)
-  {
-    return BVIEW_STATUS_FAILURE;
-  }
+  /* the names stop here, the bid is found by the registry ids */
+  realmId = bst_registry_realm_id_get(realm);
+  counterId = bst_registry_counter_id_get(name);
 
   for (bid = 0; bid < num_of_entries; bid++)
   {
-    if (strcmp(bid_tab_params[bid].realm_name, realm) == 0)
+    if ((bid_tab_params[bid].realm == realmId) &&
+        (bid_tab_params[bid].counter == counterId))
     {
-      if (strcmp(bid_tab_params[bid].counter_name, name) == 0)
-      {
-        break;
-      }
+      break;
     }
   }
 
@@ -319,56 +368,550 @@ BVIEW_STATUS bst_ovsdb_row_info_get (int asic, char *ovsdb_key,
 }
  
 /*********************************************************************
-* @brief    Update the stat/threshold of row with key 'ovsdb_key'. 
-*           
+* @brief    FNV-1a hash of a row UUID.
 *
-* @param[in]   asic      -  asic number   
-* @param[in]   ovsdb_key -  ovsdb bufmon table's name/key entry     
-* @param[out]  p_row     -  Pointer to the row    
+*********************************************************************/
+static unsigned int bst_ovsdb_row_hash (const char *uuid)
+{
+  unsigned int hash = 2166136261u;
+  int i;
+
+  for (i = 0; i < BVIEW_OVSDB_ROW_UUID_SIZE; i++)
+  {
+    hash ^= (unsigned char) uuid[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
+/*********************************************************************
+* @brief    Find the slot of a row UUID, or the free slot it would take.
 *
-* @retval BVIEW_STATUS_FAILURE      Failed to get the row for ovsdb_key.
-* @retval BVIEW_STATUS_SUCCESS      updated cache successfully. 
-*                                   
+*********************************************************************/
+static BVIEW_OVSDB_ROW_SLOT_t *bst_ovsdb_row_slot_find (const char *uuid)
+{
+  unsigned int mask = bst_ovsdb_row_index.size - 1;
+  unsigned int slot = bst_ovsdb_row_hash (uuid) & mask;
+
+  while ((bst_ovsdb_row_index.slots[slot].used) &&
+         (memcmp (bst_ovsdb_row_index.slots[slot].uuid, uuid,
+                  BVIEW_OVSDB_ROW_UUID_SIZE) != 0))
+  {
+    slot = (slot + 1) & mask;
+  }
+  return &bst_ovsdb_row_index.slots[slot];
+}
+
+/*********************************************************************
+* @brief    Size the row index for one more row.
 *
+* @retval BVIEW_STATUS_RESOURCE_NOT_AVAILABLE   no memory for it
+* @retval BVIEW_STATUS_SUCCESS
 *
-* @notes    none
 *********************************************************************/
-BVIEW_STATUS    bst_ovsdb_row_update (int asic,  int bid,
-                                      int port,  int queue,
-                                      bool default_threshold,
-                                      BVIEW_OVSDB_BID_INFO_t *p_row)
+static BVIEW_STATUS bst_ovsdb_row_index_reserve (void)
+{
+  BVIEW_OVSDB_ROW_SLOT_t *old_slots = bst_ovsdb_row_index.slots;
+  unsigned int old_size = bst_ovsdb_row_index.size;
+  unsigned int size;
+  unsigned int i;
+
+  if ((old_slots) && ((bst_ovsdb_row_index.count + 1) * 2 <= old_size))
+  {
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  size = (old_slots) ? (old_size * 2) : BST_OVSDB_ROW_INDEX_INITIAL_SIZE;
+  bst_ovsdb_row_index.slots = calloc (size, sizeof (BVIEW_OVSDB_ROW_SLOT_t));
+  if (NULL == bst_ovsdb_row_index.slots)
+  {
+    bst_ovsdb_row_index.slots = old_slots;
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+  bst_ovsdb_row_index.size = size;
+
+  for (i = 0; i < old_size; i++)
+  {
+    if (old_slots[i].used)
+    {
+      *bst_ovsdb_row_slot_find (old_slots[i].uuid) = old_slots[i];
+    }
+  }
+  free (old_slots);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Resolve a bufmon row to its cache entry.
+*
+* @param[in]   uuid      -  row UUID, as the monitor names the row
+* @param[in]   asic      -  asic number of the row
+* @param[in]   ovsdb_key -  name of the row, NULL if not at hand
+* @param[out]  p_ref     -  the resolved row
+*
+* @retval BVIEW_STATUS_FAILURE      row unknown and its name missing or
+*                                   not a BST counter
+* @retval BVIEW_STATUS_SUCCESS      row resolved
+*
+* @notes    A row seen once is found again by its UUID without
+*           parsing its name. Monitor thread only.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_row_ref_get (const char *uuid, int asic,
+                                    const char *ovsdb_key,
+                                    BVIEW_OVSDB_ROW_REF_t *p_ref)
 {
-  BVIEW_OVSDB_BID_INFO_t   *p_db_row = NULL;
+  BVIEW_OVSDB_ROW_SLOT_t *p_slot;
+  BVIEW_OVSDB_ROW_REF_t  ref;
 
-  SB_OVSDB_NULLPTR_CHECK (p_row, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK(uuid, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK(p_ref, BVIEW_STATUS_INVALID_PARAMETER);
 
-  /* Get exact row of ovsdb_key*/
-  if (BVIEW_STATUS_SUCCESS !=  
-       bst_ovsdb_cache_row_get (asic, 
-                                bid, port, queue,
-                                &p_db_row))
+  if (strlen (uuid) != BVIEW_OVSDB_ROW_UUID_SIZE)
   {
     return BVIEW_STATUS_FAILURE;
   }
+
+  if (bst_ovsdb_row_index.slots)
+  {
+    p_slot = bst_ovsdb_row_slot_find (uuid);
+    if (p_slot->used)
+    {
+      p_slot->seen = bst_ovsdb_row_index.sweep;
+      *p_ref = p_slot->ref;
+      return BVIEW_STATUS_SUCCESS;
+    }
+  }
+
+  /* first sight of the row, resolve its name */
+  if (NULL == ovsdb_key)
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+  if ((asic < 0) || (asic >= BVIEW_MAX_ASICS_ON_A_PLATFORM))
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  memset (&ref, 0, sizeof (ref));
+  ref.asic = asic;
+  ref.queue = -1;
+  if ((BVIEW_STATUS_SUCCESS != bst_ovsdb_row_info_get (asic, ovsdb_key, &ref.bid,
+                                                       &ref.port, &ref.queue)) ||
+      (BVIEW_STATUS_SUCCESS != bst_ovsdb_cache_row_get (asic, ref.bid, ref.port,
+                                                        ref.queue, &ref.index)))
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+  *p_ref = ref;
+
+  /* an index out of memory only costs the parse next time */
+  if (BVIEW_STATUS_SUCCESS == bst_ovsdb_row_index_reserve ())
+  {
+    p_slot = bst_ovsdb_row_slot_find (uuid);
+    p_slot->used = true;
+    p_slot->seen = bst_ovsdb_row_index.sweep;
+    memcpy (p_slot->uuid, uuid, BVIEW_OVSDB_ROW_UUID_SIZE);
+    p_slot->ref = ref;
+    bst_ovsdb_row_index.count++;
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Read back the cached columns of a bufmon row.
+*
+* @param[in]   p_ref     -  row resolved by bst_ovsdb_row_ref_get
+* @param[out]  p_row     -  cached columns of the row
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_SUCCESS            columns read.
+*
+* @notes    Monitor thread only, it is the one writer of the cache.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_row_cached_get (const BVIEW_OVSDB_ROW_REF_t *p_ref,
+                                       BVIEW_OVSDB_BID_INFO_t *p_row)
+{
+  const BVIEW_OVSDB_BST_STAT_DB_t *p_db;
+  unsigned int index;
+
+  SB_OVSDB_NULLPTR_CHECK(p_ref, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK(p_row, BVIEW_STATUS_INVALID_PARAMETER);
+
+  p_db = &bst_ovsdb_cache.cache[p_ref->asic];
+  index = p_ref->index;
+  p_row->stat = ((const uint64_t *) &p_db->stat)[index];
+  p_row->threshold = ((const uint64_t *) &p_db->threshold)[index];
+  p_row->enabled = ((p_db->enabled[index / 64] >> (index % 64)) & 1) ? true : false;
+  p_row->triggered = ((p_db->triggered[index / 64] >> (index % 64)) & 1) ? true : false;
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Start a sweep of the row index.
+*
+* @notes    Every row is unseen until bst_ovsdb_row_ref_get finds it
+*           again. Monitor thread only.
+*********************************************************************/
+void bst_ovsdb_row_refs_unmark (void)
+{
+  bst_ovsdb_row_index.sweep++;
+}
+
+/*********************************************************************
+* @brief    Get the next row not seen since the sweep started.
+*
+* @param[in,out]  p_cursor  -  position in the index, 0 to start
+* @param[out]     uuid      -  row UUID, BVIEW_OVSDB_ROW_UUID_SIZE + 1 bytes
+* @param[out]     p_ref     -  the row
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_FAILURE            no more unseen rows
+* @retval BVIEW_STATUS_SUCCESS            unseen row found
+*
+* @notes    The index is not to change during the walk. Monitor thread
+*           only.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_row_ref_unseen_get (unsigned int *p_cursor, char *uuid,
+                                           BVIEW_OVSDB_ROW_REF_t *p_ref)
+{
+  BVIEW_OVSDB_ROW_SLOT_t *p_slot;
+
+  SB_OVSDB_NULLPTR_CHECK(p_cursor, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK(uuid, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_OVSDB_NULLPTR_CHECK(p_ref, BVIEW_STATUS_INVALID_PARAMETER);
+
+  while (*p_cursor < bst_ovsdb_row_index.size)
+  {
+    p_slot = &bst_ovsdb_row_index.slots[(*p_cursor)++];
+    if ((p_slot->used) && (p_slot->seen != bst_ovsdb_row_index.sweep))
+    {
+      memcpy (uuid, p_slot->uuid, BVIEW_OVSDB_ROW_UUID_SIZE);
+      uuid[BVIEW_OVSDB_ROW_UUID_SIZE] = '\0';
+      *p_ref = p_slot->ref;
+      return BVIEW_STATUS_SUCCESS;
+    }
+  }
+  return BVIEW_STATUS_FAILURE;
+}
+
+/*********************************************************************
+* @brief    Forget a bufmon row deleted from the database.
+*
+* @param[in]   uuid      -  row UUID
+*
+* @notes    Monitor thread only.
+*********************************************************************/
+void bst_ovsdb_row_ref_delete (const char *uuid)
+{
+  unsigned int mask = bst_ovsdb_row_index.size - 1;
+  unsigned int hole;
+  unsigned int slot;
+  unsigned int home;
+  BVIEW_OVSDB_ROW_SLOT_t *p_slot;
+
+  if ((NULL == uuid) || (NULL == bst_ovsdb_row_index.slots) ||
+      (strlen (uuid) != BVIEW_OVSDB_ROW_UUID_SIZE))
+  {
+    return;
+  }
+
+  p_slot = bst_ovsdb_row_slot_find (uuid);
+  if (!p_slot->used)
+  {
+    return;
+  }
+  p_slot->used = false;
+  bst_ovsdb_row_index.count--;
+
+  /* shift back the rows of the probe run so no search stops early */
+  hole = p_slot - bst_ovsdb_row_index.slots;
+  for (slot = (hole + 1) & mask; bst_ovsdb_row_index.slots[slot].used;
+       slot = (slot + 1) & mask)
+  {
+    home = bst_ovsdb_row_hash (bst_ovsdb_row_index.slots[slot].uuid) & mask;
+    /* the row stays if its home lies cyclically in (hole, slot] */
+    if (((slot - home) & mask) < ((slot - hole) & mask))
+    {
+      continue;
+    }
+    bst_ovsdb_row_index.slots[hole] = bst_ovsdb_row_index.slots[slot];
+    bst_ovsdb_row_index.slots[slot].used = false;
+    hole = slot;
+  }
+}
+
+/*********************************************************************
+* @brief    Mark the stats of every ASIC as being written.
+*
+* @notes    Write lock held. A batch rarely spans ASICs, turning all
+*           the sequences keeps the writer free of per row checks.
+*********************************************************************/
+static void bst_ovsdb_cache_seq_begin (void)
+{
+  int asic;
+
+  for (asic = 0; asic < BVIEW_MAX_ASICS_ON_A_PLATFORM; asic++)
+  {
+    __atomic_store_n (&bst_ovsdb_cache.seq[asic],
+                      bst_ovsdb_cache.seq[asic] + 1, __ATOMIC_RELAXED);
+  }
+  /* the odd sequences are visible before any of the writes */
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+}
+
+/*********************************************************************
+* @brief    Publish the stats written since bst_ovsdb_cache_seq_begin().
+*
+* @notes    Write lock held.
+*********************************************************************/
+static void bst_ovsdb_cache_seq_end (void)
+{
+  int asic;
+
+  for (asic = 0; asic < BVIEW_MAX_ASICS_ON_A_PLATFORM; asic++)
+  {
+    __atomic_store_n (&bst_ovsdb_cache.seq[asic],
+                      bst_ovsdb_cache.seq[asic] + 1, __ATOMIC_RELEASE);
+  }
+}
+
+/*********************************************************************
+* @brief    Monotonic time, msec.
+*
+*********************************************************************/
+static uint64_t bst_ovsdb_cache_msec (void)
+{
+  struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ((uint64_t) ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+/*********************************************************************
+* @brief    Mark the cache as out of sync with the database, or back
+*           in sync.
+*
+* @param[in]   stale     -  cache out of sync
+*
+* @notes    The cache keeps its values while the monitor resyncs.
+*           Monitor thread only, it times the resync of a lost
+*           session.
+*********************************************************************/
+void bst_ovsdb_cache_stale_set (bool stale)
+{
+  uint64_t elapsed;
+
+  if ((stale) && (!bst_ovsdb_cache.stale))
+  {
+    bst_ovsdb_resync_stats.lost++;
+    bst_ovsdb_resync_stats.lostAt = bst_ovsdb_cache_msec ();
+    __atomic_store_n (&bst_ovsdb_resync_stats.firstReportPending, false,
+                      __ATOMIC_RELAXED);
+  }
+  else if ((!stale) && (bst_ovsdb_cache.stale) &&
+           (0 != bst_ovsdb_resync_stats.lost))
+  {
+    elapsed = bst_ovsdb_cache_msec () - bst_ovsdb_resync_stats.lostAt;
+    bst_ovsdb_resync_stats.resyncs++;
+    bst_ovsdb_resync_stats.resyncLast = elapsed;
+    if (elapsed > bst_ovsdb_resync_stats.resyncMax)
+    {
+      bst_ovsdb_resync_stats.resyncMax = elapsed;
+    }
+    __atomic_store_n (&bst_ovsdb_resync_stats.firstReportPending, true,
+                      __ATOMIC_RELEASE);
+  }
+  __atomic_store_n (&bst_ovsdb_cache.stale, stale, __ATOMIC_RELEASE);
+}
+
+/*********************************************************************
+* @brief    Note a snapshot served from the cache in sync.
+*
+* @notes    The first one after a resync times the lost session up to
+*           a valid report.
+*********************************************************************/
+void bst_ovsdb_cache_report_served (void)
+{
+  uint64_t elapsed;
+
+  if ((!__atomic_load_n (&bst_ovsdb_resync_stats.firstReportPending,
+                         __ATOMIC_RELAXED)) ||
+      (!__atomic_exchange_n (&bst_ovsdb_resync_stats.firstReportPending,
+                             false, __ATOMIC_ACQUIRE)))
+  {
+    return;
+  }
+
+  elapsed = bst_ovsdb_cache_msec () - bst_ovsdb_resync_stats.lostAt;
+  bst_ovsdb_resync_stats.firstReportLast = elapsed;
+  if (elapsed > bst_ovsdb_resync_stats.firstReportMax)
+  {
+    bst_ovsdb_resync_stats.firstReportMax = elapsed;
+  }
+}
+
+/*********************************************************************
+* @brief    Tell if the cache is out of sync with the database.
+*
+* @retval   true while the monitor resyncs
+*********************************************************************/
+bool bst_ovsdb_cache_stale_get (void)
+{
+  return __atomic_load_n (&bst_ovsdb_cache.stale, __ATOMIC_ACQUIRE);
+}
+
+/*********************************************************************
+* @brief    Apply a batch of bufmon row updates to the cache.
+*
+* @param[in]   p_updates      -  staged rows of one table update
+* @param[in]   count          -  number of staged rows
+* @param[in]   trackMask      -  realms found enabled in the batch
+* @param[out]  p_oldTrackMask -  tracking mask before the batch
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_SUCCESS            updated cache successfully.
+*
+* @notes    The whole batch goes in under one write lock and one turn
+*           of the sequences, readers see the cache either before or
+*           after the notification. The rows carry all their columns,
+*           resolved by the monitor against the cached ones.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_row_updates_apply (BVIEW_OVSDB_ROW_UPDATE_t *p_updates,
+                                          int count, int trackMask,
+                                          int *p_oldTrackMask)
+{
+  BVIEW_OVSDB_BST_STAT_DB_t *p_db;
+  unsigned int index;
+  int i;
+
+  SB_OVSDB_NULLPTR_CHECK (p_oldTrackMask, BVIEW_STATUS_INVALID_PARAMETER);
+  if ((count > 0) && (NULL == p_updates))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
   /* Acquire write lock*/
   SB_OVSDB_RWLOCK_WR_LOCK(bst_ovsdb_cache.lock);
+  *p_oldTrackMask = bst_ovsdb_cache.config_data.trackingMask;
+  bst_ovsdb_cache.config_data.trackingMask |= trackMask;
+
+  bst_ovsdb_cache_seq_begin ();
+  for (i = 0; i < count; i++)
+  {
+    p_db = &bst_ovsdb_cache.cache[p_updates[i].ref.asic];
+    index = p_updates[i].ref.index;
+    __atomic_store_n ((uint64_t *) &p_db->stat + index,
+                      p_updates[i].row.stat, __ATOMIC_RELAXED);
+    __atomic_store_n ((uint64_t *) &p_db->threshold + index,
+                      p_updates[i].row.threshold, __ATOMIC_RELAXED);
+    if (p_updates[i].row.enabled)
+    {
+      p_db->enabled[index / 64] |= (1ULL << (index % 64));
+    }
+    else
+    {
+      p_db->enabled[index / 64] &= ~(1ULL << (index % 64));
+    }
+    if (p_updates[i].row.triggered)
+    {
+      p_db->triggered[index / 64] |= (1ULL << (index % 64));
+    }
+    else
+    {
+      p_db->triggered[index / 64] &= ~(1ULL << (index % 64));
+    }
+  }
+  bst_ovsdb_cache_seq_end ();
+  /* Release lock */
+  SB_OVSDB_RWLOCK_UNLOCK(bst_ovsdb_cache.lock);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Copy stats into a snapshot, run by run.
+*
+* @notes    The stats may change under the copy, the caller checks the
+*           sequence afterwards.
+*********************************************************************/
+static void bst_ovsdb_cache_snapshot_copy (const uint64_t *p_stat,
+                                   const BVIEW_OVSDB_SNAPSHOT_MAP_t *p_map,
+                                   int count, uint64_t *p_dst)
+{
+  const uint64_t *p_src;
+  uint64_t       *p_field;
+  unsigned int    k;
+  int             i;
+
+  for (i = 0; i < count; i++)
+  {
+    p_src = p_stat + p_map[i].src;
+    p_field = p_dst + p_map[i].dst;
+    for (k = 0; k < p_map[i].count; k++)
+    {
+      *p_field = __atomic_load_n (&p_src[k], __ATOMIC_RELAXED);
+      p_field += p_map[i].stride;
+    }
+  }
+}
+
+/*********************************************************************
+* @brief    Read the stats of an ASIC into a snapshot, as the map says.
+*
+* @param[in]   asic      -  asic number
+* @param[in]   p_map     -  runs of snapshot fields and their stats
+* @param[in]   count     -  number of runs in the map
+* @param[out]  p_dst     -  snapshot, as 64 bit words
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER  Invalid input parameter(s)
+* @retval BVIEW_STATUS_SUCCESS            snapshot read.
+*
+* @notes    Lock free, the read is retried if the monitor updated the
+*           ASIC meanwhile. A reader that keeps losing falls back to
+*           the read lock, which the monitor holds while it writes.
+*********************************************************************/
+BVIEW_STATUS bst_ovsdb_cache_snapshot_read (int asic,
+                                   const BVIEW_OVSDB_SNAPSHOT_MAP_t *p_map,
+                                   int count, uint64_t *p_dst)
+{
+  const uint64_t *p_stat;
+  unsigned int seq;
+  int retry;
 
-  if (bid != -1 && default_threshold)
+  if ((asic < 0) || (asic >= BVIEW_MAX_ASICS_ON_A_PLATFORM) ||
+      (NULL == p_dst) || ((count > 0) && (NULL == p_map)))
   {
-    bst_ovsdb_default_threshold_get (bid, &p_row->threshold);
+    return BVIEW_STATUS_INVALID_PARAMETER;
   }
-  /* Update the cache*/
-  if (p_db_row)
+
+  p_stat = (const uint64_t *) &bst_ovsdb_cache.cache[asic].stat;
+
+  for (retry = 0; retry < BST_OVSDB_SNAPSHOT_READ_RETRIES; retry++)
   {
-    p_db_row->stat      = p_row->stat;
-    p_db_row->threshold = p_row->threshold;
+    seq = __atomic_load_n (&bst_ovsdb_cache.seq[asic], __ATOMIC_ACQUIRE);
+    if (seq & 1)
+    {
+      continue;
+    }
+    bst_ovsdb_cache_snapshot_copy (p_stat, p_map, count, p_dst);
+    /* the copy is done before the sequence is checked again */
+    __atomic_thread_fence (__ATOMIC_ACQUIRE);
+    if (seq == __atomic_load_n (&bst_ovsdb_cache.seq[asic], __ATOMIC_RELAXED))
+    {
+      return BVIEW_STATUS_SUCCESS;
+    }
   }
+
+  /* Acquire read lock*/
+  SB_OVSDB_RWLOCK_RD_LOCK(bst_ovsdb_cache.lock);
+  bst_ovsdb_cache_snapshot_copy (p_stat, p_map, count, p_dst);
   /* Release lock */
   SB_OVSDB_RWLOCK_UNLOCK(bst_ovsdb_cache.lock);
 
   return BVIEW_STATUS_SUCCESS;
-}  
- 
+}
+
 /*********************************************************************
 * @brief   Get the pointer to BST data
 *
@@ -409,5 +952,20 @@ BVIEW_STATUS bst_ovsdb_cache_dump(int asic)
   
   /* Release lock */
   SB_OVSDB_RWLOCK_UNLOCK(bst_ovsdb_cache.lock);
+
+  printf ("\n");
+  printf ("OVSDB BST monitor: sessions lost %" PRIu64 " -- resyncs %" PRIu64
+          " -- %s\n", bst_ovsdb_resync_stats.lost,
+          bst_ovsdb_resync_stats.resyncs,
+          (bst_ovsdb_cache_stale_get ()) ? "stale" : "in sync");
+  printf ("OVSDB BST monitor: lost to resync last %" PRIu64 " ms -- longest %"
+          PRIu64 " ms\n", bst_ovsdb_resync_stats.resyncLast,
+          bst_ovsdb_resync_stats.resyncMax);
+  printf ("OVSDB BST monitor: lost to first report last %" PRIu64
+          " ms -- longest %" PRIu64 " ms\n",
+          bst_ovsdb_resync_stats.firstReportLast,
+          bst_ovsdb_resync_stats.firstReportMax);
+  ovsdb_client_stats_dump ();
+  ovsdb_txn_stats_dump ();
    return BVIEW_STATUS_SUCCESS;
 }
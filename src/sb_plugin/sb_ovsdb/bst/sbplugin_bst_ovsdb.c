@@ -37,183 +37,183 @@ BVIEW_BST_OVSDB_BID_PARAMS_t  bid_tab_params[SB_OVSDB_BST_STAT_ID_MAX_COUNT] =
                               {
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_DEVICE, 
-                                  .realm_name = "device",
-                                  .counter_name  = "data",
+                                  .realm = BVIEW_BST_DEVICE,
+                                  .counter = BVIEW_BST_COUNTER_DATA,
                                   .is_indexed = false,
                                   .is_double_indexed = false,
                                   .num_of_rows = SB_OVSDB_BST_DEVICE_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_DEVICE_COLUMNS,
                                   .size = SB_OVSDB_BST_DEVICE_DB_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, device),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, device),
                                   .default_threshold = BVIEW_BST_DEVICE_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_EGR_POOL, 
-                                  .realm_name = "egress-service-pool",
-                                  .counter_name  = "um-share-buffer-count",
+                                  .realm = BVIEW_BST_EGRESS_SP,
+                                  .counter = BVIEW_BST_COUNTER_UM_SHARE,
                                   .is_indexed = true,
                                   .is_double_indexed = false,
                                   .num_of_rows = SB_OVSDB_BST_EGR_POOL_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_EGR_POOL_COLUMNS,
                                   .size = SB_OVSDB_E_SP_UM_SHARE_STAT_SIZE, 
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, eSPumShare),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, eSPumShare),
                                   .default_threshold = BVIEW_BST_E_SP_UCMC_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_EGR_MCAST_POOL,
-                                  .realm_name = "egress-service-pool",
-                                  .counter_name  = "mc-share-buffer-count",
+                                  .realm = BVIEW_BST_EGRESS_SP,
+                                  .counter = BVIEW_BST_COUNTER_MC_SHARE,
                                   .is_indexed = true,
                                   .is_double_indexed = false,
                                   .num_of_rows = SB_OVSDB_BST_EGR_MCAST_POOL_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_EGR_MCAST_POOL_COLUMNS,
 
                                   .size = SB_OVSDB_E_SP_MC_SHARE_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, eSPmcShare),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, eSPmcShare),
                                   .default_threshold = BVIEW_BST_E_SP_MC_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_ING_POOL, 
-                                  .realm_name = "ingress-service-pool",
-                                  .counter_name  = "um-share-buffer-count",
+                                  .realm = BVIEW_BST_INGRESS_SP,
+                                  .counter = BVIEW_BST_COUNTER_UM_SHARE,
                                   .is_indexed = true,
                                   .is_double_indexed = false,
                                   .num_of_rows = SB_OVSDB_BST_ING_POOL_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_ING_POOL_COLUMNS,
                                   .size = SB_OVSDB_I_SP_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, iSP),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, iSP),
                                   .default_threshold = BVIEW_BST_I_SP_UCMC_SHARED_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_PORT_POOL,
-                                  .realm_name = "ingress-port-service-pool",
-                                  .counter_name  = "um-share-buffer-count",
+                                  .realm = BVIEW_BST_INGRESS_PORT_SP,
+                                  .counter = BVIEW_BST_COUNTER_UM_SHARE,
                                   .is_indexed = true,
                                   .is_double_indexed = true,
                                   .num_of_rows = SB_OVSDB_BST_PORT_POOL_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_PORT_POOL_COLUMNS,
                                   .size = SB_OVSDB_I_P_SP_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, iPortSP),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, iPortSP),
                                   .default_threshold =  BVIEW_BST_I_P_SP_UCMC_SHARED_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_PRI_GROUP_SHARED,
-                                  .realm_name = "ingress-port-priority-group",
-                                  .counter_name  = "um-share-buffer-count",
+                                  .realm = BVIEW_BST_INGRESS_PORT_PG,
+                                  .counter = BVIEW_BST_COUNTER_UM_SHARE,
                                   .is_indexed = true,
                                   .is_double_indexed = true,
                                   .num_of_rows = SB_OVSDB_BST_PRI_GROUP_SHARED_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_PRI_GROUP_SHARED_COLUMNS,
                                   .size = SB_OVSDB_PG_SHARED_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, iPGShared),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, iPGShared),
                                   .default_threshold = BVIEW_BST_I_P_PG_UCMC_SHARED_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_PRI_GROUP_HEADROOM,
-                                  .realm_name = "ingress-port-priority-group",
-                                  .counter_name  = "um-headroom-buffer-count",
+                                  .realm = BVIEW_BST_INGRESS_PORT_PG,
+                                  .counter = BVIEW_BST_COUNTER_UM_HEADROOM,
                                   .is_indexed = true,
                                   .is_double_indexed = true,
                                   .num_of_rows = SB_OVSDB_BST_PRI_GROUP_HEADROOM_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_PRI_GROUP_HEADROOM_COLUMNS,
                                   .size = SB_OVSDB_PG_HEADROOM_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, iPGHeadroom),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, iPGHeadroom),
                                   .default_threshold = BVIEW_BST_I_P_PG_UCMC_HDRM_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_UCAST, 
-                                  .realm_name = "egress-uc-queue",
-                                  .counter_name  = "uc-buffer-count",
+                                  .realm = BVIEW_BST_EGRESS_UC_QUEUE,
+                                  .counter = BVIEW_BST_COUNTER_UC_BUFFER,
                                   .is_indexed = true,
                                   .is_double_indexed = false,
                                   .num_of_rows = SB_OVSDB_BST_UCAST_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_UCAST_COLUMNS,
                                   .size = SB_OVSDB_E_UC_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, ucQ),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, ucQ),
                                   .default_threshold = BVIEW_BST_UCAST_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_MCAST, 
-                                  .realm_name = "egress-mc-queue",
-                                  .counter_name  = "mc-buffer-count",
+                                  .realm = BVIEW_BST_EGRESS_MC_QUEUE,
+                                  .counter = BVIEW_BST_COUNTER_MC_BUFFER,
                                   .is_indexed = true,
                                   .is_double_indexed = false,
                                   .num_of_rows = SB_OVSDB_BST_MCAST_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_MCAST_COLUMNS,
                                   .size = SB_OVSDB_E_MC_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, mcQ),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, mcQ),
                                   .default_threshold = BVIEW_BST_MCAST_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_EGR_UCAST_PORT_SHARED,
-                                  .realm_name = "egress-port-service-pool",
-                                  .counter_name  = "uc-share-buffer-count",
+                                  .realm = BVIEW_BST_EGRESS_PORT_SP,
+                                  .counter = BVIEW_BST_COUNTER_UC_SHARE,
                                   .is_indexed = true,
                                   .is_double_indexed = true,
                                   .num_of_rows = SB_OVSDB_BST_EGR_UCAST_PORT_SHARED_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_EGR_UCAST_PORT_SHARED_COLUMNS,
                                   .size = SB_OVSDB_E_P_SP_UC_SHARE_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, ePortSPucShare),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, ePortSPucShare),
                                   .default_threshold = BVIEW_BST_E_P_SP_UC_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_EGR_PORT_SHARED,
-                                  .realm_name = "egress-port-service-pool",
-                                  .counter_name  = "um-share-buffer-count",
+                                  .realm = BVIEW_BST_EGRESS_PORT_SP,
+                                  .counter = BVIEW_BST_COUNTER_UM_SHARE,
                                   .is_indexed = true,
                                   .is_double_indexed = true,
                                   .num_of_rows = SB_OVSDB_BST_EGR_PORT_SHARED_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_EGR_PORT_SHARED_COLUMNS,
                                   .size = SB_OVSDB_E_P_SP_UM_SHARE_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, ePortSPumShare),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, ePortSPumShare),
                                   .default_threshold = BVIEW_BST_E_P_SP_UCMC_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_RQE_QUEUE,
-                                  .realm_name = "egress-rqe-queue",
-                                  .counter_name  = "rqe-buffer-count",
+                                  .realm = BVIEW_BST_EGRESS_RQE_QUEUE,
+                                  .counter = BVIEW_BST_COUNTER_RQE_BUFFER,
                                   .is_indexed = true,
                                   .is_double_indexed = false,
                                   .num_of_rows = SB_OVSDB_BST_RQE_QUEUE_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_RQE_QUEUE_COLUMNS,
                                   .size = SB_OVSDB_E_RQE_QUEUE_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, rqe),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, rqe),
                                   .default_threshold = BVIEW_BST_E_RQE_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_RQE_POOL,
-                                  .realm_name = "egress-rqe-queue",
-                                  .counter_name  = "rqe-queue-count",
+                                  .realm = BVIEW_BST_EGRESS_RQE_QUEUE,
+                                  .counter = BVIEW_BST_COUNTER_RQE_QUEUE,
                                   .is_indexed = true,
                                   .is_double_indexed = false,
                                   .num_of_rows = SB_OVSDB_BST_RQE_POOL_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_RQE_POOL_COLUMNS,
                                   .size = SB_OVSDB_E_RQE_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, rqeQueueEntries),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, rqeQueueEntries),
                                   .default_threshold = BVIEW_BST_E_RQE_THRES_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_UCAST_GROUP,
-                                  .realm_name = "egress-uc-queue-group",
-                                  .counter_name  = "uc-buffer-count",
+                                  .realm = BVIEW_BST_EGRESS_UC_QUEUEGROUPS,
+                                  .counter = BVIEW_BST_COUNTER_UC_BUFFER,
                                   .is_indexed = true,
                                   .is_double_indexed = false,
                                   .num_of_rows = SB_OVSDB_BST_UCAST_GROUP_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_UCAST_GROUP_COLUMNS,
                                   .size = SB_OVSBD_E_UC_Q_GROUP_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, eUCqGroup),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, eUCqGroup),
                                   .default_threshold = BVIEW_BST_UCAST_QUEUE_GROUP_DEFAULT
                                 },
                                 {
                                   .bid = SB_OVSDB_BST_STAT_ID_CPU_QUEUE, 
-                                  .realm_name = "egress-cpu-queue",
-                                  .counter_name  = "cpu-buffer-count",
+                                  .realm = BVIEW_BST_EGRESS_CPU_QUEUE,
+                                  .counter = BVIEW_BST_COUNTER_CPU_BUFFER,
                                   .is_indexed = true,
                                   .is_double_indexed = false,
                                   .num_of_rows = SB_OVSDB_BST_CPU_QUEUE_ROWS,
                                   .num_of_columns = SB_OVSDB_BST_CPU_QUEUE_COLUMNS,
                                   .size = SB_OVSDB_E_CPU_STAT_SIZE,
-                                  .offset = offsetof (BVIEW_OVSDB_BST_STAT_DB_t, eCPU),
+                                  .offset = offsetof (BVIEW_OVSDB_BST_COUNTER_DB_t, eCPU),
                                   .default_threshold = BVIEW_BST_E_CPU_UCMC_THRES_DEFAULT
                                 },
                               };         
@@ -294,7 +294,7 @@ BVIEW_STATUS bst_bid_port_index_to_ovsdb_key(int asic, int bid,
   SB_OVSDB_BST_STAT_ID_CHECK (bid);
  
   /* ovsdb_key string is of the format <realm>/<name>/<index1>/<index2> */ 
-  strncat(src_string, bid_tab_params[bid].realm_name, src_str_empty_size);
+  strncat(src_string, bst_registry_realm_name_get(bid_tab_params[bid].realm), src_str_empty_size);
 
   src_str_empty_size -= strlen(src_string);
   if (src_str_empty_size < 2)
@@ -304,7 +304,7 @@ BVIEW_STATUS bst_bid_port_index_to_ovsdb_key(int asic, int bid,
 
   
   strcat(src_string, delim);
-  strncat(src_string, bid_tab_params[bid].counter_name, src_str_empty_size);
+  strncat(src_string, bst_registry_counter_name_get(bid_tab_params[bid].counter), src_str_empty_size);
   src_str_empty_size -= strlen(src_string);
   if (src_str_empty_size < 2)
   {
@@ -388,8 +388,7 @@ BVIEW_STATUS bst_ovsdb_threshold_get(int asic, int port, int index,
 {
   BVIEW_STATUS rv;
   int db_index;
-  BVIEW_OVSDB_BID_INFO_t     *p_row = NULL;
-  BVIEW_OVSDB_BID_INFO_t     *p_base = NULL;
+  uint64_t                   *p_base = NULL;
   BVIEW_OVSDB_BST_DATA_t     *p_cache = NULL;
 
   SB_OVSDB_NULLPTR_CHECK (p_threshold, BVIEW_STATUS_INVALID_PARAMETER);
@@ -409,13 +408,9 @@ BVIEW_STATUS bst_ovsdb_threshold_get(int asic, int port, int index,
   /* Acquire read lock*/
   SB_OVSDB_RWLOCK_RD_LOCK(p_cache->lock);
 
-  p_base =  BVIEW_OVSDB_BID_BASE_ADDR (bid, &p_cache->cache[asic]);
+  p_base =  BVIEW_OVSDB_BID_BASE_ADDR (bid, &p_cache->cache[asic].threshold);
 
-  p_row = p_base + db_index;
-  if (p_row)
-  {
-    *p_threshold= p_row->threshold;
-  }
+  *p_threshold = p_base[db_index];
   /* Release lock */
   SB_OVSDB_RWLOCK_UNLOCK(p_cache->lock);
 
@@ -579,8 +574,8 @@ BVIEW_STATUS  bst_ovsdb_trigger_callback (int asic,
 {
   BVIEW_BST_TRIGGER_INFO_t  triggerInfo;
 
-  sprintf (triggerInfo.realm, "%s",bid_tab_params[bid].realm_name);
-  sprintf (triggerInfo.counter, "%s", bid_tab_params[bid].counter_name);
+  triggerInfo.realm = bid_tab_params[bid].realm;
+  triggerInfo.counter = bid_tab_params[bid].counter;
   triggerInfo.port = port;
   triggerInfo.queue = queue;  
   if (trigger_callback)
@@ -671,8 +666,8 @@ void bst_ovsdb_dump_bid_tab_params()
   {
     printf("Table index = %d\n", index);
     printf("BID = %d\n", bid_tab_params[index].bid);
-    printf("Realm = %s\n", bid_tab_params[index].realm_name);
-    printf("Counter name= %s\n", bid_tab_params[index].counter_name);
+    printf("Realm = %s\n", bst_registry_realm_name_get(bid_tab_params[index].realm));
+    printf("Counter name= %s\n", bst_registry_counter_name_get(bid_tab_params[index].counter));
     printf("Is indexed = %s\n", (bid_tab_params[index].is_indexed?"true":"false")); 
     printf("Is Double indexed = %s\n", (bid_tab_params[index].is_double_indexed?"true":"false")); 
   }
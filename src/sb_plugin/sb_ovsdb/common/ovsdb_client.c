@@ -0,0 +1,834 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+
+/* OVSDB includes*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <openvswitch/compiler.h>
+#include <json.h>
+#include <jsonrpc.h>
+#include <latch.h>
+#include <poll-loop.h>
+#include <timeval.h>
+
+/* BroadView Includes*/
+#include "broadview.h"
+#include "sbplugin_ovsdb.h"
+#include "ovsdb_common_ctl.h"
+#include "ovsdb_client.h"
+
+/* slots of the table of requests on the wire, a power of two above
+ * OVSDB_CLIENT_MAX_IN_FLIGHT so a free id is always found */
+#define _CLIENT_SLOTS                (2 * OVSDB_CLIENT_MAX_IN_FLIGHT)
+
+/* period of the scan for requests past their time */
+#define _CLIENT_TICK_MSEC            100
+
+typedef struct _ovsdb_client_req_
+{
+  /* link in the queue, or in the list of requests on the wire */
+  struct _ovsdb_client_req_ *next;
+  struct _ovsdb_client_req_ *prev;
+  char                      *method;
+  struct json               *params;
+  OVSDB_CLIENT_CALLBACK_t   callback;
+  void                      *context;
+  /* JSON-RPC id while on the wire, 0 otherwise */
+  unsigned int              id;
+  unsigned int              sends;
+  /* completion, once it is known */
+  BVIEW_STATUS              status;
+  /* usec of the last send, msec of the time limit */
+  long long int             sentAt;
+  long long int             deadline;
+} _OVSDB_CLIENT_REQ_t;
+
+typedef struct _ovsdb_client_list_
+{
+  _OVSDB_CLIENT_REQ_t *head;
+  _OVSDB_CLIENT_REQ_t *tail;
+  unsigned int        count;
+} _OVSDB_CLIENT_LIST_t;
+
+typedef struct _ovsdb_client_ctrl_
+{
+  pthread_mutex_t      lock;
+  /* signaled when the queue has room */
+  pthread_cond_t       room;
+  /* wakes the client thread */
+  struct latch         wake;
+  bool                 running;
+  pthread_t            thread;
+  /* requests waiting, and on the wire, in order */
+  _OVSDB_CLIENT_LIST_t queue;
+  _OVSDB_CLIENT_LIST_t sent;
+  /* requests on the wire by id */
+  _OVSDB_CLIENT_REQ_t  *slots[_CLIENT_SLOTS];
+  unsigned int         nextId;
+  BVIEW_OVSDB_CLIENT_STATS_t stats;
+} _OVSDB_CLIENT_CTRL_t;
+
+/* completion of a blocking request */
+typedef struct _ovsdb_client_wait_
+{
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
+  bool            done;
+  BVIEW_STATUS    status;
+  struct json     *result;
+} _OVSDB_CLIENT_WAIT_t;
+
+static _OVSDB_CLIENT_CTRL_t ovsdbClient = {
+  .lock = PTHREAD_MUTEX_INITIALIZER,
+  .room = PTHREAD_COND_INITIALIZER,
+};
+
+/*********************************************************************
+* @brief    Append a request to a list.
+*
+*********************************************************************/
+static void _client_list_append (_OVSDB_CLIENT_LIST_t *list,
+                                 _OVSDB_CLIENT_REQ_t *req)
+{
+  req->next = NULL;
+  req->prev = list->tail;
+  if (list->tail)
+  {
+    list->tail->next = req;
+  }
+  else
+  {
+    list->head = req;
+  }
+  list->tail = req;
+  list->count++;
+}
+
+/*********************************************************************
+* @brief    Remove a request from a list.
+*
+*********************************************************************/
+static void _client_list_remove (_OVSDB_CLIENT_LIST_t *list,
+                                 _OVSDB_CLIENT_REQ_t *req)
+{
+  if (req->prev)
+  {
+    req->prev->next = req->next;
+  }
+  else
+  {
+    list->head = req->next;
+  }
+  if (req->next)
+  {
+    req->next->prev = req->prev;
+  }
+  else
+  {
+    list->tail = req->prev;
+  }
+  req->next = req->prev = NULL;
+  list->count--;
+}
+
+/*********************************************************************
+* @brief    Release a request.
+*
+*********************************************************************/
+static void _client_req_free (_OVSDB_CLIENT_REQ_t *req)
+{
+  json_destroy (req->params);
+  free (req->method);
+  free (req);
+}
+
+/*********************************************************************
+* @brief    Run the callbacks of completed requests and release them.
+*
+* @param[in,out] done     -  completed requests, emptied
+*
+* @notes    Called without the lock.
+*
+*********************************************************************/
+static void _client_complete (_OVSDB_CLIENT_LIST_t *done)
+{
+  _OVSDB_CLIENT_REQ_t *req;
+
+  while (NULL != (req = done->head))
+  {
+    _client_list_remove (done, req);
+    if (req->callback)
+    {
+      req->callback (req->context, req->status, NULL);
+    }
+    _client_req_free (req);
+  }
+}
+
+/*********************************************************************
+* @brief    Take a request off the wire.
+*
+* @notes    Called with the lock held.
+*
+*********************************************************************/
+static void _client_unsend_locked (_OVSDB_CLIENT_REQ_t *req)
+{
+  ovsdbClient.slots[req->id & (_CLIENT_SLOTS - 1)] = NULL;
+  req->id = 0;
+  _client_list_remove (&ovsdbClient.sent, req);
+}
+
+/*********************************************************************
+* @brief    Complete the requests past their time.
+*
+* @param[out]  done       -  completed requests
+*
+*********************************************************************/
+static void _client_expire (_OVSDB_CLIENT_LIST_t *done)
+{
+  _OVSDB_CLIENT_REQ_t *req;
+  _OVSDB_CLIENT_REQ_t *next;
+  long long int now = time_msec ();
+  bool dequeued = false;
+
+  pthread_mutex_lock (&ovsdbClient.lock);
+  for (req = ovsdbClient.sent.head; req; req = next)
+  {
+    next = req->next;
+    if (req->deadline <= now)
+    {
+      _client_unsend_locked (req);
+      req->status = BVIEW_STATUS_TIMEOUT;
+      _client_list_append (done, req);
+      ovsdbClient.stats.timeouts++;
+    }
+  }
+  for (req = ovsdbClient.queue.head; req; req = next)
+  {
+    next = req->next;
+    if (req->deadline <= now)
+    {
+      _client_list_remove (&ovsdbClient.queue, req);
+      req->status = BVIEW_STATUS_TIMEOUT;
+      _client_list_append (done, req);
+      ovsdbClient.stats.timeouts++;
+      dequeued = true;
+    }
+  }
+  if (dequeued)
+  {
+    pthread_cond_broadcast (&ovsdbClient.room);
+  }
+  pthread_mutex_unlock (&ovsdbClient.lock);
+
+  if (done->count > 0)
+  {
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+                  "OVSDB client: %u request(s) timed out", done->count);
+  }
+}
+
+/*********************************************************************
+* @brief    Move the waiting requests to the wire.
+*
+* @param[out]  reqs       -  requests to send, in order
+* @param[out]  done       -  requests out of sends
+*
+* @retval   number of requests to send
+*
+*********************************************************************/
+static int _client_dequeue (_OVSDB_CLIENT_REQ_t **reqs,
+                            _OVSDB_CLIENT_LIST_t *done)
+{
+  _OVSDB_CLIENT_REQ_t *req;
+  long long int now = time_usec ();
+  unsigned int id;
+  int numReqs = 0;
+
+  pthread_mutex_lock (&ovsdbClient.lock);
+  while ((NULL != (req = ovsdbClient.queue.head)) &&
+         (ovsdbClient.sent.count < OVSDB_CLIENT_MAX_IN_FLIGHT))
+  {
+    _client_list_remove (&ovsdbClient.queue, req);
+    if (req->sends >= OVSDB_CLIENT_MAX_SENDS)
+    {
+      req->status = BVIEW_STATUS_FAILURE;
+      _client_list_append (done, req);
+      ovsdbClient.stats.failures++;
+      continue;
+    }
+    if (req->sends > 0)
+    {
+      ovsdbClient.stats.replays++;
+    }
+    req->sends++;
+
+    /* ids run on, skipping 0 and the slots still taken */
+    do
+    {
+      id = ++ovsdbClient.nextId;
+    } while ((0 == id) || (NULL != ovsdbClient.slots[id & (_CLIENT_SLOTS - 1)]));
+    ovsdbClient.slots[id & (_CLIENT_SLOTS - 1)] = req;
+    req->id = id;
+    req->sentAt = now;
+    _client_list_append (&ovsdbClient.sent, req);
+    reqs[numReqs++] = req;
+  }
+  if (ovsdbClient.sent.count > ovsdbClient.stats.maxInFlight)
+  {
+    ovsdbClient.stats.maxInFlight = ovsdbClient.sent.count;
+  }
+  if ((numReqs > 0) || (done->count > 0))
+  {
+    pthread_cond_broadcast (&ovsdbClient.room);
+  }
+  pthread_mutex_unlock (&ovsdbClient.lock);
+
+  return numReqs;
+}
+
+/*********************************************************************
+* @brief    Drop the session, the requests on the wire go back to
+*           the head of the queue.
+*
+* @param[in,out] rpc      -  session of the client
+*
+*********************************************************************/
+static void _client_disconnect (struct jsonrpc **rpc)
+{
+  _OVSDB_CLIENT_REQ_t *req;
+
+  jsonrpc_close (*rpc);
+  *rpc = NULL;
+
+  pthread_mutex_lock (&ovsdbClient.lock);
+  SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+                "OVSDB client: session lost, %u request(s) to send again",
+                ovsdbClient.sent.count);
+  while (NULL != (req = ovsdbClient.sent.tail))
+  {
+    _client_unsend_locked (req);
+    req->next = ovsdbClient.queue.head;
+    req->prev = NULL;
+    if (ovsdbClient.queue.head)
+    {
+      ovsdbClient.queue.head->prev = req;
+    }
+    else
+    {
+      ovsdbClient.queue.tail = req;
+    }
+    ovsdbClient.queue.head = req;
+    ovsdbClient.queue.count++;
+  }
+  pthread_mutex_unlock (&ovsdbClient.lock);
+}
+
+/*********************************************************************
+* @brief    Complete a request with its reply.
+*
+* @param[in]   msg        -  reply, or error
+*
+*********************************************************************/
+static void _client_reply (const struct jsonrpc_msg *msg)
+{
+  _OVSDB_CLIENT_REQ_t *req = NULL;
+  long long int latency;
+  unsigned int bucket;
+  unsigned int id;
+
+  if ((NULL == msg->id) || (JSON_INTEGER != msg->id->type))
+  {
+    return;
+  }
+  id = (unsigned int) msg->id->u.integer;
+
+  pthread_mutex_lock (&ovsdbClient.lock);
+  req = ovsdbClient.slots[id & (_CLIENT_SLOTS - 1)];
+  if ((NULL == req) || (req->id != id))
+  {
+    /* reply to a request that timed out */
+    pthread_mutex_unlock (&ovsdbClient.lock);
+    return;
+  }
+  _client_unsend_locked (req);
+
+  latency = time_usec () - req->sentAt;
+  for (bucket = 0; (bucket < OVSDB_CLIENT_LATENCY_BUCKETS - 1) &&
+                   ((latency / 1000) >= (1LL << bucket)); bucket++)
+  {
+    ;
+  }
+  ovsdbClient.stats.latency[bucket]++;
+  ovsdbClient.stats.latencyTotalUsec += latency;
+  if ((uint64_t) latency > ovsdbClient.stats.latencyMaxUsec)
+  {
+    ovsdbClient.stats.latencyMaxUsec = latency;
+  }
+  if (JSONRPC_REPLY == msg->type)
+  {
+    ovsdbClient.stats.replies++;
+    req->status = BVIEW_STATUS_SUCCESS;
+  }
+  else
+  {
+    ovsdbClient.stats.errors++;
+    req->status = BVIEW_STATUS_FAILURE;
+  }
+  pthread_mutex_unlock (&ovsdbClient.lock);
+
+  if (req->callback)
+  {
+    req->callback (req->context, req->status,
+                   (JSONRPC_REPLY == msg->type) ? msg->result : msg->error);
+  }
+  _client_req_free (req);
+}
+
+/*********************************************************************
+* @brief    Read what the ovsdb-server has sent.
+*
+* @param[in,out] rpc      -  session of the client
+*
+*********************************************************************/
+static void _client_receive (struct jsonrpc **rpc)
+{
+  struct jsonrpc_msg *msg;
+  int error;
+
+  while (*rpc)
+  {
+    error = jsonrpc_recv (*rpc, &msg);
+    if (EAGAIN == error)
+    {
+      break;
+    }
+    if (error)
+    {
+      _client_disconnect (rpc);
+      break;
+    }
+
+    if ((JSONRPC_REQUEST == msg->type) && (0 == strcmp (msg->method, "echo")))
+    {
+      /* keep-alive of the ovsdb-server */
+      jsonrpc_send (*rpc, jsonrpc_create_reply (json_clone (msg->params), msg->id));
+    }
+    else if ((JSONRPC_REPLY == msg->type) || (JSONRPC_ERROR == msg->type))
+    {
+      _client_reply (msg);
+    }
+    jsonrpc_msg_destroy (msg);
+  }
+}
+
+/*********************************************************************
+* @brief    Open the session.
+*
+*********************************************************************/
+static struct jsonrpc *_client_open (void)
+{
+  char connectMode[OVSDB_CONFIG_MAX_LINE_LENGTH];
+
+  memset (&connectMode[0], 0, OVSDB_CONFIG_MAX_LINE_LENGTH);
+  strncpy (connectMode, sbplugin_ovsdb_sock_path_get (),
+           OVSDB_CONFIG_MAX_LINE_LENGTH - 1);
+  return open_jsonrpc (connectMode);
+}
+
+/*********************************************************************
+* @brief    Client thread.
+*
+* @notes    Opens the session when there is something to send, sends
+*           the waiting requests as the wire has room, reads the
+*           replies and completes the requests past their time.
+*
+*********************************************************************/
+static void *_client_thread (void *arg)
+{
+  _OVSDB_CLIENT_REQ_t *reqs[OVSDB_CLIENT_MAX_IN_FLIGHT];
+  _OVSDB_CLIENT_LIST_t done;
+  struct jsonrpc_msg *msg;
+  struct jsonrpc *rpc = NULL;
+  long long int backoff = OVSDB_CLIENT_RECONNECT_MIN_MSEC;
+  long long int reconnectAt = 0;
+  long long int nextTick = 0;
+  bool connected = false;
+  bool waiting;
+  int numReqs;
+  int req;
+
+  (void) arg;
+  memset (&done, 0, sizeof (done));
+
+  for (;;)
+  {
+    latch_poll (&ovsdbClient.wake);
+
+    if (time_msec () >= nextTick)
+    {
+      _client_expire (&done);
+      _client_complete (&done);
+      nextTick = time_msec () + _CLIENT_TICK_MSEC;
+    }
+
+    pthread_mutex_lock (&ovsdbClient.lock);
+    waiting = (ovsdbClient.queue.count > 0);
+    pthread_mutex_unlock (&ovsdbClient.lock);
+
+    /* open the session when there is something to send */
+    if ((NULL == rpc) && (waiting) && (time_msec () >= reconnectAt))
+    {
+      rpc = _client_open ();
+      if (NULL == rpc)
+      {
+        SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+                      "OVSDB client: failed to open JSON RPC session, retry in %lld msec",
+                      backoff);
+        reconnectAt = time_msec () + backoff;
+        backoff = ((backoff * 2) < OVSDB_CLIENT_RECONNECT_MAX_MSEC) ?
+                   (backoff * 2) : OVSDB_CLIENT_RECONNECT_MAX_MSEC;
+      }
+      else
+      {
+        pthread_mutex_lock (&ovsdbClient.lock);
+        if (connected)
+        {
+          ovsdbClient.stats.reconnects++;
+        }
+        pthread_mutex_unlock (&ovsdbClient.lock);
+        connected = true;
+        backoff = OVSDB_CLIENT_RECONNECT_MIN_MSEC;
+      }
+    }
+
+    if (rpc)
+    {
+      numReqs = _client_dequeue (reqs, &done);
+      _client_complete (&done);
+      for (req = 0; req < numReqs; req++)
+      {
+        /* the request keeps its parameters for a replay */
+        msg = jsonrpc_create_request (reqs[req]->method,
+                                      json_clone (reqs[req]->params), NULL);
+        json_destroy (msg->id);
+        msg->id = json_integer_create (reqs[req]->id);
+        if (0 != jsonrpc_send (rpc, msg))
+        {
+          _client_disconnect (&rpc);
+          break;
+        }
+      }
+    }
+
+    _client_receive (&rpc);
+
+    if (rpc)
+    {
+      jsonrpc_run (rpc);
+      if (0 != jsonrpc_get_status (rpc))
+      {
+        _client_disconnect (&rpc);
+        continue;
+      }
+      jsonrpc_wait (rpc);
+      jsonrpc_recv_wait (rpc);
+    }
+    else if (waiting)
+    {
+      poll_timer_wait_until (reconnectAt);
+    }
+    latch_wait (&ovsdbClient.wake);
+    poll_timer_wait_until (nextTick);
+    poll_block ();
+  }
+  return NULL;
+}
+
+/*********************************************************************
+* @brief    Start the client thread.
+*
+* @retval   BVIEW_STATUS_SUCCESS if the thread is running
+* @retval   BVIEW_STATUS_FAILURE if it could not be started
+*
+* @notes    The session is opened on the first request, to the socket
+*           of sbplugin_ovsdb_sock_path_get().
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_client_init (void)
+{
+  pthread_mutex_lock (&ovsdbClient.lock);
+  if (ovsdbClient.running)
+  {
+    pthread_mutex_unlock (&ovsdbClient.lock);
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  latch_init (&ovsdbClient.wake);
+  if (0 != pthread_create (&ovsdbClient.thread, NULL, _client_thread, NULL))
+  {
+    latch_destroy (&ovsdbClient.wake);
+    pthread_mutex_unlock (&ovsdbClient.lock);
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR, "Failed to create OVSDB client thread");
+    return BVIEW_STATUS_FAILURE;
+  }
+  ovsdbClient.running = true;
+  pthread_mutex_unlock (&ovsdbClient.lock);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Queue a request.
+*
+* @param[in]   method     -  JSON-RPC method, e.g. "transact"
+* @param[in]   params     -  its parameters, owned by the client from
+*                            now on
+* @param[in]   timeoutMsec - time it has to complete, 0 for the
+*                            default
+* @param[in]   callback   -  completion, may be NULL
+* @param[in]   context    -  passed to the callback
+*
+* @retval   BVIEW_STATUS_SUCCESS if the request is queued, the
+*                                callback is then called once
+* @retval   BVIEW_STATUS_TIMEOUT if the queue stayed full for the time
+* @retval   BVIEW_STATUS_TABLE_FULL if the queue is full and the caller
+*                                is the client thread
+* @retval   BVIEW_STATUS_FAILURE if the client is not running
+*
+* @notes    Waits for room when OVSDB_CLIENT_MAX_QUEUED requests wait.
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_client_request (const char *method, struct json *params,
+                                   unsigned int timeoutMsec,
+                                   OVSDB_CLIENT_CALLBACK_t callback,
+                                   void *context)
+{
+  _OVSDB_CLIENT_REQ_t *req;
+  struct timespec until;
+  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+
+  if ((NULL == method) || (NULL == params))
+  {
+    json_destroy (params);
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  if (0 == timeoutMsec)
+  {
+    timeoutMsec = OVSDB_CLIENT_TIMEOUT_MSEC;
+  }
+
+  req = calloc (1, sizeof (*req));
+  if (NULL != req)
+  {
+    req->method = strdup (method);
+  }
+  if ((NULL == req) || (NULL == req->method))
+  {
+    free (req);
+    json_destroy (params);
+    return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+  }
+  req->params = params;
+  req->callback = callback;
+  req->context = context;
+  req->deadline = time_msec () + timeoutMsec;
+
+  /* the room is waited for on the wall clock of the condition */
+  clock_gettime (CLOCK_REALTIME, &until);
+  until.tv_sec += timeoutMsec / 1000;
+  until.tv_nsec += (timeoutMsec % 1000) * 1000000L;
+  if (until.tv_nsec >= 1000000000L)
+  {
+    until.tv_sec++;
+    until.tv_nsec -= 1000000000L;
+  }
+
+  pthread_mutex_lock (&ovsdbClient.lock);
+  while ((ovsdbClient.running) &&
+         (ovsdbClient.queue.count >= OVSDB_CLIENT_MAX_QUEUED))
+  {
+    if (pthread_equal (pthread_self (), ovsdbClient.thread))
+    {
+      rv = BVIEW_STATUS_TABLE_FULL;
+      break;
+    }
+    if (ETIMEDOUT == pthread_cond_timedwait (&ovsdbClient.room,
+                                             &ovsdbClient.lock, &until))
+    {
+      rv = BVIEW_STATUS_TIMEOUT;
+      break;
+    }
+  }
+  if (!ovsdbClient.running)
+  {
+    rv = BVIEW_STATUS_FAILURE;
+  }
+  if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    _client_list_append (&ovsdbClient.queue, req);
+    ovsdbClient.stats.requests++;
+  }
+  pthread_mutex_unlock (&ovsdbClient.lock);
+
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+                  "OVSDB client: failed to queue %s request (%d)", method, rv);
+    _client_req_free (req);
+    return rv;
+  }
+
+  latch_set (&ovsdbClient.wake);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Completion of a blocking request.
+*
+*********************************************************************/
+static void _client_wait_done (void *context, BVIEW_STATUS status,
+                               const struct json *result)
+{
+  _OVSDB_CLIENT_WAIT_t *wait = context;
+
+  pthread_mutex_lock (&wait->lock);
+  wait->status = status;
+  wait->result = ((BVIEW_STATUS_SUCCESS == status) && (result)) ?
+                  json_clone (result) : NULL;
+  wait->done = true;
+  pthread_cond_signal (&wait->cond);
+  pthread_mutex_unlock (&wait->lock);
+}
+
+/*********************************************************************
+* @brief    Run a "transact" request and wait for its result.
+*
+* @param[in]   params     -  transaction, owned by the client from now on
+* @param[in]   timeoutMsec - time it has to complete, 0 for the default
+* @param[out]  result     -  result of the reply, to be released with
+*                            json_destroy(), NULL on failure
+*
+* @retval   BVIEW_STATUS_SUCCESS on a reply
+* @retval   BVIEW_STATUS_FAILURE on an error reply or a lost request
+* @retval   BVIEW_STATUS_TIMEOUT past the time
+*
+* @notes    Not to be called from a callback.
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_client_transact_block (struct json *params,
+                                          unsigned int timeoutMsec,
+                                          struct json **result)
+{
+  _OVSDB_CLIENT_WAIT_t wait = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+  };
+  BVIEW_STATUS rv;
+
+  if (NULL == result)
+  {
+    json_destroy (params);
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+  *result = NULL;
+
+  rv = ovsdb_client_request ("transact", params, timeoutMsec,
+                             _client_wait_done, &wait);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    return rv;
+  }
+
+  /* the request completes once, on its time at the latest */
+  pthread_mutex_lock (&wait.lock);
+  while (!wait.done)
+  {
+    pthread_cond_wait (&wait.cond, &wait.lock);
+  }
+  pthread_mutex_unlock (&wait.lock);
+
+  *result = wait.result;
+  return wait.status;
+}
+
+/*********************************************************************
+* @brief    Get the counters of the client.
+*
+* @param[out]  stats      -  counters
+*
+* @retval   BVIEW_STATUS_SUCCESS
+* @retval   BVIEW_STATUS_INVALID_PARAMETER for a NULL pointer
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_client_stats_get (BVIEW_OVSDB_CLIENT_STATS_t *stats)
+{
+  SB_OVSDB_NULLPTR_CHECK (stats, BVIEW_STATUS_INVALID_PARAMETER);
+
+  pthread_mutex_lock (&ovsdbClient.lock);
+  *stats = ovsdbClient.stats;
+  stats->queued = ovsdbClient.queue.count;
+  stats->inFlight = ovsdbClient.sent.count;
+  pthread_mutex_unlock (&ovsdbClient.lock);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Dump the counters of the client.
+*
+* @retval   none
+*
+*********************************************************************/
+void ovsdb_client_stats_dump (void)
+{
+  BVIEW_OVSDB_CLIENT_STATS_t stats;
+  int bucket;
+
+  if (BVIEW_STATUS_SUCCESS != ovsdb_client_stats_get (&stats))
+  {
+    return;
+  }
+
+  printf ("OVSDB client: requests %" PRIu64 " -- replies %" PRIu64
+          " -- errors %" PRIu64 " -- timeouts %" PRIu64
+          " -- failures %" PRIu64 "\n",
+          stats.requests, stats.replies, stats.errors,
+          stats.timeouts, stats.failures);
+  printf ("OVSDB client: reconnects %" PRIu64 " -- replays %" PRIu64
+          " -- queued %u -- in flight %u -- most in flight %u\n",
+          stats.reconnects, stats.replays,
+          stats.queued, stats.inFlight, stats.maxInFlight);
+  printf ("OVSDB client: average latency %" PRIu64 " us -- longest %" PRIu64 " us\n",
+          (0 != (stats.replies + stats.errors)) ?
+          (stats.latencyTotalUsec / (stats.replies + stats.errors)) : 0,
+          stats.latencyMaxUsec);
+  for (bucket = 0; bucket < OVSDB_CLIENT_LATENCY_BUCKETS - 1; bucket++)
+  {
+    printf ("  < %5lld ms : %" PRIu64 "\n",
+            1LL << bucket, stats.latency[bucket]);
+  }
+  printf ("  slower     : %" PRIu64 "\n", stats.latency[bucket]);
+}
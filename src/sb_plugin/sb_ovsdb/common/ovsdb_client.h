@@ -0,0 +1,188 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+
+#ifndef INCLUDE_OVSDB_CLIENT_H
+#define INCLUDE_OVSDB_CLIENT_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "broadview.h"
+
+struct json;
+
+/* Shared asynchronous OVSDB client.
+ *
+ * One JSON-RPC session to the ovsdb-server carries the requests of the
+ * whole plugin. Any thread queues a request, the client thread sends it,
+ * keeping at most OVSDB_CLIENT_MAX_IN_FLIGHT on the wire, and matches the
+ * replies through a table keyed by the JSON-RPC id. Every request completes
+ * exactly once, through its callback on the client thread : with its
+ * result, with an error, or on timeout.
+ *
+ * When the session drops the client reopens it, backing off up to
+ * OVSDB_CLIENT_RECONNECT_MAX_MSEC, and sends again, in their order, the
+ * requests left unanswered. A request is sent OVSDB_CLIENT_MAX_SENDS times
+ * at most, so only idempotent requests should be queued.
+ *
+ * The monitor of the BST tables keeps its own session, its updates are a
+ * stream rather than replies.
+ */
+
+/* requests on the wire at most, and waiting to be sent */
+#define OVSDB_CLIENT_MAX_IN_FLIGHT         64
+#define OVSDB_CLIENT_MAX_QUEUED            1024
+
+/* default time a request has to complete, queueing included */
+#define OVSDB_CLIENT_TIMEOUT_MSEC          5000
+
+/* sends of a request at most, replays included */
+#define OVSDB_CLIENT_MAX_SENDS             3
+
+/* first and longest wait between attempts to reopen the session */
+#define OVSDB_CLIENT_RECONNECT_MIN_MSEC    100
+#define OVSDB_CLIENT_RECONNECT_MAX_MSEC    5000
+
+/* latency histogram, bucket n counts replies under 2^n msec, the last
+ * one the slower ones */
+#define OVSDB_CLIENT_LATENCY_BUCKETS       14
+
+/*********************************************************************
+* @brief    Completion of a request.
+*
+* @param[in]   context    -  context given with the request
+* @param[in]   status     -  BVIEW_STATUS_SUCCESS for a reply,
+*                            BVIEW_STATUS_FAILURE for an error reply or
+*                            a request the session could not carry,
+*                            BVIEW_STATUS_TIMEOUT past its time
+* @param[in]   result     -  result, or error, of the reply, NULL
+*                            without one. Valid during the call only.
+*
+* @notes    Runs on the client thread, it must not wait on requests.
+*
+*********************************************************************/
+typedef void (*OVSDB_CLIENT_CALLBACK_t) (void *context, BVIEW_STATUS status,
+                                         const struct json *result);
+
+typedef struct _ovsdb_client_stats_
+{
+  /* requests queued, and answered by a reply or an error */
+  uint64_t requests;
+  uint64_t replies;
+  uint64_t errors;
+  /* requests that ran out of time, or of sends */
+  uint64_t timeouts;
+  uint64_t failures;
+  /* sessions reopened, and requests sent again on them */
+  uint64_t reconnects;
+  uint64_t replays;
+  /* requests waiting, on the wire, and most on the wire */
+  unsigned int queued;
+  unsigned int inFlight;
+  unsigned int maxInFlight;
+  /* time from the send of a request to its reply */
+  uint64_t latencyTotalUsec;
+  uint64_t latencyMaxUsec;
+  uint64_t latency[OVSDB_CLIENT_LATENCY_BUCKETS];
+} BVIEW_OVSDB_CLIENT_STATS_t;
+
+/*********************************************************************
+* @brief    Start the client thread.
+*
+* @retval   BVIEW_STATUS_SUCCESS if the thread is running
+* @retval   BVIEW_STATUS_FAILURE if it could not be started
+*
+* @notes    The session is opened on the first request, to the socket
+*           of sbplugin_ovsdb_sock_path_get().
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_client_init (void);
+
+/*********************************************************************
+* @brief    Queue a request.
+*
+* @param[in]   method     -  JSON-RPC method, e.g. "transact"
+* @param[in]   params     -  its parameters, owned by the client from
+*                            now on
+* @param[in]   timeoutMsec - time it has to complete, 0 for the
+*                            default
+* @param[in]   callback   -  completion, may be NULL
+* @param[in]   context    -  passed to the callback
+*
+* @retval   BVIEW_STATUS_SUCCESS if the request is queued, the
+*                                callback is then called once
+* @retval   BVIEW_STATUS_TIMEOUT if the queue stayed full for the time
+* @retval   BVIEW_STATUS_TABLE_FULL if the queue is full and the caller
+*                                is the client thread
+* @retval   BVIEW_STATUS_FAILURE if the client is not running
+*
+* @notes    Waits for room when OVSDB_CLIENT_MAX_QUEUED requests wait.
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_client_request (const char *method, struct json *params,
+                                   unsigned int timeoutMsec,
+                                   OVSDB_CLIENT_CALLBACK_t callback,
+                                   void *context);
+
+/*********************************************************************
+* @brief    Run a "transact" request and wait for its result.
+*
+* @param[in]   params     -  transaction, owned by the client from now on
+* @param[in]   timeoutMsec - time it has to complete, 0 for the default
+* @param[out]  result     -  result of the reply, to be released with
+*                            json_destroy(), NULL on failure
+*
+* @retval   BVIEW_STATUS_SUCCESS on a reply
+* @retval   BVIEW_STATUS_FAILURE on an error reply or a lost request
+* @retval   BVIEW_STATUS_TIMEOUT past the time
+*
+* @notes    Not to be called from a callback.
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_client_transact_block (struct json *params,
+                                          unsigned int timeoutMsec,
+                                          struct json **result);
+
+/*********************************************************************
+* @brief    Get the counters of the client.
+*
+* @param[out]  stats      -  counters
+*
+* @retval   BVIEW_STATUS_SUCCESS
+* @retval   BVIEW_STATUS_INVALID_PARAMETER for a NULL pointer
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_client_stats_get (BVIEW_OVSDB_CLIENT_STATS_t *stats);
+
+/*********************************************************************
+* @brief    Dump the counters of the client.
+*
+* @retval   none
+*
+*********************************************************************/
+void ovsdb_client_stats_dump (void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,566 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+
+/* OVSDB includes*/
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <openvswitch/compiler.h>
+#include <json.h>
+#include <shash.h>
+
+/* BroadView Includes*/
+#include "broadview.h"
+#include "sbplugin_ovsdb.h"
+#include "ovsdb_client.h"
+#include "ovsdb_txn.h"
+
+/* transactions in flight at most, a power of two */
+#define _TXN_IN_FLIGHT_MAX           64
+
+/* first allocation of a transaction text */
+#define _TXN_INITIAL_SIZE            4096
+
+/* text of a transaction */
+typedef struct _ovsdb_txn_buf_
+{
+  char          *text;
+  size_t        length;
+  size_t        size;
+  unsigned int  numOps;
+} _OVSDB_TXN_BUF_t;
+
+/* a transaction between its closing and its completion */
+typedef struct _ovsdb_txn_flight_
+{
+  unsigned int  numOps;
+  bool          done;
+  bool          ok;
+} _OVSDB_TXN_FLIGHT_t;
+
+typedef struct _ovsdb_txn_ctrl_
+{
+  pthread_mutex_t  lock;
+  /* wakes the committer, and the waiting commits */
+  pthread_cond_t   work;
+  pthread_cond_t   done;
+  bool             running;
+  /* transaction being filled, and the time it goes out at the latest */
+  _OVSDB_TXN_BUF_t pending;
+  struct timespec  deadline;
+  bool             flushNow;
+  /* transactions closed, and completed with all those before them,
+   * numbered from 1 in order */
+  uint64_t         closedSeq;
+  uint64_t         doneSeq;
+  /* transactions by sequence, an entry is reused a ring later */
+  _OVSDB_TXN_FLIGHT_t flight[_TXN_IN_FLIGHT_MAX];
+  BVIEW_OVSDB_TXN_STATS_t stats;
+  pthread_t        thread;
+} _OVSDB_TXN_CTRL_t;
+
+static _OVSDB_TXN_CTRL_t ovsdbTxn = {
+  .lock = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/*********************************************************************
+* @brief    Monotonic time, msec from now.
+*
+*********************************************************************/
+static void _txn_time_get (struct timespec *ts, long msec)
+{
+  clock_gettime (CLOCK_MONOTONIC, ts);
+  ts->tv_sec += msec / 1000;
+  ts->tv_nsec += (msec % 1000) * 1000000L;
+  if (ts->tv_nsec >= 1000000000L)
+  {
+    ts->tv_sec++;
+    ts->tv_nsec -= 1000000000L;
+  }
+}
+
+/*********************************************************************
+* @brief    Tells if a monotonic time has passed.
+*
+*********************************************************************/
+static bool _txn_time_passed (const struct timespec *ts)
+{
+  struct timespec now;
+
+  clock_gettime (CLOCK_MONOTONIC, &now);
+  return ((now.tv_sec > ts->tv_sec) ||
+          ((now.tv_sec == ts->tv_sec) && (now.tv_nsec >= ts->tv_nsec)));
+}
+
+/*********************************************************************
+* @brief    Complete a transaction.
+*
+* @param[in]   seq        -  its sequence
+* @param[in]   answered   -  the ovsdb-server replied
+* @param[in]   ok         -  every operation succeeded
+*
+* @notes    Called with the lock held.
+*
+*********************************************************************/
+static void _txn_done_locked (uint64_t seq, bool answered, bool ok)
+{
+  _OVSDB_TXN_FLIGHT_t *flight = &ovsdbTxn.flight[seq & (_TXN_IN_FLIGHT_MAX - 1)];
+
+  flight->done = true;
+  flight->ok = ok;
+
+  if (answered)
+  {
+    ovsdbTxn.stats.replies++;
+  }
+  if (!ok)
+  {
+    ovsdbTxn.stats.failedTransactions++;
+    ovsdbTxn.stats.failedOps += flight->numOps;
+  }
+
+  while ((ovsdbTxn.doneSeq < ovsdbTxn.closedSeq) &&
+         (ovsdbTxn.flight[(ovsdbTxn.doneSeq + 1) & (_TXN_IN_FLIGHT_MAX - 1)].done))
+  {
+    ovsdbTxn.doneSeq++;
+  }
+  pthread_cond_broadcast (&ovsdbTxn.done);
+  pthread_cond_signal (&ovsdbTxn.work);
+}
+
+/*********************************************************************
+* @brief    Check the operation results of a "transact" reply.
+*
+* @param[in]   result     -  result array of the reply
+*
+* @retval   true if every operation succeeded
+*
+* @notes    OVSDB applies the operations of a transaction together,
+*           one error aborts them all.
+*
+*********************************************************************/
+static bool _txn_result_check (const struct json *result)
+{
+  const struct json *error;
+  const struct json *details;
+  size_t elem;
+
+  if ((NULL == result) || (JSON_ARRAY != result->type))
+  {
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR, "OVSDB transaction: malformed reply");
+    return false;
+  }
+
+  for (elem = 0; elem < result->u.array.n; elem++)
+  {
+    if (JSON_OBJECT != result->u.array.elems[elem]->type)
+    {
+      continue;
+    }
+    error = shash_find_data (json_object (result->u.array.elems[elem]), "error");
+    if (NULL == error)
+    {
+      continue;
+    }
+    details = shash_find_data (json_object (result->u.array.elems[elem]), "details");
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+                  "OVSDB transaction: operation %u failed, %s %s",
+                  (unsigned int) elem,
+                  (JSON_STRING == error->type) ? error->u.string : "",
+                  ((details) && (JSON_STRING == details->type)) ? details->u.string : "");
+    return false;
+  }
+  return true;
+}
+
+/*********************************************************************
+* @brief    Completion of a transaction by the OVSDB client.
+*
+* @param[in]   context    -  sequence of the transaction
+* @param[in]   status     -  completion of the request
+* @param[in]   result     -  result of the reply
+*
+*********************************************************************/
+static void _txn_reply (void *context, BVIEW_STATUS status,
+                        const struct json *result)
+{
+  uint64_t seq = (uint64_t) (uintptr_t) context;
+  bool ok;
+
+  if (BVIEW_STATUS_SUCCESS == status)
+  {
+    ok = _txn_result_check (result);
+  }
+  else
+  {
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+                  "OVSDB transaction: %s",
+                  (BVIEW_STATUS_TIMEOUT == status) ? "no reply in time" : "request failed");
+    ok = false;
+  }
+
+  pthread_mutex_lock (&ovsdbTxn.lock);
+  _txn_done_locked (seq, (NULL != result), ok);
+  pthread_mutex_unlock (&ovsdbTxn.lock);
+}
+
+/*********************************************************************
+* @brief    Hand a closed transaction to the OVSDB client.
+*
+* @param[in]     txn      -  transaction, its text is released
+* @param[in]     seq      -  its sequence
+*
+*********************************************************************/
+static void _txn_send (_OVSDB_TXN_BUF_t *txn, uint64_t seq)
+{
+  struct json *transaction;
+  BVIEW_STATUS rv;
+
+  txn->text[txn->length++] = ']';
+  txn->text[txn->length] = '\0';
+  transaction = json_from_string (txn->text);
+  free (txn->text);
+  txn->text = NULL;
+
+  if (JSON_STRING == transaction->type)
+  {
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
+                  "OVSDB transaction: dropping malformed transaction, %s",
+                  transaction->u.string);
+    json_destroy (transaction);
+    pthread_mutex_lock (&ovsdbTxn.lock);
+    _txn_done_locked (seq, false, false);
+    pthread_mutex_unlock (&ovsdbTxn.lock);
+    return;
+  }
+
+  rv = ovsdb_client_request ("transact", transaction, 0,
+                             _txn_reply, (void *) (uintptr_t) seq);
+
+  pthread_mutex_lock (&ovsdbTxn.lock);
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    _txn_done_locked (seq, false, false);
+  }
+  else
+  {
+    ovsdbTxn.stats.transactions++;
+    if (txn->numOps > ovsdbTxn.stats.maxOps)
+    {
+      ovsdbTxn.stats.maxOps = txn->numOps;
+    }
+  }
+  pthread_mutex_unlock (&ovsdbTxn.lock);
+}
+
+/*********************************************************************
+* @brief    Committer thread.
+*
+* @notes    Closes the pending transaction when it is due and hands it
+*           to the OVSDB client, holding back while _TXN_IN_FLIGHT_MAX
+*           transactions are not completed.
+*
+*********************************************************************/
+static void *_txn_committer (void *arg)
+{
+  _OVSDB_TXN_BUF_t txn;
+  uint64_t seq;
+  bool room;
+
+  (void) arg;
+
+  pthread_mutex_lock (&ovsdbTxn.lock);
+  for (;;)
+  {
+    room = ((ovsdbTxn.closedSeq - ovsdbTxn.doneSeq) < _TXN_IN_FLIGHT_MAX);
+    if ((ovsdbTxn.pending.numOps > 0) && (room) &&
+        ((ovsdbTxn.flushNow) || (_txn_time_passed (&ovsdbTxn.deadline))))
+    {
+      /* close the pending transaction */
+      txn = ovsdbTxn.pending;
+      memset (&ovsdbTxn.pending, 0, sizeof (ovsdbTxn.pending));
+      ovsdbTxn.flushNow = false;
+      seq = ++ovsdbTxn.closedSeq;
+      ovsdbTxn.flight[seq & (_TXN_IN_FLIGHT_MAX - 1)] =
+                 (_OVSDB_TXN_FLIGHT_t) { .numOps = txn.numOps };
+      pthread_mutex_unlock (&ovsdbTxn.lock);
+
+      _txn_send (&txn, seq);
+
+      pthread_mutex_lock (&ovsdbTxn.lock);
+      continue;
+    }
+
+    /* sleep until an operation comes, is due, or room is made */
+    if ((0 == ovsdbTxn.pending.numOps) || (!room))
+    {
+      pthread_cond_wait (&ovsdbTxn.work, &ovsdbTxn.lock);
+    }
+    else
+    {
+      pthread_cond_timedwait (&ovsdbTxn.work, &ovsdbTxn.lock,
+                              &ovsdbTxn.deadline);
+    }
+  }
+  pthread_mutex_unlock (&ovsdbTxn.lock);
+  return NULL;
+}
+
+/*********************************************************************
+* @brief    Start the committer thread.
+*
+* @retval   BVIEW_STATUS_SUCCESS if the thread is running
+* @retval   BVIEW_STATUS_FAILURE if it could not be started
+*
+* @notes    The transactions go through the shared OVSDB client,
+*           started here if it is not yet.
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_txn_init (void)
+{
+  pthread_condattr_t attr;
+
+  if (BVIEW_STATUS_SUCCESS != ovsdb_client_init ())
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  pthread_mutex_lock (&ovsdbTxn.lock);
+  if (ovsdbTxn.running)
+  {
+    pthread_mutex_unlock (&ovsdbTxn.lock);
+    return BVIEW_STATUS_SUCCESS;
+  }
+
+  /* the deadlines are monotonic */
+  pthread_condattr_init (&attr);
+  pthread_condattr_setclock (&attr, CLOCK_MONOTONIC);
+  pthread_cond_init (&ovsdbTxn.work, &attr);
+  pthread_cond_init (&ovsdbTxn.done, &attr);
+  pthread_condattr_destroy (&attr);
+
+  if (0 != pthread_create (&ovsdbTxn.thread, NULL, _txn_committer, NULL))
+  {
+    pthread_mutex_unlock (&ovsdbTxn.lock);
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR, "Failed to create OVSDB transaction thread");
+    return BVIEW_STATUS_FAILURE;
+  }
+  ovsdbTxn.running = true;
+  pthread_mutex_unlock (&ovsdbTxn.lock);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Add one operation to the pending transaction.
+*
+* @param[in]   format     -  printf format of the operation object,
+*                            e.g. {"op":"update","table":...}
+*
+* @retval   BVIEW_STATUS_SUCCESS if the operation is queued
+* @retval   BVIEW_STATUS_FAILURE if the committer is not running
+* @retval   BVIEW_STATUS_RESOURCE_NOT_AVAILABLE if memory is exhausted
+*
+* @notes    Operations are sent in the order they are added.
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_txn_op_add (const char *format, ...)
+{
+  _OVSDB_TXN_BUF_t *pending = &ovsdbTxn.pending;
+  va_list args;
+  size_t need;
+  size_t size;
+  char *text;
+  int length;
+
+  va_start (args, format);
+  length = vsnprintf (NULL, 0, format, args);
+  va_end (args);
+  if (length < 0)
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  pthread_mutex_lock (&ovsdbTxn.lock);
+  if (!ovsdbTxn.running)
+  {
+    pthread_mutex_unlock (&ovsdbTxn.lock);
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  /* database name, separator, operation, closing bracket and NUL */
+  need = pending->length + sizeof (OVSDB_TXN_DATABASE) + length + 8;
+  if (need > pending->size)
+  {
+    size = (pending->size) ? pending->size : _TXN_INITIAL_SIZE;
+    while (size < need)
+    {
+      size *= 2;
+    }
+    text = realloc (pending->text, size);
+    if (NULL == text)
+    {
+      pthread_mutex_unlock (&ovsdbTxn.lock);
+      SB_OVSDB_LOG (BVIEW_LOG_ERROR, "OVSDB transaction: out of memory");
+      return BVIEW_STATUS_RESOURCE_NOT_AVAILABLE;
+    }
+    pending->text = text;
+    pending->size = size;
+  }
+
+  if (0 == pending->numOps)
+  {
+    pending->length = sprintf (pending->text, "[\"%s\"", OVSDB_TXN_DATABASE);
+    _txn_time_get (&ovsdbTxn.deadline, OVSDB_TXN_FLUSH_DELAY_MSEC);
+    pthread_cond_signal (&ovsdbTxn.work);
+  }
+  pending->text[pending->length++] = ',';
+  va_start (args, format);
+  vsnprintf (pending->text + pending->length, pending->size - pending->length,
+             format, args);
+  va_end (args);
+  pending->length += length;
+  pending->numOps++;
+  ovsdbTxn.stats.ops++;
+
+  if ((pending->numOps >= OVSDB_TXN_MAX_OPS) ||
+      (pending->length >= OVSDB_TXN_MAX_LENGTH))
+  {
+    ovsdbTxn.flushNow = true;
+    pthread_cond_signal (&ovsdbTxn.work);
+  }
+  pthread_mutex_unlock (&ovsdbTxn.lock);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Send the pending transaction now.
+*
+* @param[in]   wait       -  wait for the reply of the ovsdb-server
+*
+* @retval   BVIEW_STATUS_SUCCESS if the transaction is sent, and when
+*                                waiting, every operation succeeded
+* @retval   BVIEW_STATUS_FAILURE if an operation failed, the
+*                                transaction could not be sent or
+*                                was not answered in time
+*
+* @notes    With nothing pending, waits for the last transaction.
+*           Earlier transactions report their failures to the log
+*           and the counters only.
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_txn_commit (bool wait)
+{
+  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+  struct timespec deadline;
+  uint64_t target;
+
+  pthread_mutex_lock (&ovsdbTxn.lock);
+  if (!ovsdbTxn.running)
+  {
+    pthread_mutex_unlock (&ovsdbTxn.lock);
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  /* the pending transaction is the next one closed */
+  target = ovsdbTxn.closedSeq;
+  if (ovsdbTxn.pending.numOps > 0)
+  {
+    target++;
+    ovsdbTxn.flushNow = true;
+    pthread_cond_signal (&ovsdbTxn.work);
+  }
+
+  if ((wait) && (target > 0))
+  {
+    _txn_time_get (&deadline, OVSDB_TXN_REPLY_TIMEOUT_SEC * 1000L);
+    while (ovsdbTxn.doneSeq < target)
+    {
+      if (ETIMEDOUT == pthread_cond_timedwait (&ovsdbTxn.done, &ovsdbTxn.lock,
+                                               &deadline))
+      {
+        break;
+      }
+    }
+
+    if (ovsdbTxn.doneSeq < target)
+    {
+      SB_OVSDB_LOG (BVIEW_LOG_ERROR, "OVSDB transaction: timed out waiting for reply");
+      rv = BVIEW_STATUS_FAILURE;
+    }
+    else if (((ovsdbTxn.closedSeq - target) < _TXN_IN_FLIGHT_MAX) &&
+             (!ovsdbTxn.flight[target & (_TXN_IN_FLIGHT_MAX - 1)].ok))
+    {
+      rv = BVIEW_STATUS_FAILURE;
+    }
+  }
+  pthread_mutex_unlock (&ovsdbTxn.lock);
+
+  return rv;
+}
+
+/*********************************************************************
+* @brief    Get the counters of the committer.
+*
+* @param[out]  stats      -  counters
+*
+* @retval   BVIEW_STATUS_SUCCESS
+* @retval   BVIEW_STATUS_INVALID_PARAMETER for a NULL pointer
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_txn_stats_get (BVIEW_OVSDB_TXN_STATS_t *stats)
+{
+  SB_OVSDB_NULLPTR_CHECK (stats, BVIEW_STATUS_INVALID_PARAMETER);
+
+  pthread_mutex_lock (&ovsdbTxn.lock);
+  *stats = ovsdbTxn.stats;
+  pthread_mutex_unlock (&ovsdbTxn.lock);
+
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief    Dump the counters of the committer.
+*
+* @retval   none
+*
+*********************************************************************/
+void ovsdb_txn_stats_dump (void)
+{
+  BVIEW_OVSDB_TXN_STATS_t stats;
+
+  if (BVIEW_STATUS_SUCCESS != ovsdb_txn_stats_get (&stats))
+  {
+    return;
+  }
+
+  printf ("OVSDB transactions: ops %" PRIu64 " -- transactions %" PRIu64
+          " -- replies %" PRIu64 " -- most ops %u\n",
+          stats.ops, stats.transactions, stats.replies, stats.maxOps);
+  printf ("OVSDB transactions: failed ops %" PRIu64
+          " -- failed transactions %" PRIu64 "\n",
+          stats.failedOps, stats.failedTransactions);
+}
@@ -0,0 +1,139 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+
+#ifndef INCLUDE_OVSDB_TXN_H
+#define INCLUDE_OVSDB_TXN_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "broadview.h"
+
+/* Batched OVSDB transactions.
+ *
+ * The commit functions of the plugin do not send their updates one by one :
+ * they add the operations they need to a pending transaction, and a
+ * committer thread hands it to the shared OVSDB client (ovsdb_client.h) as a
+ * single "transact" to the "OpenSwitch" database. The transaction goes out
+ * when it holds OVSDB_TXN_MAX_OPS operations or OVSDB_TXN_MAX_LENGTH bytes,
+ * OVSDB_TXN_FLUSH_DELAY_MSEC after its first operation, or when a caller
+ * commits it. Every operation result of the reply is checked, so a rejected
+ * row is logged and counted rather than lost.
+ */
+
+/* database every transaction goes to */
+#define OVSDB_TXN_DATABASE                 "OpenSwitch"
+
+/* most operations, and most bytes of text, in one transaction */
+#define OVSDB_TXN_MAX_OPS                  4096
+#define OVSDB_TXN_MAX_LENGTH               (1024 * 1024)
+
+/* time the first operation of a transaction waits for more */
+#define OVSDB_TXN_FLUSH_DELAY_MSEC         20
+
+/* time a waiting commit gives its transaction, the client queueing and
+ * timing out its request within it */
+#define OVSDB_TXN_REPLY_TIMEOUT_SEC        10
+
+typedef struct _ovsdb_txn_stats_
+{
+  /* operations added */
+  uint64_t ops;
+  /* transactions sent, and answered */
+  uint64_t transactions;
+  uint64_t replies;
+  /* operations the ovsdb-server refused */
+  uint64_t failedOps;
+  /* transactions not sent, refused or not answered */
+  uint64_t failedTransactions;
+  /* most operations in one transaction */
+  unsigned int maxOps;
+} BVIEW_OVSDB_TXN_STATS_t;
+
+/*********************************************************************
+* @brief    Start the committer thread.
+*
+* @retval   BVIEW_STATUS_SUCCESS if the thread is running
+* @retval   BVIEW_STATUS_FAILURE if it could not be started
+*
+* @notes    The transactions go through the shared OVSDB client,
+*           started here if it is not yet.
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_txn_init (void);
+
+/*********************************************************************
+* @brief    Add one operation to the pending transaction.
+*
+* @param[in]   format     -  printf format of the operation object,
+*                            e.g. {"op":"update","table":...}
+*
+* @retval   BVIEW_STATUS_SUCCESS if the operation is queued
+* @retval   BVIEW_STATUS_FAILURE if the committer is not running
+* @retval   BVIEW_STATUS_RESOURCE_NOT_AVAILABLE if memory is exhausted
+*
+* @notes    Operations are sent in the order they are added.
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_txn_op_add (const char *format, ...)
+                               __attribute__ ((format (printf, 1, 2)));
+
+/*********************************************************************
+* @brief    Send the pending transaction now.
+*
+* @param[in]   wait       -  wait for the reply of the ovsdb-server
+*
+* @retval   BVIEW_STATUS_SUCCESS if the transaction is sent, and when
+*                                waiting, every operation succeeded
+* @retval   BVIEW_STATUS_FAILURE if an operation failed, the
+*                                transaction could not be sent or
+*                                was not answered in time
+*
+* @notes    With nothing pending, waits for the last transaction.
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_txn_commit (bool wait);
+
+/*********************************************************************
+* @brief    Get the counters of the committer.
+*
+* @param[out]  stats      -  counters
+*
+* @retval   BVIEW_STATUS_SUCCESS
+* @retval   BVIEW_STATUS_INVALID_PARAMETER for a NULL pointer
+*
+*********************************************************************/
+BVIEW_STATUS ovsdb_txn_stats_get (BVIEW_OVSDB_TXN_STATS_t *stats);
+
+/*********************************************************************
+* @brief    Dump the counters of the committer.
+*
+* @retval   none
+*
+*********************************************************************/
+void ovsdb_txn_stats_dump (void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
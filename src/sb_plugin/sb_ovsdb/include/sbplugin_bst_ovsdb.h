@@ -21,6 +21,7 @@
 
 #include "broadview.h"
 #include "sbplugin.h"
+#include "bst_registry.h"
 #include "sbplugin_bst_map.h"
 #include "sbplugin_bst_cache.h"
 
@@ -28,21 +29,24 @@
 typedef struct _bst_ovsdb_bid_params_
 {
   int      bid;                 /* bid number */
-  char     *realm_name;         /* Realm name */
-  char     *counter_name;       /* counter name */
+  BVIEW_BST_REALM_ID_t   realm;     /* Realm, registry id */
+  BVIEW_BST_COUNTER_ID_t counter;   /* counter, registry id */
   bool     is_indexed;          /* Is it asingle indexed array */
   bool     is_double_indexed;   /* BID table is double indexed/not */
   int      num_of_rows;         /* Number of rows*/
   int      num_of_columns;      /* Number of columns*/
   int      size;                /* size of database for BID */
-  size_t   offset;              /* offset to BID database */
+  size_t   offset;              /* offset to BID database, in the counters */
   uint64_t default_threshold;   /* default threshold */
 } BVIEW_BST_OVSDB_BID_PARAMS_t;
 
 
-/* Get base address of Database for BID */
-#define   BVIEW_OVSDB_BID_BASE_ADDR(_bid, _p)  (BVIEW_OVSDB_BID_INFO_t *)((char *) _p + \
-                                                 bid_tab_params[_bid].offset);
+/* Get base address of Database for BID, in a BVIEW_OVSDB_BST_COUNTER_DB_t */
+#define   BVIEW_OVSDB_BID_BASE_ADDR(_bid, _p)  (uint64_t *)((char *) (_p) + \
+                                                 bid_tab_params[_bid].offset)
+
+/* Get first counter of BID in the cache arrays */
+#define   BVIEW_OVSDB_BID_BASE_INDEX(_bid)     (bid_tab_params[_bid].offset / sizeof (uint64_t))
 
 
 /* Macro to acquire read lock */
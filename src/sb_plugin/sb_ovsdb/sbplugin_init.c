@@ -22,6 +22,7 @@
 #include "sbplugin_system_map.h"
 #include "sbplugin_ovsdb.h"
 #include "sb_redirector_api.h"
+#include "ovsdb_client.h"
 
 /* BST feature data structure*/
 static BVIEW_SB_BST_FEATURE_t       ovsdbBstFeat;
@@ -58,6 +59,14 @@ BVIEW_STATUS  sbplugin_common_init (char *ovsdb_sock)
     SB_OVSDB_DEBUG_PRINT ("Failed to set OVSDB socket path");
     return rv;
   }
+
+  /* Start the OVSDB client shared by the features */
+  rv = ovsdb_client_init ();
+  if (rv != BVIEW_STATUS_SUCCESS)
+  {
+    SB_OVSDB_DEBUG_PRINT ("Failed to start OVSDB client");
+    return rv;
+  }
  
   /* Init SYSTEM feature*/
   rv = sbplugin_ovsdb_system_init (&ovsdbSystemFeat);
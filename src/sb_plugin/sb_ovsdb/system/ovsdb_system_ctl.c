@@ -30,6 +30,7 @@
 #include "broadview.h"
 #include "sbplugin_ovsdb.h"
 #include "ovsdb_common_ctl.h"
+#include "ovsdb_client.h"
 #include "ovsdb_system_ctl.h"
 
 #define   SYSTEM_OVSDB_ASIC_INFO_JSON    "[\"OpenSwitch\",{\"op\":\"select\",\"table\":\"Subsystem\",\"where\":[], \"columns\": [\"other_info\"]}]"
@@ -54,69 +55,49 @@ BVIEW_STATUS system_ovsdb_common_get_asicinfo (int asic , unsigned int *numports
   struct json *rows, *other_info, *cur_cfg;
   char   s_transact[1024] = {0};
   char   s_transact1[1024] = {0};
-  struct json *transaction;
-  struct jsonrpc_msg *request, *request_cur_cfg, *reply, *reply_cur_cfg;
-  struct jsonrpc *rpc;
+  struct json *reply = NULL;
+  struct json *reply_cur_cfg = NULL;
   struct json *json_data = NULL;
   struct json *json_data1 = NULL;
   struct json *map = NULL, *array = NULL, *sub_array = NULL;
   struct json *key = NULL;
   struct json *value = NULL;
-  char connectMode[OVSDB_CONFIG_MAX_LINE_LENGTH];
-  const char *sock_path;
   bool repeat = false;
   int current_config_val = 0;
+  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
 
   /* NULL Pointer validation */
   SB_OVSDB_NULLPTR_CHECK (numports, BVIEW_STATUS_INVALID_PARAMETER);
 
-  sock_path = sbplugin_ovsdb_sock_path_get();
-  memset (&connectMode[0], 0, OVSDB_CONFIG_MAX_LINE_LENGTH);
-  strncpy(connectMode, sock_path, OVSDB_CONFIG_MAX_LINE_LENGTH-1);
-  rpc = open_jsonrpc (connectMode);
-  if (rpc == NULL)
-  { 
-    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-                 "System config commit:Failed to open JSNON RPC session");
-    return BVIEW_STATUS_FAILURE;
-  }
-
   /* create JSON request to get cur_cfg*/
   repeat = true;
   while (repeat)
   {
     BVIEW_OVSDB_FORM_CONFIG_JSON (s_transact1, SYSTEM_OVSDB_CUR_CFG_INFO_JSON);
 
-    transaction = json_from_string(s_transact1);
-    request_cur_cfg = jsonrpc_create_request("transact", transaction, NULL);
-    check_txn(jsonrpc_transact_block(rpc, request_cur_cfg, &reply_cur_cfg),&reply_cur_cfg);
-
-
-    /* NULL pointer validation */
-    SB_OVSDB_NULLPTR_CHECK (reply_cur_cfg, BVIEW_STATUS_INVALID_PARAMETER);
-
-    SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-	"\r\nJSON message type %d \r\n", reply_cur_cfg->type);
-
-    if (reply_cur_cfg->type != JSONRPC_REPLY)
+    rv = ovsdb_client_transact_block (json_from_string(s_transact1), 0,
+                                      &reply_cur_cfg);
+    if (rv != BVIEW_STATUS_SUCCESS)
     {
       SB_OVSDB_LOG (BVIEW_LOG_ERROR,
-	  "JSON is not reply message ");
-
+	  "Failed to read cur_cfg (%d) ", rv);
+      sleep(1);
       continue;
     }
-    json_data = reply_cur_cfg->result->u.array.elems[0];
-    SB_OVSDB_NULLPTR_CHECK (json_data, BVIEW_STATUS_INVALID_PARAMETER);
 
-    if (json_data->type != JSON_OBJECT ||
+    json_data = (JSON_ARRAY == reply_cur_cfg->type && reply_cur_cfg->u.array.n > 0) ?
+                 reply_cur_cfg->u.array.elems[0] : NULL;
+    if (json_data == NULL || json_data->type != JSON_OBJECT ||
 	!(rows = shash_find_data(json_object(json_data), "rows"))
 	|| rows->type != JSON_ARRAY) {
       SB_OVSDB_LOG (BVIEW_LOG_ERROR, "reply is not an object with a \"rows\" \r\n");
+      json_destroy (reply_cur_cfg);
       return BVIEW_STATUS_FAILURE;
     }
 
-    if (0 == json_array(rows)->n_allocated)
+    if (0 == json_array(rows)->n)
     {
+      json_destroy (reply_cur_cfg);
       sleep(1);
       continue;
     }
@@ -127,9 +108,11 @@ BVIEW_STATUS system_ovsdb_common_get_asicinfo (int asic , unsigned int *numports
 	!(cur_cfg = shash_find_data(json_object(json_data1), "cur_cfg"))
 	|| cur_cfg->type != JSON_INTEGER) {
       SB_OVSDB_LOG (BVIEW_LOG_ERROR, " reply is not an object with a \"cur_cfg\" \r\n");
+      json_destroy (reply_cur_cfg);
       return BVIEW_STATUS_FAILURE;
     }
     current_config_val = cur_cfg->u.integer;
+    json_destroy (reply_cur_cfg);
     repeat = false;
     if (!current_config_val)
     {
@@ -141,23 +124,21 @@ BVIEW_STATUS system_ovsdb_common_get_asicinfo (int asic , unsigned int *numports
   /* Create JSON request*/ 
   BVIEW_OVSDB_FORM_CONFIG_JSON (s_transact, SYSTEM_OVSDB_ASIC_INFO_JSON);
 
-  transaction = json_from_string(s_transact);
-  request = jsonrpc_create_request("transact", transaction, NULL);
-  memset (&connectMode[0], 0, OVSDB_CONFIG_MAX_LINE_LENGTH);
-  strncpy(connectMode, sock_path, OVSDB_CONFIG_MAX_LINE_LENGTH-1);
-  check_txn(jsonrpc_transact_block(rpc, request, &reply),&reply);
-
-
-  /* NULL pointer validation */
-  SB_OVSDB_NULLPTR_CHECK (reply, BVIEW_STATUS_INVALID_PARAMETER);
+  rv = ovsdb_client_transact_block (json_from_string(s_transact), 0, &reply);
+  if (rv != BVIEW_STATUS_SUCCESS)
+  {
+    SB_OVSDB_LOG (BVIEW_LOG_ERROR, "Failed to read asic info (%d) ", rv);
+    return rv;
+  }
 
-  json_data = reply->result->u.array.elems[0];
-  SB_OVSDB_NULLPTR_CHECK (json_data, BVIEW_STATUS_INVALID_PARAMETER);
+  json_data = (JSON_ARRAY == reply->type && reply->u.array.n > 0) ?
+               reply->u.array.elems[0] : NULL;
 
-  if (json_data->type != JSON_OBJECT ||
+  if (json_data == NULL || json_data->type != JSON_OBJECT ||
       !(rows = shash_find_data(json_object(json_data), "rows"))
-      || rows->type != JSON_ARRAY) {
+      || rows->type != JSON_ARRAY || 0 == rows->u.array.n) {
     SB_OVSDB_LOG (BVIEW_LOG_ERROR, "reply is not an object with a \"rows\" \r\n");
+    json_destroy (reply);
     return BVIEW_STATUS_FAILURE;
   }
 
@@ -169,6 +150,7 @@ BVIEW_STATUS system_ovsdb_common_get_asicinfo (int asic , unsigned int *numports
 
       || other_info->type != JSON_ARRAY) {
     SB_OVSDB_LOG (BVIEW_LOG_ERROR, " reply is not an object with a \"other_info\" \r\n");
+    json_destroy (reply);
     return BVIEW_STATUS_FAILURE;
   }
 
@@ -177,15 +159,17 @@ BVIEW_STATUS system_ovsdb_common_get_asicinfo (int asic , unsigned int *numports
   if ((strcmp ("map",map->u.string) != 0) ||
       (array->type != JSON_ARRAY))
   {
+    json_destroy (reply);
     return BVIEW_STATUS_FAILURE;
   }
 
 
-  for (elem = 0; elem < json_array(array)->n_allocated; elem++)
+  for (elem = 0; elem < json_array(array)->n; elem++)
   {
     sub_array = json_array (array)->elems[elem];
     if (JSON_ARRAY != sub_array->type)
     {
+      json_destroy (reply);
       return BVIEW_STATUS_FAILURE;
     }
     key = json_array (sub_array)->elems[0];
@@ -203,9 +187,6 @@ BVIEW_STATUS system_ovsdb_common_get_asicinfo (int asic , unsigned int *numports
     }
   }
 
-  jsonrpc_msg_destroy(reply);
-  jsonrpc_msg_destroy(reply_cur_cfg);
-  jsonrpc_close(rpc);
+  json_destroy (reply);
   return BVIEW_STATUS_SUCCESS;
 }
-
@@ -152,6 +152,9 @@ BVIEW_STATUS sbapi_bst_config_set (int asic, BVIEW_BST_CONFIG_t * config)
 *
 * @retval   BVIEW_STATUS_SUCCESS      BST snapshot get is successful 
 *
+* @retval   BVIEW_STATUS_NOTREADY     BST snapshot holds the last data of
+*                                     a south bound out of sync
+*
 * @retval   BVIEW_STATUS_UNSUPPORTED  BST snapshot get functionality is 
 *                                     not supported on this unit
 *
@@ -0,0 +1,1099 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "sbplugin.h"
+#include "sbplugin_shm.h"
+#include "common/platform_spec.h"
+
+/* trigger callback registered by the application, per ASIC */
+static BVIEW_BST_TRIGGER_CALLBACK_t   shmTriggerCallback[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+static void                           *shmTriggerCookie[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+
+/* the configuration handed to the producer, kept for config get and for
+   a restarted producer */
+static BVIEW_BST_CONFIG_t             shmBstConfig[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+static bool                           shmBstConfigSet[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+static pthread_mutex_t                shmBstConfigLock = PTHREAD_MUTEX_INITIALIZER;
+
+/*********************************************************************
+* @brief  Copy a section of the statistics of an ASIC
+*
+* @param[in]   asic             - unit
+* @param[in]   offset           - offset of the section in the snapshot
+* @param[in]   size             - size of the section
+* @param[out]  data             - section
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_FAILURE           if the copy failed.
+* @retval BVIEW_STATUS_NOTREADY          if the copy holds the last values
+*                                        of a producer gone.
+* @retval BVIEW_STATUS_SUCCESS           if the copy is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_section_get (int asic, size_t offset,
+                                                  size_t size, void *data,
+                                                  BVIEW_TIME_t *time)
+{
+  return sbplugin_shm_region_read (asic, false, offset, size, data, time);
+}
+
+/*********************************************************************
+* @brief  Hand a threshold to the producer
+*
+* @param[in]   asic             - unit
+* @param[in]   realm            - realm, registry id
+* @param[in]   index1           - first index, -1 if none
+* @param[in]   index2           - second index, -1 if none
+* @param[in]   thres            - threshold structure of the realm
+* @param[in]   size             - size of the threshold structure
+*
+* @retval BVIEW_STATUS_FAILURE           if the request is not queued.
+* @retval BVIEW_STATUS_SUCCESS           if the request is queued.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_threshold_request (int asic,
+                                                       BVIEW_BST_REALM_ID_t realm,
+                                                       int index1, int index2,
+                                                       const void *thres,
+                                                       size_t size)
+{
+  BVIEW_SHM_REQUEST_t request;
+
+  memset (&request, 0, sizeof (request));
+  request.op = BVIEW_SHM_REQUEST_THRESHOLD;
+  request.asic = asic;
+  request.realm = realm;
+  request.index1 = index1;
+  request.index2 = index2;
+  memcpy (request.u.threshold, thres, size);
+
+  if (BVIEW_STATUS_SUCCESS != sbplugin_shm_region_request (&request))
+  {
+    SB_SHM_DEBUG_PRINT ("BST:ASIC(%d) realm %d (%d,%d):Failed to set Threshold\n",
+                        asic, realm, index1, index2);
+    return BVIEW_STATUS_FAILURE;
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Hand a request without data to the producer
+*
+* @param[in]   asic             - unit
+* @param[in]   op               - request
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if the request is not queued.
+* @retval BVIEW_STATUS_SUCCESS           if the request is queued.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_op_request (int asic,
+                                                BVIEW_SHM_REQUEST_OP_t op)
+{
+  BVIEW_SHM_REQUEST_t request;
+
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  memset (&request, 0, sizeof (request));
+  request.op = op;
+  request.asic = asic;
+  if (BVIEW_STATUS_SUCCESS != sbplugin_shm_region_request (&request))
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Set BST configuration
+*
+* @param[in]   asic                  - unit
+* @param[in]   data                  - BST config structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if config set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if config set is success.
+*
+* @notes    The producer applies the configuration to the driver.
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_config_set (int asic, BVIEW_BST_CONFIG_t *data)
+{
+  BVIEW_SHM_REQUEST_t request;
+  BVIEW_STATUS        rv;
+
+  SB_SHM_NULLPTR_CHECK (data, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check the validity of tracking mode*/
+  if (BVIEW_BST_MODE_CURRENT != data->mode &&
+      BVIEW_BST_MODE_PEAK != data->mode)
+  {
+     return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  memset (&request, 0, sizeof (request));
+  request.op = BVIEW_SHM_REQUEST_CONFIG;
+  request.asic = asic;
+  request.u.config = *data;
+
+  /* held over the request, a replay does not pass a newer config */
+  pthread_mutex_lock (&shmBstConfigLock);
+  rv = sbplugin_shm_region_request (&request);
+  if (BVIEW_STATUS_SUCCESS == rv)
+  {
+    shmBstConfig[asic] = *data;
+    shmBstConfigSet[asic] = true;
+  }
+  pthread_mutex_unlock (&shmBstConfigLock);
+
+  if (BVIEW_STATUS_SUCCESS != rv)
+  {
+    SB_SHM_DEBUG_PRINT ("BST:ASIC(%d) Failed to set bst config\n", asic);
+    return BVIEW_STATUS_FAILURE;
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Get BST configuration
+*
+* @param[in]   asic                  - unit
+* @param[out]  data                  - BST config structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_SUCCESS           if config get is success.
+*
+* @notes    The last configuration handed to the producer.
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_config_get (int asic, BVIEW_BST_CONFIG_t *data)
+{
+  SB_SHM_NULLPTR_CHECK (data, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  pthread_mutex_lock (&shmBstConfigLock);
+  *data = shmBstConfig[asic];
+  pthread_mutex_unlock (&shmBstConfigLock);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Obtain a complete ASIC Statistics Report
+*
+* @param[in]      asic               - unit
+* @param[out]     snapshot           - snapshot data structure
+* @param[out]     time               - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if snapshot get is failed.
+* @retval BVIEW_STATUS_NOTREADY          if the snapshot holds the last
+*                                        values of a producer gone.
+* @retval BVIEW_STATUS_SUCCESS           if snapshot get is success.
+*
+* @notes    One copy of the region, no serialization on either side.
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_snapshot_get (int asic,
+                                 BVIEW_BST_ASIC_SNAPSHOT_DATA_t *snapshot,
+                                 BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, snapshot, time);
+
+  return sbplugin_shm_bst_section_get (asic, 0, sizeof (*snapshot),
+                                       snapshot, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Device Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - Device data structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if device stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if device stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_device_data_get (int asic,
+                                    BVIEW_BST_DEVICE_DATA_t *data,
+                                    BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, device),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Ingress Port + Priority Groups Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - i_p_pg data structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if ippg stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if ippg stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_ippg_data_get (int asic,
+                              BVIEW_BST_INGRESS_PORT_PG_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, iPortPg),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Ingress Port + Service Pools Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - i_p_sp data structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if ipsp stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if ipsp stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_ipsp_data_get (int asic,
+                              BVIEW_BST_INGRESS_PORT_SP_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, iPortSp),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Ingress Service Pools Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - i_sp structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if isp stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if isp stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_isp_data_get (int asic,
+                              BVIEW_BST_INGRESS_SP_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, iSp),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Egress Port + Service Pools Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - e_p_sp data structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if epsp stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if epsp stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_epsp_data_get (int asic,
+                              BVIEW_BST_EGRESS_PORT_SP_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, ePortSp),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Egress Service Pools Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - e_sp data structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if esp stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if esp stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_esp_data_get (int asic,
+                              BVIEW_BST_EGRESS_SP_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, eSp),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Egress Egress Unicast Queues Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - e_ucq data structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if eucq stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if eucq stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_eucq_data_get (int asic,
+                              BVIEW_BST_EGRESS_UC_QUEUE_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, eUcQ),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Egress Egress Unicast Queue Groups Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - e_ucqg data structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if eucqg stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if eucqg stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_eucqg_data_get (int asic,
+                              BVIEW_BST_EGRESS_UC_QUEUEGROUPS_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, eUcQg),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Egress Egress Multicast Queues Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - e_mcq data structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if emcq stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if emcq stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_emcq_data_get (int asic,
+                              BVIEW_BST_EGRESS_MC_QUEUE_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, eMcQ),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Egress Egress CPU Queues Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - CPU queue data structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if CPU stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if CPU stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_cpuq_data_get (int asic,
+                              BVIEW_BST_EGRESS_CPU_QUEUE_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, cpqQ),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Obtain Egress Egress RQE Queues Statistics
+*
+* @param[in]   asic             - unit
+* @param[out]  data             - RQE data data structure
+* @param[out]  time             - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if RQE stat get is failed.
+* @retval BVIEW_STATUS_SUCCESS           if RQE stat get is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_rqeq_data_get (int asic,
+                              BVIEW_BST_EGRESS_RQE_QUEUE_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_bst_section_get (asic,
+                offsetof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t, rqeQ),
+                sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Device Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_device_threshold_set (int asic,
+                                     BVIEW_BST_DEVICE_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_DEVICE_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_DEVICE, -1, -1,
+                                             thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Ingress Port + Priority Groups
+*           Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] port                     - port
+* @param[in] pg                       - Priority Group
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_ippg_threshold_set (int asic, int port, int pg,
+                                     BVIEW_BST_INGRESS_PORT_PG_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_IPPG_SHRD_THRESHOLD_CHECK (thres) ||
+      BVIEW_BST_IPPG_HDRM_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_INGRESS_PORT_PG,
+                                             port, pg, thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Ingress Port + Service Pools
+*           Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] port                     - port
+* @param[in] sp                       - service pool
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_ipsp_threshold_set (int asic, int port, int sp,
+                                     BVIEW_BST_INGRESS_PORT_SP_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_IPSP_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_INGRESS_PORT_SP,
+                                             port, sp, thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Ingress Service Pools
+*           Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] sp                       - service pool
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_isp_threshold_set (int asic, int sp,
+                                     BVIEW_BST_INGRESS_SP_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_ISP_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_INGRESS_SP,
+                                             sp, -1, thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Egress Port + Service Pools
+*           Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] port                     - port
+* @param[in] sp                       - service pool
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_epsp_threshold_set (int asic, int port, int sp,
+                                     BVIEW_BST_EGRESS_PORT_SP_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_EPSP_UC_THRESHOLD_CHECK (thres) ||
+      BVIEW_BST_EPSP_UM_THRESHOLD_CHECK (thres) ||
+      BVIEW_BST_EPSP_MC_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_EGRESS_PORT_SP,
+                                             port, sp, thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Egress Service Pools
+*           Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] sp                       - service pool
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_esp_threshold_set (int asic, int sp,
+                                     BVIEW_BST_EGRESS_SP_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_E_SP_UM_THRESHOLD_CHECK (thres) ||
+      BVIEW_BST_E_SP_MC_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_EGRESS_SP,
+                                             sp, -1, thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Egress Unicast Queues
+*           Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] ucQueue                  - unicast queue
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_eucq_threshold_set (int asic, int ucQueue,
+                                     BVIEW_BST_EGRESS_UC_QUEUE_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_E_UC_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_EGRESS_UC_QUEUE,
+                                             ucQueue, -1, thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Egress Unicast Queue Groups
+*           Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] ucQueueGrp               - unicast queue group
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_eucqg_threshold_set (int asic, int ucQueueGrp,
+                                     BVIEW_BST_EGRESS_UC_QUEUEGROUPS_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_E_UC_GRP_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_EGRESS_UC_QUEUEGROUPS,
+                                             ucQueueGrp, -1, thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Egress Multicast Queues
+*           Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] mcQueue                  - multicast queue
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_emcq_threshold_set (int asic, int mcQueue,
+                                     BVIEW_BST_EGRESS_MC_QUEUE_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_E_MC_THRESHOLD_CHECK (thres) ||
+      BVIEW_BST_E_MC_QUEUE_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_EGRESS_MC_QUEUE,
+                                             mcQueue, -1, thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Egress CPU Queues
+*           Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] cpuQueue                 - CPU queue
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_cpuq_threshold_set (int asic, int cpuQueue,
+                                     BVIEW_BST_EGRESS_CPU_QUEUE_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_E_CPU_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_EGRESS_CPU_QUEUE,
+                                             cpuQueue, -1, thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Set profile configuration for Egress RQE Queues
+*           Statistics
+*
+* @param[in] asic                     - unit
+* @param[in] rqeQueue                 - RQE queue
+* @param[in] thres                    - Threshold data structure
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if threshold set is failed.
+* @retval BVIEW_STATUS_SUCCESS           if threshold set is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_rqeq_threshold_set (int asic, int rqeQueue,
+                                     BVIEW_BST_EGRESS_RQE_QUEUE_THRESHOLD_t *thres)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* Check validity of input data*/
+  if (thres == NULL ||
+      BVIEW_BST_E_RQE_THRESHOLD_CHECK (thres))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  return sbplugin_shm_bst_threshold_request (asic, BVIEW_BST_EGRESS_RQE_QUEUE,
+                                             rqeQueue, -1, thres, sizeof (*thres));
+}
+
+/*********************************************************************
+* @brief  Get snapshot of all thresholds configured
+*
+*
+* @param  [in]  asic                         - unit
+* @param  [out] data                         - Threshold snapshot
+*                                              data structure
+* @param  [out] time                         - Time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if snapshot get is failed.
+* @retval BVIEW_STATUS_NOTREADY          if the snapshot holds the last
+*                                        values of a producer gone.
+* @retval BVIEW_STATUS_SUCCESS           if snapshot get is success.
+*
+* @notes    The thresholds the producer applied, in the layout of the
+*           statistics.
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_bst_threshold_get (int asic,
+                              BVIEW_BST_ASIC_SNAPSHOT_DATA_t *data,
+                              BVIEW_TIME_t *time)
+{
+  SB_SHM_BST_INPUT_VALIDATE (asic, data, time);
+
+  return sbplugin_shm_region_read (asic, true, 0, sizeof (*data), data, time);
+}
+
+/*********************************************************************
+* @brief  Clear stats
+*
+* @param   asic                                    - unit
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if clear stats is failed.
+* @retval BVIEW_STATUS_SUCCESS           if clear stats is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS  sbplugin_shm_bst_clear_stats (int asic)
+{
+  return sbplugin_shm_bst_op_request (asic, BVIEW_SHM_REQUEST_CLEAR_STATS);
+}
+
+/*********************************************************************
+* @brief  Restore threshold configuration
+*
+* @param   asic                                    - unit
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_FAILURE           if restore is failed.
+* @retval BVIEW_STATUS_SUCCESS           if restore is success.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS  sbplugin_shm_bst_clear_thresholds (int asic)
+{
+  return sbplugin_shm_bst_op_request (asic, BVIEW_SHM_REQUEST_CLEAR_THRESHOLDS);
+}
+
+/*********************************************************************
+* @brief  Register hw trigger callback
+*
+* @param   asic                              - unit
+* @param   callback                          - function to be called
+*                                              when trigger happens
+* @param   cookie                            - user data
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_SUCCESS           if register is success.
+*
+* @notes    callback will be executed in the session thread so post the
+*           data to respective task.
+*
+*********************************************************************/
+static BVIEW_STATUS  sbplugin_shm_bst_register_trigger (int asic,
+                                        BVIEW_BST_TRIGGER_CALLBACK_t callback,
+                                        void *cookie)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  /* the cookie is seen with the callback */
+  shmTriggerCookie[asic] = cookie;
+  __atomic_store_n (&shmTriggerCallback[asic], callback, __ATOMIC_RELEASE);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Deliver a trigger of the producer
+*
+* @param[in]   trigger       - trigger
+*
+* @retval  none
+*
+* @notes   Runs in the session thread.
+*
+*********************************************************************/
+void sbplugin_shm_bst_trigger (const BVIEW_SHM_TRIGGER_t *trigger)
+{
+  BVIEW_BST_TRIGGER_CALLBACK_t callback;
+  BVIEW_BST_TRIGGER_INFO_t     info;
+  int                          asic = trigger->asic;
+
+  if (SB_SHM_RV_ERROR (sbplugin_shm_valid_unit_check (asic)))
+  {
+    SB_SHM_DEBUG_PRINT ("SHM: trigger for unknown ASIC %d\n", asic);
+    return;
+  }
+
+  callback = __atomic_load_n (&shmTriggerCallback[asic], __ATOMIC_ACQUIRE);
+  if (NULL == callback)
+  {
+    return;
+  }
+
+  info = trigger->info;
+  callback (asic, shmTriggerCookie[asic], &info);
+}
+
+/*********************************************************************
+* @brief  Hand the BST configuration to a restarted producer
+*
+* @retval  none
+*
+* @notes   Runs in the session thread, once the new region is attached.
+*          The thresholds are the state of the producer and are not
+*          handed again.
+*
+*********************************************************************/
+void sbplugin_shm_bst_config_replay (void)
+{
+  BVIEW_SHM_REQUEST_t request;
+  int                 asic;
+
+  pthread_mutex_lock (&shmBstConfigLock);
+  for (asic = 0; asic < BVIEW_MAX_ASICS_ON_A_PLATFORM; asic++)
+  {
+    if (!shmBstConfigSet[asic])
+    {
+      continue;
+    }
+    memset (&request, 0, sizeof (request));
+    request.op = BVIEW_SHM_REQUEST_CONFIG;
+    request.asic = asic;
+    request.u.config = shmBstConfig[asic];
+    if (BVIEW_STATUS_SUCCESS != sbplugin_shm_region_request (&request))
+    {
+      SB_SHM_LOG (BVIEW_LOG_ERROR,
+                  "BST:ASIC(%d) config not handed to the restarted producer", asic);
+    }
+  }
+  pthread_mutex_unlock (&shmBstConfigLock);
+}
+
+/*********************************************************************
+* @brief  SHM South Bound - BST feature init
+*
+* @param[in,out]   shmBstFeat   -  BST data structure
+*
+* @retval  BVIEW_STATUS_SUCCESS            if intialization is success
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes   none
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_bst_init (BVIEW_SB_BST_FEATURE_t *shmBstFeat)
+{
+  int asic;
+
+  SB_SHM_NULLPTR_CHECK (shmBstFeat, BVIEW_STATUS_INVALID_PARAMETER);
+
+  for (asic = 0; asic < BVIEW_MAX_ASICS_ON_A_PLATFORM; asic++)
+  {
+    shmBstConfig[asic].mode = BVIEW_BST_MODE_CURRENT;
+  }
+
+  memset (shmBstFeat, 0x00, sizeof (BVIEW_SB_BST_FEATURE_t));
+  shmBstFeat->feature.featureId           = BVIEW_FEATURE_BST;
+  shmBstFeat->feature.supportedAsicMask   = BVIEW_BST_SUPPORT_MASK;
+  shmBstFeat->bst_config_set_cb           = sbplugin_shm_bst_config_set;
+  shmBstFeat->bst_config_get_cb           = sbplugin_shm_bst_config_get;
+  shmBstFeat->bst_snapshot_get_cb         = sbplugin_shm_bst_snapshot_get;
+  shmBstFeat->bst_device_data_get_cb      = sbplugin_shm_bst_device_data_get;
+  shmBstFeat->bst_ippg_data_get_cb        = sbplugin_shm_bst_ippg_data_get;
+  shmBstFeat->bst_ipsp_data_get_cb        = sbplugin_shm_bst_ipsp_data_get;
+  shmBstFeat->bst_isp_data_get_cb         = sbplugin_shm_bst_isp_data_get;
+  shmBstFeat->bst_epsp_data_get_cb        = sbplugin_shm_bst_epsp_data_get;
+  shmBstFeat->bst_esp_data_get_cb         = sbplugin_shm_bst_esp_data_get;
+  shmBstFeat->bst_eucq_data_get_cb        = sbplugin_shm_bst_eucq_data_get;
+  shmBstFeat->bst_eucqg_data_get_cb       = sbplugin_shm_bst_eucqg_data_get;
+  shmBstFeat->bst_emcq_data_get_cb        = sbplugin_shm_bst_emcq_data_get;
+  shmBstFeat->bst_cpuq_data_get_cb        = sbplugin_shm_bst_cpuq_data_get;
+  shmBstFeat->bst_rqeq_data_get_cb        = sbplugin_shm_bst_rqeq_data_get;
+  shmBstFeat->bst_device_threshold_set_cb = sbplugin_shm_bst_device_threshold_set;
+  shmBstFeat->bst_ippg_threshold_set_cb   = sbplugin_shm_bst_ippg_threshold_set;
+  shmBstFeat->bst_ipsp_threshold_set_cb   = sbplugin_shm_bst_ipsp_threshold_set;
+  shmBstFeat->bst_isp_threshold_set_cb    = sbplugin_shm_bst_isp_threshold_set;
+  shmBstFeat->bst_epsp_threshold_set_cb   = sbplugin_shm_bst_epsp_threshold_set;
+  shmBstFeat->bst_esp_threshold_set_cb    = sbplugin_shm_bst_esp_threshold_set;
+  shmBstFeat->bst_eucq_threshold_set_cb   = sbplugin_shm_bst_eucq_threshold_set;
+  shmBstFeat->bst_eucqg_threshold_set_cb  = sbplugin_shm_bst_eucqg_threshold_set;
+  shmBstFeat->bst_emcq_threshold_set_cb   = sbplugin_shm_bst_emcq_threshold_set;
+  shmBstFeat->bst_cpuq_threshold_set_cb   = sbplugin_shm_bst_cpuq_threshold_set;
+  shmBstFeat->bst_rqeq_threshold_set_cb   = sbplugin_shm_bst_rqeq_threshold_set;
+  shmBstFeat->bst_threshold_get_cb        = sbplugin_shm_bst_threshold_get;
+  shmBstFeat->bst_clear_stats_cb          = sbplugin_shm_bst_clear_stats;
+  shmBstFeat->bst_clear_thresholds_cb     = sbplugin_shm_bst_clear_thresholds;
+  shmBstFeat->bst_register_trigger_cb     = sbplugin_shm_bst_register_trigger;
+
+  return BVIEW_STATUS_SUCCESS;
+}
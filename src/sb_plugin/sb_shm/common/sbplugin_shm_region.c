@@ -0,0 +1,626 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "sbplugin_shm.h"
+
+/* Session with the producer. The region pointer is only changed by the
+   session thread, under the write lock; the API readers take the read
+   lock around their use of the mapping. */
+typedef struct _sb_shm_session_
+{
+  pthread_rwlock_t     lock;
+  /* writers of the request ring */
+  pthread_mutex_t      requestLock;
+  BVIEW_SHM_REGION_t  *region;
+  int                  sock;
+  int                  eventFd[BVIEW_SHM_EVENTFD_COUNT];
+  /* the producer is gone, the region holds its last values */
+  bool                 stale;
+  int                  backoff;
+  uint32_t             dropped;
+  int                  numAsics;
+  pthread_t            thread;
+} SB_SHM_SESSION_t;
+
+static SB_SHM_SESSION_t shmSession = {
+  .lock = PTHREAD_RWLOCK_INITIALIZER,
+  .requestLock = PTHREAD_MUTEX_INITIALIZER,
+  .sock = -1,
+  .eventFd = { -1, -1 },
+  .stale = true,
+  .backoff = SB_SHM_ATTACH_MIN_MSEC
+};
+
+/*********************************************************************
+* @brief  Receive the eventfds of the producer
+*
+* @param[in]   sock          - connected socket
+* @param[out]  fds           - eventfds, BVIEW_SHM_EVENTFD_COUNT
+*
+* @retval BVIEW_STATUS_SUCCESS  if both eventfds are received
+* @retval BVIEW_STATUS_FAILURE  otherwise
+*
+* @notes  none
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_eventfds_recv (int sock, int *fds)
+{
+  char            byte;
+  char            control[CMSG_SPACE (sizeof (int) * BVIEW_SHM_EVENTFD_COUNT)];
+  struct iovec    iov = { .iov_base = &byte, .iov_len = sizeof (byte) };
+  struct msghdr   msg;
+  struct cmsghdr  *cmsg;
+
+  memset (&msg, 0, sizeof (msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof (control);
+
+  if (recvmsg (sock, &msg, MSG_CMSG_CLOEXEC) <= 0)
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+  cmsg = CMSG_FIRSTHDR (&msg);
+  if ((NULL == cmsg) || (SOL_SOCKET != cmsg->cmsg_level) ||
+      (SCM_RIGHTS != cmsg->cmsg_type))
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+  if (cmsg->cmsg_len != CMSG_LEN (sizeof (int) * BVIEW_SHM_EVENTFD_COUNT))
+  {
+    /* close what came, it is not from a producer of this version */
+    int index, count = (cmsg->cmsg_len - CMSG_LEN (0)) / sizeof (int);
+
+    for (index = 0; index < count; index++)
+    {
+      close (((int *) CMSG_DATA (cmsg))[index]);
+    }
+    return BVIEW_STATUS_FAILURE;
+  }
+  memcpy (fds, CMSG_DATA (cmsg), sizeof (int) * BVIEW_SHM_EVENTFD_COUNT);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Connect to the producer and map its region
+*
+* @param[out]  sock          - connected socket
+* @param[out]  fds           - eventfds of the producer
+* @param[out]  region        - mapped region
+*
+* @retval BVIEW_STATUS_SUCCESS  if the region is mapped and valid
+* @retval BVIEW_STATUS_FAILURE  otherwise, nothing is left open
+*
+* @notes  none
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_session_open (int *sock, int *fds,
+                                               BVIEW_SHM_REGION_t **region)
+{
+  struct sockaddr_un  addr;
+  struct timeval      timeout = { .tv_sec = 1, .tv_usec = 0 };
+  struct stat         st;
+  BVIEW_SHM_REGION_t  *p_region = MAP_FAILED;
+  int                 shmFd = -1;
+
+  fds[BVIEW_SHM_EVENTFD_TRIGGER] = -1;
+  fds[BVIEW_SHM_EVENTFD_REQUEST] = -1;
+
+  *sock = socket (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (*sock < 0)
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+  memset (&addr, 0, sizeof (addr));
+  addr.sun_family = AF_UNIX;
+  strncpy (addr.sun_path, BVIEW_SHM_SOCKET_PATH, sizeof (addr.sun_path) - 1);
+  setsockopt (*sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof (timeout));
+
+  if ((connect (*sock, (struct sockaddr *) &addr, sizeof (addr)) < 0) ||
+      (BVIEW_STATUS_SUCCESS != sbplugin_shm_eventfds_recv (*sock, fds)))
+  {
+    SB_SHM_DEBUG_PRINT ("SHM: no producer on %s (%s)\n",
+                        BVIEW_SHM_SOCKET_PATH, strerror (errno));
+    goto fail;
+  }
+
+  /* the producer creates the region before it listens */
+  shmFd = shm_open (BVIEW_SHM_REGION_NAME, O_RDWR, 0);
+  if ((shmFd < 0) || (fstat (shmFd, &st) < 0) ||
+      (st.st_size < (off_t) sizeof (BVIEW_SHM_REGION_t)))
+  {
+    SB_SHM_LOG (BVIEW_LOG_ERROR, "SHM: region %s is missing or short",
+                BVIEW_SHM_REGION_NAME);
+    goto fail;
+  }
+  p_region = mmap (NULL, sizeof (BVIEW_SHM_REGION_t), PROT_READ | PROT_WRITE,
+                   MAP_SHARED, shmFd, 0);
+  close (shmFd);
+  shmFd = -1;
+  if (MAP_FAILED == p_region)
+  {
+    goto fail;
+  }
+
+  if ((BVIEW_SHM_REGION_MAGIC != __atomic_load_n (&p_region->magic, __ATOMIC_ACQUIRE)) ||
+      (BVIEW_SHM_REGION_VERSION != p_region->version) ||
+      (sizeof (BVIEW_SHM_REGION_t) != p_region->size) ||
+      (p_region->numAsics <= 0) ||
+      (p_region->numAsics > BVIEW_MAX_ASICS_ON_A_PLATFORM))
+  {
+    SB_SHM_LOG (BVIEW_LOG_ERROR,
+                "SHM: region %s does not match this agent (version %u size %llu)",
+                BVIEW_SHM_REGION_NAME, p_region->version,
+                (unsigned long long) p_region->size);
+    goto fail;
+  }
+
+  *region = p_region;
+  return BVIEW_STATUS_SUCCESS;
+
+fail:
+  if (MAP_FAILED != p_region)
+  {
+    munmap (p_region, sizeof (BVIEW_SHM_REGION_t));
+  }
+  if (shmFd >= 0)
+  {
+    close (shmFd);
+  }
+  if (fds[BVIEW_SHM_EVENTFD_TRIGGER] >= 0)
+  {
+    close (fds[BVIEW_SHM_EVENTFD_TRIGGER]);
+    close (fds[BVIEW_SHM_EVENTFD_REQUEST]);
+  }
+  close (*sock);
+  *sock = -1;
+  return BVIEW_STATUS_FAILURE;
+}
+
+/*********************************************************************
+* @brief  Attach the region of the producer
+*
+* @retval BVIEW_STATUS_SUCCESS  if the region is attached
+* @retval BVIEW_STATUS_FAILURE  if no valid region could be attached
+*
+* @notes  Runs at init and in the session thread. The mapping of a
+*         producer gone is released once the new one is in place.
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_session_attach (void)
+{
+  BVIEW_SHM_REGION_t  *region = NULL, *old;
+  int                 sock, fds[BVIEW_SHM_EVENTFD_COUNT];
+
+  if (BVIEW_STATUS_SUCCESS !=
+      sbplugin_shm_session_open (&sock, fds, &region))
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  if ((NULL != shmSession.region) &&
+      ((region->numAsics != shmSession.numAsics) ||
+       (0 != memcmp (&region->asics[0].scalingParams,
+                     &shmSession.region->asics[0].scalingParams,
+                     sizeof (BVIEW_ASIC_CAPABILITIES_t)))))
+  {
+    /* the ASIC database of the agent is set at init */
+    SB_SHM_LOG (BVIEW_LOG_ERROR,
+                "SHM: the restarted producer describes other ASICs, "
+                "the agent keeps the ones it started with");
+  }
+
+  pthread_rwlock_wrlock (&shmSession.lock);
+  old = shmSession.region;
+  shmSession.region = region;
+  shmSession.sock = sock;
+  shmSession.eventFd[BVIEW_SHM_EVENTFD_TRIGGER] = fds[BVIEW_SHM_EVENTFD_TRIGGER];
+  shmSession.eventFd[BVIEW_SHM_EVENTFD_REQUEST] = fds[BVIEW_SHM_EVENTFD_REQUEST];
+  shmSession.dropped = __atomic_load_n (&region->triggers.dropped, __ATOMIC_RELAXED);
+  if (NULL == old)
+  {
+    shmSession.numAsics = region->numAsics;
+  }
+  __atomic_store_n (&shmSession.stale, false, __ATOMIC_RELEASE);
+  pthread_rwlock_unlock (&shmSession.lock);
+
+  if ((NULL != old) && (old != region))
+  {
+    munmap (old, sizeof (BVIEW_SHM_REGION_t));
+  }
+  shmSession.backoff = SB_SHM_ATTACH_MIN_MSEC;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Drop the session of a producer gone
+*
+* @retval  none
+*
+* @notes  The mapping is kept, the readers get the last values with
+*         BVIEW_STATUS_NOTREADY until a producer is attached again.
+*
+*********************************************************************/
+static void sbplugin_shm_session_close (void)
+{
+  int index;
+
+  pthread_rwlock_wrlock (&shmSession.lock);
+  __atomic_store_n (&shmSession.stale, true, __ATOMIC_RELEASE);
+  close (shmSession.sock);
+  shmSession.sock = -1;
+  for (index = 0; index < BVIEW_SHM_EVENTFD_COUNT; index++)
+  {
+    close (shmSession.eventFd[index]);
+    shmSession.eventFd[index] = -1;
+  }
+  pthread_rwlock_unlock (&shmSession.lock);
+}
+
+/*********************************************************************
+* @brief  Sleep before the next attach and double the wait
+*
+* @retval  none
+*
+* @notes  none
+*
+*********************************************************************/
+static void sbplugin_shm_session_backoff (void)
+{
+  struct timespec ts;
+
+  ts.tv_sec = shmSession.backoff / 1000;
+  ts.tv_nsec = (long) (shmSession.backoff % 1000) * 1000000;
+  nanosleep (&ts, NULL);
+
+  shmSession.backoff *= 2;
+  if (shmSession.backoff > SB_SHM_ATTACH_MAX_MSEC)
+  {
+    shmSession.backoff = SB_SHM_ATTACH_MAX_MSEC;
+  }
+}
+
+/*********************************************************************
+* @brief  Deliver the triggers queued by the producer
+*
+* @retval  none
+*
+* @notes  Runs in the session thread, the only reader of the ring.
+*
+*********************************************************************/
+static void sbplugin_shm_triggers_drain (void)
+{
+  BVIEW_SHM_TRIGGER_RING_t *ring = &shmSession.region->triggers;
+  BVIEW_SHM_TRIGGER_t      trigger;
+  uint32_t                 dropped;
+
+  while (bview_shm_trigger_pop (ring, &trigger))
+  {
+    sbplugin_shm_bst_trigger (&trigger);
+  }
+
+  dropped = __atomic_load_n (&ring->dropped, __ATOMIC_RELAXED);
+  if (dropped != shmSession.dropped)
+  {
+    SB_SHM_LOG (BVIEW_LOG_WARNING, "SHM: %u triggers lost to a full ring",
+                dropped - shmSession.dropped);
+    shmSession.dropped = dropped;
+  }
+}
+
+/*********************************************************************
+* @brief  Session thread
+*
+* @param[in]   arg           - unused
+*
+* @retval  none
+*
+* @notes  Waits on the trigger eventfd and on the socket of the producer.
+*         A hang up of the socket is the producer gone : the region of
+*         the next producer is attached, with a back off.
+*
+*********************************************************************/
+static void *sbplugin_shm_session_thread (void *arg)
+{
+  struct pollfd  pfd[2];
+  uint64_t       count;
+  ssize_t        len;
+  char           byte;
+
+  (void) arg;
+
+  while (1)
+  {
+    if (shmSession.sock < 0)
+    {
+      sbplugin_shm_session_backoff ();
+      if (BVIEW_STATUS_SUCCESS != sbplugin_shm_session_attach ())
+      {
+        continue;
+      }
+      SB_SHM_LOG (BVIEW_LOG_INFO, "SHM: producer region attached again");
+      sbplugin_shm_bst_config_replay ();
+      sbplugin_shm_triggers_drain ();
+    }
+
+    pfd[0].fd = shmSession.eventFd[BVIEW_SHM_EVENTFD_TRIGGER];
+    pfd[0].events = POLLIN;
+    pfd[1].fd = shmSession.sock;
+    pfd[1].events = POLLIN;
+    if (poll (pfd, 2, -1) < 0)
+    {
+      continue;
+    }
+
+    if (pfd[0].revents & POLLIN)
+    {
+      /* read before the ring, a trigger queued after it signals again */
+      if (read (pfd[0].fd, &count, sizeof (count)) == sizeof (count))
+      {
+        sbplugin_shm_triggers_drain ();
+      }
+    }
+
+    /* the producer sends nothing after the eventfds */
+    if (0 == (pfd[1].revents & (POLLIN | POLLHUP | POLLERR)))
+    {
+      continue;
+    }
+    len = recv (pfd[1].fd, &byte, sizeof (byte), MSG_DONTWAIT);
+    if ((0 == len) ||
+        ((len < 0) && (EAGAIN != errno) && (EINTR != errno)))
+    {
+      SB_SHM_LOG (BVIEW_LOG_ERROR, "SHM: producer gone, reattaching");
+      sbplugin_shm_triggers_drain ();
+      sbplugin_shm_session_close ();
+    }
+  }
+
+  return NULL;
+}
+
+/*********************************************************************
+* @brief  Attach the region of the producer
+*
+* @retval BVIEW_STATUS_SUCCESS  if the region is attached
+* @retval BVIEW_STATUS_FAILURE  if the session thread can not start
+*
+* @notes  Waits for the producer, retrying with a back off. Once
+*         attached, a session thread delivers the triggers and attaches
+*         the region of a restarted producer.
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_region_init (void)
+{
+  while (BVIEW_STATUS_SUCCESS != sbplugin_shm_session_attach ())
+  {
+    SB_SHM_LOG (BVIEW_LOG_ERROR, "SHM: waiting for the producer on %s",
+                BVIEW_SHM_SOCKET_PATH);
+    sbplugin_shm_session_backoff ();
+  }
+
+  if (0 != pthread_create (&shmSession.thread, NULL,
+                           sbplugin_shm_session_thread, NULL))
+  {
+    SB_SHM_LOG (BVIEW_LOG_CRITICAL, "SHM: failed to start the session thread");
+    return BVIEW_STATUS_FAILURE;
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Get the number of ASICs of the producer
+*
+* @retval  number of ASICs
+*
+* @notes  Set at init, a restarted producer does not change it.
+*
+*********************************************************************/
+int sbplugin_shm_region_num_asics_get (void)
+{
+  return shmSession.numAsics;
+}
+
+/*********************************************************************
+* @brief  Get the description of an ASIC of the producer
+*
+* @param[in]   asic            - unit
+* @param[out]  asicType        - ASIC type
+* @param[out]  scalingParams   - ASIC capabilities
+* @param[out]  maxBuf          - max buffers of the ASIC, may be NULL
+*
+* @retval BVIEW_STATUS_SUCCESS           if the description is copied
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid
+*
+* @notes  none
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_region_asic_get (int asic,
+                              BVIEW_ASIC_TYPE *asicType,
+                              BVIEW_ASIC_CAPABILITIES_t *scalingParams,
+                              BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuf)
+{
+  BVIEW_SHM_ASIC_t *p_asic;
+
+  if ((asic < 0) || (asic >= shmSession.numAsics))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  pthread_rwlock_rdlock (&shmSession.lock);
+  p_asic = &shmSession.region->asics[asic];
+  if (NULL != asicType)
+  {
+    *asicType = p_asic->asicType;
+  }
+  if (NULL != scalingParams)
+  {
+    *scalingParams = p_asic->scalingParams;
+  }
+  if (NULL != maxBuf)
+  {
+    memcpy (maxBuf, &p_asic->maxBuf, sizeof (*maxBuf));
+  }
+  pthread_rwlock_unlock (&shmSession.lock);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Copy a part of the statistics or of the thresholds of an ASIC
+*
+* @param[in]   asic          - unit
+* @param[in]   thresholds    - true for the thresholds
+* @param[in]   offset        - offset in BVIEW_BST_ASIC_SNAPSHOT_DATA_t
+* @param[in]   size          - bytes to copy
+* @param[out]  data          - copy
+* @param[out]  ptime         - time of the collection
+*
+* @retval BVIEW_STATUS_SUCCESS   if the copy is consistent
+* @retval BVIEW_STATUS_NOTREADY  if the copy holds the last values of a
+*                                producer gone, the region is being
+*                                attached again.
+* @retval BVIEW_STATUS_FAILURE   if no consistent copy could be taken
+*
+* @notes  The copy is taken again while the producer updates the ASIC
+*         under it, the producer is never held.
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_region_read (int asic, bool thresholds,
+                                       size_t offset, size_t size,
+                                       void *data, BVIEW_TIME_t *ptime)
+{
+  BVIEW_SHM_ASIC_t *p_asic;
+  const char       *base;
+  BVIEW_STATUS     rv = BVIEW_STATUS_FAILURE;
+  int64_t          collected = 0;
+  uint32_t         seq;
+  int              retry;
+  bool             stale;
+
+  if ((asic < 0) || (asic >= shmSession.numAsics) ||
+      (offset + size > sizeof (BVIEW_BST_ASIC_SNAPSHOT_DATA_t)))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  pthread_rwlock_rdlock (&shmSession.lock);
+  /* taken before the copy, a producer coming back under it is still stale */
+  stale = __atomic_load_n (&shmSession.stale, __ATOMIC_ACQUIRE);
+  p_asic = &shmSession.region->asics[asic];
+  base = (const char *) (thresholds ? &p_asic->thresholds : &p_asic->stats);
+
+  for (retry = 0; retry < SB_SHM_READ_RETRIES; retry++)
+  {
+    seq = bview_shm_read_begin (p_asic);
+    if (seq & 1)
+    {
+      /* a producer gone while writing never ends the update */
+      if (stale)
+      {
+        break;
+      }
+      sched_yield ();
+      continue;
+    }
+    memcpy (data, base + offset, size);
+    collected = p_asic->time;
+    if (!bview_shm_read_retry (p_asic, seq))
+    {
+      rv = stale ? BVIEW_STATUS_NOTREADY : BVIEW_STATUS_SUCCESS;
+      break;
+    }
+  }
+  pthread_rwlock_unlock (&shmSession.lock);
+
+  if (BVIEW_STATUS_FAILURE == rv)
+  {
+    SB_SHM_LOG (BVIEW_LOG_ERROR,
+                "SHM: ASIC(%d) no consistent copy of the region", asic);
+    return rv;
+  }
+
+  if (NULL != ptime)
+  {
+    *ptime = (0 != collected) ? (BVIEW_TIME_t) collected : (BVIEW_TIME_t) time (NULL);
+  }
+  return rv;
+}
+
+/*********************************************************************
+* @brief  Hand a request to the producer
+*
+* @param[in]   request       - request
+*
+* @retval BVIEW_STATUS_SUCCESS     if the request is queued
+* @retval BVIEW_STATUS_TABLE_FULL  if the producer does not keep up
+* @retval BVIEW_STATUS_FAILURE     if there is no producer
+*
+* @notes  The agent threads are serialized on the request ring, its
+*         single writer.
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_region_request (const BVIEW_SHM_REQUEST_t *request)
+{
+  BVIEW_STATUS rv = BVIEW_STATUS_SUCCESS;
+  uint64_t     one = 1;
+
+  pthread_rwlock_rdlock (&shmSession.lock);
+  if (__atomic_load_n (&shmSession.stale, __ATOMIC_ACQUIRE))
+  {
+    pthread_rwlock_unlock (&shmSession.lock);
+    SB_SHM_DEBUG_PRINT ("SHM: no producer for request %d\n", request->op);
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  pthread_mutex_lock (&shmSession.requestLock);
+  if (!bview_shm_request_push (&shmSession.region->requests, request))
+  {
+    rv = BVIEW_STATUS_TABLE_FULL;
+  }
+  pthread_mutex_unlock (&shmSession.requestLock);
+
+  if ((BVIEW_STATUS_SUCCESS == rv) &&
+      (write (shmSession.eventFd[BVIEW_SHM_EVENTFD_REQUEST], &one, sizeof (one)) != sizeof (one)))
+  {
+    /* queued, the producer sees it with the next one */
+    SB_SHM_DEBUG_PRINT ("SHM: request %d not signalled\n", request->op);
+  }
+  pthread_rwlock_unlock (&shmSession.lock);
+
+  if (BVIEW_STATUS_TABLE_FULL == rv)
+  {
+    SB_SHM_LOG (BVIEW_LOG_ERROR, "SHM: request ring full, request %d dropped",
+                request->op);
+  }
+  return rv;
+}
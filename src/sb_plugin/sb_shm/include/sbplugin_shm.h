@@ -0,0 +1,235 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#ifndef INCLUDE_SBPLUGIN_SHM_H
+#define INCLUDE_SBPLUGIN_SHM_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include "sbplugin.h"
+#include "sbfeature_bst.h"
+#include "sbplugin_system.h"
+#include "sb_redirector_api.h"
+#include "openapps_log_api.h"
+#include "sbplugin_shm_region.h"
+
+#define  SBPLUGIN_SHM_NETWORK_OS     "shm"
+
+/* SYSTEM feature supported ASIC's Mask.*/
+#define  BVIEW_SYSTEM_SUPPORT_MASK   (BVIEW_ASIC_TYPE_ALL)
+
+/** BST feature support ASIC's Mask*/
+#define  BVIEW_BST_SUPPORT_MASK      (BVIEW_ASIC_TYPE_TD2 | BVIEW_ASIC_TYPE_TH)
+
+/* wait before the region is attached again, doubled after each failure */
+#define  SB_SHM_ATTACH_MIN_MSEC      100
+#define  SB_SHM_ATTACH_MAX_MSEC      5000
+
+/* copies of a snapshot tried while the producer keeps updating it */
+#define  SB_SHM_READ_RETRIES         1000
+
+/* NULL Pointer Check*/
+#define  SB_SHM_NULLPTR_CHECK(_p,_rv)           \
+                if ((_p) == NULL)               \
+                {                               \
+                  return (_rv);                 \
+                }
+
+/* Flag to enable/disable debug */
+extern int sbShmDebugFlag;
+
+#define SB_SHM_RV_ERROR(_rv)     ((_rv) != BVIEW_STATUS_SUCCESS)
+
+/* Macro to print the SHM plug-in debug information */
+#define SB_SHM_DEBUG_PRINT(format, args...)                                     \
+                       if (sbShmDebugFlag)                                      \
+                       {                                                        \
+                         printf ("(%s:%d) "format, __FILE__, __LINE__,##args);  \
+                       }
+
+#define SB_SHM_LOG(severity,format, args...)                 \
+                        {                                   \
+                          log_post(severity,format, ##args);\
+                        }
+
+#define SB_SHM_VALID_UNIT_CHECK(_asic)                                           \
+                         if (SB_SHM_RV_ERROR(sbplugin_shm_valid_unit_check(_asic))) \
+                         {                                                       \
+                           return BVIEW_STATUS_INVALID_PARAMETER;                \
+                         }
+
+/* Check _asic (unit) is valid along with _data & _time for NULL pointer */
+#define  SB_SHM_BST_INPUT_VALIDATE(_asic,_data,_time)                           \
+                            if (((_data) == NULL) || ((_time) == NULL) ||       \
+                                (SB_SHM_RV_ERROR(sbplugin_shm_valid_unit_check(_asic)))) \
+                            {                                                   \
+                              SB_SHM_DEBUG_PRINT ("Invalid input data ASIC %d", _asic); \
+                              return BVIEW_STATUS_INVALID_PARAMETER;            \
+                            }
+
+/*********************************************************************
+* @brief  Attach the region of the producer
+*
+* @retval BVIEW_STATUS_SUCCESS  if the region is attached
+* @retval BVIEW_STATUS_FAILURE  if the session thread can not start
+*
+* @notes  Waits for the producer, retrying with a back off. Once
+*         attached, a session thread delivers the triggers and attaches
+*         the region of a restarted producer.
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_region_init (void);
+
+/*********************************************************************
+* @brief  Get the number of ASICs of the producer
+*
+* @retval  number of ASICs
+*
+* @notes  Set at init, a restarted producer does not change it.
+*
+*********************************************************************/
+int sbplugin_shm_region_num_asics_get (void);
+
+/*********************************************************************
+* @brief  Get the description of an ASIC of the producer
+*
+* @param[in]   asic            - unit
+* @param[out]  asicType        - ASIC type
+* @param[out]  scalingParams   - ASIC capabilities
+* @param[out]  maxBuf          - max buffers of the ASIC, may be NULL
+*
+* @retval BVIEW_STATUS_SUCCESS           if the description is copied
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid
+*
+* @notes  none
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_region_asic_get (int asic,
+                              BVIEW_ASIC_TYPE *asicType,
+                              BVIEW_ASIC_CAPABILITIES_t *scalingParams,
+                              BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBuf);
+
+/*********************************************************************
+* @brief  Copy a part of the statistics or of the thresholds of an ASIC
+*
+* @param[in]   asic          - unit
+* @param[in]   thresholds    - true for the thresholds
+* @param[in]   offset        - offset in BVIEW_BST_ASIC_SNAPSHOT_DATA_t
+* @param[in]   size          - bytes to copy
+* @param[out]  data          - copy
+* @param[out]  ptime         - time of the collection
+*
+* @retval BVIEW_STATUS_SUCCESS   if the copy is consistent
+* @retval BVIEW_STATUS_NOTREADY  if the copy holds the last values of a
+*                                producer gone, the region is being
+*                                attached again.
+* @retval BVIEW_STATUS_FAILURE   if no consistent copy could be taken
+*
+* @notes  none
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_region_read (int asic, bool thresholds,
+                                       size_t offset, size_t size,
+                                       void *data, BVIEW_TIME_t *ptime);
+
+/*********************************************************************
+* @brief  Hand a request to the producer
+*
+* @param[in]   request       - request
+*
+* @retval BVIEW_STATUS_SUCCESS     if the request is queued
+* @retval BVIEW_STATUS_TABLE_FULL  if the producer does not keep up
+* @retval BVIEW_STATUS_FAILURE     if there is no producer
+*
+* @notes  none
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_region_request (const BVIEW_SHM_REQUEST_t *request);
+
+/*********************************************************************
+* @brief  SHM South Bound - SYSTEM feature init
+*
+* @param[in,out]   shmSystemFeat   -  system data structure
+*
+* @retval  BVIEW_STATUS_SUCCESS            if intialization is success
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes   The region is attached.
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_system_init (BVIEW_SB_SYSTEM_FEATURE_t *shmSystemFeat);
+
+/*********************************************************************
+* @brief   Verify whether a given unit number is valid or not.
+*
+* @param[in]   unit                     -  unit number
+*
+* @retval  BVIEW_STATUS_SUCCESS            if it is a valid unit
+* @retval  BVIEW_STATUS_FAILURE            if it is not a valid unit
+*
+* @notes
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_valid_unit_check (int unit);
+
+/*********************************************************************
+* @brief  SHM South Bound - BST feature init
+*
+* @param[in,out]   shmBstFeat   -  BST data structure
+*
+* @retval  BVIEW_STATUS_SUCCESS            if intialization is success
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes   none
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_bst_init (BVIEW_SB_BST_FEATURE_t *shmBstFeat);
+
+/*********************************************************************
+* @brief  Deliver a trigger of the producer
+*
+* @param[in]   trigger       - trigger
+*
+* @retval  none
+*
+* @notes   Runs in the session thread.
+*
+*********************************************************************/
+void sbplugin_shm_bst_trigger (const BVIEW_SHM_TRIGGER_t *trigger);
+
+/*********************************************************************
+* @brief  Hand the BST configuration to a restarted producer
+*
+* @retval  none
+*
+* @notes   Runs in the session thread, once the new region is attached.
+*          The thresholds are the state of the producer and are not
+*          handed again.
+*
+*********************************************************************/
+void sbplugin_shm_bst_config_replay (void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_SBPLUGIN_SHM_H */
+
@@ -0,0 +1,256 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#ifndef INCLUDE_SBPLUGIN_SHM_REGION_H
+#define INCLUDE_SBPLUGIN_SHM_REGION_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "broadview.h"
+#include "asic.h"
+#include "bst.h"
+#include "system.h"
+
+/*
+ * Shared memory region of the SHM south bound plugin, the contract between
+ * the agent and a producer process co-located with the switch driver.
+ *
+ * The producer creates the region with shm_open (BVIEW_SHM_REGION_NAME),
+ * fills the description of its ASICs and writes the magic last. It then
+ * publishes the BST statistics and thresholds of each ASIC, laid out as
+ * BVIEW_BST_ASIC_SNAPSHOT_DATA_t, under a sequence lock : the sequence is
+ * odd while the producer writes, and a reader copies again when the
+ * sequence moved under its copy. Readers never block the producer.
+ *
+ * Triggers go from the producer to the agent through the trigger ring, and
+ * the agent hands the threshold and configuration changes to the producer
+ * through the request ring. Each ring has a single writer and a single
+ * reader, and is signalled through an eventfd. The producer passes both
+ * eventfds (SCM_RIGHTS) to the agent connecting to BVIEW_SHM_SOCKET_PATH;
+ * the connection is held for the session, a hang up is the producer gone.
+ *
+ * The region carries its size, the agent does not attach a region built
+ * with different ASIC limits.
+ */
+
+#define BVIEW_SHM_REGION_NAME         "/broadview-bst"
+#define BVIEW_SHM_SOCKET_PATH         "/var/run/broadview-bst.sock"
+
+/* "BVSH" */
+#define BVIEW_SHM_REGION_MAGIC        0x42565348
+#define BVIEW_SHM_REGION_VERSION      1
+
+/* entries of the rings, powers of two */
+#define BVIEW_SHM_TRIGGER_RING_SIZE   1024
+#define BVIEW_SHM_REQUEST_RING_SIZE   256
+
+/* the eventfds passed on the socket, in this order */
+#define BVIEW_SHM_EVENTFD_TRIGGER     0
+#define BVIEW_SHM_EVENTFD_REQUEST     1
+#define BVIEW_SHM_EVENTFD_COUNT       2
+
+/* values of the largest threshold structure of a realm */
+#define BVIEW_SHM_THRESHOLD_VALUES    4
+
+#define BVIEW_SHM_CACHE_LINE          64
+
+/* requests of the agent */
+typedef enum _bview_shm_request_op_
+{
+  BVIEW_SHM_REQUEST_CONFIG = 1,
+  BVIEW_SHM_REQUEST_THRESHOLD,
+  BVIEW_SHM_REQUEST_CLEAR_STATS,
+  BVIEW_SHM_REQUEST_CLEAR_THRESHOLDS
+} BVIEW_SHM_REQUEST_OP_t;
+
+typedef struct _bview_shm_request_
+{
+  int32_t   op;
+  int32_t   asic;
+  /* threshold : the realm registry id, and the indices the threshold set
+     callback of the realm takes, -1 when it takes less */
+  int32_t   realm;
+  int32_t   index1;
+  int32_t   index2;
+  union
+  {
+    /* the threshold structure of the realm, field by field */
+    uint64_t            threshold[BVIEW_SHM_THRESHOLD_VALUES];
+    BVIEW_BST_CONFIG_t  config;
+  } u;
+} BVIEW_SHM_REQUEST_t;
+
+typedef struct _bview_shm_trigger_
+{
+  int32_t                   asic;
+  BVIEW_BST_TRIGGER_INFO_t  info;
+} BVIEW_SHM_TRIGGER_t;
+
+/* The head is written by the writer only and the tail by the reader only,
+   both are free running and kept on cache lines of their own. */
+typedef struct _bview_shm_trigger_ring_
+{
+  uint32_t             head __attribute__ ((aligned (BVIEW_SHM_CACHE_LINE)));
+  /* triggers lost to a full ring */
+  uint32_t             dropped;
+  uint32_t             tail __attribute__ ((aligned (BVIEW_SHM_CACHE_LINE)));
+  BVIEW_SHM_TRIGGER_t  entries[BVIEW_SHM_TRIGGER_RING_SIZE]
+                               __attribute__ ((aligned (BVIEW_SHM_CACHE_LINE)));
+} BVIEW_SHM_TRIGGER_RING_t;
+
+typedef struct _bview_shm_request_ring_
+{
+  uint32_t             head __attribute__ ((aligned (BVIEW_SHM_CACHE_LINE)));
+  uint32_t             tail __attribute__ ((aligned (BVIEW_SHM_CACHE_LINE)));
+  BVIEW_SHM_REQUEST_t  entries[BVIEW_SHM_REQUEST_RING_SIZE]
+                               __attribute__ ((aligned (BVIEW_SHM_CACHE_LINE)));
+} BVIEW_SHM_REQUEST_RING_t;
+
+typedef struct _bview_shm_asic_
+{
+  /* set before the region is published */
+  BVIEW_ASIC_TYPE                            asicType;
+  BVIEW_ASIC_CAPABILITIES_t                  scalingParams;
+  BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t  maxBuf;
+
+  /* sequence of the data below, odd while the producer writes it */
+  uint32_t                        seq __attribute__ ((aligned (BVIEW_SHM_CACHE_LINE)));
+  /* time of the last collection */
+  int64_t                         time;
+  BVIEW_BST_ASIC_SNAPSHOT_DATA_t  stats;
+  BVIEW_BST_ASIC_SNAPSHOT_DATA_t  thresholds;
+} BVIEW_SHM_ASIC_t;
+
+typedef struct _bview_shm_region_
+{
+  /* BVIEW_SHM_REGION_MAGIC once the region is filled */
+  uint32_t                  magic;
+  uint32_t                  version;
+  /* sizeof (BVIEW_SHM_REGION_t) of the producer */
+  uint64_t                  size;
+  int32_t                   numAsics;
+
+  BVIEW_SHM_TRIGGER_RING_t  triggers;
+  BVIEW_SHM_REQUEST_RING_t  requests;
+  BVIEW_SHM_ASIC_t          asics[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+} BVIEW_SHM_REGION_t;
+
+/* Start an update of the data of an ASIC, producer side */
+static inline void bview_shm_write_begin (BVIEW_SHM_ASIC_t *asic)
+{
+  __atomic_store_n (&asic->seq, asic->seq + 1, __ATOMIC_RELAXED);
+  /* the odd sequence is seen before any of the data */
+  __atomic_thread_fence (__ATOMIC_RELEASE);
+}
+
+/* End an update of the data of an ASIC, producer side */
+static inline void bview_shm_write_end (BVIEW_SHM_ASIC_t *asic)
+{
+  __atomic_store_n (&asic->seq, asic->seq + 1, __ATOMIC_RELEASE);
+}
+
+/* Sequence to start a copy of the data of an ASIC with */
+static inline uint32_t bview_shm_read_begin (const BVIEW_SHM_ASIC_t *asic)
+{
+  return __atomic_load_n (&asic->seq, __ATOMIC_ACQUIRE);
+}
+
+/* true if the copy started at seq has to be taken again */
+static inline bool bview_shm_read_retry (const BVIEW_SHM_ASIC_t *asic,
+                                         uint32_t seq)
+{
+  /* the copy is done before the sequence is read again */
+  __atomic_thread_fence (__ATOMIC_ACQUIRE);
+  return ((seq & 1) ||
+          (seq != __atomic_load_n (&asic->seq, __ATOMIC_RELAXED)));
+}
+
+/* Queue a trigger, producer side. false if the ring is full */
+static inline bool bview_shm_trigger_push (BVIEW_SHM_TRIGGER_RING_t *ring,
+                                           const BVIEW_SHM_TRIGGER_t *trigger)
+{
+  uint32_t head = __atomic_load_n (&ring->head, __ATOMIC_RELAXED);
+
+  if (head - __atomic_load_n (&ring->tail, __ATOMIC_ACQUIRE) >=
+      BVIEW_SHM_TRIGGER_RING_SIZE)
+  {
+    __atomic_add_fetch (&ring->dropped, 1, __ATOMIC_RELAXED);
+    return false;
+  }
+  ring->entries[head & (BVIEW_SHM_TRIGGER_RING_SIZE - 1)] = *trigger;
+  __atomic_store_n (&ring->head, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+/* Take the oldest trigger, agent side. false if the ring is empty */
+static inline bool bview_shm_trigger_pop (BVIEW_SHM_TRIGGER_RING_t *ring,
+                                          BVIEW_SHM_TRIGGER_t *trigger)
+{
+  uint32_t tail = __atomic_load_n (&ring->tail, __ATOMIC_RELAXED);
+
+  if (tail == __atomic_load_n (&ring->head, __ATOMIC_ACQUIRE))
+  {
+    return false;
+  }
+  *trigger = ring->entries[tail & (BVIEW_SHM_TRIGGER_RING_SIZE - 1)];
+  __atomic_store_n (&ring->tail, tail + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+/* Queue a request, agent side. false if the ring is full */
+static inline bool bview_shm_request_push (BVIEW_SHM_REQUEST_RING_t *ring,
+                                           const BVIEW_SHM_REQUEST_t *request)
+{
+  uint32_t head = __atomic_load_n (&ring->head, __ATOMIC_RELAXED);
+
+  if (head - __atomic_load_n (&ring->tail, __ATOMIC_ACQUIRE) >=
+      BVIEW_SHM_REQUEST_RING_SIZE)
+  {
+    return false;
+  }
+  ring->entries[head & (BVIEW_SHM_REQUEST_RING_SIZE - 1)] = *request;
+  __atomic_store_n (&ring->head, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+/* Take the oldest request, producer side. false if the ring is empty */
+static inline bool bview_shm_request_pop (BVIEW_SHM_REQUEST_RING_t *ring,
+                                          BVIEW_SHM_REQUEST_t *request)
+{
+  uint32_t tail = __atomic_load_n (&ring->tail, __ATOMIC_RELAXED);
+
+  if (tail == __atomic_load_n (&ring->head, __ATOMIC_ACQUIRE))
+  {
+    return false;
+  }
+  *request = ring->entries[tail & (BVIEW_SHM_REQUEST_RING_SIZE - 1)];
+  __atomic_store_n (&ring->tail, tail + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_SBPLUGIN_SHM_REGION_H */
+
@@ -0,0 +1,96 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#include "sbplugin.h"
+#include "sbplugin_system.h"
+#include "sbplugin_shm.h"
+#include "sb_redirector_api.h"
+
+/* BST feature data structure*/
+static BVIEW_SB_BST_FEATURE_t       shmBstFeat;
+/* SYSTEM feature data structure*/
+static BVIEW_SB_SYSTEM_FEATURE_t    shmSystemFeat;
+/* SB Plugin data structure*/
+static BVIEW_SB_PLUGIN_t sbPlugin;
+
+/* Flag to enable/disable debug */
+int sbShmDebugFlag = false;
+
+/*********************************************************************
+* @brief    SHM South bound plugin init
+*
+* @param[in]   ovsdb_sock   - unused, the producer is found at
+*                             BVIEW_SHM_SOCKET_PATH
+*
+* @retval   BVIEW_STATUS_SUCCESS if the features are
+*                                initialized successfully.
+* @retval   BVIEW_STATUS_FAILURE if initialization fails.
+*
+* @notes    Waits for the producer to publish its region.
+*
+*
+*********************************************************************/
+BVIEW_STATUS  sbplugin_common_init (char *ovsdb_sock)
+{
+  BVIEW_STATUS      rv = BVIEW_STATUS_SUCCESS;
+  unsigned int      featureIndex = 0;
+
+  (void) ovsdb_sock;
+  sbPlugin.numSupportedFeatures = 0;
+
+  /* Attach the region of the producer */
+  rv = sbplugin_shm_region_init ();
+  if (rv != BVIEW_STATUS_SUCCESS)
+  {
+    SB_SHM_DEBUG_PRINT ("Failed to attach the SHM region");
+    return rv;
+  }
+
+  /* Init SYSTEM feature*/
+  rv = sbplugin_shm_system_init (&shmSystemFeat);
+  if (rv != BVIEW_STATUS_SUCCESS)
+  {
+    SB_SHM_DEBUG_PRINT ("Failed to Intialize SHM SYSTEM feature");
+    return rv;
+  }
+  sbPlugin.featureList[featureIndex] = (BVIEW_SB_FEATURE_t *)&shmSystemFeat;
+  sbPlugin.numSupportedFeatures++;
+  featureIndex++;
+
+  /* Init BST feature*/
+  rv = sbplugin_shm_bst_init (&shmBstFeat);
+  if (rv != BVIEW_STATUS_SUCCESS)
+  {
+    SB_SHM_DEBUG_PRINT ("Failed to Intialize SHM BST feature");
+    return rv;
+  }
+  sbPlugin.featureList[featureIndex] = (BVIEW_SB_FEATURE_t *)&shmBstFeat;
+  sbPlugin.numSupportedFeatures++;
+  shmSystemFeat.featureMask |= BVIEW_FEATURE_BST;
+  featureIndex++;
+
+  /* Register SHM plugin to the sb-redirector*/
+  rv = sb_plugin_register (sbPlugin);
+  if (rv != BVIEW_STATUS_SUCCESS)
+  {
+    SB_SHM_DEBUG_PRINT ("Failed to Register SHM plugin");
+    return rv;
+  }
+
+  return rv;
+}
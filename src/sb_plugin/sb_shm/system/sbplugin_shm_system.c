@@ -0,0 +1,438 @@
+/*****************************************************************************
+ *
+ * (C) Copyright Broadcom Corporation 2015
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+***************************************************************************/
+
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/ioctl.h>
+#include <netinet/in.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include "sbplugin.h"
+#include "system.h"
+#include "sbplugin_system.h"
+#include "sbplugin_shm.h"
+
+/* Array to hold ASIC properties data based for Maximum platforms*/
+static BVIEW_ASIC_t          asicDb[BVIEW_MAX_ASICS_ON_A_PLATFORM];
+
+/* ASICs described by the producer */
+static int                   shmNumAsics;
+
+/*********************************************************************
+* @brief  Get the system name
+*
+* @param[out] buffer                         - buffer
+* @param[in]  length                         - length of the buffer
+*
+* @retval  BVIEW_STATUS_SUCCESS            if Name get is success.
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS  sbplugin_shm_system_name_get (char *buffer, int length)
+{
+  SB_SHM_NULLPTR_CHECK (buffer, BVIEW_STATUS_INVALID_PARAMETER);
+
+  strncpy (buffer, "SHM-PLUGIN", length);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Get the MAC address of the system
+*
+* @param[out] buffer                         - buffer
+* @param[in]  length                         - length of the buffer
+*
+* @retval  BVIEW_STATUS_SUCCESS            if MAC get is success.
+* @retval  BVIEW_STATUS_FAILURE            if MAC get is failed.
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes    Get MAC address of the service port.
+*
+*
+*********************************************************************/
+static BVIEW_STATUS  sbplugin_shm_system_mac_get (unsigned char *buffer,
+                                                  int length)
+{
+  int fd;
+  struct ifreq ifr;
+  BVIEW_STATUS  rv = BVIEW_STATUS_FAILURE;
+
+  SB_SHM_NULLPTR_CHECK (buffer, BVIEW_STATUS_INVALID_PARAMETER);
+
+  fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+  if (fd > -1)
+  {
+    ifr.ifr_addr.sa_family = AF_INET;
+    snprintf(ifr.ifr_name, IFNAMSIZ-1, "%s", "eth0");
+
+    if (ioctl(fd, SIOCGIFHWADDR, &ifr) != -1)
+    {
+      memcpy(buffer, ifr.ifr_hwaddr.sa_data, length);
+      rv = BVIEW_STATUS_SUCCESS;
+    }
+    close(fd);
+  }
+
+  return rv;
+}
+
+/*********************************************************************
+* @brief  Get the IP address of system
+*
+* @param[out] buffer                         - buffer
+* @param[in]  length                         - length of the buffer
+*
+* @retval  BVIEW_STATUS_SUCCESS            if IP get is success.
+* @retval  BVIEW_STATUS_FAILURE            if IP get is failed.
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes    Get IP address of service port.
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_system_ipv4_get (unsigned char *buffer,
+                                                  int length)
+{
+  int fd;
+  struct ifreq ifr;
+  BVIEW_STATUS  rv  = BVIEW_STATUS_FAILURE;
+
+  SB_SHM_NULLPTR_CHECK (buffer, BVIEW_STATUS_INVALID_PARAMETER);
+
+  fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+  if (fd > -1)
+  {
+    /* IP address attached to "eth0" */
+    ifr.ifr_addr.sa_family = AF_INET;
+    strncpy(ifr.ifr_name, "eth0", IFNAMSIZ-1);
+    if (ioctl(fd, SIOCGIFADDR, &ifr) != -1)
+    {
+      memcpy (buffer, &((struct sockaddr_in *)&ifr.ifr_addr)->sin_addr, length);
+      rv = BVIEW_STATUS_SUCCESS;
+    }
+    close(fd);
+  }
+
+  return rv;
+}
+
+/*********************************************************************
+* @brief  Get Current local time.
+*
+* @param[out] ptime                       - time
+*
+* @retval  BVIEW_STATUS_SUCCESS            if time get is success.
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes    none
+*
+*
+*********************************************************************/
+static BVIEW_STATUS  sbplugin_shm_system_time_get (time_t *ptime)
+{
+  SB_SHM_NULLPTR_CHECK (ptime, BVIEW_STATUS_INVALID_PARAMETER);
+
+  time (ptime);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Translate ASIC String notation to ASIC Number.
+*
+* @param[in]  src                         - ASIC ID String
+* @param[out] asic                        - ASIC Number
+*
+* @retval  BVIEW_STATUS_SUCCESS            if ASIC Translation is success.
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes   Application ASIC numbering starts with '1', the units of
+*          the producer with 0.
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_system_asic_translate_from_notation (char *src,
+                                                                     int *asic)
+{
+  int number;
+
+  SB_SHM_NULLPTR_CHECK (src, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_SHM_NULLPTR_CHECK (asic, BVIEW_STATUS_INVALID_PARAMETER);
+
+  number = atoi (src);
+  if ((number < 1) || (number > shmNumAsics))
+  {
+    return BVIEW_STATUS_INVALID_PARAMETER;
+  }
+
+  *asic = number - 1;
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Translate ASIC number to ASIC string notation.
+*
+* @param[in]   asic                         - ASIC ID
+* @param[out]  dst                          - ASIC ID String
+*
+* @retval  BVIEW_STATUS_SUCCESS            if ASIC ID Tranlate is success.
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_system_asic_translate_to_notation (int asic,
+                                                                   char *dst)
+{
+  SB_SHM_NULLPTR_CHECK (dst, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_SHM_VALID_UNIT_CHECK (asic);
+
+  sprintf (dst, "%d", asic + 1);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Translate Port String notation to Port Number.
+*
+* @param[in]   src                         - Port ID String
+* @param[out]  port                        - PortId
+*
+* @retval  BVIEW_STATUS_SUCCESS            if Port Tranlate is success.
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes   The producer numbers the ports as the agent does.
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_system_port_translate_from_notation (char *src,
+                                                                     int *port)
+{
+  SB_SHM_NULLPTR_CHECK (src, BVIEW_STATUS_INVALID_PARAMETER);
+  SB_SHM_NULLPTR_CHECK (port, BVIEW_STATUS_INVALID_PARAMETER);
+
+  *port = atoi (src);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief   Translate port number to port string notation.
+*
+* @param[in]   asic                         - ASIC
+* @param[in]   port                         - Port Number
+* @param[out]  dst                          - Port String
+*
+* @retval  BVIEW_STATUS_SUCCESS            if Port Tranlate is success.
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_system_port_translate_to_notation (int asic,
+                                                                   int port,
+                                                                   char *dst)
+{
+  SB_SHM_NULLPTR_CHECK (dst, BVIEW_STATUS_INVALID_PARAMETER);
+
+  sprintf (dst, "%d", port);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief   Translate lag number to lag string notation.
+*
+* @param[in]   asic                         - ASIC
+* @param[in]   lag                          - lag Number
+* @param[out]  dst                          - lag String
+*
+* @retval  BVIEW_STATUS_SUCCESS            if lag Tranlate is success.
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_system_lag_translate_to_notation (int asic,
+                                                                  int lag,
+                                                                  char *dst)
+{
+  SB_SHM_NULLPTR_CHECK (dst, BVIEW_STATUS_INVALID_PARAMETER);
+
+  sprintf (dst, "%d", lag + 1);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief       Get Network OS
+*
+* @param[out]  buffer                 Pointer to network OS String
+* @param[in]   length                 length of the buffer
+*
+* @retval   BVIEW_STATUS_SUCCESS      Network OS is successfully
+*                                     queried
+* @retval   BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes    none
+*
+*********************************************************************/
+static BVIEW_STATUS  sbplugin_shm_system_network_os_get (uint8_t *buffer, int length)
+{
+  SB_SHM_NULLPTR_CHECK (buffer, BVIEW_STATUS_INVALID_PARAMETER);
+
+  strncpy ((char *) buffer, SBPLUGIN_SHM_NETWORK_OS, length);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Get the UID of the system
+*
+* @param[out] buffer                         - buffer
+* @param[in]  length                         - length of the buffer
+*
+* @retval  BVIEW_STATUS_SUCCESS            if UID get is success.
+* @retval  BVIEW_STATUS_FAILURE            if UID get is failed.
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes   get the UID of the system
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_system_uid_get (unsigned char *buffer,
+                                                 int length)
+{
+  unsigned char mac[BVIEW_MACADDR_LEN];
+
+  SB_SHM_NULLPTR_CHECK (buffer, BVIEW_STATUS_INVALID_PARAMETER);
+
+  memset(mac, 0, BVIEW_MACADDR_LEN);
+
+  if (BVIEW_STATUS_SUCCESS != sbplugin_shm_system_mac_get(&mac[0], BVIEW_MACADDR_LEN))
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+
+  snprintf((char *)buffer, length, "%02x%02x%02x%02x%02x%02x%02x%02x", 0,0, mac[0],mac[1], mac[2], mac[3], mac[4], mac[5]);
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  Get snapshot of max buffers allocated
+*
+*
+* @param[in]   asic                          - unit
+* @param[out]  maxBufSnapshot                - Max buffers snapshot
+* @param[out]  time                          - time
+*
+* @retval BVIEW_STATUS_INVALID_PARAMETER if input data is invalid.
+* @retval BVIEW_STATUS_SUCCESS           if snapshot get is success.
+*
+* @notes    The producer publishes the max buffers with the region.
+*
+*
+*********************************************************************/
+static BVIEW_STATUS sbplugin_shm_system_max_buf_snapshot_get (int asic,
+                              BVIEW_SYSTEM_ASIC_MAX_BUF_SNAPSHOT_DATA_t *maxBufSnapshot,
+                              BVIEW_TIME_t * time)
+{
+  SB_SHM_VALID_UNIT_CHECK (asic);
+  SB_SHM_NULLPTR_CHECK (maxBufSnapshot, BVIEW_STATUS_INVALID_PARAMETER);
+
+  sbplugin_shm_system_time_get (time);
+
+  return sbplugin_shm_region_asic_get (asic, NULL, NULL, maxBufSnapshot);
+}
+
+/*********************************************************************
+* @brief   Verify whether a given unit number is valid or not.
+*
+* @param[in]   unit                     -  unit number
+*
+* @retval  BVIEW_STATUS_SUCCESS            if it is a valid unit
+* @retval  BVIEW_STATUS_FAILURE            if it is not a valid unit
+*
+* @notes
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_valid_unit_check (int unit)
+{
+  if ((unit < 0) || (unit >= shmNumAsics))
+  {
+    return BVIEW_STATUS_FAILURE;
+  }
+  return BVIEW_STATUS_SUCCESS;
+}
+
+/*********************************************************************
+* @brief  SHM South Bound - SYSTEM feature init
+*
+* @param[in,out]   shmSystemFeat   -  system data structure
+*
+* @retval  BVIEW_STATUS_SUCCESS            if intialization is success
+* @retval  BVIEW_STATUS_INVALID_PARAMETER  if input parameter is invalid.
+*
+* @notes   The ASICs are the ones the producer describes in its region.
+*
+*
+*********************************************************************/
+BVIEW_STATUS sbplugin_shm_system_init (BVIEW_SB_SYSTEM_FEATURE_t *shmSystemFeat)
+{
+  int unit = 0;
+
+  SB_SHM_NULLPTR_CHECK (shmSystemFeat, BVIEW_STATUS_INVALID_PARAMETER);
+
+  memset (shmSystemFeat, 0x00, sizeof (BVIEW_SB_SYSTEM_FEATURE_t));
+  shmSystemFeat->feature.featureId           = BVIEW_FEATURE_SYSTEM;
+  shmSystemFeat->feature.supportedAsicMask   = BVIEW_SYSTEM_SUPPORT_MASK;
+
+  shmNumAsics = sbplugin_shm_region_num_asics_get ();
+  for (unit = 0; unit < shmNumAsics; unit++)
+  {
+    asicDb[unit].unit = unit;
+    sbplugin_shm_region_asic_get (unit, &asicDb[unit].asicType,
+                                  &asicDb[unit].scalingParams, NULL);
+    shmSystemFeat->asicList[unit] = &asicDb[unit];
+    shmSystemFeat->numSupportedAsics++;
+  }
+
+  shmSystemFeat->system_name_get_cb     = sbplugin_shm_system_name_get;
+  shmSystemFeat->system_mac_get_cb      = sbplugin_shm_system_mac_get;
+  shmSystemFeat->system_ip4_get_cb      = sbplugin_shm_system_ipv4_get;
+  shmSystemFeat->system_time_get_cb     = sbplugin_shm_system_time_get;
+  shmSystemFeat->system_asic_translate_from_notation_cb      = sbplugin_shm_system_asic_translate_from_notation;
+  shmSystemFeat->system_port_translate_from_notation_cb      = sbplugin_shm_system_port_translate_from_notation;
+  shmSystemFeat->system_asic_translate_to_notation_cb        = sbplugin_shm_system_asic_translate_to_notation;
+  shmSystemFeat->system_port_translate_to_notation_cb        = sbplugin_shm_system_port_translate_to_notation;
+  shmSystemFeat->system_network_os_get_cb                    = sbplugin_shm_system_network_os_get;
+  shmSystemFeat->system_uid_get_cb                           = sbplugin_shm_system_uid_get;
+  shmSystemFeat->system_lag_translate_to_notation_cb         = sbplugin_shm_system_lag_translate_to_notation;
+  shmSystemFeat->system_max_buf_snapshot_get_cb              = sbplugin_shm_system_max_buf_snapshot_get;
+
+  return BVIEW_STATUS_SUCCESS;
+}
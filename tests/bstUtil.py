@@ -21,6 +21,9 @@
 import os
 import sys
 import ConfigParser
+import json
+import threading
+import BaseHTTPServer
 
 def returnStatus(actual, expected, passmsg="", failmsg=""):
     '''Returns a tuple with result and message after comapring two values.'''
@@ -44,3 +47,59 @@ def get_ini_details(filename,section):
     config.read(filename)
     config_dict = dict(config.items(section))
     return config_dict
+
+class bstCollector(object):
+    '''Receives the asynchronous reports the agent posts to its collector.
+    The agent's bview_client_ip and bview_client_port must point at this host and port.'''
+
+    def __init__(self, port):
+        collector = self
+        self.reports = []
+        self.lock = threading.Lock()
+
+        class handler(BaseHTTPServer.BaseHTTPRequestHandler):
+            def readChunked(self):
+                # streamed reports come with chunked transfer encoding
+                body = ''
+                while True:
+                    size = int(self.rfile.readline().split(';')[0].strip() or '0', 16)
+                    if size == 0:
+                        self.rfile.readline()
+                        return body
+                    body += self.rfile.read(size)
+                    self.rfile.readline()
+
+            def do_POST(self):
+                if 'chunked' in self.headers.getheader('transfer-encoding', ''):
+                    body = self.readChunked()
+                else:
+                    body = self.rfile.read(int(self.headers.getheader('content-length', 0)))
+                # no reply, the agent closes the session once the report is sent
+                with collector.lock:
+                    collector.reports.append(body)
+
+            def log_message(self, *args):
+                pass
+
+        self.server = BaseHTTPServer.HTTPServer(('', int(port)), handler)
+        self.thread = threading.Thread(target=self.server.serve_forever)
+        self.thread.daemon = True
+        self.thread.start()
+
+    def getReports(self, method="get-bst-report"):
+        '''returns the JSON reports of the given method received so far.'''
+        with self.lock:
+            bodies = list(self.reports)
+        reports = []
+        for body in bodies:
+            try:
+                report = json.loads(body)
+            except ValueError:
+                continue
+            if report.get('method') == method:
+                reports.append(report)
+        return reports
+
+    def stop(self):
+        self.server.shutdown()
+        self.server.server_close()
@@ -78,8 +78,12 @@ class configure_bst_feature_api_ct(object):
         resultDict = data_dict['result']
         jsonDict = json.loads(self.nextStepCheckParams)
         paramsDict = jsonDict['params']
-        valsCheck = True if cmp(resultDict, paramsDict) == 0 else False
-        added,removed,modified,same=dict_compare(resultDict,paramsDict)
+        plist = [p.strip() for p in self.params.split(",")]
+        if sorted(plist) != sorted(resultDict.keys()): return "FAIL","get_bst_feature params lists contains invalid param keys"
+        # the parameters left out of the request keep the values of earlier steps
+        checkDict = dict((k, resultDict[k]) for k in paramsDict.keys() if k in resultDict)
+        valsCheck = True if cmp(checkDict, paramsDict) == 0 else False
+        added,removed,modified,same=dict_compare(checkDict,paramsDict)
         if not added and not removed and not modified:
             msg = ""
         else:
@@ -88,6 +92,40 @@ class configure_bst_feature_api_ct(object):
             msg="params "+" ".join(diff_list)+" contains wrong values in response."
         return returnStatus(valsCheck,True,"",msg)
 
+    def step25(self,jsonData):
+        """Configure BST feature with an out of range value"""
+        try:
+            resp = self.obj.postResponse(jsonData)
+            if resp[0] == "INVALID":
+                return "FAIL","Connection refused/Invalid JSON request... Please check the ip address provided in 'ini' file/BroadViewAgent is running or not/JSON data is valid or not ..."
+        except Exception,e:
+            return "FAIL","Unable to perform the rest call with given JSON data, Occured Exception ... "+str(e)
+
+        try:
+            self.obj.debugJsonPrint(self.debug,jsonData,resp)
+        except:
+            return "FAIL","Invalid JSON Response data received"
+
+        # the configuration is left as it was, the next step checks it against the last accepted one
+        return returnStatus(resp[0], 500,"","Out of range value not rejected, got reponse "+str(resp[0]))
+
+    def step55(self,jsonData):
+        """Configure BST feature with an invalid parameter value"""
+        try:
+            resp = self.obj.postResponse(jsonData)
+            if resp[0] == "INVALID":
+                return "FAIL","Connection refused/Invalid JSON request... Please check the ip address provided in 'ini' file/BroadViewAgent is running or not/JSON data is valid or not ..."
+        except Exception,e:
+            return "FAIL","Unable to perform the rest call with given JSON data, Occured Exception ... "+str(e)
+
+        try:
+            self.obj.debugJsonPrint(self.debug,jsonData,resp)
+        except:
+            return "FAIL","Invalid JSON Response data received"
+
+        # the configuration is left as it was, the next step checks it against the last accepted one
+        return returnStatus(resp[0], 400,"","Invalid parameter value not rejected, got reponse "+str(resp[0]))
+
     step3, step4 = step1, step2
     step5, step6 = step1, step2
     step7, step8 = step1, step2
@@ -98,6 +136,24 @@ class configure_bst_feature_api_ct(object):
     step17, step18 = step1, step2
     step19, step20 = step1, step2
     step21, step22 = step1, step2
+    step23, step24 = step1, step2
+    step26 = step2
+    step27, step28 = step1, step2
+    step29, step30 = step1, step2
+    step31, step32 = step25, step2
+    step33, step34 = step1, step2
+    step35, step36 = step1, step2
+    step37, step38 = step25, step2
+    step39, step40 = step1, step2
+    step41, step42 = step1, step2
+    step43, step44 = step25, step2
+    step45, step46 = step25, step2
+    step47, step48 = step1, step2
+    step49, step50 = step1, step2
+    step51, step52 = step25, step2
+    step53, step54 = step1, step2
+    step56 = step2
+    step57, step58 = step55, step2
 
     def getSteps(self):
         return sorted([ i for i in dir(self) if i.startswith('step') ], key=lambda item: int(item.replace('step','')))
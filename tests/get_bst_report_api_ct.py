@@ -20,6 +20,7 @@
 
 import os
 import sys
+import time
 
 import ConfigParser
 import json
@@ -36,6 +37,10 @@ class get_bst_report_api_ct(object):
         self.obj = BstRestService(ip,port)
         self.debug = debug
         self.params = params
+        self.collector = None
+        cwdir, f = os.path.split(__file__)
+        config_dict = get_ini_details(cwdir + "/serverDetails.ini","server_details")
+        self.collectorPort = config_dict.get('collector_port',"9070")
 
     def step1(self,jsonData):
         """Get BST Report"""
@@ -55,12 +60,13 @@ class get_bst_report_api_ct(object):
         if not resp[1]: return "FAIL","Got null response"
         resp_ = resp[1].replace('Content-Type: text/json', '')
         data_dict = json.loads(resp_)
+        self.lastResponse = resp_
         if not "report" in data_dict: return "FAIL","No Report key in Response JSON Data"
         result = data_dict['report']
         realms = [ r['realm'] for r in result if 'data' in r and 'realm' in r ]
         jsonDict = json.loads(jsonData)
         paramsDict=jsonDict['params']
-        plist = [ k.replace('include-', '') for k, v in paramsDict.items() if v == 1 ]
+        plist = [ k.replace('include-', '') for k, v in paramsDict.items() if k.startswith('include-') and v == 1 ]
         msg="Expected realm(s) " + " ".join(plist) + " not present"
         return returnStatus(sorted(plist),sorted(realms),"",msg)
 
@@ -86,6 +92,170 @@ class get_bst_report_api_ct(object):
 
     step12=step1
 
+    def step13(self,jsonData):
+        """Get BST Report in the binary format"""
+        try:
+            resp = self.obj.postResponse(jsonData)
+            if resp[0] == "INVALID":
+                return "FAIL","Connection refused/Invalid JSON request... Please check the ip address provided in 'ini' file/BroadViewAgent is running or not/JSON data is valid or not ..."
+        except Exception,e:
+            return "FAIL","Unable to perform the rest call with given JSON data, Occured Exception ... "+str(e)
+
+        if returnStatus(resp[0], 200)[0] == "FAIL": return "FAIL","Obtained {0}".format(resp[0])
+        if not resp[1]: return "FAIL","Got null response"
+        # magic "BSTB", then the format version and the message kind (0 for a report)
+        if resp[1][:4] != "BSTB": return "FAIL","No BSTB magic in the binary report"
+        if len(resp[1]) < 6: return "FAIL","Binary report too short"
+        return returnStatus((ord(resp[1][4]), ord(resp[1][5])),(1, 0),"","Unexpected binary report version or kind")
+
+    def step14(self,jsonData):
+        """Get BST Report narrowed by a report filter"""
+        result = self.step1(jsonData)
+        if result[0] == "FAIL": return result
+        data_dict = json.loads(self.lastResponse)
+        filterDict = json.loads(jsonData)['params']['report-filter']
+        ports = set()
+        for p in filterDict['ports']:
+            if isinstance(p, list):
+                ports.update([ str(i) for i in range(int(p[0]), int(p[1]) + 1) ])
+            else:
+                ports.add(p)
+        first, last = filterDict['queue-range']
+        for r in data_dict['report']:
+            if r['realm'] == 'ingress-port-priority-group':
+                outside = [ e['port'] for e in r['data'] if e['port'] not in ports ]
+            elif r['realm'] == 'egress-uc-queue':
+                # sparse rows [ queue, "port", value ], a filtered realm is never dense
+                outside = [ e for e in r['data'] if len(e) != 3 or e[1] not in ports or not first <= e[0] <= last ]
+            else:
+                continue
+            if outside: return "FAIL","Realm "+r['realm']+" has entries outside the filter "+str(outside[:4])
+        return "PASS",""
+
+    def step15(self,jsonData):
+        """Get BST Report in the sparse layout"""
+        result = self.step1(jsonData)
+        if result[0] == "FAIL": return result
+        for r in json.loads(self.lastResponse)['report']:
+            if 'layout' in r: return "FAIL","Realm "+r['realm']+" is not sparse"
+            # sparse unicast queue rows are [ queue, "port", value ]
+            if r['realm'] == 'egress-uc-queue' and [ e for e in r['data'] if len(e) != 3 ]:
+                return "FAIL","Realm "+r['realm']+" has rows without their index"
+        return "PASS",""
+
+    def step16(self,jsonData):
+        """Get BST Report in the adaptive layout"""
+        result = self.step1(jsonData)
+        if result[0] == "FAIL": return result
+        for r in json.loads(self.lastResponse)['report']:
+            if r['realm'] != 'egress-uc-queue': continue
+            # a dense realm leaves the index out of its rows, a sparse one keeps it
+            rowLength = 2 if r.get('layout') == 'dense' else 3
+            if r.get('layout', 'dense') != 'dense': return "FAIL","Unknown layout "+r['layout']
+            if [ e for e in r['data'] if len(e) != rowLength ]:
+                return "FAIL","Realm "+r['realm']+" rows do not match its layout"
+        return "PASS",""
+
+    def configure(self,jsonData):
+        """Configure BST feature for the steps that follow"""
+        try:
+            resp = self.obj.postResponse(jsonData)
+            if resp[0] == "INVALID":
+                return "FAIL","Connection refused/Invalid JSON request... Please check the ip address provided in 'ini' file/BroadViewAgent is running or not/JSON data is valid or not ..."
+        except Exception,e:
+            return "FAIL","Unable to perform the rest call with given JSON data, Occured Exception ... "+str(e)
+
+        try:
+            self.obj.debugJsonPrint(self.debug,jsonData,resp)
+        except:
+            return "FAIL","Invalid JSON Response data received"
+
+        return returnStatus(resp[0], 200,"","Unable to get the 200 OK response, got reponse "+str(resp[0]))
+
+    def step17(self,jsonData):
+        """Send periodic BST reports to the collector"""
+        if self.collector is None:
+            try:
+                self.collector = bstCollector(self.collectorPort)
+            except Exception,e:
+                return "FAIL","Unable to listen for reports on port "+str(self.collectorPort)+" ... "+str(e)
+        self.keyframeInterval = json.loads(jsonData)['params'].get('keyframe-interval', 0)
+        return self.configure(jsonData)
+
+    def step18(self):
+        """Receive periodic BST reports with sequence numbers and keyframes"""
+        deadline = time.time() + 5 + (3 * self.keyframeInterval)
+        reports = []
+        while time.time() < deadline and len(reports) < (2 * self.keyframeInterval) + 1:
+            time.sleep(1)
+            reports = self.collector.getReports()
+        if len(reports) < (2 * self.keyframeInterval) + 1: return "FAIL","Received "+str(len(reports))+" periodic reports"
+        if [ r for r in reports if 'sequence-number' not in r or 'keyframe' not in r ]:
+            return "FAIL","Periodic report without a sequence number"
+        reports.sort(key=lambda r: r['sequence-number'])
+        sequence = [ r['sequence-number'] for r in reports ]
+        if sequence != range(sequence[0], sequence[0] + len(sequence)):
+            return "FAIL","Periodic reports are not numbered one after the other "+str(sequence)
+        keyframes = [ r['sequence-number'] for r in reports if r['keyframe'] == 1 ]
+        if not keyframes: return "FAIL","No keyframe among the periodic reports"
+        # every keyframe-interval'th report is a keyframe, counted from the first one
+        expected = [ n for n in sequence if n >= keyframes[0] and (n - keyframes[0]) % self.keyframeInterval == 0 ]
+        return returnStatus(keyframes,expected,"","Keyframes sent as "+str(keyframes)+", expected "+str(expected))
+
+    def step19(self,jsonData):
+        """Stop the periodic BST reports"""
+        result = self.configure(jsonData)
+        if self.collector is not None:
+            self.collector.stop()
+            self.collector = None
+        return result
+
+    def step21(self,jsonData):
+        """Get the same BST Report twice within the coalesce window"""
+        result = self.step1(jsonData)
+        if result[0] == "FAIL": return result
+        first = self.lastResponse
+        result = self.step1(jsonData)
+        if result[0] == "FAIL": return result
+        # the second request shares the collection and the encoding of the first
+        return returnStatus(self.lastResponse,first,"","The second report differs from the first one")
+
+    step20=configure
+
+    step22=configure
+
+    def step24(self,jsonData):
+        """Get BST Feature while periodic reports are sent"""
+        slowest = 0
+        for i in range(20):
+            start = time.time()
+            result = self.configure(jsonData)
+            if result[0] == "FAIL": return result
+            slowest = max(slowest, time.time() - start)
+            time.sleep(0.1)
+        # control requests are served ahead of the queued reports
+        return returnStatus(slowest < 1,True,"","Slowest get-bst-feature took "+str(slowest)+" seconds")
+
+    step23=step17
+
+    step25=step19
+
+    def step27(self,jsonData):
+        """Get BST Report while periodic reports are sent"""
+        for i in range(10):
+            result = self.step1(jsonData)
+            if result[0] == "FAIL": return result
+            time.sleep(0.3)
+        time.sleep(1)
+        # the reports are sent from the pipeline threads, in the order they were collected
+        sequence = [ r.get('sequence-number') for r in self.collector.getReports() ]
+        if len(sequence) < 2: return "FAIL","Received "+str(len(sequence))+" periodic reports"
+        return returnStatus(sequence,sorted(set(sequence)),"","Periodic reports received out of order "+str(sequence))
+
+    step26=step17
+
+    step28=step19
+
     def getSteps(self):
         return sorted([ i for i in dir(self) if i.startswith('step') ], key=lambda item: int(item.replace('step','')))
 